@@ -25,6 +25,8 @@
 #include <iomanip>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <vector>
 #include <time.h>
 
 #include "simNotify/Notify.h"
@@ -34,6 +36,8 @@
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simCore/Calc/CoordinateSystem.h"
 #include "simCore/Calc/Calculations.h"
+#include "simCore/Calc/Geodesic.h"
+#include "simCore/System/ParallelFor.h"
 
 namespace
 {
@@ -493,6 +497,387 @@ std::string formatBearingAspectAngle(double aspectAngle)
   return std::to_string(twoDigits) + suffix;
 }
 
+namespace
+{
+  /// Targets processed together for one 'from' entity, small enough that the scratch arrays stay in cache
+  constexpr size_t PAIRWISE_BLOCK_SIZE = 1024;
+  /// Minimum pairs per thread before calculatePairwise() splits the work between threads
+  constexpr size_t PAIRWISE_MIN_PER_THREAD = 16384;
+
+  /// Structure-of-arrays positions or velocities, so the per pair loops can be vectorized
+  struct PairwiseVectors
+  {
+    void resize(size_t count)
+    {
+      x.resize(count);
+      y.resize(count);
+      z.resize(count);
+    }
+
+    void set(size_t index, const simCore::Vec3& value)
+    {
+      x[index] = value.x();
+      y[index] = value.y();
+      z[index] = value.z();
+    }
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+  };
+
+  /// Values that depend only on the 'from' entity, computed once and shared by all of its pairs
+  struct PairwiseFrame
+  {
+    double ecefToEnu[3][3] = {};  ///< ECEF to X-East tangent plane rotation at the 'from' position
+    double bodyRot[3][3] = {};    ///< rotation from the 'from' orientation, as in calculateRelAng()
+    simCore::Vec3 bodyX;          ///< body X axis from the 'from' orientation
+    simCore::Vec3 pos;            ///< position in the frame shared with the 'to' entities
+    simCore::Vec3 vel;            ///< velocity in the frame shared with the 'to' entities
+    double speed = 0.0;           ///< magnitude of the LLA frame velocity
+  };
+
+  /// Offsets of positions from an origin; rotated into the origin's X-East tangent plane if rot is not nullptr
+  void pairwiseOffsets(const double (*rot)[3], const simCore::Vec3& origin, const double* x, const double* y, const double* z,
+    size_t count, double* dx, double* dy, double* dz)
+  {
+    const double ox = origin.x();
+    const double oy = origin.y();
+    const double oz = origin.z();
+    if (!rot)
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+      {
+        dx[ii] = x[ii] - ox;
+        dy[ii] = y[ii] - oy;
+        dz[ii] = z[ii] - oz;
+      }
+      return;
+    }
+    const double r00 = rot[0][0], r01 = rot[0][1], r02 = rot[0][2];
+    const double r10 = rot[1][0], r11 = rot[1][1], r12 = rot[1][2];
+    const double r20 = rot[2][0], r21 = rot[2][1], r22 = rot[2][2];
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double ex = x[ii] - ox;
+      const double ey = y[ii] - oy;
+      const double ez = z[ii] - oz;
+      dx[ii] = r00 * ex + r01 * ey + r02 * ez;
+      dy[ii] = r10 * ex + r11 * ey + r12 * ez;
+      dz[ii] = r20 * ex + r21 * ey + r22 * ez;
+    }
+  }
+
+  /// Lengths of vectors; horizontal lengths if dz is nullptr
+  void pairwiseLengths(const double* dx, const double* dy, const double* dz, size_t count, double* out)
+  {
+    // Squares are summed in a loop the compiler can vectorize; sqrt() with errno checks cannot be
+    if (dz)
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+        out[ii] = dx[ii] * dx[ii] + dy[ii] * dy[ii] + dz[ii] * dz[ii];
+    }
+    else
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+        out[ii] = dx[ii] * dx[ii] + dy[ii] * dy[ii];
+    }
+    for (size_t ii = 0; ii < count; ++ii)
+      out[ii] = sqrt(out[ii]);
+  }
+
+  /// Closing velocities along position offsets, as calculateClosingVelocity(); offsets and velocities share a frame
+  void pairwiseClosingVelocity(const double* dx, const double* dy, const double* dz, const simCore::Vec3& fromVel,
+    const double* vx, const double* vy, const double* vz, size_t count, double* lengths, double* out)
+  {
+    const double fx = fromVel.x();
+    const double fy = fromVel.y();
+    const double fz = fromVel.z();
+    for (size_t ii = 0; ii < count; ++ii)
+      lengths[ii] = dx[ii] * dx[ii] + dy[ii] * dy[ii] + dz[ii] * dz[ii];
+    for (size_t ii = 0; ii < count; ++ii)
+      out[ii] = dx[ii] * (fx - vx[ii]) + dy[ii] * (fy - vy[ii]) + dz[ii] * (fz - vz[ii]);
+    // Coincident positions have no unit vector, and close at 0
+    for (size_t ii = 0; ii < count; ++ii)
+      out[ii] = (lengths[ii] > 0.0) ? out[ii] / sqrt(lengths[ii]) : 0.0;
+  }
+
+  /// Relative angles of an ENU offset along a 'from' entity's line of sight; matches calculateRelAng()
+  void pairwiseRelAng(double east, double north, double up, const PairwiseFrame& frame, double* azim, double* elev, double* cmp)
+  {
+    // calculateRelAng() builds its pointing vector from the azimuth and elevation of the offset; the
+    // components of that vector are the normalized offset in North, East, Down order
+    const double range = sqrt(east * east + north * north + up * up);
+    const simCore::Vec3 pntVec = (range > 0.0) ? simCore::Vec3(north / range, east / range, -up / range) : simCore::Vec3(1.0, 0.0, 0.0);
+    if (azim || elev)
+    {
+      simCore::Vec3 body;
+      simCore::d3Mv3Mult(frame.bodyRot, pntVec, body);
+      double az;
+      double el;
+      simCore::calculateYawPitchFromBodyUnitX(body, az, el);
+      if (azim)
+        *azim = az;
+      if (elev)
+        *elev = el;
+    }
+    if (cmp)
+      *cmp = simCore::v3Angle(frame.bodyX, pntVec);
+  }
+
+  /// Converts LLA velocity, given in the local ENU frame, to ECEF
+  simCore::Vec3 pairwiseEcefVelocity(const simCore::Vec3& lla, const simCore::Vec3& vel)
+  {
+    double localToEarth[3][3];
+    simCore::CoordinateConverter::setLocalToEarthMatrix(lla.lat(), lla.lon(), simCore::LOCAL_LEVEL_FRAME_ENU, localToEarth);
+    simCore::Vec3 ecefVel;
+    simCore::d3MTv3Mult(localToEarth, vel, ecefVel);
+    return ecefVel;
+  }
+
+  /// Converts geodetic positions to the scaled flat earth ENU frame of the given converter
+  int pairwiseToFlat(const simCore::CoordinateConverter& cc, const std::vector<simCore::Vec3>& lla, size_t begin, size_t count, PairwiseVectors& out)
+  {
+    out.resize(count);
+    for (size_t ii = 0; ii < count; ++ii)
+      out.set(ii, lla[begin + ii]);
+    return cc.convertPositions(simCore::COORD_SYS_LLA, out.x, out.y, out.z, simCore::COORD_SYS_ENU, out.x, out.y, out.z);
+  }
+}
+
+/// Calculates relative geometry between every pair of entities in two groups
+int calculatePairwise(const PairwiseStates& from, const PairwiseStates& to, unsigned int calculations,
+  const EarthModelCalculations model, const CoordinateConverter* coordConv, PairwiseResults& results, bool multithreaded)
+{
+  const size_t fromCount = from.lla.size();
+  const size_t toCount = to.lla.size();
+  const size_t pairCount = fromCount * toCount;
+  const bool wantAngles = (calculations & PAIRWISE_REL_AZ_EL) != 0;
+  const bool wantSlant = (calculations & PAIRWISE_SLANT) != 0;
+  const bool wantGround = (calculations & PAIRWISE_GROUND_DIST) != 0;
+  const bool wantClosing = (calculations & PAIRWISE_CLOSING_VELOCITY) != 0;
+  const bool wantRangeRate = (calculations & PAIRWISE_RANGE_RATE) != 0;
+
+  // Unrequested results are emptied; requested results start at 0, the single pair functions' error value
+  results.azim.assign(wantAngles ? pairCount : 0, 0.0);
+  results.elev.assign(wantAngles ? pairCount : 0, 0.0);
+  results.cmp.assign(wantAngles ? pairCount : 0, 0.0);
+  results.slant.assign(wantSlant ? pairCount : 0, 0.0);
+  results.groundDist.assign(wantGround ? pairCount : 0, 0.0);
+  results.closingVelocity.assign(wantClosing ? pairCount : 0, 0.0);
+  results.rangeRate.assign(wantRangeRate ? pairCount : 0, 0.0);
+
+  if (((wantAngles || wantRangeRate) && from.ori.size() != fromCount) ||
+    (wantRangeRate && to.ori.size() != toCount) ||
+    ((wantClosing || wantRangeRate) && (from.vel.size() != fromCount || to.vel.size() != toCount)))
+  {
+    SIM_ERROR << "calculatePairwise, orientation or velocity count does not match position count: " << __LINE__ << std::endl;
+    return 1;
+  }
+  if (model != WGS_84 && model != TANGENT_PLANE_WGS_84 && model != FLAT_EARTH && model != PERFECT_SPHERE)
+  {
+    SIM_WARN << "calculatePairwise, unknown earth model: " << __LINE__ << std::endl;
+    return 1;
+  }
+  // The single pair functions support only slant range on a perfect sphere
+  if (model == PERFECT_SPHERE && (wantAngles || wantGround || wantClosing || wantRangeRate))
+  {
+    SIM_WARN << "calculatePairwise, calculation not supported for PERFECT_SPHERE: " << __LINE__ << std::endl;
+    return 1;
+  }
+  // Flat earth angles and distances are measured in the caller's frame; closing velocity and range rate use a frame at each 'from' entity
+  const bool userFlat = (model == FLAT_EARTH) && (wantAngles || wantSlant || wantGround);
+  const bool localFlat = (model == FLAT_EARTH) && (wantClosing || wantRangeRate);
+  if (userFlat && (!coordConv || !coordConv->hasReferenceOrigin()))
+  {
+    SIM_WARN << "calculatePairwise, CoordinateConverter not set for FLAT_EARTH: " << __LINE__ << std::endl;
+    return 1;
+  }
+  if (pairCount == 0)
+    return 0;
+
+  // Convert the 'to' entities once, into a frame shared by every 'from' entity
+  const bool ellipsoid = (model == WGS_84 || model == TANGENT_PLANE_WGS_84);
+  PairwiseVectors toPos;
+  PairwiseVectors toVel;
+  std::vector<PairwiseFrame> frames(fromCount);
+  if (ellipsoid)
+  {
+    toPos.resize(toCount);
+    for (size_t jj = 0; jj < toCount; ++jj)
+    {
+      Vec3 ecef;
+      CoordinateConverter::convertGeodeticPosToEcef(to.lla[jj], ecef);
+      toPos.set(jj, ecef);
+    }
+  }
+  else if (userFlat)
+  {
+    PairwiseVectors fromPos;
+    if (pairwiseToFlat(*coordConv, to.lla, 0, toCount, toPos) != 0 || pairwiseToFlat(*coordConv, from.lla, 0, fromCount, fromPos) != 0)
+    {
+      SIM_WARN << "calculatePairwise, unable to convert to FLAT_EARTH: " << __LINE__ << std::endl;
+      return 1;
+    }
+    for (size_t ii = 0; ii < fromCount; ++ii)
+      frames[ii].pos.set(fromPos.x[ii], fromPos.y[ii], fromPos.z[ii]);
+  }
+  else if (model == PERFECT_SPHERE)
+  {
+    toPos.resize(toCount);
+    for (size_t jj = 0; jj < toCount; ++jj)
+    {
+      Vec3 sphere;
+      geodeticToSpherical(to.lla[jj].lat(), to.lla[jj].lon(), to.lla[jj].alt(), sphere);
+      toPos.set(jj, sphere);
+    }
+    for (size_t ii = 0; ii < fromCount; ++ii)
+      geodeticToSpherical(from.lla[ii].lat(), from.lla[ii].lon(), from.lla[ii].alt(), frames[ii].pos);
+  }
+  if (wantClosing)
+  {
+    // ECEF for the ellipsoid models; flat earth velocities are already in the ENU frame
+    toVel.resize(toCount);
+    for (size_t jj = 0; jj < toCount; ++jj)
+      toVel.set(jj, ellipsoid ? pairwiseEcefVelocity(to.lla[jj], to.vel[jj]) : to.vel[jj]);
+  }
+  std::vector<double> toSpeed;
+  if (wantRangeRate)
+  {
+    toSpeed.resize(toCount);
+    for (size_t jj = 0; jj < toCount; ++jj)
+      toSpeed[jj] = to.vel[jj].length();
+  }
+
+  for (size_t ii = 0; ii < fromCount; ++ii)
+  {
+    PairwiseFrame& frame = frames[ii];
+    const Vec3& lla = from.lla[ii];
+    if (ellipsoid)
+    {
+      CoordinateConverter::setLocalToEarthMatrix(lla.lat(), lla.lon(), LOCAL_LEVEL_FRAME_ENU, frame.ecefToEnu);
+      CoordinateConverter::convertGeodeticPosToEcef(lla, frame.pos);
+    }
+    if (wantClosing)
+      frame.vel = ellipsoid ? pairwiseEcefVelocity(lla, from.vel[ii]) : from.vel[ii];
+    if (wantAngles || wantRangeRate)
+    {
+      d3EulertoDCM(from.ori[ii], frame.bodyRot);
+      calculateBodyUnitX(from.ori[ii].yaw(), from.ori[ii].pitch(), frame.bodyX);
+    }
+    if (wantRangeRate)
+      frame.speed = from.vel[ii].length();
+  }
+
+  std::atomic<bool> failed(false);
+  // Calculates all requested quantities for one block of 'to' entities and one 'from' entity
+  auto calculateTile = [&](size_t ii, size_t begin, size_t count, PairwiseVectors& offsets, PairwiseVectors& scratch, std::vector<double>& lengths) {
+    const PairwiseFrame& frame = frames[ii];
+    const size_t outStart = ii * toCount + begin;
+    double* dx = offsets.x.data();
+    double* dy = offsets.y.data();
+    double* dz = offsets.z.data();
+
+    if (ellipsoid || userFlat || model == PERFECT_SPHERE)
+    {
+      // X-East tangent plane offsets for the ellipsoid models, offsets in the shared frame otherwise
+      pairwiseOffsets(ellipsoid ? frame.ecefToEnu : nullptr, frame.pos, toPos.x.data() + begin, toPos.y.data() + begin, toPos.z.data() + begin,
+        count, dx, dy, dz);
+      if (wantSlant)
+        pairwiseLengths(dx, dy, dz, count, results.slant.data() + outStart);
+      if (wantGround)
+      {
+        double* out = results.groundDist.data() + outStart;
+        if (model == WGS_84)
+        {
+          const Vec3& lla = from.lla[ii];
+          const SodanoGeodesic geodesic(lla.lat(), lla.lon(), 0.);
+          for (size_t kk = 0; kk < count; ++kk)
+            out[kk] = geodesic.inverse(to.lla[begin + kk].lat(), to.lla[begin + kk].lon());
+        }
+        else
+          pairwiseLengths(dx, dy, nullptr, count, out);
+      }
+      if (wantAngles)
+      {
+        for (size_t kk = 0; kk < count; ++kk)
+          pairwiseRelAng(dx[kk], dy[kk], dz[kk], frame, &results.azim[outStart + kk], &results.elev[outStart + kk], &results.cmp[outStart + kk]);
+      }
+    }
+
+    if (localFlat)
+    {
+      // Scaled flat earth frame at the 'from' entity, as the single pair functions set up
+      CoordinateConverter cc;
+      cc.setReferenceOrigin(from.lla[ii]);
+      PairwiseVectors origin;
+      if (pairwiseToFlat(cc, from.lla, ii, 1, origin) != 0 || pairwiseToFlat(cc, to.lla, begin, count, scratch) != 0)
+      {
+        failed = true;
+        return;
+      }
+      pairwiseOffsets(nullptr, Vec3(origin.x[0], origin.y[0], origin.z[0]), scratch.x.data(), scratch.y.data(), scratch.z.data(), count, dx, dy, dz);
+    }
+
+    if (wantClosing)
+    {
+      const double* vx = toVel.x.data() + begin;
+      const double* vy = toVel.y.data() + begin;
+      const double* vz = toVel.z.data() + begin;
+      double* out = results.closingVelocity.data() + outStart;
+      if (ellipsoid)
+      {
+        // Closing velocity is the same in ECEF and X-East coordinates; use ECEF offsets to match the ECEF velocities
+        pairwiseOffsets(nullptr, frame.pos, toPos.x.data() + begin, toPos.y.data() + begin, toPos.z.data() + begin,
+          count, scratch.x.data(), scratch.y.data(), scratch.z.data());
+        pairwiseClosingVelocity(scratch.x.data(), scratch.y.data(), scratch.z.data(), frame.vel, vx, vy, vz, count, lengths.data(), out);
+      }
+      else
+        pairwiseClosingVelocity(dx, dy, dz, frame.vel, vx, vy, vz, count, lengths.data(), out);
+    }
+
+    if (wantRangeRate)
+    {
+      const double fromYaw = from.ori[ii].yaw();
+      for (size_t kk = 0; kk < count; ++kk)
+      {
+        double bearing = 0.0;
+        // Reuse the relative azimuth when it was computed in the same frame
+        if (wantAngles && !localFlat)
+          bearing = results.azim[outStart + kk];
+        else
+          pairwiseRelAng(dx[kk], dy[kk], dz[kk], frame, &bearing, nullptr, nullptr);
+        results.rangeRate[outStart + kk] = frame.speed * cos(fromYaw - bearing) - toSpeed[begin + kk] * cos(to.ori[begin + kk].yaw() - bearing);
+      }
+    }
+  };
+
+  const size_t blocksPerFrom = (toCount + PAIRWISE_BLOCK_SIZE - 1) / PAIRWISE_BLOCK_SIZE;
+  const size_t tileCount = fromCount * blocksPerFrom;
+  auto calculateRange = [&](size_t firstTile, size_t endTile) {
+    PairwiseVectors offsets;
+    PairwiseVectors scratch;
+    offsets.resize(PAIRWISE_BLOCK_SIZE);
+    scratch.resize(PAIRWISE_BLOCK_SIZE);
+    std::vector<double> lengths(PAIRWISE_BLOCK_SIZE);
+    for (size_t tile = firstTile; tile < endTile; ++tile)
+    {
+      const size_t ii = tile / blocksPerFrom;
+      const size_t begin = (tile % blocksPerFrom) * PAIRWISE_BLOCK_SIZE;
+      calculateTile(ii, begin, std::min(PAIRWISE_BLOCK_SIZE, toCount - begin), offsets, scratch, lengths);
+    }
+  };
+
+  parallelFor(tileCount, multithreaded ? pairCount / PAIRWISE_MIN_PER_THREAD : 1, calculateRange);
+
+  if (failed)
+  {
+    SIM_WARN << "calculatePairwise, unable to convert to FLAT_EARTH at a 'from' entity: " << __LINE__ << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
 /**
 * This function implements Sodano's direct solution algorithm to determine geodetic
 * longitude and latitude and back azimuth given a geodetic reference longitude
@@ -511,45 +896,7 @@ void sodanoDirect(const double refLat, const double refLon, const double refAlt,
     return;
   }
 
-  const double reqtr = WGS_A + refAlt;
-  const double rpolr = reqtr * (1.0 - WGS_F);
-  const double flat = 1. - (rpolr/reqtr);
-  const double ecc2 = (reqtr*reqtr - rpolr*rpolr)/(rpolr*rpolr);
-  const double theta = dist / rpolr;
-  const double beta1 = atan2(rpolr*sin(refLat), reqtr*cos(refLat));
-
-  const double sbeta1 = sin(beta1);
-  const double cbeta1 = cos(beta1);
-  const double stheta = sin(theta);
-  const double ctheta = cos(theta);
-  const double saz = sin(azfwd);
-  const double caz = cos(azfwd);
-
-  const double g = cbeta1*caz;
-  const double h = cbeta1*saz;
-
-  const double m = (1.+0.5*ecc2*sbeta1*sbeta1)*(1.-h*h)*0.5;
-  const double n = (1.+0.5*ecc2*sbeta1*sbeta1)*(ctheta*sbeta1*sbeta1+g*sbeta1*stheta)*0.5;
-  const double length = h*(-flat*theta+3.*flat*flat*n*stheta+3.*flat*flat*m*(theta-stheta*ctheta)*0.5);
-  const double capm = m*ecc2;
-  const double capn = n*ecc2;
-  const double delta = theta - capn*stheta + 0.5*capm*(stheta*ctheta - theta) + (5./2.)*capn*capn*stheta*ctheta +
-    (capm*capm/16.)*(11.*theta-13.*stheta*ctheta-8.*theta*ctheta*ctheta+10.*stheta*ctheta*ctheta*ctheta)
-    + 0.5*capm*capn*(3.*stheta+2.*theta*ctheta-5.*stheta*ctheta*ctheta);
-
-  const double sdel = sin(delta);
-  const double cdel = cos(delta);
-  const double f = g*cdel - sbeta1*sdel;
-  const double sbeta2 = sbeta1*cdel + g*sdel;
-  const double cbeta2 = sqrt(h*h + f*f);
-  const double lamda = atan2((sdel*saz), (cbeta1*cdel - sbeta1*sdel*caz));
-
-  // Set second latitude and longitude point
-  if (latOut) *latOut = atan2(reqtr*sbeta2, rpolr*cbeta2);
-  if (lonOut) *lonOut = refLon + lamda + length;
-
-  // Back azimuth
-  if (azbck) *azbck = atan2(-h, (sbeta1*sdel - g*cdel));
+  SodanoGeodesic(refLat, refLon, refAlt).direct(dist, azfwd, latOut, lonOut, azbck);
 }
 
 /**
@@ -562,60 +909,7 @@ double sodanoInverse(const double refLat, const double refLon, const double refA
   // E. M. Sodano and T. A. Robinson,
   // "Direct and Inverse Solutions in Geodesics Technical Report 7"
   // U.S. Army Map Service, Washington, DC 1963 pp. 15-27.
-  if (refLat == lat && refLon == lon)
-  {
-    if (azfwd) *azfwd = 0;
-    if (azbck) *azbck = 0;
-    return 0.0;
-  }
-
-  const double reqtr = WGS_A + refAlt;
-  const double rpolr = reqtr * (1.0 - WGS_F);
-  const double flat = 1. - (rpolr/reqtr);
-  const double deltaLon = lon - refLon;
-  const double beta1 = atan2((rpolr*sin(refLat)), (reqtr*cos(refLat)));
-  const double beta2 = atan2((rpolr*sin(lat)), (reqtr*cos(lat)));
-  const double sbet1 = sin(beta1);
-  const double sbet2 = sin(beta2);
-  const double cbet1 = cos(beta1);
-  const double cbet2 = cos(beta2);
-  const double sl = sin(deltaLon);
-  const double sl2 = sin(0.5*deltaLon);
-
-  const double a = sbet1*sbet2;
-  const double b = cbet1*cbet2;
-  const double cdel = a + b*cos(deltaLon);
-  const double n = (reqtr-rpolr) / (reqtr+rpolr);
-  const double b2mb1 = (lat-refLat) + 2.*(a*(n + n*n + n*n*n)-b*(n - n*n + n*n*n)) * sin(lat-refLat);
-
-  const double d = sin(b2mb1) + 2.*cbet2*sbet1*sl2*sl2;
-  const double sdel = sqrt(sl*sl*cbet2*cbet2 + d*d);
-  const double delta = fabs(atan2(sdel, cdel));
-
-  const double c = b*sl/sdel;
-  const double m = 1. - c*c;
-  const double f2 = flat*flat;
-  const double d2 = delta*delta;
-
-  if (azfwd || azbck)
-  {
-    // Forward and back azimuths
-    const double lamda = deltaLon+c*((flat+f2)*delta-0.5*a*f2*(sdel+2.*d2/sdel)+
-      0.25*m*f2*(sdel*cdel-5.*delta+4.*d2/tan(delta)));
-
-    const double slam = sin(lamda);
-    const double slam2 = sin(0.5*lamda);
-
-    if (azfwd) *azfwd = atan2((cbet2*slam), (sin(b2mb1) + 2.*cbet2*sbet1*slam2*slam2));
-    if (azbck) *azbck = atan2((-cbet1*slam), (2.*cbet1*sbet2*slam2*slam2 - sin(b2mb1)));
-  }
-
-  // Geodesic length
-  return rpolr*((1.+flat+f2)*delta + a*((flat+f2)*sdel-f2*d2/(2.*sdel))
-    -0.5*m*((flat+f2)*(delta+sdel*cdel)-f2*d2/tan(delta))
-    -0.5*a*a*f2*sdel*cdel+(f2*m*m/16.)
-    *(delta+sdel*cdel-2.*sdel*cdel*cdel*cdel-8.*d2/tan(delta))
-    +0.5*a*m*f2*(sdel*cdel*cdel+d2/sdel));
+  return SodanoGeodesic(refLat, refLon, refAlt).inverse(lat, lon, azfwd, azbck);
 }
 
 /**
@@ -647,6 +941,8 @@ NumericalSearchType calculateGeodesicDRCR(const Vec3 &fromLla, const double &yaw
   const double latref = fromLla[0];
   const double lonref = fromLla[1];
   const double azref  = yaw;
+  // Origin terms are reused by every direct solution in the search below
+  const SodanoGeodesic fromGeodesic(latref, lonref, fromLla[2]);
 
   // Get downrange/crossrange reference point and azimuth
   const double lat = toLla[0];
@@ -658,7 +954,7 @@ NumericalSearchType calculateGeodesicDRCR(const Vec3 &fromLla, const double &yaw
   double azf = 0;
   if (fabs(lonref - lon) > LATLON_ERR_TOL_DOUBLE || fabs(latref - lat) > LATLON_ERR_TOL_DOUBLE)
   {
-    dwnrng = sodanoInverse(latref, lonref, fromLla[2], lat, lon, &azf);
+    dwnrng = fromGeodesic.inverse(lat, lon, &azf);
   }
 
   // if vehicle at reference point, return zero ranges
@@ -758,11 +1054,11 @@ NumericalSearchType calculateGeodesicDRCR(const Vec3 &fromLla, const double &yaw
         // of a point at "dwnrng" along reference azimuth
         if (dwnrng > 0.01 * minDR)
         {
-          sodanoDirect(latref, lonref, fromLla[2], dwnrng, azref, &lat2, &lon2, &azbk);
+          fromGeodesic.direct(dwnrng, azref, &lat2, &lon2, &azbk);
         }
         else if (dwnrng < -0.01 * minDR)
         {
-          sodanoDirect(latref, lonref, fromLla[2], -dwnrng, azref+M_PI, &lat2, &lon2, &azbk);
+          fromGeodesic.direct(-dwnrng, azref+M_PI, &lat2, &lon2, &azbk);
         }
         else
         {
@@ -29,6 +29,7 @@
 * radians for latitude/longitude and other angles, and meters per second for velocity.
 */
 
+#include <vector>
 #include "simCore/Common/Common.h"
 #include "simCore/Calc/NumericalAnalysis.h"
 #include "simCore/Calc/CoordinateConverter.h"
@@ -251,6 +252,61 @@ namespace simCore
   */
   SDKCORE_EXPORT std::string formatBearingAspectAngle(double angleRadians);
 
+  /// Quantities computed by calculatePairwise(); combine values to request several in one pass
+  enum PairwiseCalculation
+  {
+    PAIRWISE_REL_AZ_EL = 0x01,          ///< Relative azimuth, elevation, and composite angles, as calculateRelAzEl()
+    PAIRWISE_SLANT = 0x02,              ///< Slant distance, as calculateSlant()
+    PAIRWISE_GROUND_DIST = 0x04,        ///< Ground distance, as calculateGroundDist()
+    PAIRWISE_CLOSING_VELOCITY = 0x08,   ///< Closing velocity, as calculateClosingVelocity()
+    PAIRWISE_RANGE_RATE = 0x10          ///< Range rate, as calculateRangeRate()
+  };
+
+  /// States of a group of entities for calculatePairwise(); each vector holds one value per entity
+  struct PairwiseStates
+  {
+    std::vector<Vec3> lla;  ///< Latitude, longitude, and altitude of each entity
+    std::vector<Vec3> ori;  ///< Yaw, pitch, roll of each entity; needed by the 'from' group for angles and by both groups for range rate
+    std::vector<Vec3> vel;  ///< Velocity X/Y/Z in m/s in an LLA frame; needed for closing velocity and range rate
+  };
+
+  /**
+  * Results of calculatePairwise().  Each requested quantity holds one value per (from, to) pair, at
+  * index fromIndex * toCount + toIndex; quantities that were not requested are left empty.
+  */
+  struct PairwiseResults
+  {
+    std::vector<double> azim;             ///< Relative azimuth along the 'from' entity's line of sight
+    std::vector<double> elev;             ///< Relative elevation along the 'from' entity's line of sight
+    std::vector<double> cmp;              ///< Composite (bore sight) angle
+    std::vector<double> slant;            ///< Slant distance in meters
+    std::vector<double> groundDist;       ///< Ground distance in meters
+    std::vector<double> closingVelocity;  ///< Closing velocity in m/s
+    std::vector<double> rangeRate;        ///< Range rate in m/s
+  };
+
+  /**
+  * @brief Calculates relative geometry between every pair of entities in two groups
+  *
+  * Computes calculateRelAzEl(), calculateSlant(), calculateGroundDist(), calculateClosingVelocity(), and
+  * calculateRangeRate() for each (from, to) pair in one pass, with results matching the single pair functions.
+  * Positions of the 'to' entities are converted once, the local frame of each 'from' entity is set up once,
+  * and the per pair arithmetic runs in loops the compiler can vectorize.  Large requests are split across threads.
+  * A single 'from' entity gives a one-to-many calculation.
+  * @param[in ] from States of the 'from' entities, such as sensors
+  * @param[in ] to States of the 'to' entities, such as targets
+  * @param[in ] calculations Combination of PairwiseCalculation values to compute
+  * @param[in ] model Earth model to perform the calculations in
+  * @param[in ] coordConv If model is flat earth, then this must point to an initialized CoordinateConverter with a reference origin set,
+  *   used for the angle, slant, and ground distance calculations as in the single pair functions.  Optional for other models
+  * @param[out] results Requested quantities, resized to from.lla.size() * to.lla.size()
+  * @param[in ] multithreaded If false, all work is done on the calling thread
+  * @return 0 on success; !0 if the inputs are inconsistent or a requested quantity is not supported for the model,
+  *   in which case the affected results are 0 as in the single pair functions
+  */
+  SDKCORE_EXPORT int calculatePairwise(const PairwiseStates& from, const PairwiseStates& to, unsigned int calculations,
+    const EarthModelCalculations model, const CoordinateConverter* coordConv, PairwiseResults& results, bool multithreaded = true);
+
   //////////////////////////////////////////////////////////////////////
   ////////////////// Helper functions for Calculation //////////////////
   //////////////////////////////////////////////////////////////////////
@@ -341,6 +397,7 @@ namespace simCore
   * @param[out] lonOut Geodetic longitude of point 2 (rad)
   * @param[out] azbck Backward azimuth from second point to reference (rad)
   * @pre one of the lat, lon or azbck params must be valid
+  * @see SodanoGeodesic for repeated solutions from the same reference point
   */
   SDKCORE_EXPORT void sodanoDirect(const double refLat, const double refLon, const double refAlt, const double dist, const double azfwd, double *latOut, double *lonOut, double *azbck=nullptr);
 
@@ -359,6 +416,7 @@ namespace simCore
   * @param[out] azfwd Forward azimuth from reference to second point clockwise from North (rad), not calculated if nullptr
   * @param[out] azbck Backward azimuth from second point to reference (rad), not calculated if nullptr
   * @return dist, Geodesic length or distance from reference to second point (m)
+  * @see SodanoGeodesic for repeated solutions from the same reference point
   */
   SDKCORE_EXPORT double sodanoInverse(const double refLat, const double refLon, const double refAlt, const double lat, const double lon, double *azfwd=nullptr, double *azbck=nullptr);
 
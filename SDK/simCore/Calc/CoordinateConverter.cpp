@@ -20,15 +20,18 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <cassert>
 #include <limits>
+#include <vector>
 
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Math.h"
 #include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/System/ParallelFor.h"
 
 namespace simCore
 {
@@ -906,6 +909,368 @@ int CoordinateConverter::convert(const Coordinate &inCoord, Coordinate &outCoord
   return 0;
 }
 
+namespace
+{
+  /// Returns true for the scaled flat earth systems
+  bool isFlatSystem(CoordinateSystem system)
+  {
+    return system == COORD_SYS_NED || system == COORD_SYS_NWU || system == COORD_SYS_ENU;
+  }
+
+  /// Positions converted together through every step, small enough to stay in cache
+  constexpr size_t BATCH_BLOCK_SIZE = 1024;
+  /// Minimum positions per thread before a batch is split between threads
+  constexpr size_t BATCH_MIN_PER_THREAD = 32768;
+}
+
+int CoordinateConverter::convertPositions(CoordinateSystem inSystem, std::span<const double> inX, std::span<const double> inY, std::span<const double> inZ,
+  CoordinateSystem outSystem, std::span<double> outX, std::span<double> outY, std::span<double> outZ, double elapsedEciTime) const
+{
+  const size_t count = inX.size();
+  if (inY.size() != count || inZ.size() != count || outX.size() != count || outY.size() != count || outZ.size() != count)
+  {
+    SIM_ERROR << "convertPositions, position arrays differ in size: " << __LINE__ << std::endl;
+    return 1;
+  }
+  if (count == 0)
+    return 0;
+
+  // Build the same conversion path that convert() follows for this pair of systems
+  struct Step
+  {
+    BatchStep step;
+    CoordinateSystem from;
+    CoordinateSystem to;
+  };
+  Step route[5];
+  size_t numSteps = 0;
+  auto addStep = [&route, &numSteps](BatchStep step, CoordinateSystem from, CoordinateSystem to) {
+    route[numSteps++] = { step, from, to };
+  };
+
+  if (inSystem == outSystem)
+  {
+    // copy only
+  }
+  else if (isFlatSystem(inSystem) && isFlatSystem(outSystem))
+    addStep(BATCH_FLAT_TO_FLAT, inSystem, outSystem);
+  else if (inSystem == COORD_SYS_LLA && isFlatSystem(outSystem))
+    addStep(BATCH_LLA_TO_FLAT, inSystem, outSystem);
+  else if (isFlatSystem(inSystem) && outSystem == COORD_SYS_LLA)
+    addStep(BATCH_FLAT_TO_LLA, inSystem, outSystem);
+  else if (inSystem == COORD_SYS_XEAST && outSystem == COORD_SYS_GTP)
+    addStep(BATCH_XEAST_TO_GTP, inSystem, outSystem);
+  else if (inSystem == COORD_SYS_GTP && outSystem == COORD_SYS_XEAST)
+    addStep(BATCH_GTP_TO_XEAST, inSystem, outSystem);
+  else
+  {
+    // All other conversions pass through ECEF
+    switch (inSystem)
+    {
+    case COORD_SYS_LLA:
+      addStep(BATCH_LLA_TO_ECEF, COORD_SYS_LLA, COORD_SYS_ECEF);
+      break;
+    case COORD_SYS_NED:
+    case COORD_SYS_NWU:
+    case COORD_SYS_ENU:
+      addStep(BATCH_FLAT_TO_LLA, inSystem, COORD_SYS_LLA);
+      addStep(BATCH_LLA_TO_ECEF, COORD_SYS_LLA, COORD_SYS_ECEF);
+      break;
+    case COORD_SYS_ECEF:
+      break;
+    case COORD_SYS_ECI:
+      addStep(BATCH_ECI_TO_ECEF, COORD_SYS_ECI, COORD_SYS_ECEF);
+      break;
+    case COORD_SYS_XEAST:
+      addStep(BATCH_XEAST_TO_ECEF, COORD_SYS_XEAST, COORD_SYS_ECEF);
+      break;
+    case COORD_SYS_GTP:
+      addStep(BATCH_GTP_TO_XEAST, COORD_SYS_GTP, COORD_SYS_XEAST);
+      addStep(BATCH_XEAST_TO_ECEF, COORD_SYS_XEAST, COORD_SYS_ECEF);
+      break;
+    default:
+      SIM_ERROR << "convertPositions, unsupported input coordinate system: " << __LINE__ << std::endl;
+      return 1;
+    }
+
+    switch (outSystem)
+    {
+    case COORD_SYS_LLA:
+      addStep(BATCH_ECEF_TO_LLA, COORD_SYS_ECEF, COORD_SYS_LLA);
+      break;
+    case COORD_SYS_NED:
+    case COORD_SYS_NWU:
+    case COORD_SYS_ENU:
+      addStep(BATCH_ECEF_TO_LLA, COORD_SYS_ECEF, COORD_SYS_LLA);
+      addStep(BATCH_LLA_TO_FLAT, COORD_SYS_LLA, outSystem);
+      break;
+    case COORD_SYS_ECEF:
+      break;
+    case COORD_SYS_ECI:
+      addStep(BATCH_ECEF_TO_ECI, COORD_SYS_ECEF, COORD_SYS_ECI);
+      break;
+    case COORD_SYS_XEAST:
+      addStep(BATCH_ECEF_TO_XEAST, COORD_SYS_ECEF, COORD_SYS_XEAST);
+      break;
+    case COORD_SYS_GTP:
+      addStep(BATCH_ECEF_TO_XEAST, COORD_SYS_ECEF, COORD_SYS_XEAST);
+      addStep(BATCH_XEAST_TO_GTP, COORD_SYS_XEAST, COORD_SYS_GTP);
+      break;
+    default:
+      SIM_ERROR << "convertPositions, unsupported output coordinate system: " << __LINE__ << std::endl;
+      return 1;
+    }
+  }
+
+  // Check the reference origin once for the whole batch, rather than per position
+  for (size_t ii = 0; ii < numSteps; ++ii)
+  {
+    const bool usesFlat = isFlatSystem(route[ii].from) || isFlatSystem(route[ii].to);
+    const bool usesTangentPlane = route[ii].from == COORD_SYS_XEAST || route[ii].to == COORD_SYS_XEAST;
+    if ((usesFlat || usesTangentPlane) && !hasReferenceOrigin())
+    {
+      SIM_ERROR << "convertPositions, reference origin not set: " << __LINE__ << std::endl;
+      return 1;
+    }
+    if (usesFlat && refOriginStatus_ == REF_ORIGIN_SCALED_FLAT_EARTH_DEGENERATE)
+    {
+      SIM_ERROR << "convertPositions, degenerate reference origin at/near pole: " << __LINE__ << std::endl;
+      return 1;
+    }
+  }
+
+  // Each block runs through every step before moving on, so its values stay in cache
+  auto convertRange = [&](size_t begin, size_t end) {
+    for (size_t blockStart = begin; blockStart < end; blockStart += BATCH_BLOCK_SIZE)
+    {
+      const size_t blockSize = std::min(BATCH_BLOCK_SIZE, end - blockStart);
+      double* x = outX.data() + blockStart;
+      double* y = outY.data() + blockStart;
+      double* z = outZ.data() + blockStart;
+      if (x != inX.data() + blockStart)
+        std::copy_n(inX.data() + blockStart, blockSize, x);
+      if (y != inY.data() + blockStart)
+        std::copy_n(inY.data() + blockStart, blockSize, y);
+      if (z != inZ.data() + blockStart)
+        std::copy_n(inZ.data() + blockStart, blockSize, z);
+      for (size_t ii = 0; ii < numSteps; ++ii)
+        applyBatchStep_(route[ii].step, route[ii].from, route[ii].to, x, y, z, blockSize, elapsedEciTime);
+    }
+  };
+
+  parallelFor(count, count / BATCH_MIN_PER_THREAD, convertRange);
+  return 0;
+}
+
+void CoordinateConverter::applyBatchStep_(BatchStep step, CoordinateSystem fromSystem, CoordinateSystem toSystem,
+  double* x, double* y, double* z, size_t count, double elapsedEciTime) const
+{
+  // Each loop mirrors the position math of the scalar conversion it replaces, term for term
+  switch (step)
+  {
+  case BATCH_LLA_TO_FLAT:
+  {
+    const double refLat = referenceOrigin_.lat();
+    const double refLon = referenceOrigin_.lon();
+    const double refAlt = referenceOrigin_.alt();
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double north = angFixPI(x[ii] - refLat) * latRadius_;
+      const double east = angFixPI(y[ii] - refLon) * lonRadius_;
+      const double up = z[ii] - refAlt;
+      if (toSystem == COORD_SYS_NED)
+      {
+        x[ii] = north;
+        y[ii] = east;
+        z[ii] = -up;
+      }
+      else if (toSystem == COORD_SYS_ENU)
+      {
+        x[ii] = east;
+        y[ii] = north;
+        z[ii] = up;
+      }
+      else
+      {
+        x[ii] = north;
+        y[ii] = -east;
+        z[ii] = up;
+      }
+    }
+    break;
+  }
+
+  case BATCH_FLAT_TO_LLA:
+  {
+    const double refLat = referenceOrigin_.lat();
+    const double refLon = referenceOrigin_.lon();
+    const double refAlt = referenceOrigin_.alt();
+    if (fromSystem == COORD_SYS_NED)
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+      {
+        const double lat = x[ii] * invLatRadius_ + refLat;
+        const double lon = y[ii] * invLonRadius_ + refLon;
+        x[ii] = lat;
+        y[ii] = lon;
+        z[ii] = -z[ii] + refAlt;
+      }
+    }
+    else if (fromSystem == COORD_SYS_ENU)
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+      {
+        const double lat = y[ii] * invLatRadius_ + refLat;
+        const double lon = x[ii] * invLonRadius_ + refLon;
+        x[ii] = lat;
+        y[ii] = lon;
+        z[ii] = z[ii] + refAlt;
+      }
+    }
+    else
+    {
+      for (size_t ii = 0; ii < count; ++ii)
+      {
+        x[ii] = x[ii] * invLatRadius_ + refLat;
+        y[ii] = -y[ii] * invLonRadius_ + refLon;
+        z[ii] = z[ii] + refAlt;
+      }
+    }
+    break;
+  }
+
+  case BATCH_FLAT_TO_FLAT:
+  {
+    const bool nedEnu = (fromSystem == COORD_SYS_NED && toSystem == COORD_SYS_ENU) || (fromSystem == COORD_SYS_ENU && toSystem == COORD_SYS_NED);
+    const bool nedNwu = (fromSystem == COORD_SYS_NED && toSystem == COORD_SYS_NWU) || (fromSystem == COORD_SYS_NWU && toSystem == COORD_SYS_NED);
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double inX = x[ii];
+      const double inY = y[ii];
+      if (nedEnu)
+      {
+        x[ii] = inY;
+        y[ii] = inX;
+        z[ii] = -z[ii];
+      }
+      else if (nedNwu)
+      {
+        y[ii] = -inY;
+        z[ii] = -z[ii];
+      }
+      else if (fromSystem == COORD_SYS_ENU)
+      {
+        // ENU to NWU
+        x[ii] = inY;
+        y[ii] = -inX;
+      }
+      else
+      {
+        // NWU to ENU
+        x[ii] = -inY;
+        y[ii] = inX;
+      }
+    }
+    break;
+  }
+
+  case BATCH_LLA_TO_ECEF:
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double sLat = sin(x[ii]);
+      const double Rn = WGS_A / sqrt(1.0 - WGS_ESQ * square(sLat));
+      const double cLat = cos(x[ii]);
+      const double lon = y[ii];
+      const double alt = z[ii];
+      x[ii] = (Rn + alt) * cLat * cos(lon);
+      y[ii] = (Rn + alt) * cLat * sin(lon);
+      z[ii] = (Rn * (1.0 - WGS_ESQ) + alt) * sLat;
+    }
+    break;
+
+  case BATCH_ECEF_TO_LLA:
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      Vec3 llaPos;
+      CoordinateConverter::convertEcefToGeodeticPos(Vec3(x[ii], y[ii], z[ii]), llaPos);
+      x[ii] = llaPos.lat();
+      y[ii] = llaPos.lon();
+      z[ii] = llaPos.alt();
+    }
+    break;
+
+  case BATCH_ECEF_TO_ECI:
+  case BATCH_ECI_TO_ECEF:
+  {
+    // z axis rotation of omega; negative when converting from ECI to ECEF
+    const double rotationRate = (step == BATCH_ECI_TO_ECEF) ? -EARTH_ROTATION_RATE : EARTH_ROTATION_RATE;
+    const double eciRotation = angFix2PI(rotationRate * elapsedEciTime);
+    const double cosOmega = cos(eciRotation);
+    const double sinOmega = sin(eciRotation);
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double inX = x[ii];
+      const double inY = y[ii];
+      x[ii] = cosOmega * inX - sinOmega * inY;
+      y[ii] = cosOmega * inY + sinOmega * inX;
+    }
+    break;
+  }
+
+  case BATCH_ECEF_TO_XEAST:
+  {
+    const double (&r)[3][3] = rotationMatrixENU_;
+    const Vec3& t = tangentPlaneTranslation_;
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double px = x[ii] - t.x();
+      const double py = y[ii] - t.y();
+      const double pz = z[ii] - t.z();
+      x[ii] = r[0][0] * px + r[0][1] * py + r[0][2] * pz;
+      y[ii] = r[1][0] * px + r[1][1] * py + r[1][2] * pz;
+      z[ii] = r[2][0] * px + r[2][1] * py + r[2][2] * pz;
+    }
+    break;
+  }
+
+  case BATCH_XEAST_TO_ECEF:
+  {
+    const double (&r)[3][3] = rotationMatrixENU_;
+    const Vec3& t = tangentPlaneTranslation_;
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double px = x[ii];
+      const double py = y[ii];
+      const double pz = z[ii];
+      x[ii] = (r[0][0] * px + r[1][0] * py + r[2][0] * pz) + t.x();
+      y[ii] = (r[0][1] * px + r[1][1] * py + r[2][1] * pz) + t.y();
+      z[ii] = (r[0][2] * px + r[1][2] * py + r[2][2] * pz) + t.z();
+    }
+    break;
+  }
+
+  case BATCH_XEAST_TO_GTP:
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double dx = x[ii] - tangentPlaneOffsetX_;
+      const double dy = y[ii] - tangentPlaneOffsetY_;
+      x[ii] = dx * cosTPR_ - dy * sinTPR_;
+      y[ii] = dx * sinTPR_ + dy * cosTPR_;
+    }
+    break;
+
+  case BATCH_GTP_TO_XEAST:
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+      const double inX = x[ii];
+      const double inY = y[ii];
+      x[ii] = (inX * cosTPR_ + inY * sinTPR_) + tangentPlaneOffsetX_;
+      y[ii] = (-inX * sinTPR_ + inY * cosTPR_) + tangentPlaneOffsetY_;
+    }
+    break;
+  }
+}
+
 /// convert geodetic projection (LLA) to flat earth projection (NED/NWU/ENU)
 ///@pre flatCoord valid, ref origin set, in coord is LLA, system is NED/NWU/ENU, llaCoord does not alias flatCoord
 int CoordinateConverter::convertGeodeticToFlat_(const Coordinate& llaCoord, Coordinate& flatCoord, CoordinateSystem system) const
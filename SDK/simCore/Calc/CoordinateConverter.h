@@ -24,6 +24,7 @@
 #define SIMCORE_CALC_COORDCONVERT_H
 
 #include <cassert>
+#include <span>
 
 #include "simCore/Common/Common.h"
 #include "simCore/Calc/CoordinateSystem.h"
@@ -293,6 +294,27 @@ namespace simCore
     */
     int convert(const Coordinate &inCoord, Coordinate &outCoord, CoordinateSystem outSystem) const;
 
+    /**
+    * @brief Converts an array of positions between the supported projections
+    *
+    * Batch form of convert() for positions only, with input and output stored as separate x/y/z arrays
+    * of the same size.  Each position follows the same conversion path as convert(), so results match
+    * the scalar path.  Positions are processed in blocks of simple loops that the compiler can vectorize,
+    * and large batches are split between threads.  Output arrays may be the same as the input arrays.
+    * @param[in ] inSystem projection system of the input positions
+    * @param[in ] inX input x values (or latitudes in radians for LLA)
+    * @param[in ] inY input y values (or longitudes in radians for LLA)
+    * @param[in ] inZ input z values (or altitudes in meters for LLA)
+    * @param[in ] outSystem projection system of the output positions
+    * @param[out] outX output x values (or latitudes in radians for LLA)
+    * @param[out] outY output y values (or longitudes in radians for LLA)
+    * @param[out] outZ output z values (or altitudes in meters for LLA)
+    * @param[in ] elapsedEciTime elapsed ECI time applied to every position when converting to/from ECI
+    * @return 0 on success, !0 on failure, such as arrays of different sizes or a missing reference origin for a system that requires one
+    */
+    int convertPositions(CoordinateSystem inSystem, std::span<const double> inX, std::span<const double> inY, std::span<const double> inZ,
+      CoordinateSystem outSystem, std::span<double> outX, std::span<double> outY, std::span<double> outZ, double elapsedEciTime = 0.0) const;
+
     //------------------------------------------------------------------------
     // Static functions which perform coordinate system conversions but do not
     // maintain any state information in the CoordinateConverter class
@@ -648,6 +670,36 @@ namespace simCore
     * @pre gtpCoord param valid and reference origin must be set
     */
     void reverseTPOffsetRotate_(Coordinate &gtpCoord) const;
+
+    /// Position-only conversion steps chained together by convertPositions()
+    enum BatchStep
+    {
+      BATCH_LLA_TO_FLAT,
+      BATCH_FLAT_TO_LLA,
+      BATCH_FLAT_TO_FLAT,
+      BATCH_LLA_TO_ECEF,
+      BATCH_ECEF_TO_LLA,
+      BATCH_ECEF_TO_ECI,
+      BATCH_ECI_TO_ECEF,
+      BATCH_ECEF_TO_XEAST,
+      BATCH_XEAST_TO_ECEF,
+      BATCH_XEAST_TO_GTP,
+      BATCH_GTP_TO_XEAST
+    };
+
+    /**
+    * @brief Applies one conversion step in place to a block of positions
+    *
+    * @param[in ] step conversion to apply
+    * @param[in ] fromSystem projection system of the positions before the step
+    * @param[in ] toSystem projection system of the positions after the step
+    * @param[in,out] x x values
+    * @param[in,out] y y values
+    * @param[in,out] z z values
+    * @param[in ] count number of positions
+    * @param[in ] elapsedEciTime elapsed ECI time for ECI steps
+    */
+    void applyBatchStep_(BatchStep step, CoordinateSystem fromSystem, CoordinateSystem toSystem, double* x, double* y, double* z, size_t count, double elapsedEciTime) const;
   };
 
 } // End namespace simCore
@@ -0,0 +1,261 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "simNotify/Notify.h"
+#include "simCore/Calc/CoordinateSystem.h"
+#include "simCore/Calc/Geodesic.h"
+#include "simCore/System/ParallelFor.h"
+
+namespace simCore {
+
+namespace
+{
+  /// Points solved together as one unit of work by the batch methods
+  constexpr size_t GEODESIC_BLOCK_SIZE = 1024;
+  /// Minimum points per thread before a batch is split between threads
+  constexpr size_t GEODESIC_MIN_PER_THREAD = 4096;
+
+  /**
+  * Calls func(begin, end) over [0, count) in blocks, spread over threads when there is enough work.
+  * The calling thread does a share of the work.
+  */
+  template <typename Func>
+  void runBlocks(size_t count, bool multithreaded, const Func& func)
+  {
+    const size_t blockCount = (count + GEODESIC_BLOCK_SIZE - 1) / GEODESIC_BLOCK_SIZE;
+    auto runRange = [&](size_t firstBlock, size_t endBlock) {
+      for (size_t block = firstBlock; block < endBlock; ++block)
+        func(block * GEODESIC_BLOCK_SIZE, std::min(count, (block + 1) * GEODESIC_BLOCK_SIZE));
+    };
+
+    parallelFor(blockCount, multithreaded ? count / GEODESIC_MIN_PER_THREAD : 1, runRange);
+  }
+}
+
+// Origin starts as NaN, which never matches, so that setOrigin() always computes the terms
+SodanoGeodesic::SodanoGeodesic()
+  : refLat_(std::numeric_limits<double>::quiet_NaN()),
+    refLon_(0.0),
+    refAlt_(0.0)
+{
+  setOrigin(0.0, 0.0, 0.0);
+}
+
+SodanoGeodesic::SodanoGeodesic(double refLat, double refLon, double refAlt)
+  : refLat_(std::numeric_limits<double>::quiet_NaN()),
+    refLon_(0.0),
+    refAlt_(0.0)
+{
+  setOrigin(refLat, refLon, refAlt);
+}
+
+void SodanoGeodesic::setOrigin(double refLat, double refLon, double refAlt)
+{
+  // prevent redundant calculations when the identical origin is specified
+  if (refLat == refLat_ && refLon == refLon_ && refAlt == refAlt_)
+    return;
+  refLat_ = refLat;
+  refLon_ = refLon;
+  refAlt_ = refAlt;
+
+  reqtr_ = WGS_A + refAlt;
+  rpolr_ = reqtr_ * (1.0 - WGS_F);
+  flat_ = 1. - (rpolr_/reqtr_);
+  f2_ = flat_*flat_;
+  ecc2_ = (reqtr_*reqtr_ - rpolr_*rpolr_)/(rpolr_*rpolr_);
+  const double n = (reqtr_-rpolr_) / (reqtr_+rpolr_);
+  nPlus_ = n + n*n + n*n*n;
+  nMinus_ = n - n*n + n*n*n;
+
+  const double beta1 = atan2((rpolr_*sin(refLat)), (reqtr_*cos(refLat)));
+  sbeta1_ = sin(beta1);
+  cbeta1_ = cos(beta1);
+  directK_ = 1.+0.5*ecc2_*sbeta1_*sbeta1_;
+}
+
+Vec3 SodanoGeodesic::origin() const
+{
+  return Vec3(refLat_, refLon_, refAlt_);
+}
+
+double SodanoGeodesic::inverse(double lat, double lon, double* azfwd, double* azbck) const
+{
+  if (refLat_ == lat && refLon_ == lon)
+  {
+    if (azfwd) *azfwd = 0;
+    if (azbck) *azbck = 0;
+    return 0.0;
+  }
+
+  const double deltaLon = lon - refLon_;
+  const double beta2 = atan2((rpolr_*sin(lat)), (reqtr_*cos(lat)));
+  const double sbet2 = sin(beta2);
+  const double cbet2 = cos(beta2);
+  const double sl = sin(deltaLon);
+  const double sl2 = sin(0.5*deltaLon);
+
+  const double a = sbeta1_*sbet2;
+  const double b = cbeta1_*cbet2;
+  const double cdel = a + b*cos(deltaLon);
+  const double sinDeltaLat = sin(lat-refLat_);
+  const double b2mb1 = (lat-refLat_) + 2.*(a*nPlus_-b*nMinus_) * sinDeltaLat;
+  const double sinB2mb1 = sin(b2mb1);
+
+  const double d = sinB2mb1 + 2.*cbet2*sbeta1_*sl2*sl2;
+  const double sdel = sqrt(sl*sl*cbet2*cbet2 + d*d);
+  const double delta = fabs(atan2(sdel, cdel));
+  const double tanDelta = tan(delta);
+
+  const double c = b*sl/sdel;
+  const double m = 1. - c*c;
+  const double flat = flat_;
+  const double f2 = f2_;
+  const double d2 = delta*delta;
+
+  if (azfwd || azbck)
+  {
+    // Forward and back azimuths
+    const double lamda = deltaLon+c*((flat+f2)*delta-0.5*a*f2*(sdel+2.*d2/sdel)+
+      0.25*m*f2*(sdel*cdel-5.*delta+4.*d2/tanDelta));
+
+    const double slam = sin(lamda);
+    const double slam2 = sin(0.5*lamda);
+
+    if (azfwd) *azfwd = atan2((cbet2*slam), (sinB2mb1 + 2.*cbet2*sbeta1_*slam2*slam2));
+    if (azbck) *azbck = atan2((-cbeta1_*slam), (2.*cbeta1_*sbet2*slam2*slam2 - sinB2mb1));
+  }
+
+  // Geodesic length
+  return rpolr_*((1.+flat+f2)*delta + a*((flat+f2)*sdel-f2*d2/(2.*sdel))
+    -0.5*m*((flat+f2)*(delta+sdel*cdel)-f2*d2/tanDelta)
+    -0.5*a*a*f2*sdel*cdel+(f2*m*m/16.)
+    *(delta+sdel*cdel-2.*sdel*cdel*cdel*cdel-8.*d2/tanDelta)
+    +0.5*a*m*f2*(sdel*cdel*cdel+d2/sdel));
+}
+
+void SodanoGeodesic::direct(double dist, double azfwd, double* latOut, double* lonOut, double* azbck) const
+{
+  const double flat = flat_;
+  const double theta = dist / rpolr_;
+  const double sbeta1 = sbeta1_;
+  const double cbeta1 = cbeta1_;
+  const double stheta = sin(theta);
+  const double ctheta = cos(theta);
+  const double saz = sin(azfwd);
+  const double caz = cos(azfwd);
+
+  const double g = cbeta1*caz;
+  const double h = cbeta1*saz;
+
+  const double m = directK_*(1.-h*h)*0.5;
+  const double n = directK_*(ctheta*sbeta1*sbeta1+g*sbeta1*stheta)*0.5;
+  const double length = h*(-flat*theta+3.*flat*flat*n*stheta+3.*flat*flat*m*(theta-stheta*ctheta)*0.5);
+  const double capm = m*ecc2_;
+  const double capn = n*ecc2_;
+  const double delta = theta - capn*stheta + 0.5*capm*(stheta*ctheta - theta) + (5./2.)*capn*capn*stheta*ctheta +
+    (capm*capm/16.)*(11.*theta-13.*stheta*ctheta-8.*theta*ctheta*ctheta+10.*stheta*ctheta*ctheta*ctheta)
+    + 0.5*capm*capn*(3.*stheta+2.*theta*ctheta-5.*stheta*ctheta*ctheta);
+
+  const double sdel = sin(delta);
+  const double cdel = cos(delta);
+  const double f = g*cdel - sbeta1*sdel;
+  const double sbeta2 = sbeta1*cdel + g*sdel;
+  const double cbeta2 = sqrt(h*h + f*f);
+  const double lamda = atan2((sdel*saz), (cbeta1*cdel - sbeta1*sdel*caz));
+
+  // Set second latitude and longitude point
+  if (latOut) *latOut = atan2(reqtr_*sbeta2, rpolr_*cbeta2);
+  if (lonOut) *lonOut = refLon_ + lamda + length;
+
+  // Back azimuth
+  if (azbck) *azbck = atan2(-h, (sbeta1*sdel - g*cdel));
+}
+
+int SodanoGeodesic::inverseBatch(const double* lat, const double* lon, size_t count, double* dist, double* azfwd, double* azbck, bool multithreaded) const
+{
+  if (count == 0)
+    return 0;
+  if (!lat || !lon || (!dist && !azfwd && !azbck))
+  {
+    SIM_ERROR << "SodanoGeodesic::inverseBatch, invalid params: " << __LINE__ << std::endl;
+    return 1;
+  }
+  runBlocks(count, multithreaded, [&](size_t begin, size_t end) {
+    for (size_t ii = begin; ii < end; ++ii)
+    {
+      const double length = inverse(lat[ii], lon[ii], azfwd ? azfwd + ii : nullptr, azbck ? azbck + ii : nullptr);
+      if (dist)
+        dist[ii] = length;
+    }
+  });
+  return 0;
+}
+
+int SodanoGeodesic::directBatch(const double* dist, const double* azfwd, size_t count, double* latOut, double* lonOut, double* azbck, bool multithreaded) const
+{
+  if (count == 0)
+    return 0;
+  if (!dist || !azfwd || (!latOut && !lonOut && !azbck))
+  {
+    SIM_ERROR << "SodanoGeodesic::directBatch, invalid params: " << __LINE__ << std::endl;
+    return 1;
+  }
+  runBlocks(count, multithreaded, [&](size_t begin, size_t end) {
+    for (size_t ii = begin; ii < end; ++ii)
+      direct(dist[ii], azfwd[ii], latOut ? latOut + ii : nullptr, lonOut ? lonOut + ii : nullptr, azbck ? azbck + ii : nullptr);
+  });
+  return 0;
+}
+
+int SodanoGeodesic::inverseAllPairs(const std::vector<Vec3>& origins, const double* lat, const double* lon, size_t count,
+  double* dist, double* azfwd, double* azbck, bool multithreaded)
+{
+  if (count == 0 || origins.empty())
+    return 0;
+  if (!lat || !lon || (!dist && !azfwd && !azbck))
+  {
+    SIM_ERROR << "SodanoGeodesic::inverseAllPairs, invalid params: " << __LINE__ << std::endl;
+    return 1;
+  }
+
+  std::vector<SodanoGeodesic> solvers;
+  solvers.reserve(origins.size());
+  for (const Vec3& lla : origins)
+    solvers.push_back(SodanoGeodesic(lla.lat(), lla.lon(), lla.alt()));
+
+  // Work is split over all pairs, so that a few origins with many points still use every thread
+  runBlocks(origins.size() * count, multithreaded, [&](size_t begin, size_t end) {
+    for (size_t pair = begin; pair < end; ++pair)
+    {
+      const size_t ii = pair % count;
+      const double length = solvers[pair / count].inverse(lat[ii], lon[ii], azfwd ? azfwd + pair : nullptr, azbck ? azbck + pair : nullptr);
+      if (dist)
+        dist[pair] = length;
+    }
+  });
+  return 0;
+}
+
+}
@@ -0,0 +1,151 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_CALC_GEODESIC_H
+#define SIMCORE_CALC_GEODESIC_H
+
+#include <cstddef>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simCore/Calc/Vec3.h"
+
+namespace simCore
+{
+/**
+ * Solves Sodano's direct and inverse geodesic problems from one origin to many points.  Terms that
+ * depend only on the origin are computed when the origin is set and reused for every destination,
+ * and the batch methods split large requests across threads.  sodanoInverse() and sodanoDirect()
+ * use this class, so single and batched results are identical.
+ *
+ * Reference: E. M. Sodano and T. A. Robinson, "Direct and Inverse Solutions in Geodesics Technical
+ * Report 7", U.S. Army Map Service, Washington, DC 1963 pp. 15-27.
+ */
+class SDKCORE_EXPORT SodanoGeodesic
+{
+public:
+  /** Constructs a solver with its origin at latitude, longitude, and altitude 0 */
+  SodanoGeodesic();
+
+  /**
+   * Constructs a solver with the given origin
+   * @param refLat Geodetic latitude of reference point (rad)
+   * @param refLon Geodetic longitude of reference point (rad)
+   * @param refAlt Height above ellipsoid of reference point (m)
+   */
+  SodanoGeodesic(double refLat, double refLon, double refAlt);
+
+  /**
+   * Changes the origin; does nothing if the origin is unchanged
+   * @param refLat Geodetic latitude of reference point (rad)
+   * @param refLon Geodetic longitude of reference point (rad)
+   * @param refAlt Height above ellipsoid of reference point (m)
+   */
+  void setOrigin(double refLat, double refLon, double refAlt);
+
+  /** @return Geodetic latitude, longitude, and altitude of the origin */
+  Vec3 origin() const;
+
+  /**
+   * Solves the inverse problem from the origin to one point, as sodanoInverse()
+   * @param[in ] lat Geodetic latitude of second point (rad)
+   * @param[in ] lon Geodetic longitude of second point (rad)
+   * @param[out] azfwd Forward azimuth from origin to second point (rad), not calculated if nullptr
+   * @param[out] azbck Backward azimuth from second point to origin (rad), not calculated if nullptr
+   * @return Geodesic length from origin to second point (m)
+   */
+  double inverse(double lat, double lon, double* azfwd = nullptr, double* azbck = nullptr) const;
+
+  /**
+   * Solves the direct problem from the origin, as sodanoDirect()
+   * @param[in ] dist Geodesic length from origin to second point along the forward azimuth (m)
+   * @param[in ] azfwd Forward azimuth from origin to second point (rad)
+   * @param[out] latOut Geodetic latitude of second point (rad), not calculated if nullptr
+   * @param[out] lonOut Geodetic longitude of second point (rad), not calculated if nullptr
+   * @param[out] azbck Backward azimuth from second point to origin (rad), not calculated if nullptr
+   */
+  void direct(double dist, double azfwd, double* latOut, double* lonOut, double* azbck = nullptr) const;
+
+  /**
+   * Solves the inverse problem from the origin to each of count points.  Output arrays may be nullptr
+   * if not needed, and must not overlap the input arrays.
+   * @param[in ] lat Geodetic latitudes of the second points (rad)
+   * @param[in ] lon Geodetic longitudes of the second points (rad)
+   * @param[in ] count Number of points
+   * @param[out] dist Geodesic lengths from origin to each point (m)
+   * @param[out] azfwd Forward azimuths from origin to each point (rad)
+   * @param[out] azbck Backward azimuths from each point to origin (rad)
+   * @param[in ] multithreaded If false, all work is done on the calling thread
+   * @return 0 on success, !0 if inputs are nullptr or no output was requested
+   */
+  int inverseBatch(const double* lat, const double* lon, size_t count, double* dist, double* azfwd = nullptr, double* azbck = nullptr,
+    bool multithreaded = true) const;
+
+  /**
+   * Solves the direct problem from the origin for each of count lengths and azimuths.  Output arrays
+   * may be nullptr if not needed, and must not overlap the input arrays.
+   * @param[in ] dist Geodesic lengths from origin along each forward azimuth (m)
+   * @param[in ] azfwd Forward azimuths from origin (rad)
+   * @param[in ] count Number of points
+   * @param[out] latOut Geodetic latitudes of the second points (rad)
+   * @param[out] lonOut Geodetic longitudes of the second points (rad)
+   * @param[out] azbck Backward azimuths from each second point to origin (rad)
+   * @param[in ] multithreaded If false, all work is done on the calling thread
+   * @return 0 on success, !0 if inputs are nullptr or no output was requested
+   */
+  int directBatch(const double* dist, const double* azfwd, size_t count, double* latOut, double* lonOut, double* azbck = nullptr,
+    bool multithreaded = true) const;
+
+  /**
+   * Solves the inverse problem from every origin to every point.  Outputs hold origins.size() * count
+   * values at index originIndex * count + pointIndex, and may be nullptr if not needed.
+   * @param[in ] origins Geodetic latitude, longitude, and altitude of each origin
+   * @param[in ] lat Geodetic latitudes of the second points (rad)
+   * @param[in ] lon Geodetic longitudes of the second points (rad)
+   * @param[in ] count Number of points
+   * @param[out] dist Geodesic lengths (m)
+   * @param[out] azfwd Forward azimuths from each origin (rad)
+   * @param[out] azbck Backward azimuths to each origin (rad)
+   * @param[in ] multithreaded If false, all work is done on the calling thread
+   * @return 0 on success, !0 if inputs are nullptr or no output was requested
+   */
+  static int inverseAllPairs(const std::vector<Vec3>& origins, const double* lat, const double* lon, size_t count,
+    double* dist, double* azfwd = nullptr, double* azbck = nullptr, bool multithreaded = true);
+
+private:
+  double refLat_;     ///< origin latitude (rad)
+  double refLon_;     ///< origin longitude (rad)
+  double refAlt_;     ///< origin altitude (m)
+  double reqtr_;      ///< equatorial radius raised to the origin altitude
+  double rpolr_;      ///< polar radius raised to the origin altitude
+  double flat_;       ///< flattening of the raised ellipsoid
+  double f2_;         ///< flattening squared
+  double ecc2_;       ///< second eccentricity squared of the raised ellipsoid
+  double nPlus_;      ///< n + n^2 + n^3 for the third flattening n
+  double nMinus_;     ///< n - n^2 + n^3 for the third flattening n
+  double sbeta1_;     ///< sine of the origin's reduced latitude
+  double cbeta1_;     ///< cosine of the origin's reduced latitude
+  double directK_;    ///< 1 + ecc2 * sin^2(beta1) / 2, shared by the direct solution's series terms
+};
+
+}
+
+#endif /* SIMCORE_CALC_GEODESIC_H */
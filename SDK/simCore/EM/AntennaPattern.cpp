@@ -219,6 +219,17 @@ AntennaPattern* loadPatternFile(const std::string& filename, float freqMHz)
 
 // ----------------------------------------------------------------------------
 
+int AntennaPattern::gains(std::span<const AntennaGainParameters> params, std::span<float> results)
+{
+  if (results.size() < params.size())
+    return 1;
+  for (size_t ii = 0; ii < params.size(); ++ii)
+    results[ii] = gain(params[ii]);
+  return 0;
+}
+
+// ----------------------------------------------------------------------------
+
 AntennaPatternGauss::AntennaPatternGauss()
   : AntennaPattern(),
   lastVbw_(-FLT_MAX)
@@ -570,94 +581,211 @@ namespace
   }
 }
 
-/* This function returns the gain for lookup table-based antennaPatterns */
+// ----------------------------------------------------------------------------
+/// AntennaGainTable methods
 
-float calculateGain(const std::map<float, float> *azimData,
-  const std::map<float, float> *elevData,
-  AntennaLobeType &lastLobe,
-  float azim,
-  float elev,
-  float hbw,
-  float vbw,
-  float maxGain,
-  bool applyWeight)
+AntennaGainTable::AntennaGainTable()
+  : minAngle_(0.f),
+  cellsPerRad_(0.f)
+{}
+
+void AntennaGainTable::set(const std::map<float, float>& data)
 {
-  if (!azimData || azimData->size() == 0 || !elevData || elevData->size() == 0)
+  clear();
+  if (data.empty())
+    return;
+
+  breakpoints_.reserve(data.size());
+  for (const auto& angleGain : data)
+    breakpoints_.push_back({ angleGain.first, angleGain.second });
+
+  // Two cells per breakpoint keeps the scan after the indexed jump to a breakpoint or two for
+  // evenly spaced tables, while uneven tables still find the right breakpoint by scanning
+  const size_t cellCount = 2 * breakpoints_.size();
+  minAngle_ = breakpoints_.front().angle;
+  const float range = breakpoints_.back().angle - minAngle_;
+  cellsPerRad_ = (range > 0.f) ? static_cast<float>(cellCount / range) : 0.f;
+  cellStart_.resize(cellCount);
+  unsigned int index = 0;
+  for (size_t cell = 0; cell < cellCount; ++cell)
+  {
+    const float edge = (cellsPerRad_ > 0.f) ? static_cast<float>(minAngle_ + cell / cellsPerRad_) : minAngle_;
+    while (index + 1 < breakpoints_.size() && breakpoints_[index].angle < edge)
+      ++index;
+    cellStart_[cell] = index;
+  }
+}
+
+void AntennaGainTable::clear()
+{
+  breakpoints_.clear();
+  cellStart_.clear();
+  minAngle_ = 0.f;
+  cellsPerRad_ = 0.f;
+}
+
+float AntennaGainTable::gain(float angle) const
+{
+  if (breakpoints_.empty())
     return SMALL_DB_VAL;
 
-  if (hbw == 0.f || vbw == 0.f)
+  // Same results as gainAtAngle() on the source map, which finds the first breakpoint >= angle;
+  // angles at or below the first breakpoint (and NaN) use the first breakpoint's gain
+  const Breakpoint& last = breakpoints_.back();
+  if (!(angle > minAngle_))
+    return breakpoints_.front().gain;
+  if (angle > last.angle)
   {
-    assert(0); // hbw and vbw must be non-zero to avoid divide-by-zero errors
+    // if not found in table, double-check, possibly missed due to rounding errors due to casting
+    if (areEqual(angle, minAngle_))
+      return breakpoints_.front().gain;
+    if (areEqual(angle, last.angle))
+      return last.gain;
     return SMALL_DB_VAL;
   }
 
-  float gain = SMALL_DB_VAL;
+  // Jump to the grid cell, then scan to the first breakpoint >= angle; the scan also corrects
+  // for rounding in the cell calculation
+  const size_t cell = sdkMin(cellStart_.size() - 1, static_cast<size_t>((angle - minAngle_) * cellsPerRad_));
+  size_t index = cellStart_[cell];
+  while (index > 0 && breakpoints_[index - 1].angle >= angle)
+    --index;
+  while (breakpoints_[index].angle < angle)
+    ++index;
+
+  const Breakpoint& hi = breakpoints_[index];
+  if (hi.angle == angle || index == 0)
+    return hi.gain;
+  const Breakpoint& lo = breakpoints_[index - 1];
+  // linearInterpolate casts to double as needed to avoid loss of precision
+  return linearInterpolate(lo.gain, hi.gain, lo.angle, angle, hi.angle);
+}
 
-  if (!applyWeight)
+namespace
+{
+  /** Gain lookup in a compiled table, so that calculateGainT() can use either table type */
+  inline float gainAtAngle(float angle, const AntennaGainTable& table)
   {
-    const float az_gain = gainAtAngle(static_cast<float>(azim), *azimData);
-    if (az_gain == SMALL_DB_VAL)
+    return table.gain(angle);
+  }
+
+  /** Implements calculateGain() for std::map and compiled gain tables */
+  template <typename Table>
+  float calculateGainT(const Table *azimData,
+    const Table *elevData,
+    AntennaLobeType &lastLobe,
+    float azim,
+    float elev,
+    float hbw,
+    float vbw,
+    float maxGain,
+    bool applyWeight)
+  {
+    if (!azimData || azimData->empty() || !elevData || elevData->empty())
       return SMALL_DB_VAL;
-    const float el_gain = gainAtAngle(static_cast<float>(elev), *elevData);
-    if (el_gain == SMALL_DB_VAL)
+
+    if (hbw == 0.f || vbw == 0.f)
+    {
+      assert(0); // hbw and vbw must be non-zero to avoid divide-by-zero errors
       return SMALL_DB_VAL;
+    }
 
-    gain = maxGain + (az_gain + el_gain) / 2.0f;
-  }
+    float gain = SMALL_DB_VAL;
 
-  // Compute angular distance in normalized beam widths
-  const double azim_bw = azim / hbw;
-  const double elev_bw = elev / vbw;
-  const double phi = sqrt(square(azim_bw) + square(elev_bw));
+    if (!applyWeight)
+    {
+      const float az_gain = gainAtAngle(static_cast<float>(azim), *azimData);
+      if (az_gain == SMALL_DB_VAL)
+        return SMALL_DB_VAL;
+      const float el_gain = gainAtAngle(static_cast<float>(elev), *elevData);
+      if (el_gain == SMALL_DB_VAL)
+        return SMALL_DB_VAL;
 
-  // Determine lobe
-  if (phi < 1.29)
-    lastLobe = ANTENNA_LOBE_MAIN;
-  else if (phi < 4.0)
-    lastLobe = ANTENNA_LOBE_SIDE;
-  else if (phi < 5.0)
-    lastLobe = ANTENNA_LOBE_SIDE;
-  else
-    lastLobe = ANTENNA_LOBE_BACK;
+      gain = maxGain + (az_gain + el_gain) / 2.0f;
+    }
 
-  if (!applyWeight)
-    return gain;
+    // Compute angular distance in normalized beam widths
+    const double azim_bw = azim / hbw;
+    const double elev_bw = elev / vbw;
+    const double phi = sqrt(square(azim_bw) + square(elev_bw));
 
-  const double azim_ang = sdkMin(phi * hbw, M_PI);
-  const float az_gain = gainAtAngle(static_cast<float>(azim_ang), *azimData);
-  if (az_gain == SMALL_DB_VAL)
-    return SMALL_DB_VAL;
+    // Determine lobe
+    if (phi < 1.29)
+      lastLobe = ANTENNA_LOBE_MAIN;
+    else if (phi < 4.0)
+      lastLobe = ANTENNA_LOBE_SIDE;
+    else if (phi < 5.0)
+      lastLobe = ANTENNA_LOBE_SIDE;
+    else
+      lastLobe = ANTENNA_LOBE_BACK;
 
-  const double elev_ang = sdkMin(phi * vbw, M_PI_2);
-  const float el_gain = gainAtAngle(static_cast<float>(elev_ang), *elevData);
-  if (el_gain == SMALL_DB_VAL)
-    return SMALL_DB_VAL;
+    if (!applyWeight)
+      return gain;
 
-  // Determine angles (alpha & beta) associated with normalized
-  // azim / elev components.  They will be used to obtain a
-  // 'weighted average' antenna loss value
-  if ((azim_bw == 0.0 && elev_bw == 0.0) || vbw == hbw)
-    return maxGain + (az_gain + el_gain) / 2.0f;
+    const double azim_ang = sdkMin(phi * hbw, M_PI);
+    const float az_gain = gainAtAngle(static_cast<float>(azim_ang), *azimData);
+    if (az_gain == SMALL_DB_VAL)
+      return SMALL_DB_VAL;
+
+    const double elev_ang = sdkMin(phi * vbw, M_PI_2);
+    const float el_gain = gainAtAngle(static_cast<float>(elev_ang), *elevData);
+    if (el_gain == SMALL_DB_VAL)
+      return SMALL_DB_VAL;
+
+    // Determine angles (alpha & beta) associated with normalized
+    // azim / elev components.  They will be used to obtain a
+    // 'weighted average' antenna loss value
+    if ((azim_bw == 0.0 && elev_bw == 0.0) || vbw == hbw)
+      return maxGain + (az_gain + el_gain) / 2.0f;
+
+    double alpha, beta;
+    if (azim_bw <= elev_bw)
+    {
+      // since atan2 returns values between -pi and pi,
+      // alpha and beta should be in rad instead of deg
+      alpha = fabs(atan2(azim_bw, elev_bw));
+      if (alpha > M_PI_2)
+        alpha = M_PI - alpha;
+      beta = M_PI_2 - alpha;
+      return static_cast<float>(maxGain + (alpha * az_gain + beta * el_gain) / M_PI_2);
+    }
 
-  double alpha, beta;
-  if (azim_bw <= elev_bw)
-  {
     // since atan2 returns values between -pi and pi,
     // alpha and beta should be in rad instead of deg
-    alpha = fabs(atan2(azim_bw, elev_bw));
-    if (alpha > M_PI_2)
-      alpha = M_PI - alpha;
-    beta = M_PI_2 - alpha;
+    beta = fabs(atan2(elev_bw, azim_bw));
+    if (beta > M_PI_2)
+      beta = M_PI - beta;
+    alpha = M_PI_2 - beta;
     return static_cast<float>(maxGain + (alpha * az_gain + beta * el_gain) / M_PI_2);
   }
+}
+
+/* This function returns the gain for lookup table-based antennaPatterns */
 
-  // since atan2 returns values between -pi and pi,
-  // alpha and beta should be in rad instead of deg
-  beta = fabs(atan2(elev_bw, azim_bw));
-  if (beta > M_PI_2)
-    beta = M_PI - beta;
-  alpha = M_PI_2 - beta;
-  return static_cast<float>(maxGain + (alpha * az_gain + beta * el_gain) / M_PI_2);
+float calculateGain(const std::map<float, float> *azimData,
+  const std::map<float, float> *elevData,
+  AntennaLobeType &lastLobe,
+  float azim,
+  float elev,
+  float hbw,
+  float vbw,
+  float maxGain,
+  bool applyWeight)
+{
+  return calculateGainT(azimData, elevData, lastLobe, azim, elev, hbw, vbw, maxGain, applyWeight);
+}
+
+float calculateGain(const AntennaGainTable *azimData,
+  const AntennaGainTable *elevData,
+  AntennaLobeType &lastLobe,
+  float azim,
+  float elev,
+  float hbw,
+  float vbw,
+  float maxGain,
+  bool applyWeight)
+{
+  return calculateGainT(azimData, elevData, lastLobe, azim, elev, hbw, vbw, maxGain, applyWeight);
 }
 
 // ----------------------------------------------------------------------------
@@ -668,15 +796,23 @@ AntennaPatternTable::AntennaPatternTable(bool type)
   beamWidthType_(type),
   lastVbw_(-FLT_MAX),
   lastHbw_(-FLT_MAX),
-  lastGain_(SMALL_DB_VAL)
+  lastGain_(SMALL_DB_VAL),
+  tablesDirty_(false)
 {}
 
 float AntennaPatternTable::gain(const AntennaGainParameters &params)
 {
   if (!valid_) return SMALL_DB_VAL;
+  // data may also be set directly by the binary FCT loader, so compile on first use after a change
+  if (tablesDirty_)
+  {
+    azimTable_.set(azimData_);
+    elevTable_.set(elevData_);
+    tablesDirty_ = false;
+  }
   AntennaLobeType lastLobe;
-  return calculateGain(&azimData_,
-    &elevData_,
+  return calculateGain(&azimTable_,
+    &elevTable_,
     lastLobe,
     static_cast<float>(angFixPI(params.azim_)),
     static_cast<float>(angFixPI2(params.elev_)),
@@ -695,6 +831,8 @@ int AntennaPatternTable::readPat(std::istream& fp)
   float *gain[4];
   float azim, elev;
   valid_ = false;
+  // the tables are compiled below; until then, they no longer match the data being read
+  tablesDirty_ = true;
   std::string st;
   std::vector<std::string> tmpvec;
 
@@ -903,6 +1041,9 @@ int AntennaPatternTable::readPat(std::istream& fp)
     delete [] gain[i];
   }
 
+  azimTable_.set(azimData_);
+  elevTable_.set(elevData_);
+  tablesDirty_ = false;
   valid_ = true;
   return 0;
 }
@@ -983,8 +1124,8 @@ float AntennaPatternRelativeTable::gain(const AntennaGainParameters &params)
   if (!valid_)
     return SMALL_DB_VAL;
   AntennaLobeType lastLobe;
-  return calculateGain(&azimData_,
-    &elevData_,
+  return calculateGain(&azimTable_,
+    &elevTable_,
     lastLobe,
     static_cast<float>(angFixPI(params.azim_)),
     static_cast<float>(angFixPI2(params.elev_)),
@@ -1134,6 +1275,8 @@ int AntennaPatternRelativeTable::readPat_(std::istream& fp)
     }
   }
 
+  azimTable_.set(azimData_);
+  elevTable_.set(elevData_);
   valid_ = true;
   return 0;
 }
@@ -2154,8 +2297,8 @@ float AntennaPatternNSMA::gain(const AntennaGainParameters &params)
   switch (params.polarity_)
   {
   case POLARITY_VERTICAL:
-    return calculateGain(&VVDataMap_,
-      &ELVVDataMap_,
+    return calculateGain(&VVTable_,
+      &ELVVTable_,
       lastLobe,
       params.azim_,
       params.elev_,
@@ -2167,8 +2310,8 @@ float AntennaPatternNSMA::gain(const AntennaGainParameters &params)
 
   case POLARITY_HORZVERT:
   case POLARITY_RIGHTCIRC:
-    return calculateGain(&HVDataMap_,
-      &ELHVDataMap_,
+    return calculateGain(&HVTable_,
+      &ELHVTable_,
       lastLobe,
       params.azim_,
       params.elev_,
@@ -2180,8 +2323,8 @@ float AntennaPatternNSMA::gain(const AntennaGainParameters &params)
 
   case POLARITY_VERTHORZ:
   case POLARITY_LEFTCIRC:
-    return calculateGain(&VHDataMap_,
-      &ELVHDataMap_,
+    return calculateGain(&VHTable_,
+      &ELVHTable_,
       lastLobe,
       params.azim_,
       params.elev_,
@@ -2192,8 +2335,8 @@ float AntennaPatternNSMA::gain(const AntennaGainParameters &params)
     break;
 
   default:
-    return calculateGain(&HHDataMap_,
-      &ELHHDataMap_,
+    return calculateGain(&HHTable_,
+      &ELHHTable_,
       lastLobe,
       params.azim_,
       params.elev_,
@@ -2642,6 +2785,14 @@ int AntennaPatternNSMA::readPat_(std::istream& fp)
     }
   }
 
+  HHTable_.set(HHDataMap_);
+  ELHHTable_.set(ELHHDataMap_);
+  HVTable_.set(HVDataMap_);
+  ELHVTable_.set(ELHVDataMap_);
+  VHTable_.set(VHDataMap_);
+  ELVHTable_.set(ELVHDataMap_);
+  VVTable_.set(VVDataMap_);
+  ELVVTable_.set(ELVVDataMap_);
   valid_ = true;
   return 0;
 }
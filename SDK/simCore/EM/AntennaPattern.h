@@ -27,7 +27,9 @@
 #include <complex>
 #include <iosfwd>
 #include <map>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "simCore/Common/Common.h"
 #include "simCore/LUT/InterpTable.h"
@@ -128,6 +130,14 @@ public:
   */
   virtual float gain(const AntennaGainParameters &params) = 0;
 
+  /**
+  * This method computes the antenna pattern gain for each entry in a batch of parameters
+  * @param[in ] params Collection of antenna parameters for each requested gain value
+  * @param[out] results Antenna pattern gain for each entry in params (dB)
+  * @return 0 on success, !0 if results is smaller than params
+  */
+  virtual int gains(std::span<const AntennaGainParameters> params, std::span<float> results);
+
   /**
   * This method returns the minimum and maximum gains for the pattern
   * @param[out] min Minimum gain value to retrieve (dB)
@@ -280,6 +290,52 @@ public:
 };
 
 // ----------------------------------------------------------------------------
+
+/**
+* Angle/gain lookup table compiled from a std::map for repeated gain lookups.  Breakpoints are
+* stored contiguously, and a uniform grid over the angle range indexes the first breakpoint of
+* each grid cell, so a lookup is an indexed jump and a short scan instead of a tree search.
+* Lookups return the same values as gain lookups in the map the table was compiled from.
+*/
+class SDKCORE_EXPORT AntennaGainTable
+{
+public:
+  AntennaGainTable();
+
+  /**
+  * Replaces the table with the breakpoints in the given map
+  * @param[in ] data Map of angle (rad) to gain (dB)
+  */
+  void set(const std::map<float, float>& data);
+
+  /** Removes all breakpoints */
+  void clear();
+
+  /** @return true if the table has no breakpoints */
+  bool empty() const { return breakpoints_.empty(); }
+
+  /**
+  * Returns the gain at the given angle, interpolating between breakpoints.  Angles below the
+  * first breakpoint return its gain.
+  * @param[in ] angle Angle to look up (rad)
+  * @return table gain (dB), or SMALL_DB_VAL if the table is empty or angle is past the last breakpoint
+  */
+  float gain(float angle) const;
+
+private:
+  /** Angle and gain at one breakpoint, kept together so an interpolation touches one cache line */
+  struct Breakpoint
+  {
+    float angle;  ///< Breakpoint angle (rad)
+    float gain;   ///< Gain at the angle (dB)
+  };
+
+  std::vector<Breakpoint> breakpoints_; ///< Breakpoints in increasing angle order
+  std::vector<unsigned int> cellStart_; ///< Index of the first breakpoint at or above each grid cell's lower edge
+  float minAngle_;                      ///< Angle of the first breakpoint (rad)
+  float cellsPerRad_;                   ///< Grid cells per radian of angle
+};
+
 /**
 * @brief This function returns the gain for an antenna pattern lookup table
 * @param[in ] azimData Azimuth gain data
@@ -303,6 +359,29 @@ SDKCORE_EXPORT float calculateGain(const std::map<float, float> *azimData,
   float maxGain,
   bool applyWeight);
 
+/**
+* @brief This function returns the gain for a compiled antenna pattern lookup table, as the std::map version does
+* @param[in ] azimData Azimuth gain data
+* @param[in ] elevData Elevation gain data
+* @param[out ] lastLobe AntennaLobeType of lobe last seen, set based on normalized beam width (phi)
+* @param[in ] azim Azimuth relative to antenna (rad)
+* @param[in ] elev Elevation relative to antenna (rad)
+* @param[in ] hbw Horizontal beam width of radar (rad), must be non-zero
+* @param[in ] vbw Vertical beam width of radar (rad), must be non-zero
+* @param[in ] maxGain Maximum (normalized) antenna gain (dB)
+* @param[in ] applyWeight Boolean toggle to apply weighting (true) to the antenna gain
+* @return Antenna pattern gain (dB).
+*/
+SDKCORE_EXPORT float calculateGain(const AntennaGainTable *azimData,
+  const AntennaGainTable *elevData,
+  AntennaLobeType &lastLobe,
+  float azim,
+  float elev,
+  float hbw,
+  float vbw,
+  float maxGain,
+  bool applyWeight);
+
 // ----------------------------------------------------------------------------
 
 /// Table based antenna pattern class
@@ -358,14 +437,14 @@ public:
   * @param[in ] ang Azimuth position of antenna pattern, units based on type_
   * @param[in ] gain Gain of antenna pattern at specified azimuth (dB)
   */
-  void setAzimData(float ang, float gain) {azimData_[ang] = gain;}
+  void setAzimData(float ang, float gain) {azimData_[ang] = gain; tablesDirty_ = true;}
 
   /**
   * This method sets the gain value for the specified elevation, accessed by SimLogic binary FCT loader
   * @param[in ] ang Elevation position of antenna pattern, units based on type_
   * @param[in ] gain Gain of antenna pattern at specified elevation (dB)
   */
-  void setElevData(float ang, float gain) {elevData_[ang] = gain;}
+  void setElevData(float ang, float gain) {elevData_[ang] = gain; tablesDirty_ = true;}
 
 protected:
   bool beamWidthType_;              ///< false: angles in radians, true: angles in beamwidth (m)
@@ -374,6 +453,9 @@ protected:
   float lastGain_;                  ///< Last gain value used to calculate min & max gains
   std::map<float, float> azimData_; ///< Azimuth gain data
   std::map<float, float> elevData_; ///< Elevation gain data
+  AntennaGainTable azimTable_;      ///< Azimuth gain data compiled for lookups
+  AntennaGainTable elevTable_;      ///< Elevation gain data compiled for lookups
+  bool tablesDirty_;                ///< true if the gain data changed since the tables were compiled
 };
 
 // ----------------------------------------------------------------------------
@@ -459,6 +541,8 @@ protected:
   float lastGain_;                  ///< Last gain value used to calculate min & max gains
   std::map<float, float> azimData_; ///< Azimuth gain data (dB)
   std::map<float, float> elevData_; ///< Elevation gain data (dB)
+  AntennaGainTable azimTable_;      ///< Azimuth gain data compiled for lookups
+  AntennaGainTable elevTable_;      ///< Elevation gain data compiled for lookups
 
   /**
   * This method parses and stores the incoming antenna pattern data
@@ -672,6 +756,15 @@ protected:
   float minVVGain_;                     ///< Minimum VV gain value (dB)
   float maxVVGain_;                     ///< Maximum VV gain value (dB)
 
+  AntennaGainTable HHTable_;            ///< Azimuth HH polarization gain data compiled for lookups
+  AntennaGainTable ELHHTable_;          ///< Elevation HH polarization gain data compiled for lookups
+  AntennaGainTable HVTable_;            ///< Azimuth HV polarization gain data compiled for lookups
+  AntennaGainTable ELHVTable_;          ///< Elevation HV polarization gain data compiled for lookups
+  AntennaGainTable VHTable_;            ///< Azimuth VH polarization gain data compiled for lookups
+  AntennaGainTable ELVHTable_;          ///< Elevation VH polarization gain data compiled for lookups
+  AntennaGainTable VVTable_;            ///< Azimuth VV polarization gain data compiled for lookups
+  AntennaGainTable ELVVTable_;          ///< Elevation VV polarization gain data compiled for lookups
+
   /**
   * This method parses and stores the incoming antenna pattern data
   * @param[in ] fp Input file stream handle
@@ -0,0 +1,180 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "simCore/System/ParallelFor.h"
+
+namespace simCore
+{
+
+namespace
+{
+
+/**
+ * Worker threads that split a range of indices between them.  Created once and intentionally never
+ * destroyed; idle workers block on startCondition_ until the process exits.
+ */
+class WorkerPool
+{
+public:
+  WorkerPool()
+  {
+    const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int ii = 1; ii < maxThreads; ++ii)
+    {
+      try
+      {
+        std::thread(&WorkerPool::workerLoop_, this, ii).detach();
+        ++numWorkers_;
+      }
+      catch (const std::system_error&)
+      {
+        // Could not start a thread; work with the ones already running
+        break;
+      }
+    }
+  }
+
+  /** Returns true if the pool was free and is now reserved for the caller */
+  bool tryAcquire()
+  {
+    bool expected = false;
+    return busy_.compare_exchange_strong(expected, true);
+  }
+
+  /** Frees the pool reserved by tryAcquire() */
+  void release()
+  {
+    busy_ = false;
+  }
+
+  /** Number of threads that share the work, including the calling thread */
+  unsigned int numThreads() const
+  {
+    return numWorkers_ + 1;
+  }
+
+  /** Runs fn over [0, count) in numPartitions partitions; the pool must be reserved */
+  void run(size_t count, unsigned int numPartitions, const ParallelRangeFunction& fn)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      function_ = &fn;
+      count_ = count;
+      numPartitions_ = numPartitions;
+      // Workers beyond the partition count wake up and go back to sleep without being counted
+      numPending_ = numPartitions - 1;
+      ++generation_;
+    }
+    startCondition_.notify_all();
+
+    // The calling thread always handles the first partition
+    fn(0, count / numPartitions);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this] { return numPending_ == 0; });
+    function_ = nullptr;
+  }
+
+private:
+  /** Main loop of each worker thread */
+  void workerLoop_(unsigned int partition)
+  {
+    unsigned long long lastGeneration = 0;
+    while (true)
+    {
+      const ParallelRangeFunction* fn = nullptr;
+      size_t begin = 0;
+      size_t end = 0;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        startCondition_.wait(lock, [this, lastGeneration] { return generation_ != lastGeneration; });
+        lastGeneration = generation_;
+        if (partition >= numPartitions_)
+          continue;
+        fn = function_;
+        begin = count_ * partition / numPartitions_;
+        end = count_ * (partition + 1) / numPartitions_;
+      }
+
+      (*fn)(begin, end);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --numPending_;
+      }
+      doneCondition_.notify_one();
+    }
+  }
+
+  unsigned int numWorkers_ = 0;
+  std::atomic<bool> busy_{ false };
+  std::mutex mutex_;
+  std::condition_variable startCondition_;
+  std::condition_variable doneCondition_;
+  /** Work for the current generation; only valid while run() is executing */
+  const ParallelRangeFunction* function_ = nullptr;
+  size_t count_ = 0;
+  unsigned int numPartitions_ = 0;
+  unsigned int numPending_ = 0;
+  unsigned long long generation_ = 0;
+};
+
+/** Returns the process-wide pool, creating it on first use */
+WorkerPool& workerPool()
+{
+  // Never deleted, so that no worker is joined or destroyed during static destruction
+  static WorkerPool* pool = new WorkerPool;
+  return *pool;
+}
+
+}
+
+void parallelFor(size_t count, size_t maxPartitions, const ParallelRangeFunction& fn)
+{
+  if (count == 0)
+    return;
+  if (maxPartitions <= 1 || count == 1)
+  {
+    fn(0, count);
+    return;
+  }
+
+  WorkerPool& pool = workerPool();
+  const unsigned int numPartitions = static_cast<unsigned int>(std::min<size_t>({ maxPartitions, count, pool.numThreads() }));
+  // Nested and concurrent calls run serially rather than wait for the pool
+  if (numPartitions <= 1 || !pool.tryAcquire())
+  {
+    fn(0, count);
+    return;
+  }
+  pool.run(count, numPartitions, fn);
+  pool.release();
+}
+
+}
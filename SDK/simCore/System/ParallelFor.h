@@ -0,0 +1,54 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_SYSTEM_PARALLELFOR_H
+#define SIMCORE_SYSTEM_PARALLELFOR_H
+
+#include <cstddef>
+#include <functional>
+#include "simCore/Common/Export.h"
+
+namespace simCore
+{
+
+/** Function that processes the indices [begin, end) */
+typedef std::function<void(size_t begin, size_t end)> ParallelRangeFunction;
+
+/**
+ * Splits [0, count) into up to maxPartitions contiguous partitions and calls fn once per partition,
+ * in parallel on a set of worker threads shared by the whole process.  The calling thread processes
+ * the first partition, and the call returns only after every partition is complete.  The number of
+ * partitions is also limited by count and by the number of hardware threads.
+ *
+ * Workers start on first use and live until the process exits; they are never joined, so that no
+ * thread is waited on during static destruction.  Calls made while another call is running, whether
+ * from another thread or from inside fn, process all of [0, count) on the calling thread.
+ * @param count Number of indices to process
+ * @param maxPartitions Largest number of partitions; callers usually pass the amount of work divided
+ *   by the least work worth a thread of its own.  0 and 1 run fn(0, count) on the calling thread.
+ * @param fn Function called for each partition, possibly on a worker thread
+ */
+SDKCORE_EXPORT void parallelFor(size_t count, size_t maxPartitions, const ParallelRangeFunction& fn);
+
+}
+
+#endif /* SIMCORE_SYSTEM_PARALLELFOR_H */
@@ -0,0 +1,891 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include "simData/CategoryData/CategoryData.h"
+#include "simData/DataTable.h"
+#include "simData/MappedDataSlice.h"
+#include "simData/MappedFile.h"
+#include "simData/ArchiveDataStore.h"
+
+namespace simData
+{
+
+namespace
+{
+
+const char ARCHIVE_MAGIC[8] = { 'S', 'I', 'M', 'D', 'A', 'R', 'C', 'H' };
+/// Detects archives written on a machine with a different byte order
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/// Fixed size header at the start of an archive
+struct ArchiveHeader
+{
+  char magic[8];
+  uint32_t byteOrderMark;
+  uint32_t version;
+  uint64_t numEntities;
+  uint64_t metadataOffset;
+};
+
+typedef std::map<uint64_t, ObjectId> IdMap;
+
+/// Appends values to a byte buffer
+class Writer
+{
+public:
+  /// Appends the bytes of a plain value
+  template <typename T>
+  void put(const T& value)
+  {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /// Appends a length prefixed string
+  void putString(const std::string& value)
+  {
+    put(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+
+  /// Appends raw bytes
+  void putBytes(const void* data, size_t size)
+  {
+    buffer_.append(static_cast<const char*>(data), size);
+  }
+
+  /// Pads the buffer to a multiple of 8 bytes
+  void pad()
+  {
+    buffer_.append((8 - buffer_.size() % 8) % 8, '\0');
+  }
+
+  /// Contents of the buffer
+  const std::string& buffer() const
+  {
+    return buffer_;
+  }
+
+private:
+  std::string buffer_;
+};
+
+/// Type specific access to an entity for the archive
+template <typename T>
+struct EntityTraits;
+
+template <>
+struct EntityTraits<PlatformUpdate>
+{
+  typedef PlatformProperties Properties;
+  typedef PlatformPrefs Prefs;
+  typedef PlatformCommand Command;
+  static const ObjectType TYPE = PLATFORM;
+
+  static const Properties* properties(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.platformProperties(id, t); }
+  static const Prefs* prefs(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.platformPrefs(id, t); }
+  static const DataSlice<PlatformUpdate>* updates(const DataStore& ds, ObjectId id) { return ds.platformUpdateSlice(id); }
+  static const DataSlice<Command>* commands(const DataStore& ds, ObjectId id) { return ds.platformCommandSlice(id); }
+
+  static Properties* add(DataStore& ds, DataStore::Transaction* t) { return ds.addPlatform(t); }
+  static Prefs* mutablePrefs(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.mutable_platformPrefs(id, t); }
+  static Command* addCommand(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.addPlatformCommand(id, t); }
+};
+
+template <>
+struct EntityTraits<BeamUpdate>
+{
+  typedef BeamProperties Properties;
+  typedef BeamPrefs Prefs;
+  typedef BeamCommand Command;
+  static const ObjectType TYPE = BEAM;
+
+  static const Properties* properties(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.beamProperties(id, t); }
+  static const Prefs* prefs(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.beamPrefs(id, t); }
+  static const DataSlice<BeamUpdate>* updates(const DataStore& ds, ObjectId id) { return ds.beamUpdateSlice(id); }
+  static const DataSlice<Command>* commands(const DataStore& ds, ObjectId id) { return ds.beamCommandSlice(id); }
+
+  static Properties* add(DataStore& ds, DataStore::Transaction* t) { return ds.addBeam(t); }
+  static Prefs* mutablePrefs(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.mutable_beamPrefs(id, t); }
+  static Command* addCommand(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.addBeamCommand(id, t); }
+};
+
+template <>
+struct EntityTraits<GateUpdate>
+{
+  typedef GateProperties Properties;
+  typedef GatePrefs Prefs;
+  typedef GateCommand Command;
+  static const ObjectType TYPE = GATE;
+
+  static const Properties* properties(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.gateProperties(id, t); }
+  static const Prefs* prefs(const DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.gatePrefs(id, t); }
+  static const DataSlice<GateUpdate>* updates(const DataStore& ds, ObjectId id) { return ds.gateUpdateSlice(id); }
+  static const DataSlice<Command>* commands(const DataStore& ds, ObjectId id) { return ds.gateCommandSlice(id); }
+
+  static Properties* add(DataStore& ds, DataStore::Transaction* t) { return ds.addGate(t); }
+  static Prefs* mutablePrefs(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.mutable_gatePrefs(id, t); }
+  static Command* addCommand(DataStore& ds, ObjectId id, DataStore::Transaction* t) { return ds.addGateCommand(id, t); }
+};
+
+/// Copies every update of a slice
+template <typename T>
+class CollectUpdates : public VisitableDataSlice<T>::Visitor
+{
+public:
+  explicit CollectUpdates(std::vector<T>& updates)
+    : updates_(updates)
+  {
+  }
+
+  virtual void operator()(const T* update) override
+  {
+    updates_.push_back(*update);
+  }
+
+private:
+  std::vector<T>& updates_;
+};
+
+/// Serializes every message of a slice
+template <typename T>
+class SerializeMessages : public VisitableDataSlice<T>::Visitor
+{
+public:
+  explicit SerializeMessages(std::vector<std::string>& messages)
+    : messages_(messages)
+  {
+  }
+
+  virtual void operator()(const T* message) override
+  {
+    messages_.push_back(message->SerializeAsString());
+  }
+
+private:
+  std::vector<std::string>& messages_;
+};
+
+/// Serializes every category data message of a slice
+class SerializeCategoryData : public CategoryDataSlice::Visitor
+{
+public:
+  explicit SerializeCategoryData(std::vector<std::string>& messages)
+    : messages_(messages)
+  {
+  }
+
+  virtual void operator()(const CategoryData* message) override
+  {
+    messages_.push_back(message->SerializeAsString());
+  }
+
+private:
+  std::vector<std::string>& messages_;
+};
+
+/// Writes a count followed by the strings
+void putStrings(const std::vector<std::string>& values, Writer& out)
+{
+  out.put(static_cast<uint32_t>(values.size()));
+  for (const auto& value : values)
+    out.putString(value);
+}
+
+/// Writes the times, then the remaining fields in MappedChunkLayout blocks
+template <typename T>
+void putUpdates(const std::vector<T>& updates, Writer& out)
+{
+  for (const T& update : updates)
+    out.put(update.time());
+
+  std::vector<uint8_t> block(MappedChunkLayout<T>::Bytes);
+  for (size_t start = 0; start < updates.size(); start += ColumnChunkSize)
+  {
+    std::fill(block.begin(), block.end(), static_cast<uint8_t>(0));
+    double* doubles = reinterpret_cast<double*>(block.data());
+    float* floats = reinterpret_cast<float*>(block.data() + MappedChunkLayout<T>::FloatsOffset);
+    for (size_t ii = 0; ii < ColumnChunkSize && start + ii < updates.size(); ++ii)
+      ColumnLayout<T>::store(updates[start + ii], doubles, floats, block[MappedChunkLayout<T>::FlagsOffset + ii], ii);
+    out.putBytes(block.data(), block.size());
+  }
+}
+
+/// Writes the columns and rows of a table
+class PutTable : public TableList::Visitor, public DataTable::ColumnVisitor, public DataTable::RowVisitor
+{
+public:
+  explicit PutTable(Writer& out)
+    : out_(out),
+      numTables_(0)
+  {
+  }
+
+  /// Number of tables written
+  uint32_t numTables() const
+  {
+    return numTables_;
+  }
+
+  virtual void visit(DataTable* table) override
+  {
+    ++numTables_;
+    out_.putString(table->tableName());
+
+    columns_.clear();
+    table->accept(static_cast<DataTable::ColumnVisitor&>(*this));
+    out_.put(static_cast<uint32_t>(columns_.size()));
+    for (const TableColumn* column : columns_)
+    {
+      out_.putString(column->name());
+      out_.put(static_cast<uint32_t>(column->variableType()));
+      out_.put(static_cast<int32_t>(column->unitType()));
+    }
+
+    // Rows are written to their own buffer, since the count is not known up front
+    rows_ = Writer();
+    numRows_ = 0;
+    table->accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), static_cast<DataTable::RowVisitor&>(*this));
+    out_.put(numRows_);
+    out_.putBytes(rows_.buffer().data(), rows_.buffer().size());
+  }
+
+  virtual void visit(TableColumn* column) override
+  {
+    columns_.push_back(column);
+  }
+
+  virtual VisitReturn visit(const TableRow& row) override
+  {
+    ++numRows_;
+    rows_.put(row.time());
+    rows_.put(static_cast<uint32_t>(row.cellCount()));
+    for (uint32_t index = 0; index < columns_.size(); ++index)
+    {
+      const TableColumn* column = columns_[index];
+      if (!row.containsCell(column->columnId()))
+        continue;
+
+      rows_.put(index);
+      switch (column->variableType())
+      {
+      case VT_STRING:
+      {
+        std::string value;
+        row.value(column->columnId(), value);
+        rows_.putString(value);
+        break;
+      }
+      case VT_UINT64:
+      {
+        uint64_t value = 0;
+        row.value(column->columnId(), value);
+        rows_.put(value);
+        break;
+      }
+      case VT_INT64:
+      {
+        int64_t value = 0;
+        row.value(column->columnId(), value);
+        rows_.put(value);
+        break;
+      }
+      default:
+      {
+        // Every other type fits in a double without loss
+        double value = 0.0;
+        row.value(column->columnId(), value);
+        rows_.put(value);
+        break;
+      }
+      }
+    }
+    return VISIT_CONTINUE;
+  }
+
+private:
+  Writer& out_;
+  uint32_t numTables_;
+  std::vector<const TableColumn*> columns_;
+  Writer rows_;
+  uint64_t numRows_ = 0;
+};
+
+/// Writes the updates of one entity to the file and its metadata to the metadata buffer
+template <typename T>
+int putEntity(const DataStore& ds, ObjectId id, std::ofstream& file, uint64_t& offset, Writer& metadata)
+{
+  typedef EntityTraits<T> Traits;
+
+  std::string properties;
+  std::string prefs;
+  {
+    DataStore::Transaction t;
+    const typename Traits::Properties* props = Traits::properties(ds, id, &t);
+    const typename Traits::Prefs* pref = Traits::prefs(ds, id, &t);
+    if (props == nullptr || pref == nullptr)
+      return 1;
+    properties = props->SerializeAsString();
+    prefs = pref->SerializeAsString();
+  }
+
+  std::vector<T> updates;
+  const DataSlice<T>* updateSlice = Traits::updates(ds, id);
+  if (updateSlice != nullptr)
+  {
+    CollectUpdates<T> collect(updates);
+    updateSlice->visit(&collect);
+  }
+  Writer data;
+  putUpdates(updates, data);
+  file.write(data.buffer().data(), data.buffer().size());
+
+  metadata.put(static_cast<uint32_t>(Traits::TYPE));
+  metadata.put(static_cast<uint64_t>(id));
+  metadata.put(static_cast<uint64_t>(updates.size()));
+  metadata.put(offset);
+  offset += data.buffer().size();
+  metadata.putString(properties);
+  metadata.putString(prefs);
+
+  std::vector<std::string> messages;
+  const DataSlice<typename Traits::Command>* commandSlice = Traits::commands(ds, id);
+  if (commandSlice != nullptr)
+  {
+    SerializeMessages<typename Traits::Command> serialize(messages);
+    commandSlice->visit(&serialize);
+  }
+  putStrings(messages, metadata);
+
+  messages.clear();
+  const CategoryDataSlice* categorySlice = ds.categoryDataSlice(id);
+  if (categorySlice != nullptr)
+  {
+    SerializeCategoryData serialize(messages);
+    categorySlice->visit(&serialize);
+  }
+  putStrings(messages, metadata);
+
+  messages.clear();
+  const GenericDataSlice* genericSlice = ds.genericDataSlice(id);
+  if (genericSlice != nullptr)
+  {
+    SerializeMessages<GenericData> serialize(messages);
+    genericSlice->visit(&serialize);
+  }
+  putStrings(messages, metadata);
+
+  Writer tables;
+  PutTable putTable(tables);
+  const TableList* tableList = ds.dataTableManager().tablesForOwner(id);
+  if (tableList != nullptr)
+    tableList->accept(putTable);
+  metadata.put(putTable.numTables());
+  metadata.putBytes(tables.buffer().data(), tables.buffer().size());
+
+  return file.good() ? 0 : 1;
+}
+
+/// Replaces the host ID with its ID in the new data store; returns false if the host is unknown
+template <typename Properties>
+bool translateHostId(Properties& properties, const IdMap& ids)
+{
+  // Hosts always come first in the archive
+  if (!properties.has_hostid())
+    return true;
+  auto host = ids.find(properties.hostid());
+  if (host == ids.end())
+    return false;
+  properties.set_hostid(host->second);
+  return true;
+}
+
+/// Platforms have no host
+bool translateIds(PlatformProperties& properties, const IdMap& ids)
+{
+  return true;
+}
+
+/// Beams are hosted by platforms
+bool translateIds(BeamProperties& properties, const IdMap& ids)
+{
+  return translateHostId(properties, ids);
+}
+
+/// Gates are hosted by beams
+bool translateIds(GateProperties& properties, const IdMap& ids)
+{
+  return translateHostId(properties, ids);
+}
+
+/// Platform preferences hold no IDs
+void translateIds(PlatformPrefs& prefs, const IdMap& ids)
+{
+}
+
+/// Target beams point at a platform
+void translateIds(BeamPrefs& prefs, const IdMap& ids)
+{
+  if (prefs.targetid() == 0)
+    return;
+  auto it = ids.find(prefs.targetid());
+  prefs.set_targetid(it == ids.end() ? 0 : it->second);
+}
+
+/// Gate preferences hold no IDs
+void translateIds(GatePrefs& prefs, const IdMap& ids)
+{
+}
+
+}
+
+//----------------------------------------------------------------------------
+/// Bounds checked reading of the archive metadata
+class ArchiveDataStore::Reader
+{
+public:
+  Reader(const uint8_t* data, size_t size, size_t offset)
+    : data_(data),
+      size_(size),
+      offset_(offset)
+  {
+  }
+
+  /// Reads a plain value; returns false if the archive is too short
+  template <typename T>
+  bool get(T& value)
+  {
+    if (size_ - offset_ < sizeof(T))
+      return false;
+    memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  /// Reads a length prefixed string; returns false if the archive is too short
+  bool getString(std::string& value)
+  {
+    uint32_t length = 0;
+    if (!get(length) || (size_ - offset_ < length))
+      return false;
+    value.assign(reinterpret_cast<const char*>(data_ + offset_), length);
+    offset_ += length;
+    return true;
+  }
+
+  /// Finds the columns of numUpdates updates at offset; returns false if they are not inside the archive
+  template <typename T>
+  bool getUpdates(uint64_t offset, uint64_t numUpdates, const double*& times, const uint8_t*& chunks) const
+  {
+    if ((offset % 8) != 0 || offset > size_ || numUpdates > (size_ - offset) / sizeof(double))
+      return false;
+    const uint64_t timesBytes = numUpdates * sizeof(double);
+    const uint64_t numBlocks = (numUpdates + ColumnChunkSize - 1) / ColumnChunkSize;
+    if (numBlocks > (size_ - offset - timesBytes) / MappedChunkLayout<T>::Bytes)
+      return false;
+    times = reinterpret_cast<const double*>(data_ + offset);
+    chunks = data_ + offset + timesBytes;
+    return true;
+  }
+
+private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+};
+
+//----------------------------------------------------------------------------
+ArchiveDataStore::ArchiveDataStore()
+  : MemoryDataStore(),
+    pendingPlatformSlice_(nullptr),
+    pendingBeamSlice_(nullptr),
+    pendingGateSlice_(nullptr)
+{
+}
+
+ArchiveDataStore::~ArchiveDataStore()
+{
+  // Entries hold slices that refer to the mapping
+  clear();
+}
+
+int ArchiveDataStore::write(const DataStore& dataStore, const std::string& filename)
+{
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return 1;
+
+  // The header is rewritten once the metadata offset is known
+  ArchiveHeader header;
+  memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+  header.byteOrderMark = BYTE_ORDER_MARK;
+  header.version = ARCHIVE_VERSION;
+  header.numEntities = 0;
+  header.metadataOffset = 0;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t offset = sizeof(header);
+
+  // Hosts are written before the entities that depend on them
+  Writer metadata;
+  int rv = 0;
+  IdList ids;
+  dataStore.idList(&ids, PLATFORM);
+  for (ObjectId id : ids)
+    rv += putEntity<PlatformUpdate>(dataStore, id, file, offset, metadata);
+  header.numEntities += ids.size();
+  ids.clear();
+  dataStore.idList(&ids, BEAM);
+  for (ObjectId id : ids)
+    rv += putEntity<BeamUpdate>(dataStore, id, file, offset, metadata);
+  header.numEntities += ids.size();
+  ids.clear();
+  dataStore.idList(&ids, GATE);
+  for (ObjectId id : ids)
+    rv += putEntity<GateUpdate>(dataStore, id, file, offset, metadata);
+  header.numEntities += ids.size();
+
+  header.metadataOffset = offset;
+  file.write(metadata.buffer().data(), metadata.buffer().size());
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!file.good())
+    return 1;
+  return (rv == 0) ? 0 : 1;
+}
+
+int ArchiveDataStore::open(const std::string& filename)
+{
+  clear();
+  file_.reset();
+
+  auto file = std::make_shared<MappedFile>();
+  if (file->open(filename) != 0 || file->size() < sizeof(ArchiveHeader))
+    return 1;
+
+  ArchiveHeader header;
+  memcpy(&header, file->data(), sizeof(header));
+  if (memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) != 0 || header.byteOrderMark != BYTE_ORDER_MARK ||
+    header.version != ARCHIVE_VERSION || header.metadataOffset > file->size())
+    return 1;
+
+  file_ = file;
+  Reader reader(file->data(), file->size(), static_cast<size_t>(header.metadataOffset));
+  IdMap idMap;
+  for (uint64_t ii = 0; ii < header.numEntities; ++ii)
+  {
+    if (openEntity_(reader, idMap) != 0)
+    {
+      clear();
+      file_.reset();
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int ArchiveDataStore::openEntity_(Reader& reader, std::map<uint64_t, ObjectId>& idMap)
+{
+  uint32_t type = 0;
+  if (!reader.get(type))
+    return 1;
+
+  switch (type)
+  {
+  case PLATFORM:
+    return openEntityOfType_<PlatformUpdate>(reader, idMap);
+  case BEAM:
+    return openEntityOfType_<BeamUpdate>(reader, idMap);
+  case GATE:
+    return openEntityOfType_<GateUpdate>(reader, idMap);
+  default:
+    break;
+  }
+  return 1;
+}
+
+template <typename T>
+int ArchiveDataStore::openEntityOfType_(Reader& reader, std::map<uint64_t, ObjectId>& idMap)
+{
+  typedef EntityTraits<T> Traits;
+
+  uint64_t sourceId = 0;
+  uint64_t numUpdates = 0;
+  uint64_t updatesOffset = 0;
+  std::string properties;
+  std::string prefs;
+  const double* times = nullptr;
+  const uint8_t* chunks = nullptr;
+  if (!reader.get(sourceId) || !reader.get(numUpdates) || !reader.get(updatesOffset) ||
+    !reader.getString(properties) || !reader.getString(prefs) ||
+    !reader.getUpdates<T>(updatesOffset, numUpdates, times, chunks))
+    return 1;
+
+  typename Traits::Properties archivedProperties;
+  typename Traits::Prefs archivedPrefs;
+  if (!archivedProperties.ParseFromString(properties) || !archivedPrefs.ParseFromString(prefs))
+    return 1;
+
+  if (!translateIds(archivedProperties, idMap))
+    return 1;
+  translateIds(archivedPrefs, idMap);
+
+  ObjectId id = 0;
+  {
+    setPendingSlice_(new MappedDataSlice<T>(file_, times, chunks, static_cast<size_t>(numUpdates)));
+    Transaction t;
+    typename Traits::Properties* newProperties = Traits::add(*this, &t);
+    id = newProperties->id();
+    newProperties->CopyFrom(archivedProperties);
+    newProperties->set_id(id);
+    t.commit();
+  }
+  idMap[sourceId] = id;
+
+  {
+    Transaction t;
+    typename Traits::Prefs* newPrefs = Traits::mutablePrefs(*this, id, &t);
+    if (newPrefs == nullptr)
+      return 1;
+    newPrefs->CopyFrom(archivedPrefs);
+    t.commit();
+  }
+
+  uint32_t count = 0;
+  std::string message;
+  if (!reader.get(count))
+    return 1;
+  for (uint32_t ii = 0; ii < count; ++ii)
+  {
+    Transaction t;
+    typename Traits::Command* command = Traits::addCommand(*this, id, &t);
+    if (!reader.getString(message) || command == nullptr || !command->ParseFromString(message))
+      return 1;
+    if (command->has_updateprefs())
+      translateIds(*command->mutable_updateprefs(), idMap);
+    t.commit();
+  }
+
+  if (!reader.get(count))
+    return 1;
+  for (uint32_t ii = 0; ii < count; ++ii)
+  {
+    Transaction t;
+    CategoryData* category = addCategoryData(id, &t);
+    if (!reader.getString(message) || category == nullptr || !category->ParseFromString(message))
+      return 1;
+    t.commit();
+  }
+
+  if (!reader.get(count))
+    return 1;
+  for (uint32_t ii = 0; ii < count; ++ii)
+  {
+    Transaction t;
+    GenericData* generic = addGenericData(id, &t);
+    if (!reader.getString(message) || generic == nullptr || !generic->ParseFromString(message))
+      return 1;
+    t.commit();
+  }
+
+  if (!reader.get(count))
+    return 1;
+  for (uint32_t ii = 0; ii < count; ++ii)
+  {
+    if (openTable_(reader, id) != 0)
+      return 1;
+  }
+  return 0;
+}
+
+int ArchiveDataStore::openTable_(Reader& reader, ObjectId id)
+{
+  std::string name;
+  uint32_t numColumns = 0;
+  DataTable* table = nullptr;
+  if (!reader.getString(name) || !reader.get(numColumns) || dataTableManager().addDataTable(id, name, &table).isError())
+    return 1;
+
+  std::vector<TableColumn*> columns;
+  for (uint32_t ii = 0; ii < numColumns; ++ii)
+  {
+    uint32_t variableType = 0;
+    int32_t unitType = 0;
+    TableColumn* column = nullptr;
+    if (!reader.getString(name) || !reader.get(variableType) || !reader.get(unitType) || variableType > VT_STRING ||
+      table->addColumn(name, static_cast<VariableType>(variableType), unitType, &column).isError())
+      return 1;
+    columns.push_back(column);
+  }
+
+  uint64_t numRows = 0;
+  if (!reader.get(numRows))
+    return 1;
+  TableRow row;
+  for (uint64_t ii = 0; ii < numRows; ++ii)
+  {
+    double time = 0.0;
+    uint32_t numCells = 0;
+    if (!reader.get(time) || !reader.get(numCells))
+      return 1;
+    row.clear();
+    row.setTime(time);
+    for (uint32_t jj = 0; jj < numCells; ++jj)
+    {
+      uint32_t index = 0;
+      if (!reader.get(index) || index >= columns.size())
+        return 1;
+      const TableColumn* column = columns[index];
+      bool valid = false;
+      switch (column->variableType())
+      {
+      case VT_STRING:
+      {
+        std::string value;
+        valid = reader.getString(value);
+        row.setValue(column->columnId(), value);
+        break;
+      }
+      case VT_UINT64:
+      {
+        uint64_t value = 0;
+        valid = reader.get(value);
+        row.setValue(column->columnId(), value);
+        break;
+      }
+      case VT_INT64:
+      {
+        int64_t value = 0;
+        valid = reader.get(value);
+        row.setValue(column->columnId(), value);
+        break;
+      }
+      default:
+      {
+        double value = 0.0;
+        valid = reader.get(value);
+        row.setValue(column->columnId(), value);
+        break;
+      }
+      }
+      if (!valid)
+        return 1;
+    }
+    if (table->addRow(row).isError())
+      return 1;
+  }
+  return 0;
+}
+
+PlatformUpdate* ArchiveDataStore::addPlatformUpdate(ObjectId id, Transaction *transaction)
+{
+  if (isArchived(id))
+    return nullptr;
+  return MemoryDataStore::addPlatformUpdate(id, transaction);
+}
+
+BeamUpdate* ArchiveDataStore::addBeamUpdate(ObjectId id, Transaction *transaction)
+{
+  if (isArchived(id))
+    return nullptr;
+  return MemoryDataStore::addBeamUpdate(id, transaction);
+}
+
+GateUpdate* ArchiveDataStore::addGateUpdate(ObjectId id, Transaction *transaction)
+{
+  if (isArchived(id))
+    return nullptr;
+  return MemoryDataStore::addGateUpdate(id, transaction);
+}
+
+int ArchiveDataStore::addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates)
+{
+  if (isArchived(id))
+    return 1;
+  return MemoryDataStore::addPlatformUpdates(id, updates);
+}
+
+int ArchiveDataStore::addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates)
+{
+  if (isArchived(id))
+    return 1;
+  return MemoryDataStore::addBeamUpdates(id, updates);
+}
+
+int ArchiveDataStore::addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates)
+{
+  if (isArchived(id))
+    return 1;
+  return MemoryDataStore::addGateUpdates(id, updates);
+}
+
+bool ArchiveDataStore::isArchived(ObjectId id) const
+{
+  return dynamic_cast<const MappedDataSlice<PlatformUpdate>*>(platformUpdateSlice(id)) != nullptr ||
+    dynamic_cast<const MappedDataSlice<BeamUpdate>*>(beamUpdateSlice(id)) != nullptr ||
+    dynamic_cast<const MappedDataSlice<GateUpdate>*>(gateUpdateSlice(id)) != nullptr;
+}
+
+MemoryDataStore::PlatformEntry* ArchiveDataStore::newPlatformEntry_()
+{
+  if (pendingPlatformSlice_ == nullptr)
+    return MemoryDataStore::newPlatformEntry_();
+  PlatformEntry* rv = new PlatformEntry(pendingPlatformSlice_);
+  pendingPlatformSlice_ = nullptr;
+  return rv;
+}
+
+MemoryDataStore::BeamEntry* ArchiveDataStore::newBeamEntry_()
+{
+  if (pendingBeamSlice_ == nullptr)
+    return MemoryDataStore::newBeamEntry_();
+  BeamEntry* rv = new BeamEntry(pendingBeamSlice_);
+  pendingBeamSlice_ = nullptr;
+  return rv;
+}
+
+MemoryDataStore::GateEntry* ArchiveDataStore::newGateEntry_()
+{
+  if (pendingGateSlice_ == nullptr)
+    return MemoryDataStore::newGateEntry_();
+  GateEntry* rv = new GateEntry(pendingGateSlice_);
+  pendingGateSlice_ = nullptr;
+  return rv;
+}
+
+void ArchiveDataStore::setPendingSlice_(MemoryDataSlice<PlatformUpdate>* slice)
+{
+  pendingPlatformSlice_ = slice;
+}
+
+void ArchiveDataStore::setPendingSlice_(MemoryDataSlice<BeamUpdate>* slice)
+{
+  pendingBeamSlice_ = slice;
+}
+
+void ArchiveDataStore::setPendingSlice_(MemoryDataSlice<GateUpdate>* slice)
+{
+  pendingGateSlice_ = slice;
+}
+
+}
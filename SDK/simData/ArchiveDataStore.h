@@ -0,0 +1,129 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_ARCHIVEDATASTORE_H
+#define SIMDATA_ARCHIVEDATASTORE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "simData/MemoryDataStore.h"
+
+namespace simData
+{
+
+class MappedFile;
+
+/**
+ * Data store that plays back an archive written by ArchiveDataStore::write().  Platform, beam and
+ * gate updates are served from the memory mapped archive by MappedDataSlice, so opening a large
+ * archive only reads its metadata and the operating system pages in updates as they are used.
+ * Properties, preferences, commands, category data, generic data and data tables are loaded into
+ * memory by open().
+ *
+ * The updates of archived entities are read-only; adding updates to them fails.  Preferences can
+ * still be changed, and entities added after open() behave as they do in a MemoryDataStore.
+ *
+ * The archive is a binary file in the byte order of the machine that wrote it:
+ *  - A header with the magic string, byte order mark, version, entity count and metadata offset.
+ *  - For each entity, its update times followed by its other update fields in MappedChunkLayout
+ *    blocks, aligned to 8 bytes.
+ *  - The metadata: for each entity, its serialized properties, preferences, commands, category
+ *    data and generic data, its data tables, and the location of its updates.
+ */
+class SDKDATA_EXPORT ArchiveDataStore : public MemoryDataStore
+{
+public:
+  /// Version of the archive format written by write() and accepted by open()
+  static const uint32_t ARCHIVE_VERSION = 1;
+
+  ArchiveDataStore();
+  virtual ~ArchiveDataStore();
+
+  /**
+   * Writes the platforms, beams and gates of the data store to an archive, with their updates,
+   * commands, category data, generic data and data tables.  Other entity types are not archived.
+   * @param dataStore Source of the data
+   * @param filename File to write, replacing any existing file
+   * @return 0 on success, non-zero on error
+   */
+  static int write(const DataStore& dataStore, const std::string& filename);
+
+  /**
+   * Removes the current contents of the data store and opens the archive.  The data store assigns
+   * new IDs to the archived entities; host and target IDs are translated to match.
+   * @param filename Archive written by write()
+   * @return 0 on success, non-zero if the file cannot be mapped or is not a valid archive
+   */
+  int open(const std::string& filename);
+
+  /**@name Archived entities reject new updates
+   * @{
+   */
+  virtual PlatformUpdate* addPlatformUpdate(ObjectId id, Transaction *transaction) override;
+  virtual BeamUpdate* addBeamUpdate(ObjectId id, Transaction *transaction) override;
+  virtual GateUpdate* addGateUpdate(ObjectId id, Transaction *transaction) override;
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) override;
+  virtual int addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates) override;
+  virtual int addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates) override;
+  ///@}
+
+  /// Returns true if the entity's updates are served from the archive
+  bool isArchived(ObjectId id) const;
+
+protected:
+  /// Uses the pending mapped slice while open() adds an entity
+  virtual PlatformEntry* newPlatformEntry_() override;
+  /// Uses the pending mapped slice while open() adds an entity
+  virtual BeamEntry* newBeamEntry_() override;
+  /// Uses the pending mapped slice while open() adds an entity
+  virtual GateEntry* newGateEntry_() override;
+
+private:
+  class Reader;
+
+  /// Adds one archived entity, translating its IDs through idMap; returns 0 on success
+  int openEntity_(Reader& reader, std::map<uint64_t, ObjectId>& idMap);
+  /// Implements openEntity_() for the entity type that has updates of type T
+  template <typename T>
+  int openEntityOfType_(Reader& reader, std::map<uint64_t, ObjectId>& idMap);
+  /// Adds one archived data table to the entity; returns 0 on success
+  int openTable_(Reader& reader, ObjectId id);
+
+  /// Sets the slice for the next new platform entry
+  void setPendingSlice_(MemoryDataSlice<PlatformUpdate>* slice);
+  /// Sets the slice for the next new beam entry
+  void setPendingSlice_(MemoryDataSlice<BeamUpdate>* slice);
+  /// Sets the slice for the next new gate entry
+  void setPendingSlice_(MemoryDataSlice<GateUpdate>* slice);
+
+  /// Mapping of the open archive; shared with the mapped slices
+  std::shared_ptr<MappedFile> file_;
+  /// Slices for the entity being added by open(); consumed by the new*Entry_() methods
+  MemoryDataSlice<PlatformUpdate>* pendingPlatformSlice_;
+  MemoryDataSlice<BeamUpdate>* pendingBeamSlice_;
+  MemoryDataSlice<GateUpdate>* pendingGateSlice_;
+};
+
+}
+
+#endif /* SIMDATA_ARCHIVEDATASTORE_H */
@@ -316,6 +316,7 @@ public:
   std::string getRegExpPattern(int nameInt) const;
 
 private:
+  friend class CompiledCategoryFilter;
   class CategoryFilterListener;
 
   /** Assignment operator; made private to force developers to use assign */
@@ -0,0 +1,190 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include "simData/DataStore.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CompiledCategoryFilter.h"
+#include "simData/CategoryData/CategoryFilterResults.h"
+
+namespace simData {
+
+/** Re-tests entities as their category data changes */
+class CategoryFilterResults::DataStoreListener : public DataStore::DefaultListener
+{
+public:
+  explicit DataStoreListener(CategoryFilterResults& results)
+    : results_(results)
+  {
+  }
+
+  virtual void onAddEntity(DataStore* source, ObjectId newId, ObjectType ot) override
+  {
+    results_.testEntity_(newId);
+  }
+
+  virtual void onRemoveEntity(DataStore* source, ObjectId removedId, ObjectType ot) override
+  {
+    results_.setMatch_(removedId, false);
+    results_.publishChanges();
+  }
+
+  virtual void onCategoryDataChange(DataStore* source, ObjectId changedId, ObjectType ot) override
+  {
+    results_.testEntity_(changedId);
+  }
+
+  virtual void onChange(DataStore* source) override
+  {
+    if (results_.testAllPending_)
+    {
+      results_.testAllPending_ = false;
+      results_.testAllEntities_();
+    }
+    results_.publishChanges();
+  }
+
+  virtual void onFlush(DataStore* source, ObjectId flushedId) override
+  {
+    // Flushes are rare and may be recursive, and the next update does not report emptied
+    // categories, so test everything once that update makes the remaining data current
+    results_.testAllPending_ = true;
+  }
+
+  virtual void onScenarioDelete(DataStore* source) override
+  {
+    results_.testAllPending_ = false;
+    const std::set<ObjectId> matches = results_.matches_;
+    for (ObjectId id : matches)
+      results_.setMatch_(id, false);
+    results_.publishChanges();
+  }
+
+private:
+  CategoryFilterResults& results_;
+};
+
+CategoryFilterResults::CategoryFilterResults(DataStore& dataStore)
+  : dataStore_(dataStore),
+    dataStoreListener_(std::make_shared<DataStoreListener>(*this)),
+    filter_(new CategoryFilter(&dataStore)),
+    compiledFilter_(new CompiledCategoryFilter(*filter_))
+{
+  testAllEntities_();
+  // Entities that already exist are the starting state, not changes
+  pending_.clear();
+  dataStore_.addListener(dataStoreListener_);
+}
+
+CategoryFilterResults::~CategoryFilterResults()
+{
+  dataStore_.removeListener(dataStoreListener_);
+}
+
+void CategoryFilterResults::setFilter(const CategoryFilter& filter)
+{
+  // Avoid copy constructor, which could add a listener
+  filter_.reset(new CategoryFilter(filter.getDataStore()));
+  filter_->assign(filter, false);
+  compiledFilter_.reset(new CompiledCategoryFilter(*filter_));
+  testAllEntities_();
+  publishChanges();
+}
+
+const CategoryFilter& CategoryFilterResults::filter() const
+{
+  return *filter_;
+}
+
+bool CategoryFilterResults::matches(ObjectId id) const
+{
+  return matches_.find(id) != matches_.end();
+}
+
+const std::set<ObjectId>& CategoryFilterResults::matchingIds() const
+{
+  return matches_;
+}
+
+void CategoryFilterResults::addListener(ListenerPtr listener)
+{
+  listeners_.push_back(listener);
+}
+
+void CategoryFilterResults::removeListener(ListenerPtr listener)
+{
+  listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+}
+
+void CategoryFilterResults::publishChanges()
+{
+  if (pending_.empty())
+    return;
+  std::vector<ObjectId> added;
+  std::vector<ObjectId> removed;
+  for (const auto& idAndMatch : pending_)
+  {
+    if (idAndMatch.second)
+      added.push_back(idAndMatch.first);
+    else
+      removed.push_back(idAndMatch.first);
+  }
+  pending_.clear();
+
+  // Listeners may remove themselves, so iterate a copy
+  const std::vector<ListenerPtr> listeners = listeners_;
+  for (const auto& listener : listeners)
+    listener->onMatchesChanged(*this, added, removed);
+}
+
+void CategoryFilterResults::testEntity_(ObjectId id)
+{
+  CategoryFilter::CurrentCategoryValues values;
+  CategoryFilter::getCurrentCategoryValues(dataStore_, id, values);
+  setMatch_(id, compiledFilter_->matchData(values));
+}
+
+void CategoryFilterResults::testAllEntities_()
+{
+  DataStore::IdList ids;
+  dataStore_.idList(&ids);
+  CategoryFilter::CurrentCategoryValues values;
+  for (ObjectId id : ids)
+  {
+    values.clear();
+    CategoryFilter::getCurrentCategoryValues(dataStore_, id, values);
+    setMatch_(id, compiledFilter_->matchData(values));
+  }
+}
+
+void CategoryFilterResults::setMatch_(ObjectId id, bool match)
+{
+  if (match ? !matches_.insert(id).second : (matches_.erase(id) == 0))
+    return;
+
+  // A change that reverses an unreported change cancels it
+  auto inserted = pending_.insert(std::make_pair(id, match));
+  if (!inserted.second)
+    pending_.erase(inserted.first);
+}
+
+}
@@ -0,0 +1,110 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_CATEGORYFILTERRESULTS_H
+#define SIMDATA_CATEGORYFILTERRESULTS_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/ObjectId.h"
+
+namespace simData {
+
+class CategoryFilter;
+class CompiledCategoryFilter;
+class DataStore;
+
+/**
+ * Maintains the set of entities that match a CategoryFilter as category data changes, so that
+ * consumers react to the entities that started or stopped matching rather than re-testing every
+ * entity.  Only entities that are added or reported by onCategoryDataChange() are re-tested;
+ * changing the filter re-tests every entity once, as does the first update after a flush.  Listeners are told of changes at the end of
+ * each DataStore::update(), immediately when the filter changes or entities are removed, or when
+ * publishChanges() is called.  An entity that starts and stops matching between notifications is
+ * not reported.  Must be used from the thread that modifies the data store.
+ */
+class SDKDATA_EXPORT CategoryFilterResults
+{
+public:
+  /** Observer of changes to the matching entities */
+  class Listener
+  {
+  public:
+    virtual ~Listener() {}
+
+    /** Entities that started matching (added) or stopped matching (removed) since the last notification */
+    virtual void onMatchesChanged(const CategoryFilterResults& results, const std::vector<ObjectId>& added, const std::vector<ObjectId>& removed) = 0;
+  };
+  /** Managed pointer to a Listener */
+  typedef std::shared_ptr<Listener> ListenerPtr;
+
+  /** Starts with an empty filter, which matches every entity of the data store */
+  explicit CategoryFilterResults(DataStore& dataStore);
+  virtual ~CategoryFilterResults();
+
+  SDK_DISABLE_COPY_MOVE(CategoryFilterResults);
+
+  /** Replaces the filter and re-tests every entity; auto update of the filter is not copied */
+  void setFilter(const CategoryFilter& filter);
+  /** Current filter */
+  const CategoryFilter& filter() const;
+
+  /** Returns true if the entity matches the filter */
+  bool matches(ObjectId id) const;
+  /** Entities that match the filter */
+  const std::set<ObjectId>& matchingIds() const;
+
+  /** Adds a listener for changes to the matching entities */
+  void addListener(ListenerPtr listener);
+  /** Removes a listener */
+  void removeListener(ListenerPtr listener);
+  /** Tells listeners about any changes not yet reported */
+  void publishChanges();
+
+private:
+  class DataStoreListener;
+
+  /** Re-tests the entity, recording any change */
+  void testEntity_(ObjectId id);
+  /** Re-tests every entity, recording any changes */
+  void testAllEntities_();
+  /** Records that the entity starts or stops matching */
+  void setMatch_(ObjectId id, bool match);
+
+  DataStore& dataStore_;
+  std::shared_ptr<DataStoreListener> dataStoreListener_;
+  std::unique_ptr<CategoryFilter> filter_;
+  std::unique_ptr<CompiledCategoryFilter> compiledFilter_;
+  std::set<ObjectId> matches_;
+  /// Entities whose match changed since the last notification; true if they now match
+  std::map<ObjectId, bool> pending_;
+  std::vector<ListenerPtr> listeners_;
+  /// True after a flush, until the next update re-tests every entity
+  bool testAllPending_ = false;
+};
+
+}
+
+#endif /* SIMDATA_CATEGORYFILTERRESULTS_H */
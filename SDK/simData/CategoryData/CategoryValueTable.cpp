@@ -0,0 +1,137 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cassert>
+#include <limits>
+#include "simData/CategoryData/CategoryValueTable.h"
+
+namespace simData {
+
+const int CategoryValueTable::NO_VALUE = std::numeric_limits<int>::min();
+
+CategoryValueTable::CategoryValueTable()
+{
+}
+
+CategoryValueTable::~CategoryValueTable()
+{
+}
+
+size_t CategoryValueTable::numRows() const
+{
+  return ids_.size();
+}
+
+ObjectId CategoryValueTable::id(size_t row) const
+{
+  // Assertion failure means the row is out of range
+  assert(row < ids_.size());
+  return ids_[row];
+}
+
+bool CategoryValueTable::findRow(ObjectId id, size_t& row) const
+{
+  auto it = rows_.find(id);
+  if (it == rows_.end())
+    return false;
+  row = it->second;
+  return true;
+}
+
+const std::vector<int>* CategoryValueTable::column(int nameInt) const
+{
+  auto it = columns_.find(nameInt);
+  return (it == columns_.end()) ? nullptr : &it->second;
+}
+
+void CategoryValueTable::names(std::vector<int>& nameInts) const
+{
+  nameInts.clear();
+  for (const auto& nameAndColumn : columns_)
+    nameInts.push_back(nameAndColumn.first);
+}
+
+void CategoryValueTable::setValues(ObjectId id, const std::map<int, int>& values)
+{
+  auto inserted = rows_.insert(std::make_pair(id, ids_.size()));
+  const size_t row = inserted.first->second;
+  if (inserted.second)
+  {
+    ids_.push_back(id);
+    for (auto& nameAndColumn : columns_)
+      nameAndColumn.second.push_back(NO_VALUE);
+  }
+
+  // Walk the columns and the values together, clearing the categories the entity no longer has
+  auto value = values.begin();
+  for (auto& nameAndColumn : columns_)
+  {
+    for (; value != values.end() && value->first < nameAndColumn.first; ++value)
+    {
+      std::vector<int>& newColumn = columns_[value->first];
+      newColumn.resize(ids_.size(), NO_VALUE);
+      newColumn[row] = value->second;
+    }
+    if (value != values.end() && value->first == nameAndColumn.first)
+    {
+      nameAndColumn.second[row] = value->second;
+      ++value;
+    }
+    else
+      nameAndColumn.second[row] = NO_VALUE;
+  }
+  for (; value != values.end(); ++value)
+  {
+    std::vector<int>& newColumn = columns_[value->first];
+    newColumn.resize(ids_.size(), NO_VALUE);
+    newColumn[row] = value->second;
+  }
+}
+
+void CategoryValueTable::removeEntity(ObjectId id)
+{
+  auto it = rows_.find(id);
+  if (it == rows_.end())
+    return;
+  const size_t row = it->second;
+  const size_t last = ids_.size() - 1;
+  rows_.erase(it);
+  if (row != last)
+  {
+    ids_[row] = ids_[last];
+    rows_[ids_[row]] = row;
+    for (auto& nameAndColumn : columns_)
+      nameAndColumn.second[row] = nameAndColumn.second[last];
+  }
+  ids_.pop_back();
+  for (auto& nameAndColumn : columns_)
+    nameAndColumn.second.pop_back();
+}
+
+void CategoryValueTable::clear()
+{
+  ids_.clear();
+  rows_.clear();
+  columns_.clear();
+}
+
+}
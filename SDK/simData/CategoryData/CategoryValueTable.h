@@ -0,0 +1,81 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_CATEGORYVALUETABLE_H
+#define SIMDATA_CATEGORYVALUETABLE_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/ObjectId.h"
+
+namespace simData {
+
+/**
+ * Columnar table of the current category values of many entities: one row per entity, and for
+ * each category name a column holding the value int of every row.  Evaluating a filter against
+ * the columns is a tight loop per category rather than a map lookup per entity and category; see
+ * CompiledCategoryFilter.  MemoryDataStore keeps a table of all its entities current as of the
+ * last update(); other tables can be filled from CategoryFilter::getCurrentCategoryValues().
+ * Copies are independent, so a copy may be read in another thread while the original changes.
+ */
+class SDKDATA_EXPORT CategoryValueTable
+{
+public:
+  /// Value int of a row that has no value for the category at the current time
+  static const int NO_VALUE;
+
+  CategoryValueTable();
+  virtual ~CategoryValueTable();
+
+  /// Number of rows, one for each entity
+  size_t numRows() const;
+  /// Entity of the row, which must be less than numRows()
+  ObjectId id(size_t row) const;
+  /// Returns true and sets the row of the entity, or returns false if the entity has no row
+  bool findRow(ObjectId id, size_t& row) const;
+
+  /// Returns the value ints of the category for each row, or nullptr if no row ever had a value; rows without a value hold NO_VALUE
+  const std::vector<int>* column(int nameInt) const;
+  /// Retrieves the category names that have a column
+  void names(std::vector<int>& nameInts) const;
+
+  /// Replaces the current values of the entity, adding a row for it if needed
+  void setValues(ObjectId id, const std::map<int, int>& values);
+  /// Removes the row of the entity; the last row takes its place
+  void removeEntity(ObjectId id);
+  /// Removes all rows and columns
+  void clear();
+
+private:
+  /// Entity of each row
+  std::vector<ObjectId> ids_;
+  /// Row of each entity
+  std::map<ObjectId, size_t> rows_;
+  /// Value int of each row, by category name
+  std::map<int, std::vector<int> > columns_;
+};
+
+}
+
+#endif /* SIMDATA_CATEGORYVALUETABLE_H */
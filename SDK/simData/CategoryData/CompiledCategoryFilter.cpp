@@ -0,0 +1,270 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include "simData/DataStore.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/CategoryData/CategoryValueTable.h"
+#include "simData/CategoryData/CompiledCategoryFilter.h"
+
+namespace simData {
+
+namespace
+{
+  /** Number of 64 bit words in a bitset of the rows */
+  size_t numWords(size_t numRows)
+  {
+    return (numRows + 63) / 64;
+  }
+
+  /** Sets the bits of all rows, leaving the bits past the last row clear */
+  void setAllRows(size_t numRows, std::vector<uint64_t>& rows)
+  {
+    rows.assign(numWords(numRows), ~static_cast<uint64_t>(0));
+    if (numRows % 64 != 0)
+      rows.back() = (static_cast<uint64_t>(1) << (numRows % 64)) - 1;
+  }
+}
+
+CompiledCategoryFilter::CompiledCategoryFilter(const CategoryFilter& filter)
+{
+  if (filter.categoryCheck_.empty() && filter.categoryRegExp_.empty())
+    return;
+  if (filter.dataStore_ != nullptr)
+    nameManager_ = &filter.dataStore_->categoryNameManager();
+
+  // Regular expressions apply only with a data store, but replace the checks of their category regardless
+  std::map<int, RegExpFilterPtr> regExps;
+  for (const auto& nameAndRegExp : filter.categoryRegExp_)
+  {
+    if (nameAndRegExp.second && !nameAndRegExp.second->pattern().empty())
+      regExps[nameAndRegExp.first] = nameAndRegExp.second;
+  }
+
+  for (const auto& nameAndValues : filter.categoryCheck_)
+  {
+    // Same categories that CategoryFilter::matchData() skips
+    if (nameAndValues.first == CategoryNameManager::NO_CATEGORY_NAME || !nameAndValues.second.first ||
+      regExps.find(nameAndValues.first) != regExps.end())
+      continue;
+
+    Category category;
+    category.nameInt = nameAndValues.first;
+    category.checks = nameAndValues.second.second;
+    auto noValue = category.checks.find(CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
+    category.passNoValue = (noValue != category.checks.end() && noValue->second);
+    auto unlisted = category.checks.find(CategoryNameManager::UNLISTED_CATEGORY_VALUE);
+    category.passUnlisted = (unlisted != category.checks.end() && unlisted->second);
+
+    // Every value at or above 0 has a known result, so results need only cover the listed values
+    if (!category.checks.empty() && category.checks.rbegin()->first >= 0)
+    {
+      category.results.assign(category.checks.rbegin()->first + 1, category.passUnlisted ? 1 : 0);
+      for (const auto& valueAndCheck : category.checks)
+      {
+        if (valueAndCheck.first >= 0)
+          category.results[valueAndCheck.first] = valueAndCheck.second ? 1 : 0;
+      }
+    }
+    categories_.push_back(category);
+  }
+
+  if (nameManager_ == nullptr)
+    return;
+  std::vector<int> valueInts;
+  for (const auto& nameAndRegExp : regExps)
+  {
+    Category category;
+    category.nameInt = nameAndRegExp.first;
+    category.regExp = nameAndRegExp.second;
+    category.passNoValue = category.regExp->match("");
+
+    // Match each known value once; values added later are matched as they are seen
+    nameManager_->allValueIntsInCategory(category.nameInt, valueInts);
+    for (int valueInt : valueInts)
+    {
+      if (valueInt < 0)
+        continue;
+      if (static_cast<size_t>(valueInt) >= category.results.size())
+        category.results.resize(valueInt + 1, -1);
+      category.results[valueInt] = category.regExp->match(nameManager_->valueIntToString(valueInt)) ? 1 : 0;
+    }
+    valueInts.clear();
+    categories_.push_back(category);
+  }
+}
+
+CompiledCategoryFilter::~CompiledCategoryFilter()
+{
+}
+
+bool CompiledCategoryFilter::isEmpty() const
+{
+  return categories_.empty();
+}
+
+bool CompiledCategoryFilter::matchData(const CategoryFilter::CurrentCategoryValues& curCategoryData) const
+{
+  for (const auto& category : categories_)
+  {
+    auto it = curCategoryData.find(category.nameInt);
+    if (!passes_(category, (it == curCategoryData.end()) ? CategoryValueTable::NO_VALUE : it->second))
+      return false;
+  }
+  return true;
+}
+
+void CompiledCategoryFilter::match(const CategoryValueTable& table, std::vector<uint64_t>& rows) const
+{
+  const size_t numRows = table.numRows();
+  setAllRows(numRows, rows);
+  std::vector<uint64_t> passing;
+  for (const auto& category : categories_)
+  {
+    passingRows_(category, table.column(category.nameInt), numRows, passing);
+    for (size_t word = 0; word < rows.size(); ++word)
+      rows[word] &= passing[word];
+  }
+}
+
+void CompiledCategoryFilter::matchingIds(const CategoryValueTable& table, std::vector<ObjectId>& ids) const
+{
+  ids.clear();
+  std::vector<uint64_t> rows;
+  match(table, rows);
+  for (size_t word = 0; word < rows.size(); ++word)
+  {
+    size_t row = word * 64;
+    for (uint64_t bits = rows[word]; bits != 0; bits >>= 1, ++row)
+    {
+      if ((bits & 1) != 0)
+        ids.push_back(table.id(row));
+    }
+  }
+}
+
+void CompiledCategoryFilter::countValues(const CategoryValueTable& table, const std::vector<uint64_t>& rows, std::map<int, ValueCounts>& counts) const
+{
+  if (counts.empty())
+    return;
+  const size_t numRows = table.numRows();
+  const size_t words = std::min(numWords(numRows), rows.size());
+
+  // Rows that fail at least once and at least twice; a row counts for a category if that category
+  // is the only one it fails, or if it fails none
+  std::vector<uint64_t> once(words, 0);
+  std::vector<uint64_t> twice(words, 0);
+  std::map<int, std::vector<uint64_t> > failing;
+  std::vector<uint64_t> passing;
+  for (const auto& category : categories_)
+  {
+    passingRows_(category, table.column(category.nameInt), numRows, passing);
+    for (size_t word = 0; word < words; ++word)
+    {
+      const uint64_t fail = ~passing[word];
+      twice[word] |= once[word] & fail;
+      once[word] |= fail;
+    }
+    if (counts.find(category.nameInt) != counts.end())
+    {
+      std::vector<uint64_t>& fail = failing[category.nameInt];
+      fail.resize(words);
+      for (size_t word = 0; word < words; ++word)
+        fail[word] = ~passing[word];
+    }
+  }
+
+  for (auto& nameAndCounts : counts)
+  {
+    const std::vector<int>* column = table.column(nameAndCounts.first);
+    auto fail = failing.find(nameAndCounts.first);
+    ValueCounts& valueCounts = nameAndCounts.second;
+    for (size_t word = 0; word < words; ++word)
+    {
+      uint64_t bits = rows[word] & ~once[word];
+      if (fail != failing.end())
+        bits = rows[word] & ~twice[word] & (~once[word] | fail->second[word]);
+
+      size_t row = word * 64;
+      for (; bits != 0 && row < numRows; bits >>= 1, ++row)
+      {
+        if ((bits & 1) == 0)
+          continue;
+        const int value = (column == nullptr) ? CategoryValueTable::NO_VALUE : (*column)[row];
+        ++valueCounts[(value == CategoryValueTable::NO_VALUE) ? CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME : value];
+      }
+    }
+  }
+}
+
+bool CompiledCategoryFilter::passes_(const Category& category, int valueInt) const
+{
+  if (valueInt == CategoryValueTable::NO_VALUE)
+    return category.passNoValue;
+  if (valueInt >= 0 && static_cast<size_t>(valueInt) < category.results.size() && category.results[valueInt] >= 0)
+    return category.results[valueInt] != 0;
+  return passesUncompiled_(category, valueInt);
+}
+
+bool CompiledCategoryFilter::passesUncompiled_(const Category& category, int valueInt) const
+{
+  if (category.regExp)
+    return category.regExp->match(nameManager_->valueIntToString(valueInt));
+  // Values at or above 0 past the end of results are unlisted
+  if (valueInt >= 0)
+    return category.passUnlisted;
+  auto it = category.checks.find(valueInt);
+  if (it == category.checks.end())
+    return category.passUnlisted;
+  return it->second;
+}
+
+void CompiledCategoryFilter::passingRows_(const Category& category, const std::vector<int>* column, size_t numRows, std::vector<uint64_t>& rows) const
+{
+  if (column == nullptr)
+  {
+    if (category.passNoValue)
+      setAllRows(numRows, rows);
+    else
+      rows.assign(numWords(numRows), 0);
+    return;
+  }
+
+  rows.assign(numWords(numRows), 0);
+  const int* values = column->data();
+  const int8_t* results = category.results.data();
+  const size_t numResults = category.results.size();
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    const int value = values[row];
+    bool pass;
+    // Unsigned compare rejects negative values, including NO_VALUE, for the slow path
+    if (static_cast<unsigned int>(value) < numResults && results[value] >= 0)
+      pass = (results[value] != 0);
+    else
+      pass = passes_(category, value);
+    if (pass)
+      rows[row / 64] |= static_cast<uint64_t>(1) << (row % 64);
+  }
+}
+
+}
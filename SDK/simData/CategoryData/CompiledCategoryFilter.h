@@ -0,0 +1,116 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_COMPILEDCATEGORYFILTER_H
+#define SIMDATA_COMPILEDCATEGORYFILTER_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/ObjectId.h"
+#include "simData/CategoryData/CategoryFilter.h"
+
+namespace simData {
+
+class CategoryNameManager;
+class CategoryValueTable;
+
+/**
+ * Compiled form of a CategoryFilter for evaluating many entities.  Each category that contributes
+ * to the filter becomes a table of pass/fail results indexed by value int, with the results of
+ * regular expressions computed once per value rather than once per entity.  Matching every row of
+ * a CategoryValueTable is then one pass per category that ANDs the results into a bitset of rows.
+ *
+ * The compiled filter is a copy: recompile after changing the CategoryFilter.  Values added to the
+ * category name manager after compiling are still handled, more slowly.  All methods are const and
+ * may be called from any thread, as long as the data store's category name manager does not change
+ * while a filter with regular expressions runs.
+ */
+class SDKDATA_EXPORT CompiledCategoryFilter
+{
+public:
+  /** Maps category value int to a count; NO_CATEGORY_VALUE_AT_TIME counts entities without a value */
+  typedef std::map<int, size_t> ValueCounts;
+
+  /** Compiles the current checks and regular expressions of the filter */
+  explicit CompiledCategoryFilter(const CategoryFilter& filter);
+  virtual ~CompiledCategoryFilter();
+
+  /** Returns true if the filter matches every entity */
+  bool isEmpty() const;
+
+  /** Returns the same result as CategoryFilter::matchData() */
+  bool matchData(const CategoryFilter::CurrentCategoryValues& curCategoryData) const;
+
+  /**
+   * Evaluates the filter for every row of the table.
+   * @param table Current category values of the entities
+   * @param rows Receives a bitset of the rows that match: bit (row % 64) of rows[row / 64]
+   */
+  void match(const CategoryValueTable& table, std::vector<uint64_t>& rows) const;
+  /** Retrieves the IDs of the entities in the table that match the filter, in row order */
+  void matchingIds(const CategoryValueTable& table, std::vector<ObjectId>& ids) const;
+
+  /**
+   * For each category in counts, counts the rows that match every other category of the filter,
+   * by their value of that category.  This is the number of entities the filter would match with
+   * only that value checked in that category, as reported by simQt::CategoryFilterCounter.  Counts
+   * are added to the values already in the maps, including values that are not in the maps.
+   * @param table Current category values of the entities
+   * @param rows Bitset of the rows to count, as from match(); rows beyond its end are not counted
+   * @param counts Map of category name int to the counts of its values
+   */
+  void countValues(const CategoryValueTable& table, const std::vector<uint64_t>& rows, std::map<int, ValueCounts>& counts) const;
+
+private:
+  /** Compiled checks of one category */
+  struct Category
+  {
+    int nameInt = 0;
+    /// Result for each value int below its size: 1 pass, 0 fail, -1 not known at compile time
+    std::vector<int8_t> results;
+    /// Result for entities with no value for the category
+    bool passNoValue = false;
+    /// Result for values that are not listed in checks; unused for regular expressions
+    bool passUnlisted = false;
+    /// Checks of the values, for values outside of results
+    CategoryFilter::ValuesCheck checks;
+    /// Regular expression that replaces the checks; nullptr if none
+    RegExpFilterPtr regExp;
+  };
+
+  /** Returns true if the value int, or CategoryValueTable::NO_VALUE, passes the category */
+  bool passes_(const Category& category, int valueInt) const;
+  /** Slow path of passes_() for values without a compiled result */
+  bool passesUncompiled_(const Category& category, int valueInt) const;
+  /** Sets a bit for each row whose value in the column passes the category */
+  void passingRows_(const Category& category, const std::vector<int>* column, size_t numRows, std::vector<uint64_t>& rows) const;
+
+  std::vector<Category> categories_;
+  /// Converts value ints for regular expressions; nullptr if the filter has no data store
+  const CategoryNameManager* nameManager_ = nullptr;
+};
+
+}
+
+#endif /* SIMDATA_COMPILEDCATEGORYFILTER_H */
@@ -0,0 +1,574 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_COLUMNARDATASLICE_INL_H
+#define SIMDATA_COLUMNARDATASLICE_INL_H
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace simData
+{
+
+template <typename T>
+ColumnChunkPool<T>::ColumnChunkPool(size_t maxFreeChunks)
+  : maxFree_(maxFreeChunks),
+    inUse_(0)
+{
+}
+
+template <typename T>
+ColumnChunkPool<T>::~ColumnChunkPool()
+{
+  // Any chunks still in use belong to slices that outlive the pool, which is an error
+  assert(inUse_ == 0);
+  for (auto* chunk : free_)
+    delete chunk;
+}
+
+template <typename T>
+ColumnChunk<T>* ColumnChunkPool<T>::acquire()
+{
+  ++inUse_;
+  if (free_.empty())
+    return new ColumnChunk<T>();
+
+  ColumnChunk<T>* rv = free_.back();
+  free_.pop_back();
+  return rv;
+}
+
+template <typename T>
+void ColumnChunkPool<T>::release(ColumnChunk<T>* chunk)
+{
+  if (chunk == nullptr)
+    return;
+
+  assert(inUse_ > 0);
+  --inUse_;
+  chunk->views.reset();
+  if (free_.size() < maxFree_)
+    free_.push_back(chunk);
+  else
+    delete chunk;
+}
+
+template <typename T>
+size_t ColumnChunkPool<T>::numInUse() const
+{
+  return inUse_;
+}
+
+template <typename T>
+size_t ColumnChunkPool<T>::numFree() const
+{
+  return free_.size();
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+ColumnarDataSlice<T>::ColumnarDataSlice(std::shared_ptr<ColumnChunkPool<T> > pool)
+  : IndexedDataSlice<T, ColumnarDataSlice<T> >(),
+    pool_(pool),
+    head_(0),
+    size_(0)
+{
+  assert(pool_);
+}
+
+template <typename T>
+ColumnarDataSlice<T>::~ColumnarDataSlice()
+{
+  clear_();
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::flush(bool keepStatic)
+{
+  // don't flush static entities
+  if (!keepStatic || size_ != 1 || timeAt(0) != -1.0)
+  {
+    clear_();
+    this->current_ = nullptr;
+  }
+  this->dirty_ = true;
+
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::flush(double startTime, double endTime)
+{
+  const size_t first = lowerBoundIndex_(startTime);
+  if ((first != size_) && (timeAt(first) < endTime))
+  {
+    // endTime is non-inclusive
+    size_t last = first;
+    while ((last < size_) && (timeAt(last) < endTime))
+      ++last;
+    eraseRange_(first, last);
+    this->current_ = nullptr;
+  }
+  this->dirty_ = true;
+
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+size_t ColumnarDataSlice<T>::numItems() const
+{
+  return size_;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::visit(typename DataSlice<T>::Visitor *visitor) const
+{
+  T scratch;
+  for (size_t ii = 0; ii < size_; ++ii)
+  {
+    load_(ii, scratch);
+    (*visitor)(&scratch);
+  }
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::insert(T *data)
+{
+  if (this->notifierFn_)
+    this->notifierFn_();
+
+  const double time = data->time();
+  if ((size_ == 0) || (timeAt(size_ - 1) < time))
+  {
+    grow_();
+    store_(size_ - 1, *data);
+  }
+  else
+  {
+    const size_t index = lowerBoundIndex_(time);
+    if (timeAt(index) == time)
+    {
+      // null the current ptr, if we are replacing the update it aliases; current will become valid upon update
+      if (((this->current_ == &this->currentExact_) && (this->currentExact_.time() == time)) || isView_(this->current_, index))
+        this->setCurrent(nullptr);
+    }
+    else
+    {
+      // shift the later updates back one slot to make room
+      grow_();
+      for (size_t ii = size_ - 1; ii > index; --ii)
+        move_(ii, ii - 1);
+    }
+    store_(index, *data);
+  }
+
+  delete data;
+  this->dirty_ = true;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::insertMany(std::vector<T*>& data)
+{
+  if (data.empty())
+    return;
+
+  if (this->notifierFn_)
+    this->notifierFn_();
+
+  this->sortUnique_(data);
+
+  if ((size_ != 0) && (timeAt(size_ - 1) >= data.front()->time()))
+  {
+    // Merge with the existing updates, then rebuild the columns from the merged list
+    std::vector<T> merged;
+    merged.reserve(size_ + data.size());
+    bool replaced = false;
+    size_t oldIndex = 0;
+    auto newIter = data.begin();
+    while (oldIndex < size_ && newIter != data.end())
+    {
+      const double oldTime = timeAt(oldIndex);
+      if (oldTime < (*newIter)->time())
+      {
+        merged.push_back(T());
+        load_(oldIndex++, merged.back());
+      }
+      else
+      {
+        if (oldTime == (*newIter)->time())
+        {
+          replaced = replaced || ((this->current_ == &this->currentExact_) && (this->currentExact_.time() == oldTime));
+          ++oldIndex;
+        }
+        merged.push_back(**newIter++);
+      }
+    }
+    for (; oldIndex < size_; ++oldIndex)
+    {
+      merged.push_back(T());
+      load_(oldIndex, merged.back());
+    }
+    for (; newIter != data.end(); ++newIter)
+      merged.push_back(**newIter);
+
+    // null the current ptr, if we are replacing the update it aliases; current will become valid upon update
+    if (replaced)
+      this->setCurrent(nullptr);
+    clear_();
+    for (const auto& update : merged)
+    {
+      grow_();
+      store_(size_ - 1, update);
+    }
+  }
+  else
+  {
+    // Common case of appending newer data
+    for (const auto* update : data)
+    {
+      grow_();
+      store_(size_ - 1, *update);
+    }
+  }
+
+  for (auto* update : data)
+    delete update;
+  data.clear();
+  this->dirty_ = true;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::limitByTime(double timeWindow)
+{
+  if ((timeWindow < 0) || (size_ == 0))
+    return;
+
+  const double timeLimit = this->lastTime() - timeWindow;
+  if (timeLimit < 0.0)
+    return;
+
+  // always leave one point
+  size_t newFirst = upperBoundIndex_(timeLimit);
+  if (newFirst == size_)
+    --newFirst;
+  if (newFirst == 0)
+    return;
+
+  eraseFront_(newFirst);
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::limitByPoints(uint32_t limitPoints)
+{
+  // zero is special case for "no limit"
+  if ((limitPoints == 0) || (size_ <= limitPoints))
+    return;
+
+  eraseFront_(size_ - limitPoints);
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+size_t ColumnarDataSlice<T>::memoryUsage() const
+{
+  size_t rv = sizeof(*this) + chunks_.size() * (sizeof(ColumnChunk<T>*) + sizeof(ColumnChunk<T>));
+  for (const auto* chunk : chunks_)
+  {
+    if (chunk->views)
+      rv += ColumnChunkSize * sizeof(T);
+  }
+  return rv;
+}
+
+template <typename T>
+double ColumnarDataSlice<T>::timeAt(size_t index) const
+{
+  size_t offset = 0;
+  return chunk_(index, offset)->times[offset];
+}
+
+template <typename T>
+const T* ColumnarDataSlice<T>::at(size_t index) const
+{
+  assert(index < size_);
+  const size_t position = head_ + index;
+  ColumnChunk<T>* chunk = chunks_[position / ColumnChunkSize];
+  if (!chunk->views)
+    materialize_(*chunk, position / ColumnChunkSize);
+  return &chunk->views[position % ColumnChunkSize];
+}
+
+template <typename T>
+ColumnChunk<T>* ColumnarDataSlice<T>::chunk_(size_t index, size_t& offset) const
+{
+  const size_t position = head_ + index;
+  offset = position % ColumnChunkSize;
+  return chunks_[position / ColumnChunkSize];
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::load_(size_t index, T& update) const
+{
+  size_t offset = 0;
+  const ColumnChunk<T>* chunk = chunk_(index, offset);
+  ColumnLayout<T>::load(chunk->doubles.data(), chunk->floats.data(), chunk->flags[offset], offset, update);
+  update.set_time(chunk->times[offset]);
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::store_(size_t index, const T& update)
+{
+  size_t offset = 0;
+  ColumnChunk<T>* chunk = chunk_(index, offset);
+  chunk->times[offset] = update.time();
+  ColumnLayout<T>::store(update, chunk->doubles.data(), chunk->floats.data(), chunk->flags[offset], offset);
+  if (chunk->views)
+    chunk->views[offset] = update;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::move_(size_t to, size_t from)
+{
+  size_t toOffset = 0;
+  size_t fromOffset = 0;
+  ColumnChunk<T>* toChunk = chunk_(to, toOffset);
+  const ColumnChunk<T>* fromChunk = chunk_(from, fromOffset);
+
+  toChunk->times[toOffset] = fromChunk->times[fromOffset];
+  for (size_t col = 0; col < ColumnLayout<T>::NumDoubles; ++col)
+    toChunk->doubles[col * ColumnChunkSize + toOffset] = fromChunk->doubles[col * ColumnChunkSize + fromOffset];
+  for (size_t col = 0; col < ColumnLayout<T>::NumFloats; ++col)
+    toChunk->floats[col * ColumnChunkSize + toOffset] = fromChunk->floats[col * ColumnChunkSize + fromOffset];
+  toChunk->flags[toOffset] = fromChunk->flags[fromOffset];
+
+  if (toChunk->views)
+    load_(to, toChunk->views[toOffset]);
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::materialize_(ColumnChunk<T>& chunk, size_t chunkIndex) const
+{
+  chunk.views.reset(new T[ColumnChunkSize]);
+
+  // Only the positions that hold updates are filled in; the rest are filled in by store_() or move_()
+  const size_t chunkStart = chunkIndex * ColumnChunkSize;
+  const size_t first = std::max(head_, chunkStart);
+  const size_t last = std::min(head_ + size_, chunkStart + ColumnChunkSize);
+  for (size_t position = first; position < last; ++position)
+    load_(position - head_, chunk.views[position - chunkStart]);
+}
+
+template <typename T>
+bool ColumnarDataSlice<T>::isView_(const T* ptr, size_t index) const
+{
+  if (ptr == nullptr)
+    return false;
+
+  size_t offset = 0;
+  const ColumnChunk<T>* chunk = chunk_(index, offset);
+  return chunk->views && (ptr == &chunk->views[offset]);
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::grow_()
+{
+  if (head_ + size_ == chunks_.size() * ColumnChunkSize)
+    chunks_.push_back(pool_->acquire());
+  ++size_;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::eraseFront_(size_t count)
+{
+  if (count >= size_)
+  {
+    clear_();
+    return;
+  }
+
+  head_ += count;
+  size_ -= count;
+  while (head_ >= ColumnChunkSize)
+  {
+    releaseChunk_(chunks_.front());
+    chunks_.pop_front();
+    head_ -= ColumnChunkSize;
+  }
+  this->fastIndex_ = 0;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::eraseRange_(size_t first, size_t last)
+{
+  if (first == 0)
+  {
+    eraseFront_(last);
+    return;
+  }
+
+  const size_t count = last - first;
+  for (size_t ii = first; ii + count < size_; ++ii)
+    move_(ii, ii + count);
+  size_ -= count;
+
+  // Return the chunks that no longer hold any updates
+  const size_t needed = (head_ + size_ + ColumnChunkSize - 1) / ColumnChunkSize;
+  while (chunks_.size() > needed)
+  {
+    releaseChunk_(chunks_.back());
+    chunks_.pop_back();
+  }
+  this->fastIndex_ = 0;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::clear_()
+{
+  for (auto* chunk : chunks_)
+    releaseChunk_(chunk);
+  chunks_.clear();
+  head_ = 0;
+  size_ = 0;
+  this->fastIndex_ = 0;
+}
+
+template <typename T>
+void ColumnarDataSlice<T>::releaseChunk_(ColumnChunk<T>* chunk)
+{
+  if (chunk->views)
+  {
+    // Drop references into the views; the slice will recalculate them on the next update
+    const T* begin = chunk->views.get();
+    const T* end = begin + ColumnChunkSize;
+    const std::less<const T*> less;
+    auto isView = [&](const T* ptr) { return !less(ptr, begin) && less(ptr, end); };
+    if (isView(this->current_))
+    {
+      this->current_ = nullptr;
+      this->dirty_ = true;
+    }
+    if (isView(this->bounds_.first) || isView(this->bounds_.second))
+    {
+      this->bounds_ = typename DataSlice<T>::Bounds(static_cast<T*>(nullptr), static_cast<T*>(nullptr));
+      this->dirty_ = true;
+    }
+  }
+  pool_->release(chunk);
+}
+
+template <typename T>
+size_t ColumnarDataSlice<T>::lowerBoundIndex_(double time) const
+{
+  // Sequential playback usually lands next to the previous result, so look there first
+  size_t index = this->fastIndex_;
+  if (index < size_)
+  {
+    if (timeAt(index) <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && index < size_; ++ii, ++index)
+      {
+        if (timeAt(index) >= time)
+          return index;
+      }
+      if (index == size_)
+        return size_;
+    }
+    else
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && index != 0; ++ii, --index)
+      {
+        if (timeAt(index) < time)
+          return index + 1;
+      }
+    }
+  }
+
+  size_t first = 0;
+  size_t count = size_;
+  while (count > 0)
+  {
+    const size_t step = count / 2;
+    if (timeAt(first + step) < time)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+  return first;
+}
+
+template <typename T>
+size_t ColumnarDataSlice<T>::upperBoundIndex_(double time) const
+{
+  // Sequential playback usually lands next to the previous result, so look there first
+  size_t index = this->fastIndex_;
+  if (index < size_)
+  {
+    if (timeAt(index) <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && index < size_; ++ii, ++index)
+      {
+        if (timeAt(index) > time)
+          return index;
+      }
+      if (index == size_)
+        return size_;
+    }
+    else
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && index != 0; ++ii, --index)
+      {
+        if (timeAt(index) <= time)
+          return index + 1;
+      }
+      if ((index == 0) && (timeAt(0) > time))
+        return 0;
+    }
+  }
+
+  size_t first = 0;
+  size_t count = size_;
+  while (count > 0)
+  {
+    const size_t step = count / 2;
+    if (timeAt(first + step) <= time)
+    {
+      first += step + 1;
+      count -= step + 1;
+    }
+    else
+      count = step;
+  }
+  return first;
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_COLUMNARDATASLICE_INL_H
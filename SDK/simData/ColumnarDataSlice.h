@@ -0,0 +1,306 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_COLUMNARDATASLICE_H
+#define SIMDATA_COLUMNARDATASLICE_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/DataTypes.h"
+#include "simData/IndexedDataSlice.h"
+
+namespace simData
+{
+
+/// Number of updates held by each ColumnChunk
+const size_t ColumnChunkSize = 128;
+
+/**
+ * Describes how an update type is split into columns.  Each specialization gives the number of
+ * double and float columns, and copies an update to or from the columns at a given index.  Column
+ * k of a chunk starts at offset (k * ColumnChunkSize) of the chunk's double or float array.  The
+ * time is always stored in its own column and is not handled by the layout.
+ */
+template <typename T>
+struct ColumnLayout;
+
+/// Platform updates mark unset fields with max(); the sentinels round trip through the columns, so no flags are needed
+template <>
+struct ColumnLayout<PlatformUpdate>
+{
+  /// x, y, z
+  static constexpr size_t NumDoubles = 3;
+  /// psi, theta, phi, vx, vy, vz
+  static constexpr size_t NumFloats = 6;
+
+  /// Copies the update into the columns at index
+  static void store(const PlatformUpdate& update, double* doubles, float* floats, uint8_t& flags, size_t index)
+  {
+    doubles[index] = update.x();
+    doubles[ColumnChunkSize + index] = update.y();
+    doubles[2 * ColumnChunkSize + index] = update.z();
+    floats[index] = static_cast<float>(update.psi());
+    floats[ColumnChunkSize + index] = static_cast<float>(update.theta());
+    floats[2 * ColumnChunkSize + index] = static_cast<float>(update.phi());
+    floats[3 * ColumnChunkSize + index] = static_cast<float>(update.vx());
+    floats[4 * ColumnChunkSize + index] = static_cast<float>(update.vy());
+    floats[5 * ColumnChunkSize + index] = static_cast<float>(update.vz());
+    flags = 0;
+  }
+
+  /// Copies the columns at index into the update; the caller sets the time afterwards
+  static void load(const double* doubles, const float* floats, uint8_t flags, size_t index, PlatformUpdate& update)
+  {
+    update.set_x(doubles[index]);
+    update.set_y(doubles[ColumnChunkSize + index]);
+    update.set_z(doubles[2 * ColumnChunkSize + index]);
+    update.set_psi(floats[index]);
+    update.set_theta(floats[ColumnChunkSize + index]);
+    update.set_phi(floats[2 * ColumnChunkSize + index]);
+    update.set_vx(floats[3 * ColumnChunkSize + index]);
+    update.set_vy(floats[4 * ColumnChunkSize + index]);
+    update.set_vz(floats[5 * ColumnChunkSize + index]);
+  }
+};
+
+/// Beam updates are protobuf messages, so the has-bits are kept in the flags column
+template <>
+struct ColumnLayout<BeamUpdate>
+{
+  /// range, azimuth, elevation
+  static constexpr size_t NumDoubles = 3;
+  /// No single precision fields
+  static constexpr size_t NumFloats = 0;
+
+  /// Copies the update into the columns at index
+  static void store(const BeamUpdate& update, double* doubles, float* floats, uint8_t& flags, size_t index)
+  {
+    doubles[index] = update.range();
+    doubles[ColumnChunkSize + index] = update.azimuth();
+    doubles[2 * ColumnChunkSize + index] = update.elevation();
+    flags = static_cast<uint8_t>((update.has_range() ? 0x1 : 0) | (update.has_azimuth() ? 0x2 : 0) | (update.has_elevation() ? 0x4 : 0));
+  }
+
+  /// Copies the columns at index into the update; the caller sets the time afterwards
+  static void load(const double* doubles, const float* floats, uint8_t flags, size_t index, BeamUpdate& update)
+  {
+    update.Clear();
+    if (flags & 0x1)
+      update.set_range(doubles[index]);
+    if (flags & 0x2)
+      update.set_azimuth(doubles[ColumnChunkSize + index]);
+    if (flags & 0x4)
+      update.set_elevation(doubles[2 * ColumnChunkSize + index]);
+  }
+};
+
+/// Gate updates are protobuf messages, so the has-bits are kept in the flags column
+template <>
+struct ColumnLayout<GateUpdate>
+{
+  /// azimuth, elevation, width, height, minrange, maxrange, centroid
+  static constexpr size_t NumDoubles = 7;
+  /// No single precision fields
+  static constexpr size_t NumFloats = 0;
+
+  /// Copies the update into the columns at index
+  static void store(const GateUpdate& update, double* doubles, float* floats, uint8_t& flags, size_t index)
+  {
+    doubles[index] = update.azimuth();
+    doubles[ColumnChunkSize + index] = update.elevation();
+    doubles[2 * ColumnChunkSize + index] = update.width();
+    doubles[3 * ColumnChunkSize + index] = update.height();
+    doubles[4 * ColumnChunkSize + index] = update.minrange();
+    doubles[5 * ColumnChunkSize + index] = update.maxrange();
+    doubles[6 * ColumnChunkSize + index] = update.centroid();
+    flags = static_cast<uint8_t>((update.has_azimuth() ? 0x01 : 0) | (update.has_elevation() ? 0x02 : 0) |
+      (update.has_width() ? 0x04 : 0) | (update.has_height() ? 0x08 : 0) | (update.has_minrange() ? 0x10 : 0) |
+      (update.has_maxrange() ? 0x20 : 0) | (update.has_centroid() ? 0x40 : 0));
+  }
+
+  /// Copies the columns at index into the update; the caller sets the time afterwards
+  static void load(const double* doubles, const float* floats, uint8_t flags, size_t index, GateUpdate& update)
+  {
+    update.Clear();
+    if (flags & 0x01)
+      update.set_azimuth(doubles[index]);
+    if (flags & 0x02)
+      update.set_elevation(doubles[ColumnChunkSize + index]);
+    if (flags & 0x04)
+      update.set_width(doubles[2 * ColumnChunkSize + index]);
+    if (flags & 0x08)
+      update.set_height(doubles[3 * ColumnChunkSize + index]);
+    if (flags & 0x10)
+      update.set_minrange(doubles[4 * ColumnChunkSize + index]);
+    if (flags & 0x20)
+      update.set_maxrange(doubles[5 * ColumnChunkSize + index]);
+    if (flags & 0x40)
+      update.set_centroid(doubles[6 * ColumnChunkSize + index]);
+  }
+};
+
+/** Fixed size block of updates stored as structure-of-arrays */
+template <typename T>
+struct ColumnChunk
+{
+  /// Update times; kept in their own column so searches only touch this array
+  std::array<double, ColumnChunkSize> times;
+  /// Double precision fields, one column after another
+  std::array<double, ColumnLayout<T>::NumDoubles * ColumnChunkSize> doubles;
+  /// Single precision fields, one column after another
+  std::array<float, ColumnLayout<T>::NumFloats * ColumnChunkSize> floats;
+  /// Per-update flags, such as protobuf has-bits
+  std::array<uint8_t, ColumnChunkSize> flags;
+  /// Updates materialized on demand for callers that need a T pointer; nullptr until first needed
+  std::unique_ptr<T[]> views;
+};
+
+/**
+ * Recycles ColumnChunk blocks between the slices of a data store, so that steady state
+ * inserting and data limiting does not touch the heap.  Not thread safe; the pool is
+ * meant to be shared by the slices of a single MemoryDataStore.
+ */
+template <typename T>
+class ColumnChunkPool
+{
+public:
+  /** @param maxFreeChunks Number of released chunks to keep for reuse; extras are deleted */
+  explicit ColumnChunkPool(size_t maxFreeChunks = 256);
+  virtual ~ColumnChunkPool();
+  SDK_DISABLE_COPY(ColumnChunkPool);
+
+  /// Returns a chunk with undefined contents and no views
+  ColumnChunk<T>* acquire();
+  /// Returns the chunk to the pool; the chunk's views are released
+  void release(ColumnChunk<T>* chunk);
+
+  /// Number of chunks handed out and not yet released
+  size_t numInUse() const;
+  /// Number of chunks waiting for reuse
+  size_t numFree() const;
+
+private:
+  std::vector<ColumnChunk<T>*> free_;
+  size_t maxFree_;
+  size_t inUse_;
+};
+
+/**
+ * MemoryDataSlice that copies its updates into pooled structure-of-arrays chunks instead of
+ * keeping a separately allocated T per update.  Time searches run over the contiguous time
+ * column, and updates are only rebuilt as T objects when a caller needs one:
+ *  - update() keeps copies of the current update and of the interpolation bounds inside the slice,
+ *    so playing through the data does not materialize anything.
+ *  - Iterators materialize a whole chunk of views on first access.  Views stay valid until their
+ *    chunk is removed by flushing or data limiting; an out-of-order insert shifts the later views.
+ *  - visit() passes a temporary that is only valid for the duration of the callback.
+ * Available for PlatformUpdate, BeamUpdate and GateUpdate; see ColumnLayout.
+ */
+template <typename T>
+class ColumnarDataSlice : public IndexedDataSlice<T, ColumnarDataSlice<T> >
+{
+  friend class IndexedDataSlice<T, ColumnarDataSlice<T> >;
+
+public:
+  /** @param pool Source of chunks, normally shared with the other slices of the data store */
+  explicit ColumnarDataSlice(std::shared_ptr<ColumnChunkPool<T> > pool);
+  virtual ~ColumnarDataSlice();
+  SDK_DISABLE_COPY(ColumnarDataSlice);
+
+  /// remove all data in the slice
+  virtual void flush(bool keepStatic = true);
+  /// remove points in the given time range; up to but not including endTime
+  virtual void flush(double startTime, double endTime);
+
+  /// Total number of items in this data slice
+  virtual size_t numItems() const;
+
+  /// Process update range; the pointer given to the visitor is only valid during the call
+  virtual void visit(typename DataSlice<T>::Visitor *visitor) const;
+
+  /// Copies the update into the columns and deletes it; replaces any update with the same time
+  virtual void insert(T *data);
+  /// Copies the updates into the columns and deletes them, appending directly when they are all newer
+  virtual void insertMany(std::vector<T*>& data);
+
+  /// reduce the data store to only have points within the given 'timeWindow'
+  virtual void limitByTime(double timeWindow);
+  /// reduce the data store to only have 'limitPoints' points
+  virtual void limitByPoints(uint32_t limitPoints);
+
+  /** Approximate number of bytes used to hold the slice, its chunks and any materialized views */
+  virtual size_t memoryUsage() const;
+
+  /** Time of the update at index, which must be less than numItems() */
+  double timeAt(size_t index) const;
+  /** Returns the materialized view of the update at index, which must be less than numItems() */
+  const T* at(size_t index) const;
+
+private:
+  /// Returns the chunk holding index and the offset of index within the chunk
+  ColumnChunk<T>* chunk_(size_t index, size_t& offset) const;
+  /// Copies the update at index into the given object
+  void load_(size_t index, T& update) const;
+  /// Copies the update into the columns (and view, if any) at index
+  void store_(size_t index, const T& update);
+  /// Copies the update at index from to index to
+  void move_(size_t to, size_t from);
+  /// Builds the views for every stored update in the chunk
+  void materialize_(ColumnChunk<T>& chunk, size_t chunkIndex) const;
+  /// Returns true if ptr is the view of the update at index
+  bool isView_(const T* ptr, size_t index) const;
+
+  /// Makes room for one more update at the back
+  void grow_();
+  /// Removes the first count updates
+  void eraseFront_(size_t count);
+  /// Removes updates in [first, last)
+  void eraseRange_(size_t first, size_t last);
+  /// Removes every update
+  void clear_();
+  /// Returns the chunk to the pool, dropping any references to its views
+  void releaseChunk_(ColumnChunk<T>* chunk);
+
+  /// Index of the first update with time >= the given time, or numItems()
+  size_t lowerBoundIndex_(double time) const;
+  /// Index of the first update with time > the given time, or numItems()
+  size_t upperBoundIndex_(double time) const;
+
+  std::shared_ptr<ColumnChunkPool<T> > pool_;
+  /// Chunks in time order; update i is at position (head_ + i) of the concatenated chunks
+  std::deque<ColumnChunk<T>*> chunks_;
+  /// Position of the first update within the first chunk
+  size_t head_;
+  /// Number of updates stored
+  size_t size_;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/ColumnarDataSlice-inl.h"
+
+#endif // SIMDATA_COLUMNARDATASLICE_H
@@ -27,6 +27,7 @@
 #include "simCore/Calc/Math.h"
 #include "simData/UpdateComp.h"
 #include "simData/Interpolator.h"
+#include "simData/TimeBucketIndex.h"
 
 namespace simData
 {
@@ -35,8 +36,9 @@ const size_t FastSearchWidth = 3;
 
 /// Like std::lower_bound, but uses currentIt to find quickly a neighboring location.
 // (provides significant performance improvement when sequentially moving through time)
+// Falls back to the time index, if given, rather than a binary search when currentIt is not close.
 template <typename ForwardIterator, typename T>
-ForwardIterator computeLowerBound(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time)
+ForwardIterator computeLowerBound(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time, const TimeBucketIndex<T>* index = nullptr)
 {
   if (currentIt != end)
   {
@@ -60,13 +62,16 @@ ForwardIterator computeLowerBound(ForwardIterator begin, ForwardIterator current
     }
   }
 
+ if (index != nullptr)
+   return index->lowerBound(begin, end, time);
  return std::lower_bound(begin, end, time, UpdateComp<T>());
 }
 
 /// Like std::upper_bound, but uses currentIt to find quickly a neighboring location.
 // (provides significant performance improvement when sequentially moving through time)
+// Falls back to the time index, if given, rather than a binary search when currentIt is not close.
 template <typename ForwardIterator, typename T>
-ForwardIterator computeUpperBound(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time)
+ForwardIterator computeUpperBound(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time, const TimeBucketIndex<T>* index = nullptr)
 {
   if (currentIt != end)
   {
@@ -99,19 +104,21 @@ ForwardIterator computeUpperBound(ForwardIterator begin, ForwardIterator current
     }
   }
 
+  if (index != nullptr)
+    return index->upperBound(begin, end, time);
   return std::upper_bound(begin, end, time, UpdateComp<T>());
 }
 
 /** Update slices to the specified time */
 template <typename ForwardIterator, typename T>
-ForwardIterator computeTimeUpdate(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time)
+ForwardIterator computeTimeUpdate(ForwardIterator begin, ForwardIterator currentIt, ForwardIterator end, double time, const TimeBucketIndex<T>* index = nullptr)
 {
   if (begin == end)
   {
     return end;
   }
 
-  currentIt = computeLowerBound<ForwardIterator, T>(begin, currentIt, end, time);
+  currentIt = computeLowerBound<ForwardIterator, T>(begin, currentIt, end, time, index);
 
   // Current update is selected as the point <= to current time;
   if (currentIt == end)
@@ -154,7 +161,7 @@ class Interpolator;
  */
 
 template <typename ForwardIterator, typename T, typename B>
-T *computeTimeUpdate(ForwardIterator begin, ForwardIterator& currentIt, ForwardIterator end, double time, Interpolator *interpolator, bool *isInterpolated, T *interpolatedPoint, B *bounds)
+T *computeTimeUpdate(ForwardIterator begin, ForwardIterator& currentIt, ForwardIterator end, double time, Interpolator *interpolator, bool *isInterpolated, T *interpolatedPoint, B *bounds, const TimeBucketIndex<T>* index = nullptr)
 {
   assert(interpolator && isInterpolated && interpolatedPoint && bounds);
 
@@ -165,7 +172,7 @@ T *computeTimeUpdate(ForwardIterator begin, ForwardIterator& currentIt, ForwardI
     return nullptr;
   }
 
-  currentIt = computeUpperBound<ForwardIterator, T>(begin, currentIt, end, time);
+  currentIt = computeUpperBound<ForwardIterator, T>(begin, currentIt, end, time, index);
 
   // Current update is selected as the point <= to current time;
   // will be interpolated/extrapolated in the future
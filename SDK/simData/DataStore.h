@@ -292,6 +292,41 @@ public:
   /// List of IDs for objects contained by the DataStore
   typedef std::vector<ObjectId> IdList;
 
+  /// Changes consolidated over the time between two calls to update(), each list sorted by ID with no duplicates
+  struct ChangeSet
+  {
+    IdList added;         ///< Entities added that were not removed again
+    IdList removed;       ///< Entities removed that were not added in the same batch
+    IdList prefs;         ///< Entities whose prefs changed; excludes added and removed entities
+    IdList properties;    ///< Entities whose properties changed; excludes added and removed entities
+    IdList names;         ///< Entities whose name or alias changed; excludes added and removed entities
+    IdList categoryData;  ///< Entities whose category data changed; excludes removed entities
+    IdList flushed;       ///< Entities whose data was flushed, with 0 for the whole scenario; excludes removed entities
+    bool scenarioDeleted = false;  ///< True if the scenario was deleted during the batch
+
+    /// Returns true if no entity changed and the scenario was not deleted
+    bool empty() const
+    {
+      return added.empty() && removed.empty() && prefs.empty() && properties.empty() && names.empty() &&
+        categoryData.empty() && flushed.empty() && !scenarioDeleted;
+    }
+  };
+
+  /**
+   * Alternative to Listener for consumers that process changes in bulk.  Instead of one callback
+   * per entity per event, receives one ChangeSet per update(), in place of Listener::onChange().
+   */
+  class BatchListener
+  {
+  public:
+    virtual ~BatchListener() {}
+
+    /// Called by update() with the changes since the previous update(); the change set may be empty if only time changed
+    virtual void onChanges(DataStore* source, const ChangeSet& changes) = 0;
+  };
+  /// Managed pointer for BatchListener
+  typedef std::shared_ptr<BatchListener> BatchListenerPtr;
+
 public: // methods
   virtual ~DataStore();
 
@@ -460,6 +495,20 @@ public: // methods
   /// Retrieve a list of IDs for objects of 'type' with the given name. Does not respect alias.
   virtual void idListByName(const std::string& name, IdList* ids, simData::ObjectType type = simData::ALL) const = 0;
 
+  /// Ways that idListByNameSearch() compares entity names to the search text
+  enum class NameSearch
+  {
+    EXACT,     ///< Name equals the text
+    PREFIX,    ///< Name starts with the text
+    SUBSTRING  ///< Name contains the text
+  };
+
+  /**
+   * Retrieve a list of IDs for objects of 'type' whose name matches the text, in no particular order.  Uses an index
+   * rather than scanning every entity.  When not case sensitive, only ASCII letters are folded.  Does not respect alias.
+   */
+  virtual void idListByNameSearch(const std::string& text, NameSearch search, bool caseSensitive, IdList* ids, simData::ObjectType type = simData::ALL) const = 0;
+
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const = 0;
 
@@ -642,6 +691,24 @@ public: // methods
   //virtual        TableData*        addTableData(ObjectId id, Transaction *transaction) = 0;
   ///@}
 
+  /**@name Add many data updates to one entity at once
+   * The updates may be in any order.  They are sorted once and merged with the entity's existing
+   * updates in a single pass, replacing existing updates with the same time; the last of several
+   * updates with equal times wins.  Data limiting is applied once, and NewUpdatesListeners receive
+   * one onEntityUpdate() with the latest time.  Much faster than one transaction per update when
+   * loading recorded data.
+   * @param id Entity to receive the updates
+   * @param updates Updates to copy into the data store
+   * @return 0 on success, non-zero if the entity does not exist
+   * @{
+   */
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) = 0;
+  virtual int addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates) = 0;
+  virtual int addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates) = 0;
+  virtual int addLaserUpdates(ObjectId id, const std::vector<LaserUpdate>& updates) = 0;
+  virtual int addProjectorUpdates(ObjectId id, const std::vector<ProjectorUpdate>& updates) = 0;
+  ///@}
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
@@ -719,6 +786,14 @@ public: // methods
   virtual void removeNewUpdatesListener(NewUpdatesListenerPtr callback) = 0;
   ///@}
 
+  /**@name BatchListener
+  * @{
+  */
+  /// Add or remove a listener for the change set of each update(); changes are only collected while a batch listener exists
+  virtual void addBatchListener(BatchListenerPtr callback) = 0;
+  virtual void removeBatchListener(BatchListenerPtr callback) = 0;
+  ///@}
+
   /**@name Get a handle to the CategoryNameManager
    * @{
    */
@@ -114,6 +114,16 @@ void DataStoreProxy::removeNewUpdatesListener(DataStore::NewUpdatesListenerPtr c
   dataStore_->removeNewUpdatesListener(callback);
 }
 
+void DataStoreProxy::addBatchListener(DataStore::BatchListenerPtr callback)
+{
+  dataStore_->addBatchListener(callback);
+}
+
+void DataStoreProxy::removeBatchListener(DataStore::BatchListenerPtr callback)
+{
+  dataStore_->removeBatchListener(callback);
+}
+
 void DataStoreProxy::bindToClock(simCore::Clock* clock)
 {
   dataStore_->bindToClock(clock);
@@ -145,6 +145,7 @@ public: // methods
 
   /// Retrieve a list of IDs for objects of 'type' with the given name
   virtual void idListByName(const std::string& name, IdList* ids, simData::ObjectType type = simData::ALL) const override {dataStore_->idListByName(name, ids, type);}
+  virtual void idListByNameSearch(const std::string& text, NameSearch search, bool caseSensitive, IdList* ids, simData::ObjectType type = simData::ALL) const override {dataStore_->idListByNameSearch(text, search, caseSensitive, ids, type);}
 
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const override {dataStore_->idListByOriginalId(ids, originalId, type);}
@@ -306,6 +307,17 @@ public: // methods
   virtual     CategoryData*   addCategoryData(ObjectId id, Transaction *transaction) override {return dataStore_->addCategoryData(id, transaction);}
   ///@}
 
+  /**@name Add many data updates to one entity at once
+   * @see simData::DataStore::addPlatformUpdates()
+   * @{
+   */
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) override { return dataStore_->addPlatformUpdates(id, updates); }
+  virtual int addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates) override { return dataStore_->addBeamUpdates(id, updates); }
+  virtual int addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates) override { return dataStore_->addGateUpdates(id, updates); }
+  virtual int addLaserUpdates(ObjectId id, const std::vector<LaserUpdate>& updates) override { return dataStore_->addLaserUpdates(id, updates); }
+  virtual int addProjectorUpdates(ObjectId id, const std::vector<ProjectorUpdate>& updates) override { return dataStore_->addProjectorUpdates(id, updates); }
+  ///@}
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
@@ -363,6 +375,14 @@ public: // methods
   virtual void removeNewUpdatesListener(NewUpdatesListenerPtr callback) override;
   ///@}
 
+  /**@name BatchListener
+  * @{
+  */
+  /// Add or remove a listener for the change set of each update()
+  virtual void addBatchListener(BatchListenerPtr callback) override;
+  virtual void removeBatchListener(BatchListenerPtr callback) override;
+  ///@}
+
   /**@name Get a handle to the CategoryNameManager
    * @{
    */
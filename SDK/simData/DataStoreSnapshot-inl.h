@@ -0,0 +1,105 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_DATASTORESNAPSHOT_INL_H
+#define SIMDATA_DATASTORESNAPSHOT_INL_H
+
+#include <cassert>
+
+namespace simData
+{
+
+template <typename T>
+size_t SnapshotSlice<T>::size() const
+{
+  return size_;
+}
+
+template <typename T>
+bool SnapshotSlice<T>::empty() const
+{
+  return size_ == 0;
+}
+
+template <typename T>
+const T& SnapshotSlice<T>::operator[](size_t index) const
+{
+  assert(index < size_);
+  // Every chunk but the last is full, so the chunk follows from the index
+  const size_t position = index + offset_;
+  return (*chunks_[position / ChunkSize])[position % ChunkSize];
+}
+
+template <typename T>
+double SnapshotSlice<T>::firstTime() const
+{
+  return empty() ? std::numeric_limits<double>::max() : (*this)[0].time();
+}
+
+template <typename T>
+double SnapshotSlice<T>::lastTime() const
+{
+  return empty() ? -std::numeric_limits<double>::max() : (*this)[size_ - 1].time();
+}
+
+template <typename T>
+size_t SnapshotSlice<T>::lowerBound(double time) const
+{
+  size_t low = 0;
+  size_t high = size_;
+  while (low < high)
+  {
+    const size_t middle = low + (high - low) / 2;
+    if ((*this)[middle].time() < time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+template <typename T>
+size_t SnapshotSlice<T>::upperBound(double time) const
+{
+  size_t low = 0;
+  size_t high = size_;
+  while (low < high)
+  {
+    const size_t middle = low + (high - low) / 2;
+    if ((*this)[middle].time() <= time)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+template <typename T>
+const T* SnapshotSlice<T>::atOrBefore(double time) const
+{
+  const size_t index = upperBound(time);
+  return (index == 0) ? nullptr : &(*this)[index - 1];
+}
+
+}
+
+#endif /* SIMDATA_DATASTORESNAPSHOT_INL_H */
@@ -0,0 +1,642 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include "simData/DataStoreSnapshot.h"
+
+namespace
+{
+
+/// Returns a shared copy of the message, or nullptr if there is none
+template <typename T>
+std::shared_ptr<const google::protobuf::Message> copyMessage(const T* message)
+{
+  if (message == nullptr)
+    return nullptr;
+  return std::make_shared<const T>(*message);
+}
+
+/// Collects the tables of an owner
+class TableCollector : public simData::TableList::Visitor
+{
+public:
+  virtual void visit(simData::DataTable* table) override
+  {
+    tables.push_back(table);
+  }
+
+  std::vector<simData::DataTable*> tables;
+};
+
+/// Collects the columns of a table, and the total number of entries in them
+class ColumnCollector : public simData::DataTable::ColumnVisitor
+{
+public:
+  virtual void visit(simData::TableColumn* column) override
+  {
+    simData::SnapshotTable::Column description;
+    description.id = column->columnId();
+    description.name = column->name();
+    description.type = column->variableType();
+    description.units = column->unitType();
+    columns.push_back(description);
+    entries += column->size();
+  }
+
+  std::vector<simData::SnapshotTable::Column> columns;
+  size_t entries = 0;
+};
+
+}
+
+namespace simData
+{
+
+TableId SnapshotTable::tableId() const
+{
+  return tableId_;
+}
+
+const std::string& SnapshotTable::tableName() const
+{
+  return tableName_;
+}
+
+ObjectId SnapshotTable::ownerId() const
+{
+  return ownerId_;
+}
+
+const std::vector<SnapshotTable::Column>& SnapshotTable::columns() const
+{
+  return columns_;
+}
+
+const SnapshotSlice<TableRow>& SnapshotTable::rows() const
+{
+  return rows_;
+}
+
+//----------------------------------------------------------------------------
+
+DataStoreSnapshot::DataStoreSnapshot()
+{
+}
+
+DataStoreSnapshot::~DataStoreSnapshot()
+{
+}
+
+double DataStoreSnapshot::updateTime() const
+{
+  return updateTime_;
+}
+
+void DataStoreSnapshot::idList(DataStore::IdList* ids, ObjectType type) const
+{
+  if (ids == nullptr)
+    return;
+  for (const auto& [id, entity] : entities_)
+  {
+    if ((entity.type & type) != 0)
+      ids->push_back(id);
+  }
+}
+
+ObjectType DataStoreSnapshot::objectType(ObjectId id) const
+{
+  auto it = entities_.find(id);
+  return (it == entities_.end()) ? NONE : it->second.type;
+}
+
+const ScenarioProperties& DataStoreSnapshot::scenarioProperties() const
+{
+  return *scenarioProperties_;
+}
+
+const PlatformProperties* DataStoreSnapshot::platformProperties(ObjectId id) const
+{
+  return properties_<PlatformProperties>(id, PLATFORM);
+}
+
+const BeamProperties* DataStoreSnapshot::beamProperties(ObjectId id) const
+{
+  return properties_<BeamProperties>(id, BEAM);
+}
+
+const GateProperties* DataStoreSnapshot::gateProperties(ObjectId id) const
+{
+  return properties_<GateProperties>(id, GATE);
+}
+
+const LaserProperties* DataStoreSnapshot::laserProperties(ObjectId id) const
+{
+  return properties_<LaserProperties>(id, LASER);
+}
+
+const ProjectorProperties* DataStoreSnapshot::projectorProperties(ObjectId id) const
+{
+  return properties_<ProjectorProperties>(id, PROJECTOR);
+}
+
+const LobGroupProperties* DataStoreSnapshot::lobGroupProperties(ObjectId id) const
+{
+  return properties_<LobGroupProperties>(id, LOB_GROUP);
+}
+
+const CustomRenderingProperties* DataStoreSnapshot::customRenderingProperties(ObjectId id) const
+{
+  return properties_<CustomRenderingProperties>(id, CUSTOM_RENDERING);
+}
+
+const PlatformPrefs* DataStoreSnapshot::platformPrefs(ObjectId id) const
+{
+  return prefs_<PlatformPrefs>(id, PLATFORM);
+}
+
+const BeamPrefs* DataStoreSnapshot::beamPrefs(ObjectId id) const
+{
+  return prefs_<BeamPrefs>(id, BEAM);
+}
+
+const GatePrefs* DataStoreSnapshot::gatePrefs(ObjectId id) const
+{
+  return prefs_<GatePrefs>(id, GATE);
+}
+
+const LaserPrefs* DataStoreSnapshot::laserPrefs(ObjectId id) const
+{
+  return prefs_<LaserPrefs>(id, LASER);
+}
+
+const ProjectorPrefs* DataStoreSnapshot::projectorPrefs(ObjectId id) const
+{
+  return prefs_<ProjectorPrefs>(id, PROJECTOR);
+}
+
+const LobGroupPrefs* DataStoreSnapshot::lobGroupPrefs(ObjectId id) const
+{
+  return prefs_<LobGroupPrefs>(id, LOB_GROUP);
+}
+
+const CustomRenderingPrefs* DataStoreSnapshot::customRenderingPrefs(ObjectId id) const
+{
+  return prefs_<CustomRenderingPrefs>(id, CUSTOM_RENDERING);
+}
+
+const SnapshotSlice<PlatformUpdate>* DataStoreSnapshot::platformUpdates(ObjectId id) const
+{
+  return updates_<PlatformUpdate>(id, PLATFORM);
+}
+
+const SnapshotSlice<BeamUpdate>* DataStoreSnapshot::beamUpdates(ObjectId id) const
+{
+  return updates_<BeamUpdate>(id, BEAM);
+}
+
+const SnapshotSlice<GateUpdate>* DataStoreSnapshot::gateUpdates(ObjectId id) const
+{
+  return updates_<GateUpdate>(id, GATE);
+}
+
+const SnapshotSlice<LaserUpdate>* DataStoreSnapshot::laserUpdates(ObjectId id) const
+{
+  return updates_<LaserUpdate>(id, LASER);
+}
+
+const SnapshotSlice<ProjectorUpdate>* DataStoreSnapshot::projectorUpdates(ObjectId id) const
+{
+  return updates_<ProjectorUpdate>(id, PROJECTOR);
+}
+
+const SnapshotSlice<LobGroupUpdate>* DataStoreSnapshot::lobGroupUpdates(ObjectId id) const
+{
+  return updates_<LobGroupUpdate>(id, LOB_GROUP);
+}
+
+const SnapshotTable* DataStoreSnapshot::table(TableId id) const
+{
+  auto it = tables_.find(id);
+  return (it == tables_.end()) ? nullptr : it->second.get();
+}
+
+const SnapshotTable* DataStoreSnapshot::findTable(ObjectId ownerId, const std::string& tableName) const
+{
+  for (const auto& [id, table] : tables_)
+  {
+    if (table->ownerId() == ownerId && table->tableName() == tableName)
+      return table.get();
+  }
+  return nullptr;
+}
+
+std::vector<const SnapshotTable*> DataStoreSnapshot::tablesForOwner(ObjectId ownerId) const
+{
+  std::vector<const SnapshotTable*> rv;
+  for (const auto& [id, table] : tables_)
+  {
+    if (table->ownerId() == ownerId)
+      rv.push_back(table.get());
+  }
+  return rv;
+}
+
+const DataStoreSnapshot::Entity* DataStoreSnapshot::entity_(ObjectId id, ObjectType type) const
+{
+  auto it = entities_.find(id);
+  if (it == entities_.end() || it->second.type != type)
+    return nullptr;
+  return &it->second;
+}
+
+template <typename T>
+const T* DataStoreSnapshot::properties_(ObjectId id, ObjectType type) const
+{
+  const Entity* entity = entity_(id, type);
+  return entity ? static_cast<const T*>(entity->properties.get()) : nullptr;
+}
+
+template <typename T>
+const T* DataStoreSnapshot::prefs_(ObjectId id, ObjectType type) const
+{
+  const Entity* entity = entity_(id, type);
+  return entity ? static_cast<const T*>(entity->prefs.get()) : nullptr;
+}
+
+template <typename T>
+const SnapshotSlice<T>* DataStoreSnapshot::updates_(ObjectId id, ObjectType type) const
+{
+  const Entity* entity = entity_(id, type);
+  return entity ? static_cast<const SnapshotSlice<T>*>(entity->updates.get()) : nullptr;
+}
+
+//----------------------------------------------------------------------------
+
+/** Tracks changes to the entities and the set of tables */
+class DataStoreSnapshotBuilder::Listener : public DataStore::DefaultListener, public DataTableManager::ManagerObserver
+{
+public:
+  explicit Listener(DataStoreSnapshotBuilder& builder)
+    : builder_(builder)
+  {
+  }
+
+  virtual void onRemoveEntity(DataStore* source, ObjectId removedId, ObjectType ot) override
+  {
+    builder_.entities_.erase(removedId);
+  }
+
+  virtual void onPrefsChange(DataStore* source, ObjectId id) override
+  {
+    auto it = builder_.entities_.find(id);
+    if (it != builder_.entities_.end())
+      it->second.prefsDirty = true;
+  }
+
+  virtual void onPropertiesChange(DataStore* source, ObjectId id) override
+  {
+    auto it = builder_.entities_.find(id);
+    if (it != builder_.entities_.end())
+      it->second.propertiesDirty = true;
+  }
+
+  virtual void onNameChange(DataStore* source, ObjectId changeId) override
+  {
+    onPrefsChange(source, changeId);
+  }
+
+  virtual void onFlush(DataStore* source, ObjectId flushedId) override
+  {
+    // Flushes are rare and may be recursive, so copy everything again
+    builder_.markAllDirty_();
+  }
+
+  virtual void onScenarioDelete(DataStore* source) override
+  {
+    builder_.entities_.clear();
+  }
+
+  virtual void onAddTable(DataTable* table) override
+  {
+    builder_.addTable_(table);
+  }
+
+  virtual void onPreRemoveTable(DataTable* table) override
+  {
+    builder_.removeTable_(table);
+  }
+
+private:
+  DataStoreSnapshotBuilder& builder_;
+};
+
+/** Marks a table for copying when its rows or columns change */
+class DataStoreSnapshotBuilder::TableListener : public DataTable::TableObserver
+{
+public:
+  explicit TableListener(bool& dirty)
+    : dirty_(dirty)
+  {
+  }
+
+  virtual void onAddColumn(DataTable& table, const TableColumn& column) override
+  {
+    dirty_ = true;
+  }
+
+  virtual void onAddRow(DataTable& table, const TableRow& row) override
+  {
+    dirty_ = true;
+  }
+
+  virtual void onPreRemoveColumn(DataTable& table, const TableColumn& column) override
+  {
+    dirty_ = true;
+  }
+
+  virtual void onPreRemoveRow(DataTable& table, double rowTime) override
+  {
+    dirty_ = true;
+  }
+
+private:
+  bool& dirty_;
+};
+
+DataStoreSnapshotBuilder::DataStoreSnapshotBuilder(DataStore& dataStore)
+  : dataStore_(dataStore),
+    listener_(std::make_shared<Listener>(*this))
+{
+  dataStore_.addListener(listener_);
+  dataStore_.dataTableManager().addObserver(listener_);
+
+  // Track the tables that already exist
+  DataStore::IdList ids;
+  dataStore_.idList(&ids);
+  ids.push_back(0);
+  for (ObjectId id : ids)
+  {
+    const TableList* tables = dataStore_.dataTableManager().tablesForOwner(id);
+    if (tables == nullptr)
+      continue;
+    TableCollector collector;
+    tables->accept(collector);
+    for (DataTable* table : collector.tables)
+      addTable_(table);
+  }
+}
+
+DataStoreSnapshotBuilder::~DataStoreSnapshotBuilder()
+{
+  for (auto& [table, state] : tables_)
+    table->removeObserver(state.listener);
+  dataStore_.dataTableManager().removeObserver(listener_);
+  dataStore_.removeListener(listener_);
+}
+
+void DataStoreSnapshotBuilder::onNewUpdate(ObjectId id, double time)
+{
+  EntityState& state = entities_[id];
+  state.dirtyFrom = std::min(state.dirtyFrom, time);
+}
+
+std::shared_ptr<const DataStoreSnapshot> DataStoreSnapshotBuilder::create()
+{
+  std::shared_ptr<DataStoreSnapshot> rv(new DataStoreSnapshot);
+  rv->updateTime_ = dataStore_.updateTime();
+
+  DataStore::Transaction t;
+  const ScenarioProperties* scenario = dataStore_.scenarioProperties(&t);
+  rv->scenarioProperties_ = scenario ? std::make_shared<const ScenarioProperties>(*scenario) : std::make_shared<const ScenarioProperties>();
+
+  DataStore::IdList ids;
+  dataStore_.idList(&ids);
+  for (ObjectId id : ids)
+  {
+    EntityState& state = entities_[id];
+    const ObjectType type = dataStore_.objectType(id);
+    if (state.entity.type != type)
+    {
+      state = EntityState();
+      state.entity.type = type;
+    }
+
+    DataStoreSnapshot::Entity& entity = state.entity;
+    switch (type)
+    {
+    case PLATFORM:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.platformProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.platformPrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.platformUpdateSlice(id), state.dirtyFrom);
+      break;
+    case BEAM:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.beamProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.beamPrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.beamUpdateSlice(id), state.dirtyFrom);
+      break;
+    case GATE:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.gateProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.gatePrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.gateUpdateSlice(id), state.dirtyFrom);
+      break;
+    case LASER:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.laserProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.laserPrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.laserUpdateSlice(id), state.dirtyFrom);
+      break;
+    case PROJECTOR:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.projectorProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.projectorPrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.projectorUpdateSlice(id), state.dirtyFrom);
+      break;
+    case LOB_GROUP:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.lobGroupProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.lobGroupPrefs(id, &t));
+      entity.updates = copySlice_(entity.updates, dataStore_.lobGroupUpdateSlice(id), state.dirtyFrom);
+      break;
+    case CUSTOM_RENDERING:
+      if (state.propertiesDirty)
+        entity.properties = copyMessage(dataStore_.customRenderingProperties(id, &t));
+      if (state.prefsDirty)
+        entity.prefs = copyMessage(dataStore_.customRenderingPrefs(id, &t));
+      break;
+    case NONE:
+    case ALL:
+      continue;
+    }
+
+    state.propertiesDirty = false;
+    state.prefsDirty = false;
+    state.dirtyFrom = std::numeric_limits<double>::max();
+    rv->entities_.emplace(id, entity);
+  }
+
+  for (auto& [table, state] : tables_)
+  {
+    updateTable_(table, state);
+    rv->tables_[state.table->tableId()] = state.table;
+  }
+
+  return rv;
+}
+
+void DataStoreSnapshotBuilder::addTable_(DataTable* table)
+{
+  TableState& state = tables_[table];
+  state.dirty = true;
+  if (!state.listener)
+  {
+    state.listener = std::make_shared<TableListener>(state.dirty);
+    table->addObserver(state.listener);
+  }
+}
+
+void DataStoreSnapshotBuilder::removeTable_(DataTable* table)
+{
+  auto it = tables_.find(table);
+  if (it == tables_.end())
+    return;
+  table->removeObserver(it->second.listener);
+  tables_.erase(it);
+}
+
+void DataStoreSnapshotBuilder::markAllDirty_()
+{
+  for (auto& [id, state] : entities_)
+  {
+    state.propertiesDirty = true;
+    state.prefsDirty = true;
+    state.dirtyFrom = -std::numeric_limits<double>::max();
+  }
+  for (auto& [table, state] : tables_)
+    state.dirty = true;
+}
+
+void DataStoreSnapshotBuilder::updateTable_(DataTable* table, TableState& state) const
+{
+  // Data limiting removes rows without notification, but changes the column sizes
+  ColumnCollector columns;
+  table->accept(columns);
+  if (state.table && !state.dirty && (columns.entries == state.entries))
+    return;
+
+  auto copy = std::make_shared<SnapshotTable>();
+  copy->tableId_ = table->tableId();
+  copy->tableName_ = table->tableName();
+  copy->ownerId_ = table->ownerId();
+  copy->columns_ = std::move(columns.columns);
+
+  class RowCopier : public DataTable::RowVisitor
+  {
+  public:
+    explicit RowCopier(SnapshotSlice<TableRow>& rows)
+      : rows_(rows)
+    {
+    }
+
+    virtual VisitReturn visit(const TableRow& row) override
+    {
+      DataStoreSnapshotBuilder::append_(rows_, chunk_, row);
+      return VISIT_CONTINUE;
+    }
+
+  private:
+    SnapshotSlice<TableRow>& rows_;
+    std::shared_ptr<std::vector<TableRow> > chunk_;
+  };
+  RowCopier copier(copy->rows_);
+  table->accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), copier);
+
+  state.table = copy;
+  state.entries = columns.entries;
+  state.dirty = false;
+}
+
+template <typename T>
+std::shared_ptr<const void> DataStoreSnapshotBuilder::copySlice_(const std::shared_ptr<const void>& previous, const DataSlice<T>* slice, double dirtyFrom)
+{
+  const auto* last = static_cast<const SnapshotSlice<T>*>(previous.get());
+  const size_t numItems = (slice == nullptr) ? 0 : slice->numItems();
+
+  // Nothing added, replaced or removed by data limiting
+  if (last && (dirtyFrom == std::numeric_limits<double>::max()) && (last->size() == numItems))
+    return previous;
+
+  auto rv = std::make_shared<SnapshotSlice<T> >();
+  if (numItems == 0)
+    return rv;
+
+  if (last && !last->empty())
+  {
+    // Data limiting removes the oldest updates, so skip copies of updates before the first
+    const size_t start = last->lowerBound(slice->firstTime());
+    const size_t dirty = last->lowerBound(dirtyFrom);
+    // Share the full chunks that only hold unchanged updates
+    const size_t constexpr chunkSize = SnapshotSlice<T>::ChunkSize;
+    const size_t firstChunk = (last->offset_ + start) / chunkSize;
+    const size_t endChunk = (last->offset_ + dirty) / chunkSize;
+    if (firstChunk < endChunk)
+    {
+      rv->chunks_.assign(last->chunks_.begin() + firstChunk, last->chunks_.begin() + endChunk);
+      rv->offset_ = last->offset_ + start - firstChunk * chunkSize;
+      rv->size_ = endChunk * chunkSize - last->offset_ - start;
+    }
+  }
+
+  // Copy the rest from the slice
+  typename DataSlice<T>::Iterator it = rv->empty() ? slice->lower_bound(-std::numeric_limits<double>::max()) : slice->upper_bound(rv->lastTime());
+  std::shared_ptr<std::vector<T> > chunk;
+  while (it.hasNext())
+    append_(*rv, chunk, *it.next());
+
+  // Sharing assumes only data limiting removes updates without notice; copy everything if that was wrong
+  if (last && (rv->size() != numItems))
+    return copySlice_<T>(nullptr, slice, dirtyFrom);
+  return rv;
+}
+
+template <typename T>
+void DataStoreSnapshotBuilder::append_(SnapshotSlice<T>& slice, std::shared_ptr<std::vector<T> >& chunk, const T& item)
+{
+  if (!chunk || chunk->size() == SnapshotSlice<T>::ChunkSize)
+  {
+    chunk = std::make_shared<std::vector<T> >();
+    chunk->reserve(SnapshotSlice<T>::ChunkSize);
+    slice.chunks_.push_back(chunk);
+  }
+  chunk->push_back(item);
+  ++slice.size_;
+}
+
+}
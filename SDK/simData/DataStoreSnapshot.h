@@ -0,0 +1,289 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_DATASTORESNAPSHOT_H
+#define SIMDATA_DATASTORESNAPSHOT_H
+
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/DataStore.h"
+#include "simData/DataTable.h"
+
+namespace google { namespace protobuf { class Message; } }
+
+namespace simData
+{
+
+class DataStoreSnapshotBuilder;
+
+/**
+ * Immutable, time ordered copy of the updates in one slice of a DataStoreSnapshot.  The updates
+ * are held in fixed size chunks; later snapshots share every chunk whose updates did not change,
+ * so taking a snapshot of a growing slice only copies the newest updates.
+ */
+template <typename T>
+class SnapshotSlice
+{
+public:
+  /// Number of updates in each chunk; only the last chunk may hold fewer
+  static constexpr size_t ChunkSize = 256;
+
+  /// Returns the number of updates
+  size_t size() const;
+  /// Returns true if there are no updates
+  bool empty() const;
+  /// Returns the update at the index, which must be less than size()
+  const T& operator[](size_t index) const;
+  /// Time of the first update, or std::numeric_limits<double>::max() if empty, matching DataSlice
+  double firstTime() const;
+  /// Time of the last update, or -std::numeric_limits<double>::max() if empty, matching DataSlice
+  double lastTime() const;
+  /// Returns the index of the first update at or after the time, or size() if there is none
+  size_t lowerBound(double time) const;
+  /// Returns the index of the first update after the time, or size() if there is none
+  size_t upperBound(double time) const;
+  /// Returns the last update at or before the time, or nullptr if there is none
+  const T* atOrBefore(double time) const;
+
+private:
+  friend class DataStoreSnapshotBuilder;
+
+  typedef std::vector<T> Chunk;
+  std::vector<std::shared_ptr<const Chunk> > chunks_;
+  /// Updates at the front of the first chunk that were removed by data limiting
+  size_t offset_ = 0;
+  size_t size_ = 0;
+};
+
+/** Immutable copy of a DataTable in a DataStoreSnapshot */
+class SDKDATA_EXPORT SnapshotTable
+{
+public:
+  /// Description of one column
+  struct Column
+  {
+    TableColumnId id = 0;          ///< Column ID, matching the DataTable
+    std::string name;              ///< Column name
+    VariableType type = VT_DOUBLE; ///< Storage type of the values
+    UnitType units = 0;            ///< Units of the values
+  };
+
+  /// Table ID, matching the DataTable
+  TableId tableId() const;
+  /// Name of the table
+  const std::string& tableName() const;
+  /// Entity that owns the table; 0 for the scenario
+  ObjectId ownerId() const;
+  /// Columns, in the order of the DataTable
+  const std::vector<Column>& columns() const;
+  /// Rows, in time order
+  const SnapshotSlice<TableRow>& rows() const;
+
+private:
+  friend class DataStoreSnapshotBuilder;
+
+  TableId tableId_ = 0;
+  std::string tableName_;
+  ObjectId ownerId_ = 0;
+  std::vector<Column> columns_;
+  SnapshotSlice<TableRow> rows_;
+};
+
+/**
+ * Immutable, consistent view of the entities, properties, prefs, update slices and data tables of
+ * a DataStore at one point in time.  A snapshot owns or shares everything it refers to, so it may be
+ * read from any thread, and kept for any length of time, while the DataStore continues to update,
+ * limit and flush its data.  Create snapshots with MemoryDataStore::createSnapshot().
+ */
+class SDKDATA_EXPORT DataStoreSnapshot
+{
+public:
+  virtual ~DataStoreSnapshot();
+
+  SDK_DISABLE_COPY_MOVE(DataStoreSnapshot);
+
+  /// Time of the last DataStore::update() before the snapshot was taken
+  double updateTime() const;
+
+  /// Retrieves the IDs of the entities of the given type
+  void idList(DataStore::IdList* ids, ObjectType type = ALL) const;
+  /// Returns the type of the entity, or NONE if the entity was not in the data store
+  ObjectType objectType(ObjectId id) const;
+
+  /// Scenario properties
+  const ScenarioProperties& scenarioProperties() const;
+
+  /**@name Properties; nullptr if the entity is not of the type
+   * @{
+   */
+  const PlatformProperties* platformProperties(ObjectId id) const;
+  const BeamProperties* beamProperties(ObjectId id) const;
+  const GateProperties* gateProperties(ObjectId id) const;
+  const LaserProperties* laserProperties(ObjectId id) const;
+  const ProjectorProperties* projectorProperties(ObjectId id) const;
+  const LobGroupProperties* lobGroupProperties(ObjectId id) const;
+  const CustomRenderingProperties* customRenderingProperties(ObjectId id) const;
+  ///@}
+
+  /**@name Prefs; nullptr if the entity is not of the type
+   * @{
+   */
+  const PlatformPrefs* platformPrefs(ObjectId id) const;
+  const BeamPrefs* beamPrefs(ObjectId id) const;
+  const GatePrefs* gatePrefs(ObjectId id) const;
+  const LaserPrefs* laserPrefs(ObjectId id) const;
+  const ProjectorPrefs* projectorPrefs(ObjectId id) const;
+  const LobGroupPrefs* lobGroupPrefs(ObjectId id) const;
+  const CustomRenderingPrefs* customRenderingPrefs(ObjectId id) const;
+  ///@}
+
+  /**@name Updates; nullptr if the entity is not of the type
+   * @{
+   */
+  const SnapshotSlice<PlatformUpdate>* platformUpdates(ObjectId id) const;
+  const SnapshotSlice<BeamUpdate>* beamUpdates(ObjectId id) const;
+  const SnapshotSlice<GateUpdate>* gateUpdates(ObjectId id) const;
+  const SnapshotSlice<LaserUpdate>* laserUpdates(ObjectId id) const;
+  const SnapshotSlice<ProjectorUpdate>* projectorUpdates(ObjectId id) const;
+  const SnapshotSlice<LobGroupUpdate>* lobGroupUpdates(ObjectId id) const;
+  ///@}
+
+  /**@name Data tables
+   * @{
+   */
+  /// Returns the table with the ID, or nullptr if there is none
+  const SnapshotTable* table(TableId id) const;
+  /// Returns the owner's table with the name, or nullptr if there is none
+  const SnapshotTable* findTable(ObjectId ownerId, const std::string& tableName) const;
+  /// Returns the tables of the owner; 0 for the scenario
+  std::vector<const SnapshotTable*> tablesForOwner(ObjectId ownerId) const;
+  ///@}
+
+private:
+  friend class DataStoreSnapshotBuilder;
+  DataStoreSnapshot();
+
+  /// Copies of the settings and updates of one entity, shared with other snapshots until they change
+  struct Entity
+  {
+    ObjectType type = NONE;
+    std::shared_ptr<const google::protobuf::Message> properties;
+    std::shared_ptr<const google::protobuf::Message> prefs;
+    /// SnapshotSlice of the entity's update type; nullptr for custom renderings
+    std::shared_ptr<const void> updates;
+  };
+
+  /// Returns the entity if it is of the type, nullptr otherwise
+  const Entity* entity_(ObjectId id, ObjectType type) const;
+  /// Returns the properties of the entity if it is of the type
+  template <typename T>
+  const T* properties_(ObjectId id, ObjectType type) const;
+  /// Returns the prefs of the entity if it is of the type
+  template <typename T>
+  const T* prefs_(ObjectId id, ObjectType type) const;
+  /// Returns the updates of the entity if it is of the type
+  template <typename T>
+  const SnapshotSlice<T>* updates_(ObjectId id, ObjectType type) const;
+
+  double updateTime_ = 0.0;
+  std::shared_ptr<const ScenarioProperties> scenarioProperties_;
+  std::map<ObjectId, Entity> entities_;
+  std::map<TableId, std::shared_ptr<const SnapshotTable> > tables_;
+};
+
+/**
+ * Creates DataStoreSnapshots of a DataStore, sharing the copies of everything that did not change
+ * since the previous snapshot.  Listens to the data store for changes to entities, properties,
+ * prefs and tables; the owner of the builder must also pass the time of every new update to
+ * onNewUpdate(), since the NewUpdatesListener only reports the latest time of a batch.  Updates
+ * removed from the front of a slice by data limiting are detected without notification.  Must be
+ * used from the thread that modifies the data store.
+ */
+class SDKDATA_EXPORT DataStoreSnapshotBuilder
+{
+public:
+  explicit DataStoreSnapshotBuilder(DataStore& dataStore);
+  virtual ~DataStoreSnapshotBuilder();
+
+  SDK_DISABLE_COPY_MOVE(DataStoreSnapshotBuilder);
+
+  /// Records that an update at the time was added to the entity, replacing copies of any later updates in the next snapshot
+  void onNewUpdate(ObjectId id, double time);
+  /// Creates a snapshot of the current contents of the data store
+  std::shared_ptr<const DataStoreSnapshot> create();
+
+private:
+  class Listener;
+  class TableListener;
+
+  /// Copies of one entity and what changed since they were made
+  struct EntityState
+  {
+    DataStoreSnapshot::Entity entity;
+    bool propertiesDirty = true;
+    bool prefsDirty = true;
+    /// Updates at or after this time may have changed since the last snapshot
+    double dirtyFrom = -std::numeric_limits<double>::max();
+  };
+
+  /// Copy of one table and what changed since it was made
+  struct TableState
+  {
+    std::shared_ptr<const SnapshotTable> table;
+    std::shared_ptr<TableListener> listener;
+    bool dirty = true;
+    /// Sum of the column sizes when copied, which detects rows removed without notification
+    size_t entries = 0;
+  };
+
+  /// Starts tracking a table
+  void addTable_(DataTable* table);
+  /// Stops tracking a table
+  void removeTable_(DataTable* table);
+  /// Marks all entities and tables for copying
+  void markAllDirty_();
+  /// Copies the table if it changed
+  void updateTable_(DataTable* table, TableState& state) const;
+
+  /// Returns the slice copy, sharing the unchanged chunks of the previous copy
+  template <typename T>
+  static std::shared_ptr<const void> copySlice_(const std::shared_ptr<const void>& previous, const DataSlice<T>* slice, double dirtyFrom);
+  /// Appends an item to the slice, starting a new chunk when the last one is full
+  template <typename T>
+  static void append_(SnapshotSlice<T>& slice, std::shared_ptr<std::vector<T> >& chunk, const T& item);
+
+  DataStore& dataStore_;
+  /// Listens to the data store and its table manager
+  std::shared_ptr<Listener> listener_;
+  std::map<ObjectId, EntityState> entities_;
+  std::map<DataTable*, TableState> tables_;
+};
+
+}
+
+#include "simData/DataStoreSnapshot-inl.h"
+
+#endif /* SIMDATA_DATASTORESNAPSHOT_H */
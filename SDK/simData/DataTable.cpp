@@ -345,4 +345,130 @@ void TableRow::accept(TableRow::CellVisitor& visitor) const
 
 ////////////////////////////////////////////////////////////////////////
 
+double TableColumnAggregate::mean() const
+{
+  return (count == 0) ? 0.0 : (sum / count);
+}
+
+void TableColumnAggregate::append(const TableColumnAggregate& later)
+{
+  if (later.count == 0)
+    return;
+  if (count == 0)
+  {
+    *this = later;
+    return;
+  }
+  count += later.count;
+  // Ties keep the earlier value
+  if (later.min < min)
+  {
+    min = later.min;
+    minTime = later.minTime;
+  }
+  if (later.max > max)
+  {
+    max = later.max;
+    maxTime = later.maxTime;
+  }
+  sum += later.sum;
+  lastTime = later.lastTime;
+  lastValue = later.lastValue;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+TableColumnChunk::TableColumnChunk()
+{
+}
+
+TableColumnChunk::~TableColumnChunk()
+{
+}
+
+const std::vector<double>& TableColumnChunk::times() const
+{
+  return times_;
+}
+
+size_t TableColumnChunk::rowCount() const
+{
+  return times_.size();
+}
+
+size_t TableColumnChunk::columnCount() const
+{
+  return columns_.size();
+}
+
+TableColumnId TableColumnChunk::columnId(size_t column) const
+{
+  return columns_[column].id;
+}
+
+VariableType TableColumnChunk::variableType(size_t column) const
+{
+  return columns_[column].type;
+}
+
+bool TableColumnChunk::isNull(size_t column, size_t row) const
+{
+  return (columns_[column].nulls[row / 64] & (uint64_t(1) << (row % 64))) != 0;
+}
+
+const std::vector<uint64_t>& TableColumnChunk::nullBitmap(size_t column) const
+{
+  return columns_[column].nulls;
+}
+
+size_t TableColumnChunk::nullCount(size_t column) const
+{
+  return columns_[column].nullCount;
+}
+
+void TableColumnChunk::reset(std::vector<double>&& times)
+{
+  times_ = std::move(times);
+  columns_.clear();
+}
+
+size_t TableColumnChunk::addColumn(TableColumnId columnId, VariableType storageType)
+{
+  const size_t rows = times_.size();
+  Column column;
+  column.id = columnId;
+  column.type = storageType;
+  switch (storageType)
+  {
+  case VT_UINT8: column.values = std::vector<uint8_t>(rows); break;
+  case VT_INT8: column.values = std::vector<int8_t>(rows); break;
+  case VT_UINT16: column.values = std::vector<uint16_t>(rows); break;
+  case VT_INT16: column.values = std::vector<int16_t>(rows); break;
+  case VT_UINT32: column.values = std::vector<uint32_t>(rows); break;
+  case VT_INT32: column.values = std::vector<int32_t>(rows); break;
+  case VT_UINT64: column.values = std::vector<uint64_t>(rows); break;
+  case VT_INT64: column.values = std::vector<int64_t>(rows); break;
+  case VT_FLOAT: column.values = std::vector<float>(rows); break;
+  case VT_DOUBLE: column.values = std::vector<double>(rows); break;
+  case VT_STRING: column.values = std::vector<std::string>(rows); break;
+  }
+  // Every row starts out null; clear the unused bits past the last row
+  column.nulls.assign((rows + 63) / 64, ~uint64_t(0));
+  if (rows % 64 != 0)
+    column.nulls.back() = (uint64_t(1) << (rows % 64)) - 1;
+  column.nullCount = rows;
+  columns_.push_back(std::move(column));
+  return columns_.size() - 1;
+}
+
+void TableColumnChunk::setNotNull(size_t column, size_t row)
+{
+  Column& col = columns_[column];
+  const uint64_t bit = uint64_t(1) << (row % 64);
+  if ((col.nulls[row / 64] & bit) == 0)
+    return;
+  col.nulls[row / 64] &= ~bit;
+  --col.nullCount;
+}
+
 }
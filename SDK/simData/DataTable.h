@@ -28,6 +28,7 @@
 #include <vector>
 #include <deque>
 #include <utility>
+#include <variant>
 #include "simCore/Common/Common.h"
 #include "simData/GenericIterator.h"
 #include "simData/ObjectId.h"
@@ -68,6 +69,8 @@ class DataTable;
 class TableColumn;
 class TableRow;
 class TableList;
+class TableColumnChunk;
+struct TableColumnAggregate;
 
 /// Column IDs are 64 bit integers; TODO should this be unsigned? 32 bits?
 typedef int64_t TableColumnId;
@@ -419,6 +422,19 @@ public:
    */
   virtual void accept(ColumnVisitor& visitor) const = 0;
 
+  /**
+   * Copies the values of the columns in the time range into contiguous arrays of their storage
+   * types, one entry per row, without the per-cell calls of the row visitor.  The rows are those
+   * after beginTime (inclusive) until endTime (exclusive) that have a value in at least one of
+   * the columns; rows in which a column has no value are marked in its null bitmap.
+   * @param beginTime Inclusive start of the time range.
+   * @param endTime Exclusive end of the time range.
+   * @param columnIds Columns to read; the chunk holds them in the same order.
+   * @param chunk Receives the times and values, replacing its contents.
+   * @return Error if a column does not exist in this table, in which case the chunk is empty.
+   */
+  virtual TableStatus readColumns(double beginTime, double endTime, const std::vector<TableColumnId>& columnIds, TableColumnChunk& chunk) const = 0;
+
   /**
    * Adds a data table row to the table.
    * @param row Row to add to the table.
@@ -663,6 +679,77 @@ public:
    */
   virtual int getTimeRange(double& begin, double& end) const = 0;
   /// @}
+
+  /**
+   * Copies the column's entries after beginTime (inclusive) until endTime (exclusive) into
+   * contiguous arrays, converting the values to double as getValue() does.  Replaces the
+   * contents of the arrays.  Much faster than iteration for scanning a range of a column.
+   * @param beginTime Inclusive start of the time range.
+   * @param endTime Exclusive end of the time range.
+   * @param times Receives the times of the entries, in increasing order.
+   * @param values Receives the values of the entries, one for each time.
+   */
+  virtual void values(double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values) const = 0;
+
+  /**
+   * Computes the count, min and max with their times, sum and first and last values of the
+   * entries after beginTime (inclusive) until endTime (exclusive), with values converted to
+   * double.  Implementations may keep summaries of older entries so that repeated queries on a
+   * growing column do not rescan its history.
+   * @param beginTime Inclusive start of the time range.
+   * @param endTime Exclusive end of the time range.
+   * @param aggregate Receives the aggregate; count is 0 if there are no entries in the range.
+   * @return Error if the column holds strings.
+   */
+  virtual TableStatus aggregate(double beginTime, double endTime, TableColumnAggregate& aggregate) const = 0;
+
+  /**
+   * Divides the time range into equal buckets and computes the aggregate of each, e.g. for
+   * drawing the min/max envelope of a downsampled plot.
+   * @param beginTime Inclusive start of the time range.
+   * @param endTime Exclusive end of the time range.
+   * @param numBuckets Number of buckets.
+   * @param buckets Receives numBuckets aggregates, in time order.
+   * @return Error if the column holds strings, or if the time range or number of buckets is empty.
+   */
+  virtual TableStatus aggregate(double beginTime, double endTime, size_t numBuckets, std::vector<TableColumnAggregate>& buckets) const = 0;
+
+  /**
+   * Retrieves at most maxPoints representative entries after beginTime (inclusive) until endTime
+   * (exclusive), for drawing a long column at screen resolution.  If the range holds no more than
+   * maxPoints entries, all of them are returned.  Otherwise the range is split into maxPoints / 4
+   * equal buckets and the first, last, smallest and largest entry of each bucket is returned, so a
+   * line plot drawn with maxPoints of 4 times its pixel width looks the same as one drawn with
+   * every entry.  Implementations may keep a min/max pyramid so the cost depends on maxPoints
+   * rather than on the number of entries in the range.
+   * @param beginTime Inclusive start of the time range.
+   * @param endTime Exclusive end of the time range.
+   * @param maxPoints Maximum number of entries to return; at least 4.
+   * @param times Receives the times of the entries, in increasing order.
+   * @param values Receives the values of the entries converted to double, one for each time.
+   * @return Error if the column holds strings or maxPoints is less than 4.
+   */
+  virtual TableStatus decimate(double beginTime, double endTime, size_t maxPoints, std::vector<double>& times, std::vector<double>& values) const = 0;
+};
+
+/** Aggregate of the values of a table column over a time range, from TableColumn::aggregate() */
+struct SDKDATA_EXPORT TableColumnAggregate
+{
+  size_t count = 0;        ///< Number of values
+  double min = 0.0;        ///< Smallest value; 0 if count is 0
+  double max = 0.0;        ///< Largest value; 0 if count is 0
+  double minTime = 0.0;    ///< Time of the first smallest value; 0 if count is 0
+  double maxTime = 0.0;    ///< Time of the first largest value; 0 if count is 0
+  double sum = 0.0;        ///< Sum of the values
+  double firstTime = 0.0;  ///< Time of the first value; 0 if count is 0
+  double firstValue = 0.0; ///< First value in time; 0 if count is 0
+  double lastTime = 0.0;   ///< Time of the last value; 0 if count is 0
+  double lastValue = 0.0;  ///< Last value in time; 0 if count is 0
+
+  /** Mean of the values; 0 if count is 0 */
+  double mean() const;
+  /** Combines with the aggregate of values that are all later in time */
+  void append(const TableColumnAggregate& later);
 };
 
 /// Forward declare a cell class to be used internally by TableRow
@@ -815,6 +902,91 @@ private:
   TableCell* findCell_(TableColumnId id) const;
 };
 
+/**
+ * Values of columns of a data table over a time range, as returned by DataTable::readColumns().
+ * Each column's values are held in one contiguous array of the column's storage type with an
+ * entry for every row, so that they can be scanned or vectorized without a call per cell.  Rows
+ * in which a column has no value hold a default value (0 or empty) and are marked in the column's
+ * null bitmap.
+ */
+class SDKDATA_EXPORT TableColumnChunk
+{
+public:
+  TableColumnChunk();
+  virtual ~TableColumnChunk();
+
+  /** Times of the rows, in increasing order */
+  const std::vector<double>& times() const;
+  /** Number of rows */
+  size_t rowCount() const;
+  /** Number of columns */
+  size_t columnCount() const;
+  /** Retrieves the ID of the column at the index */
+  TableColumnId columnId(size_t column) const;
+  /** Retrieves the storage type of the column at the index */
+  VariableType variableType(size_t column) const;
+
+  /** Returns true if T is the storage type of the column at the index, e.g. hasType<float>() for a VT_FLOAT column */
+  template <typename T>
+  bool hasType(size_t column) const
+  {
+    return std::holds_alternative<std::vector<T> >(columns_[column].values);
+  }
+
+  /**
+   * Retrieves the values of the column at the index, one for each row.
+   * @return Pointer to rowCount() values, or nullptr if hasType<T>() is false.  The pointer may
+   *   also be nullptr when rowCount() is 0, so check hasType<T>() to tell the two apart.
+   */
+  template <typename T>
+  const T* values(size_t column) const
+  {
+    const std::vector<T>* rv = std::get_if<std::vector<T> >(&columns_[column].values);
+    return (rv == nullptr) ? nullptr : rv->data();
+  }
+
+  /** Returns true if the column at the index has no value in the row */
+  bool isNull(size_t column, size_t row) const;
+  /** Null bitmap of the column at the index; bit (row % 64) of word (row / 64) is set if the row has no value */
+  const std::vector<uint64_t>& nullBitmap(size_t column) const;
+  /** Number of rows in which the column at the index has no value */
+  size_t nullCount(size_t column) const;
+
+  /**@name Used by DataTable implementations to fill the chunk
+   * @{
+   */
+  /** Removes all columns and sets the row times */
+  void reset(std::vector<double>&& times);
+  /** Adds a column in which every row is null, returning its index */
+  size_t addColumn(TableColumnId columnId, VariableType storageType);
+  /** Retrieves the values of the column for writing; as values(), nullptr if hasType<T>() is false or there are no rows */
+  template <typename T>
+  T* mutableValues(size_t column)
+  {
+    std::vector<T>* rv = std::get_if<std::vector<T> >(&columns_[column].values);
+    return (rv == nullptr) ? nullptr : rv->data();
+  }
+  /** Marks the row of the column at the index as having a value */
+  void setNotNull(size_t column, size_t row);
+  ///@}
+
+private:
+  /** Values and null bitmap of one column */
+  struct Column
+  {
+    TableColumnId id = 0;
+    VariableType type = VT_DOUBLE;
+    std::variant<std::vector<uint8_t>, std::vector<int8_t>, std::vector<uint16_t>, std::vector<int16_t>,
+      std::vector<uint32_t>, std::vector<int32_t>, std::vector<uint64_t>, std::vector<int64_t>,
+      std::vector<float>, std::vector<double>, std::vector<std::string> > values;
+    std::vector<uint64_t> nulls;
+    size_t nullCount = 0;
+  };
+
+  std::vector<double> times_;
+  std::vector<Column> columns_;
+};
+
 
 }
 
@@ -0,0 +1,292 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_DECIMATIONPYRAMID_INL_H
+#define SIMDATA_DECIMATIONPYRAMID_INL_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace simData
+{
+
+template <size_t Channels>
+void DecimationPyramid<Channels>::Extent::append(const Extent& later)
+{
+  if (later.count == 0)
+    return;
+  if (count == 0)
+  {
+    *this = later;
+    return;
+  }
+  count += later.count;
+  lastTime = later.lastTime;
+  last = later.last;
+  for (size_t c = 0; c < Channels; ++c)
+  {
+    // Ties keep the earlier point
+    if (later.min[c] < min[c])
+    {
+      min[c] = later.min[c];
+      minTime[c] = later.minTime[c];
+    }
+    if (later.max[c] > max[c])
+    {
+      max[c] = later.max[c];
+      maxTime[c] = later.maxTime[c];
+    }
+    sum[c] += later.sum[c];
+  }
+}
+
+template <size_t Channels>
+DecimationPyramid<Channels>::DecimationPyramid()
+{
+}
+
+template <size_t Channels>
+template <typename Reader>
+void DecimationPyramid<Channels>::extent(const Reader& reader, double beginTime, double endTime, Extent& extent) const
+{
+  extent = Extent();
+  if (!(endTime > beginTime))
+    return;
+  extend_(reader);
+  accumulate_(reader, levels_.size(), beginTime, endTime, extent);
+}
+
+template <size_t Channels>
+template <typename Reader>
+void DecimationPyramid<Channels>::decimate(const Reader& reader, double beginTime, double endTime, size_t maxPoints, std::vector<double>& times) const
+{
+  times.clear();
+  if (maxPoints == 0 || !(endTime > beginTime))
+    return;
+
+  Extent bucket;
+  extent(reader, beginTime, endTime, bucket);
+  if (bucket.count <= maxPoints)
+  {
+    reader(beginTime, endTime, times, values_);
+    return;
+  }
+
+  const size_t numBuckets = std::max<size_t>(1, maxPoints / PointsPerBucket);
+  const double width = (endTime - beginTime) / numBuckets;
+  times.reserve(numBuckets * PointsPerBucket);
+  std::array<double, PointsPerBucket> candidates;
+  for (size_t k = 0; k < numBuckets; ++k)
+  {
+    const double bucketEnd = (k + 1 == numBuckets) ? endTime : (beginTime + (k + 1) * width);
+    bucket = Extent();
+    accumulate_(reader, levels_.size(), beginTime + k * width, bucketEnd, bucket);
+    if (bucket.count == 0)
+      continue;
+
+    size_t numCandidates = 0;
+    candidates[numCandidates++] = bucket.firstTime;
+    candidates[numCandidates++] = bucket.lastTime;
+    for (size_t c = 0; c < Channels; ++c)
+    {
+      candidates[numCandidates++] = bucket.minTime[c];
+      candidates[numCandidates++] = bucket.maxTime[c];
+    }
+    std::sort(candidates.begin(), candidates.end());
+    times.insert(times.end(), candidates.begin(), std::unique(candidates.begin(), candidates.end()));
+  }
+}
+
+template <size_t Channels>
+void DecimationPyramid<Channels>::changed(double time)
+{
+  for (Level& level : levels_)
+  {
+    // Changes before the first summary or after the last do not affect them; appends are the common case
+    if (level.empty() || time < level.front().extent.firstTime || time > level.back().extent.lastTime)
+      continue;
+    // Summaries hold a fixed number of points, so every summary from the change on is stale
+    auto first = std::lower_bound(level.begin(), level.end(), time,
+      [](const Summary& summary, double t) { return summary.extent.lastTime < t; });
+    level.erase(first, level.end());
+  }
+}
+
+template <size_t Channels>
+void DecimationPyramid<Channels>::removed(double beginTime, double endTime)
+{
+  for (Level& level : levels_)
+  {
+    auto first = std::lower_bound(level.begin(), level.end(), beginTime,
+      [](const Summary& summary, double time) { return summary.extent.lastTime < time; });
+    auto last = first;
+    while (last != level.end() && last->extent.firstTime <= endTime)
+      ++last;
+    if (first == last)
+      continue;
+    last = level.erase(first, last);
+    if (last != level.end())
+      last->followsPrevious = false;
+  }
+}
+
+template <size_t Channels>
+void DecimationPyramid<Channels>::clear()
+{
+  levels_.clear();
+}
+
+template <size_t Channels>
+size_t DecimationPyramid<Channels>::numLevels() const
+{
+  return levels_.size();
+}
+
+template <size_t Channels>
+template <typename Reader>
+void DecimationPyramid<Channels>::extend_(const Reader& reader) const
+{
+  // Level 0 summarizes the full blocks of points after its last summary
+  if (levels_.empty())
+    levels_.emplace_back();
+  Level& blocks = levels_.front();
+  const double from = blocks.empty() ? -std::numeric_limits<double>::max() :
+    std::nextafter(blocks.back().extent.lastTime, std::numeric_limits<double>::max());
+  reader(from, std::numeric_limits<double>::max(), times_, values_);
+  for (size_t start = 0; start + BlockSize <= times_.size(); start += BlockSize)
+  {
+    Summary summary;
+    summary.followsPrevious = !blocks.empty();
+    scan_(&times_[start], &values_[start * Channels], BlockSize, summary.extent);
+    blocks.push_back(summary);
+  }
+
+  // Each higher level summarizes runs of Fanout summaries of the level below with no points between them
+  for (size_t level = 1; levels_[level - 1].size() >= Fanout; ++level)
+  {
+    if (levels_.size() == level)
+      levels_.emplace_back();
+    const Level& children = levels_[level - 1];
+    Level& parents = levels_[level];
+    size_t start = 0;
+    if (!parents.empty())
+    {
+      start = std::upper_bound(children.begin(), children.end(), parents.back().extent.lastTime,
+        [](double time, const Summary& summary) { return time < summary.extent.firstTime; }) - children.begin();
+    }
+    while (start + Fanout <= children.size())
+    {
+      size_t gap = start + 1;
+      while (gap < start + Fanout && children[gap].followsPrevious)
+        ++gap;
+      if (gap < start + Fanout)
+      {
+        start = gap;
+        continue;
+      }
+
+      Summary summary;
+      summary.followsPrevious = !parents.empty() && start > 0 && children[start].followsPrevious &&
+        (children[start - 1].extent.lastTime == parents.back().extent.lastTime);
+      for (size_t k = start; k < start + Fanout; ++k)
+        summary.extent.append(children[k].extent);
+      parents.push_back(summary);
+      start += Fanout;
+    }
+  }
+}
+
+template <size_t Channels>
+template <typename Reader>
+void DecimationPyramid<Channels>::accumulate_(const Reader& reader, size_t level, double beginTime, double endTime, Extent& extent) const
+{
+  if (!(endTime > beginTime))
+    return;
+  if (level == 0)
+  {
+    reader(beginTime, endTime, times_, values_);
+    Extent scanned;
+    scan_(times_.data(), values_.data(), times_.size(), scanned);
+    extent.append(scanned);
+    return;
+  }
+
+  // Use the summaries that lie inside the range, filling in before, between and after them from the level below
+  const Level& summaries = levels_[level - 1];
+  auto summary = std::lower_bound(summaries.begin(), summaries.end(), beginTime,
+    [](const Summary& item, double time) { return item.extent.firstTime < time; });
+  double from = beginTime;
+  for (; summary != summaries.end() && summary->extent.lastTime < endTime; ++summary)
+  {
+    if (!summary->followsPrevious || from == beginTime)
+      accumulate_(reader, level - 1, from, summary->extent.firstTime, extent);
+    extent.append(summary->extent);
+    from = std::nextafter(summary->extent.lastTime, std::numeric_limits<double>::max());
+  }
+  accumulate_(reader, level - 1, from, endTime, extent);
+}
+
+template <size_t Channels>
+void DecimationPyramid<Channels>::scan_(const double* times, const double* values, size_t count, Extent& extent)
+{
+  extent = Extent();
+  if (count == 0)
+    return;
+  extent.count = count;
+  extent.firstTime = times[0];
+  extent.lastTime = times[count - 1];
+  for (size_t c = 0; c < Channels; ++c)
+  {
+    extent.first[c] = values[c];
+    extent.last[c] = values[(count - 1) * Channels + c];
+    double minValue = values[c];
+    double maxValue = values[c];
+    size_t minIndex = 0;
+    size_t maxIndex = 0;
+    double sum = 0.0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      const double value = values[k * Channels + c];
+      if (value < minValue)
+      {
+        minValue = value;
+        minIndex = k;
+      }
+      if (value > maxValue)
+      {
+        maxValue = value;
+        maxIndex = k;
+      }
+      sum += value;
+    }
+    extent.min[c] = minValue;
+    extent.max[c] = maxValue;
+    extent.minTime[c] = times[minIndex];
+    extent.maxTime[c] = times[maxIndex];
+    extent.sum[c] = sum;
+  }
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_DECIMATIONPYRAMID_INL_H
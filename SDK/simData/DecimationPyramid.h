@@ -0,0 +1,137 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_DECIMATIONPYRAMID_H
+#define SIMDATA_DECIMATIONPYRAMID_H
+
+#include <array>
+#include <vector>
+
+namespace simData
+{
+
+/**
+ * Min/max pyramid over a long, time ordered series of points with Channels values each, so that a
+ * history of millions of points can be aggregated or drawn at screen resolution without scanning
+ * every point.  The lowest level summarizes blocks of BlockSize consecutive points and each higher
+ * level summarizes Fanout consecutive summaries of the level below, so the extent of any time range
+ * comes from a few summaries per level plus at most two partial blocks of points.
+ *
+ * The pyramid does not hold the points.  Queries take a Reader, a callable
+ * void(double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values)
+ * that fills the times of the owner's points in [beginTime, endTime) and their values, Channels
+ * per point.  Summaries are added after the last one as queries need them, so live appends are
+ * summarized incrementally.  The owner reports every other change with changed() or removed(),
+ * e.g. data limiting removing points from the front.  Not thread safe.
+ */
+template <size_t Channels>
+class DecimationPyramid
+{
+public:
+  /// Number of points in each summary of the lowest level
+  static const size_t BlockSize = 64;
+  /// Number of summaries of one level in each summary of the next
+  static const size_t Fanout = 16;
+  /// Maximum number of representative points that decimate() returns for each bucket
+  static const size_t PointsPerBucket = 2 + 2 * Channels;
+
+  /** Extent of the points in a time range; the values are 0 if count is 0 */
+  struct Extent
+  {
+    size_t count = 0;                        ///< Number of points
+    double firstTime = 0.0;                  ///< Time of the first point
+    double lastTime = 0.0;                   ///< Time of the last point
+    std::array<double, Channels> first{};    ///< Values of the first point
+    std::array<double, Channels> last{};     ///< Values of the last point
+    std::array<double, Channels> min{};      ///< Smallest value of each channel
+    std::array<double, Channels> max{};      ///< Largest value of each channel
+    std::array<double, Channels> minTime{};  ///< Time of the first point with the smallest value of each channel
+    std::array<double, Channels> maxTime{};  ///< Time of the first point with the largest value of each channel
+    std::array<double, Channels> sum{};      ///< Sum of the values of each channel
+
+    /** Combines with the extent of points that are all later in time */
+    void append(const Extent& later);
+  };
+
+  DecimationPyramid();
+
+  /** Computes the extent of the points in [beginTime, endTime) */
+  template <typename Reader>
+  void extent(const Reader& reader, double beginTime, double endTime, Extent& extent) const;
+
+  /**
+   * Retrieves the times of representative points in [beginTime, endTime), in time order.  If the
+   * range holds no more than maxPoints points, all of them are returned.  Otherwise the range is
+   * split into maxPoints / PointsPerBucket equal buckets, and the first, last, smallest and largest
+   * point of each channel in each bucket is returned.  With Channels of 1 and maxPoints of 4 times
+   * the pixel width, a line drawn through the points matches a line drawn through all of them.
+   * @param reader Reads the points of the series
+   * @param beginTime Inclusive start of the time range
+   * @param endTime Exclusive end of the time range
+   * @param maxPoints Maximum number of points; at least PointsPerBucket
+   * @param times Receives at most maxPoints times
+   */
+  template <typename Reader>
+  void decimate(const Reader& reader, double beginTime, double endTime, size_t maxPoints, std::vector<double>& times) const;
+
+  /// Drops the summaries made stale by a point added or changed at the time
+  void changed(double time);
+  /// Drops the summaries of points in [beginTime, endTime]; call before removing the points from the series
+  void removed(double beginTime, double endTime);
+  /// Drops all summaries, e.g. when the series is cleared
+  void clear();
+
+  /// Number of levels of summaries currently built
+  size_t numLevels() const;
+
+private:
+  /// Extent of consecutive points
+  struct Summary
+  {
+    Extent extent;
+    /// False if there may be points between the previous summary of the level and this one
+    bool followsPrevious = false;
+  };
+  typedef std::vector<Summary> Level;
+
+  /// Summarizes the points and lower level summaries after the last summary of each level
+  template <typename Reader>
+  void extend_(const Reader& reader) const;
+  /// Adds the extent of [beginTime, endTime) to the extent, using the summaries of the level and below
+  template <typename Reader>
+  void accumulate_(const Reader& reader, size_t level, double beginTime, double endTime, Extent& extent) const;
+  /// Computes the extent of the points by scanning them
+  static void scan_(const double* times, const double* values, size_t count, Extent& extent);
+
+  /// Summaries of each level, in time order; level 0 summarizes points
+  mutable std::vector<Level> levels_;
+  /// Scratch buffers for the Reader
+  mutable std::vector<double> times_;
+  mutable std::vector<double> values_;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/DecimationPyramid-inl.h"
+
+#endif // SIMDATA_DECIMATIONPYRAMID_H
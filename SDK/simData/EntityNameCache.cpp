@@ -67,9 +67,16 @@ void EntityNameCache::getEntries(const std::string& name, simData::ObjectType ty
   }
 }
 
+void EntityNameCache::findEntries(const std::string& text, EntityNameIndex::Match match, bool caseSensitive, simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const
+{
+  index_.find(text, match, caseSensitive, type, entries);
+}
+
 void EntityNameCache::addEntity(const std::string& name, simData::ObjectId newId, simData::ObjectType ot)
 {
-  entries_.insert(std::pair<std::string, EntityNameEntry*>(name, new EntityNameEntry(newId, ot)));
+  EntityNameEntry* entry = new EntityNameEntry(newId, ot);
+  entries_.insert(std::pair<std::string, EntityNameEntry*>(name, entry));
+  index_.add(name, entry);
 }
 
 void EntityNameCache::removeEntity(const std::string& name, simData::ObjectId removedId, simData::ObjectType ot)
@@ -79,6 +86,7 @@ void EntityNameCache::removeEntity(const std::string& name, simData::ObjectId re
   {
     if (iter->second->id() == removedId)
     {
+      index_.remove(iter->second);
       delete iter->second;
       entries_.erase(iter);
       return;
@@ -102,6 +110,8 @@ void EntityNameCache::nameChange(const std::string& newName, const std::string&
         EntityNameEntry* entry = iter->second;
         entries_.erase(iter);
         entries_.insert(std::pair<std::string, EntityNameEntry*>(newName, entry));
+        index_.remove(entry);
+        index_.add(newName, entry);
       }
 
       return;
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 
+#include "simData/EntityNameIndex.h"
 #include "simData/ObjectId.h"
 
 namespace simData {
@@ -65,10 +66,14 @@ public:
   void nameChange(const std::string& newName, const std::string& oldName, simData::ObjectId changeId);
   /// Returns a vector of EntityNameEntry for the given name and given type
   void getEntries(const std::string& name, simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const;
+  /// Returns a vector of EntityNameEntry of the given type whose names match the text, in no particular order
+  void findEntries(const std::string& text, EntityNameIndex::Match match, bool caseSensitive, simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const;
 
 private:
   typedef std::multimap<std::string, EntityNameEntry*> EntityMap;  /// Keyed off entity name
   EntityMap entries_;
+  /// Prefix and trigram index over the same names as entries_
+  EntityNameIndex index_;
 };
 
 
@@ -0,0 +1,209 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include "simData/EntityNameCache.h"
+#include "simData/EntityNameIndex.h"
+
+namespace simData {
+
+/// Posting lists are only compacted once at least this many names were removed
+static const size_t MIN_REMOVED_FOR_COMPACT = 1024;
+
+EntityNameIndex::EntityNameIndex()
+{
+}
+
+EntityNameIndex::~EntityNameIndex()
+{
+}
+
+std::string EntityNameIndex::fold_(const std::string& text)
+{
+  std::string rv = text;
+  for (char& c : rv)
+  {
+    if ((c >= 'A') && (c <= 'Z'))
+      c = static_cast<char>(c - 'A' + 'a');
+  }
+  return rv;
+}
+
+uint32_t EntityNameIndex::trigram_(const char* text)
+{
+  return (static_cast<uint32_t>(static_cast<unsigned char>(text[0])) << 16) |
+    (static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8) |
+    static_cast<uint32_t>(static_cast<unsigned char>(text[2]));
+}
+
+void EntityNameIndex::add(const std::string& name, const EntityNameEntry* entry)
+{
+  assert(entry != nullptr);
+  assert(slotOf_.find(entry) == slotOf_.end());
+  const uint32_t slot = static_cast<uint32_t>(slots_.size());
+  slots_.push_back(Slot());
+  Slot& newSlot = slots_.back();
+  newSlot.entry = entry;
+  newSlot.name = name;
+  newSlot.folded = fold_(name);
+  slotOf_[entry] = slot;
+  sorted_.insert(std::make_pair(newSlot.folded, slot));
+  addTrigrams_(slot);
+}
+
+void EntityNameIndex::addTrigrams_(uint32_t slot)
+{
+  const std::string& folded = slots_[slot].folded;
+  for (size_t ii = 0; ii + 3 <= folded.size(); ++ii)
+  {
+    std::vector<uint32_t>& postings = trigrams_[trigram_(folded.data() + ii)];
+    // Slots are added in ascending order, so a repeated trigram in the name is always at the back
+    if (postings.empty() || (postings.back() != slot))
+      postings.push_back(slot);
+  }
+}
+
+void EntityNameIndex::remove(const EntityNameEntry* entry)
+{
+  auto slotIt = slotOf_.find(entry);
+  if (slotIt == slotOf_.end())
+  {
+    // The index is not consistent with the name cache
+    assert(false);
+    return;
+  }
+  const uint32_t slot = slotIt->second;
+  slotOf_.erase(slotIt);
+
+  Slot& removed = slots_[slot];
+  const auto range = sorted_.equal_range(removed.folded);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second == slot)
+    {
+      sorted_.erase(it);
+      break;
+    }
+  }
+
+  // The posting lists keep the slot until the next compaction; queries skip it
+  removed.entry = nullptr;
+  removed.name.clear();
+  removed.folded.clear();
+  ++numRemoved_;
+  if ((numRemoved_ >= MIN_REMOVED_FOR_COMPACT) && (numRemoved_ > slotOf_.size()))
+    compact_();
+}
+
+void EntityNameIndex::compact_()
+{
+  std::vector<Slot> live;
+  live.reserve(slotOf_.size());
+  for (auto& slot : slots_)
+  {
+    if (slot.entry != nullptr)
+      live.push_back(std::move(slot));
+  }
+  slots_.swap(live);
+  numRemoved_ = 0;
+
+  slotOf_.clear();
+  sorted_.clear();
+  trigrams_.clear();
+  for (uint32_t slot = 0; slot < slots_.size(); ++slot)
+  {
+    slotOf_[slots_[slot].entry] = slot;
+    sorted_.insert(std::make_pair(slots_[slot].folded, slot));
+    addTrigrams_(slot);
+  }
+}
+
+void EntityNameIndex::clear()
+{
+  slots_.clear();
+  numRemoved_ = 0;
+  slotOf_.clear();
+  sorted_.clear();
+  trigrams_.clear();
+}
+
+size_t EntityNameIndex::size() const
+{
+  return slotOf_.size();
+}
+
+void EntityNameIndex::addIfContains_(const Slot& slot, const std::string& text, const std::string& folded, bool caseSensitive,
+  simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const
+{
+  if ((slot.entry == nullptr) || ((slot.entry->type() & type) == 0))
+    return;
+  if (caseSensitive ? (slot.name.find(text) == std::string::npos) : (slot.folded.find(folded) == std::string::npos))
+    return;
+  entries.push_back(slot.entry);
+}
+
+void EntityNameIndex::find(const std::string& text, Match match, bool caseSensitive, simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const
+{
+  const std::string folded = fold_(text);
+
+  if (match != Match::SUBSTRING)
+  {
+    // Equal or prefixed names are adjacent in the sorted map, starting at the folded text
+    for (auto it = sorted_.lower_bound(folded); it != sorted_.end(); ++it)
+    {
+      if (match == Match::EXACT ? (it->first != folded) : (it->first.compare(0, folded.size(), folded) != 0))
+        break;
+      const Slot& slot = slots_[it->second];
+      if ((slot.entry->type() & type) == 0)
+        continue;
+      // Folding keeps the length, so an exact match only needs the prefix compared
+      if (caseSensitive && (slot.name.compare(0, text.size(), text) != 0))
+        continue;
+      entries.push_back(slot.entry);
+    }
+    return;
+  }
+
+  // Text shorter than a trigram has no posting list, so check every name
+  if (folded.size() < 3)
+  {
+    for (const auto& slot : slots_)
+      addIfContains_(slot, text, folded, caseSensitive, type, entries);
+    return;
+  }
+
+  // Only names in the shortest posting list of the text's trigrams can contain the text
+  const std::vector<uint32_t>* shortest = nullptr;
+  for (size_t ii = 0; ii + 3 <= folded.size(); ++ii)
+  {
+    const auto it = trigrams_.find(trigram_(folded.data() + ii));
+    if (it == trigrams_.end())
+      return;
+    if ((shortest == nullptr) || (it->second.size() < shortest->size()))
+      shortest = &it->second;
+  }
+  for (uint32_t slot : *shortest)
+    addIfContains_(slots_[slot], text, folded, caseSensitive, type, entries);
+}
+
+}
@@ -0,0 +1,104 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_ENTITY_NAME_INDEX_H
+#define SIMDATA_ENTITY_NAME_INDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "simData/ObjectId.h"
+
+namespace simData {
+
+class EntityNameEntry;
+
+/**
+ * Index of entity names supporting exact, prefix and substring queries, with or without case.
+ * Names are folded to lower case (ASCII letters only) and kept in a sorted map for exact and
+ * prefix queries, and in trigram posting lists for substring queries, so a query only visits
+ * names that share its rarest trigram.  Removed names are dropped from the posting lists lazily,
+ * when they outnumber the live names.
+ */
+class SDKDATA_EXPORT EntityNameIndex
+{
+public:
+  /// Ways a name can match the query text
+  enum class Match
+  {
+    EXACT,     ///< Name equals the text
+    PREFIX,    ///< Name starts with the text
+    SUBSTRING  ///< Name contains the text
+  };
+
+  EntityNameIndex();
+  virtual ~EntityNameIndex();
+
+  /// Adds the entry under the name; the entry must not already be in the index
+  void add(const std::string& name, const EntityNameEntry* entry);
+  /// Removes the entry
+  void remove(const EntityNameEntry* entry);
+  /// Removes all entries
+  void clear();
+  /// Returns the number of entries
+  size_t size() const;
+
+  /// Adds the entries of the given type whose names match the text to the vector, in no particular order
+  void find(const std::string& text, Match match, bool caseSensitive, simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const;
+
+private:
+  /// One indexed name; entry is nullptr once removed
+  struct Slot
+  {
+    const EntityNameEntry* entry = nullptr;
+    std::string name;
+    std::string folded;
+  };
+
+  /// Returns the text with ASCII letters in lower case
+  static std::string fold_(const std::string& text);
+  /// Returns the key of the three characters at the pointer
+  static uint32_t trigram_(const char* text);
+  /// Adds the slot to the posting list of each of its trigrams
+  void addTrigrams_(uint32_t slot);
+  /// Rebuilds the slots, sorted names and posting lists without the removed names
+  void compact_();
+  /// Adds the entry of the slot to the vector if it is live, of the given type, and contains the text
+  void addIfContains_(const Slot& slot, const std::string& text, const std::string& folded, bool caseSensitive,
+    simData::ObjectType type, std::vector<const EntityNameEntry*>& entries) const;
+
+  std::vector<Slot> slots_;
+  size_t numRemoved_ = 0;
+  /// Slot of each live entry
+  std::unordered_map<const EntityNameEntry*, uint32_t> slotOf_;
+  /// Folded names of the live entries, for exact and prefix queries
+  std::multimap<std::string, uint32_t> sorted_;
+  /// Ascending slots of the names that contain each folded trigram; may list removed slots
+  std::unordered_map<uint32_t, std::vector<uint32_t> > trigrams_;
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_ENTITYREGISTRY_INL_H
+#define SIMDATA_ENTITYREGISTRY_INL_H
+
+#include <cassert>
+
+namespace simData
+{
+
+template <typename T>
+EntitySlots<T>::EntitySlots(EntityRegistry& registry, EntityRegistry::Column column, ObjectType type)
+  : registry_(registry),
+    column_(column),
+    type_(type)
+{
+  assert((column_ != EntityRegistry::ENTITY) || (type_ != NONE));
+}
+
+template <typename T>
+EntitySlots<T>::~EntitySlots()
+{
+  clear();
+}
+
+template <typename T>
+typename EntitySlots<T>::iterator EntitySlots<T>::begin()
+{
+  return items_.begin();
+}
+
+template <typename T>
+typename EntitySlots<T>::iterator EntitySlots<T>::end()
+{
+  return items_.end();
+}
+
+template <typename T>
+typename EntitySlots<T>::const_iterator EntitySlots<T>::begin() const
+{
+  return items_.begin();
+}
+
+template <typename T>
+typename EntitySlots<T>::const_iterator EntitySlots<T>::end() const
+{
+  return items_.end();
+}
+
+template <typename T>
+size_t EntitySlots<T>::size() const
+{
+  return items_.size();
+}
+
+template <typename T>
+bool EntitySlots<T>::empty() const
+{
+  return items_.empty();
+}
+
+template <typename T>
+void EntitySlots<T>::reserve(size_t count)
+{
+  items_.reserve(count);
+}
+
+template <typename T>
+typename EntitySlots<T>::iterator EntitySlots<T>::find(ObjectId id)
+{
+  const size_t slot = registry_.slot(id, column_, type_);
+  return (slot == EntityRegistry::NO_SLOT) ? items_.end() : items_.begin() + slot;
+}
+
+template <typename T>
+typename EntitySlots<T>::const_iterator EntitySlots<T>::find(ObjectId id) const
+{
+  const size_t slot = registry_.slot(id, column_, type_);
+  return (slot == EntityRegistry::NO_SLOT) ? items_.end() : items_.begin() + slot;
+}
+
+template <typename T>
+T& EntitySlots<T>::operator[](ObjectId id)
+{
+  const size_t slot = registry_.slot(id, column_, type_);
+  if (slot != EntityRegistry::NO_SLOT)
+    return items_[slot].second;
+
+  // An ID holds one entity; adding it under a second type would orphan the first
+  assert((column_ != EntityRegistry::ENTITY) || (registry_.type(id) == NONE));
+  registry_.setSlot(id, column_, items_.size(), type_);
+  items_.push_back(value_type(id, T()));
+  return items_.back().second;
+}
+
+template <typename T>
+void EntitySlots<T>::erase(iterator it)
+{
+  assert(it != items_.end());
+  const size_t slot = static_cast<size_t>(it - items_.begin());
+  registry_.clearSlot(it->first, column_);
+  if (slot + 1 != items_.size())
+  {
+    *it = std::move(items_.back());
+    registry_.setSlot(it->first, column_, slot, type_);
+  }
+  items_.pop_back();
+}
+
+template <typename T>
+size_t EntitySlots<T>::erase(ObjectId id)
+{
+  iterator it = find(id);
+  if (it == items_.end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+template <typename T>
+void EntitySlots<T>::clear()
+{
+  for (const auto& item : items_)
+    registry_.clearSlot(item.first, column_);
+  items_.clear();
+}
+
+}
+
+#endif /* SIMDATA_ENTITYREGISTRY_INL_H */
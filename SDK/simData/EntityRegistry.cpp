@@ -0,0 +1,91 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <limits>
+#include "simData/EntityRegistry.h"
+
+namespace simData
+{
+
+const size_t EntityRegistry::NO_SLOT = std::numeric_limits<size_t>::max();
+
+EntityRegistry::EntityRegistry()
+{
+}
+
+EntityRegistry::~EntityRegistry()
+{
+}
+
+ObjectType EntityRegistry::type(ObjectId id) const
+{
+  const auto it = records_.find(id);
+  return (it == records_.end()) ? NONE : it->second.type;
+}
+
+size_t EntityRegistry::slot(ObjectId id, Column column, ObjectType type) const
+{
+  const auto it = records_.find(id);
+  if (it == records_.end())
+    return NO_SLOT;
+  if ((column == ENTITY) && ((it->second.type & type) == 0))
+    return NO_SLOT;
+  return it->second.slots[column];
+}
+
+void EntityRegistry::setSlot(ObjectId id, Column column, size_t slot, ObjectType type)
+{
+  Record& record = records_[id];
+  record.slots[column] = slot;
+  if (column == ENTITY)
+    record.type = type;
+}
+
+void EntityRegistry::clearSlot(ObjectId id, Column column)
+{
+  auto it = records_.find(id);
+  if (it == records_.end())
+    return;
+  Record& record = it->second;
+  record.slots[column] = NO_SLOT;
+  if (column == ENTITY)
+    record.type = NONE;
+
+  for (size_t slot : record.slots)
+  {
+    if (slot != NO_SLOT)
+      return;
+  }
+  records_.erase(it);
+}
+
+size_t EntityRegistry::size() const
+{
+  return records_.size();
+}
+
+void EntityRegistry::reserve(size_t count)
+{
+  records_.reserve(count);
+}
+
+}
@@ -0,0 +1,156 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_ENTITYREGISTRY_H
+#define SIMDATA_ENTITYREGISTRY_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#ifdef HAVE_ENTT
+#include "entt/container/dense_map.hpp"
+#endif
+#include "simCore/Common/Common.h"
+#include "simData/ObjectId.h"
+
+namespace simData
+{
+
+/**
+ * Hash index from entity ID to the entity's type and to its slots in dense, slot indexed arrays.
+ * Each array is an EntitySlots container that registers its items in one column of the registry,
+ * so a single lookup answers both what an entity is and where each piece of its data lives.
+ */
+class SDKDATA_EXPORT EntityRegistry
+{
+public:
+  /// Columns of slots held for each ID; each column is used by the EntitySlots containers of one kind of data
+  enum Column
+  {
+    ENTITY = 0,     ///< Slot in the EntitySlots of the entity's type
+    GENERIC_DATA,   ///< Slot in the EntitySlots of generic data
+    CATEGORY_DATA,  ///< Slot in the EntitySlots of category data
+    NUM_COLUMNS
+  };
+
+  /// Slot value of a column that holds nothing for the ID
+  static const size_t NO_SLOT;
+
+  EntityRegistry();
+  virtual ~EntityRegistry();
+
+  SDK_DISABLE_COPY_MOVE(EntityRegistry);
+
+  /// Returns the type of the entity, or NONE if the ID has no ENTITY slot
+  ObjectType type(ObjectId id) const;
+  /// Returns the slot of the ID in the column, or NO_SLOT; for the ENTITY column the type must also match, unless ALL
+  size_t slot(ObjectId id, Column column, ObjectType type = ALL) const;
+  /// Sets the slot of the ID in the column; the type is recorded for the ENTITY column only
+  void setSlot(ObjectId id, Column column, size_t slot, ObjectType type = NONE);
+  /// Clears the slot of the ID in the column, forgetting the ID once no column holds it
+  void clearSlot(ObjectId id, Column column);
+
+  /// Number of IDs with at least one slot
+  size_t size() const;
+  /// Reserves space for the given number of IDs
+  void reserve(size_t count);
+
+private:
+  /// Slots of one ID
+  struct Record
+  {
+    ObjectType type = NONE;
+    size_t slots[NUM_COLUMNS] = { NO_SLOT, NO_SLOT, NO_SLOT };
+  };
+
+#ifdef HAVE_ENTT
+  entt::dense_map<ObjectId, Record> records_;
+#else
+  std::unordered_map<ObjectId, Record> records_;
+#endif
+};
+
+/**
+ * Dense array of (ID, value) pairs for one type of entity, or for one kind of per entity data,
+ * indexed through an EntityRegistry.  Looking up an ID is a single hash probe, and iteration
+ * walks contiguous memory.  Removal moves the last item into the freed slot, so iteration order
+ * is insertion order only until the first removal.  Offers the subset of the std::map interface
+ * used for the entity containers of MemoryDataStore; iterators are invalidated by insertion and
+ * removal.
+ */
+template <typename T>
+class EntitySlots
+{
+public:
+  /// ID and value of one slot
+  typedef std::pair<ObjectId, T> value_type;
+  /// Iterator over the slots
+  typedef typename std::vector<value_type>::iterator iterator;
+  /// Constant iterator over the slots
+  typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+  /**
+   * Slots register themselves in the column of the registry, which must outlive this container
+   * @param registry Registry shared by the containers of a data store
+   * @param column Registry column of this container; at most one container per type may use ENTITY
+   * @param type Type of the entities held, for the ENTITY column; NONE for the other columns
+   */
+  EntitySlots(EntityRegistry& registry, EntityRegistry::Column column, ObjectType type = NONE);
+  virtual ~EntitySlots();
+
+  SDK_DISABLE_COPY_MOVE(EntitySlots);
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+  size_t size() const;
+  bool empty() const;
+  /// Reserves space for the given number of items
+  void reserve(size_t count);
+
+  /// Returns the item of the ID, or end()
+  iterator find(ObjectId id);
+  /// Returns the item of the ID, or end()
+  const_iterator find(ObjectId id) const;
+  /// Returns the value of the ID, adding a value initialized item if there is none
+  T& operator[](ObjectId id);
+  /// Removes the item, moving the last item into its slot
+  void erase(iterator it);
+  /// Removes the item of the ID, if any; returns the number removed
+  size_t erase(ObjectId id);
+  /// Removes all items
+  void clear();
+
+private:
+  EntityRegistry& registry_;
+  EntityRegistry::Column column_;
+  ObjectType type_;
+  std::vector<value_type> items_;
+};
+
+}
+
+#include "simData/EntityRegistry-inl.h"
+
+#endif /* SIMDATA_ENTITYREGISTRY_H */
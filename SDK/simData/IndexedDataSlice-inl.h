@@ -0,0 +1,388 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_INDEXEDDATASLICE_INL_H
+#define SIMDATA_INDEXEDDATASLICE_INL_H
+
+#include <cassert>
+#include <limits>
+#include "simCore/Calc/Math.h"
+
+namespace simData
+{
+
+template <typename T, typename SliceType>
+ColumnIterator<T, SliceType>::ColumnIterator(const SliceType* slice)
+  : slice_(slice),
+    nextIndex_(0)
+{
+  assert(slice_);
+}
+
+template <typename T, typename SliceType>
+const T* const ColumnIterator<T, SliceType>::next()
+{
+  if (!hasNext())
+    return nullptr;
+
+  return slice_->at(nextIndex_++);
+}
+
+template <typename T, typename SliceType>
+const T* const ColumnIterator<T, SliceType>::peekNext() const
+{
+  if (!hasNext())
+    return nullptr;
+
+  return slice_->at(nextIndex_);
+}
+
+template <typename T, typename SliceType>
+const T* const ColumnIterator<T, SliceType>::previous()
+{
+  if (!hasPrevious())
+    return nullptr;
+
+  return slice_->at(--nextIndex_);
+}
+
+template <typename T, typename SliceType>
+const T* const ColumnIterator<T, SliceType>::peekPrevious() const
+{
+  if (!hasPrevious())
+    return nullptr;
+
+  return slice_->at(nextIndex_ - 1);
+}
+
+template <typename T, typename SliceType>
+void ColumnIterator<T, SliceType>::toFront()
+{
+  nextIndex_ = 0;
+}
+
+template <typename T, typename SliceType>
+void ColumnIterator<T, SliceType>::toBack()
+{
+  nextIndex_ = slice_->numItems();
+}
+
+template <typename T, typename SliceType>
+bool ColumnIterator<T, SliceType>::hasNext() const
+{
+  return nextIndex_ < slice_->numItems();
+}
+
+template <typename T, typename SliceType>
+bool ColumnIterator<T, SliceType>::hasPrevious() const
+{
+  return nextIndex_ > 0 && nextIndex_ <= slice_->numItems();
+}
+
+template <typename T, typename SliceType>
+typename DataSlice<T>::IteratorImpl* ColumnIterator<T, SliceType>::clone() const
+{
+  ColumnIterator* rv = new ColumnIterator(slice_);
+  rv->nextIndex_ = nextIndex_;
+  return rv;
+}
+
+template <typename T, typename SliceType>
+void ColumnIterator<T, SliceType>::set(size_t idx)
+{
+  nextIndex_ = idx;
+}
+
+//----------------------------------------------------------------------------
+template <typename T, typename SliceType>
+IndexedDataSlice<T, SliceType>::IndexedDataSlice()
+  : MemoryDataSlice<T>(),
+    fastIndex_(0)
+{
+}
+
+template <typename T, typename SliceType>
+IndexedDataSlice<T, SliceType>::~IndexedDataSlice()
+{
+}
+
+template <typename T, typename SliceType>
+typename DataSlice<T>::Iterator IndexedDataSlice<T, SliceType>::lower_bound(double timeValue) const
+{
+  ColumnIterator<T, SliceType>* rv = new ColumnIterator<T, SliceType>(&slice_());
+  rv->set(slice_().lowerBoundIndex_(timeValue));
+  return typename DataSlice<T>::Iterator(rv);
+}
+
+template <typename T, typename SliceType>
+typename DataSlice<T>::Iterator IndexedDataSlice<T, SliceType>::upper_bound(double timeValue) const
+{
+  ColumnIterator<T, SliceType>* rv = new ColumnIterator<T, SliceType>(&slice_());
+  rv->set(slice_().upperBoundIndex_(timeValue));
+  return typename DataSlice<T>::Iterator(rv);
+}
+
+template <typename T, typename SliceType>
+void IndexedDataSlice<T, SliceType>::update(double time)
+{
+  // start by marking as unchanged, new hasChanged status is outcome of this update
+  this->clearChanged();
+
+  // early out when there are no changes to this slice
+  if (!this->dirty_ && (this->current_ != nullptr) && ((this->current_->time() == time) || (this->current_->time() == -1.0)))
+    return;
+
+  this->dirty_ = false;
+  this->interpolated_ = false;
+
+  SliceType& slice = slice_();
+  const size_t size = slice.numItems();
+  if (size == 0)
+  {
+    this->setCurrent(nullptr);
+    return;
+  }
+
+  // Current update is the point <= to the time
+  size_t index = slice.lowerBoundIndex_(time);
+  if (index == size)
+    index = size - 1;
+  else if (time < slice.timeAt(index))
+    index = (index == 0) ? size : index - 1;
+
+  slice.setCurrentIndex_(index);
+}
+
+template <typename T, typename SliceType>
+void IndexedDataSlice<T, SliceType>::update(double time, std::optional<double>& startTime, std::optional<double>& endTime)
+{
+  // start by marking as unchanged, new hasChanged status is outcome of this update
+  this->clearChanged();
+
+  // assume entire range then narrow down
+  startTime = 0;
+  endTime = std::numeric_limits<double>::max();
+
+  // early out when there are no changes to this slice
+  if (!this->dirty_ && (this->current_ != nullptr) && ((this->current_->time() == time) || (this->current_->time() == -1.0)))
+    return;
+
+  this->dirty_ = false;
+  this->interpolated_ = false;
+
+  SliceType& slice = slice_();
+  const size_t size = slice.numItems();
+  if (size == 0)
+  {
+    this->setCurrent(nullptr);
+    return;
+  }
+
+  size_t index = slice.lowerBoundIndex_(time);
+  if (index == size)
+  {
+    // The given time is greater than all points so the time span is the last point to the end of time
+    startTime = slice.timeAt(size - 1);
+    index = size - 1;
+  }
+  else if (slice.timeAt(index) == time)
+  {
+    // The point matches the given time so the time range is from time to the time of the next point, if any
+    startTime = time;
+    if (index + 1 < size)
+      endTime = slice.timeAt(index + 1);
+  }
+  else if (index == 0)
+  {
+    // The first point is greater than the given time so the time range is from 0 to the time of the first point
+    endTime = slice.timeAt(0);
+    index = size;
+  }
+  else
+  {
+    // The point time is greater than the given time so the time range is the time of the points that straddle the time
+    endTime = slice.timeAt(index);
+    --index;
+    startTime = slice.timeAt(index);
+  }
+
+  slice.setCurrentIndex_(index);
+}
+
+template <typename T, typename SliceType>
+void IndexedDataSlice<T, SliceType>::update(double time, Interpolator *interpolator)
+{
+  updateInterpolated_(time, interpolator);
+}
+
+template <typename T, typename SliceType>
+double IndexedDataSlice<T, SliceType>::firstTime() const
+{
+  if (slice_().numItems() == 0)
+    return std::numeric_limits<double>::max();
+
+  return slice_().timeAt(0);
+}
+
+template <typename T, typename SliceType>
+double IndexedDataSlice<T, SliceType>::lastTime() const
+{
+  const size_t size = slice_().numItems();
+  if (size == 0)
+    return -std::numeric_limits<double>::max();
+
+  return slice_().timeAt(size - 1);
+}
+
+template <typename T, typename SliceType>
+double IndexedDataSlice<T, SliceType>::deltaTime(double time) const
+{
+  const SliceType& slice = slice_();
+  const size_t size = slice.numItems();
+  if ((size == 0) || (time < 0.0))
+    return -1.0;
+
+  const size_t index = slice.lowerBoundIndex_(time);
+  if (index != size)
+  {
+    if (slice.timeAt(index) == time)
+      return 0.0;
+
+    if (index == 0)
+      return -1.0;
+  }
+
+  // Check for static point
+  const double prevTime = slice.timeAt(index - 1);
+  if (prevTime < 0.0)
+    return -1.0;
+
+  return time - prevTime;
+}
+
+template <typename T, typename SliceType>
+typename DataSlice<T>::IteratorImpl* IndexedDataSlice<T, SliceType>::iterator_() const
+{
+  return new ColumnIterator<T, SliceType>(&slice_());
+}
+
+template <typename T, typename SliceType>
+bool IndexedDataSlice<T, SliceType>::updateInterpolated_(double time, Interpolator *interpolator)
+{
+  // start by marking as unchanged, new hasChanged status is outcome of this update
+  this->clearChanged();
+
+  // early out when there are no changes to this slice
+  if (!this->dirty_ && (this->current_ != nullptr) && ((this->current_->time() == time) || (this->current_->time() == -1.0)))
+    return true;
+
+  // update is processing the changes to the slice, clear the flag
+  this->dirty_ = false;
+
+  SliceType& slice = slice_();
+  const typename DataSlice<T>::Bounds noBounds(static_cast<T*>(nullptr), static_cast<T*>(nullptr));
+  const size_t size = slice.numItems();
+  if (size == 0)
+  {
+    this->setCurrent(nullptr);
+    this->setInterpolated(false, noBounds);
+    return true;
+  }
+
+  const size_t next = slice.upperBoundIndex_(time);
+  if (next == size)
+  {
+    // Closest update is the last point
+    slice.setCurrentIndex_(size - 1);
+    this->setInterpolated(false, noBounds);
+    return true;
+  }
+
+  // time is before the first point
+  if (next == 0)
+  {
+    this->setCurrent(nullptr);
+    this->setInterpolated(false, noBounds);
+    return true;
+  }
+
+  // time is between points
+  if (simCore::areEqual(time, slice.timeAt(next - 1)))
+  {
+    slice.setCurrentIndex_(next - 1);
+    this->setInterpolated(false, noBounds);
+    return true;
+  }
+
+  const T* low = slice.bound_(next - 1, lowBound_);
+  const T* high = slice.bound_(next, highBound_);
+  interpolator->interpolate(time, *low, *high, &this->currentInterpolated_);
+  fastIndex_ = next - 1;
+  this->setCurrent(&this->currentInterpolated_);
+  this->setInterpolated(true, typename DataSlice<T>::Bounds(low, high));
+  return true;
+}
+
+template <typename T, typename SliceType>
+void IndexedDataSlice<T, SliceType>::setCurrentIndex_(size_t index)
+{
+  SliceType& slice = slice_();
+  if (index >= slice.numItems())
+  {
+    this->setCurrent(nullptr);
+    return;
+  }
+
+  fastIndex_ = index;
+
+  // currentExact_ is reused for every point, so compare times to detect a change, like setCurrent() does with pointers
+  const double time = slice.timeAt(index);
+  if ((this->current_ == &currentExact_) && (currentExact_.time() == time))
+    return;
+
+  slice.load_(index, currentExact_);
+  this->mdsHasChanged_ = true;
+  this->current_ = &currentExact_;
+}
+
+template <typename T, typename SliceType>
+const T* IndexedDataSlice<T, SliceType>::bound_(size_t index, T& scratch) const
+{
+  slice_().load_(index, scratch);
+  return &scratch;
+}
+
+template <typename T, typename SliceType>
+SliceType& IndexedDataSlice<T, SliceType>::slice_()
+{
+  return static_cast<SliceType&>(*this);
+}
+
+template <typename T, typename SliceType>
+const SliceType& IndexedDataSlice<T, SliceType>::slice_() const
+{
+  return static_cast<const SliceType&>(*this);
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_INDEXEDDATASLICE_INL_H
@@ -0,0 +1,143 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_INDEXEDDATASLICE_H
+#define SIMDATA_INDEXEDDATASLICE_H
+
+#include <optional>
+#include "simData/MemoryDataSlice.h"
+
+namespace simData
+{
+
+/**
+ * Iterator for any slice that provides numItems() and at(index), such as the subclasses of
+ * IndexedDataSlice; returns the views given by the slice
+ */
+template <typename T, typename SliceType>
+class ColumnIterator : public DataSlice<T>::IteratorImpl
+{
+public:
+  /** @param slice Slice to iterate through */
+  explicit ColumnIterator(const SliceType* slice);
+
+  /** Retrieves next item and increments iterator to next element */
+  virtual const T* const next();
+  /** Retrieves next item and does not increment iterator to next element */
+  virtual const T* const peekNext() const;
+  /** Retrieves previous item and increments iterator to next element */
+  virtual const T* const previous();
+  /** Retrieves previous item and does not increment iterator to next element */
+  virtual const T* const peekPrevious() const;
+
+  /** Resets the iterator to the front of the data structure */
+  virtual void toFront();
+  /** Sets the iterator to the end of the data structure */
+  virtual void toBack();
+
+  /** Returns true if next() / peekNext() will be a valid entry in the data slice */
+  virtual bool hasNext() const;
+  /** Returns true if previous() / peekPrevious() will be a valid entry in the data slice */
+  virtual bool hasPrevious() const;
+
+  /** Create a copy of the iterator */
+  virtual typename DataSlice<T>::IteratorImpl* clone() const;
+
+  /** Sets the index of the next item */
+  void set(size_t idx);
+
+private:
+  const SliceType* slice_;
+  size_t nextIndex_;
+};
+
+/**
+ * Base for the MemoryDataSlice subclasses that address their updates by index instead of keeping a
+ * T pointer per update, such as ColumnarDataSlice, MappedDataSlice and TieredDataSlice.  Implements
+ * the time updates, searches and iterators once on top of what SliceType provides:
+ *  - numItems(), timeAt(index) and at(index), the view used by iterators
+ *  - load_(index, update), which copies the update at index
+ *  - lowerBoundIndex_(time) and upperBoundIndex_(time), which may start from fastIndex_
+ * SliceType may also replace setCurrentIndex_() and bound_() when some of its updates can be used
+ * in place.  The current update and interpolation bounds are copies held by the slice, so playing
+ * through the data does not need any views.
+ */
+template <typename T, typename SliceType>
+class IndexedDataSlice : public MemoryDataSlice<T>
+{
+public:
+  IndexedDataSlice();
+  virtual ~IndexedDataSlice();
+  SDK_DISABLE_COPY(IndexedDataSlice);
+
+  /// Returns an iterator pointing to the first update whose time is >= timeValue
+  virtual typename DataSlice<T>::Iterator lower_bound(double timeValue) const;
+  /// Returns an iterator pointing to the first update whose time is > timeValue
+  virtual typename DataSlice<T>::Iterator upper_bound(double timeValue) const;
+
+  /// Perform a time update, finding the state data whose time matches or is the lower bound of the specified time
+  virtual void update(double time);
+  /// Perform a time update and return the time span over which the current update stays the same
+  virtual void update(double time, std::optional<double>& startTime, std::optional<double>& endTime);
+  /// Perform a time update, interpolating between the bounding points as needed
+  void update(double time, Interpolator *interpolator);
+
+  /** Retrieves the earliest time stored in this slice */
+  virtual double firstTime() const;
+  /** Retrieves the latest time stored in this slice */
+  virtual double lastTime() const;
+  /** The time delta between the given time and the data point before the given time; return -1 if no previous point */
+  virtual double deltaTime(double time) const;
+
+protected:
+  /// Helper function to return an iterator to first index
+  virtual typename DataSlice<T>::IteratorImpl* iterator_() const;
+  /// Implements update(double, Interpolator*) for callers holding a MemoryDataSlice pointer
+  virtual bool updateInterpolated_(double time, Interpolator *interpolator);
+
+  /// Points current_ at a copy of the update at index; index of numItems() clears current_
+  void setCurrentIndex_(size_t index);
+  /// Returns the update at index for use as an interpolation bound, copied into scratch
+  const T* bound_(size_t index, T& scratch) const;
+
+  /// Last index found by update(), used to speed up sequential searches
+  size_t fastIndex_;
+  /// Copy of the current update when it is an actual data point
+  T currentExact_;
+  /// Copies of the interpolation bounds
+  T lowBound_;
+  /// Copies of the interpolation bounds
+  T highBound_;
+
+private:
+  /// Returns this as the subclass
+  SliceType& slice_();
+  /// Returns this as the subclass
+  const SliceType& slice_() const;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/IndexedDataSlice-inl.h"
+
+#endif // SIMDATA_INDEXEDDATASLICE_H
@@ -0,0 +1,165 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include "simData/IngestQueue.h"
+
+namespace simData {
+
+IngestQueue::IngestQueue(size_t capacity)
+  : enqueuePos_(0),
+    dequeuePos_(0),
+    pushed_(0),
+    dropped_(0),
+    drained_(0),
+    lastDrainCount_(0),
+    lastDrainSeconds_(0.0),
+    maxDrainSeconds_(0.0),
+    totalDrainSeconds_(0.0)
+{
+  // The sequence arithmetic requires a power of two of at least 2
+  size_t size = 2;
+  while (size < capacity)
+    size <<= 1;
+  mask_ = size - 1;
+
+  cells_.reset(new Cell[size]);
+  for (size_t ii = 0; ii < size; ++ii)
+    cells_[ii].sequence.store(ii, std::memory_order_relaxed);
+}
+
+IngestQueue::~IngestQueue()
+{
+}
+
+bool IngestQueue::pushPlatformUpdate(ObjectId id, const PlatformUpdate& update)
+{
+  return push_(id, update);
+}
+
+bool IngestQueue::pushBeamUpdate(ObjectId id, const BeamUpdate& update)
+{
+  return push_(id, update);
+}
+
+bool IngestQueue::pushGateUpdate(ObjectId id, const GateUpdate& update)
+{
+  return push_(id, update);
+}
+
+bool IngestQueue::pushCategoryData(ObjectId id, const CategoryData& data)
+{
+  return push_(id, data);
+}
+
+bool IngestQueue::pushGenericData(ObjectId id, const GenericData& data)
+{
+  return push_(id, data);
+}
+
+template <typename T>
+bool IngestQueue::push_(ObjectId id, const T& data)
+{
+
+  // Claim a cell; a cell is free for position pos when its sequence equals pos
+  size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true)
+  {
+    cell = &cells_[pos & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0)
+    {
+      if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+    {
+      // The consumer has not yet emptied this cell, so the queue is full
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    else
+      pos = enqueuePos_.load(std::memory_order_relaxed);
+  }
+
+  cell->item.id = id;
+  cell->item.data = std::make_unique<T>(data);
+  // Publish the item to the consumer
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  pushed_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+size_t IngestQueue::drain(const std::function<void(Item& item)>& fn)
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+  const size_t end = enqueuePos_.load(std::memory_order_acquire);
+  size_t count = 0;
+  while (pos != end)
+  {
+    Cell& cell = cells_[pos & mask_];
+    // A producer may have claimed the cell but not yet published it; stop rather than wait
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+      break;
+
+    Item item = std::move(cell.item);
+    // Release the cell for the producers' next pass around the ring
+    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    ++pos;
+    dequeuePos_.store(pos, std::memory_order_relaxed);
+    ++count;
+
+    fn(item);
+  }
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  drained_.fetch_add(count, std::memory_order_relaxed);
+  lastDrainCount_.store(count, std::memory_order_relaxed);
+  lastDrainSeconds_.store(seconds, std::memory_order_relaxed);
+  maxDrainSeconds_.store(std::max(maxDrainSeconds_.load(std::memory_order_relaxed), seconds), std::memory_order_relaxed);
+  totalDrainSeconds_.store(totalDrainSeconds_.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+  return count;
+}
+
+IngestQueue::Statistics IngestQueue::statistics() const
+{
+  Statistics rv;
+  rv.capacity = mask_ + 1;
+  const size_t enqueued = enqueuePos_.load(std::memory_order_relaxed);
+  const size_t dequeued = dequeuePos_.load(std::memory_order_relaxed);
+  rv.depth = (enqueued > dequeued) ? (enqueued - dequeued) : 0;
+  rv.pushed = pushed_.load(std::memory_order_relaxed);
+  rv.dropped = dropped_.load(std::memory_order_relaxed);
+  rv.drained = drained_.load(std::memory_order_relaxed);
+  rv.lastDrainCount = lastDrainCount_.load(std::memory_order_relaxed);
+  rv.lastDrainSeconds = lastDrainSeconds_.load(std::memory_order_relaxed);
+  rv.maxDrainSeconds = maxDrainSeconds_.load(std::memory_order_relaxed);
+  rv.totalDrainSeconds = totalDrainSeconds_.load(std::memory_order_relaxed);
+  return rv;
+}
+
+}
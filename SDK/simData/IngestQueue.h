@@ -0,0 +1,133 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+
+#ifndef SIMDATA_INGEST_QUEUE_H
+#define SIMDATA_INGEST_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <variant>
+#include "simCore/Common/Common.h"
+#include "simData/DataTypes.h"
+#include "simData/ObjectId.h"
+
+namespace simData {
+
+/**
+ * Bounded, lock-free queue that accepts entity updates, category data and generic data from any
+ * number of threads for later insertion into a data store.  Producers call the push methods from
+ * any thread; a full queue rejects the item and counts it as dropped instead of blocking.  A single
+ * consumer, normally MemoryDataStore::update(), removes the items with drain().
+ *
+ * Each push copies the data, so the caller keeps ownership of its arguments.
+ */
+class SDKDATA_EXPORT IngestQueue
+{
+public:
+  /// Single entry in the queue
+  struct Item
+  {
+    ObjectId id = 0;
+    std::variant<std::unique_ptr<PlatformUpdate>,
+      std::unique_ptr<BeamUpdate>,
+      std::unique_ptr<GateUpdate>,
+      std::unique_ptr<CategoryData>,
+      std::unique_ptr<GenericData> > data;
+  };
+
+  /// Counters describing the queue activity
+  struct Statistics
+  {
+    size_t capacity = 0;      ///< Maximum number of items held at once
+    size_t depth = 0;         ///< Approximate number of items waiting to be drained
+    uint64_t pushed = 0;      ///< Items accepted since creation
+    uint64_t dropped = 0;     ///< Items rejected because the queue was full
+    uint64_t drained = 0;     ///< Items removed by drain() since creation
+    size_t lastDrainCount = 0;      ///< Items removed by the most recent drain()
+    double lastDrainSeconds = 0.0;  ///< Wall clock seconds spent in the most recent drain()
+    double maxDrainSeconds = 0.0;   ///< Longest drain() in wall clock seconds
+    double totalDrainSeconds = 0.0; ///< Total wall clock seconds spent in drain()
+  };
+
+  /** Creates a queue that holds at least capacity items; the capacity is rounded up to a power of two */
+  explicit IngestQueue(size_t capacity);
+  virtual ~IngestQueue();
+
+  SDK_DISABLE_COPY_MOVE(IngestQueue);
+
+  /**@name Producer methods; safe to call from any thread.  Return false if the queue is full
+   * @{
+   */
+  bool pushPlatformUpdate(ObjectId id, const PlatformUpdate& update);
+  bool pushBeamUpdate(ObjectId id, const BeamUpdate& update);
+  bool pushGateUpdate(ObjectId id, const GateUpdate& update);
+  bool pushCategoryData(ObjectId id, const CategoryData& data);
+  bool pushGenericData(ObjectId id, const GenericData& data);
+  ///@}
+
+  /**
+   * Removes the items present at the start of the call, oldest first, and passes each to the function.
+   * Items pushed while draining are left for the next call, so a busy producer cannot stall the consumer.
+   * Must only be called from one thread at a time.
+   * @return Number of items removed
+   */
+  size_t drain(const std::function<void(Item& item)>& fn);
+
+  /** Returns a snapshot of the counters; safe to call from any thread, though drain times are only exact on the consumer thread */
+  Statistics statistics() const;
+
+private:
+  /** Adds a copy of the data to the queue */
+  template <typename T>
+  bool push_(ObjectId id, const T& data);
+
+  /** Slot in the ring; sequence tells producers and the consumer whose turn it is */
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    Item item;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+
+  /// Producer and consumer positions are kept on separate cache lines to avoid false sharing
+  alignas(64) std::atomic<size_t> enqueuePos_;
+  alignas(64) std::atomic<size_t> dequeuePos_;
+
+  alignas(64) std::atomic<uint64_t> pushed_;
+  std::atomic<uint64_t> dropped_;
+
+  // Written only by the consumer
+  std::atomic<uint64_t> drained_;
+  std::atomic<size_t> lastDrainCount_;
+  std::atomic<double> lastDrainSeconds_;
+  std::atomic<double> maxDrainSeconds_;
+  std::atomic<double> totalDrainSeconds_;
+};
+
+}
+
+#endif /* SIMDATA_INGEST_QUEUE_H */
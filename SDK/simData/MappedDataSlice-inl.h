@@ -0,0 +1,269 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_MAPPEDDATASLICE_INL_H
+#define SIMDATA_MAPPEDDATASLICE_INL_H
+
+#include <algorithm>
+#include <cassert>
+#include "simData/DataSliceUpdaters.h"
+
+namespace simData
+{
+
+template <typename T>
+MappedDataSlice<T>::MappedDataSlice(std::shared_ptr<const MappedFile> file, const double* times, const uint8_t* chunks, size_t numUpdates)
+  : IndexedDataSlice<T, MappedDataSlice<T> >(),
+    file_(file),
+    times_(times),
+    chunks_(chunks),
+    begin_(0),
+    end_(numUpdates),
+    views_((numUpdates + ColumnChunkSize - 1) / ColumnChunkSize)
+{
+}
+
+template <typename T>
+MappedDataSlice<T>::~MappedDataSlice()
+{
+}
+
+template <typename T>
+void MappedDataSlice<T>::flush(bool keepStatic)
+{
+  // don't flush static entities
+  if (!keepStatic || numItems() != 1 || timeAt(0) != -1.0)
+  {
+    eraseFront_(numItems());
+    this->current_ = nullptr;
+  }
+  this->dirty_ = true;
+
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+void MappedDataSlice<T>::flush(double startTime, double endTime)
+{
+  // endTime is non-inclusive
+  const size_t first = lowerBoundIndex_(startTime);
+  const size_t last = lowerBoundIndex_(endTime);
+  if (first < last)
+  {
+    // The archive cannot change, so only the ends of the slice can be hidden
+    if (first == 0)
+      eraseFront_(last);
+    else if (last == numItems())
+      eraseBack_(first);
+    this->current_ = nullptr;
+  }
+  this->dirty_ = true;
+
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+size_t MappedDataSlice<T>::numItems() const
+{
+  return end_ - begin_;
+}
+
+template <typename T>
+void MappedDataSlice<T>::visit(typename DataSlice<T>::Visitor *visitor) const
+{
+  T scratch;
+  const size_t size = numItems();
+  for (size_t ii = 0; ii < size; ++ii)
+  {
+    load_(ii, scratch);
+    (*visitor)(&scratch);
+  }
+}
+
+template <typename T>
+void MappedDataSlice<T>::insert(T *data)
+{
+  delete data;
+}
+
+template <typename T>
+void MappedDataSlice<T>::insertMany(std::vector<T*>& data)
+{
+  for (T* update : data)
+    delete update;
+  data.clear();
+}
+
+template <typename T>
+void MappedDataSlice<T>::limitByTime(double timeWindow)
+{
+  if ((timeWindow < 0) || (numItems() == 0))
+    return;
+
+  const double timeLimit = this->lastTime() - timeWindow;
+  if (timeLimit < 0.0)
+    return;
+
+  // always leave one point
+  size_t newFirst = upperBoundIndex_(timeLimit);
+  if (newFirst == numItems())
+    --newFirst;
+  if (newFirst == 0)
+    return;
+
+  eraseFront_(newFirst);
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+void MappedDataSlice<T>::limitByPoints(uint32_t limitPoints)
+{
+  // zero is special case for "no limit"
+  if ((limitPoints == 0) || (numItems() <= limitPoints))
+    return;
+
+  eraseFront_(numItems() - limitPoints);
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+size_t MappedDataSlice<T>::memoryUsage() const
+{
+  size_t rv = sizeof(*this) + views_.size() * sizeof(std::unique_ptr<T[]>);
+  for (const auto& views : views_)
+  {
+    if (views)
+      rv += ColumnChunkSize * sizeof(T);
+  }
+  return rv;
+}
+
+template <typename T>
+double MappedDataSlice<T>::timeAt(size_t index) const
+{
+  return times_[begin_ + index];
+}
+
+template <typename T>
+const T* MappedDataSlice<T>::at(size_t index) const
+{
+  assert(index < numItems());
+  const size_t position = begin_ + index;
+  const size_t block = position / ColumnChunkSize;
+  std::unique_ptr<T[]>& views = views_[block];
+  if (!views)
+  {
+    // Hidden positions never become visible again, so only the visible ones are filled in
+    views.reset(new T[ColumnChunkSize]);
+    const size_t blockStart = block * ColumnChunkSize;
+    const size_t first = std::max(begin_, blockStart);
+    const size_t last = std::min(end_, blockStart + ColumnChunkSize);
+    for (size_t ii = first; ii < last; ++ii)
+      load_(ii - begin_, views[ii - blockStart]);
+  }
+  return &views[position % ColumnChunkSize];
+}
+
+template <typename T>
+void MappedDataSlice<T>::load_(size_t index, T& update) const
+{
+  const size_t position = begin_ + index;
+  const size_t offset = position % ColumnChunkSize;
+  const uint8_t* block = chunks_ + (position / ColumnChunkSize) * MappedChunkLayout<T>::Bytes;
+  ColumnLayout<T>::load(reinterpret_cast<const double*>(block), reinterpret_cast<const float*>(block + MappedChunkLayout<T>::FloatsOffset),
+    block[MappedChunkLayout<T>::FlagsOffset + offset], offset, update);
+  update.set_time(times_[position]);
+}
+
+template <typename T>
+void MappedDataSlice<T>::eraseFront_(size_t count)
+{
+  begin_ += std::min(count, numItems());
+  this->fastIndex_ = 0;
+
+  // Release the views of blocks that are now completely hidden
+  for (size_t block = 0; block < begin_ / ColumnChunkSize; ++block)
+    views_[block].reset();
+}
+
+template <typename T>
+void MappedDataSlice<T>::eraseBack_(size_t index)
+{
+  end_ = begin_ + std::min(index, numItems());
+  this->fastIndex_ = 0;
+}
+
+template <typename T>
+size_t MappedDataSlice<T>::lowerBoundIndex_(double time) const
+{
+  const double* begin = times_ + begin_;
+  const double* end = times_ + end_;
+
+  // Sequential playback usually lands next to the previous result, so look there first
+  const double* hint = begin + this->fastIndex_;
+  if (hint < end)
+  {
+    if (*hint <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && hint != end; ++ii, ++hint)
+      {
+        if (*hint >= time)
+          return hint - begin;
+      }
+      return std::lower_bound(hint, end, time) - begin;
+    }
+    return std::lower_bound(begin, hint, time) - begin;
+  }
+  return std::lower_bound(begin, end, time) - begin;
+}
+
+template <typename T>
+size_t MappedDataSlice<T>::upperBoundIndex_(double time) const
+{
+  const double* begin = times_ + begin_;
+  const double* end = times_ + end_;
+
+  // Sequential playback usually lands next to the previous result, so look there first
+  const double* hint = begin + this->fastIndex_;
+  if (hint < end)
+  {
+    if (*hint <= time)
+    {
+      for (size_t ii = 0; ii < FastSearchWidth && hint != end; ++ii, ++hint)
+      {
+        if (*hint > time)
+          return hint - begin;
+      }
+      return std::upper_bound(hint, end, time) - begin;
+    }
+    return std::upper_bound(begin, hint, time) - begin;
+  }
+  return std::upper_bound(begin, end, time) - begin;
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_MAPPEDDATASLICE_INL_H
@@ -0,0 +1,137 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_MAPPEDDATASLICE_H
+#define SIMDATA_MAPPEDDATASLICE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/ColumnarDataSlice.h"
+
+namespace simData
+{
+
+class MappedFile;
+
+/**
+ * Describes the layout of a block of ColumnChunkSize update fields inside an archive.  The block
+ * holds the double columns, then the float columns, then the flags, each column laid out as in
+ * ColumnChunk so that ColumnLayout can read it in place.  Blocks are padded to 8 bytes.
+ */
+template <typename T>
+struct MappedChunkLayout
+{
+  /// Offset of the float columns from the start of the block
+  static constexpr size_t FloatsOffset = ColumnLayout<T>::NumDoubles * ColumnChunkSize * sizeof(double);
+  /// Offset of the flags from the start of the block
+  static constexpr size_t FlagsOffset = FloatsOffset + ColumnLayout<T>::NumFloats * ColumnChunkSize * sizeof(float);
+  /// Size of a block, including padding
+  static constexpr size_t Bytes = (FlagsOffset + ColumnChunkSize + 7) & ~static_cast<size_t>(7);
+};
+
+/**
+ * Read-only MemoryDataSlice that serves updates straight out of a memory mapped archive; see
+ * ArchiveDataStore.  Times are a single contiguous column and the remaining fields are stored
+ * in MappedChunkLayout blocks, so only the pages that are searched or read are brought into memory.
+ *  - insert() and insertMany() discard their data, since the archive cannot change.
+ *  - Flushing and data limiting hide updates from the front or back of the slice; flushing a
+ *    range from the middle of the slice is ignored.
+ *  - Views for iterators are materialized a block at a time, like ColumnarDataSlice.
+ * Available for PlatformUpdate, BeamUpdate and GateUpdate; see ColumnLayout.
+ */
+template <typename T>
+class MappedDataSlice : public IndexedDataSlice<T, MappedDataSlice<T> >
+{
+  friend class IndexedDataSlice<T, MappedDataSlice<T> >;
+
+public:
+  /**
+   * @param file Mapping that holds the data; kept open for the life of the slice
+   * @param times Update times in increasing order; numUpdates long
+   * @param chunks First of the (numUpdates / ColumnChunkSize) rounded up MappedChunkLayout blocks
+   * @param numUpdates Number of updates
+   */
+  MappedDataSlice(std::shared_ptr<const MappedFile> file, const double* times, const uint8_t* chunks, size_t numUpdates);
+  virtual ~MappedDataSlice();
+  SDK_DISABLE_COPY(MappedDataSlice);
+
+  /// hide all data in the slice
+  virtual void flush(bool keepStatic = true);
+  /// hide points in the given time range, if the range covers the front or the back of the slice
+  virtual void flush(double startTime, double endTime);
+
+  /// Total number of items in this data slice
+  virtual size_t numItems() const;
+
+  /// Process update range; the pointer given to the visitor is only valid during the call
+  virtual void visit(typename DataSlice<T>::Visitor *visitor) const;
+
+  /// Archived data is read-only; deletes the update
+  virtual void insert(T *data);
+  /// Archived data is read-only; deletes the updates
+  virtual void insertMany(std::vector<T*>& data);
+
+  /// reduce the data store to only have points within the given 'timeWindow'
+  virtual void limitByTime(double timeWindow);
+  /// reduce the data store to only have 'limitPoints' points
+  virtual void limitByPoints(uint32_t limitPoints);
+
+  /** Approximate number of heap bytes used by the slice and its materialized views; the mapped file is not counted */
+  virtual size_t memoryUsage() const;
+
+  /** Time of the update at index, which must be less than numItems() */
+  double timeAt(size_t index) const;
+  /** Returns the materialized view of the update at index, which must be less than numItems() */
+  const T* at(size_t index) const;
+
+private:
+  /// Copies the update at index into the given object
+  void load_(size_t index, T& update) const;
+  /// Hides the first count updates
+  void eraseFront_(size_t count);
+  /// Hides the updates from index to the end
+  void eraseBack_(size_t index);
+
+  /// Index of the first update with time >= the given time, or numItems()
+  size_t lowerBoundIndex_(double time) const;
+  /// Index of the first update with time > the given time, or numItems()
+  size_t upperBoundIndex_(double time) const;
+
+  std::shared_ptr<const MappedFile> file_;
+  const double* times_;
+  const uint8_t* chunks_;
+  /// Position in the archive of the first visible update
+  size_t begin_;
+  /// Position in the archive one past the last visible update
+  size_t end_;
+  /// Views materialized for iterators, one entry per block; nullptr until first needed
+  mutable std::vector<std::unique_ptr<T[]> > views_;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/MappedDataSlice-inl.h"
+
+#endif // SIMDATA_MAPPEDDATASLICE_H
@@ -0,0 +1,152 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "simData/MappedFile.h"
+
+namespace simData
+{
+
+MappedFile::MappedFile()
+  : data_(nullptr),
+    size_(0)
+#ifdef WIN32
+  , file_(INVALID_HANDLE_VALUE),
+    mapping_(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#ifdef WIN32
+
+int MappedFile::open(const std::string& filename)
+{
+  close();
+
+  file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE)
+    return 1;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0)
+  {
+    close();
+    return 1;
+  }
+
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr)
+  {
+    close();
+    return 1;
+  }
+
+  data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr)
+  {
+    close();
+    return 1;
+  }
+  size_ = static_cast<size_t>(fileSize.QuadPart);
+  return 0;
+}
+
+void MappedFile::close()
+{
+  if (data_ != nullptr)
+    UnmapViewOfFile(data_);
+  if (mapping_ != nullptr)
+    CloseHandle(mapping_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_);
+  data_ = nullptr;
+  size_ = 0;
+  mapping_ = nullptr;
+  file_ = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+int MappedFile::open(const std::string& filename)
+{
+  close();
+
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return 1;
+
+  struct stat fileStat;
+  if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0))
+  {
+    ::close(fd);
+    return 1;
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  void* address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED)
+    return 1;
+
+  data_ = static_cast<const uint8_t*>(address);
+  size_ = static_cast<size_t>(fileStat.st_size);
+  return 0;
+}
+
+void MappedFile::close()
+{
+  if (data_ != nullptr)
+    munmap(const_cast<uint8_t*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
+
+bool MappedFile::isOpen() const
+{
+  return data_ != nullptr;
+}
+
+const uint8_t* MappedFile::data() const
+{
+  return data_;
+}
+
+size_t MappedFile::size() const
+{
+  return size_;
+}
+
+}
@@ -0,0 +1,72 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_MAPPEDFILE_H
+#define SIMDATA_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "simCore/Common/Common.h"
+
+namespace simData
+{
+
+/**
+ * Read-only memory mapping of an entire file.  Pages are loaded by the operating system as they
+ * are touched, so opening a large file is fast and residency is left to the OS.
+ */
+class SDKDATA_EXPORT MappedFile
+{
+public:
+  MappedFile();
+  virtual ~MappedFile();
+  SDK_DISABLE_COPY_MOVE(MappedFile);
+
+  /**
+   * Maps the file, closing any previous mapping
+   * @param filename File to map
+   * @return 0 on success, non-zero if the file cannot be opened or mapped
+   */
+  int open(const std::string& filename);
+  /// Releases the mapping
+  void close();
+
+  /// Returns true if a file is mapped
+  bool isOpen() const;
+  /// Start of the mapped bytes; nullptr if nothing is mapped
+  const uint8_t* data() const;
+  /// Number of mapped bytes
+  size_t size() const;
+
+private:
+  const uint8_t* data_;
+  size_t size_;
+#ifdef WIN32
+  void* file_;
+  void* mapping_;
+#endif
+};
+
+}
+
+#endif /* SIMDATA_MAPPEDFILE_H */
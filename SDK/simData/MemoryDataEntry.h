@@ -23,6 +23,7 @@
 #ifndef SIMDATA_MEMORYDATAENTRY_H
 #define SIMDATA_MEMORYDATAENTRY_H
 
+#include <memory>
 #include "simData/DataEntry.h"
 #include "simData/MemoryDataSlice.h"
 #include "simData/MemoryGenericDataSlice.h"
@@ -37,6 +38,17 @@ template<typename Properties, typename Preferences, typename Updates, typename C
 class MemoryDataEntry : public DataEntry<Properties, Preferences, Updates, Commands>
 {
 public:
+  MemoryDataEntry()
+    : updates_(new Updates)
+  {
+  }
+
+  /// Takes ownership of the given update slice, which may be a subclass of Updates
+  explicit MemoryDataEntry(Updates* updates)
+    : updates_(updates)
+  {
+  }
+
   /// Retrieve the data entry's properties object defining the reference frame for its state
   virtual Properties *mutable_properties() { return &properties_; }
 
@@ -50,7 +62,7 @@ public:
   virtual const Preferences *preferences() const { return &preferences_; }
 
   /// Retrieve the data entry's DataSlice containing state updates
-  virtual Updates *updates() { return &updates_; }
+  virtual Updates *updates() { return updates_.get(); }
 
   /// Retrieve the data entry's DataSlice containing state modifying commands
   virtual Commands *commands() { return &commands_; }
@@ -64,7 +76,7 @@ public:
 private:
   Properties              properties_;
   Preferences             preferences_;
-  Updates                 updates_;
+  std::unique_ptr<Updates> updates_;
   Commands                commands_;
   MemoryCategoryDataSlice categoryData_;
   MemoryGenericDataSlice  genericData_;
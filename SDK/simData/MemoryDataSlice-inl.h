@@ -29,6 +29,7 @@
 #include "simData/MessageVisitor/Message.h"
 #include "simData/MessageVisitor/MessageVisitor.h"
 #include "simData/MessageVisitor/protobuf.h"
+#include "simData/UpdateReclaimer.h"
 
 namespace simData
 {
@@ -72,7 +73,23 @@ typename std::deque<T>::iterator SafeDequeIterator<T>::get() const
 
 //----------------------------------------------------------------------------
 template<typename T>
-int limitByTime(std::deque<T*> &updates, double timeLimit)
+void eraseUpdates(std::deque<T*> &updates, typename std::deque<T*>::iterator begin, typename std::deque<T*>::iterator end, UpdateReclaimer* reclaimer)
+{
+  if (reclaimer == nullptr)
+  {
+    for (auto it = begin; it != end; ++it)
+      delete *it;
+    updates.erase(begin, end);
+    return;
+  }
+
+  std::vector<T*> removed(begin, end);
+  updates.erase(begin, end);
+  reclaimer->reclaim(removed);
+}
+
+template<typename T>
+int limitByTime(std::deque<T*> &updates, double timeLimit, UpdateReclaimer* reclaimer)
 {
   if (updates.empty() || timeLimit < 0.0)
     return -1; // nothing to do
@@ -87,17 +104,13 @@ int limitByTime(std::deque<T*> &updates, double timeLimit)
   if (newFirstPt == updates.begin())
     return -1; // nothing to do
 
-  // reclaim memory for the points which will be removed
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != newFirstPt; ++j)
-    delete *j;
-
-  // do the removal
-  updates.erase(updates.begin(), newFirstPt);
+  // reclaim memory for the points which will be removed, and do the removal
+  eraseUpdates(updates, updates.begin(), newFirstPt, reclaimer);
   return 0;
 }
 
 template<typename T>
-int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints)
+int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints, UpdateReclaimer* reclaimer)
 {
   // zero is special case for "no limit"
   if (limitPoints == 0)
@@ -110,29 +123,23 @@ int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints)
   // set end point for deletion (only 'limitPoints' will remain at end)
   typename std::deque<T*>::iterator newFirstPt = updates.begin() + (curPoints - limitPoints);
 
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != newFirstPt; ++j)
-    delete *j;
-
-  updates.erase(updates.begin(), newFirstPt);
+  eraseUpdates(updates, updates.begin(), newFirstPt, reclaimer);
   return 0;
 }
 
 template<typename T>
-int flush(std::deque<T*> &updates, bool keepStatic)
+int flush(std::deque<T*> &updates, bool keepStatic, UpdateReclaimer* reclaimer)
 {
   // don't flush static entities
   if (keepStatic && updates.size() == 1 && (**updates.begin()).time() == -1.0)
     return 1;
 
-  for (typename std::deque<T*>::iterator j = updates.begin(); j != updates.end(); ++j)
-    delete *j;
-
-  updates.clear();
+  eraseUpdates(updates, updates.begin(), updates.end(), reclaimer);
   return 0;
 }
 
 template<typename T>
-int flush(std::deque<T*> &updates, double startTime, double endTime)
+int flush(std::deque<T*> &updates, double startTime, double endTime, UpdateReclaimer* reclaimer)
 {
   auto start = std::lower_bound(updates.begin(), updates.end(), startTime, UpdateComp<T>());
   if ((start == updates.end()) || ((*start)->time() >= endTime))
@@ -141,10 +148,7 @@ int flush(std::deque<T*> &updates, double startTime, double endTime)
   // endTime is non-inclusive
   auto end = std::lower_bound(start, updates.end(), endTime, UpdateComp<T>());
 
-  for (auto it = start; it != end; ++it)
-    delete *it;
-
-  updates.erase(start, end);
+  eraseUpdates(updates, start, end, reclaimer);
   return 0;
 }
 
@@ -246,15 +250,17 @@ MemoryDataSlice<T>::MemoryDataSlice()
 template<typename T>
 MemoryDataSlice<T>::~MemoryDataSlice()
 {
-  MemorySliceHelper::flush(updates_, false);
+  MemorySliceHelper::flush(updates_, false, reclaimer_.get());
 }
 
 template<typename T>
 void MemoryDataSlice<T>::flush(bool keepStatic)
 {
-  if (MemorySliceHelper::flush(updates_, keepStatic) == 0)
+  if (MemorySliceHelper::flush(updates_, keepStatic, reclaimer_.get()) == 0)
     current_ = nullptr;
   dirty_ = true;
+  if (timeIndex_)
+    timeIndex_->invalidate();
 
   if (notifierFn_)
     notifierFn_();
@@ -263,9 +269,11 @@ void MemoryDataSlice<T>::flush(bool keepStatic)
 template<typename T>
 void MemoryDataSlice<T>::flush(double startTime, double endTime)
 {
-  if (MemorySliceHelper::flush(updates_, startTime, endTime) == 0)
+  if (MemorySliceHelper::flush(updates_, startTime, endTime, reclaimer_.get()) == 0)
     current_ = nullptr;
   dirty_ = true;
+  if (timeIndex_)
+    timeIndex_->invalidate();
 
   if (notifierFn_)
     notifierFn_();
@@ -275,7 +283,7 @@ template<typename T>
 typename DataSlice<T>::Iterator MemoryDataSlice<T>::lower_bound(double timeValue) const
 {
   VectorIterator<T>* rv = new VectorIterator<T>(&updates_);
-  typename std::deque<T*>::const_iterator iter =  computeLowerBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), timeValue);
+  typename std::deque<T*>::const_iterator iter =  computeLowerBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), timeValue, timeIndex_.get());
   rv->set(iter - updates_.begin());
   return typename DataSlice<T>::Iterator(rv);
 }
@@ -284,7 +292,7 @@ template<typename T>
 typename DataSlice<T>::Iterator MemoryDataSlice<T>::upper_bound(double timeValue) const
 {
   VectorIterator<T>* rv = new VectorIterator<T>(&updates_);
-  typename std::deque<T*>::const_iterator iter = computeUpperBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), timeValue);
+  typename std::deque<T*>::const_iterator iter = computeUpperBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), timeValue, timeIndex_.get());
   rv->set(iter - updates_.begin());
   return typename DataSlice<T>::Iterator(rv);
 }
@@ -393,7 +401,7 @@ void MemoryDataSlice<T>::update(double time)
   dirty_ = false;
 
   interpolated_ = false;
-  fastUpdate_ = MemorySliceHelper::SafeDequeIterator<T*>(&updates_, computeTimeUpdate<typename std::deque<T*>::iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), time));
+  fastUpdate_ = MemorySliceHelper::SafeDequeIterator<T*>(&updates_, computeTimeUpdate<typename std::deque<T*>::iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), time, timeIndex_.get()));
   if (fastUpdate_.get() != updates_.end())
     setCurrent(*fastUpdate_.get());
   else
@@ -424,7 +432,7 @@ void MemoryDataSlice<T>::update(double time, std::optional<double>& startTime, s
     return;
   }
 
-  auto currentIt = std::lower_bound(updates_.begin(), updates_.end(), time, UpdateComp<T>());
+  auto currentIt = timeIndex_ ? timeIndex_->lowerBound(updates_.begin(), updates_.end(), time) : std::lower_bound(updates_.begin(), updates_.end(), time, UpdateComp<T>());
 
   if (currentIt == updates_.begin()) // At the start
   {
@@ -485,6 +493,9 @@ void MemoryDataSlice<T>::installNotifier(const std::function<void()>& fn)
 template<typename T>
 void MemoryDataSlice<T>::update(double time, Interpolator *interpolator)
 {
+  if (updateInterpolated_(time, interpolator))
+    return;
+
   // start by marking as unchanged, new hasChanged status is outcome of this update
   clearChanged();
 
@@ -500,7 +511,7 @@ void MemoryDataSlice<T>::update(double time, Interpolator *interpolator)
   typename std::deque<T*>::iterator it = fastUpdate_.get();
 
   // note that computeTimeUpdate can return a ptr to a real update, or pointer to currentInterpolated_
-  setCurrent(computeTimeUpdate<typename std::deque<T*>::iterator, T, typename DataSlice<T>::Bounds>(updates_.begin(), it, updates_.end(), time, interpolator, &isBounded, &currentInterpolated_, &bounds));
+  setCurrent(computeTimeUpdate<typename std::deque<T*>::iterator, T, typename DataSlice<T>::Bounds>(updates_.begin(), it, updates_.end(), time, interpolator, &isBounded, &currentInterpolated_, &bounds, timeIndex_.get()));
   fastUpdate_ =  MemorySliceHelper::SafeDequeIterator<T*>(&updates_, it);
   setInterpolated(isBounded, bounds);
 }
@@ -530,9 +541,86 @@ void MemoryDataSlice<T>::insert(T *data)
       }
     }
   }
+  const bool append = (iter == updates_.end());
   updates_.insert(iter, data);
   fastUpdate_.invalidate();
   dirty_ = true;
+  if (timeIndex_)
+  {
+    if (append)
+      timeIndex_->append(updates_);
+    else
+      timeIndex_->invalidate();
+  }
+}
+
+template<typename T>
+void MemoryDataSlice<T>::insertMany(std::vector<T*>& data)
+{
+  if (data.empty())
+    return;
+
+  if (notifierFn_)
+    notifierFn_();
+
+  sortUnique_(data);
+
+  if (updates_.empty() || (updates_.back()->time() < data.front()->time()))
+  {
+    // Common case of appending newer data
+    updates_.insert(updates_.end(), data.begin(), data.end());
+    if (timeIndex_)
+      timeIndex_->append(updates_);
+  }
+  else
+  {
+    std::deque<T*> merged;
+    auto oldIter = updates_.begin();
+    auto newIter = data.begin();
+    while (oldIter != updates_.end() && newIter != data.end())
+    {
+      if ((*oldIter)->time() < (*newIter)->time())
+        merged.push_back(*oldIter++);
+      else
+      {
+        if ((*oldIter)->time() == (*newIter)->time())
+        {
+          // null the current ptr, if we are replacing the update it aliases; current will become valid upon update
+          if (current_ == *oldIter)
+            setCurrent(nullptr);
+          delete *oldIter++;
+        }
+        merged.push_back(*newIter++);
+      }
+    }
+    merged.insert(merged.end(), oldIter, updates_.end());
+    merged.insert(merged.end(), newIter, data.end());
+    updates_.swap(merged);
+    if (timeIndex_)
+      timeIndex_->invalidate();
+  }
+
+  data.clear();
+  fastUpdate_.invalidate();
+  dirty_ = true;
+}
+
+template<typename T>
+void MemoryDataSlice<T>::sortUnique_(std::vector<T*>& data)
+{
+  std::stable_sort(data.begin(), data.end(), UpdateComp<T>());
+  size_t last = 0;
+  for (size_t ii = 1; ii < data.size(); ++ii)
+  {
+    if (data[ii]->time() == data[last]->time())
+    {
+      delete data[last];
+      data[last] = data[ii];
+    }
+    else
+      data[++last] = data[ii];
+  }
+  data.resize(last + 1);
 }
 
 template<typename T>
@@ -540,8 +628,11 @@ void MemoryDataSlice<T>::limitByTime(double timeWindow)
 {
   if (timeWindow >= 0)
   {
-    if (MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow) == 0)
+    const size_t before = updates_.size();
+    if (MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow, reclaimer_.get()) == 0)
     {
+      if (timeIndex_)
+        timeIndex_->eraseFront(before - updates_.size());
       fastUpdate_.invalidate();
       if (notifierFn_)
         notifierFn_();
@@ -552,8 +643,11 @@ void MemoryDataSlice<T>::limitByTime(double timeWindow)
 template<typename T>
 void MemoryDataSlice<T>::limitByPoints(uint32_t limitPoints)
 {
-  if (MemorySliceHelper::limitByPoints(updates_, limitPoints) == 0)
+  const size_t before = updates_.size();
+  if (MemorySliceHelper::limitByPoints(updates_, limitPoints, reclaimer_.get()) == 0)
   {
+    if (timeIndex_)
+      timeIndex_->eraseFront(before - updates_.size());
     fastUpdate_.invalidate();
     if (notifierFn_)
       notifierFn_();
@@ -591,7 +685,7 @@ double MemoryDataSlice<T>::deltaTime(double time) const
   if (updates_.empty() || (time < 0.0))
     return -1.0;
 
-  typename std::deque<T*>::const_iterator it = computeLowerBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), time);
+  typename std::deque<T*>::const_iterator it = computeLowerBound<typename std::deque<T*>::const_iterator, T>(updates_.begin(), fastUpdate_.get(), updates_.end(), time, timeIndex_.get());
 
   if (it != updates_.end())
   {
@@ -617,12 +711,45 @@ T* MemoryDataSlice<T>::currentInterpolated()
   return &currentInterpolated_;
 }
 
+template<typename T>
+size_t MemoryDataSlice<T>::memoryUsage() const
+{
+  return sizeof(*this) + updates_.size() * (sizeof(T*) + sizeof(T));
+}
+
+template<typename T>
+void MemoryDataSlice<T>::enableTimeIndex(bool enable)
+{
+  if (!enable)
+    timeIndex_.reset();
+  else if (!timeIndex_)
+    timeIndex_.reset(new TimeBucketIndex<T>());
+}
+
+template<typename T>
+bool MemoryDataSlice<T>::timeIndexEnabled() const
+{
+  return timeIndex_ != nullptr;
+}
+
+template<typename T>
+void MemoryDataSlice<T>::setUpdateReclaimer(std::shared_ptr<UpdateReclaimer> reclaimer)
+{
+  reclaimer_ = reclaimer;
+}
+
 template<typename T>
 typename DataSlice<T>::IteratorImpl* MemoryDataSlice<T>::iterator_() const
 {
   return new VectorIterator<T>(&updates_);
 }
 
+template<typename T>
+bool MemoryDataSlice<T>::updateInterpolated_(double time, Interpolator *interpolator)
+{
+  return false;
+}
+
 //----------------------------------------------------------------------------
 template<class CommandType, class PrefType>
 MemoryCommandSlice<CommandType, PrefType>::MemoryCommandSlice()
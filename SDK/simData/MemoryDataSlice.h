@@ -24,18 +24,23 @@
 #define SIMDATA_MEMORYDATASLICE_H
 
 #include <deque>
+#include <memory>
 #include <optional>
+#include <vector>
 #include "simData/DataTypes.h"
 #include "simData/DataSlice.h"
 #include "simData/DataSliceUpdaters.h"
 #include "simData/DataStore.h"
 #include "simData/Interpolator.h"
 #include "simData/ObjectId.h"
+#include "simData/TimeBucketIndex.h"
 #include "simData/UpdateComp.h"
 
 namespace simData
 {
 
+class UpdateReclaimer;
+
 namespace MemorySliceHelper
 {
 
@@ -61,31 +66,42 @@ private:
 };
 
 
+/*
+ * The functions below delete the removed updates inline, or hand them to the reclaimer if one
+ * is given, so large removals are destroyed off the calling thread.
+ */
+
+/// remove the updates [begin, end), deleting them or handing them to the reclaimer if not nullptr
+template<typename T>
+void eraseUpdates(std::deque<T*> &updates, typename std::deque<T*>::iterator begin, typename std::deque<T*>::iterator end, UpdateReclaimer* reclaimer);
+
 /**
  * Reduce the data store to only have points within the given 'timeWindow'
  * @param updates Deque of updates on which to apply data limit
  * @param timeLimit earliest time to keep
+ * @param reclaimer Destroys the removed updates if not nullptr
  * @return 0 if at least one item is removed.
  */
 template<typename T>
-int limitByTime(std::deque<T*> &updates, double timeLimit);
+int limitByTime(std::deque<T*> &updates, double timeLimit, UpdateReclaimer* reclaimer = nullptr);
 
 /**
  * Reduce the data store to only have 'limitPoints' points
  * @param updates Deque of updates on which to apply data limit
  * @param limitPoints number of points to keep (0 is no limit)
+ * @param reclaimer Destroys the removed updates if not nullptr
  * @return 0 if at least one item is removed.
  */
 template<typename T>
-int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints);
+int limitByPoints(std::deque<T*> &updates, uint32_t limitPoints, UpdateReclaimer* reclaimer = nullptr);
 
 /// remove all points, unless keeping a static (time = -1) point; returns non-zero if flush did not occur due to static case
 template<typename T>
-int flush(std::deque<T*> &updates, bool keepStatic = true);
+int flush(std::deque<T*> &updates, bool keepStatic = true, UpdateReclaimer* reclaimer = nullptr);
 
 /// remove points in the given time range; up to but not including endTime
 template<typename T>
-int flush(std::deque<T*> &updates, double startTime, double endTime);
+int flush(std::deque<T*> &updates, double startTime, double endTime, UpdateReclaimer* reclaimer = nullptr);
 } // namespace MemorySliceHelper
 
 /** Iterator for DataSlice vector */
@@ -238,7 +254,7 @@ public:
    * @param endTime The end time of the time range that has the same current_ as time
    * @return true if the slice's current_changes
   */
-  void update(double time, std::optional<double>& startTime, std::optional<double>& endTime);
+  virtual void update(double time, std::optional<double>& startTime, std::optional<double>& endTime);
 
   /// A function that is called every time the slice is modified
   void installNotifier(const std::function<void()>& fn);
@@ -257,13 +273,21 @@ public:
    */
   virtual void insert(T *data);
 
+  /**
+   * Inserts many updates at once, taking ownership of them.  The updates may be in any order; they are
+   * sorted once and merged with the existing updates in a single pass.  As with insert(), an update
+   * replaces any existing update with the same time, and the last of several equal times wins.
+   * @param data Updates to insert; cleared on return
+   */
+  virtual void insertMany(std::vector<T*>& data);
+
   /// reduce the data store to only have points within the given 'timeWindow'
   /// @param timeWindow amount of time to keep in window (negative for no limit)
-  void limitByTime(double timeWindow);
+  virtual void limitByTime(double timeWindow);
 
   /// reduce the data store to only have 'limitPoints' points
   /// @param limitPoints number of points to keep (0 is no limit)
-  void limitByPoints(uint32_t limitPoints);
+  virtual void limitByPoints(uint32_t limitPoints);
 
   /** Performs both point and time limiting based on the settings in prefs */
   virtual void limitByPrefs(const CommonPrefs &prefs);
@@ -280,10 +304,39 @@ public:
   /** Retrieves the current interpolated T, or nullptr if none */
   T* currentInterpolated();
 
+  /** Approximate number of bytes used to hold the slice and its updates, not counting allocator overhead */
+  virtual size_t memoryUsage() const;
+
+  /**
+   * Enables a TimeBucketIndex for the time searches of update(), lower_bound(), upper_bound() and
+   * deltaTime().  Sequential playback is already fast without the index; the index makes random
+   * seeks, such as scrubbing the time slider, nearly as fast.  Disabled by default.  Slices that
+   * keep their own time column, like ColumnarDataSlice, ignore the setting.
+   */
+  void enableTimeIndex(bool enable);
+  /// Returns true if the time searches use a TimeBucketIndex
+  bool timeIndexEnabled() const;
+
+  /**
+   * Destroys updates removed by data limiting and flushes on the reclaimer's background thread,
+   * instead of inline; nullptr, the default, deletes them inline.  Slices that keep their own
+   * storage, like ColumnarDataSlice, do not use it.
+   */
+  void setUpdateReclaimer(std::shared_ptr<UpdateReclaimer> reclaimer);
+
 protected:
   /// Helper function to return an iterator to first index
   virtual typename DataSlice<T>::IteratorImpl* iterator_() const;
 
+  /**
+   * Lets a subclass replace update(double, Interpolator*), which cannot be virtual because not every
+   * update type has an interpolate() overload.  Returns true if the update was handled.
+   */
+  virtual bool updateInterpolated_(double time, Interpolator *interpolator);
+
+  /** Stable sorts the updates by time and deletes all but the last of any with equal times */
+  static void sortUnique_(std::vector<T*>& data);
+
 protected:
   /// used to mark if time update or changes to the slice have resulted in a change to the current update
   bool mdsHasChanged_;
@@ -303,6 +356,10 @@ protected:
   typename MemorySliceHelper::SafeDequeIterator<T*> fastUpdate_;
   /// Used to notify parent that the slice changed
   std::function<void()> notifierFn_;
+  /// Optional index for the time searches; kept up to date by every change to updates_
+  std::unique_ptr<TimeBucketIndex<T> > timeIndex_;
+  /// Optional destroyer of removed updates; nullptr deletes them inline
+  std::shared_ptr<UpdateReclaimer> reclaimer_;
 };
 
 //----------------------------------------------------------------------------
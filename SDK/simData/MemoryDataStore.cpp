@@ -22,10 +22,14 @@
  */
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <float.h>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <optional>
+#include <type_traits>
+#include <unordered_map>
 #ifdef HAVE_ENTT
 #include "entt/container/dense_map.hpp"
 #endif
@@ -34,15 +38,22 @@
 #include "simCore/Calc/Calculations.h"
 #include "simCore/Calc/Coordinate.h"
 #include "simCore/Calc/Interpolation.h"
-#include "simCore/Calc/MultiFrameCoordinate.h"
 #include "simCore/Common/Common.h"
+#include "simCore/System/ParallelFor.h"
 #include "simCore/Time/Clock.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/ColumnarDataSlice.h"
 #include "simData/DataEntry.h"
 #include "simData/DataTypes.h"
 #include "simData/DataTable.h"
 #include "simData/DataStoreHelpers.h"
+#include "simData/DataStoreSnapshot.h"
 #include "simData/EntityNameCache.h"
+#include "simData/IngestQueue.h"
+#include "simData/PlatformFrameCache.h"
+#include "simData/StringPool.h"
+#include "simData/TieredDataSlice.h"
+#include "simData/UpdateReclaimer.h"
 #include "simData/CategoryData/MemoryCategoryDataSlice.h"
 #include "simData/CategoryData/CategoryNameManager.h"
 #include "simData/MemoryTable/DataLimitsProvider.h"
@@ -53,6 +64,8 @@ namespace simData
 
 /// If there are more than USE_THREAD_FOR_GENERIC_DATA entities, then use a worker thread for the update
 constexpr size_t USE_THREAD_FOR_GENERIC_DATA = 1000;
+/// Minimum number of entities given to each thread of a parallel update; fewer entities are not worth the hand off
+constexpr size_t MIN_ENTITIES_PER_UPDATE_THREAD = 64;
 
 //----------------------------------------------------------------------------
 // Functions local to compilation unit, for implementation of common operations
@@ -67,10 +80,10 @@ namespace
  * @param[in   ] id id to delete
  * @param[in   ] deepDelete when true, also delete the object in the map
  */
-template<typename T>
-bool deleteFromMap(std::map<ObjectId, T*> &map, ObjectId id, bool deepDelete = true)
+template<typename MapType>
+bool deleteFromMap(MapType &map, ObjectId id, bool deepDelete = true)
 {
-  typename std::map<ObjectId, T*>::iterator i = map.find(id);
+  typename MapType::iterator i = map.find(id);
   if (i != map.end())
   {
     if (deepDelete)
@@ -84,22 +97,82 @@ bool deleteFromMap(std::map<ObjectId, T*> &map, ObjectId id, bool deepDelete = t
   return false;
 }
 
+/**
+ * Commits data from the IngestQueue through the same transaction used by the public add methods.
+ * @param id Entity the data belongs to
+ * @param source Data to commit; may be moved from
+ * @param addFn Function that returns a new T for the given ID and transaction, or nullptr if the entity does not exist
+ */
+template <typename T, typename AddFunction>
+void commitIngested(ObjectId id, T& source, const AddFunction& addFn)
+{
+  DataStore::Transaction transaction;
+  T* data = addFn(id, &transaction);
+  if (data == nullptr)
+    return;
+  *data = std::move(source);
+  transaction.commit();
+}
+
+/**
+ * Calls fn(id, entry) for every item in the map.  If numThreads is more than 1, the items are
+ * split between up to that many threads and the function must be safe to call concurrently
+ * for different items.  Returns after every item is processed.
+ */
+template <typename MapType, typename Function>
+void forEachEntry(unsigned int numThreads, MapType& map, const Function& fn)
+{
+  if ((numThreads <= 1) || (map.size() < 2 * MIN_ENTITIES_PER_UPDATE_THREAD))
+  {
+    for (auto it = map.begin(); it != map.end(); ++it)
+      fn(it->first, it->second);
+    return;
+  }
+
+  const size_t maxPartitions = std::min<size_t>(numThreads, map.size() / MIN_ENTITIES_PER_UPDATE_THREAD);
+
+  // Dense containers such as EntitySlots are partitioned in place
+  typedef typename std::iterator_traits<decltype(map.begin())>::iterator_category Category;
+  if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>)
+  {
+    const auto first = map.begin();
+    simCore::parallelFor(map.size(), maxPartitions, [&first, &fn](size_t begin, size_t end) {
+      for (size_t ii = begin; ii < end; ++ii)
+        fn(first[ii].first, first[ii].second);
+    });
+    return;
+  }
+
+  // Maps cannot be partitioned directly, so gather the items in order first
+  std::vector<std::pair<ObjectId, decltype(&map.begin()->second)> > items;
+  items.reserve(map.size());
+  for (auto it = map.begin(); it != map.end(); ++it)
+    items.push_back(std::make_pair(it->first, &it->second));
+
+  simCore::parallelFor(items.size(), maxPartitions, [&items, &fn](size_t begin, size_t end) {
+    for (size_t ii = begin; ii < end; ++ii)
+      fn(items[ii].first, *items[ii].second);
+  });
+}
+
 /**
  * @param Unique ID (retrieved from MemoryDataStore::genUniqueId_()
- * @param Container (std::map keyed by ID for Platform, Beam, or Gate)
+ * @param Container (EntitySlots of Platform, Beam, Gate, etc. entries)
  * @param memory data store
  * @param Pointer to Transaction object (MemoryDataStore::transaction_)
+ * @param Entry to add; if nullptr a default constructed entry is added
  */
 template <typename EntryType,            // PlatformEntry, BeamEntry, GateEntry, LaserEntry, ProjectorEntry
           typename PropertiesType,       // PlatformProperties, BeamProperties, GateProperties, LaserProperties, ProjectorProperties
           typename TransactionImplType,  // Properties transaction implementation type
           typename ListenerListType,     // Type for list of "entry added" observer callbacks (such as the private MemoryDataStore::ListenerList)
           typename PrefType>             // Type for the adding the default pref values
-PropertiesType* addEntry(ObjectId id, std::map<ObjectId, EntryType*> *entries, MemoryDataStore *store, DataStore::Transaction *transaction, ListenerListType *listeners, PrefType *defaultPrefs)
+PropertiesType* addEntry(ObjectId id, EntitySlots<EntryType*> *entries, MemoryDataStore *store, DataStore::Transaction *transaction, ListenerListType *listeners, PrefType *defaultPrefs, EntryType *entry = nullptr)
 {
   assert(transaction);
 
-  EntryType *entry = new EntryType();
+  if (entry == nullptr)
+    entry = new EntryType();
 
   entry->mutable_properties()->set_id(id);
 
@@ -125,6 +198,23 @@ EntryType* getEntry(ObjectId id, const EntryMapType *store)
   return nullptr;
 }
 
+/// Reports the memory used by an update slice, split into hot and cold tiers
+template <typename T>
+void sliceMemoryUsage(const MemoryDataSlice<T>* slice, size_t& hotBytes, size_t& coldBytes)
+{
+  const auto* tiered = dynamic_cast<const TieredDataSlice<T>*>(slice);
+  if (tiered)
+  {
+    hotBytes = tiered->hotMemoryUsage();
+    coldBytes = tiered->coldMemoryUsage();
+  }
+  else
+  {
+    hotBytes = slice->memoryUsage();
+    coldBytes = 0;
+  }
+}
+
 /**
  * Retrieve a constant pointer to a properties object from different lists;
  * requires:
@@ -305,6 +395,24 @@ public:
       listener->onScenarioDelete(source);
   }
 
+  virtual void onCategoryDataChange(DataStore* source, ObjectId changedId, simData::ObjectType ot) override
+  {
+    for (const auto& listener : listeners_)
+      listener->onCategoryDataChange(source, changedId, ot);
+  }
+
+  virtual void onNameChange(DataStore* source, ObjectId changeId) override
+  {
+    for (const auto& listener : listeners_)
+      listener->onNameChange(source, changeId);
+  }
+
+  virtual void onFlush(DataStore* source, ObjectId flushedId) override
+  {
+    for (const auto& listener : listeners_)
+      listener->onFlush(source, flushedId);
+  }
+
 private:
   simData::DataStore::ListenerList listeners_;
 };
@@ -492,6 +600,7 @@ public:
     }
 
     categoryCache_[newId] = CategoryCache(categoryIt->second);
+    mds_.categoryValues_.setValues(newId, std::map<int, int>());
 
     auto genericIt = mds_.genericData_.find(newId);
     if (genericIt == mds_.genericData_.end())
@@ -502,6 +611,7 @@ public:
     }
 
     genericIt->second->setTimeGetter([this]() { return mds_.updateTime(); });
+    genericIt->second->setStringPool(mds_.genericDataStringPool_);
 
     if (ot == simData::PLATFORM)
     {
@@ -512,7 +622,7 @@ public:
         assert(false);
         return;
       }
-      platformCache_[newId] = PlatformCache(it->second);
+      platformCache_[newId] = PlatformCache(it->second, mds_.platformFrameCaching_);
       platformCommandCache_[newId] = CommandCache(it->second->commands(), newId);
     }
     else if (ot == simData::CUSTOM_RENDERING)
@@ -586,6 +696,7 @@ public:
   virtual void onRemoveEntity(DataStore* source, ObjectId removedId, simData::ObjectType ot) override
   {
     categoryCache_.erase(removedId);
+    mds_.categoryValues_.removeEntity(removedId);
     if (platformCache_.erase(removedId) == 1)
     {
       platformCommandCache_.erase(removedId);
@@ -622,6 +733,7 @@ public:
   virtual void onScenarioDelete(DataStore* source) override
   {
     categoryCache_.clear();
+    mds_.categoryValues_.clear();
     platformCache_.clear();
     platformCommandCache_.clear();
     customRenderingCommandCache_.clear();
@@ -632,6 +744,13 @@ public:
     projectorCommandCache_.clear();
   }
 
+  /// Returns the frame cache of the platform, or nullptr if the platform does not exist or does not cache frames
+  PlatformFrameCache* platformFrames(ObjectId id) const
+  {
+    auto it = platformCache_.find(id);
+    return (it == platformCache_.end()) ? nullptr : it->second.frameCache();
+  }
+
   void installSliceTimeRangeMonitor(ObjectId id, std::function<void(double startTime, double endTime)> fn)
   {
     auto it = platformCache_.find(id);
@@ -690,12 +809,22 @@ public:
 
     const bool fileMode = isFileMode_();
 
+    // Platforms call the Interpolator only in EXTERNAL mode; INTERNAL interpolation is thread safe
+    const unsigned int numThreads = mds_.entityUpdateThreads_(interpolateEnabled == InterpolatorState::EXTERNAL);
+    if (numThreads > 1)
+    {
+      // The time range monitors are callbacks, so they must be made from this thread
 #ifdef HAVE_ENTT
-    for (const auto& [id, entry] : platformCache_)
+      for (const auto& [id, entry] : platformCache_)
 #else
-    for (auto& [id, entry] : platformCache_)
+      for (auto& [id, entry] : platformCache_)
 #endif
+        entry.updateSliceTimeRange();
+    }
+
+    forEachEntry(numThreads, platformCache_, [&](ObjectId id, PlatformCache& entry) {
       entry.update(&mds_, id, interpolateEnabled, fileMode, time);
+    });
   }
 
   void resetPlatforms()
@@ -852,9 +981,11 @@ private:
   class PlatformCache
   {
   public:
-    explicit PlatformCache(PlatformEntry* entry = nullptr)
+    explicit PlatformCache(PlatformEntry* entry = nullptr, bool cacheFrames = false)
       : entry_(entry)
     {
+      if (cacheFrames)
+        frameCache_ = std::make_unique<PlatformFrameCache>();
       resetPreferences();
       reset();
       if (entry_)
@@ -879,6 +1010,7 @@ private:
         lifeSpanMode_(std::move(other.lifeSpanMode_)),
         entry1_(std::move(other.entry1_)),
         entry2_(std::move(other.entry2_)),
+        frameCache_(std::move(other.frameCache_)),
         timeRangeMonitorFn_(std::move(other.timeRangeMonitorFn_))
     {
       if (entry_)
@@ -900,6 +1032,7 @@ private:
       lifeSpanMode_ = std::move(other.lifeSpanMode_);
       entry1_ = std::move(other.entry1_);
       entry2_ = std::move(other.entry2_);
+      frameCache_ = std::move(other.frameCache_);
       timeRangeMonitorFn_ = std::move(other.timeRangeMonitorFn_);
 
       if (entry_)
@@ -918,21 +1051,15 @@ private:
      */
     void update(simData::DataStore* ds, simData::ObjectId id, DataStore::InterpolatorState interpolateState, bool fileMode, double time)
     {
-      // Set the slice time range
-      if (!sliceStartTime_.has_value())
-      {
-        sliceStartTime_ = entry_->updates()->firstTime();
-        sliceEndTime_ = entry_->updates()->lastTime();
-        sliceSize_ = entry_->updates()->numItems();
-        if (timeRangeMonitorFn_)
-          timeRangeMonitorFn_(*sliceStartTime_, *sliceEndTime_);
-      }
+      updateSliceTimeRange();
 
       // Return early if not drawing
       if (!dataDraw_)
       {
         // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
         entry_->updates()->setCurrent(nullptr);
+        if (frameCache_)
+          frameCache_->setCurrent(nullptr);
         return;
       }
 
@@ -961,6 +1088,8 @@ private:
           if (needToSetToNull_)
           {
             entry_->updates()->setCurrent(nullptr);
+            if (frameCache_)
+              frameCache_->setCurrent(nullptr);
             needToSetToNull_ = false;
           }
           return;
@@ -980,6 +1109,31 @@ private:
         if (fileMode && !isExtendedPlatform() && (updateEndTime_ > sliceEndTime_))
           updateEndTime_ = sliceEndTime_;
       }
+
+      if (frameCache_)
+        frameCache_->setCurrent(entry_->updates()->current());
+    }
+
+    /** Caches the time range of the slice if it is not already known, notifying the time range monitor */
+    void updateSliceTimeRange()
+    {
+      if (sliceStartTime_.has_value())
+        return;
+
+      sliceStartTime_ = entry_->updates()->firstTime();
+      sliceEndTime_ = entry_->updates()->lastTime();
+      sliceSize_ = entry_->updates()->numItems();
+      if (timeRangeMonitorFn_)
+        timeRangeMonitorFn_(*sliceStartTime_, *sliceEndTime_);
+
+      // The slice changed; drop the frames of updates removed by data limiting or flushing
+      if (frameCache_)
+      {
+        if (sliceSize_ == 0)
+          frameCache_->clear();
+        else
+          frameCache_->eraseBefore(*sliceStartTime_);
+      }
     }
 
     /** Called when the slice is modified so that the next call to update will not kick out early */
@@ -996,6 +1150,12 @@ private:
       entry2_.reset();
     }
 
+    /** Returns the frame cache, or nullptr if the platform does not cache frames */
+    PlatformFrameCache* frameCache() const
+    {
+      return frameCache_.get();
+    }
+
     void resetPreferences()
     {
       if (!entry_ || !entry_->preferences())
@@ -1088,22 +1248,27 @@ private:
         }
         else if (!it.hasPrevious())  // First point
         {
-          entry1_ = Entry(it.peekNext(), convert_(it.peekNext()));
+          Entry first = makeEntry_(it.peekNext());
+          entry1_ = std::move(first);
           entry2_.reset();
           updateStartTime_ = 0;
           updateEndTime_ = it.peekNext()->time();
         }
         else if (!it.hasNext()) // Last point
         {
+          Entry last = makeEntry_(it.peekPrevious());
           entry1_.reset();
-          entry2_ = Entry(it.peekPrevious(), convert_(it.peekPrevious()));
+          entry2_ = std::move(last);
           updateStartTime_ = it.peekPrevious()->time();
           updateEndTime_ = std::numeric_limits<double>::max();
         }
         else // Time in between points
         {
-          entry1_ = Entry(it.peekPrevious(), convert_(it.peekPrevious()));
-          entry2_ = Entry(it.peekNext(), convert_(it.peekNext()));
+          // Build both before assigning, so that frames of the old bracket can be reused
+          Entry first = makeEntry_(it.peekPrevious());
+          Entry second = makeEntry_(it.peekNext());
+          entry1_ = std::move(first);
+          entry2_ = std::move(second);
           updateStartTime_ = it.peekPrevious()->time();
           updateEndTime_ = it.peekNext()->time();
         }
@@ -1154,15 +1319,15 @@ private:
       // If gotten this far, then it must be an interpolation
       isInterpolated = true;
       bounds = { const_cast<simData::PlatformUpdate*>(entry1_->update), const_cast<simData::PlatformUpdate*>(entry2_->update) };
-      interpolate_(time, *entry1_->mfc, *entry2_->mfc, *interpolatedPoint);
+      interpolate_(time, framesOf_(*entry1_), framesOf_(*entry2_), *interpolatedPoint);
       return interpolatedPoint;
     }
 
     /**
-     * Returns the interpolated TSPI point between mfc1 and mfc2 as specified by the time
+     * Returns the interpolated TSPI point between prev and next as specified by the time
      * Maps to bool LinearInterpolator::interpolate(double time, const PlatformUpdate &prev, const PlatformUpdate &next, PlatformUpdate *result)
      */
-    void interpolate_(double time, simCore::MultiFrameCoordinate& mfc1, simCore::MultiFrameCoordinate& mfc2, PlatformUpdate& result) const
+    void interpolate_(double time, const PlatformFrames& prev, const PlatformFrames& next, PlatformUpdate& result) const
     {
       // time must be within bounds for interpolation to work
       assert(updateStartTime_.value() <= time && time <= updateEndTime_.value());
@@ -1170,16 +1335,11 @@ private:
       // compute time ratio
       const double factor = simCore::getFactor(updateStartTime_.value(), time, updateEndTime_.value());
 
-      const auto& prev = mfc1.ecefCoordinate();
-      const auto& prevLla = mfc1.llaCoordinate();
-      const auto& next = mfc2.ecefCoordinate();
-      const auto& nextLla = mfc2.llaCoordinate();
-
       // do the interpolation in geocentric, this way the
        // interpolation is correct at N/S and E/W transitions
-      simCore::Vec3 xyz(simCore::linearInterpolate(prev.x(), next.x(), factor),
-        simCore::linearInterpolate(prev.y(), next.y(), factor),
-        simCore::linearInterpolate(prev.z(), next.z(), factor));
+      simCore::Vec3 xyz(simCore::linearInterpolate(prev.ecef[0], next.ecef[0], factor),
+        simCore::linearInterpolate(prev.ecef[1], next.ecef[1], factor),
+        simCore::linearInterpolate(prev.ecef[2], next.ecef[2], factor));
 
       simCore::Vec3 lla;
       simCore::CoordinateConverter::convertEcefToGeodeticPos(xyz, lla);
@@ -1187,16 +1347,16 @@ private:
       // Use interpolated geodetic altitude to prevent short cuts through the earth
       simCore::Coordinate resultsLla;
       resultsLla.setCoordinateSystem(simCore::COORD_SYS_LLA);
-      resultsLla.setPositionLLA(lla.lat(), lla.lon(), simCore::linearInterpolate(prevLla.z(), nextLla.z(), factor));
+      resultsLla.setPositionLLA(lla.lat(), lla.lon(), simCore::linearInterpolate(prev.lla[2], next.lla[2], factor));
 
-      if (prev.hasOrientation() && next.hasOrientation())
+      if ((prev.flags & next.flags & PlatformFrames::HAS_ORIENTATION) != 0)
       {
-        const double l_yaw = simCore::angFix2PI(prevLla.yaw());
-        const double l_pitch = simCore::angFix2PI(prevLla.pitch());
-        const double l_roll = simCore::angFix2PI(prevLla.roll());
-        const double h_yaw = simCore::angFix2PI(nextLla.yaw());
-        const double h_pitch = simCore::angFix2PI(nextLla.pitch());
-        const double h_roll = simCore::angFix2PI(nextLla.roll());
+        const double l_yaw = simCore::angFix2PI(prev.llaOrientation[0]);
+        const double l_pitch = simCore::angFix2PI(prev.llaOrientation[1]);
+        const double l_roll = simCore::angFix2PI(prev.llaOrientation[2]);
+        const double h_yaw = simCore::angFix2PI(next.llaOrientation[0]);
+        const double h_pitch = simCore::angFix2PI(next.llaOrientation[1]);
+        const double h_roll = simCore::angFix2PI(next.llaOrientation[2]);
 
         // orientations assumed to be between 0 and 360
         const double delta_yaw = (h_yaw - l_yaw);
@@ -1246,11 +1406,11 @@ private:
         resultsLla.setOrientation(yaw, pitch, roll);
       }
 
-      if (prev.hasVelocity() && next.hasVelocity())
+      if ((prev.flags & next.flags & PlatformFrames::HAS_VELOCITY) != 0)
       {
-        resultsLla.setVelocity(simCore::linearInterpolate(prevLla.vx(), nextLla.vx(), factor),
-          simCore::linearInterpolate(prevLla.vy(), nextLla.vy(), factor),
-          simCore::linearInterpolate(prevLla.vz(), nextLla.vz(), factor));
+        resultsLla.setVelocity(simCore::linearInterpolate(prev.llaVelocity[0], next.llaVelocity[0], factor),
+          simCore::linearInterpolate(prev.llaVelocity[1], next.llaVelocity[1], factor),
+          simCore::linearInterpolate(prev.llaVelocity[2], next.llaVelocity[2], factor));
       }
 
       simCore::Coordinate resultsEcef;
@@ -1275,33 +1435,14 @@ private:
         result.set_theta(resultsEcef.theta());
         result.set_phi(resultsEcef.phi());
       }
-    }
-
-    /** Convert a simData::PlatformUpdate into a simCore::MultiFrameCoordinate */
-    simCore::MultiFrameCoordinate convert_(const simData::PlatformUpdate* update) const
-    {
-      simCore::Vec3 pos;
-      update->position(pos);
 
-      simCore::MultiFrameCoordinate rv;
-      simCore::Coordinate coord(simCore::COORD_SYS_ECEF, pos);
-
-      if (update->has_orientation())
+      // Keep the frames of the interpolated state, since its geodetic coordinate is already known
+      if (frameCache_ && (resultsLla.hasOrientation() == result.has_orientation()) && (resultsLla.hasVelocity() == result.has_velocity()))
       {
-        simCore::Vec3 ori;
-        update->orientation(ori);
-        coord.setOrientation(ori);
+        PlatformFrames frames;
+        PlatformFrameCache::compute(result, resultsLla, frames);
+        frameCache_->setCurrent(frames);
       }
-
-      if (update->has_velocity())
-      {
-        simCore::Vec3 vec;
-        update->velocity(vec);
-        coord.setVelocity(vec);
-      }
-
-      rv.setCoordinate(coord);
-      return rv;
     }
 
     std::optional<double> updateStartTime_;
@@ -1316,15 +1457,14 @@ private:
     bool needToSetToNull_ = true;
     LifespanMode lifeSpanMode_ = LIFE_FIRST_LAST_POINT;
 
-    /** Keep track of a platform update / MultiFrameCoordinate pair */
+    /** Keep track of a platform update and its coordinate frames, which are computed on demand */
     struct Entry
     {
       const simData::PlatformUpdate* update = nullptr;
-      std::optional<simCore::MultiFrameCoordinate> mfc;
+      std::optional<PlatformFrames> frames;
 
-      Entry(const simData::PlatformUpdate* inUpdate, std::optional<simCore::MultiFrameCoordinate> inMfc)
-        : update(inUpdate),
-          mfc(inMfc)
+      explicit Entry(const simData::PlatformUpdate* inUpdate)
+        : update(inUpdate)
       {
       }
 
@@ -1336,8 +1476,36 @@ private:
       Entry& operator=(Entry&& other) noexcept = default;
     };
 
+    /** Returns a bracket entry for the update, reusing the frames of the current bracket if possible */
+    Entry makeEntry_(const simData::PlatformUpdate* update)
+    {
+      if (entry1_.has_value() && (entry1_->update == update))
+        return std::move(*entry1_);
+      if (entry2_.has_value() && (entry2_->update == update))
+        return std::move(*entry2_);
+      return Entry(update);
+    }
+
+    /** Returns the frames of the entry, computing them the first time they are needed */
+    const PlatformFrames& framesOf_(Entry& entry) const
+    {
+      if (!entry.frames.has_value())
+      {
+        if (frameCache_)
+          entry.frames = frameCache_->get(*entry.update);
+        else
+        {
+          entry.frames.emplace();
+          PlatformFrameCache::compute(*entry.update, *entry.frames);
+        }
+      }
+      return *entry.frames;
+    }
+
     std::optional<Entry> entry1_;
     std::optional<Entry> entry2_;
+    /** Frames of the updates, computed at insert time; nullptr if not caching frames */
+    std::unique_ptr<PlatformFrameCache> frameCache_;
     std::function<void(double startTime, double endTime)> timeRangeMonitorFn_;
   };
 
@@ -1394,6 +1562,138 @@ private:
 
 //----------------------------------------------------------------------------
 
+/** Consolidates the events of every entity into one ChangeSet; records nothing while disabled */
+class MemoryDataStore::ChangeSetCollector : public simData::DataStore::DefaultListener
+{
+public:
+  ChangeSetCollector()
+  {
+  }
+
+  /** Starts or stops recording; stopping discards the pending changes */
+  void setEnabled(bool enabled)
+  {
+    enabled_ = enabled;
+    if (!enabled_)
+    {
+      pending_.clear();
+      scenarioDeleted_ = false;
+    }
+  }
+
+  /** Moves the pending changes into the change set and starts a new batch */
+  void take(ChangeSet& changes)
+  {
+    changes = ChangeSet();
+    changes.scenarioDeleted = scenarioDeleted_;
+    for (const auto& idAndFlags : pending_)
+    {
+      const ObjectId id = idAndFlags.first;
+      const unsigned int flags = idAndFlags.second;
+      if (flags & ADDED)
+        changes.added.push_back(id);
+      else if (flags & REMOVED)
+        changes.removed.push_back(id);
+      else
+      {
+        if (flags & PREFS)
+          changes.prefs.push_back(id);
+        if (flags & PROPERTIES)
+          changes.properties.push_back(id);
+        if (flags & NAME)
+          changes.names.push_back(id);
+      }
+      // Category data and flushes of new entities are still reported, since they follow the add
+      if (!(flags & REMOVED))
+      {
+        if (flags & CATEGORY_DATA)
+          changes.categoryData.push_back(id);
+        if (flags & FLUSHED)
+          changes.flushed.push_back(id);
+      }
+    }
+    pending_.clear();
+    scenarioDeleted_ = false;
+
+    for (auto* list : { &changes.added, &changes.removed, &changes.prefs, &changes.properties, &changes.names, &changes.categoryData, &changes.flushed })
+      std::sort(list->begin(), list->end());
+  }
+
+  virtual void onAddEntity(DataStore* source, ObjectId newId, simData::ObjectType ot) override
+  {
+    if (enabled_)
+      pending_[newId] |= ADDED;
+  }
+
+  virtual void onRemoveEntity(DataStore* source, ObjectId removedId, simData::ObjectType ot) override
+  {
+    if (!enabled_)
+      return;
+    auto it = pending_.find(removedId);
+    if (it == pending_.end())
+      pending_[removedId] = REMOVED;
+    else if (it->second & ADDED)
+      pending_.erase(it);  // Added and removed in the same batch, so the batch never saw it
+    else
+      it->second = REMOVED;
+  }
+
+  virtual void onPrefsChange(DataStore* source, ObjectId id) override
+  {
+    if (enabled_)
+      pending_[id] |= PREFS;
+  }
+
+  virtual void onPropertiesChange(DataStore* source, ObjectId id) override
+  {
+    if (enabled_)
+      pending_[id] |= PROPERTIES;
+  }
+
+  virtual void onCategoryDataChange(DataStore* source, ObjectId changedId, simData::ObjectType ot) override
+  {
+    if (enabled_)
+      pending_[changedId] |= CATEGORY_DATA;
+  }
+
+  virtual void onNameChange(DataStore* source, ObjectId changeId) override
+  {
+    if (enabled_)
+      pending_[changeId] |= NAME;
+  }
+
+  virtual void onFlush(DataStore* source, ObjectId flushedId) override
+  {
+    if (enabled_)
+      pending_[flushedId] |= FLUSHED;
+  }
+
+  virtual void onScenarioDelete(DataStore* source) override
+  {
+    if (enabled_)
+      scenarioDeleted_ = true;
+  }
+
+private:
+  /// Bits recording the events of one entity
+  enum Flags
+  {
+    ADDED = 1 << 0,
+    REMOVED = 1 << 1,
+    PREFS = 1 << 2,
+    PROPERTIES = 1 << 3,
+    NAME = 1 << 4,
+    CATEGORY_DATA = 1 << 5,
+    FLUSHED = 1 << 6
+  };
+
+  bool enabled_ = false;
+  bool scenarioDeleted_ = false;
+  std::unordered_map<ObjectId, unsigned int> pending_;
+};
+
+//----------------------------------------------------------------------------
+
 /** Adapts NewRowDataListener to MemoryDataStore's newUpdatesListener_ */
 class MemoryDataStore::NewRowDataToNewUpdatesAdapter : public MemoryTable::TableManager::NewRowDataListener
 {
@@ -1426,6 +1726,7 @@ public:
       listeners_(ds.listeners_),
       scenarioListeners_(ds.scenarioListeners_),
       newUpdatesListeners_(ds.newUpdatesListeners_),
+      batchListeners_(ds.batchListeners_),
       boundClock_(ds.boundClock_)
   {
     // fill in everything
@@ -1464,6 +1765,9 @@ public:
     for (auto listener : newUpdatesListeners_)
       ds.addNewUpdatesListener(listener);
 
+    for (auto listener : batchListeners_)
+      ds.addBatchListener(listener);
+
     for (std::vector<DataTableManager::ManagerObserverPtr>::const_iterator iter = dtObservers_.begin(); iter != dtObservers_.end(); ++iter)
       ds.dataTableManager().addObserver(*iter);
 
@@ -1481,6 +1785,7 @@ private: // data
   DataStore::ListenerList listeners_;
   DataStore::ScenarioListenerList scenarioListeners_;
   std::vector<DataStore::NewUpdatesListenerPtr> newUpdatesListeners_;
+  std::vector<DataStore::BatchListenerPtr> batchListeners_;
   std::vector<DataTableManager::ManagerObserverPtr> dtObservers_;
   std::vector<CategoryNameManager::ListenerPtr> catListeners_;
 
@@ -1549,10 +1854,15 @@ MemoryDataStore::MemoryDataStore(const ScenarioProperties &properties)
 ///destructor
 MemoryDataStore::~MemoryDataStore()
 {
+  // Stop listening before the listeners and tables go away
+  snapshotBuilder_.reset();
   if (boundClock_)
     boundClock_->removeModeChangeCallback(clockModeMonitor_);
 
   clearMemory_();
+  // Slices are gone, so no more batches can arrive
+  if (updateReclaimer_)
+    updateReclaimer_->shutDown();
   delete categoryNameManager_;
   categoryNameManager_ = nullptr;
   delete dataTableManager_;
@@ -1571,6 +1881,8 @@ void MemoryDataStore::initCompositeListener_()
   local->add(originalIdCache_);
   sliceCacheObserver_ = std::make_shared<SliceCacheObserver>(*this);
   local->add(sliceCacheObserver_);
+  changeSetCollector_ = std::make_shared<ChangeSetCollector>();
+  local->add(changeSetCollector_);
   addListener(local);
 }
 
@@ -1596,6 +1908,9 @@ void MemoryDataStore::clearMemory_()
     delete it->second;
   genericData_.clear();
   categoryData_.clear();
+  platformPyramids_.clear();
+  categoryValues_.clear();
+  categoryValuesDirty_ = false;
 
   // clear out the category name manager, since categories are scenario specific data
   categoryNameManager_->clear();
@@ -1688,6 +2003,427 @@ DataStore::InterpolatorState MemoryDataStore::interpolatorState() const
   return interpolationEnabled_;
 }
 
+void MemoryDataStore::setUpdateStorage(UpdateStorage storage)
+{
+  updateStorage_ = storage;
+  if (updateStorage_ != UpdateStorage::COLUMNAR || platformChunks_)
+    return;
+
+  platformChunks_ = std::make_shared<ColumnChunkPool<PlatformUpdate> >();
+  beamChunks_ = std::make_shared<ColumnChunkPool<BeamUpdate> >();
+  gateChunks_ = std::make_shared<ColumnChunkPool<GateUpdate> >();
+}
+
+MemoryDataStore::UpdateStorage MemoryDataStore::updateStorage() const
+{
+  return updateStorage_;
+}
+
+void MemoryDataStore::setColdStorageBudget(size_t bytesPerEntity)
+{
+  coldStorageBudget_ = bytesPerEntity;
+}
+
+size_t MemoryDataStore::coldStorageBudget() const
+{
+  return coldStorageBudget_;
+}
+
+void MemoryDataStore::setTimeIndexing(bool enable)
+{
+  timeIndexing_ = enable;
+}
+
+bool MemoryDataStore::timeIndexing() const
+{
+  return timeIndexing_;
+}
+
+void MemoryDataStore::setUpdateReclaiming(bool enable)
+{
+  if (enable == updateReclaiming())
+    return;
+
+  std::shared_ptr<UpdateReclaimer> old = updateReclaimer_;
+  updateReclaimer_ = enable ? std::make_shared<UpdateReclaimer>() : nullptr;
+  for (auto it = platforms_.begin(); it != platforms_.end(); ++it)
+  {
+    if (it->second)
+      it->second->updates()->setUpdateReclaimer(updateReclaimer_);
+  }
+  for (auto it = beams_.begin(); it != beams_.end(); ++it)
+  {
+    if (it->second)
+      it->second->updates()->setUpdateReclaimer(updateReclaimer_);
+  }
+  for (auto it = gates_.begin(); it != gates_.end(); ++it)
+  {
+    if (it->second)
+      it->second->updates()->setUpdateReclaimer(updateReclaimer_);
+  }
+  if (old)
+    old->shutDown();
+}
+
+bool MemoryDataStore::updateReclaiming() const
+{
+  return updateReclaimer_ != nullptr;
+}
+
+void MemoryDataStore::setPlatformFrameCaching(bool enable)
+{
+  platformFrameCaching_ = enable;
+}
+
+bool MemoryDataStore::platformFrameCaching() const
+{
+  return platformFrameCaching_;
+}
+
+const PlatformFrameCache* MemoryDataStore::platformFrameCache(ObjectId id) const
+{
+  return sliceCacheObserver_->platformFrames(id);
+}
+
+const PlatformFrames* MemoryDataStore::currentPlatformFrames(ObjectId id) const
+{
+  const PlatformFrameCache* cache = sliceCacheObserver_->platformFrames(id);
+  return (cache == nullptr) ? nullptr : cache->current();
+}
+
+void MemoryDataStore::setGenericDataStringPooling(bool enable)
+{
+  if (enable == genericDataStringPooling())
+    return;
+  genericDataStringPool_ = enable ? std::make_shared<StringPool>() : nullptr;
+  for (GenericDataMap::const_iterator it = genericData_.begin(); it != genericData_.end(); ++it)
+    it->second->setStringPool(genericDataStringPool_);
+}
+
+bool MemoryDataStore::genericDataStringPooling() const
+{
+  return genericDataStringPool_ != nullptr;
+}
+
+size_t MemoryDataStore::genericDataMemoryUsage(ObjectId id) const
+{
+  GenericDataMap::const_iterator it = genericData_.find(id);
+  return (it == genericData_.end()) ? 0 : it->second->memoryUsage();
+}
+
+size_t MemoryDataStore::genericDataStringPoolMemoryUsage() const
+{
+  return genericDataStringPool_ ? genericDataStringPool_->memoryUsage() : 0;
+}
+
+std::shared_ptr<const DataStoreSnapshot> MemoryDataStore::createSnapshot()
+{
+  if (!snapshotBuilder_)
+    snapshotBuilder_ = std::make_unique<DataStoreSnapshotBuilder>(*this);
+  return snapshotBuilder_->create();
+}
+
+const CategoryValueTable& MemoryDataStore::categoryValueTable() const
+{
+  return categoryValues_;
+}
+
+void MemoryDataStore::updateCategoryValues_(const std::vector<ObjectId>& changedIds)
+{
+  std::map<int, int> values;
+  if (categoryValuesDirty_)
+  {
+    categoryValuesDirty_ = false;
+    for (const auto& idAndSlice : categoryData_)
+    {
+      // Scenario category data is not part of any entity
+      if (idAndSlice.first == 0)
+        continue;
+      values.clear();
+      idAndSlice.second->allInts(values);
+      categoryValues_.setValues(idAndSlice.first, values);
+    }
+    return;
+  }
+
+  for (ObjectId id : changedIds)
+  {
+    auto it = categoryData_.find(id);
+    if (it == categoryData_.end())
+      continue;
+    values.clear();
+    it->second->allInts(values);
+    categoryValues_.setValues(id, values);
+  }
+}
+
+int MemoryDataStore::decimatePlatformUpdates(ObjectId id, double beginTime, double endTime, size_t maxPoints, std::vector<PlatformUpdate>& updates)
+{
+  updates.clear();
+  const PlatformUpdateSlice* slice = platformUpdateSlice(id);
+  if (slice == nullptr || maxPoints < DecimationPyramid<3>::PointsPerBucket)
+    return 1;
+
+  DecimationPyramid<3>& pyramid = platformPyramids_[id];
+  // Data limiting removes updates from the front without notification
+  if (slice->numItems() == 0)
+    pyramid.clear();
+  else
+    pyramid.removed(-std::numeric_limits<double>::max(), std::nextafter(slice->firstTime(), -std::numeric_limits<double>::max()));
+
+  std::vector<double> times;
+  pyramid.decimate([slice](double begin, double end, std::vector<double>& rangeTimes, std::vector<double>& positions) {
+    rangeTimes.clear();
+    positions.clear();
+    auto iter = slice->lower_bound(begin);
+    while (iter.hasNext())
+    {
+      const PlatformUpdate* update = iter.next();
+      if (update->time() >= end)
+        break;
+      rangeTimes.push_back(update->time());
+      positions.push_back(update->x());
+      positions.push_back(update->y());
+      positions.push_back(update->z());
+    }
+  }, beginTime, endTime, maxPoints, times);
+
+  // Copy the updates, since cold TIERED updates are views that do not outlive their block
+  updates.reserve(times.size());
+  for (double time : times)
+  {
+    auto iter = slice->lower_bound(time);
+    if (iter.hasNext())
+      updates.push_back(*iter.next());
+  }
+  return 0;
+}
+
+void MemoryDataStore::cachePlatformFrames_(ObjectId id, const std::vector<PlatformUpdate>& updates)
+{
+  PlatformFrameCache* cache = sliceCacheObserver_->platformFrames(id);
+  if (cache == nullptr || updates.empty())
+    return;
+
+  // The conversions are independent, so split them between the update threads when there are any
+  std::vector<PlatformFrames> frames(updates.size());
+  auto computeRange = [&updates, &frames](size_t begin, size_t end) {
+    for (size_t k = begin; k < end; ++k)
+      PlatformFrameCache::compute(updates[k], frames[k]);
+  };
+  simCore::parallelFor(updates.size(), std::min<size_t>(updateThreads_, updates.size() / 256), computeRange);
+  cache->add(std::move(frames));
+}
+
+int MemoryDataStore::updateMemoryUsage(ObjectId id, size_t& hotBytes, size_t& coldBytes) const
+{
+  hotBytes = 0;
+  coldBytes = 0;
+
+  PlatformEntry* platform = getEntry<PlatformEntry, Platforms>(id, &platforms_);
+  if (platform)
+  {
+    sliceMemoryUsage(platform->updates(), hotBytes, coldBytes);
+    return 0;
+  }
+
+  BeamEntry* beam = getEntry<BeamEntry, Beams>(id, &beams_);
+  if (beam)
+  {
+    sliceMemoryUsage(beam->updates(), hotBytes, coldBytes);
+    return 0;
+  }
+
+  GateEntry* gate = getEntry<GateEntry, Gates>(id, &gates_);
+  if (gate)
+  {
+    sliceMemoryUsage(gate->updates(), hotBytes, coldBytes);
+    return 0;
+  }
+
+  return 1;
+}
+
+void MemoryDataStore::setUpdateThreads(unsigned int numThreads)
+{
+  updateThreads_ = std::max(1u, numThreads);
+}
+
+unsigned int MemoryDataStore::updateThreads() const
+{
+  return updateThreads_;
+}
+
+unsigned int MemoryDataStore::entityUpdateThreads_(bool callsInterpolator) const
+{
+  return callsInterpolator ? 1 : updateThreads_;
+}
+
+void MemoryDataStore::setIngestQueueCapacity(size_t capacity)
+{
+  if (capacity == 0)
+    ingestQueue_.reset();
+  else
+    ingestQueue_ = std::make_shared<IngestQueue>(capacity);
+}
+
+std::shared_ptr<IngestQueue> MemoryDataStore::ingestQueue() const
+{
+  return ingestQueue_;
+}
+
+void MemoryDataStore::drainIngestQueue_()
+{
+  std::map<ObjectId, double> updateTimes;
+  batchedUpdateTimes_ = &updateTimes;
+  ingestQueue_->drain([this](IngestQueue::Item& item) {
+    if (auto* platformUpdate = std::get_if<std::unique_ptr<PlatformUpdate> >(&item.data))
+      commitIngested(item.id, **platformUpdate, [this](ObjectId id, Transaction* t) { return addPlatformUpdate(id, t); });
+    else if (auto* beamUpdate = std::get_if<std::unique_ptr<BeamUpdate> >(&item.data))
+      commitIngested(item.id, **beamUpdate, [this](ObjectId id, Transaction* t) { return addBeamUpdate(id, t); });
+    else if (auto* gateUpdate = std::get_if<std::unique_ptr<GateUpdate> >(&item.data))
+      commitIngested(item.id, **gateUpdate, [this](ObjectId id, Transaction* t) { return addGateUpdate(id, t); });
+    else if (auto* categoryData = std::get_if<std::unique_ptr<CategoryData> >(&item.data))
+      commitIngested(item.id, **categoryData, [this](ObjectId id, Transaction* t) { return addCategoryData(id, t); });
+    else if (auto* genericData = std::get_if<std::unique_ptr<GenericData> >(&item.data))
+      commitIngested(item.id, **genericData, [this](ObjectId id, Transaction* t) { return addGenericData(id, t); });
+  });
+  batchedUpdateTimes_ = nullptr;
+
+  // Copy in case a listener removes itself
+  const auto listeners = newUpdatesListeners_;
+  for (const auto& [id, updateTime] : updateTimes)
+  {
+    for (const auto& listenerPtr : listeners)
+      listenerPtr->onEntityUpdate(this, id, updateTime);
+  }
+}
+
+void MemoryDataStore::notifyNewUpdate_(ObjectId id, double updateTime, double earliestTime)
+{
+  if (snapshotBuilder_)
+    snapshotBuilder_->onNewUpdate(id, earliestTime);
+  if (!platformPyramids_.empty())
+  {
+    auto it = platformPyramids_.find(id);
+    if (it != platformPyramids_.end())
+      it->second.changed(earliestTime);
+  }
+
+  if (batchedUpdateTimes_ != nullptr)
+  {
+    // Draining the ingest queue; the notification is sent once the drain completes
+    auto it = batchedUpdateTimes_->insert(std::make_pair(id, updateTime)).first;
+    it->second = std::max(it->second, updateTime);
+    return;
+  }
+
+  // Notify the data store's new-update callback
+  for (const auto& listenerPtr : newUpdatesListeners_)
+    listenerPtr->onEntityUpdate(this, id, updateTime);
+}
+
+template <typename EntryType, typename UpdateType>
+int MemoryDataStore::addUpdates_(ObjectId id, EntryType* entry, const std::vector<UpdateType>& updates)
+{
+  if (entry == nullptr)
+    return 1;
+  if (updates.empty())
+    return 0;
+
+  double earliestTime = updates.front().time();
+  double latestTime = earliestTime;
+  std::vector<UpdateType*> copies;
+  copies.reserve(updates.size());
+  for (const auto& update : updates)
+  {
+    copies.push_back(new UpdateType(update));
+    earliestTime = std::min(earliestTime, update.time());
+    latestTime = std::max(latestTime, update.time());
+  }
+  entry->updates()->insertMany(copies);
+
+  if (dataLimiting())
+  {
+    Transaction t;
+    const CommonPrefs* prefs = commonPrefs(id, &t);
+    if (prefs)
+      entry->updates()->limitByPrefs(*prefs);
+  }
+  hasChanged_ = true;
+  // The snapshot copies and pyramid levels must be redone from the earliest update, not just the latest
+  notifyNewUpdate_(id, latestTime, earliestTime);
+  return 0;
+}
+
+int MemoryDataStore::addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates)
+{
+  cachePlatformFrames_(id, updates);
+  return addUpdates_(id, getEntry<PlatformEntry, Platforms>(id, &platforms_), updates);
+}
+
+int MemoryDataStore::addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates)
+{
+  return addUpdates_(id, getEntry<BeamEntry, Beams>(id, &beams_), updates);
+}
+
+int MemoryDataStore::addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates)
+{
+  return addUpdates_(id, getEntry<GateEntry, Gates>(id, &gates_), updates);
+}
+
+int MemoryDataStore::addLaserUpdates(ObjectId id, const std::vector<LaserUpdate>& updates)
+{
+  return addUpdates_(id, getEntry<LaserEntry, Lasers>(id, &lasers_), updates);
+}
+
+int MemoryDataStore::addProjectorUpdates(ObjectId id, const std::vector<ProjectorUpdate>& updates)
+{
+  return addUpdates_(id, getEntry<ProjectorEntry, Projectors>(id, &projectors_), updates);
+}
+
+MemoryDataStore::PlatformEntry* MemoryDataStore::newPlatformEntry_()
+{
+  PlatformEntry* rv = nullptr;
+  if (updateStorage_ == UpdateStorage::COLUMNAR)
+    rv = new PlatformEntry(new ColumnarDataSlice<PlatformUpdate>(platformChunks_));
+  else if (updateStorage_ == UpdateStorage::TIERED)
+    rv = new PlatformEntry(new TieredDataSlice<PlatformUpdate>(coldStorageBudget_));
+  else
+    rv = new PlatformEntry();
+  rv->updates()->enableTimeIndex(timeIndexing_);
+  rv->updates()->setUpdateReclaimer(updateReclaimer_);
+  return rv;
+}
+
+MemoryDataStore::BeamEntry* MemoryDataStore::newBeamEntry_()
+{
+  BeamEntry* rv = nullptr;
+  if (updateStorage_ == UpdateStorage::COLUMNAR)
+    rv = new BeamEntry(new ColumnarDataSlice<BeamUpdate>(beamChunks_));
+  else if (updateStorage_ == UpdateStorage::TIERED)
+    rv = new BeamEntry(new TieredDataSlice<BeamUpdate>(coldStorageBudget_));
+  else
+    rv = new BeamEntry();
+  rv->updates()->enableTimeIndex(timeIndexing_);
+  rv->updates()->setUpdateReclaimer(updateReclaimer_);
+  return rv;
+}
+
+MemoryDataStore::GateEntry* MemoryDataStore::newGateEntry_()
+{
+  GateEntry* rv = nullptr;
+  if (updateStorage_ == UpdateStorage::COLUMNAR)
+    rv = new GateEntry(new ColumnarDataSlice<GateUpdate>(gateChunks_));
+  else if (updateStorage_ == UpdateStorage::TIERED)
+    rv = new GateEntry(new TieredDataSlice<GateUpdate>(coldStorageBudget_));
+  else
+    rv = new GateEntry();
+  rv->updates()->enableTimeIndex(timeIndexing_);
+  rv->updates()->setUpdateReclaimer(updateReclaimer_);
+  return rv;
+}
+
 void MemoryDataStore::updateTargetBeam_(ObjectId id, BeamEntry* beam, double time)
 {
   // Get the two platforms, if available
@@ -1753,22 +2489,25 @@ void MemoryDataStore::updateTargetBeam_(ObjectId id, BeamEntry* beam, double tim
     beam->updates()->clearChanged();
 }
 
-void MemoryDataStore::updateBeams_(double time)
+void MemoryDataStore::updateBeam_(ObjectId id, BeamEntry* beamEntry, double time)
 {
-  for (Beams::iterator iter = beams_.begin(); iter != beams_.end(); ++iter)
-  {
-    BeamEntry* beamEntry = iter->second;
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!beamEntry->preferences()->commonprefs().datadraw())
+    beamEntry->updates()->setCurrent(nullptr);
+  else if (beamEntry->properties()->type() == BeamProperties_BeamType_TARGET)
+    updateTargetBeam_(id, beamEntry, time);
+  else if (isInterpolationEnabled() && beamEntry->preferences()->interpolatebeampos())
+    beamEntry->updates()->update(time, interpolator_);
+  else
+    beamEntry->updates()->update(time);
+}
 
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!beamEntry->preferences()->commonprefs().datadraw())
-      beamEntry->updates()->setCurrent(nullptr);
-    else if (beamEntry->properties()->type() == BeamProperties_BeamType_TARGET)
-      updateTargetBeam_(iter->first, beamEntry, time);
-    else if (isInterpolationEnabled() && beamEntry->preferences()->interpolatebeampos())
-      beamEntry->updates()->update(time, interpolator_);
-    else
-      beamEntry->updates()->update(time);
-  }
+void MemoryDataStore::updateBeams_(double time)
+{
+  // Platforms are already updated, so target beams can read their hosts and targets from any thread
+  forEachEntry(entityUpdateThreads_(isInterpolationEnabled()), beams_, [this, time](ObjectId id, BeamEntry* beamEntry) {
+    updateBeam_(id, beamEntry, time);
+  });
 }
 
 simData::MemoryDataStore::BeamEntry* MemoryDataStore::getBeamForGate_(google::protobuf::uint64 gateID)
@@ -1887,65 +2626,72 @@ bool MemoryDataStore::gateUsesBeamBeamwidth_(GateEntry* gate) const
     (currentUpdate->height() <= 0.0 || currentUpdate->width() <= 0.0));
 }
 
-void MemoryDataStore::updateGates_(double time)
+void MemoryDataStore::updateGate_(GateEntry* gateEntry, double time)
 {
-  for (Gates::iterator iter = gates_.begin(); iter != gates_.end(); ++iter)
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!gateEntry->preferences()->commonprefs().datadraw())
+    gateEntry->updates()->setCurrent(nullptr);
+  else if (gateEntry->properties()->type() == GateProperties_GateType_TARGET)
+    updateTargetGate_(gateEntry, time);
+  else
   {
-    GateEntry* gateEntry = iter->second;
-
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!gateEntry->preferences()->commonprefs().datadraw())
-      gateEntry->updates()->setCurrent(nullptr);
-    else if (gateEntry->properties()->type() == GateProperties_GateType_TARGET)
-      updateTargetGate_(gateEntry, time);
+    if (isInterpolationEnabled() && gateEntry->preferences()->interpolategatepos())
+      gateEntry->updates()->update(time, interpolator_);
     else
-    {
-      if (isInterpolationEnabled() && gateEntry->preferences()->interpolategatepos())
-        gateEntry->updates()->update(time, interpolator_);
-      else
-        gateEntry->updates()->update(time);
+      gateEntry->updates()->update(time);
 
-      if (gateUsesBeamBeamwidth_(gateEntry))
-      {
-        // this gate depends on beam prefs; either
-        //   force an update of the gate every iteration, or
-        //   update gate when there is a change in beam pref height or width
+    if (gateUsesBeamBeamwidth_(gateEntry))
+    {
+      // this gate depends on beam prefs; either
+      //   force an update of the gate every iteration, or
+      //   update gate when there is a change in beam pref height or width
 
-        // force an update of the gate every iteration
-        gateEntry->updates()->setChanged();
-      }
+      // force an update of the gate every iteration
+      gateEntry->updates()->setChanged();
     }
   }
 }
 
+void MemoryDataStore::updateGates_(double time)
+{
+  // Beams are already updated, so gates can read their host beams from any thread
+  forEachEntry(entityUpdateThreads_(isInterpolationEnabled()), gates_, [this, time](ObjectId id, GateEntry* gateEntry) {
+    updateGate_(gateEntry, time);
+  });
+}
+
+void MemoryDataStore::updateLaser_(LaserEntry* laserEntry, double time)
+{
+  // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
+  if (!laserEntry->preferences()->commonprefs().datadraw())
+    laserEntry->updates()->setCurrent(nullptr);
+  // laser interpolation is on, there is no preference; but off if we have no interpolator
+  else if (isInterpolationEnabled())
+    laserEntry->updates()->update(time, interpolator_);
+  else
+    laserEntry->updates()->update(time);
+}
+
 void MemoryDataStore::updateLasers_(double time)
 {
-  for (Lasers::iterator iter = lasers_.begin(); iter != lasers_.end(); ++iter)
-  {
-    LaserEntry* laserEntry = iter->second;
+  forEachEntry(entityUpdateThreads_(isInterpolationEnabled()), lasers_, [this, time](ObjectId id, LaserEntry* laserEntry) {
+    updateLaser_(laserEntry, time);
+  });
+}
 
-    // until we have datadraw, send nullptr; once we have datadraw, we'll immediately update with valid data
-    if (!laserEntry->preferences()->commonprefs().datadraw())
-      laserEntry->updates()->setCurrent(nullptr);
-    // laser interpolation is on, there is no preference; but off if we have no interpolator
-    else if (isInterpolationEnabled())
-      laserEntry->updates()->update(time, interpolator_);
-    else
-      laserEntry->updates()->update(time);
-  }
+void MemoryDataStore::updateProjector_(ProjectorEntry* projectorEntry, double time)
+{
+  if (isInterpolationEnabled() && projectorEntry->preferences()->interpolateprojectorfov())
+    projectorEntry->updates()->update(time, interpolator_);
+  else
+    projectorEntry->updates()->update(time);
 }
 
 void MemoryDataStore::updateProjectors_(double time)
 {
-  for (Projectors::iterator iter = projectors_.begin(); iter != projectors_.end(); ++iter)
-  {
-    ProjectorEntry* projectorEntry = iter->second;
-
-    if (isInterpolationEnabled() && projectorEntry->preferences()->interpolateprojectorfov())
-      projectorEntry->updates()->update(time, interpolator_);
-    else
-      projectorEntry->updates()->update(time);
-  }
+  forEachEntry(entityUpdateThreads_(isInterpolationEnabled()), projectors_, [this, time](ObjectId id, ProjectorEntry* projectorEntry) {
+    updateProjector_(projectorEntry, time);
+  });
 }
 
 void MemoryDataStore::updateLobGroups_(double time)
@@ -2143,6 +2889,9 @@ simData::PlatformPrefs MemoryDataStore::defaultPlatformPrefs() const
 ///Update internal data to show 'time' as current
 void MemoryDataStore::update(double time)
 {
+  if (ingestQueue_)
+    drainIngestQueue_();
+
   if (!hasChanged_ && time == lastUpdateTime_)
     return;
 
@@ -2155,6 +2904,7 @@ void MemoryDataStore::update(double time)
 
   std::vector<simData::ObjectId> ids;
   sliceCacheObserver_->updateCategoryData_(time, ids);
+  updateCategoryValues_(ids);
 
   sliceCacheObserver_->updatePlatforms_(time);
   updateBeams_(time);
@@ -2190,6 +2940,23 @@ void MemoryDataStore::update(double time)
       checkForRemoval_(localCopy);
     }
   }
+
+  if (!batchListeners_.empty())
+    fireBatchListeners_();
+}
+
+void MemoryDataStore::fireBatchListeners_()
+{
+  ChangeSet changes;
+  changeSetCollector_->take(changes);
+
+  // Listeners may add or remove batch listeners, so work from a copy and skip any removed along the way
+  const auto localCopy = batchListeners_;
+  for (const auto& listener : localCopy)
+  {
+    if (std::find(batchListeners_.begin(), batchListeners_.end(), listener) != batchListeners_.end())
+      listener->onChanges(this, changes);
+  }
 }
 
 void MemoryDataStore::invokePreferenceChangeCallback_(const std::map<simData::ObjectId, CommitResult>& results, ListenerList& localCopy)
@@ -2316,6 +3083,15 @@ int MemoryDataStore::flush(ObjectId id, FlushScope scope, FlushFields fields, do
     flushEntity_(id, type, scope, fields, startTime, endTime);
   }
 
+  // Slices do not report categories emptied by a flush, so refresh every row on the next update
+  if ((fields & FLUSH_CATEGORY_DATA) != 0)
+    categoryValuesDirty_ = true;
+
+  // Track pyramids of flushed platforms are rebuilt on their next use
+  if (id == 0 && scope == FLUSH_RECURSIVE)
+    platformPyramids_.clear();
+  else
+    platformPyramids_.erase(id);
   hasChanged_ = true;
 
   // Need to handle recursion so make a local copy
@@ -2488,6 +3264,38 @@ void MemoryDataStore::idListByName(const std::string& name, IdList* ids, simData
     ids->push_back((*it)->id());
 }
 
+/// Retrieve a list of IDs for objects of 'type' whose name matches the text
+void MemoryDataStore::idListByNameSearch(const std::string& text, NameSearch search, bool caseSensitive, IdList* ids, simData::ObjectType type) const
+{
+  if (ids == nullptr)
+    return;
+  ids->clear();
+
+  assert(entityNameCache_ != nullptr);
+  if (entityNameCache_ == nullptr)
+    return;
+
+  EntityNameIndex::Match match = EntityNameIndex::Match::EXACT;
+  switch (search)
+  {
+  case NameSearch::EXACT:
+    match = EntityNameIndex::Match::EXACT;
+    break;
+  case NameSearch::PREFIX:
+    match = EntityNameIndex::Match::PREFIX;
+    break;
+  case NameSearch::SUBSTRING:
+    match = EntityNameIndex::Match::SUBSTRING;
+    break;
+  }
+
+  std::vector<const EntityNameEntry*> entries;
+  entityNameCache_->findEntries(text, match, caseSensitive, type, entries);
+  ids->reserve(entries.size());
+  for (const EntityNameEntry* entry : entries)
+    ids->push_back(entry->id());
+}
+
 
 /// Retrieve a list of IDs for objects with the given original id
 void MemoryDataStore::idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type) const
@@ -2545,21 +3353,7 @@ void MemoryDataStore::idListForHost_(ObjectId hostid, simData::ObjectType inType
 ///Retrieves the ObjectType for a particular ID
 simData::ObjectType MemoryDataStore::objectType(ObjectId id) const
 {
-  if (platforms_.find(id) != platforms_.end())
-    return simData::PLATFORM;
-  if (beams_.find(id) != beams_.end())
-    return simData::BEAM;
-  if (gates_.find(id) != gates_.end())
-    return simData::GATE;
-  if (lasers_.find(id) != lasers_.end())
-    return simData::LASER;
-  if (projectors_.find(id) != projectors_.end())
-    return simData::PROJECTOR;
-  if (lobGroups_.find(id) != lobGroups_.end())
-    return simData::LOB_GROUP;
-  if (customRenderings_.find(id) != customRenderings_.end())
-    return simData::CUSTOM_RENDERING;
-  return simData::NONE;
+  return entityRegistry_.type(id);
 }
 
 ///Retrieves the host ID for an entity; returns 0 for platforms, or for not found
@@ -2617,7 +3411,7 @@ PlatformProperties* MemoryDataStore::addPlatform(Transaction *transaction)
   PlatformProperties* rv = addEntry<PlatformEntry,
                               PlatformProperties,
                               NewEntryTransactionImpl<PlatformEntry, PlatformPrefs>,
-                              ListenerList>(id, &platforms_, this, transaction, &listeners_, &defaultPlatformPrefs_);
+                              ListenerList>(id, &platforms_, this, transaction, &listeners_, &defaultPlatformPrefs_, newPlatformEntry_());
   entityNameCache_->addEntity(defaultPlatformPrefs_.commonprefs().name(), id, simData::PLATFORM);
   return rv;
 }
@@ -2633,7 +3427,7 @@ BeamProperties* MemoryDataStore::addBeam(Transaction *transaction)
   BeamProperties* rv = addEntry<BeamEntry,
                           BeamProperties,
                           NewEntryTransactionImpl<BeamEntry, BeamPrefs>,
-                          ListenerList>(id, &beams_, this, transaction, &listeners_, &defaultBeamPrefs_);
+                          ListenerList>(id, &beams_, this, transaction, &listeners_, &defaultBeamPrefs_, newBeamEntry_());
   entityNameCache_->addEntity(defaultBeamPrefs_.commonprefs().name(), id, simData::BEAM);
   return rv;
 }
@@ -2649,7 +3443,7 @@ GateProperties* MemoryDataStore::addGate(Transaction *transaction)
   GateProperties* rv = addEntry<GateEntry,
                           GateProperties,
                           NewEntryTransactionImpl<GateEntry, GatePrefs>,
-                          ListenerList>(id, &gates_, this, transaction, &listeners_, &defaultGatePrefs_);
+                          ListenerList>(id, &gates_, this, transaction, &listeners_, &defaultGatePrefs_, newGateEntry_());
   entityNameCache_->addEntity(defaultGatePrefs_.commonprefs().name(), id, simData::GATE);
   return rv;
 }
@@ -2734,6 +3528,7 @@ void MemoryDataStore::removeEntity(ObjectId id)
   }
 
   entityNameCache_->removeEntity(simData::DataStoreHelpers::nameFromId(id, this), id, ot);
+  platformPyramids_.erase(id);
 
   // do not delete the objects pointed to by the GD and CD maps
   // those pointers point into regions of the entity structure - not objects on the heap
@@ -2745,8 +3540,7 @@ void MemoryDataStore::removeEntity(ObjectId id)
 
   // once we've found the item in an entity-type list, we are done
 
-  Platforms::iterator pi = platforms_.find(id);
-  if (pi != platforms_.end())
+  if (platforms_.find(id) != platforms_.end())
   {
     // also delete everything attached to the platform
     // we will need to send notifications and recurse on them as well...
@@ -2759,14 +3553,15 @@ void MemoryDataStore::removeEntity(ObjectId id)
     for (IdList::const_iterator i = ids.begin(); i != ids.end(); ++i)
       removeEntity(*i);
 
+    // Removals move items between slots, so find the platform again
+    Platforms::iterator pi = platforms_.find(id);
     delete pi->second;
     platforms_.erase(pi);
     fireOnPostRemoveEntity_(id, ot);
     return;
   }
 
-  Beams::iterator bi = beams_.find(id);
-  if (bi != beams_.end())
+  if (beams_.find(id) != beams_.end())
   {
     // also delete any gates or projectors; projectorIdListForHost adds to the list
     gateIdListForHost(id, &ids);
@@ -2775,6 +3570,7 @@ void MemoryDataStore::removeEntity(ObjectId id)
     for (IdList::const_iterator i = ids.begin(); i != ids.end(); ++i)
       removeEntity(*i);
 
+    Beams::iterator bi = beams_.find(id);
     delete bi->second;
     beams_.erase(bi);
     fireOnPostRemoveEntity_(id, ot);
@@ -3737,6 +4533,27 @@ void MemoryDataStore::removeNewUpdatesListener(NewUpdatesListenerPtr callback)
     static_cast<MemoryTable::TableManager*>(dataTableManager_)->setNewRowDataListener({});
 }
 
+void MemoryDataStore::addBatchListener(BatchListenerPtr callback)
+{
+  if (!callback || (std::find(batchListeners_.begin(), batchListeners_.end(), callback) != batchListeners_.end()))
+    return;
+
+  batchListeners_.push_back(callback);
+  // Only collect changes while someone will receive them
+  changeSetCollector_->setEnabled(true);
+}
+
+void MemoryDataStore::removeBatchListener(BatchListenerPtr callback)
+{
+  auto iter = std::find(batchListeners_.begin(), batchListeners_.end(), callback);
+  if (iter == batchListeners_.end())
+    return;
+  batchListeners_.erase(iter);
+
+  if (batchListeners_.empty())
+    changeSetCollector_->setEnabled(false);
+}
+
 CategoryNameManager& MemoryDataStore::categoryNameManager() const
 {
   return *categoryNameManager_;
@@ -3760,10 +4577,10 @@ void MemoryDataStore::deleteEntries_(EntryMapType *entries)
   entries->clear();
 }
 
-template <typename EntryMapType>
-void MemoryDataStore::dataLimit_(std::map<ObjectId, EntryMapType* >& entryMap, ObjectId id, const CommonPrefs* prefs)
+template <typename EntryType>
+void MemoryDataStore::dataLimit_(EntitySlots<EntryType*>& entryMap, ObjectId id, const CommonPrefs* prefs)
 {
-  typename std::map<ObjectId, EntryMapType *>::const_iterator iter = entryMap.find(id);
+  typename EntitySlots<EntryType*>::const_iterator iter = entryMap.find(id);
   if (iter == entryMap.end())
     return;
   // limit updates and commands
@@ -4003,7 +4820,7 @@ void MemoryDataStore::NewEntryTransactionImpl<T, P>::commit()
     P* mutablePrefs = entry_->mutable_preferences();
     mutablePrefs->CopyFrom(*defaultPrefs_);
 
-    typename std::map<ObjectId, T*>::iterator i = entries_->find(entry_->properties()->id());
+    typename EntitySlots<T*>::iterator i = entries_->find(entry_->properties()->id());
     if (i == entries_->end())
       (*entries_)[entry_->properties()->id()] = entry_;
     else
@@ -4089,11 +4906,7 @@ void MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::commit()
     }
     dataStore_->hasChanged_ = true;
     if (isEntityUpdate_)
-    {
-      // Notify the data store's new-update callback
-      for (const auto& listenerPtr : dataStore_->newUpdatesListeners_)
-        listenerPtr->onEntityUpdate(dataStore_, id_, updateTime);
-    }
+      dataStore_->notifyNewUpdate_(id_, updateTime, updateTime);
   }
 }
 
@@ -4105,6 +4918,17 @@ void MemoryDataStore::NewUpdateTransactionImpl<T, SliceType>::insert_()
   slice_->insert(update_);
 }
 
+/// Specialization for platforms to compute the coordinate frames of the update when caching frames
+template <>
+void MemoryDataStore::NewUpdateTransactionImpl<PlatformUpdate, MemoryDataSlice<PlatformUpdate> >::insert_()
+{
+  // Compute before the insert, which may delete update_
+  PlatformFrameCache* frames = dataStore_->sliceCacheObserver_->platformFrames(id_);
+  if (frames != nullptr)
+    frames->add(*update_);
+  slice_->insert(update_);
+}
+
 /// Specialization for Generic Data to permit use of ignore-duplicate-generic-data flag on insert
 template <>
 void MemoryDataStore::NewUpdateTransactionImpl<simData::GenericData, simData::MemoryGenericDataSlice>::insert_()
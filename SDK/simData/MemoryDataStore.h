@@ -24,16 +24,28 @@
 #define SIMDATA_MEMORYDATASTORE_H
 
 #include <map>
+#include <memory>
 #include <string>
 #include "simData/MemoryDataEntry.h"
 #include "simData/DataStore.h"
+#include "simData/DecimationPyramid.h"
+#include "simData/EntityRegistry.h"
+#include "simData/CategoryData/CategoryValueTable.h"
 
 namespace simCore { class Clock; }
 
 namespace simData {
 
+template <typename T> class ColumnChunkPool;
+class DataStoreSnapshot;
+class DataStoreSnapshotBuilder;
 class EntityNameCache;
 class GenericDataSlice;
+class IngestQueue;
+class PlatformFrameCache;
+class StringPool;
+class UpdateReclaimer;
+struct PlatformFrames;
 class MemoryCategoryDataSlice;
 namespace MemoryTable { class DataLimitsProvider; }
 
@@ -126,6 +138,175 @@ public:
   /// Returns the interpolation state
   virtual InterpolatorState interpolatorState() const override;
 
+  /**@name Update Storage
+   * @{
+   */
+  /// Storage layouts available for the update slices of platforms, beams and gates
+  enum class UpdateStorage
+  {
+    DEQUE,    ///< Each update is allocated separately and referenced from a std::deque; the default
+    COLUMNAR, ///< Updates are copied into pooled structure-of-arrays chunks; see ColumnarDataSlice
+    TIERED    ///< Like DEQUE, but data limiting compresses old updates into a cold tier instead of deleting them; see TieredDataSlice
+  };
+
+  /**
+   * Sets the storage layout for the update slices of platforms, beams and gates.  Only entities
+   * added after the call are affected; existing entities keep their storage.
+   */
+  void setUpdateStorage(UpdateStorage storage);
+  /// Returns the storage layout used for new platform, beam and gate update slices
+  UpdateStorage updateStorage() const;
+
+  /**
+   * Sets the bytes of compressed cold storage each TIERED update slice may hold.  The data limits
+   * in the prefs set the size of the hot tier; once the cold tier exceeds this budget, its oldest
+   * updates are discarded.  Only entities added after the call are affected.
+   */
+  void setColdStorageBudget(size_t bytesPerEntity);
+  /// Returns the bytes of cold storage for each new TIERED update slice
+  size_t coldStorageBudget() const;
+
+  /**
+   * Reports the approximate memory used by the update slice of a platform, beam or gate, split into
+   * the hot and cold tiers.  Slices that are not TIERED report all of their memory as hot.
+   * @param id Platform, beam or gate
+   * @param hotBytes Bytes used by the slice and its uncompressed updates
+   * @param coldBytes Bytes used by the compressed updates; 0 unless the slice is TIERED
+   * @return 0 on success, non-zero if id is not a platform, beam or gate
+   */
+  int updateMemoryUsage(ObjectId id, size_t& hotBytes, size_t& coldBytes) const;
+
+  /**
+   * Enables a TimeBucketIndex in the update slices of platforms, beams and gates, so that random time
+   * jumps, such as scrubbing the time slider, resolve in near constant time instead of a binary search.
+   * Costs about one size_t per two updates.  Only entities added after the call are affected.  The
+   * COLUMNAR storage searches its own time columns and ignores the setting.
+   */
+  void setTimeIndexing(bool enable);
+  /// Returns true if new platform, beam and gate update slices have a time index
+  bool timeIndexing() const;
+
+  /**
+   * Destroys platform, beam and gate updates removed by data limiting and flushes on a background
+   * thread owned by the data store, instead of on the calling thread.  Helps on hosts with a spare
+   * core when large batches are removed at once; costs a copy of the removed pointers.  Disabled
+   * by default.  Applies to existing and new entities; disabling waits for queued batches.
+   */
+  void setUpdateReclaiming(bool enable);
+  /// Returns true if removed updates are destroyed on a background thread
+  bool updateReclaiming() const;
+
+  /**
+   * Keeps the ECEF, geodetic and quaternion frames of every platform update, computed once as the
+   * update is inserted, so that the internal interpolator does not convert the bracketing updates
+   * each time the bracket changes and displays can draw the current state without converting it
+   * again.  addPlatformUpdates() computes the frames on the update threads, if any.  Frames of
+   * removed updates are dropped by the next update(double).  Costs about 176 bytes per update.
+   * Only platforms added after the call are affected.
+   */
+  void setPlatformFrameCaching(bool enable);
+  /// Returns true if new platforms cache the frames of their updates
+  bool platformFrameCaching() const;
+  /// Returns the frame cache of the platform, or nullptr if the platform does not exist or does not cache frames
+  const PlatformFrameCache* platformFrameCache(ObjectId id) const;
+  /// Returns the frames of the platform's current state, or nullptr if there is no current state or no frame cache
+  const PlatformFrames* currentPlatformFrames(ObjectId id) const;
+
+  /**
+   * Interns generic data values in one reference counted string pool shared by all entities,
+   * instead of the default scheme that shares only recently repeated values.  Suited to feeds with
+   * many distinct values: each value is stored once in arena chunks, even if repeated across
+   * entities, and reclaimed as soon as data limiting removes its last use.  Existing generic data
+   * is converted, as is that of entities added later.
+   */
+  void setGenericDataStringPooling(bool enable);
+  /// Returns true if generic data values are interned in the string pool
+  bool genericDataStringPooling() const;
+  /// Returns the approximate number of bytes of generic data held for the entity, or the scenario for 0; 0 if there is no such entity
+  size_t genericDataMemoryUsage(ObjectId id) const;
+  /// Returns the approximate number of bytes used by the generic data string pool itself; 0 if not pooling
+  size_t genericDataStringPoolMemoryUsage() const;
+  ///@}
+
+  /**@name Parallel Update
+   * @{
+   */
+  /**
+   * Sets the largest number of threads used by update(double) to update the platform, beam, gate,
+   * laser and projector slices.  The count includes the calling thread; 0 or 1 updates serially,
+   * which is the default.  The threads come from the process-wide simCore::parallelFor() pool, so
+   * fewer may be used on hosts with fewer hardware threads.  Hosts are always updated before the
+   * beams and gates that depend on them, and listener callbacks are always made from the thread
+   * that calls update(double), in the same order as a serial update.  The Interpolator given to
+   * setInterpolator() is also only called from that thread, so entity types that use it update
+   * serially while interpolation is enabled.
+   */
+  void setUpdateThreads(unsigned int numThreads);
+  /// Returns the largest number of threads used by update(double), including the calling thread
+  unsigned int updateThreads() const;
+  ///@}
+
+  /**@name Ingest Queue
+   * @{
+   */
+  /**
+   * Creates a queue that accepts updates and category/generic data from any thread.  The queue is
+   * drained at the start of every update(double): items are committed in the order they were pushed,
+   * and each NewUpdatesListener hears about each entity at most once per drain, with the latest time.
+   * Items for entities that do not exist are discarded.  Replacing the queue discards its contents.
+   * @param capacity Maximum number of items held between updates; 0 removes the queue
+   */
+  void setIngestQueueCapacity(size_t capacity);
+  /** Returns the ingest queue, or nullptr if there is none.  Producers may hold on to the pointer to keep the queue alive */
+  std::shared_ptr<IngestQueue> ingestQueue() const;
+  ///@}
+
+  /**@name Snapshots
+   * @{
+   */
+  /**
+   * Returns an immutable copy of the entities, properties, prefs, update slices and data tables as
+   * they are now, which may be read from other threads while this data store continues to update.
+   * Consecutive snapshots share the copies of everything that did not change in between, so taking
+   * a snapshot after each update(double) only copies what that update changed.  Must be called from
+   * the thread that modifies the data store.  Category and generic data are not included.
+   */
+  std::shared_ptr<const DataStoreSnapshot> createSnapshot();
+  ///@}
+
+  /**@name Track Decimation
+   * @{
+   */
+  /**
+   * Retrieves at most maxPoints representative updates of the platform after beginTime (inclusive)
+   * until endTime (exclusive), for drawing a long track history at screen resolution.  If the range
+   * holds no more than maxPoints updates, all of them are returned.  Otherwise the range is split
+   * into maxPoints / 8 equal buckets, and the first and last update of each bucket are returned
+   * with the updates that have the smallest and largest ECEF X, Y and Z.  The first call for a
+   * platform builds a min/max pyramid over its updates; the pyramid is extended as new updates
+   * arrive and trimmed as data limiting removes old ones, so later calls cost about the same
+   * however long the history grows.
+   * @param id Platform ID
+   * @param beginTime Inclusive start of the time range
+   * @param endTime Exclusive end of the time range
+   * @param maxPoints Maximum number of updates to return; at least 8
+   * @param updates Receives copies of the updates in time order
+   * @return 0 on success, non-zero if the ID is not a platform or maxPoints is less than 8
+   */
+  int decimatePlatformUpdates(ObjectId id, double beginTime, double endTime, size_t maxPoints, std::vector<PlatformUpdate>& updates);
+  ///@}
+
+  /**@name Category Values
+   * @{
+   */
+  /**
+   * Returns the current category values of every entity as of the last update(), one row per
+   * entity, for evaluating a CompiledCategoryFilter against all entities at once.  The table is
+   * kept current by update(); copy it to read it from another thread.
+   */
+  const CategoryValueTable& categoryValueTable() const;
+  ///@}
+
   /**@name ID Lists
    * @{
    */
@@ -138,6 +319,9 @@ public:
   /// Retrieve a list of IDs for objects of 'type' with the given name
   virtual void idListByName(const std::string& name, IdList* ids, simData::ObjectType type = simData::ALL) const override;
 
+  /// Retrieve a list of IDs for objects of 'type' whose name matches the text, in no particular order
+  virtual void idListByNameSearch(const std::string& text, NameSearch search, bool caseSensitive, IdList* ids, simData::ObjectType type = simData::ALL) const override;
+
   /// Retrieve a list of IDs for objects with the given original id
   virtual void idListByOriginalId(IdList *ids, uint64_t originalId, simData::ObjectType type = simData::ALL) const override;
 
@@ -283,6 +467,17 @@ public:
   virtual CategoryData *addCategoryData(ObjectId id, Transaction *transaction) override;
   ///@}
 
+  /**@name Add many data updates to one entity at once
+   * @see simData::DataStore::addPlatformUpdates()
+   * @{
+   */
+  virtual int addPlatformUpdates(ObjectId id, const std::vector<PlatformUpdate>& updates) override;
+  virtual int addBeamUpdates(ObjectId id, const std::vector<BeamUpdate>& updates) override;
+  virtual int addGateUpdates(ObjectId id, const std::vector<GateUpdate>& updates) override;
+  virtual int addLaserUpdates(ObjectId id, const std::vector<LaserUpdate>& updates) override;
+  virtual int addProjectorUpdates(ObjectId id, const std::vector<ProjectorUpdate>& updates) override;
+  ///@}
+
   /**@name Retrieving read-only data slices
    * @note No locking performed for read-only update slice objects
    * @{
@@ -348,6 +543,14 @@ public:
   virtual void removeNewUpdatesListener(NewUpdatesListenerPtr callback) override;
   ///@}
 
+  /**@name BatchListener
+  * @{
+  */
+  /// Add or remove a listener for the change set of each update()
+  virtual void addBatchListener(BatchListenerPtr callback) override;
+  virtual void removeBatchListener(BatchListenerPtr callback) override;
+  ///@}
+
   /**@name Get a handle to the CategoryNameManager
    * @{
    */
@@ -377,12 +580,14 @@ private:
   /// apply data limiting for this entity
   void applyDataLimiting_(ObjectId id);
 
-  template <typename EntryMapType>
-  void dataLimit_(std::map<ObjectId, EntryMapType*>& entryMap, ObjectId id, const CommonPrefs* prefs);
+  template <typename EntryType>
+  void dataLimit_(EntitySlots<EntryType*>& entryMap, ObjectId id, const CommonPrefs* prefs);
   ///@}
 
   /// Execute the onPostRemoveEntity callback
   void fireOnPostRemoveEntity_(ObjectId id, ObjectType ot);
+  /// Passes the collected change set to the batch listeners
+  void fireBatchListeners_();
 
   /// Check to see if a Listener got removed during a callback
   void checkForRemoval_(ListenerList& list);
@@ -410,24 +615,32 @@ public:
   /// CustomRenderingEntry
   typedef MemoryDataEntry<CustomRenderingProperties,       CustomRenderingPrefs,       MemoryDataSlice<CustomRenderingUpdate>,       MemoryCommandSlice<CustomRenderingCommand, CustomRenderingPrefs> >     CustomRenderingEntry;
 
-  /// Map of entity IDs to platform entries
-  typedef std::map<ObjectId, PlatformEntry*>           Platforms;
-  /// Map of entity IDs to beam entries
-  typedef std::map<ObjectId, BeamEntry*>               Beams;
-  /// Map of entity IDs to gate entries
-  typedef std::map<ObjectId, GateEntry*>               Gates;
-  /// Map of entity IDs to laser entries
-  typedef std::map<ObjectId, LaserEntry*>              Lasers;
-  /// Map of entity IDs to projector entries
-  typedef std::map<ObjectId, ProjectorEntry*>          Projectors;
-  /// Map of entity IDs to LOB Group entries
-  typedef std::map<ObjectId, LobGroupEntry*>           LobGroups;
-  /// Map of entity IDs to custom entries
-  typedef std::map<ObjectId, CustomRenderingEntry*>    CustomRenderings;
-  /// Map of entity IDs to generic data entries
-  typedef std::map<ObjectId, MemoryGenericDataSlice*>  GenericDataMap;
-  /// Map of entity IDs to category data entries
-  typedef std::map<ObjectId, MemoryCategoryDataSlice*> CategoryDataMap;
+  /// Slots of platform entries, indexed by entityRegistry_
+  typedef EntitySlots<PlatformEntry*>           Platforms;
+  /// Slots of beam entries, indexed by entityRegistry_
+  typedef EntitySlots<BeamEntry*>               Beams;
+  /// Slots of gate entries, indexed by entityRegistry_
+  typedef EntitySlots<GateEntry*>               Gates;
+  /// Slots of laser entries, indexed by entityRegistry_
+  typedef EntitySlots<LaserEntry*>              Lasers;
+  /// Slots of projector entries, indexed by entityRegistry_
+  typedef EntitySlots<ProjectorEntry*>          Projectors;
+  /// Slots of LOB Group entries, indexed by entityRegistry_
+  typedef EntitySlots<LobGroupEntry*>           LobGroups;
+  /// Slots of custom entries, indexed by entityRegistry_
+  typedef EntitySlots<CustomRenderingEntry*>    CustomRenderings;
+  /// Slots of generic data entries, including the scenario's at ID 0, indexed by entityRegistry_
+  typedef EntitySlots<MemoryGenericDataSlice*>  GenericDataMap;
+  /// Slots of category data entries, indexed by entityRegistry_
+  typedef EntitySlots<MemoryCategoryDataSlice*> CategoryDataMap;
+
+protected:
+  /// Creates a platform entry whose update slice matches updateStorage_
+  virtual PlatformEntry* newPlatformEntry_();
+  /// Creates a beam entry whose update slice matches updateStorage_
+  virtual BeamEntry* newBeamEntry_();
+  /// Creates a gate entry whose update slice matches updateStorage_
+  virtual GateEntry* newGateEntry_();
 
 
 private:
@@ -549,7 +762,7 @@ private:
   class NewEntryTransactionImpl : public TransactionImpl
   {
   public:
-    NewEntryTransactionImpl(T *entry, std::map<ObjectId, T *> *entries, MemoryDataStore *store, ListenerList *listeners, const P *defaultPrefs, uint64_t initialId)
+    NewEntryTransactionImpl(T *entry, EntitySlots<T *> *entries, MemoryDataStore *store, ListenerList *listeners, const P *defaultPrefs, uint64_t initialId)
       : committed_(false),
         notified_(false),
         entry_(entry),
@@ -576,7 +789,7 @@ private:
     bool committed_;                              // The entry has been added to the data structure
     bool notified_;                               // Observers have been notified for the new entry's commit
     T *entry_;                                    // Type such as PlatformEntry, BeamEntry, GateEntry, LaserEntry, ProjectorEntry, LobGroupEntry
-    std::map<ObjectId, T *> *entries_;            // Matches Platforms, Beams, Gates, Lasers, Projectors, or LobGroups internal typedef
+    EntitySlots<T *> *entries_;                   // Matches Platforms, Beams, Gates, Lasers, Projectors, or LobGroups internal typedef
     MemoryDataStore *store_;                      // Data store which will receive the new entity on commit
     ListenerList *listeners_;                     // Listeners from the data store which need to be notified
     const P *defaultPrefs_;                       // Default prefs values for initializing prefs on entity creation
@@ -666,8 +879,12 @@ private:
   /// Clean up memory
   void clearMemory_();
 
+  /// Threads for one pass of update(double); 1 if the pass calls the Interpolator, which need not be thread safe
+  unsigned int entityUpdateThreads_(bool callsInterpolator) const;
   /// Updates a target beam
   void updateTargetBeam_(ObjectId id, BeamEntry* beam, double time);
+  /// Updates a single beam; safe to call for different beams at the same time
+  void updateBeam_(ObjectId id, BeamEntry* beam, double time);
   /// Updates all the beams
   void updateBeams_(double time);
   /// Gets the beam that corresponds to specified gate
@@ -682,14 +899,35 @@ private:
   */
   bool gateUsesBeamBeamwidth_(GateEntry* gate) const;
 
+  /// Updates a single gate; safe to call for different gates at the same time
+  void updateGate_(GateEntry* gate, double time);
   /// Updates all the gates
   void updateGates_(double time);
+  /// Updates a single laser; safe to call for different lasers at the same time
+  void updateLaser_(LaserEntry* laser, double time);
   /// Updates all the lasers
   void updateLasers_(double time);
+  /// Updates a single projector; safe to call for different projectors at the same time
+  void updateProjector_(ProjectorEntry* projector, double time);
   /// Updates all the projectors
   void updateProjectors_(double time);
   /// Updates all the LobGroups
   void updateLobGroups_(double time);
+  /// Refreshes the rows of categoryValues_ for the entities whose category data changed, or all rows after a flush
+  void updateCategoryValues_(const std::vector<ObjectId>& changedIds);
+  /// Commits the contents of the ingest queue, notifying the NewUpdatesListeners once per entity
+  void drainIngestQueue_();
+  /**
+   * Tells the NewUpdatesListeners about new updates, or records them for later if draining the ingest queue.
+   * updateTime is the latest time of the updates added, and earliestTime the earliest, from which cached
+   * copies of the data must be redone.
+   */
+  void notifyNewUpdate_(ObjectId id, double updateTime, double earliestTime);
+  /// Computes the frames of the updates for the platform's frame cache, if it has one
+  void cachePlatformFrames_(ObjectId id, const std::vector<PlatformUpdate>& updates);
+  /// Implements the add*Updates() methods for the entry's update slice
+  template <typename EntryType, typename UpdateType>
+  int addUpdates_(ObjectId id, EntryType* entry, const std::vector<UpdateType>& updates);
   /// Flushes an entity based on the given scope, fields and time ranges
   void flushEntity_(ObjectId id, simData::ObjectType type, FlushScope flushScope, FlushFields flushFields, double startTime, double endTime);
   /// Flushes an entity's data tables
@@ -720,17 +958,54 @@ private:
   InterpolatorState interpolationEnabled_ = InterpolatorState::OFF;
   Interpolator *interpolator_;
 
+  /// Storage layout for new platform, beam and gate update slices
+  UpdateStorage updateStorage_ = UpdateStorage::DEQUE;
+  /// Bytes of cold storage for each new TIERED update slice
+  size_t coldStorageBudget_ = 1024 * 1024;
+  /// True if new platform, beam and gate update slices have a time index
+  bool timeIndexing_ = false;
+  /// Destroys removed platform, beam and gate updates; nullptr if they are deleted inline
+  std::shared_ptr<UpdateReclaimer> updateReclaimer_;
+  /// True if new platforms cache the frames of their updates
+  bool platformFrameCaching_ = false;
+  /// Pool shared by the generic data slices to intern their values; nullptr if not pooling
+  std::shared_ptr<StringPool> genericDataStringPool_;
+  /// Chunks shared by the columnar platform update slices
+  std::shared_ptr<ColumnChunkPool<PlatformUpdate> > platformChunks_;
+  /// Chunks shared by the columnar beam update slices
+  std::shared_ptr<ColumnChunkPool<BeamUpdate> > beamChunks_;
+  /// Chunks shared by the columnar gate update slices
+  std::shared_ptr<ColumnChunkPool<GateUpdate> > gateChunks_;
+
+  /// Largest number of threads for update(double), including the calling thread; 1 updates serially
+  unsigned int updateThreads_ = 1;
+
+  /// Queue drained at the start of update(double); may be nullptr
+  std::shared_ptr<IngestQueue> ingestQueue_;
+  /// Tracks changes between snapshots; created by the first createSnapshot()
+  std::unique_ptr<DataStoreSnapshotBuilder> snapshotBuilder_;
+  /// Min/max pyramids over the ECEF positions of platform updates, created by decimatePlatformUpdates()
+  std::map<ObjectId, DecimationPyramid<3> > platformPyramids_;
+  /// Current category values of every entity, refreshed by update()
+  CategoryValueTable categoryValues_;
+  /// True when a flush removed category data, so update() must refresh every row of categoryValues_
+  bool categoryValuesDirty_ = false;
+  /// While draining the ingest queue, the latest new update time of each entity; nullptr otherwise
+  std::map<ObjectId, double>* batchedUpdateTimes_ = nullptr;
+
   // all the data
   ScenarioProperties properties_;
-  Platforms          platforms_;
-  Beams              beams_;
-  Gates              gates_;
-  Lasers             lasers_;
-  Projectors         projectors_;
-  LobGroups          lobGroups_;
-  CustomRenderings   customRenderings_;
-  GenericDataMap     genericData_;  // Map to hold references for GenericData update slice contained by the DataEntry object with the associated id
-  CategoryDataMap    categoryData_; // Map to hold references for CategoryData update slice contained by the DataEntry object with the associated id
+  /// Type and slots of every entity; must be declared before the containers that register in it
+  EntityRegistry     entityRegistry_;
+  Platforms          platforms_{ entityRegistry_, EntityRegistry::ENTITY, PLATFORM };
+  Beams              beams_{ entityRegistry_, EntityRegistry::ENTITY, BEAM };
+  Gates              gates_{ entityRegistry_, EntityRegistry::ENTITY, GATE };
+  Lasers             lasers_{ entityRegistry_, EntityRegistry::ENTITY, LASER };
+  Projectors         projectors_{ entityRegistry_, EntityRegistry::ENTITY, PROJECTOR };
+  LobGroups          lobGroups_{ entityRegistry_, EntityRegistry::ENTITY, LOB_GROUP };
+  CustomRenderings   customRenderings_{ entityRegistry_, EntityRegistry::ENTITY, CUSTOM_RENDERING };
+  GenericDataMap     genericData_{ entityRegistry_, EntityRegistry::GENERIC_DATA };  // References to the GenericData update slice contained by the DataEntry object with the associated id
+  CategoryDataMap    categoryData_{ entityRegistry_, EntityRegistry::CATEGORY_DATA }; // References to the CategoryData update slice contained by the DataEntry object with the associated id
 
   /// To improve performance keep track of children entities by host
   class HostChildCache;
@@ -738,6 +1013,8 @@ private:
   class OriginalIdCache;
   /// Improve performance by caching the slice state
   class SliceCacheObserver;
+  /// Consolidates listener events into a ChangeSet for the batch listeners
+  class ChangeSetCollector;
 
   /// Key by host id and child type
   struct IdAndTypeKey {
@@ -777,6 +1054,8 @@ private:
   ScenarioListenerList scenarioListeners_;
   /// Observers for new updates
   std::vector<NewUpdatesListenerPtr> newUpdatesListeners_;
+  /// Observers for the change set of each update()
+  std::vector<BatchListenerPtr> batchListeners_;
   /// Flag indicating if data limiting is set
   bool dataLimiting_;
   /// The CategoryNameManager coordinates string/int values
@@ -797,6 +1076,9 @@ private:
   /// Improve performance by caching the slice state
   std::shared_ptr<SliceCacheObserver> sliceCacheObserver_;
 
+  /// Consolidates listener events into the change set for batchListeners_
+  std::shared_ptr<ChangeSetCollector> changeSetCollector_;
+
   /// Links together the TableManager::NewRowDataListener to our newUpdatesListener_
   std::shared_ptr<NewRowDataToNewUpdatesAdapter> newRowDataListener_;
 
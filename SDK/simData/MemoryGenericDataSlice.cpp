@@ -35,24 +35,40 @@ static const double INFINITE_EXPIRATION_TIME = -1.0;
 /// How long to look for a value string match before giving up and making a new entry
 static const int COUNT_DOWN = 5;
 
+/// Approximate number of bytes used by a string, including its heap allocation if any
+static size_t stringBytes(const std::string& value)
+{
+  // Short strings are stored inside the std::string itself
+  static const size_t SHORT_STRING = std::string().capacity();
+  return sizeof(std::string) + ((value.capacity() > SHORT_STRING) ? value.capacity() + 1 : 0);
+}
+
 /// Holds all the values for one Generic Data Key
 class MemoryGenericDataSlice::Key
 {
 public:
-  /** Constructor */
-  explicit Key(const std::string& key)
-    : key_(key)
+  /** Constructor; values are interned in the pool if not nullptr */
+  Key(const std::string& key, StringPool* pool)
+    : key_(key),
+      pool_(pool),
+      pooledBytes_(0)
   {
     flush();
   }
 
   virtual ~Key()
   {
+    flush();
   }
 
   /// Removes all times and values
   void flush()
   {
+    if (pool_)
+    {
+      for (const auto& timeIndex : times_)
+        release_(timeIndex);
+    }
     // No static entries (-1 time) so just clear everything
     times_.clear();
     values_.clear();
@@ -62,6 +78,22 @@ public:
 
   void flush(double startTime, double endTime)
   {
+    // Pooled values are reference counted individually, so entries can simply be removed
+    if (pool_)
+    {
+      TimeList remaining;
+      for (const auto& timeIndex : times_)
+      {
+        if ((timeIndex.time >= startTime) && (timeIndex.time < endTime))
+          release_(timeIndex);
+        else
+          remaining.push_back(timeIndex);
+      }
+      times_.swap(remaining);
+      lastUpdateDirty_ = true;
+      return;
+    }
+
     // Instead of attempting to delete entries and update the data structure,
     // just save what is needed to a temporary vector, flush the data and rebuild.
 
@@ -84,11 +116,7 @@ public:
       if ((timeIndex.time >= startTime) && (timeIndex.time < endTime))
         continue;
 
-      const auto index = timeIndex.index - indexOffset_;
-      // verify that indexOffset_ is updated correctly; dev error if assert
-      assert((index >= 0) && (index < static_cast<int>(values_.size())));
-      const ValueIndex& cacheValue = values_[index];
-      remainingValues.push_back(TimeValuePair(timeIndex.time, cacheValue.value));
+      remainingValues.push_back(TimeValuePair(timeIndex.time, std::string(value_(timeIndex))));
     }
 
     // clear
@@ -136,7 +164,7 @@ public:
 
     // Decrease reference count
     for (uint32_t i = 0; i < amount; ++i)
-      values_[times_[i].index - indexOffset_].referenceCount--;
+      release_(times_[i]);
 
     // Actually remove
     times_.erase(times_.begin(), times_.begin() + amount);
@@ -163,7 +191,7 @@ public:
     {
       if (timeEnd->time >= cutoff)
         break;
-      values_[timeEnd->index - indexOffset_].referenceCount--;
+      release_(*timeEnd);
     }
 
     if (times_.begin() != timeEnd)
@@ -207,11 +235,7 @@ public:
         break;
 
       // check values
-      const auto index = start->index - indexOffset_;
-      // verify that indexOffset_ is updated correctly; dev error if assert
-      assert((index >= 0) && (index < static_cast<int>(values_.size())));
-      const ValueIndex& cacheValue = values_[index];
-      if (cacheValue.value == value)
+      if (value_(*start) == value)
         return; // no assert, user provided data
     }
 
@@ -220,14 +244,19 @@ public:
     {
       TimeList::iterator check = start;
       --check;
-      const auto index = check->index - indexOffset_;
-      // verify that indexOffset_ is updated correctly; dev error if assert
-      assert((index >= 0) && (index < static_cast<int>(values_.size())));
-      const ValueIndex& cacheValue = values_[index];
-      if (cacheValue.value == value)
+      if (value_(*check) == value)
         return;
     }
 
+    // The pool finds repeats of any earlier value
+    if (pool_)
+    {
+      times_.insert(start, TimeIndex(time, static_cast<int>(pool_->acquire(value))));
+      pooledBytes_ += value.size();
+      lastUpdateDirty_ = true;
+      return;
+    }
+
     // check for repeat values
     int valueIndex = -1;
     int countDown = COUNT_DOWN;  // After 5 checks give up and consider "new"
@@ -276,7 +305,8 @@ public:
 
     simData::GenericData_Entry* newEntry = genericData.add_entry();
     newEntry->set_key(key_);
-    newEntry->set_value(values_[it->index - indexOffset_].value);
+    const std::string_view value = value_(*it);
+    newEntry->set_value(value.data(), value.size());
   }
 
   /** Returns true if last update dirty */
@@ -306,10 +336,19 @@ public:
       return false;
 
     time = times_[index].time;
-    value = values_[times_[index].index - indexOffset_].value;
+    value = value_(times_[index]);
     return true;
   }
 
+  /** Approximate number of bytes used, counting pooled strings once per time */
+  size_t memoryUsage() const
+  {
+    size_t rv = sizeof(*this) + stringBytes(key_) + times_.size() * sizeof(TimeIndex) + pooledBytes_;
+    for (const auto& valueIndex : values_)
+      rv += sizeof(ValueIndex) - sizeof(std::string) + stringBytes(valueIndex.value);
+    return rv;
+  }
+
 private:
   /// Time with an index into the value list for the value string
   struct TimeIndex
@@ -341,9 +380,34 @@ private:
   };
   typedef std::deque<ValueIndex> ValueList;
 
+  /// Returns the value of the time entry; pooled values are valid until the pool changes
+  std::string_view value_(const TimeIndex& timeIndex) const
+  {
+    if (pool_)
+      return pool_->get(timeIndex.index);
+    const auto index = timeIndex.index - indexOffset_;
+    // verify that indexOffset_ is updated correctly; dev error if assert
+    assert((index >= 0) && (index < static_cast<int>(values_.size())));
+    return values_[index].value;
+  }
+
+  /// Removes the reference of the time entry to its value
+  void release_(const TimeIndex& timeIndex)
+  {
+    if (pool_)
+    {
+      pooledBytes_ -= pool_->get(timeIndex.index).size();
+      pool_->release(timeIndex.index);
+    }
+    else
+      values_[timeIndex.index - indexOffset_].referenceCount--;
+  }
+
   std::string key_;  ///< The key for this generic data
   TimeList times_;  ///< List of times
-  ValueList values_;  /// List of values
+  ValueList values_;  /// List of values; empty if pooled
+  StringPool* pool_;  ///< Pool holding the values, or nullptr to use values_
+  size_t pooledBytes_;  ///< Sum of the lengths of the pooled values of times_
   int indexOffset_;  ///< As the values list is trim need to offset the existing indexes in times_
   bool lastUpdateDirty_; ///< True if changes have been made since last update
 };
@@ -440,6 +504,7 @@ MemoryGenericDataSlice::~MemoryGenericDataSlice()
 void MemoryGenericDataSlice::flush()
 {
   // No static entries (-1 time) so just clear everything
+  keyIndex_.clear();
   for (GenericDataMap::const_iterator it = genericData_.begin(); it != genericData_.end(); ++it)
     delete it->second;
   genericData_.clear();
@@ -493,15 +558,7 @@ void MemoryGenericDataSlice::insert(GenericData* data, bool ignoreDuplicates)
     const std::string& key = data->entry(k).key();
     const std::string& value = data->entry(k).value();
 
-    GenericDataMap::const_iterator it = genericData_.find(key);
-    if (it == genericData_.end())
-    {
-      Key* newKey = new Key(key);
-      newKey->insert(data->time(), value, ignoreDuplicates);
-      genericData_[key] = newKey;
-    }
-    else
-      it->second->insert(data->time(), value, ignoreDuplicates);
+    findOrAddKey_(key)->insert(data->time(), value, ignoreDuplicates);
   }
 
   delete data;
@@ -513,6 +570,7 @@ int MemoryGenericDataSlice::removeTag(const std::string& tag)
   if (it == genericData_.end())
     return 1;
 
+  keyIndex_.erase(it->first);
   delete it->second;
   genericData_.erase(it);
   force_ = true;
@@ -633,4 +691,74 @@ size_t MemoryGenericDataSlice::numItems() const
   return rv;
 }
 
+void MemoryGenericDataSlice::setStringPool(std::shared_ptr<StringPool> pool)
+{
+  if (pool == pool_)
+    return;
+
+  // Copy out all the data, then insert it again in the new storage mode
+  struct Item
+  {
+    std::string key;
+    double time;
+    std::string value;
+  };
+  std::vector<Item> items;
+  for (GenericDataMap::const_iterator it = genericData_.begin(); it != genericData_.end(); ++it)
+  {
+    Item item;
+    item.key = it->first;
+    for (size_t k = 0; k < it->second->numItems(); ++k)
+    {
+      it->second->getItem(k, item.time, item.value);
+      items.push_back(item);
+    }
+  }
+
+  flush();
+  pool_ = pool;
+  for (const auto& item : items)
+    findOrAddKey_(item.key)->insert(item.time, item.value, false);
+  force_ = true;
+}
+
+std::shared_ptr<StringPool> MemoryGenericDataSlice::stringPool() const
+{
+  return pool_;
+}
+
+void MemoryGenericDataSlice::setStringPooling(bool pooling)
+{
+  if (pooling != stringPooling())
+    setStringPool(pooling ? std::make_shared<StringPool>() : nullptr);
+}
+
+bool MemoryGenericDataSlice::stringPooling() const
+{
+  return pool_ != nullptr;
+}
+
+size_t MemoryGenericDataSlice::memoryUsage() const
+{
+  // Map and hash nodes each hold about three pointers beyond their contents
+  size_t rv = sizeof(*this) + static_cast<size_t>(current_.SpaceUsedLong()) - sizeof(current_) + keyIndex_.bucket_count() * sizeof(void*);
+  for (GenericDataMap::const_iterator it = genericData_.begin(); it != genericData_.end(); ++it)
+  {
+    rv += it->second->memoryUsage() + stringBytes(it->first) + sizeof(std::string_view) + 2 * sizeof(Key*) + 6 * sizeof(void*);
+  }
+  return rv;
+}
+
+MemoryGenericDataSlice::Key* MemoryGenericDataSlice::findOrAddKey_(const std::string& key)
+{
+  auto it = keyIndex_.find(key);
+  if (it != keyIndex_.end())
+    return it->second;
+
+  Key* newKey = new Key(key, pool_.get());
+  auto inserted = genericData_.insert(std::make_pair(key, newKey));
+  keyIndex_[inserted.first->first] = newKey;
+  return newKey;
+}
+
 }
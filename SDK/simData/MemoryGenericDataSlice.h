@@ -25,10 +25,14 @@
 
 #include <deque>
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "simCore/Common/Common.h"
 #include "simData/DataSlice.h"
+#include "simData/StringPool.h"
 
 namespace simData
 {
@@ -49,6 +53,12 @@ namespace simData
  * value will get a new index in the queue.  The older repeating value can be data limited out without adversely
  * affecting the indexes.   Without the kick out it would theoretically be possible to stall the data limiting
  * of the std::deque and have it grow without bound.
+ *
+ * For feeds with many distinct values, setStringPool() switches the slice to a second storage
+ * mode that interns every value in a reference counted StringPool.  Repeats of any earlier value
+ * share one copy, values are stored in arena chunks rather than one allocation each, and data
+ * limiting reclaims a value as soon as its last reference is removed.  The pool can be shared by
+ * many slices, so values repeated across entities are also stored once.
  */
 class SDKDATA_EXPORT MemoryGenericDataSlice : public GenericDataSlice
 {
@@ -102,12 +112,30 @@ public:
   /// Retrieve total number of items in the data slice
   virtual size_t numItems() const;
 
+  /// Interns values in the string pool, which may be shared with other slices, or stops pooling for nullptr; existing data is converted
+  void setStringPool(std::shared_ptr<StringPool> pool);
+  /// Returns the pool holding the values, or nullptr if not pooling
+  std::shared_ptr<StringPool> stringPool() const;
+  /// Interns values in a string pool of the slice's own if true; existing data is converted
+  void setStringPooling(bool pooling);
+  /// Returns true if values are interned in a string pool
+  bool stringPooling() const;
+  /**
+   * Approximate number of bytes used by the slice, including its keys, times and values.  Pooled
+   * values are counted at their length for each time that uses them; the overhead of the pool
+   * itself is not included, since it may be shared.
+   */
+  size_t memoryUsage() const;
+
 private:
   /// Holds the data for individual generic data keys
   class Key;
   /// Collects data for the visitor pattern
   class Collector;
 
+  /// Returns the key with the name, adding it if needed
+  Key* findOrAddKey_(const std::string& key);
+
   // All the member variables are mutable so that the calculation of current_ can be delayed until the call to current()
   // 99% of the time no code calls current() after a call to update(), so don't calculate current_ until needed.
 
@@ -123,6 +151,10 @@ private:
   // All the generic data keyed by generic data key
   typedef std::map<std::string, Key*> GenericDataMap;
   mutable GenericDataMap genericData_;
+  /// Hashed lookup of the keys of genericData_, viewing the map's key strings
+  std::unordered_map<std::string_view, Key*> keyIndex_;
+  /// Holds the values when pooling, possibly shared with other slices; nullptr otherwise
+  std::shared_ptr<StringPool> pool_;
 
   /// force a re-calculation of current_
   mutable bool force_;
@@ -20,8 +20,12 @@
  * disclose, or release this software.
  *
  */
-#include <deque>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <type_traits>
 #include "simCore/Calc/Interpolation.h"
 #include "simData/DataTable.h"
 #include "simData/TableCellTranslator.h"
@@ -38,8 +42,9 @@ class DataColumn::IteratorDataImpl : public simData::TableColumn::IteratorData
 {
 public:
   /** Constructs a new IteratorDataImpl */
-  IteratorDataImpl(DataContainer* data, size_t position, double time)
-    : data_(data),
+  IteratorDataImpl(const DataColumn* column, DataContainer* data, size_t position, double time)
+    : column_(column),
+      data_(data),
       position_(position),
       time_(time)
   {
@@ -65,19 +70,20 @@ public:
   virtual TableStatus getValue(double& value) const { return data_->getValue(position_, value); }
   virtual TableStatus getValue(std::string& value) const { return data_->getValue(position_, value); }
 
-  virtual TableStatus setValue(uint8_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(int8_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(uint16_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(int16_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(uint32_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(int32_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(uint64_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(int64_t value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(float value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(double value) { return data_->replace(position_, value); }
-  virtual TableStatus setValue(const std::string& value) { return data_->replace(position_, value); }
+  virtual TableStatus setValue(uint8_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(int8_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(uint16_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(int16_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(uint32_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(int32_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(uint64_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(int64_t value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(float value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(double value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
+  virtual TableStatus setValue(const std::string& value) { column_->valueChanged_(time_); return data_->replace(position_, value); }
 
 private:
+  const DataColumn* column_;
   DataContainer* data_;
   size_t position_;
   double time_;
@@ -93,8 +99,9 @@ class DataColumn::ColumnIteratorImpl : public TableColumn::IteratorImpl
 {
 public:
   /** Constructs a new ColumnIteratorImpl */
-  ColumnIteratorImpl(DataContainer* freshData, DataContainer* staleData, TimeContainer::Iterator timeIter)
-    : freshData_(freshData),
+  ColumnIteratorImpl(const DataColumn* column, DataContainer* freshData, DataContainer* staleData, TimeContainer::Iterator timeIter)
+    : column_(column),
+      freshData_(freshData),
       staleData_(staleData),
       timeIter_(timeIter)
   {
@@ -142,10 +149,11 @@ public:
 
   virtual GenericIteratorImpl<IteratorDataPtr>* clone() const
   {
-    return new ColumnIteratorImpl(freshData_, staleData_, timeIter_);
+    return new ColumnIteratorImpl(column_, freshData_, staleData_, timeIter_);
   }
 
 private:
+  const DataColumn* column_;
   DataContainer* freshData_;
   DataContainer* staleData_;
   TimeContainer::Iterator timeIter_;
@@ -154,8 +162,8 @@ private:
   IteratorDataImpl* newIteratorDataImpl_(TimeContainer::IteratorData data) const
   {
     if (data.isFreshBin())
-      return new IteratorDataImpl(freshData_, data.index(), data.time());
-    return new IteratorDataImpl(staleData_, data.index(), data.time());
+      return new IteratorDataImpl(column_, freshData_, data.index(), data.time());
+    return new IteratorDataImpl(column_, staleData_, data.index(), data.time());
   }
 };
 
@@ -243,6 +251,9 @@ public:
   /** Removes all items from container */
   virtual void clear() { data_.clear(); }
 
+  /** Typed access to the values for bulk reads */
+  const std::deque<T>& data() const { return data_; }
+
 private:
   /**
    * All data is stored in a deque.  Deque chosen for faster insertion
@@ -356,6 +367,7 @@ private:
 
 DelayedFlushContainerPtr DataColumn::flush()
 {
+  pyramid_.clear();
   // Optimize for case where both are empty (no memory allocation)
   if (freshData_->empty() && staleData_->empty())
     return DelayedFlushContainerPtr();
@@ -463,30 +475,30 @@ void DataColumn::fillRow(const TimeContainer::IteratorData& timeIdxData, TableRo
 // Start iteration at the beginning of the container (smallest time).
 TableColumn::Iterator DataColumn::begin() const
 {
-  return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->begin()));
+  return Iterator(new ColumnIteratorImpl(this, freshData_, staleData_, timeContainer_->begin()));
 }
 
 // Iterator representing the back of the container (largest time).
 TableColumn::Iterator DataColumn::end() const
 {
-  return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->end()));
+  return Iterator(new ColumnIteratorImpl(this, freshData_, staleData_, timeContainer_->end()));
 }
 
 // Returns lower_bound() iterator into container
 TableColumn::Iterator DataColumn::lower_bound(double timeValue) const
 {
-  return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->lower_bound(timeValue)));
+  return Iterator(new ColumnIteratorImpl(this, freshData_, staleData_, timeContainer_->lower_bound(timeValue)));
 }
 
 // Returns upper_bound() iterator into container
 TableColumn::Iterator DataColumn::upper_bound(double timeValue) const
 {
-  return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->upper_bound(timeValue)));
+  return Iterator(new ColumnIteratorImpl(this, freshData_, staleData_, timeContainer_->upper_bound(timeValue)));
 }
 
 TableColumn::Iterator DataColumn::findAtOrBeforeTime(double timeValue) const
 {
-  return Iterator(new ColumnIteratorImpl(freshData_, staleData_, timeContainer_->findTimeAtOrBeforeGivenTime(timeValue)));
+  return Iterator(new ColumnIteratorImpl(this, freshData_, staleData_, timeContainer_->findTimeAtOrBeforeGivenTime(timeValue)));
 }
 
 DataContainer* DataColumn::newDataContainer_(simData::VariableType variableType) const
@@ -526,4 +538,159 @@ int DataColumn::getTimeRange(double& begin, double& end) const
 {
   return timeContainer_->getTimeRange(begin, end);
 }
+
+template <typename Function>
+void DataColumn::withTypedData_(Function&& function) const
+{
+  switch (variableType_)
+  {
+  case VT_UINT8: function(static_cast<const DataContainerT<uint8_t>*>(freshData_)->data(), static_cast<const DataContainerT<uint8_t>*>(staleData_)->data()); break;
+  case VT_INT8: function(static_cast<const DataContainerT<int8_t>*>(freshData_)->data(), static_cast<const DataContainerT<int8_t>*>(staleData_)->data()); break;
+  case VT_UINT16: function(static_cast<const DataContainerT<uint16_t>*>(freshData_)->data(), static_cast<const DataContainerT<uint16_t>*>(staleData_)->data()); break;
+  case VT_INT16: function(static_cast<const DataContainerT<int16_t>*>(freshData_)->data(), static_cast<const DataContainerT<int16_t>*>(staleData_)->data()); break;
+  case VT_UINT32: function(static_cast<const DataContainerT<uint32_t>*>(freshData_)->data(), static_cast<const DataContainerT<uint32_t>*>(staleData_)->data()); break;
+  case VT_INT32: function(static_cast<const DataContainerT<int32_t>*>(freshData_)->data(), static_cast<const DataContainerT<int32_t>*>(staleData_)->data()); break;
+  case VT_UINT64: function(static_cast<const DataContainerT<uint64_t>*>(freshData_)->data(), static_cast<const DataContainerT<uint64_t>*>(staleData_)->data()); break;
+  case VT_INT64: function(static_cast<const DataContainerT<int64_t>*>(freshData_)->data(), static_cast<const DataContainerT<int64_t>*>(staleData_)->data()); break;
+  case VT_FLOAT: function(static_cast<const DataContainerT<float>*>(freshData_)->data(), static_cast<const DataContainerT<float>*>(staleData_)->data()); break;
+  case VT_DOUBLE: function(static_cast<const DataContainerT<double>*>(freshData_)->data(), static_cast<const DataContainerT<double>*>(staleData_)->data()); break;
+  case VT_STRING: function(static_cast<const DataContainerT<std::string>*>(freshData_)->data(), static_cast<const DataContainerT<std::string>*>(staleData_)->data()); break;
+  }
+}
+
+void DataColumn::values(double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values) const
+{
+  std::vector<TimeContainer::IteratorData> entries;
+  timeContainer_->entries(beginTime, endTime, entries);
+  times.resize(entries.size());
+  for (size_t k = 0; k < entries.size(); ++k)
+    times[k] = entries[k].time();
+  values_(entries, values);
+}
+
+void DataColumn::values_(const std::vector<TimeContainer::IteratorData>& entries, std::vector<double>& values) const
+{
+  values.resize(entries.size());
+  withTypedData_([&entries, &values](const auto& fresh, const auto& stale) {
+    for (size_t k = 0; k < entries.size(); ++k)
+    {
+      const TimeContainer::IteratorData& entry = entries[k];
+      const auto& data = entry.isFreshBin() ? fresh : stale;
+      values[k] = 0.0;
+      if (entry.index() < data.size())
+        TableCellTranslator::cast(data[entry.index()], values[k]);
+    }
+  });
+}
+
+void DataColumn::copyValues(const std::vector<TimeContainer::IteratorData>& entries, const std::vector<size_t>& rows,
+  TableColumnChunk& chunk, size_t chunkColumn) const
+{
+  // Assertion failure means the rows do not match the entries
+  assert(rows.size() == entries.size());
+  if (entries.empty())
+    return;
+  withTypedData_([&entries, &rows, &chunk, chunkColumn](const auto& fresh, const auto& stale) {
+    typedef typename std::decay_t<decltype(fresh)>::value_type ValueType;
+    // Assertion failure means the chunk column was not added with this column's storage type
+    assert(chunk.hasType<ValueType>(chunkColumn));
+    if (!chunk.hasType<ValueType>(chunkColumn))
+      return;
+    ValueType* out = chunk.mutableValues<ValueType>(chunkColumn);
+    for (size_t k = 0; k < entries.size(); ++k)
+    {
+      const TimeContainer::IteratorData& entry = entries[k];
+      const auto& data = entry.isFreshBin() ? fresh : stale;
+      if (entry.index() >= data.size())
+        continue;
+      out[rows[k]] = data[entry.index()];
+      chunk.setNotNull(chunkColumn, rows[k]);
+    }
+  });
+}
+TableStatus DataColumn::aggregate(double beginTime, double endTime, TableColumnAggregate& aggregate) const
+{
+  aggregate = TableColumnAggregate();
+  if (variableType_ == VT_STRING)
+    return TableStatus::Error("Cannot aggregate string column.");
+
+  DecimationPyramid<1>::Extent extent;
+  pyramid_.extent([this](double begin, double end, std::vector<double>& times, std::vector<double>& values) {
+    this->values(begin, end, times, values);
+  }, beginTime, endTime, extent);
+  if (extent.count == 0)
+    return TableStatus::Success();
+  aggregate.count = extent.count;
+  aggregate.min = extent.min[0];
+  aggregate.max = extent.max[0];
+  aggregate.minTime = extent.minTime[0];
+  aggregate.maxTime = extent.maxTime[0];
+  aggregate.sum = extent.sum[0];
+  aggregate.firstTime = extent.firstTime;
+  aggregate.firstValue = extent.first[0];
+  aggregate.lastTime = extent.lastTime;
+  aggregate.lastValue = extent.last[0];
+  return TableStatus::Success();
+}
+
+TableStatus DataColumn::aggregate(double beginTime, double endTime, size_t numBuckets, std::vector<TableColumnAggregate>& buckets) const
+{
+  buckets.clear();
+  if (variableType_ == VT_STRING)
+    return TableStatus::Error("Cannot aggregate string column.");
+  if (numBuckets == 0 || !(endTime > beginTime))
+    return TableStatus::Error("Invalid bucket range.");
+  buckets.resize(numBuckets);
+  const double width = (endTime - beginTime) / numBuckets;
+  for (size_t k = 0; k < numBuckets; ++k)
+  {
+    const double bucketEnd = (k + 1 == numBuckets) ? endTime : (beginTime + (k + 1) * width);
+    aggregate(beginTime + k * width, bucketEnd, buckets[k]);
+  }
+  return TableStatus::Success();
+}
+
+TableStatus DataColumn::decimate(double beginTime, double endTime, size_t maxPoints, std::vector<double>& times, std::vector<double>& values) const
+{
+  times.clear();
+  values.clear();
+  if (variableType_ == VT_STRING)
+    return TableStatus::Error("Cannot decimate string column.");
+  if (maxPoints < DecimationPyramid<1>::PointsPerBucket)
+    return TableStatus::Error("Too few points for decimation.");
+
+  pyramid_.decimate([this](double begin, double end, std::vector<double>& rangeTimes, std::vector<double>& rangeValues) {
+    this->values(begin, end, rangeTimes, rangeValues);
+  }, beginTime, endTime, maxPoints, times);
+
+  // Look up the value at each chosen time; times are unique within a column
+  std::vector<TimeContainer::IteratorData> entries;
+  entries.reserve(times.size());
+  std::vector<TimeContainer::IteratorData> found;
+  for (double time : times)
+  {
+    found.clear();
+    timeContainer_->entries(time, std::nextafter(time, std::numeric_limits<double>::max()), found);
+    // Assertion failure means the pyramid returned a time that is not in the column
+    assert(found.size() == 1);
+    if (!found.empty())
+      entries.push_back(found.front());
+  }
+  times.resize(entries.size());
+  for (size_t k = 0; k < entries.size(); ++k)
+    times[k] = entries[k].time();
+  values_(entries, values);
+  return TableStatus::Success();
+}
+
+void DataColumn::removeSummaries(double beginTime, double endTime)
+{
+  pyramid_.removed(beginTime, endTime);
+}
+
+void DataColumn::valueChanged_(double time) const
+{
+  pyramid_.changed(time);
+}
+
 } }
@@ -24,7 +24,9 @@
 #define SIMDATA_MEMORYTABLE_DATACOLUMN_H
 
 #include <string>
+#include <vector>
 #include "simData/DataTable.h"
+#include "simData/DecimationPyramid.h"
 #include "simData/MemoryTable/DataContainer.h"
 #include "simData/MemoryTable/TimeContainer.h"
 
@@ -44,17 +46,19 @@ public:
   /** Columns contain no dynamic memory */
   virtual ~DataColumn();
 
-  /** Inserts a template value into a data container */
+  /** Inserts a template value for the given time into a data container */
   template <typename DataType>
-  void insert(bool freshContainer, size_t position, const DataType& value)
+  void insert(bool freshContainer, size_t position, double time, const DataType& value)
   {
+    valueChanged_(time);
     dataContainer_(freshContainer)->insert(position, value);
   }
 
-  /** Replaces a value in a data container with a template value */
+  /** Replaces the value for the given time in a data container with a template value */
   template <typename DataType>
-  TableStatus replace(bool freshContainer, size_t position, const DataType& value)
+  TableStatus replace(bool freshContainer, size_t position, double time, const DataType& value)
   {
+    valueChanged_(time);
     return dataContainer_(freshContainer)->replace(position, value);
   }
 
@@ -126,6 +130,12 @@ public:
   /// Swaps the contents of the fresh and stale data, flushing out the stale
   void swapFreshStaleData();
 
+  /**
+   * Drops the aggregate summaries of entries in the time range, inclusive at both ends.  The time
+   * container calls this before removing entries in the range from the column.
+   */
+  void removeSummaries(double beginTime, double endTime);
+
   /**
    * Returns the begin and end time of the column
    * @param begin Returns the begin time
@@ -134,7 +144,37 @@ public:
    */
   virtual int getTimeRange(double& begin, double& end) const;
 
+  /** Copies the entries in the time range into contiguous arrays, converted to double */
+  virtual void values(double beginTime, double endTime, std::vector<double>& times, std::vector<double>& values) const;
+
+  /**
+   * Copies the values at the time container entries into a column of the chunk, which must have
+   * this column's storage type, marking them not null.  Entry i is copied to row rows[i].
+   */
+  void copyValues(const std::vector<TimeContainer::IteratorData>& entries, const std::vector<size_t>& rows,
+    TableColumnChunk& chunk, size_t chunkColumn) const;
+
+  /** Computes the aggregate of the entries in the time range, using the pyramid's summaries of older entries */
+  virtual TableStatus aggregate(double beginTime, double endTime, TableColumnAggregate& aggregate) const;
+  /** Computes the aggregates of equal buckets of the time range */
+  virtual TableStatus aggregate(double beginTime, double endTime, size_t numBuckets, std::vector<TableColumnAggregate>& buckets) const;
+
+  /** Retrieves representative entries in the time range from the min/max pyramid */
+  virtual TableStatus decimate(double beginTime, double endTime, size_t maxPoints, std::vector<double>& times, std::vector<double>& values) const;
+
 private:
+  /// Drops the summaries that the new or changed value at the time would make stale
+  void valueChanged_(double time) const;
+  /// Retrieves the values of the entries converted to double
+  void values_(const std::vector<TimeContainer::IteratorData>& entries, std::vector<double>& values) const;
+
+  /**
+   * Calls the function with the typed fresh and stale std::deque<T> of values, where T is the
+   * storage type, so that bulk reads avoid the virtual call per cell of DataContainer.
+   */
+  template <typename Function>
+  void withTypedData_(Function&& function) const;
+
   /// Allocates a new data container based on the data storage type
   DataContainer* newDataContainer_(simData::VariableType variableType) const;
   /// Retrieves the data container, fresh or stale, as requested
@@ -149,6 +189,8 @@ private:
   TableColumnId id_;
   VariableType variableType_;
   UnitType unitType_;
+  /// Min/max summaries of the entries, extended as aggregates are requested
+  mutable DecimationPyramid<1> pyramid_;
 
   // Implement the iteration mechanisms from TableColumn::IteratorData
   class IteratorDataImpl;
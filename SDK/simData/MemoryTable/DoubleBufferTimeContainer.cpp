@@ -576,6 +576,27 @@ TimeContainer::Iterator DoubleBufferTimeContainer::findOrAddTime(double timeValu
   return newIterator_(BIN_FRESH, iterStale, freshDeq.insert(iterFresh, itemToInsert));
 }
 
+void DoubleBufferTimeContainer::entries(double beginTime, double endTime, std::vector<IteratorData>& entries) const
+{
+  if (endTime <= beginTime)
+    return;
+  // Merge the two time sorted bins directly rather than through the iterator
+  TimeIndexDeque& staleDeq = staleTimes_();
+  TimeIndexDeque& freshDeq = freshTimes_();
+  TimeIndexDeque::const_iterator stale = lowerBound_(staleDeq, beginTime);
+  TimeIndexDeque::const_iterator staleEnd = lowerBound_(staleDeq, endTime);
+  TimeIndexDeque::const_iterator fresh = lowerBound_(freshDeq, beginTime);
+  TimeIndexDeque::const_iterator freshEnd = lowerBound_(freshDeq, endTime);
+  entries.reserve(entries.size() + (staleEnd - stale) + (freshEnd - fresh));
+  while (stale != staleEnd || fresh != freshEnd)
+  {
+    if (fresh == freshEnd || (stale != staleEnd && stale->first < fresh->first))
+      entries.push_back(IteratorData(*stale++, false));
+    else
+      entries.push_back(IteratorData(*fresh++, true));
+  }
+}
+
 void DoubleBufferTimeContainer::erase(TimeContainer::Iterator iter, TimeContainer::EraseBehavior eraseBehavior)
 {
   DoubleBufferIterator* dbIter = dynamic_cast<DoubleBufferIterator*>(iter.impl());
@@ -593,6 +614,8 @@ simData::DelayedFlushContainerPtr DoubleBufferTimeContainer::flush()
 
 void DoubleBufferTimeContainer::flush(const std::vector<DataColumn*>& columns, double startTime, double endTime)
 {
+  for (DataColumn* column : columns)
+    column->removeSummaries(startTime, endTime);
   flush_(*times_[BIN_STALE], false, columns, startTime, endTime);
   flush_(*times_[BIN_FRESH], true, columns, startTime, endTime);
 }
@@ -772,6 +795,11 @@ void DoubleBufferTimeContainer::limitData(size_t maxPoints, double latestInvalid
   // Note that naive implementation here does not retain item -1
 
   // We definitely need to limit.  Do a swap of buffers to handle it
+  if (!times_[BIN_STALE]->empty())
+  {
+    for (DataColumn* column : columns)
+      column->removeSummaries(times_[BIN_STALE]->front().first, times_[BIN_STALE]->back().first);
+  }
   swapFreshStaleData(table, observers);
   for (std::vector<DataColumn*>::const_iterator i = columns.begin(); i != columns.end(); ++i)
     (*i)->swapFreshStaleData();
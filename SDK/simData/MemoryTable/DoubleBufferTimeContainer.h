@@ -63,6 +63,7 @@ public:
   virtual TimeContainer::Iterator findTimeAtOrBeforeGivenTime(double timeValue);
   virtual TimeContainer::Iterator find(double timeValue);
   virtual TimeContainer::Iterator findOrAddTime(double timeValue, bool* exactMatch=nullptr);
+  virtual void entries(double beginTime, double endTime, std::vector<IteratorData>& entries) const;
   virtual void erase(Iterator iter, EraseBehavior eraseBehavior);
   virtual DelayedFlushContainerPtr flush();
   virtual void flush(const std::vector<DataColumn*>& columns, double startTime, double endTime);
@@ -94,14 +94,14 @@ private:
     if (column == nullptr)
       return TableStatus::Error("Column does not exist in subtable.");
     if (!insertRow_)
-      return column->replace(isFreshBin_, rowIndex_, value);
+      return column->replace(isFreshBin_, rowIndex_, timeStamp_, value);
     // Here we catch the case of setting the same cell value more than once
     if (column->size() == origTimeMapSize_)
-      column->insert(isFreshBin_, rowIndex_, value);
+      column->insert(isFreshBin_, rowIndex_, timeStamp_, value);
     else
     {
       assert(column->size() == origTimeMapSize_ + 1);
-      column->replace(isFreshBin_, rowIndex_, value);
+      column->replace(isFreshBin_, rowIndex_, timeStamp_, value);
     }
     return TableStatus::Success();
   }
@@ -454,6 +454,21 @@ TableStatus SubTable::interpolate(TableColumnId columnId, double time, double& v
   return column->interpolate(value, time, interpolator);
 }
 
+void SubTable::entries(double beginTime, double endTime, std::vector<TimeContainer::IteratorData>& entries) const
+{
+  timeContainer_->entries(beginTime, endTime, entries);
+}
+
+TableStatus SubTable::copyValues(TableColumnId columnId, const std::vector<TimeContainer::IteratorData>& entries,
+  const std::vector<size_t>& rows, TableColumnChunk& chunk, size_t chunkColumn) const
+{
+  const DataColumn* column = findColumn_(columnId);
+  if (column == nullptr)
+    return TableStatus::Error("Invalid column index.");
+  column->copyValues(entries, rows, chunk, chunkColumn);
+  return TableStatus::Success();
+}
+
 SubTable::AddRowTransactionPtr SubTable::addRow(double timeStamp, SplitObserverPtr splitObserver)
 {
   return AddRowTransactionPtr(new AddRowTransactionImpl(*this, timeStamp, splitObserver));
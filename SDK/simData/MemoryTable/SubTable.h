@@ -137,6 +137,16 @@ public:
    */
   TableStatus interpolate(TableColumnId columnId, double time, double& value, const TableColumn::Interpolator* interpolator) const;
 
+  /** Appends the time container entries after beginTime (inclusive) until endTime (exclusive), in time order */
+  void entries(double beginTime, double endTime, std::vector<TimeContainer::IteratorData>& entries) const;
+
+  /**
+   * Copies the column's values at the time container entries into a column of the chunk, which
+   * must have the column's storage type.  Entry i is copied to row rows[i] of the chunk.
+   */
+  TableStatus copyValues(TableColumnId columnId, const std::vector<TimeContainer::IteratorData>& entries,
+    const std::vector<size_t>& rows, TableColumnChunk& chunk, size_t chunkColumn) const;
+
   /**
    * Removes all rows from the subtable.
    */
@@ -467,6 +467,64 @@ void Table::accept(DataTable::ColumnVisitor& visitor) const
     visitor.visit(i->second.second);
 }
 
+TableStatus Table::readColumns(double beginTime, double endTime, const std::vector<TableColumnId>& columnIds, TableColumnChunk& chunk) const
+{
+  chunk.reset(std::vector<double>());
+
+  // Collect the entries of each subtable that holds one of the columns, once per subtable
+  std::vector<const SubTable*> subtables;
+  std::vector<size_t> subtableOfColumn;
+  subtableOfColumn.reserve(columnIds.size());
+  for (TableColumnId id : columnIds)
+  {
+    std::map<TableColumnId, TableToColumn>::const_iterator i = columns_.find(id);
+    if (i == columns_.end())
+      return TableStatus::Error("Invalid column index.");
+    const size_t index = std::find(subtables.begin(), subtables.end(), i->second.first) - subtables.begin();
+    if (index == subtables.size())
+      subtables.push_back(i->second.first);
+    subtableOfColumn.push_back(index);
+  }
+  std::vector<std::vector<TimeContainer::IteratorData> > entries(subtables.size());
+  for (size_t k = 0; k < subtables.size(); ++k)
+    subtables[k]->entries(beginTime, endTime, entries[k]);
+
+  // Rows are the union of the subtable times
+  std::vector<double> times;
+  for (const auto& subtableEntries : entries)
+  {
+    const size_t previousSize = times.size();
+    for (const TimeContainer::IteratorData& entry : subtableEntries)
+      times.push_back(entry.time());
+    if (previousSize != 0)
+      std::inplace_merge(times.begin(), times.begin() + previousSize, times.end());
+  }
+  times.erase(std::unique(times.begin(), times.end()), times.end());
+
+  // Find the row of each entry; both are in time order
+  std::vector<std::vector<size_t> > rows(subtables.size());
+  for (size_t k = 0; k < subtables.size(); ++k)
+  {
+    rows[k].reserve(entries[k].size());
+    size_t row = 0;
+    for (const TimeContainer::IteratorData& entry : entries[k])
+    {
+      while (times[row] < entry.time())
+        ++row;
+      rows[k].push_back(row);
+    }
+  }
+
+  chunk.reset(std::move(times));
+  for (size_t k = 0; k < columnIds.size(); ++k)
+  {
+    const size_t column = chunk.addColumn(columnIds[k], columns_.find(columnIds[k])->second.second->variableType());
+    const size_t subtable = subtableOfColumn[k];
+    subtables[subtable]->copyValues(columnIds[k], entries[subtable], rows[subtable], chunk, column);
+  }
+  return TableStatus::Success();
+}
+
 TableStatus Table::addRow(const TableRow& row)
 {
   if (row.empty())
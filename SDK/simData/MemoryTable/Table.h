@@ -77,6 +77,8 @@ public:
   virtual void accept(double beginTime, double endTime, DataTable::RowVisitor& visitor) const;
   /** Visitor pattern to access all columns in the table. */
   virtual void accept(DataTable::ColumnVisitor& visitor) const;
+  /** Copies the values of the columns in the time range into contiguous arrays. */
+  virtual TableStatus readColumns(double beginTime, double endTime, const std::vector<TableColumnId>& columnIds, TableColumnChunk& chunk) const;
   /** Adds a row to the table. */
   virtual TableStatus addRow(const TableRow& row);
   /** Clears data out of the given column or all columns if given -1 */
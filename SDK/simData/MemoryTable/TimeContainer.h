@@ -24,6 +24,7 @@
 #define SIMDATA_MEMORYTABLE_TIMECONTAINER_H
 
 #include <utility>
+#include <vector>
 #include "simCore/Common/Common.h"
 #include "simData/GenericIterator.h"
 #include "simData/DataTable.h"
@@ -158,6 +159,11 @@ public:
    * @param exactMatch If non-nullptr, will be set to false if added row, or true if found row
    */
   virtual Iterator findOrAddTime(double timeValue, bool* exactMatch=nullptr) = 0;
+  /**
+   * Appends the entries with times after beginTime (inclusive) until endTime (exclusive) in time
+   * order, without the per-entry calls of iteration.  Used for bulk reads of the data columns.
+   */
+  virtual void entries(double beginTime, double endTime, std::vector<IteratorData>& entries) const = 0;
 
   /**
    * Performs data limiting for the container and associated columns
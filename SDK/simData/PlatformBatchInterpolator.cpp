@@ -0,0 +1,317 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cassert>
+#include <cmath>
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Interpolation.h"
+#include "simCore/Calc/Math.h"
+#include "simData/DataStore.h"
+#include "simData/PlatformBatchInterpolator.h"
+
+namespace
+{
+
+/// Returns true if all fields of the updates match
+bool sameUpdate(const simData::PlatformUpdate& lhs, const simData::PlatformUpdate& rhs)
+{
+  return (lhs.time() == rhs.time()) &&
+    (lhs.x() == rhs.x()) && (lhs.y() == rhs.y()) && (lhs.z() == rhs.z()) &&
+    (lhs.psi() == rhs.psi()) && (lhs.theta() == rhs.theta()) && (lhs.phi() == rhs.phi()) &&
+    (lhs.vx() == rhs.vx()) && (lhs.vy() == rhs.vy()) && (lhs.vz() == rhs.vz());
+}
+
+/// Returns the change from low to high along the shorter way around the circle, matching LinearInterpolator
+double angleStep(double low, double high)
+{
+  const double delta = high - low;
+  if (delta == 0.)
+    return 0.;
+  if (std::abs(delta) < M_PI)
+    return delta;
+  return (delta > 0) ? (delta - M_TWOPI) : (M_TWOPI + delta);
+}
+
+/// Writes value to entry i of the array, if the array is not nullptr
+template <typename T>
+void write(T* array, size_t i, T value)
+{
+  if (array != nullptr)
+    array[i] = value;
+}
+
+}
+
+namespace simData
+{
+
+PlatformBatchInterpolator::PlatformBatchInterpolator(Method method)
+  : method_(method)
+{
+}
+
+PlatformBatchInterpolator::~PlatformBatchInterpolator()
+{
+}
+
+PlatformBatchInterpolator::Method PlatformBatchInterpolator::method() const
+{
+  return method_;
+}
+
+void PlatformBatchInterpolator::clear()
+{
+  *this = PlatformBatchInterpolator(method_);
+}
+
+int PlatformBatchInterpolator::interpolate(const DataStore& dataStore, double time, const std::vector<ObjectId>& ids, const Output& output)
+{
+  resize_(ids.size());
+
+  // Find the bracket of each platform; copies are written now, interpolations after the table pass
+  int rv = 0;
+  bool anyInterpolated = false;
+  for (size_t ii = 0; ii < ids.size(); ++ii)
+  {
+    kind_[ii] = Kind::NONE;
+    const PlatformUpdateSlice* slice = dataStore.platformUpdateSlice(ids[ii]);
+    if (slice == nullptr)
+    {
+      rv = 1;
+      write<uint8_t>(output.flags, ii, 0);
+      continue;
+    }
+
+    const auto it = slice->upper_bound(time);
+    const PlatformUpdate* prev = it.hasPrevious() ? it.peekPrevious() : nullptr;
+    const PlatformUpdate* next = it.hasNext() ? it.peekNext() : nullptr;
+    if (prev == nullptr)
+    {
+      // Before the first update
+      write<uint8_t>(output.flags, ii, 0);
+      continue;
+    }
+
+    if ((next == nullptr) || simCore::areEqual(time, prev->time()))
+    {
+      kind_[ii] = Kind::COPY;
+      writeCopy_(ii, *prev, output);
+      continue;
+    }
+
+    if (method_ == Method::NEAREST_NEIGHBOR)
+    {
+      kind_[ii] = Kind::COPY;
+      writeCopy_(ii, (time < (next->time() + prev->time()) / 2.0) ? *prev : *next, output);
+      if (output.flags != nullptr)
+        output.flags[ii] |= INTERPOLATED;
+      continue;
+    }
+
+    kind_[ii] = Kind::INTERPOLATE;
+    setBracket_(ii, *prev, *next);
+    anyInterpolated = true;
+  }
+
+  if (!anyInterpolated)
+    return rv;
+
+  interpolateTable_(time);
+  for (size_t ii = 0; ii < ids.size(); ++ii)
+  {
+    if (kind_[ii] == Kind::INTERPOLATE)
+      writeInterpolated_(ii, output);
+  }
+  return rv;
+}
+
+void PlatformBatchInterpolator::resize_(size_t size)
+{
+  if (kind_.size() == size)
+    return;
+
+  kind_.resize(size, Kind::NONE);
+  prev_.resize(size);
+  next_.resize(size);
+  converted_.assign(size, 0);
+  parts_.resize(size);
+  for (auto* column : { &t0_, &t1_, &x0_, &y0_, &z0_, &x1_, &y1_, &z1_, &alt0_, &alt1_,
+    &yaw0_, &pitch0_, &roll0_, &yawStep_, &pitchStep_, &rollStep_, &vx0_, &vy0_, &vz0_, &vx1_, &vy1_, &vz1_,
+    &factor_, &x_, &y_, &z_, &alt_, &yaw_, &pitch_, &roll_, &vx_, &vy_, &vz_ })
+  {
+    // Entries that are not interpolated still pass through interpolateTable_(), so keep their factor finite
+    column->assign(size, 0.0);
+  }
+  t1_.assign(size, 1.0);
+}
+
+void PlatformBatchInterpolator::setBracket_(size_t i, const PlatformUpdate& prev, const PlatformUpdate& next)
+{
+  // During playback the bracket usually matches the previous call, so skip the geodetic conversions
+  if (converted_[i] && sameUpdate(prev, prev_[i]) && sameUpdate(next, next_[i]))
+    return;
+
+  prev_[i] = prev;
+  next_[i] = next;
+  converted_[i] = 1;
+
+  // Same conversions as LinearInterpolator
+  const bool orientation = prev.has_orientation() && next.has_orientation();
+  const bool velocity = prev.has_velocity() && next.has_velocity();
+  parts_[i] = (orientation ? HAS_ORIENTATION : 0) | (velocity ? HAS_VELOCITY : 0);
+
+  simCore::Coordinate prevEcef(simCore::COORD_SYS_ECEF, simCore::Vec3(prev.x(), prev.y(), prev.z()));
+  simCore::Coordinate nextEcef(simCore::COORD_SYS_ECEF, simCore::Vec3(next.x(), next.y(), next.z()));
+  if (orientation)
+  {
+    prevEcef.setOrientation(simCore::Vec3(prev.psi(), prev.theta(), prev.phi()));
+    nextEcef.setOrientation(simCore::Vec3(next.psi(), next.theta(), next.phi()));
+  }
+  if (velocity)
+  {
+    prevEcef.setVelocity(simCore::Vec3(prev.vx(), prev.vy(), prev.vz()));
+    nextEcef.setVelocity(simCore::Vec3(next.vx(), next.vy(), next.vz()));
+  }
+  simCore::Coordinate prevLla;
+  simCore::CoordinateConverter::convertEcefToGeodetic(prevEcef, prevLla);
+  simCore::Coordinate nextLla;
+  simCore::CoordinateConverter::convertEcefToGeodetic(nextEcef, nextLla);
+
+  t0_[i] = prev.time();
+  t1_[i] = next.time();
+  x0_[i] = prev.x();
+  y0_[i] = prev.y();
+  z0_[i] = prev.z();
+  x1_[i] = next.x();
+  y1_[i] = next.y();
+  z1_[i] = next.z();
+  alt0_[i] = prevLla.z();
+  alt1_[i] = nextLla.z();
+
+  if (orientation)
+  {
+    yaw0_[i] = simCore::angFix2PI(prevLla.yaw());
+    pitch0_[i] = simCore::angFix2PI(prevLla.pitch());
+    roll0_[i] = simCore::angFix2PI(prevLla.roll());
+    yawStep_[i] = angleStep(yaw0_[i], simCore::angFix2PI(nextLla.yaw()));
+    pitchStep_[i] = angleStep(pitch0_[i], simCore::angFix2PI(nextLla.pitch()));
+    rollStep_[i] = angleStep(roll0_[i], simCore::angFix2PI(nextLla.roll()));
+  }
+
+  if (velocity)
+  {
+    vx0_[i] = prevLla.vx();
+    vy0_[i] = prevLla.vy();
+    vz0_[i] = prevLla.vz();
+    vx1_[i] = nextLla.vx();
+    vy1_[i] = nextLla.vy();
+    vz1_[i] = nextLla.vz();
+  }
+}
+
+void PlatformBatchInterpolator::writeCopy_(size_t i, const PlatformUpdate& update, const Output& output) const
+{
+  const bool orientation = update.has_orientation();
+  const bool velocity = update.has_velocity();
+  write(output.x, i, update.x());
+  write(output.y, i, update.y());
+  write(output.z, i, update.z());
+  write(output.psi, i, orientation ? update.psi() : 0.0);
+  write(output.theta, i, orientation ? update.theta() : 0.0);
+  write(output.phi, i, orientation ? update.phi() : 0.0);
+  write(output.vx, i, velocity ? update.vx() : 0.0);
+  write(output.vy, i, velocity ? update.vy() : 0.0);
+  write(output.vz, i, velocity ? update.vz() : 0.0);
+  write<uint8_t>(output.flags, i, HAS_POSITION | (orientation ? HAS_ORIENTATION : 0) | (velocity ? HAS_VELOCITY : 0));
+}
+
+void PlatformBatchInterpolator::interpolateTable_(double time)
+{
+  // Every entry is processed, interpolated or not, so that each loop is a straight pass over
+  // contiguous columns without branches; the compiler turns these into SIMD loops.
+  const size_t size = kind_.size();
+  const double* t0 = t0_.data();
+  const double* t1 = t1_.data();
+  double* factor = factor_.data();
+  for (size_t ii = 0; ii < size; ++ii)
+    factor[ii] = (time - t0[ii]) / (t1[ii] - t0[ii]);
+
+  // Same arithmetic as simCore::linearInterpolate(), so the results match LinearInterpolator
+  auto lerp = [size, factor](const std::vector<double>& low, const std::vector<double>& high, std::vector<double>& out) {
+    const double* lo = low.data();
+    const double* hi = high.data();
+    double* rv = out.data();
+    for (size_t ii = 0; ii < size; ++ii)
+      rv[ii] = lo[ii] + (hi[ii] - lo[ii]) * factor[ii];
+  };
+  auto step = [size, factor](const std::vector<double>& start, const std::vector<double>& delta, std::vector<double>& out) {
+    const double* st = start.data();
+    const double* de = delta.data();
+    double* rv = out.data();
+    for (size_t ii = 0; ii < size; ++ii)
+      rv[ii] = st[ii] + factor[ii] * de[ii];
+  };
+
+  lerp(x0_, x1_, x_);
+  lerp(y0_, y1_, y_);
+  lerp(z0_, z1_, z_);
+  step(yaw0_, yawStep_, yaw_);
+  step(pitch0_, pitchStep_, pitch_);
+  step(roll0_, rollStep_, roll_);
+  lerp(vx0_, vx1_, vx_);
+  lerp(vy0_, vy1_, vy_);
+  lerp(vz0_, vz1_, vz_);
+  lerp(alt0_, alt1_, alt_);
+}
+
+void PlatformBatchInterpolator::writeInterpolated_(size_t i, const Output& output) const
+{
+  // Use the interpolated geodetic altitude to prevent short cuts through the earth, as LinearInterpolator does
+  simCore::Vec3 lla;
+  simCore::CoordinateConverter::convertEcefToGeodeticPos(simCore::Vec3(x_[i], y_[i], z_[i]), lla);
+  simCore::Coordinate resultLla;
+  resultLla.setCoordinateSystem(simCore::COORD_SYS_LLA);
+  resultLla.setPositionLLA(lla.lat(), lla.lon(), alt_[i]);
+  if (parts_[i] & HAS_ORIENTATION)
+    resultLla.setOrientation(yaw_[i], pitch_[i], roll_[i]);
+  if (parts_[i] & HAS_VELOCITY)
+    resultLla.setVelocity(vx_[i], vy_[i], vz_[i]);
+
+  simCore::Coordinate resultEcef;
+  simCore::CoordinateConverter::convertGeodeticToEcef(resultLla, resultEcef);
+
+  const bool orientation = resultEcef.hasOrientation();
+  const bool velocity = resultEcef.hasVelocity();
+  write(output.x, i, resultEcef.x());
+  write(output.y, i, resultEcef.y());
+  write(output.z, i, resultEcef.z());
+  write(output.psi, i, orientation ? resultEcef.psi() : 0.0);
+  write(output.theta, i, orientation ? resultEcef.theta() : 0.0);
+  write(output.phi, i, orientation ? resultEcef.phi() : 0.0);
+  write(output.vx, i, velocity ? resultEcef.vx() : 0.0);
+  write(output.vy, i, velocity ? resultEcef.vy() : 0.0);
+  write(output.vz, i, velocity ? resultEcef.vz() : 0.0);
+  write<uint8_t>(output.flags, i, HAS_POSITION | INTERPOLATED | (orientation ? HAS_ORIENTATION : 0) | (velocity ? HAS_VELOCITY : 0));
+}
+
+}
@@ -0,0 +1,152 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_PLATFORMBATCHINTERPOLATOR_H
+#define SIMDATA_PLATFORMBATCHINTERPOLATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simData/DataTypes.h"
+#include "simData/ObjectId.h"
+
+namespace simData
+{
+
+class DataStore;
+
+/**
+ * Interpolates the TSPI of many platforms for one time in a single pass, writing into caller
+ * provided arrays.  This is an alternative to DataStore::update() with a LinearInterpolator or a
+ * NearestNeighborInterpolator for displays that only need the platform states each frame.
+ *
+ * The updates bracketing each platform's time are kept in a packed structure-of-arrays table along
+ * with their geodetic conversions, which are only recomputed when the bracket changes.  Each call
+ * finds the brackets, interpolates the whole table in plain loops that the compiler vectorizes, and
+ * then converts the interpolated geodetic states back to ECEF.  The results match those of the
+ * Interpolator for the same method.
+ */
+class SDKDATA_EXPORT PlatformBatchInterpolator
+{
+public:
+  /// Interpolation methods, matching the Interpolator implementations
+  enum class Method
+  {
+    LINEAR,           ///< Matches LinearInterpolator
+    NEAREST_NEIGHBOR  ///< Matches NearestNeighborInterpolator
+  };
+
+  /// Bits of the per platform flags written by interpolate()
+  enum StateFlags
+  {
+    HAS_POSITION = 0x01,    ///< x, y and z are valid; clear if the platform has no update at or before the time
+    HAS_ORIENTATION = 0x02, ///< psi, theta and phi are valid
+    HAS_VELOCITY = 0x04,    ///< vx, vy and vz are valid
+    INTERPOLATED = 0x08     ///< The time is between two updates, rather than at or after an update
+  };
+
+  /**
+   * Caller owned output arrays, each with one value per platform in the order of the IDs.  Values
+   * are ECEF, matching PlatformUpdate.  Arrays that are nullptr are not written.
+   */
+  struct Output
+  {
+    double* x = nullptr;      ///< ECEF X, meters
+    double* y = nullptr;      ///< ECEF Y, meters
+    double* z = nullptr;      ///< ECEF Z, meters
+    double* psi = nullptr;    ///< ECEF psi, radians
+    double* theta = nullptr;  ///< ECEF theta, radians
+    double* phi = nullptr;    ///< ECEF phi, radians
+    double* vx = nullptr;     ///< ECEF X velocity, m/s
+    double* vy = nullptr;     ///< ECEF Y velocity, m/s
+    double* vz = nullptr;     ///< ECEF Z velocity, m/s
+    uint8_t* flags = nullptr; ///< Bitwise OR of StateFlags
+  };
+
+  /** Constructs an interpolator for the given method */
+  explicit PlatformBatchInterpolator(Method method = Method::LINEAR);
+  ~PlatformBatchInterpolator();
+
+  /// Returns the interpolation method
+  Method method() const;
+
+  /**
+   * Interpolates the platforms at the given time.  Like the slice update of DataStore::update(), a
+   * time before the first update has no state, and a time after the last update returns the last
+   * update; life span preferences are not applied.
+   * @param dataStore Source of the platform updates; not changed
+   * @param time Time for the states
+   * @param ids Platforms to interpolate; entry i of each output array is for ids[i]
+   * @param output Arrays of ids.size() values
+   * @return 0 on success, non-zero if any ID is not a platform; the flags of those entries are 0
+   */
+  int interpolate(const DataStore& dataStore, double time, const std::vector<ObjectId>& ids, const Output& output);
+
+  /// Releases the bracket table; the next interpolate() rebuilds it
+  void clear();
+
+private:
+  /// What to write for one platform
+  enum class Kind : uint8_t
+  {
+    NONE,       ///< No state
+    COPY,       ///< Copy bracket update prev_
+    INTERPOLATE ///< Interpolate between prev_ and next_
+  };
+
+  /// Resizes the bracket table to the number of platforms
+  void resize_(size_t size);
+  /// Sets entry i of the bracket table to interpolate between prev and next, reusing the geodetic values if unchanged
+  void setBracket_(size_t i, const PlatformUpdate& prev, const PlatformUpdate& next);
+  /// Writes the copied update of entry i
+  void writeCopy_(size_t i, const PlatformUpdate& update, const Output& output) const;
+  /// Interpolates every entry of the table at the given time into the interpolated columns
+  void interpolateTable_(double time);
+  /// Converts entry i from the interpolated columns to ECEF and writes it
+  void writeInterpolated_(size_t i, const Output& output) const;
+
+  Method method_;
+
+  /// Kind of each entry for the current call
+  std::vector<Kind> kind_;
+  /// Bracketing updates of each entry, to detect when the geodetic values need recomputing
+  std::vector<PlatformUpdate> prev_;
+  std::vector<PlatformUpdate> next_;
+  /// True if the geodetic columns of the entry match prev_ and next_
+  std::vector<uint8_t> converted_;
+  /// Bits of HAS_ORIENTATION and HAS_VELOCITY when interpolating the entry
+  std::vector<uint8_t> parts_;
+
+  /// Bracket columns: times, ECEF positions, geodetic altitudes, orientation starts and steps, and geodetic velocities
+  std::vector<double> t0_, t1_;
+  std::vector<double> x0_, y0_, z0_, x1_, y1_, z1_;
+  std::vector<double> alt0_, alt1_;
+  std::vector<double> yaw0_, pitch0_, roll0_, yawStep_, pitchStep_, rollStep_;
+  std::vector<double> vx0_, vy0_, vz0_, vx1_, vy1_, vz1_;
+
+  /// Interpolated columns: time factor, ECEF position, geodetic altitude, orientation and velocity
+  std::vector<double> factor_, x_, y_, z_, alt_, yaw_, pitch_, roll_, vx_, vy_, vz_;
+};
+
+} // End of namespace simData
+
+#endif // SIMDATA_PLATFORMBATCHINTERPOLATOR_H
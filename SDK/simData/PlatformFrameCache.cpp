@@ -0,0 +1,276 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <iterator>
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simData/PlatformFrameCache.h"
+
+namespace
+{
+
+/// Orders frames by time
+bool earlier(const simData::PlatformFrames& lhs, const simData::PlatformFrames& rhs)
+{
+  return lhs.time < rhs.time;
+}
+
+/// Removes all but the last of each run of frames with the same time from a time ordered container
+template <typename Container>
+void keepLastOfEqualTimes(Container& frames)
+{
+  if (frames.size() < 2)
+    return;
+  size_t out = 0;
+  for (size_t in = 1; in < frames.size(); ++in)
+  {
+    if (frames[in].time != frames[out].time)
+      ++out;
+    if (out != in)
+      frames[out] = frames[in];
+  }
+  frames.erase(frames.begin() + (out + 1), frames.end());
+}
+
+}
+
+namespace simData
+{
+
+bool PlatformFrames::matches(const PlatformUpdate& update) const
+{
+  return (time == update.time()) &&
+    (ecef[0] == update.x()) && (ecef[1] == update.y()) && (ecef[2] == update.z()) &&
+    (ecefOrientation[0] == static_cast<float>(update.psi())) &&
+    (ecefOrientation[1] == static_cast<float>(update.theta())) &&
+    (ecefOrientation[2] == static_cast<float>(update.phi())) &&
+    (ecefVelocity[0] == static_cast<float>(update.vx())) &&
+    (ecefVelocity[1] == static_cast<float>(update.vy())) &&
+    (ecefVelocity[2] == static_cast<float>(update.vz()));
+}
+
+//----------------------------------------------------------------------------
+
+PlatformFrameCache::PlatformFrameCache()
+{
+}
+
+PlatformFrameCache::~PlatformFrameCache()
+{
+}
+
+void PlatformFrameCache::compute(const PlatformUpdate& update, PlatformFrames& frames)
+{
+  simCore::Vec3 pos;
+  update.position(pos);
+  simCore::Coordinate ecefCoord(simCore::COORD_SYS_ECEF, pos);
+
+  if (update.has_orientation())
+  {
+    simCore::Vec3 ori;
+    update.orientation(ori);
+    ecefCoord.setOrientation(ori);
+  }
+
+  if (update.has_velocity())
+  {
+    simCore::Vec3 vel;
+    update.velocity(vel);
+    ecefCoord.setVelocity(vel);
+  }
+
+  simCore::Coordinate llaCoord;
+  simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
+  compute(update, llaCoord, frames);
+}
+
+void PlatformFrameCache::compute(const PlatformUpdate& update, const simCore::Coordinate& llaCoord, PlatformFrames& frames)
+{
+  frames.time = update.time();
+  frames.ecef[0] = update.x();
+  frames.ecef[1] = update.y();
+  frames.ecef[2] = update.z();
+  frames.ecefOrientation[0] = static_cast<float>(update.psi());
+  frames.ecefOrientation[1] = static_cast<float>(update.theta());
+  frames.ecefOrientation[2] = static_cast<float>(update.phi());
+  frames.ecefVelocity[0] = static_cast<float>(update.vx());
+  frames.ecefVelocity[1] = static_cast<float>(update.vy());
+  frames.ecefVelocity[2] = static_cast<float>(update.vz());
+  frames.flags = 0;
+
+  frames.lla[0] = llaCoord.lat();
+  frames.lla[1] = llaCoord.lon();
+  frames.lla[2] = llaCoord.alt();
+
+  if (update.has_orientation())
+  {
+    frames.flags |= PlatformFrames::HAS_ORIENTATION;
+    simCore::Vec3 ori;
+    update.orientation(ori);
+    simCore::d3EulertoQ(ori, frames.quaternion);
+    frames.llaOrientation[0] = llaCoord.yaw();
+    frames.llaOrientation[1] = llaCoord.pitch();
+    frames.llaOrientation[2] = llaCoord.roll();
+  }
+  else
+  {
+    frames.quaternion[0] = 1.0;
+    frames.quaternion[1] = frames.quaternion[2] = frames.quaternion[3] = 0.0;
+    frames.llaOrientation[0] = frames.llaOrientation[1] = frames.llaOrientation[2] = 0.0;
+  }
+
+  if (update.has_velocity())
+  {
+    frames.flags |= PlatformFrames::HAS_VELOCITY;
+    frames.llaVelocity[0] = llaCoord.vx();
+    frames.llaVelocity[1] = llaCoord.vy();
+    frames.llaVelocity[2] = llaCoord.vz();
+  }
+  else
+    frames.llaVelocity[0] = frames.llaVelocity[1] = frames.llaVelocity[2] = 0.0;
+}
+
+void PlatformFrameCache::add(const PlatformUpdate& update)
+{
+  PlatformFrames frames;
+  compute(update, frames);
+
+  if (frames_.empty() || (frames_.back().time < frames.time))
+  {
+    frames_.push_back(frames);
+    return;
+  }
+
+  const size_t index = lowerBound_(frames.time) - frames_.cbegin();
+  if (frames_[index].time == frames.time)
+    frames_[index] = frames;
+  else
+    frames_.insert(frames_.begin() + index, frames);
+}
+
+void PlatformFrameCache::add(std::vector<PlatformFrames>&& frames)
+{
+  if (frames.empty())
+    return;
+
+  std::stable_sort(frames.begin(), frames.end(), earlier);
+  keepLastOfEqualTimes(frames);
+
+  // Usual case of newer data
+  if (frames_.empty() || (frames_.back().time < frames.front().time))
+  {
+    frames_.insert(frames_.end(), frames.begin(), frames.end());
+    return;
+  }
+
+  // Equal times keep the existing entry first, so the new entry replaces it
+  std::deque<PlatformFrames> merged;
+  std::merge(frames_.begin(), frames_.end(), frames.begin(), frames.end(), std::back_inserter(merged), earlier);
+  keepLastOfEqualTimes(merged);
+  frames_.swap(merged);
+}
+
+const PlatformFrames& PlatformFrameCache::get(const PlatformUpdate& update)
+{
+  // Playback usually asks for the entry after the previous one
+  size_t index = hint_ + 1;
+  if (index >= frames_.size() || frames_[index].time != update.time())
+    index = lowerBound_(update.time()) - frames_.cbegin();
+  hint_ = index;
+  if (index < frames_.size() && frames_[index].time == update.time())
+  {
+    // Recompute entries left behind by a replaced update
+    if (!frames_[index].matches(update))
+      compute(update, frames_[index]);
+    return frames_[index];
+  }
+
+  auto it = frames_.insert(frames_.begin() + index, PlatformFrames());
+  compute(update, *it);
+  return *it;
+}
+
+const PlatformFrames* PlatformFrameCache::find(const PlatformUpdate& update) const
+{
+  auto it = lowerBound_(update.time());
+  if (it != frames_.end() && it->matches(update))
+    return &*it;
+  return nullptr;
+}
+
+void PlatformFrameCache::eraseBefore(double time)
+{
+  while (!frames_.empty() && frames_.front().time < time)
+    frames_.pop_front();
+}
+
+void PlatformFrameCache::clear()
+{
+  frames_.clear();
+  hasCurrent_ = false;
+}
+
+size_t PlatformFrameCache::size() const
+{
+  return frames_.size();
+}
+
+void PlatformFrameCache::setCurrent(const PlatformUpdate* update)
+{
+  if (update == nullptr)
+  {
+    hasCurrent_ = false;
+    return;
+  }
+
+  if (hasCurrent_ && current_.matches(*update))
+    return;
+
+  const PlatformFrames* stored = find(*update);
+  if (stored != nullptr)
+    current_ = *stored;
+  else
+    compute(*update, current_);
+  hasCurrent_ = true;
+}
+
+void PlatformFrameCache::setCurrent(const PlatformFrames& frames)
+{
+  current_ = frames;
+  hasCurrent_ = true;
+}
+
+const PlatformFrames* PlatformFrameCache::current() const
+{
+  return hasCurrent_ ? &current_ : nullptr;
+}
+
+std::deque<PlatformFrames>::const_iterator PlatformFrameCache::lowerBound_(double time) const
+{
+  PlatformFrames key;
+  key.time = time;
+  return std::lower_bound(frames_.cbegin(), frames_.cend(), key, earlier);
+}
+
+}
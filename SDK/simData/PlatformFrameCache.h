@@ -0,0 +1,120 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_PLATFORMFRAMECACHE_H
+#define SIMDATA_PLATFORMFRAMECACHE_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "simCore/Common/Export.h"
+#include "simData/DataTypes.h"
+
+namespace simCore { class Coordinate; }
+
+namespace simData
+{
+
+/**
+ * Coordinate frames of one PlatformUpdate, computed once so that interpolation and drawing do
+ * not repeat the ECEF to geodetic conversion every time the update brackets the current time.
+ * The ECEF orientation and velocity are kept as stored in the update, which also lets a cached
+ * entry be checked against the update it came from.
+ */
+struct alignas(16) PlatformFrames
+{
+  /// Bits of flags
+  enum Flags
+  {
+    HAS_ORIENTATION = 0x01, ///< Orientation fields and the quaternion are valid
+    HAS_VELOCITY = 0x02     ///< Velocity fields are valid
+  };
+
+  double time = -1.0;            ///< Time of the update, seconds
+  double ecef[3] = { 0., 0., 0. }; ///< ECEF position, meters
+  double quaternion[4] = { 1., 0., 0., 0. }; ///< ECEF orientation as a quaternion (w, x, y, z)
+  double lla[3] = { 0., 0., 0. };            ///< Geodetic latitude and longitude in radians, altitude in meters
+  double llaOrientation[3] = { 0., 0., 0. }; ///< Yaw, pitch and roll in the local level frame, radians
+  double llaVelocity[3] = { 0., 0., 0. };    ///< Velocity in the local level frame, m/s
+  float ecefOrientation[3] = { 0.f, 0.f, 0.f }; ///< Psi, theta and phi exactly as stored in the update
+  float ecefVelocity[3] = { 0.f, 0.f, 0.f };    ///< Vx, vy and vz exactly as stored in the update
+  uint32_t flags = 0;            ///< Combination of Flags
+
+  /// Returns true if the frames were computed from an update with the same time and values
+  bool matches(const PlatformUpdate& update) const;
+};
+
+/**
+ * Time ordered PlatformFrames for the updates of one platform.  Entries are usually added as the
+ * updates are inserted into the data store, but every lookup checks the entry against the update
+ * and recomputes it on a mismatch, so entries left behind by flushes or replaced updates are never
+ * returned.  The cache also holds the frames of the platform's current, possibly interpolated, state.
+ */
+class SDKDATA_EXPORT PlatformFrameCache
+{
+public:
+  PlatformFrameCache();
+  virtual ~PlatformFrameCache();
+
+  /// Computes all the frames of the update, converting from ECEF to geodetic
+  static void compute(const PlatformUpdate& update, PlatformFrames& frames);
+  /// Computes the frames of the update using an already converted geodetic coordinate
+  static void compute(const PlatformUpdate& update, const simCore::Coordinate& llaCoord, PlatformFrames& frames);
+
+  /// Computes and stores the frames of the update, replacing any entry with the same time
+  void add(const PlatformUpdate& update);
+  /// Stores frames that were already computed, possibly on another thread, in any order
+  void add(std::vector<PlatformFrames>&& frames);
+
+  /// Returns the frames for the update, computing and storing them if needed
+  const PlatformFrames& get(const PlatformUpdate& update);
+  /// Returns the frames for the update, or nullptr if they are not stored
+  const PlatformFrames* find(const PlatformUpdate& update) const;
+
+  /// Removes the entries before the given time
+  void eraseBefore(double time);
+  /// Removes all entries, including the current frames
+  void clear();
+  /// Returns the number of stored entries
+  size_t size() const;
+
+  /// Sets the current frames to those of the update; nullptr indicates no current state
+  void setCurrent(const PlatformUpdate* update);
+  /// Sets the current frames to frames already computed for an interpolated state
+  void setCurrent(const PlatformFrames& frames);
+  /// Returns the frames of the current state, or nullptr if there is none
+  const PlatformFrames* current() const;
+
+private:
+  /// Returns the position of the first entry at or after the time
+  std::deque<PlatformFrames>::const_iterator lowerBound_(double time) const;
+
+  std::deque<PlatformFrames> frames_;
+  /// Index of the entry returned by the last get(), which speeds up sequential access
+  size_t hint_ = 0;
+  PlatformFrames current_;
+  bool hasCurrent_ = false;
+};
+
+}
+
+#endif /* SIMDATA_PLATFORMFRAMECACHE_H */
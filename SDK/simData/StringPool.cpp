@@ -0,0 +1,233 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "simData/StringPool.h"
+
+namespace simData
+{
+
+/// Size of the first arena chunk; later chunks double in size up to CHUNK_SIZE
+static const size_t FIRST_CHUNK_SIZE = 256;
+/// Largest size of an arena chunk
+static const size_t CHUNK_SIZE = 64 * 1024;
+/// Strings longer than this get a chunk of their own
+static const size_t LONG_STRING = CHUNK_SIZE / 4;
+/// Arena size below which compaction is not worth the copy
+static const size_t MIN_COMPACT_BYTES = 4 * CHUNK_SIZE;
+
+StringPool::StringPool()
+{
+}
+
+StringPool::~StringPool()
+{
+}
+
+uint32_t StringPool::acquire(std::string_view value)
+{
+  auto it = index_.find(value);
+  if (it != index_.end())
+  {
+    ++entries_[it->second].references;
+    return it->second;
+  }
+
+  uint32_t handle;
+  if (!freeEntries_.empty())
+  {
+    handle = freeEntries_.back();
+    freeEntries_.pop_back();
+  }
+  else
+  {
+    handle = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(Entry());
+  }
+
+  Entry& entry = entries_[handle];
+  store_(value, entry);
+  entry.references = 1;
+  index_[get(handle)] = handle;
+  return handle;
+}
+
+void StringPool::addReference(uint32_t handle)
+{
+  // Assertion failure means the handle was released or never acquired
+  assert(handle < entries_.size() && entries_[handle].references > 0);
+  ++entries_[handle].references;
+}
+
+void StringPool::release(uint32_t handle)
+{
+  // Assertion failure means the handle was released too many times
+  assert(handle < entries_.size() && entries_[handle].references > 0);
+  Entry& entry = entries_[handle];
+  if (--entry.references > 0)
+    return;
+
+  index_.erase(get(handle));
+  freeEntries_.push_back(handle);
+  if (entry.length == 0)
+    return;
+  Chunk& chunk = chunks_[entry.chunk];
+  chunk.live -= entry.length;
+  liveBytes_ -= entry.length;
+
+  // Free emptied chunks, except the one receiving new strings, which just starts over
+  if (chunk.live == 0)
+  {
+    if (entry.chunk == currentChunk_)
+      chunk.used = 0;
+    else
+    {
+      arenaBytes_ -= chunk.capacity;
+      chunk = Chunk();
+      freeChunks_.push_back(entry.chunk);
+    }
+  }
+
+  // Reclaim space pinned by a few long lived strings in otherwise empty chunks
+  if (arenaBytes_ >= MIN_COMPACT_BYTES && liveBytes_ < arenaBytes_ / 2)
+    compact_();
+}
+
+std::string_view StringPool::get(uint32_t handle) const
+{
+  assert(handle < entries_.size());
+  const Entry& entry = entries_[handle];
+  if (entry.length == 0)
+    return std::string_view();
+  return std::string_view(chunks_[entry.chunk].data.get() + entry.offset, entry.length);
+}
+
+size_t StringPool::numStrings() const
+{
+  return entries_.size() - freeEntries_.size();
+}
+
+size_t StringPool::memoryUsage() const
+{
+  // Hash nodes hold a view, a handle and a next pointer, plus one bucket pointer each
+  const size_t indexBytes = index_.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*)) + index_.bucket_count() * sizeof(void*);
+  return sizeof(*this) + arenaBytes_ + entries_.capacity() * sizeof(Entry) + freeEntries_.capacity() * sizeof(uint32_t) +
+    chunks_.capacity() * sizeof(Chunk) + freeChunks_.capacity() * sizeof(uint32_t) + indexBytes;
+}
+
+void StringPool::clear()
+{
+  index_.clear();
+  entries_.clear();
+  freeEntries_.clear();
+  chunks_.clear();
+  freeChunks_.clear();
+  currentChunk_ = NO_CHUNK;
+  arenaBytes_ = 0;
+  liveBytes_ = 0;
+}
+
+void StringPool::store_(std::string_view value, Entry& entry)
+{
+  entry.chunk = 0;
+  entry.offset = 0;
+  entry.length = static_cast<uint32_t>(value.size());
+  if (value.empty())
+    return;
+
+  // Long strings get a chunk of their own, so they do not waste the tail of a shared chunk
+  uint32_t index;
+  if (value.size() > LONG_STRING)
+    index = newChunk_(value.size());
+  else
+  {
+    if (currentChunk_ == NO_CHUNK)
+      currentChunk_ = newChunk_(std::max(FIRST_CHUNK_SIZE, value.size()));
+    else if (chunks_[currentChunk_].capacity - chunks_[currentChunk_].used < value.size())
+    {
+      // Small pools stay small; busy ones grow to full sized chunks
+      const size_t capacity = std::min(CHUNK_SIZE, 2 * chunks_[currentChunk_].capacity);
+      currentChunk_ = newChunk_(std::max(capacity, value.size()));
+    }
+    index = currentChunk_;
+  }
+
+  Chunk& chunk = chunks_[index];
+  std::memcpy(chunk.data.get() + chunk.used, value.data(), value.size());
+  entry.chunk = index;
+  entry.offset = static_cast<uint32_t>(chunk.used);
+  chunk.used += value.size();
+  chunk.live += value.size();
+  liveBytes_ += value.size();
+}
+
+uint32_t StringPool::newChunk_(size_t capacity)
+{
+  uint32_t index;
+  if (!freeChunks_.empty())
+  {
+    index = freeChunks_.back();
+    freeChunks_.pop_back();
+  }
+  else
+  {
+    index = static_cast<uint32_t>(chunks_.size());
+    chunks_.push_back(Chunk());
+  }
+  Chunk& chunk = chunks_[index];
+  chunk.data.reset(new char[capacity]);
+  chunk.capacity = capacity;
+  arenaBytes_ += capacity;
+  return index;
+}
+
+void StringPool::compact_()
+{
+  std::vector<Chunk> oldChunks;
+  oldChunks.swap(chunks_);
+  freeChunks_.clear();
+  currentChunk_ = NO_CHUNK;
+  arenaBytes_ = 0;
+  liveBytes_ = 0;
+  // Replace the index rather than clearing it, to release its buckets too
+  std::unordered_map<std::string_view, uint32_t>().swap(index_);
+  index_.reserve(numStrings());
+
+  for (uint32_t handle = 0; handle < entries_.size(); ++handle)
+  {
+    Entry& entry = entries_[handle];
+    if (entry.references == 0)
+      continue;
+    if (entry.length == 0)
+    {
+      index_[std::string_view()] = handle;
+      continue;
+    }
+    const std::string_view value(oldChunks[entry.chunk].data.get() + entry.offset, entry.length);
+    store_(value, entry);
+    index_[get(handle)] = handle;
+  }
+}
+
+}
@@ -0,0 +1,114 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_STRINGPOOL_H
+#define SIMDATA_STRINGPOOL_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "simCore/Common/Common.h"
+
+namespace simData
+{
+
+/**
+ * Reference counted pool of interned strings.  Each distinct string is stored once, in arena
+ * chunks rather than a heap allocation per string, and is identified by a small integer handle
+ * that stays valid until its last reference is released.  Chunks start small and double in size
+ * as the pool fills, so a pool holding a few strings costs little.  Released strings are reclaimed
+ * immediately: emptied chunks are freed, and once less than half of the arena holds live strings
+ * the survivors are compacted into fresh chunks.  Handles are never moved by compaction.
+ */
+class SDKDATA_EXPORT StringPool
+{
+public:
+  StringPool();
+  virtual ~StringPool();
+
+  SDK_DISABLE_COPY_MOVE(StringPool);
+
+  /// Returns the handle of the string, adding a reference; the string is copied into the pool if new
+  uint32_t acquire(std::string_view value);
+  /// Adds a reference to the handle
+  void addReference(uint32_t handle);
+  /// Removes a reference to the handle; the string is reclaimed when no references remain
+  void release(uint32_t handle);
+  /// Returns the string of a handle with references; valid until the next acquire() or release()
+  std::string_view get(uint32_t handle) const;
+
+  /// Number of distinct strings with references
+  size_t numStrings() const;
+  /// Approximate number of bytes used by the pool, including its arena and index
+  size_t memoryUsage() const;
+  /// Removes all strings, invalidating every handle
+  void clear();
+
+private:
+  /// Location and reference count of one string
+  struct Entry
+  {
+    uint32_t chunk = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint32_t references = 0;
+  };
+  /// Arena block holding the bytes of many strings
+  struct Chunk
+  {
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+    size_t used = 0;
+    /// Bytes of strings that still have references
+    size_t live = 0;
+  };
+
+  /// Copies the bytes into the arena, setting the location of the entry
+  void store_(std::string_view value, Entry& entry);
+  /// Allocates a chunk, reusing a freed slot if possible, and returns its index
+  uint32_t newChunk_(size_t capacity);
+  /// Moves every live string into new chunks
+  void compact_();
+
+  std::vector<Entry> entries_;
+  /// Handles of entries without references, for reuse
+  std::vector<uint32_t> freeEntries_;
+  /// Chunks of the arena; freed chunks have no data
+  std::vector<Chunk> chunks_;
+  /// Indices of freed chunks, for reuse
+  std::vector<uint32_t> freeChunks_;
+  /// Value of currentChunk_ when there is no chunk
+  static const uint32_t NO_CHUNK = 0xffffffff;
+  /// Chunk receiving new short strings
+  uint32_t currentChunk_ = NO_CHUNK;
+  /// Sum of the capacities and live bytes of all chunks
+  size_t arenaBytes_ = 0;
+  size_t liveBytes_ = 0;
+  /// Handle of each interned string, viewing the bytes in the arena
+  std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+}
+
+#endif /* SIMDATA_STRINGPOOL_H */
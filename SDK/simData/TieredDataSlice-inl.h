@@ -0,0 +1,735 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_TIEREDDATASLICE_INL_H
+#define SIMDATA_TIEREDDATASLICE_INL_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include "simData/DataSliceUpdaters.h"
+
+namespace simData
+{
+
+namespace TieredSliceHelper
+{
+
+/// Appends the value as a base 128 varint, low bits first
+inline void putVarint(std::vector<uint8_t>& bytes, uint64_t value)
+{
+  while (value >= 0x80)
+  {
+    bytes.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  bytes.push_back(static_cast<uint8_t>(value));
+}
+
+/// Reads a varint written by putVarint() and advances ptr past it
+inline uint64_t getVarint(const uint8_t*& ptr)
+{
+  uint64_t rv = 0;
+  for (unsigned int shift = 0; ; shift += 7)
+  {
+    const uint8_t byte = *ptr++;
+    rv |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return rv;
+  }
+}
+
+/// Appends the low 'width' bytes of value, without their leading and trailing zero bytes, after a control byte holding the zero counts
+inline void putTrimmed(std::vector<uint8_t>& bytes, uint64_t value, unsigned int width)
+{
+  if (value == 0)
+  {
+    bytes.push_back(static_cast<uint8_t>(width << 4));
+    return;
+  }
+
+  unsigned int lead = 0;
+  while (((value >> (8 * (width - 1 - lead))) & 0xff) == 0)
+    ++lead;
+  unsigned int trail = 0;
+  while (((value >> (8 * trail)) & 0xff) == 0)
+    ++trail;
+
+  bytes.push_back(static_cast<uint8_t>((lead << 4) | trail));
+  for (unsigned int ii = trail; ii < width - lead; ++ii)
+    bytes.push_back(static_cast<uint8_t>(value >> (8 * ii)));
+}
+
+/// Reads a value written by putTrimmed() and advances ptr past it
+inline uint64_t getTrimmed(const uint8_t*& ptr, unsigned int width)
+{
+  const unsigned int lead = *ptr >> 4;
+  const unsigned int trail = *ptr & 0xf;
+  ++ptr;
+
+  uint64_t rv = 0;
+  for (unsigned int ii = trail; ii < width - lead; ++ii)
+    rv |= static_cast<uint64_t>(*ptr++) << (8 * ii);
+  return rv;
+}
+
+/// Maps small negative and positive values to small unsigned values
+template <typename Bits>
+Bits zigzag(Bits value)
+{
+  return static_cast<Bits>((value << 1) ^ (Bits(0) - (value >> (8 * sizeof(Bits) - 1))));
+}
+
+/// Inverse of zigzag()
+template <typename Bits>
+Bits unzigzag(Bits value)
+{
+  return static_cast<Bits>((value >> 1) ^ (Bits(0) - (value & 1)));
+}
+
+/// Column encodings, stored in the byte before each column
+enum ColumnEncoding : uint8_t
+{
+  DELTA_OF_DELTA = 0,  ///< zigzag varint of the change in the difference between successive bit patterns
+  XOR_PREVIOUS = 1     ///< bit pattern XOR the previous one, without its zero bytes; see putTrimmed()
+};
+
+/**
+ * Appends the ColumnChunkSize bit patterns in the smaller of the two encodings.  Bit patterns of
+ * same-signed values are ordered like the values, so smoothly changing values and regularly
+ * spaced times have delta-of-deltas near zero.  Noisy values still share their sign, exponent and
+ * high mantissa bits with the previous value, which XOR removes.
+ */
+template <typename Bits>
+void putColumn(std::vector<uint8_t>& bytes, const Bits* bits)
+{
+  std::vector<uint8_t> deltas;
+  std::vector<uint8_t> xors;
+  Bits prevDelta = 0;
+  for (size_t ii = 0; ii < ColumnChunkSize; ++ii)
+  {
+    const Bits prev = (ii == 0) ? 0 : bits[ii - 1];
+    const Bits delta = static_cast<Bits>(bits[ii] - prev);
+    putVarint(deltas, zigzag<Bits>(static_cast<Bits>(delta - prevDelta)));
+    putTrimmed(xors, bits[ii] ^ prev, sizeof(Bits));
+    prevDelta = delta;
+  }
+
+  const bool useDeltas = deltas.size() <= xors.size();
+  bytes.push_back(useDeltas ? DELTA_OF_DELTA : XOR_PREVIOUS);
+  const std::vector<uint8_t>& column = useDeltas ? deltas : xors;
+  bytes.insert(bytes.end(), column.begin(), column.end());
+}
+
+/// Reads ColumnChunkSize bit patterns written by putColumn() and advances ptr past them
+template <typename Bits>
+void getColumn(const uint8_t*& ptr, Bits* bits)
+{
+  const uint8_t encoding = *ptr++;
+  Bits prev = 0;
+  Bits prevDelta = 0;
+  for (size_t ii = 0; ii < ColumnChunkSize; ++ii)
+  {
+    if (encoding == DELTA_OF_DELTA)
+    {
+      prevDelta = static_cast<Bits>(prevDelta + unzigzag<Bits>(static_cast<Bits>(getVarint(ptr))));
+      prev = static_cast<Bits>(prev + prevDelta);
+    }
+    else
+      prev ^= static_cast<Bits>(getTrimmed(ptr, sizeof(Bits)));
+    bits[ii] = prev;
+  }
+}
+
+/// Compresses ColumnChunkSize time ordered updates into the block; see ColdBlock
+template <typename T>
+void encode(T* const* updates, ColdBlock& block)
+{
+  std::unique_ptr<ColumnChunk<T> > chunk(new ColumnChunk<T>());
+  for (size_t ii = 0; ii < ColumnChunkSize; ++ii)
+  {
+    chunk->times[ii] = updates[ii]->time();
+    ColumnLayout<T>::store(*updates[ii], chunk->doubles.data(), chunk->floats.data(), chunk->flags[ii], ii);
+  }
+
+  block.firstTime = chunk->times[0];
+  block.lastTime = chunk->times[ColumnChunkSize - 1];
+  block.bytes.clear();
+
+  // The columns are reinterpreted as bit patterns in place
+  static_assert(sizeof(double) == sizeof(uint64_t) && sizeof(float) == sizeof(uint32_t), "Unexpected floating point size");
+  std::array<uint64_t, ColumnChunkSize> bits;
+  memcpy(bits.data(), chunk->times.data(), sizeof(bits));
+  putColumn(block.bytes, bits.data());
+  for (size_t column = 0; column < ColumnLayout<T>::NumDoubles; ++column)
+  {
+    memcpy(bits.data(), &chunk->doubles[column * ColumnChunkSize], sizeof(bits));
+    putColumn(block.bytes, bits.data());
+  }
+  std::array<uint32_t, ColumnChunkSize> floatBits;
+  for (size_t column = 0; column < ColumnLayout<T>::NumFloats; ++column)
+  {
+    memcpy(floatBits.data(), &chunk->floats[column * ColumnChunkSize], sizeof(floatBits));
+    putColumn(block.bytes, floatBits.data());
+  }
+
+  for (size_t ii = 0; ii < ColumnChunkSize; )
+  {
+    size_t run = 1;
+    while ((ii + run < ColumnChunkSize) && (chunk->flags[ii + run] == chunk->flags[ii]))
+      ++run;
+    putVarint(block.bytes, run);
+    block.bytes.push_back(chunk->flags[ii]);
+    ii += run;
+  }
+
+  block.bytes.shrink_to_fit();
+}
+
+/// Decompresses the block into ColumnChunkSize updates
+template <typename T>
+void decode(const ColdBlock& block, T* updates)
+{
+  std::unique_ptr<ColumnChunk<T> > chunk(new ColumnChunk<T>());
+  const uint8_t* ptr = block.bytes.data();
+
+  std::array<uint64_t, ColumnChunkSize> bits;
+  getColumn(ptr, bits.data());
+  memcpy(chunk->times.data(), bits.data(), sizeof(bits));
+  for (size_t column = 0; column < ColumnLayout<T>::NumDoubles; ++column)
+  {
+    getColumn(ptr, bits.data());
+    memcpy(&chunk->doubles[column * ColumnChunkSize], bits.data(), sizeof(bits));
+  }
+  std::array<uint32_t, ColumnChunkSize> floatBits;
+  for (size_t column = 0; column < ColumnLayout<T>::NumFloats; ++column)
+  {
+    getColumn(ptr, floatBits.data());
+    memcpy(&chunk->floats[column * ColumnChunkSize], floatBits.data(), sizeof(floatBits));
+  }
+
+  for (size_t ii = 0; ii < ColumnChunkSize; )
+  {
+    const size_t run = static_cast<size_t>(getVarint(ptr));
+    const uint8_t flags = *ptr++;
+    for (size_t jj = 0; jj < run && ii < ColumnChunkSize; ++jj, ++ii)
+      chunk->flags[ii] = flags;
+  }
+  assert(ptr == block.bytes.data() + block.bytes.size());
+
+  for (size_t ii = 0; ii < ColumnChunkSize; ++ii)
+  {
+    ColumnLayout<T>::load(chunk->doubles.data(), chunk->floats.data(), chunk->flags[ii], ii, updates[ii]);
+    updates[ii].set_time(chunk->times[ii]);
+  }
+}
+
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+TieredDataSlice<T>::TieredDataSlice(size_t coldBudget)
+  : IndexedDataSlice<T, TieredDataSlice<T> >(),
+    coldBudget_(coldBudget),
+    firstSequence_(0),
+    blockBytes_(0),
+    mostRecent_(0)
+{
+}
+
+template <typename T>
+TieredDataSlice<T>::~TieredDataSlice()
+{
+  clearCold_();
+}
+
+template <typename T>
+void TieredDataSlice<T>::flush(bool keepStatic)
+{
+  clearCold_();
+  if (this->current_ == &this->currentExact_)
+    this->current_ = nullptr;
+  MemoryDataSlice<T>::flush(keepStatic);
+}
+
+template <typename T>
+void TieredDataSlice<T>::flush(double startTime, double endTime)
+{
+  const size_t cold = numColdItems();
+  if ((cold != 0) && (startTime <= lastColdTime_()) && (endTime > timeAt(0)))
+  {
+    // endTime is non-inclusive
+    rebuildCold_([startTime, endTime](std::vector<T*>& updates) {
+      auto start = std::lower_bound(updates.begin(), updates.end(), startTime, UpdateComp<T>());
+      auto end = std::lower_bound(start, updates.end(), endTime, UpdateComp<T>());
+      for (auto it = start; it != end; ++it)
+        delete *it;
+      updates.erase(start, end);
+    });
+    this->current_ = nullptr;
+  }
+  MemoryDataSlice<T>::flush(startTime, endTime);
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::numItems() const
+{
+  return numColdItems() + this->updates_.size();
+}
+
+template <typename T>
+void TieredDataSlice<T>::visit(typename DataSlice<T>::Visitor *visitor) const
+{
+  if (!blocks_.empty())
+  {
+    // Decode outside of the cache, so that visiting does not evict the blocks in use by iterators
+    std::unique_ptr<T[]> scratch(new T[ColumnChunkSize]);
+    for (const auto& block : blocks_)
+    {
+      TieredSliceHelper::decode(block, scratch.get());
+      for (size_t ii = 0; ii < ColumnChunkSize; ++ii)
+        (*visitor)(&scratch[ii]);
+    }
+  }
+  for (const auto* update : staged_)
+    (*visitor)(update);
+  MemoryDataSlice<T>::visit(visitor);
+}
+
+template <typename T>
+void TieredDataSlice<T>::insert(T *data)
+{
+  if ((numColdItems() == 0) || (data->time() > lastColdTime_()))
+  {
+    MemoryDataSlice<T>::insert(data);
+    return;
+  }
+
+  std::vector<T*> older(1, data);
+  insertCold_(older);
+}
+
+template <typename T>
+void TieredDataSlice<T>::insertMany(std::vector<T*>& data)
+{
+  if (!data.empty() && (numColdItems() != 0))
+  {
+    // Stable, so that the last of several equal times still wins
+    const double lastCold = lastColdTime_();
+    auto split = std::stable_partition(data.begin(), data.end(), [lastCold](const T* update) { return update->time() <= lastCold; });
+    if (split != data.begin())
+    {
+      std::vector<T*> older(data.begin(), split);
+      data.erase(data.begin(), split);
+      insertCold_(older);
+    }
+  }
+  MemoryDataSlice<T>::insertMany(data);
+}
+
+template <typename T>
+void TieredDataSlice<T>::limitByTime(double timeWindow)
+{
+  if ((timeWindow < 0) || this->updates_.empty())
+    return;
+
+  const double timeLimit = this->updates_.back()->time() - timeWindow;
+  if (timeLimit < 0.0)
+    return;
+
+  // always leave one point
+  auto newFirst = std::upper_bound(this->updates_.begin(), this->updates_.end(), timeLimit, UpdateComp<T>());
+  if (newFirst == this->updates_.end())
+    --newFirst;
+  if (newFirst == this->updates_.begin())
+    return;
+
+  demote_(newFirst - this->updates_.begin());
+}
+
+template <typename T>
+void TieredDataSlice<T>::limitByPoints(uint32_t limitPoints)
+{
+  // zero is special case for "no limit"
+  if ((limitPoints == 0) || (this->updates_.size() <= limitPoints))
+    return;
+
+  demote_(this->updates_.size() - limitPoints);
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::memoryUsage() const
+{
+  return hotMemoryUsage() + coldMemoryUsage();
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::hotMemoryUsage() const
+{
+  return sizeof(*this) + this->updates_.size() * (sizeof(T*) + sizeof(T));
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::coldMemoryUsage() const
+{
+  size_t rv = blockBytes_ + blocks_.size() * sizeof(ColdBlock) + staged_.capacity() * sizeof(T*) + staged_.size() * sizeof(T);
+  for (const auto& decoded : decoded_)
+  {
+    if (decoded.updates)
+      rv += ColumnChunkSize * sizeof(T);
+  }
+  rv += views_.size() * sizeof(std::unique_ptr<T[]>);
+  for (const auto& views : views_)
+  {
+    if (views)
+      rv += ColumnChunkSize * sizeof(T);
+  }
+  return rv;
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::numHotItems() const
+{
+  return this->updates_.size();
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::numColdItems() const
+{
+  return numBlockItems_() + staged_.size();
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::coldBudget() const
+{
+  return coldBudget_;
+}
+
+template <typename T>
+double TieredDataSlice<T>::timeAt(size_t index) const
+{
+  const size_t blockItems = numBlockItems_();
+  if (index < blockItems)
+    return blockUpdates_(index / ColumnChunkSize)[index % ColumnChunkSize].time();
+  return at(index)->time();
+}
+
+template <typename T>
+const T* TieredDataSlice<T>::at(size_t index) const
+{
+  assert(index < numItems());
+  const size_t blockItems = numBlockItems_();
+  if (index < blockItems)
+  {
+    // Views are kept until the block is discarded, so that callers may hold on to them like hot updates
+    const size_t block = index / ColumnChunkSize;
+    std::unique_ptr<T[]>& views = views_[block];
+    if (!views)
+    {
+      views.reset(new T[ColumnChunkSize]);
+      const T* decoded = blockUpdates_(block);
+      std::copy(decoded, decoded + ColumnChunkSize, views.get());
+    }
+    return &views[index % ColumnChunkSize];
+  }
+  index -= blockItems;
+  if (index < staged_.size())
+    return staged_[index];
+  return this->updates_[index - staged_.size()];
+}
+
+template <typename T>
+const T* TieredDataSlice<T>::blockUpdates_(size_t block) const
+{
+  const size_t sequence = firstSequence_ + block;
+  if (decoded_[mostRecent_].sequence == sequence)
+    return decoded_[mostRecent_].updates.get();
+
+  mostRecent_ = 1 - mostRecent_;
+  DecodedBlock& decoded = decoded_[mostRecent_];
+  if (decoded.sequence != sequence)
+  {
+    if (!decoded.updates)
+      decoded.updates.reset(new T[ColumnChunkSize]);
+    TieredSliceHelper::decode(blocks_[block], decoded.updates.get());
+    decoded.sequence = sequence;
+  }
+  return decoded.updates.get();
+}
+
+template <typename T>
+void TieredDataSlice<T>::load_(size_t index, T& update) const
+{
+  const size_t blockItems = numBlockItems_();
+  if (index < blockItems)
+    update = blockUpdates_(index / ColumnChunkSize)[index % ColumnChunkSize];
+  else
+    update = *at(index);
+}
+
+template <typename T>
+void TieredDataSlice<T>::demote_(size_t count)
+{
+  auto last = this->updates_.begin() + count;
+  if (coldBudget_ == 0)
+  {
+    for (auto it = this->updates_.begin(); it != last; ++it)
+    {
+      forget_(*it);
+      delete *it;
+    }
+  }
+  else
+    staged_.insert(staged_.end(), this->updates_.begin(), last);
+  this->updates_.erase(this->updates_.begin(), last);
+  if (this->timeIndex_)
+    this->timeIndex_->eraseFront(count);
+
+  compressStaged_();
+  enforceBudget_();
+
+  this->fastUpdate_.invalidate();
+  if (this->notifierFn_)
+    this->notifierFn_();
+}
+
+template <typename T>
+void TieredDataSlice<T>::compressStaged_()
+{
+  size_t done = 0;
+  while (staged_.size() - done >= ColumnChunkSize)
+  {
+    blocks_.push_back(ColdBlock());
+    views_.push_back(nullptr);
+    TieredSliceHelper::encode(&staged_[done], blocks_.back());
+    blockBytes_ += blocks_.back().bytes.capacity();
+    for (size_t ii = done; ii < done + ColumnChunkSize; ++ii)
+    {
+      forget_(staged_[ii]);
+      delete staged_[ii];
+    }
+    done += ColumnChunkSize;
+  }
+  staged_.erase(staged_.begin(), staged_.begin() + done);
+}
+
+template <typename T>
+void TieredDataSlice<T>::enforceBudget_()
+{
+  const size_t stagedBytes = staged_.size() * (sizeof(T*) + sizeof(T));
+  while (!blocks_.empty() && (blockBytes_ + blocks_.size() * sizeof(ColdBlock) + stagedBytes > coldBudget_))
+  {
+    blockBytes_ -= blocks_.front().bytes.capacity();
+    blocks_.pop_front();
+    views_.pop_front();
+    ++firstSequence_;
+    // the current update may have been discarded
+    this->dirty_ = true;
+  }
+}
+
+template <typename T>
+void TieredDataSlice<T>::clearCold_()
+{
+  for (auto* update : staged_)
+  {
+    forget_(update);
+    delete update;
+  }
+  std::vector<T*>().swap(staged_);
+  blocks_.clear();
+  views_.clear();
+  blockBytes_ = 0;
+  firstSequence_ = 0;
+  for (auto& decoded : decoded_)
+  {
+    decoded.sequence = ~static_cast<size_t>(0);
+    decoded.updates.reset();
+  }
+}
+
+template <typename T>
+void TieredDataSlice<T>::rebuildCold_(const std::function<void(std::vector<T*>&)>& edit)
+{
+  std::vector<T*> updates;
+  updates.reserve(numColdItems());
+  for (size_t ii = 0; ii < blocks_.size(); ++ii)
+  {
+    const T* decoded = blockUpdates_(ii);
+    for (size_t jj = 0; jj < ColumnChunkSize; ++jj)
+      updates.push_back(new T(decoded[jj]));
+  }
+  for (auto* update : staged_)
+  {
+    forget_(update);
+    updates.push_back(update);
+  }
+  staged_.clear();
+  clearCold_();
+
+  edit(updates);
+  staged_.swap(updates);
+  compressStaged_();
+  enforceBudget_();
+  this->dirty_ = true;
+}
+
+template <typename T>
+void TieredDataSlice<T>::insertCold_(std::vector<T*>& data)
+{
+  if (this->notifierFn_)
+    this->notifierFn_();
+
+  this->sortUnique_(data);
+  rebuildCold_([&data](std::vector<T*>& updates) {
+    std::vector<T*> merged;
+    merged.reserve(updates.size() + data.size());
+    auto oldIter = updates.begin();
+    auto newIter = data.begin();
+    while (oldIter != updates.end() && newIter != data.end())
+    {
+      if ((*oldIter)->time() < (*newIter)->time())
+        merged.push_back(*oldIter++);
+      else
+      {
+        if ((*oldIter)->time() == (*newIter)->time())
+          delete *oldIter++;
+        merged.push_back(*newIter++);
+      }
+    }
+    merged.insert(merged.end(), oldIter, updates.end());
+    merged.insert(merged.end(), newIter, data.end());
+    updates.swap(merged);
+  });
+  data.clear();
+
+  // the current update may have been replaced
+  if (this->current_ == &this->currentExact_)
+    this->current_ = nullptr;
+}
+
+template <typename T>
+void TieredDataSlice<T>::forget_(const T* update)
+{
+  if (this->current_ == update)
+  {
+    this->currentExact_ = *update;
+    this->current_ = &this->currentExact_;
+  }
+  if ((this->bounds_.first == update) || (this->bounds_.second == update))
+  {
+    this->bounds_ = typename DataSlice<T>::Bounds(static_cast<T*>(nullptr), static_cast<T*>(nullptr));
+    this->dirty_ = true;
+  }
+}
+
+template <typename T>
+const T* TieredDataSlice<T>::bound_(size_t index, T& scratch) const
+{
+  const size_t cold = numColdItems();
+  if (index >= cold)
+    return this->updates_[index - cold];
+  return IndexedDataSlice<T, TieredDataSlice<T> >::bound_(index, scratch);
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::numBlockItems_() const
+{
+  return blocks_.size() * ColumnChunkSize;
+}
+
+template <typename T>
+double TieredDataSlice<T>::lastColdTime_() const
+{
+  if (!staged_.empty())
+    return staged_.back()->time();
+  return blocks_.back().lastTime;
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::lowerBoundIndex_(double time) const
+{
+  const size_t cold = numColdItems();
+  if ((cold == 0) || (time > lastColdTime_()))
+  {
+    // Sequential playback usually lands next to the previous result, so look there first
+    const auto begin = this->updates_.cbegin();
+    const auto end = this->updates_.cend();
+    const auto hint = ((this->fastIndex_ >= cold) && (this->fastIndex_ - cold < this->updates_.size())) ? begin + (this->fastIndex_ - cold) : end;
+    return cold + (computeLowerBound<typename std::deque<T*>::const_iterator, T>(begin, hint, end, time, this->timeIndex_.get()) - begin);
+  }
+
+  const size_t blockItems = numBlockItems_();
+  if (blocks_.empty() || (time > blocks_.back().lastTime))
+    return blockItems + (std::lower_bound(staged_.begin(), staged_.end(), time, UpdateComp<T>()) - staged_.begin());
+
+  // First block that ends at or after the time, then the first update at or after the time within it
+  const size_t block = std::lower_bound(blocks_.begin(), blocks_.end(), time,
+    [](const ColdBlock& lhs, double rhs) { return lhs.lastTime < rhs; }) - blocks_.begin();
+  const T* updates = blockUpdates_(block);
+  return block * ColumnChunkSize + (std::lower_bound(updates, updates + ColumnChunkSize, time,
+    [](const T& lhs, double rhs) { return lhs.time() < rhs; }) - updates);
+}
+
+template <typename T>
+size_t TieredDataSlice<T>::upperBoundIndex_(double time) const
+{
+  const size_t cold = numColdItems();
+  if ((cold == 0) || (time >= lastColdTime_()))
+  {
+    // Sequential playback usually lands next to the previous result, so look there first
+    const auto begin = this->updates_.cbegin();
+    const auto end = this->updates_.cend();
+    const auto hint = ((this->fastIndex_ >= cold) && (this->fastIndex_ - cold < this->updates_.size())) ? begin + (this->fastIndex_ - cold) : end;
+    return cold + (computeUpperBound<typename std::deque<T*>::const_iterator, T>(begin, hint, end, time, this->timeIndex_.get()) - begin);
+  }
+
+  const size_t blockItems = numBlockItems_();
+  if (blocks_.empty() || (time >= blocks_.back().lastTime))
+    return blockItems + (std::upper_bound(staged_.begin(), staged_.end(), time, UpdateComp<T>()) - staged_.begin());
+
+  // First block that ends after the time, then the first update after the time within it
+  const size_t block = std::upper_bound(blocks_.begin(), blocks_.end(), time,
+    [](double lhs, const ColdBlock& rhs) { return lhs < rhs.lastTime; }) - blocks_.begin();
+  const T* updates = blockUpdates_(block);
+  return block * ColumnChunkSize + (std::upper_bound(updates, updates + ColumnChunkSize, time,
+    [](double lhs, const T& rhs) { return lhs < rhs.time(); }) - updates);
+}
+
+template <typename T>
+void TieredDataSlice<T>::setCurrentIndex_(size_t index)
+{
+  // Hot updates are used in place; MemoryDataSlice clears current_ when one is replaced or removed
+  const size_t cold = numColdItems();
+  if ((index >= cold) && (index < numItems()))
+  {
+    this->fastIndex_ = index;
+    this->setCurrent(this->updates_[index - cold]);
+    return;
+  }
+  IndexedDataSlice<T, TieredDataSlice<T> >::setCurrentIndex_(index);
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_TIEREDDATASLICE_INL_H
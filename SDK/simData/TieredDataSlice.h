@@ -0,0 +1,190 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_TIEREDDATASLICE_H
+#define SIMDATA_TIEREDDATASLICE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simData/ColumnarDataSlice.h"
+
+namespace simData
+{
+
+/**
+ * Immutable block of ColumnChunkSize updates that were pushed out of the hot tier of a
+ * TieredDataSlice.  The time and each ColumnLayout column are stored as bit patterns, either as
+ * zigzag varint delta-of-deltas or XORed with the previous value and stripped of zero bytes,
+ * whichever is smaller for that column.  Regular times and smooth tracks take about a byte per
+ * value.  The flags are run length encoded.  The encoding is lossless.
+ */
+struct ColdBlock
+{
+  /// Time of the first update in the block
+  double firstTime = 0.0;
+  /// Time of the last update in the block
+  double lastTime = 0.0;
+  /// Encoded update fields
+  std::vector<uint8_t> bytes;
+};
+
+/**
+ * MemoryDataSlice with a second, compressed tier for updates removed by data limiting.  The
+ * newest updates are kept in the hot tier, which behaves like a MemoryDataSlice, and the data
+ * limits from the prefs apply to the hot tier only.  Updates pushed out of the hot tier are
+ * staged and then compressed into ColdBlock objects of ColumnChunkSize updates.  The oldest
+ * blocks are discarded once the cold tier exceeds its byte budget.
+ *
+ * The cold tier stays part of the slice.  numItems(), lower_bound(), upper_bound(), visit()
+ * and update() all see the cold and hot updates as a single time ordered sequence:
+ *  - update() copies cold updates into the slice, like ColumnarDataSlice.
+ *  - Iterators materialize a whole cold block of views on first access.  Views stay valid until
+ *    their block is discarded by the cold budget or by flushing, which calls the notifier.
+ *  - Searches decode into a small cache of their own, so they do not materialize views.
+ *  - visit() passes cold updates in a temporary that is only valid for the duration of the callback.
+ *  - Inserting or flushing in the time span of the cold tier rebuilds the cold tier and releases
+ *    its views; this is slow, but is not expected during normal data limited playback.
+ * Available for PlatformUpdate, BeamUpdate and GateUpdate; see ColumnLayout.
+ */
+template <typename T>
+class TieredDataSlice : public IndexedDataSlice<T, TieredDataSlice<T> >
+{
+  friend class IndexedDataSlice<T, TieredDataSlice<T> >;
+
+public:
+  /** @param coldBudget Bytes of cold storage to keep; 0 deletes updates removed by data limiting, like MemoryDataSlice */
+  explicit TieredDataSlice(size_t coldBudget);
+  virtual ~TieredDataSlice();
+  SDK_DISABLE_COPY(TieredDataSlice);
+
+  /// remove all data in the slice
+  virtual void flush(bool keepStatic = true);
+  /// remove points in the given time range; up to but not including endTime
+  virtual void flush(double startTime, double endTime);
+
+  /// Total number of items in this data slice, in both tiers
+  virtual size_t numItems() const;
+
+  /// Process update range; cold updates are given to the visitor in a temporary only valid during the call
+  virtual void visit(typename DataSlice<T>::Visitor *visitor) const;
+
+  /// Insert the specified data in time-based sorted order; replaces any update with the same time
+  virtual void insert(T *data);
+  /// Inserts many updates at once, taking ownership of them; see MemoryDataSlice::insertMany()
+  virtual void insertMany(std::vector<T*>& data);
+
+  /// Moves hot updates older than the 'timeWindow' into the cold tier
+  virtual void limitByTime(double timeWindow);
+  /// Moves all but the newest 'limitPoints' hot updates into the cold tier
+  virtual void limitByPoints(uint32_t limitPoints);
+
+  /** Approximate number of bytes used by both tiers */
+  virtual size_t memoryUsage() const;
+  /** Approximate number of bytes used by the slice and its hot updates */
+  size_t hotMemoryUsage() const;
+  /** Approximate number of bytes used by the cold blocks, the staged updates, the decoded block cache and the views */
+  size_t coldMemoryUsage() const;
+
+  /** Number of updates in the hot tier */
+  size_t numHotItems() const;
+  /** Number of updates in the cold tier, including the ones not yet compressed */
+  size_t numColdItems() const;
+
+  /** Bytes of cold storage to keep before discarding the oldest cold blocks */
+  size_t coldBudget() const;
+
+  /** Time of the update at index, which must be less than numItems() */
+  double timeAt(size_t index) const;
+  /** Returns a view of the update at index, which must be less than numItems() */
+  const T* at(size_t index) const;
+
+private:
+  /// A block decoded for searches and copies
+  struct DecodedBlock
+  {
+    /// Sequence number of the block; ~0 if unused
+    size_t sequence = ~static_cast<size_t>(0);
+    /// Decoded updates
+    std::unique_ptr<T[]> updates;
+  };
+
+  /// Returns the ColumnChunkSize decoded updates of the cold block at the given position in blocks_; valid until two other blocks are decoded
+  const T* blockUpdates_(size_t block) const;
+  /// Copies the update at index into the given object
+  void load_(size_t index, T& update) const;
+
+  /// Moves the first count hot updates to the cold tier, then enforces the budget
+  void demote_(size_t count);
+  /// Compresses full blocks of staged updates
+  void compressStaged_();
+  /// Discards the oldest cold blocks until the cold tier fits the budget
+  void enforceBudget_();
+  /// Removes the cold tier
+  void clearCold_();
+  /// Decodes the cold tier, lets the function edit the updates, and compresses the result
+  void rebuildCold_(const std::function<void(std::vector<T*>&)>& edit);
+  /// Inserts sorted, unique updates that are not newer than the cold tier
+  void insertCold_(std::vector<T*>& data);
+  /// Drops any reference to the update held as the current update or as an interpolation bound
+  void forget_(const T* update);
+  /// Returns the update at index, copied into scratch if it is in the cold tier
+  const T* bound_(size_t index, T& scratch) const;
+
+  /// Number of updates in cold blocks
+  size_t numBlockItems_() const;
+  /// Time of the newest cold update; the cold tier must not be empty
+  double lastColdTime_() const;
+  /// Index of the first update with time >= the given time, or numItems()
+  size_t lowerBoundIndex_(double time) const;
+  /// Index of the first update with time > the given time, or numItems()
+  size_t upperBoundIndex_(double time) const;
+  /// Points current_ at the hot update at index, or at a copy of the cold update; index of numItems() clears current_
+  void setCurrentIndex_(size_t index);
+
+  /// Bytes of cold storage to keep
+  size_t coldBudget_;
+  /// Compressed updates, oldest first
+  std::deque<ColdBlock> blocks_;
+  /// Sequence number of blocks_.front(); blocks keep their number when older blocks are discarded
+  size_t firstSequence_;
+  /// Bytes held by blocks_
+  size_t blockBytes_;
+  /// Updates waiting for a full block, in time order, newer than the blocks and older than the hot tier
+  std::vector<T*> staged_;
+  /// Cache of recently decoded blocks
+  mutable DecodedBlock decoded_[2];
+  /// Views materialized for at(), one entry per entry of blocks_; nullptr until first needed
+  mutable std::deque<std::unique_ptr<T[]> > views_;
+  /// Entry of decoded_ used most recently
+  mutable size_t mostRecent_;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/TieredDataSlice-inl.h"
+
+#endif // SIMDATA_TIEREDDATASLICE_H
@@ -0,0 +1,228 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_TIMEBUCKETINDEX_INL_H
+#define SIMDATA_TIMEBUCKETINDEX_INL_H
+
+#include <algorithm>
+#include <cmath>
+#include "simData/UpdateComp.h"
+
+namespace simData
+{
+
+template <typename T>
+TimeBucketIndex<T>::TimeBucketIndex()
+  : valid_(false),
+    origin_(0.0),
+    scale_(0.0),
+    firstBucket_(0),
+    front_(0),
+    erased_(0),
+    size_(0),
+    builtSize_(0)
+{
+}
+
+template <typename T>
+void TimeBucketIndex<T>::invalidate()
+{
+  valid_ = false;
+  starts_.clear();
+  front_ = 0;
+}
+
+template <typename T>
+void TimeBucketIndex<T>::append(const std::deque<T*>& updates)
+{
+  if (!valid_)
+    return;
+
+  // Rebuild once the data has doubled, since the bucket width may no longer suit the data rate
+  if ((updates.size() < size_) || (updates.size() >= 2 * builtSize_))
+  {
+    invalidate();
+    return;
+  }
+
+  if (starts_.size() == front_)
+  {
+    // Searched without an index; stays that way until the next rebuild
+    size_ = updates.size();
+    return;
+  }
+
+  for (size_t ii = size_; ii < updates.size(); ++ii)
+  {
+    const int64_t bucket = bucket_(updates[ii]->time());
+    const int64_t lastBucket = firstBucket_ + static_cast<int64_t>(starts_.size() - front_) - 1;
+    // Out of order, or after a gap that would need many empty buckets
+    if ((bucket < lastBucket) || (bucket - lastBucket > static_cast<int64_t>(builtSize_ + MinimumSize)))
+    {
+      invalidate();
+      return;
+    }
+    for (int64_t newBucket = lastBucket + 1; newBucket <= bucket; ++newBucket)
+      starts_.push_back(erased_ + ii);
+  }
+  size_ = updates.size();
+}
+
+template <typename T>
+void TimeBucketIndex<T>::eraseFront(size_t count)
+{
+  if (!valid_)
+    return;
+
+  // Rebuild once most of the data is gone, for the same reason as in append()
+  if ((count >= size_) || (4 * (size_ - count) < builtSize_))
+  {
+    invalidate();
+    return;
+  }
+
+  erased_ += count;
+  size_ -= count;
+
+  // Drop the buckets that no longer hold any updates
+  while ((starts_.size() - front_ > 1) && (starts_[front_ + 1] <= erased_))
+  {
+    ++front_;
+    ++firstBucket_;
+  }
+  if (2 * front_ > starts_.size())
+  {
+    starts_.erase(starts_.begin(), starts_.begin() + front_);
+    front_ = 0;
+  }
+}
+
+template <typename T>
+template <typename Iterator>
+Iterator TimeBucketIndex<T>::lowerBound(Iterator begin, Iterator end, double time) const
+{
+  size_t first = 0;
+  size_t last = end - begin;
+  range_(begin, end, time, first, last);
+  if (last - first > ScanLimit)
+    return std::lower_bound(begin + first, begin + last, time, UpdateComp<T>());
+  // Buckets are small, so a scan beats the deque iterator arithmetic of std::lower_bound
+  while ((first < last) && (begin[first]->time() < time))
+    ++first;
+  return begin + first;
+}
+
+template <typename T>
+template <typename Iterator>
+Iterator TimeBucketIndex<T>::upperBound(Iterator begin, Iterator end, double time) const
+{
+  size_t first = 0;
+  size_t last = end - begin;
+  range_(begin, end, time, first, last);
+  if (last - first > ScanLimit)
+    return std::upper_bound(begin + first, begin + last, time, UpdateComp<T>());
+  while ((first < last) && (begin[first]->time() <= time))
+    ++first;
+  return begin + first;
+}
+
+template <typename T>
+size_t TimeBucketIndex<T>::numBuckets() const
+{
+  return valid_ ? starts_.size() - front_ : 0;
+}
+
+template <typename T>
+template <typename Iterator>
+void TimeBucketIndex<T>::rebuild_(Iterator begin, Iterator end) const
+{
+  valid_ = true;
+  starts_.clear();
+  front_ = 0;
+  firstBucket_ = 0;
+  erased_ = 0;
+  size_ = end - begin;
+  builtSize_ = size_;
+
+  if (size_ < MinimumSize)
+    return;
+  const double front = begin[0]->time();
+  const double back = begin[size_ - 1]->time();
+  if (!(back > front))
+    return;
+
+  origin_ = front;
+  scale_ = static_cast<double>(size_ / PointsPerBucket) / (back - front);
+  for (size_t ii = 0; ii < size_; ++ii)
+  {
+    const int64_t bucket = bucket_(begin[ii]->time());
+    while (static_cast<int64_t>(starts_.size()) <= bucket)
+      starts_.push_back(ii);
+  }
+}
+
+template <typename T>
+int64_t TimeBucketIndex<T>::bucket_(double time) const
+{
+  // Monotonic in time, which is all the searches rely on; clamp to keep the conversion defined
+  const double bucket = std::floor((time - origin_) * scale_);
+  const double limit = 4503599627370496.0; // 2^52
+  if (bucket < -limit)
+    return static_cast<int64_t>(-limit);
+  if (bucket > limit)
+    return static_cast<int64_t>(limit);
+  return static_cast<int64_t>(bucket);
+}
+
+template <typename T>
+template <typename Iterator>
+bool TimeBucketIndex<T>::range_(Iterator begin, Iterator end, double time, size_t& first, size_t& last) const
+{
+  // Changes that were not reported, such as an insert in the middle, change the size
+  if (!valid_ || (size_ != static_cast<size_t>(end - begin)))
+    rebuild_(begin, end);
+  const size_t count = starts_.size() - front_;
+  if (count == 0)
+    return false;
+
+  // Every update in an earlier bucket is before the time, and every update in a later bucket is after it
+  const int64_t bucket = bucket_(time) - firstBucket_;
+  if (bucket < 0)
+  {
+    first = last = 0;
+    return true;
+  }
+  if (bucket >= static_cast<int64_t>(count))
+  {
+    first = last = size_;
+    return true;
+  }
+
+  const size_t index = front_ + static_cast<size_t>(bucket);
+  first = std::max(starts_[index], erased_) - erased_;
+  last = (index + 1 < starts_.size()) ? starts_[index + 1] - erased_ : size_;
+  return true;
+}
+
+} // End of namespace simData
+
+#endif // SIMDATA_TIMEBUCKETINDEX_INL_H
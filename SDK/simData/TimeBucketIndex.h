@@ -0,0 +1,110 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_TIMEBUCKETINDEX_H
+#define SIMDATA_TIMEBUCKETINDEX_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace simData
+{
+
+/**
+ * Index over the time ordered updates of a MemoryDataSlice that finds the lower or upper bound of
+ * any time in near constant time, so that random seeks cost about the same as sequential playback.
+ *
+ * The time span of the updates is split into equal width buckets holding about PointsPerBucket
+ * updates each, and the index records the position of the first update of each bucket.  A search
+ * computes the bucket from the time and then only searches the updates of that bucket.  Appends
+ * and removals from the front, the common changes during live data limiting, update the index
+ * incrementally.  Any other change, or a large change in the data rate, marks the index out of
+ * date and the next search rebuilds it.
+ */
+template <typename T>
+class TimeBucketIndex
+{
+public:
+  /// Average number of updates per bucket when the index is built
+  static const size_t PointsPerBucket = 2;
+  /// Slices smaller than this are searched without an index
+  static const size_t MinimumSize = 16;
+  /// Buckets holding more updates than this are binary searched rather than scanned
+  static const size_t ScanLimit = 8;
+
+  TimeBucketIndex();
+
+  /// Marks the index out of date; the next search rebuilds it
+  void invalidate();
+
+  /// Records updates appended to the back of the deque since the last change
+  void append(const std::deque<T*>& updates);
+  /// Records the removal of count updates from the front of the deque
+  void eraseFront(size_t count);
+
+  /// Returns the first update in [begin, end) whose time is >= time, like std::lower_bound
+  template <typename Iterator>
+  Iterator lowerBound(Iterator begin, Iterator end, double time) const;
+  /// Returns the first update in [begin, end) whose time is > time, like std::upper_bound
+  template <typename Iterator>
+  Iterator upperBound(Iterator begin, Iterator end, double time) const;
+
+  /// Number of buckets in the index; 0 when out of date or not needed
+  size_t numBuckets() const;
+
+private:
+  /// Rebuilds the buckets from the updates
+  template <typename Iterator>
+  void rebuild_(Iterator begin, Iterator end) const;
+  /// Returns the bucket of the time, which may be negative or beyond the last bucket
+  int64_t bucket_(double time) const;
+  /// Sets [first, last) to the range of indices that can hold the bounds of time; returns false if the index cannot be used
+  template <typename Iterator>
+  bool range_(Iterator begin, Iterator end, double time, size_t& first, size_t& last) const;
+
+  /// True if the buckets match the updates
+  mutable bool valid_;
+  /// Time of the start of bucket 0
+  mutable double origin_;
+  /// Reciprocal of the bucket width
+  mutable double scale_;
+  /// Bucket number of starts_[front_]
+  mutable int64_t firstBucket_;
+  /// For each bucket, the position of its first update counted from the first update ever indexed
+  mutable std::vector<size_t> starts_;
+  /// Entries of starts_ before this belong to buckets removed from the front; compacted lazily
+  mutable size_t front_;
+  /// Updates removed from the front since the index was built
+  mutable size_t erased_;
+  /// Number of updates covered by the index
+  mutable size_t size_;
+  /// Number of updates when the index was built
+  mutable size_t builtSize_;
+};
+
+} // End of namespace simData
+
+// implementation of inline functions
+#include "simData/TimeBucketIndex-inl.h"
+
+#endif // SIMDATA_TIMEBUCKETINDEX_H
@@ -0,0 +1,67 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_UPDATE_RECLAIMER_INL_H
+#define SIMDATA_UPDATE_RECLAIMER_INL_H
+
+namespace simData {
+
+/** Batch of update pointers deleted together */
+template <typename T>
+class UpdateReclaimer::UpdateBatch : public UpdateReclaimer::Batch
+{
+public:
+  explicit UpdateBatch(std::vector<T*>& items)
+  {
+    items_.swap(items);
+  }
+
+  virtual ~UpdateBatch()
+  {
+    for (T* item : items_)
+      delete item;
+  }
+
+private:
+  std::vector<T*> items_;
+};
+
+template <typename T>
+void UpdateReclaimer::reclaim(std::vector<T*>& items)
+{
+  if (items.size() >= MIN_DEFERRED_BATCH)
+  {
+    std::unique_ptr<Batch> batch(new UpdateBatch<T>(items));
+    // Deletes inline if the background thread is disabled or unavailable
+    if (!defer_(batch))
+      batch.reset();
+    return;
+  }
+
+  for (T* item : items)
+    delete item;
+  items.clear();
+}
+
+}
+
+#endif /* SIMDATA_UPDATE_RECLAIMER_INL_H */
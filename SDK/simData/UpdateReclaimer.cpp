@@ -0,0 +1,108 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <system_error>
+#include "simData/UpdateReclaimer.h"
+
+namespace simData {
+
+UpdateReclaimer::UpdateReclaimer()
+{
+}
+
+UpdateReclaimer::~UpdateReclaimer()
+{
+  shutDown();
+}
+
+void UpdateReclaimer::waitForIdle()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  idleCondition_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+void UpdateReclaimer::shutDown()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  workCondition_.notify_all();
+  // Worker drains the queue before returning
+  if (thread_.joinable())
+    thread_.join();
+}
+
+bool UpdateReclaimer::isShutDown() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stopping_;
+}
+
+bool UpdateReclaimer::defer_(std::unique_ptr<Batch>& batch)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_)
+      return false;
+    if (!thread_.joinable())
+    {
+      try
+      {
+        thread_ = std::thread(&UpdateReclaimer::run_, this);
+      }
+      catch (const std::system_error&)
+      {
+        return false;
+      }
+    }
+    queue_.push_back(std::move(batch));
+  }
+  workCondition_.notify_one();
+  return true;
+}
+
+void UpdateReclaimer::run_()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    workCondition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty())
+    {
+      idleCondition_.notify_all();
+      return;
+    }
+
+    std::unique_ptr<Batch> batch = std::move(queue_.front());
+    queue_.pop_front();
+    busy_ = true;
+    lock.unlock();
+    batch.reset();
+    lock.lock();
+    busy_ = false;
+    if (queue_.empty())
+      idleCondition_.notify_all();
+  }
+}
+
+}
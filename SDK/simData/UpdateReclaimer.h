@@ -0,0 +1,107 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_UPDATE_RECLAIMER_H
+#define SIMDATA_UPDATE_RECLAIMER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "simCore/Common/Common.h"
+
+namespace simData {
+
+/**
+ * Destroys removed slice updates on a background thread.  Data limiting and range flushes
+ * can remove thousands of updates from a slice at once; deleting each one inline shows up as
+ * a frame time spike on hosts with a spare core.  Removed updates are already detached from
+ * their slice, so their destruction can be handed off as a single batch and the caller
+ * returns immediately.
+ *
+ * Each MemoryDataStore that enables reclaiming owns one reclaimer and shuts it down before the
+ * store goes away.  The thread starts with the first deferred batch.  Small batches are deleted
+ * inline, since the hand off costs more than the deletes.  All methods are thread safe.
+ */
+class SDKDATA_EXPORT UpdateReclaimer
+{
+public:
+  /** Batches smaller than this are always deleted on the calling thread */
+  static const size_t MIN_DEFERRED_BATCH = 64;
+
+  UpdateReclaimer();
+  /** Shuts down the thread, destroying any batches still queued */
+  virtual ~UpdateReclaimer();
+
+  SDK_DISABLE_COPY_MOVE(UpdateReclaimer);
+
+  /** Holds memory for the reclaimer to destroy; the destructor does the work */
+  class Batch
+  {
+  public:
+    virtual ~Batch() {}
+  };
+
+  /**
+   * Takes ownership of the items and deletes them, either inline or on the background thread.
+   * The vector is cleared on return.
+   */
+  template <typename T>
+  void reclaim(std::vector<T*>& items);
+
+  /** Blocks until every batch queued so far has been destroyed */
+  void waitForIdle();
+
+  /**
+   * Destroys the queued batches and stops the background thread.  Later batches are deleted
+   * inline.  Called by the destructor; the owner may call it sooner, but not from the thread
+   * of a static destructor or library unload.
+   */
+  void shutDown();
+  /** Returns true if shutDown() has been called */
+  bool isShutDown() const;
+
+private:
+  template <typename T> class UpdateBatch;
+
+  /** Queues the batch for the background thread; returns false (and leaves batch alone) if that is not possible */
+  bool defer_(std::unique_ptr<Batch>& batch);
+  /** Destroys queued batches until shut down */
+  void run_();
+
+  std::thread thread_;
+  mutable std::mutex mutex_;
+  std::condition_variable workCondition_;
+  std::condition_variable idleCondition_;
+  std::deque<std::unique_ptr<Batch> > queue_;
+  bool busy_ = false;
+  bool stopping_ = false;
+};
+
+}
+
+#include "simData/UpdateReclaimer-inl.h"
+
+#endif /* SIMDATA_UPDATE_RECLAIMER_H */
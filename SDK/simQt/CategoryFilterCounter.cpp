@@ -45,6 +45,7 @@ void CategoryFilterCounter::prepare()
 
   // Set up initial state
   allEntities_.clear();
+  compiledFilter_.reset();
   results_.allCategories.clear();
   if (!filter_)
     return;
@@ -55,13 +56,14 @@ void CategoryFilterCounter::prepare()
   // Make a copy of all the current category data
   std::vector<simData::ObjectId> ids;
   idList_(ids);
+  simData::CategoryFilter::CurrentCategoryValues values;
   for (auto i = ids.begin(); i != ids.end(); ++i)
   {
-    IdAndCategories entry;
-    entry.id = *i;
-    simData::CategoryFilter::getCurrentCategoryValues(*ds, entry.id, entry.categories);
-    allEntities_.push_back(entry);
+    values.clear();
+    simData::CategoryFilter::getCurrentCategoryValues(*ds, *i, values);
+    allEntities_.setValues(*i, values);
   }
+  compiledFilter_.reset(new simData::CompiledCategoryFilter(*filter_));
 
   // Initialize all filter entries based on state of filter
   const simData::CategoryNameManager& nameManager = ds->categoryNameManager();
@@ -117,9 +119,17 @@ void CategoryFilterCounter::testAllCategories()
   // prepare() should turn off the dirty flag
   assert(!dirtyFlag_);
 
-  // Test every category we know about
-  for (auto i = results_.allCategories.begin(); i != results_.allCategories.end(); ++i)
-    testCategory_(i->first, i->second);
+  // Count every category we know about in one pass over the entities per filtered category
+  if (compiledFilter_)
+  {
+    for (auto i = results_.allCategories.begin(); i != results_.allCategories.end(); ++i)
+    {
+      for (auto vi = i->second.begin(); vi != i->second.end(); ++vi)
+        vi->second = 0;
+    }
+    std::vector<uint64_t> allRows(allEntities_.numRows() / 64 + 1, ~static_cast<uint64_t>(0));
+    compiledFilter_->countValues(allEntities_, allRows, results_.allCategories);
+  }
   Q_EMIT resultsReady(results_);
 }
 
@@ -128,57 +138,6 @@ const CategoryCountResults& CategoryFilterCounter::results() const
   return results_;
 }
 
-// Inside thread (protected)
-void CategoryFilterCounter::filteredIds_(int ignoreNameInt, std::vector<const IdAndCategories*>& ids) const
-{
-  simData::CategoryFilter baseFilter(*filter_);
-  baseFilter.removeName(ignoreNameInt);
-
-  // Find all IDs that match the new filter without the name provided
-  for (auto idIter = allEntities_.begin(); idIter != allEntities_.end(); ++idIter)
-  {
-    if (baseFilter.matchData(idIter->categories))
-      ids.push_back(&(*idIter));
-  }
-}
-
-// Inside thread (protected)
-void CategoryFilterCounter::testCategory_(int nameInt, CategoryCountResults::ValueToCountMap& countMap)
-{
-  // Start out by not testing anything in this filter
-  simData::CategoryFilter baseFilter(*filter_);
-  baseFilter.removeName(nameInt);
-
-  // Get all IDs that match the filter excluding this name
-  std::vector<const IdAndCategories*> idDataVec;
-  filteredIds_(nameInt, idDataVec);
-
-  // Loop through each value in this category.  If the platform matches, add it
-  for (auto vi = countMap.begin(); vi != countMap.end(); ++vi)
-  {
-    // Test what happens when this filter value is turned on
-    baseFilter.setValue(nameInt, vi->first, true);
-    size_t& numMatches = vi->second;
-    // Assertion failure means the prepare() missed a category value
-    assert(numMatches == 0);
-
-    // Loop through each entity of interest
-    for (auto idIter = idDataVec.begin(); idIter != idDataVec.end(); ++idIter)
-    {
-      const IdAndCategories& idData = **idIter;
-      const simData::ObjectId& id = idData.id;
-
-      // Test the value and increment if it matches
-      const bool matches = baseFilter.matchData(idData.categories);
-      if (matches)
-        ++vi->second;
-    }
-
-    // Turn that value back off.  removeName()
-    baseFilter.setValue(nameInt, vi->first, false);
-  }
-}
-
 ////////////////////////////////////////////////////
 
 AsyncCategoryCounter::AsyncCategoryCounter(QObject* parent)
@@ -30,6 +30,8 @@
 #include "simCore/Common/Export.h"
 #include "simData/ObjectId.h"
 #include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CategoryValueTable.h"
+#include "simData/CategoryData/CompiledCategoryFilter.h"
 
 namespace simQt {
 
@@ -50,8 +52,9 @@ struct CategoryCountResults
  * given filter.  This is intended to give a runtime count of the number of entities that will
  * be impacted by clicking a category value line in a category tree widget.
  *
- * Note that this algorithm is O(m * n), scaling both on the number of entities (m) and the
- * total number of category values (n).
+ * The filter is compiled once, and each entity is tested once per category of the filter, so the
+ * cost scales with the number of entities times the number of filtered categories rather than
+ * with the total number of category values.
  */
 class SDKQT_EXPORT CategoryFilterCounter : public QObject
 {
@@ -92,26 +95,16 @@ Q_SIGNALS:
   void resultsReady(const simQt::CategoryCountResults& results);
 
 private:
-  /** Local storage structure for current category data.  Filled out by prepare(). */
-  struct IdAndCategories
-  {
-    simData::ObjectId id;
-    simData::CategoryFilter::CurrentCategoryValues categories;
-  };
-
   /**
    * Retrieves the list of IDs out of the data store.  This is called in prepare() and is not thread
    * safe with regards to interactions with the data store.
    */
   void idList_(std::vector<simData::ObjectId>& ids) const;
 
-  /** Returns a list of ID+Categories that matches filter_.  Thread safe. */
-  void filteredIds_(int ignoreNameInt, std::vector<const IdAndCategories*>& ids) const;
-  /** Tests an individual category and sets the counts for that category */
-  void testCategory_(int nameInt, CategoryCountResults::ValueToCountMap& countMap);
-
   /** Stores all entity IDs and their current category values. */
-  std::vector<IdAndCategories> allEntities_;
+  simData::CategoryValueTable allEntities_;
+  /** Compiled form of filter_, created by prepare() */
+  std::unique_ptr<simData::CompiledCategoryFilter> compiledFilter_;
   /** Map of category name, to map of category value to count. */
   CategoryCountResults results_;
   /** Current filter supplied by end user. */
@@ -21,6 +21,8 @@
  *
  */
 #include <cmath>
+#include <iostream>
+#include <random>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/Math.h"
@@ -1822,6 +1824,124 @@ int testTangentPlane2Sphere()
   return rv;
 }
 
+/** Builds entities scattered within a few degrees of a point, with one 'to' entity on the first 'from' entity */
+void makePairwiseStates(size_t fromCount, size_t toCount, simCore::PairwiseStates& from, simCore::PairwiseStates& to)
+{
+  std::mt19937 gen(4321);
+  std::uniform_real_distribution<double> offset(-3.0 * simCore::DEG2RAD, 3.0 * simCore::DEG2RAD);
+  std::uniform_real_distribution<double> alt(0.0, 20000.0);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::uniform_real_distribution<double> speed(-300.0, 300.0);
+  const simCore::Vec3 center(35.0 * simCore::DEG2RAD, -120.0 * simCore::DEG2RAD, 0.0);
+  auto fill = [&](size_t count, simCore::PairwiseStates& states) {
+    for (size_t k = 0; k < count; ++k)
+    {
+      states.lla.push_back(simCore::Vec3(center.lat() + offset(gen), center.lon() + offset(gen), alt(gen)));
+      states.ori.push_back(simCore::Vec3(angle(gen), 0.5 * angle(gen), angle(gen)));
+      states.vel.push_back(simCore::Vec3(speed(gen), speed(gen), 0.1 * speed(gen)));
+    }
+  };
+  fill(fromCount, from);
+  fill(toCount, to);
+  to.lla[toCount / 2] = from.lla[0];
+}
+
+/** Compares calculatePairwise() against the single pair functions for one earth model */
+int testPairwiseModel(simCore::EarthModelCalculations model, unsigned int calculations, bool multithreaded)
+{
+  int rv = 0;
+  simCore::PairwiseStates from;
+  simCore::PairwiseStates to;
+  // More 'to' entities than fit in one block of work
+  makePairwiseStates(5, 2500, from, to);
+  simCore::CoordinateConverter cc;
+  cc.setReferenceOrigin(34.0 * simCore::DEG2RAD, -121.0 * simCore::DEG2RAD, 0.0);
+
+  simCore::PairwiseResults results;
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, calculations, model, &cc, results, multithreaded) == 0);
+  const size_t pairCount = from.lla.size() * to.lla.size();
+  const bool wantAngles = (calculations & simCore::PAIRWISE_REL_AZ_EL) != 0;
+  rv += SDK_ASSERT(results.azim.size() == (wantAngles ? pairCount : 0));
+  rv += SDK_ASSERT(results.slant.size() == ((calculations & simCore::PAIRWISE_SLANT) ? pairCount : 0));
+  rv += SDK_ASSERT(results.rangeRate.size() == ((calculations & simCore::PAIRWISE_RANGE_RATE) ? pairCount : 0));
+
+  int mismatches = 0;
+  for (size_t i = 0; i < from.lla.size(); ++i)
+  {
+    for (size_t j = 0; j < to.lla.size(); ++j)
+    {
+      const size_t k = i * to.lla.size() + j;
+      if (wantAngles)
+      {
+        double azim = 0.0;
+        double elev = 0.0;
+        double cmp = 0.0;
+        simCore::calculateRelAzEl(from.lla[i], from.ori[i], to.lla[j], &azim, &elev, &cmp, model, &cc);
+        mismatches += !simCore::areAnglesEqual(azim, results.azim[k], 1e-9);
+        mismatches += !simCore::areEqual(elev, results.elev[k], 1e-9);
+        mismatches += !simCore::areEqual(cmp, results.cmp[k], 1e-9);
+      }
+      if (calculations & simCore::PAIRWISE_SLANT)
+        mismatches += !simCore::areEqual(simCore::calculateSlant(from.lla[i], to.lla[j], model, &cc), results.slant[k], 1e-6);
+      if (calculations & simCore::PAIRWISE_GROUND_DIST)
+        mismatches += !simCore::areEqual(simCore::calculateGroundDist(from.lla[i], to.lla[j], model, &cc), results.groundDist[k], 1e-6);
+      if (calculations & simCore::PAIRWISE_CLOSING_VELOCITY)
+      {
+        const double closing = simCore::calculateClosingVelocity(from.lla[i], to.lla[j], model, &cc, from.vel[i], to.vel[j]);
+        mismatches += !simCore::areEqual(closing, results.closingVelocity[k], 1e-9);
+      }
+      if (calculations & simCore::PAIRWISE_RANGE_RATE)
+      {
+        const double rangeRate = simCore::calculateRangeRate(from.lla[i], from.ori[i], to.lla[j], to.ori[j], model, &cc, from.vel[i], to.vel[j]);
+        mismatches += !simCore::areEqual(rangeRate, results.rangeRate[k], 1e-9);
+      }
+    }
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+  return rv;
+}
+
+int testPairwise()
+{
+  int rv = 0;
+  const unsigned int all = simCore::PAIRWISE_REL_AZ_EL | simCore::PAIRWISE_SLANT | simCore::PAIRWISE_GROUND_DIST |
+    simCore::PAIRWISE_CLOSING_VELOCITY | simCore::PAIRWISE_RANGE_RATE;
+  for (bool multithreaded : { false, true })
+  {
+    rv += SDK_ASSERT(testPairwiseModel(simCore::WGS_84, all, multithreaded) == 0);
+    rv += SDK_ASSERT(testPairwiseModel(simCore::TANGENT_PLANE_WGS_84, all, multithreaded) == 0);
+    rv += SDK_ASSERT(testPairwiseModel(simCore::FLAT_EARTH, all, multithreaded) == 0);
+    rv += SDK_ASSERT(testPairwiseModel(simCore::PERFECT_SPHERE, simCore::PAIRWISE_SLANT, multithreaded) == 0);
+  }
+  // Range rate on its own computes the bearing separately from the relative angles
+  rv += SDK_ASSERT(testPairwiseModel(simCore::FLAT_EARTH, simCore::PAIRWISE_RANGE_RATE, true) == 0);
+  rv += SDK_ASSERT(testPairwiseModel(simCore::WGS_84, simCore::PAIRWISE_RANGE_RATE | simCore::PAIRWISE_SLANT, true) == 0);
+
+  simCore::PairwiseStates from;
+  simCore::PairwiseStates to;
+  makePairwiseStates(2, 3, from, to);
+  simCore::PairwiseResults results;
+
+  // Calculations the single pair functions do not support fail, with zero results
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_REL_AZ_EL, simCore::PERFECT_SPHERE, nullptr, results) != 0);
+  rv += SDK_ASSERT(results.azim.size() == 6 && results.azim[0] == 0.0);
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_SLANT, simCore::FLAT_EARTH, nullptr, results) != 0);
+  rv += SDK_ASSERT(results.slant.size() == 6 && results.azim.empty());
+  // Flat earth closing velocity sets up its own frame at each 'from' entity
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_CLOSING_VELOCITY, simCore::FLAT_EARTH, nullptr, results) == 0);
+
+  // Missing velocities
+  to.vel.pop_back();
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_CLOSING_VELOCITY, simCore::WGS_84, nullptr, results) != 0);
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_SLANT, simCore::WGS_84, nullptr, results) == 0);
+
+  // Empty groups
+  to = simCore::PairwiseStates();
+  rv += SDK_ASSERT(simCore::calculatePairwise(from, to, simCore::PAIRWISE_SLANT, simCore::WGS_84, nullptr, results) == 0);
+  rv += SDK_ASSERT(results.slant.empty());
+  return rv;
+}
+
 }
 
 int CalculationTest(int argc, char* argv[])
@@ -1852,5 +1972,6 @@ int CalculationTest(int argc, char* argv[])
   rv += testAoaSideslipTotalAoa();
   rv += testBoresightAlphaBeta();
   rv += testTangentPlane2Sphere();
+  rv += testPairwise();
   return rv;
 }
@@ -0,0 +1,206 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/CoordinateSystem.h"
+#include "simCore/Calc/Math.h"
+
+namespace {
+
+/** Structure-of-arrays positions for batch conversion */
+struct Positions
+{
+  explicit Positions(size_t count)
+    : x(count), y(count), z(count)
+  {
+  }
+
+  simCore::Vec3 at(size_t index) const
+  {
+    return simCore::Vec3(x[index], y[index], z[index]);
+  }
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+};
+
+const simCore::CoordinateSystem ALL_SYSTEMS[] = {
+  simCore::COORD_SYS_LLA, simCore::COORD_SYS_ECEF, simCore::COORD_SYS_ECI,
+  simCore::COORD_SYS_NED, simCore::COORD_SYS_NWU, simCore::COORD_SYS_ENU,
+  simCore::COORD_SYS_XEAST, simCore::COORD_SYS_GTP
+};
+
+/** Elapsed ECI time used for all conversions */
+const double ECI_TIME = 1234.5;
+
+/** Random geodetic positions within range of a tracked scenario */
+Positions makeLlaPositions(size_t count)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> lat(-80.0 * simCore::DEG2RAD, 80.0 * simCore::DEG2RAD);
+  std::uniform_real_distribution<double> lon(-M_PI, M_PI);
+  std::uniform_real_distribution<double> alt(-100.0, 100000.0);
+  Positions rv(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    rv.x[k] = lat(gen);
+    rv.y[k] = lon(gen);
+    rv.z[k] = alt(gen);
+  }
+  return rv;
+}
+
+/** Converts each position with the scalar convert() */
+Positions convertScalar(const simCore::CoordinateConverter& cc, const Positions& in, simCore::CoordinateSystem inSystem, simCore::CoordinateSystem outSystem)
+{
+  Positions rv(in.x.size());
+  simCore::Coordinate outCoord;
+  for (size_t k = 0; k < in.x.size(); ++k)
+  {
+    const simCore::Coordinate inCoord(inSystem, in.at(k), ECI_TIME);
+    cc.convert(inCoord, outCoord, outSystem);
+    rv.x[k] = outCoord.position().x();
+    rv.y[k] = outCoord.position().y();
+    rv.z[k] = outCoord.position().z();
+  }
+  return rv;
+}
+
+/** Returns true if every position matches within the tolerance */
+bool samePositions(const Positions& a, const Positions& b, double tolerance)
+{
+  for (size_t k = 0; k < a.x.size(); ++k)
+  {
+    if (!simCore::areEqual(a.x[k], b.x[k], tolerance) || !simCore::areEqual(a.y[k], b.y[k], tolerance) || !simCore::areEqual(a.z[k], b.z[k], tolerance))
+      return false;
+  }
+  return true;
+}
+
+simCore::CoordinateConverter makeConverter()
+{
+  simCore::CoordinateConverter cc;
+  cc.setReferenceOriginDegrees(30.0, -75.0, 10.0);
+  cc.setTangentPlaneOffsets(100.0, -200.0, 0.3);
+  return cc;
+}
+
+int testMatchesScalar()
+{
+  int rv = 0;
+  const simCore::CoordinateConverter cc = makeConverter();
+  // Not a multiple of the block size, so partial blocks are covered
+  const Positions lla = makeLlaPositions(2500);
+
+  for (auto inSystem : ALL_SYSTEMS)
+  {
+    const Positions in = convertScalar(cc, lla, simCore::COORD_SYS_LLA, inSystem);
+    for (auto outSystem : ALL_SYSTEMS)
+    {
+      const Positions expected = convertScalar(cc, in, inSystem, outSystem);
+      Positions out(in.x.size());
+      rv += SDK_ASSERT(cc.convertPositions(inSystem, in.x, in.y, in.z,
+        outSystem, out.x, out.y, out.z, ECI_TIME) == 0);
+      const bool matches = samePositions(expected, out, 1e-6);
+      rv += SDK_ASSERT(matches);
+      if (!matches)
+        std::cerr << "Batch conversion mismatch from " << inSystem << " to " << outSystem << "\n";
+
+      // Converting in place gives the same answer
+      Positions inPlace = in;
+      rv += SDK_ASSERT(cc.convertPositions(inSystem, inPlace.x, inPlace.y, inPlace.z,
+        outSystem, inPlace.x, inPlace.y, inPlace.z, ECI_TIME) == 0);
+      rv += SDK_ASSERT(out.x == inPlace.x && out.y == inPlace.y && out.z == inPlace.z);
+    }
+  }
+  return rv;
+}
+
+int testErrors()
+{
+  int rv = 0;
+  Positions pos(10);
+  Positions out(10);
+
+  // Flat and tangent plane systems need a reference origin
+  simCore::CoordinateConverter noOrigin;
+  rv += SDK_ASSERT(noOrigin.convertPositions(simCore::COORD_SYS_LLA, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_ENU, out.x, out.y, out.z) != 0);
+  rv += SDK_ASSERT(noOrigin.convertPositions(simCore::COORD_SYS_ECEF, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_GTP, out.x, out.y, out.z) != 0);
+  // ECEF and LLA do not
+  rv += SDK_ASSERT(noOrigin.convertPositions(simCore::COORD_SYS_ECEF, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_ECI, out.x, out.y, out.z) == 0);
+
+  // Flat systems are degenerate at the poles
+  simCore::CoordinateConverter pole;
+  pole.setReferenceOriginDegrees(90.0, 0.0, 0.0);
+  rv += SDK_ASSERT(pole.convertPositions(simCore::COORD_SYS_LLA, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_NED, out.x, out.y, out.z) != 0);
+  rv += SDK_ASSERT(pole.convertPositions(simCore::COORD_SYS_LLA, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_XEAST, out.x, out.y, out.z) == 0);
+
+  // Arrays of different sizes are an error, but an empty batch is not
+  Positions shorter(9);
+  rv += SDK_ASSERT(pole.convertPositions(simCore::COORD_SYS_LLA, shorter.x, pos.y, pos.z,
+    simCore::COORD_SYS_ECEF, out.x, out.y, out.z) != 0);
+  rv += SDK_ASSERT(pole.convertPositions(simCore::COORD_SYS_LLA, pos.x, pos.y, pos.z,
+    simCore::COORD_SYS_ECEF, out.x, out.y, shorter.z) != 0);
+  rv += SDK_ASSERT(pole.convertPositions(simCore::COORD_SYS_LLA, {}, {}, {},
+    simCore::COORD_SYS_ECEF, {}, {}, {}) == 0);
+  return rv;
+}
+
+int testLargeBatch()
+{
+  int rv = 0;
+  const simCore::CoordinateConverter cc = makeConverter();
+  // Large enough to be split between threads on multi-core hosts
+  const Positions lla = makeLlaPositions(200000);
+  const Positions expected = convertScalar(cc, lla, simCore::COORD_SYS_LLA, simCore::COORD_SYS_ECEF);
+  Positions out(lla.x.size());
+  rv += SDK_ASSERT(cc.convertPositions(simCore::COORD_SYS_LLA, lla.x, lla.y, lla.z,
+    simCore::COORD_SYS_ECEF, out.x, out.y, out.z) == 0);
+  rv += SDK_ASSERT(samePositions(expected, out, 1e-6));
+  return rv;
+}
+
+}
+
+int CoordConvertBatchTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testMatchesScalar() == 0);
+  rv += SDK_ASSERT(testErrors() == 0);
+  rv += SDK_ASSERT(testLargeBatch() == 0);
+
+  std::cout << "CoordConvertBatchTest: " << (rv == 0 ? "PASSED" : "FAILED") << "\n";
+  return rv;
+}
@@ -20,7 +20,12 @@
  * disclose, or release this software.
  *
  */
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
 #include "simCore/Calc/Angle.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/EM/AntennaPattern.h"
@@ -677,6 +682,114 @@ int antennaPatternTest(int argc, char* argv[])
   return rv;
 }
 
+/** Returns true if calculateGain() gives identical results from the map and its compiled table */
+bool sameCalculatedGain(const std::map<float, float>& azimData, const std::map<float, float>& elevData,
+  const simCore::AntennaGainTable& azimTable, const simCore::AntennaGainTable& elevTable, float azim, float elev, bool weight)
+{
+  // lobe is not set when the gain lookup fails
+  simCore::AntennaLobeType mapLobe = simCore::ANTENNA_LOBE_SIDE;
+  simCore::AntennaLobeType tableLobe = simCore::ANTENNA_LOBE_SIDE;
+  const float mapGain = simCore::calculateGain(&azimData, &elevData, mapLobe, azim, elev, 0.1f, 0.2f, 10.f, weight);
+  const float tableGain = simCore::calculateGain(&azimTable, &elevTable, tableLobe, azim, elev, 0.1f, 0.2f, 10.f, weight);
+  return mapLobe == tableLobe && (mapGain == tableGain || (std::isnan(mapGain) && std::isnan(tableGain)));
+}
+
+int testAntennaGainTable()
+{
+  int rv = 0;
+
+  // Unevenly spaced breakpoints, denser near the main beam
+  std::mt19937 gen(2468);
+  std::uniform_real_distribution<float> gainDist(-40.f, 0.f);
+  std::map<float, float> azimData;
+  std::map<float, float> elevData;
+  for (int ii = -180; ii <= 180; ii += (std::abs(ii) < 10 ? 1 : 7))
+    azimData[static_cast<float>(ii * simCore::DEG2RAD)] = gainDist(gen);
+  for (int ii = -60; ii <= 90; ii += 3)
+    elevData[static_cast<float>(ii * simCore::DEG2RAD)] = gainDist(gen);
+  simCore::AntennaGainTable azimTable;
+  simCore::AntennaGainTable elevTable;
+  azimTable.set(azimData);
+  elevTable.set(elevData);
+
+  // Random angles, breakpoint angles, and angles outside the tables match the map lookups exactly
+  std::uniform_real_distribution<float> angleDist(-4.f, 4.f);
+  std::vector<std::pair<float, float> > angles;
+  for (int ii = 0; ii < 20000; ++ii)
+    angles.push_back(std::make_pair(angleDist(gen), angleDist(gen)));
+  for (const auto& azimGain : azimData)
+    angles.push_back(std::make_pair(azimGain.first, elevData.begin()->first));
+  for (const auto& elevGain : elevData)
+    angles.push_back(std::make_pair(0.f, elevGain.first));
+  angles.push_back(std::make_pair(static_cast<float>(M_PI) + 1e-7f, static_cast<float>(M_PI_2) + 1e-7f));
+  angles.push_back(std::make_pair(std::numeric_limits<float>::quiet_NaN(), 0.f));
+  int mismatches = 0;
+  for (const auto& azimElev : angles)
+  {
+    if (!sameCalculatedGain(azimData, elevData, azimTable, elevTable, azimElev.first, azimElev.second, false))
+      ++mismatches;
+    if (!sameCalculatedGain(azimData, elevData, azimTable, elevTable, azimElev.first, azimElev.second, true))
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+
+  // Degenerate tables
+  simCore::AntennaGainTable single;
+  rv += SDK_ASSERT(single.empty());
+  rv += SDK_ASSERT(single.gain(0.f) == simCore::SMALL_DB_VAL);
+  single.set({ { 0.5f, -3.f } });
+  rv += SDK_ASSERT(!single.empty());
+  rv += SDK_ASSERT(single.gain(0.f) == -3.f);
+  rv += SDK_ASSERT(single.gain(0.5f) == -3.f);
+  rv += SDK_ASSERT(single.gain(1.f) == simCore::SMALL_DB_VAL);
+  single.clear();
+  rv += SDK_ASSERT(single.empty());
+  return rv;
+}
+
+int testAntennaPatternTableGains()
+{
+  int rv = 0;
+
+  // Symmetry 2: azimuth [0, 180] and elevation [0, 90] tables in degrees
+  std::stringstream tableFile;
+  tableFile << "0 2\n"
+    << "4\n0 0\n10 -3\n90 -20\n180 -30\n"
+    << "3\n0 0\n20 -6\n90 -25\n";
+  simCore::AntennaPatternTable table;
+  rv += SDK_ASSERT(table.readPat(tableFile) == 0);
+  rv += SDK_ASSERT(table.valid());
+
+  std::vector<simCore::AntennaGainParameters> params;
+  for (int ii = -180; ii <= 180; ii += 5)
+    params.push_back(simCore::AntennaGainParameters(static_cast<float>(ii * simCore::DEG2RAD), static_cast<float>(ii * 0.5 * simCore::DEG2RAD)));
+  std::vector<float> gains(params.size());
+  rv += SDK_ASSERT(table.gains(params, gains) == 0);
+  int mismatches = 0;
+  for (size_t ii = 0; ii < params.size(); ++ii)
+  {
+    if (gains[ii] != table.gain(params[ii]))
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+  rv += SDK_ASSERT(simCore::areEqual(table.gain(simCore::AntennaGainParameters(0.f, 0.f)), 0.f));
+  rv += SDK_ASSERT(simCore::areEqual(table.gain(simCore::AntennaGainParameters(static_cast<float>(-10 * simCore::DEG2RAD), 0.f)), -1.5f));
+
+  // Too few results is an error
+  std::vector<float> tooFew(params.size() - 1);
+  rv += SDK_ASSERT(table.gains(params, tooFew) != 0);
+
+  // Data set directly is used for the next gain
+  table.setAzimData(0.f, -10.f);
+  rv += SDK_ASSERT(simCore::areEqual(table.gain(simCore::AntennaGainParameters(0.f, 0.f)), -5.f));
+
+  // Default batch implementation calls gain() for each entry
+  simCore::AntennaPatternGauss gauss;
+  rv += SDK_ASSERT(gauss.gains(params, gains) == 0);
+  rv += SDK_ASSERT(gains[3] == gauss.gain(params[3]));
+  return rv;
+}
+
 }
 
 int EMTest(int argc, char* argv[])
@@ -689,6 +802,8 @@ int EMTest(int argc, char* argv[])
   rv += testOneWayFreeSpaceRangeLoss();
   rv += testLossToPpf();
   rv += antennaPatternTest(argc, argv);
+  rv += testAntennaGainTable();
+  rv += testAntennaPatternTableGains();
 
   std::cout << "EMTests " << ((rv == 0) ? "Passed" : "Failed") << std::endl;
 
@@ -0,0 +1,244 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Calculations.h"
+#include "simCore/Calc/Geodesic.h"
+#include "simCore/Calc/Math.h"
+
+namespace {
+
+/** Random destination points within range of a tracked scenario */
+struct Points
+{
+  explicit Points(size_t count)
+    : lat(count), lon(count)
+  {
+    std::mt19937 gen(4321);
+    std::uniform_real_distribution<double> latDist(-80.0 * simCore::DEG2RAD, 80.0 * simCore::DEG2RAD);
+    std::uniform_real_distribution<double> lonDist(-M_PI, M_PI);
+    for (size_t k = 0; k < count; ++k)
+    {
+      lat[k] = latDist(gen);
+      lon[k] = lonDist(gen);
+    }
+  }
+
+  std::vector<double> lat;
+  std::vector<double> lon;
+};
+
+int testSingle()
+{
+  int rv = 0;
+  const double refLat = 30.0 * simCore::DEG2RAD;
+  const double refLon = -75.0 * simCore::DEG2RAD;
+  simCore::SodanoGeodesic geodesic(refLat, refLon, 500.0);
+  rv += SDK_ASSERT(geodesic.origin() == simCore::Vec3(refLat, refLon, 500.0));
+
+  // Same answers as the free functions, which solve from a temporary origin
+  const Points points(100);
+  for (size_t k = 0; k < points.lat.size(); ++k)
+  {
+    double azfwd = 0.0;
+    double azbck = 0.0;
+    double expectedAzfwd = 1.0;
+    double expectedAzbck = 1.0;
+    const double dist = geodesic.inverse(points.lat[k], points.lon[k], &azfwd, &azbck);
+    rv += SDK_ASSERT(dist == simCore::sodanoInverse(refLat, refLon, 500.0, points.lat[k], points.lon[k], &expectedAzfwd, &expectedAzbck));
+    rv += SDK_ASSERT(azfwd == expectedAzfwd && azbck == expectedAzbck);
+
+    // Direct solution returns to the destination
+    double lat = 0.0;
+    double lon = 0.0;
+    geodesic.direct(dist, azfwd, &lat, &lon);
+    rv += SDK_ASSERT(simCore::areAnglesEqual(lat, points.lat[k], 1e-6));
+    rv += SDK_ASSERT(simCore::areAnglesEqual(lon, points.lon[k], 1e-6));
+  }
+
+  // Coincident points
+  double azfwd = 1.0;
+  rv += SDK_ASSERT(geodesic.inverse(refLat, refLon, &azfwd) == 0.0);
+  rv += SDK_ASSERT(azfwd == 0.0);
+
+  // Moving the origin matches a new solver
+  geodesic.setOrigin(-10.0 * simCore::DEG2RAD, 40.0 * simCore::DEG2RAD, 0.0);
+  const simCore::SodanoGeodesic moved(-10.0 * simCore::DEG2RAD, 40.0 * simCore::DEG2RAD, 0.0);
+  rv += SDK_ASSERT(geodesic.inverse(points.lat[0], points.lon[0]) == moved.inverse(points.lat[0], points.lon[0]));
+  rv += SDK_ASSERT(simCore::SodanoGeodesic().origin() == simCore::Vec3());
+  return rv;
+}
+
+int testBatch()
+{
+  int rv = 0;
+  const simCore::SodanoGeodesic geodesic(10.0 * simCore::DEG2RAD, 20.0 * simCore::DEG2RAD, 0.0);
+  // Large enough to be split between threads, and not a multiple of the block size
+  const Points points(12345);
+  const size_t count = points.lat.size();
+
+  for (bool multithreaded : { false, true })
+  {
+    std::vector<double> dist(count);
+    std::vector<double> azfwd(count);
+    std::vector<double> azbck(count);
+    rv += SDK_ASSERT(geodesic.inverseBatch(points.lat.data(), points.lon.data(), count, dist.data(), azfwd.data(), azbck.data(), multithreaded) == 0);
+    std::vector<double> lat(count);
+    std::vector<double> lon(count);
+    std::vector<double> backAz(count);
+    rv += SDK_ASSERT(geodesic.directBatch(dist.data(), azfwd.data(), count, lat.data(), lon.data(), backAz.data(), multithreaded) == 0);
+
+    int mismatches = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      double expectedAzfwd = 0.0;
+      double expectedAzbck = 0.0;
+      if (dist[k] != geodesic.inverse(points.lat[k], points.lon[k], &expectedAzfwd, &expectedAzbck) ||
+        azfwd[k] != expectedAzfwd || azbck[k] != expectedAzbck)
+        ++mismatches;
+      double expectedLat = 0.0;
+      double expectedLon = 0.0;
+      double expectedBackAz = 0.0;
+      geodesic.direct(dist[k], azfwd[k], &expectedLat, &expectedLon, &expectedBackAz);
+      if (lat[k] != expectedLat || lon[k] != expectedLon || backAz[k] != expectedBackAz)
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+
+    // Optional outputs may be omitted
+    std::vector<double> distOnly(count);
+    rv += SDK_ASSERT(geodesic.inverseBatch(points.lat.data(), points.lon.data(), count, distOnly.data(), nullptr, nullptr, multithreaded) == 0);
+    rv += SDK_ASSERT(distOnly == dist);
+  }
+  return rv;
+}
+
+int testAllPairs()
+{
+  int rv = 0;
+  const std::vector<simCore::Vec3> origins = {
+    simCore::Vec3(0.0, 0.0, 0.0),
+    simCore::Vec3(0.5, -1.0, 1000.0),
+    simCore::Vec3(-1.2, 2.5, 0.0)
+  };
+  const Points points(3000);
+  const size_t count = points.lat.size();
+
+  for (bool multithreaded : { false, true })
+  {
+    std::vector<double> dist(origins.size() * count);
+    std::vector<double> azfwd(origins.size() * count);
+    rv += SDK_ASSERT(simCore::SodanoGeodesic::inverseAllPairs(origins, points.lat.data(), points.lon.data(), count,
+      dist.data(), azfwd.data(), nullptr, multithreaded) == 0);
+
+    int mismatches = 0;
+    for (size_t ii = 0; ii < origins.size(); ++ii)
+    {
+      for (size_t k = 0; k < count; ++k)
+      {
+        double expectedAzfwd = 0.0;
+        const double expected = simCore::sodanoInverse(origins[ii].lat(), origins[ii].lon(), origins[ii].alt(), points.lat[k], points.lon[k], &expectedAzfwd);
+        if (dist[ii * count + k] != expected || azfwd[ii * count + k] != expectedAzfwd)
+          ++mismatches;
+      }
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+  }
+  return rv;
+}
+
+int testErrors()
+{
+  int rv = 0;
+  const simCore::SodanoGeodesic geodesic;
+  std::vector<double> in(10);
+  std::vector<double> out(10);
+
+  // Missing inputs or no outputs are errors, but an empty batch is not
+  rv += SDK_ASSERT(geodesic.inverseBatch(nullptr, in.data(), in.size(), out.data()) != 0);
+  rv += SDK_ASSERT(geodesic.inverseBatch(in.data(), in.data(), in.size(), nullptr) != 0);
+  rv += SDK_ASSERT(geodesic.inverseBatch(nullptr, nullptr, 0, nullptr) == 0);
+  rv += SDK_ASSERT(geodesic.directBatch(in.data(), nullptr, in.size(), out.data(), nullptr) != 0);
+  rv += SDK_ASSERT(geodesic.directBatch(in.data(), in.data(), in.size(), nullptr, nullptr) != 0);
+  rv += SDK_ASSERT(geodesic.directBatch(nullptr, nullptr, 0, nullptr, nullptr) == 0);
+  const std::vector<simCore::Vec3> origins(2);
+  rv += SDK_ASSERT(simCore::SodanoGeodesic::inverseAllPairs(origins, in.data(), nullptr, in.size(), out.data()) != 0);
+  rv += SDK_ASSERT(simCore::SodanoGeodesic::inverseAllPairs(origins, in.data(), in.data(), in.size(), nullptr) != 0);
+  rv += SDK_ASSERT(simCore::SodanoGeodesic::inverseAllPairs(std::vector<simCore::Vec3>(), in.data(), in.data(), in.size(), nullptr) == 0);
+  return rv;
+}
+
+/** Checks a batch large enough to be split between threads against repeated scalar calls */
+int testLargeBatch()
+{
+  int rv = 0;
+  const double refLat = 35.0 * simCore::DEG2RAD;
+  const double refLon = -120.0 * simCore::DEG2RAD;
+  const Points points(10000);
+  const size_t count = points.lat.size();
+  std::vector<double> expected(count);
+  std::vector<double> azfwd(count);
+  std::vector<double> dist(count);
+  for (size_t k = 0; k < count; ++k)
+    expected[k] = simCore::sodanoInverse(refLat, refLon, 0.0, points.lat[k], points.lon[k], &azfwd[k]);
+
+  const simCore::SodanoGeodesic geodesic(refLat, refLon, 0.0);
+  rv += SDK_ASSERT(geodesic.inverseBatch(points.lat.data(), points.lon.data(), count, dist.data(), azfwd.data(), nullptr, false) == 0);
+  rv += SDK_ASSERT(dist == expected);
+  rv += SDK_ASSERT(geodesic.inverseBatch(points.lat.data(), points.lon.data(), count, dist.data(), azfwd.data()) == 0);
+  rv += SDK_ASSERT(dist == expected);
+
+  std::vector<double> expectedLat(count);
+  std::vector<double> expectedLon(count);
+  for (size_t k = 0; k < count; ++k)
+    simCore::sodanoDirect(refLat, refLon, 0.0, dist[k], azfwd[k], &expectedLat[k], &expectedLon[k]);
+
+  std::vector<double> lat(count);
+  std::vector<double> lon(count);
+  rv += SDK_ASSERT(geodesic.directBatch(dist.data(), azfwd.data(), count, lat.data(), lon.data(), nullptr, false) == 0);
+  rv += SDK_ASSERT(lat == expectedLat);
+  rv += SDK_ASSERT(lon == expectedLon);
+  rv += SDK_ASSERT(geodesic.directBatch(dist.data(), azfwd.data(), count, lat.data(), lon.data()) == 0);
+  rv += SDK_ASSERT(lat == expectedLat);
+  rv += SDK_ASSERT(lon == expectedLon);
+  return rv;
+}
+
+}
+
+int GeodesicTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testSingle() == 0);
+  rv += SDK_ASSERT(testBatch() == 0);
+  rv += SDK_ASSERT(testAllPairs() == 0);
+  rv += SDK_ASSERT(testErrors() == 0);
+  rv += SDK_ASSERT(testLargeBatch() == 0);
+
+  std::cout << "GeodesicTest: " << (rv == 0 ? "PASSED" : "FAILED") << "\n";
+  return rv;
+}
@@ -0,0 +1,103 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/System/ParallelFor.h"
+
+namespace {
+
+/** Counts how many times each index is visited */
+int testCoverage(size_t count, size_t maxPartitions)
+{
+  int rv = 0;
+  std::vector<std::atomic<int> > visits(count);
+  std::atomic<size_t> calls(0);
+  simCore::parallelFor(count, maxPartitions, [&](size_t begin, size_t end) {
+    ++calls;
+    for (size_t ii = begin; ii < end; ++ii)
+      ++visits[ii];
+  });
+  for (const auto& visit : visits)
+    rv += SDK_ASSERT(visit == 1);
+  rv += SDK_ASSERT(calls >= (count == 0 ? 0u : 1u));
+  rv += SDK_ASSERT(calls <= std::max<size_t>(1, maxPartitions));
+  return rv;
+}
+
+int testNested()
+{
+  int rv = 0;
+  // Calls from inside a partition run on the calling thread rather than wait for the busy workers
+  std::atomic<size_t> total(0);
+  simCore::parallelFor(64, 64, [&](size_t begin, size_t end) {
+    for (size_t ii = begin; ii < end; ++ii)
+    {
+      simCore::parallelFor(100, 100, [&](size_t innerBegin, size_t innerEnd) {
+        total += innerEnd - innerBegin;
+      });
+    }
+  });
+  rv += SDK_ASSERT(total == 6400);
+  return rv;
+}
+
+int testConcurrent()
+{
+  int rv = 0;
+  std::atomic<size_t> totals[4] = { 0, 0, 0, 0 };
+  std::vector<std::thread> threads;
+  for (size_t tt = 0; tt < 4; ++tt)
+  {
+    threads.emplace_back([&totals, tt]() {
+      for (int repeat = 0; repeat < 50; ++repeat)
+      {
+        simCore::parallelFor(1000, 8, [&totals, tt](size_t begin, size_t end) {
+          totals[tt] += end - begin;
+        });
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  for (const auto& total : totals)
+    rv += SDK_ASSERT(total == 50000);
+  return rv;
+}
+
+}
+
+int ParallelForTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testCoverage(0, 4) == 0);
+  rv += SDK_ASSERT(testCoverage(1, 4) == 0);
+  rv += SDK_ASSERT(testCoverage(1000, 0) == 0);
+  rv += SDK_ASSERT(testCoverage(1000, 1) == 0);
+  rv += SDK_ASSERT(testCoverage(3, 16) == 0);
+  rv += SDK_ASSERT(testCoverage(100003, 64) == 0);
+  rv += SDK_ASSERT(testNested() == 0);
+  rv += SDK_ASSERT(testConcurrent() == 0);
+  return rv;
+}
@@ -20,11 +20,17 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
+#include <random>
+#include <thread>
 
 #include "simCore/Common/Version.h"
 #include "simCore/String/UtfUtils.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/MemoryDataSlice.h"
 #include "simData/LinearInterpolator.h"
 #include "simData/DataTable.h"
 #include "simData/CategoryData/CategoryFilter.h"
@@ -194,6 +200,44 @@ public:
   /// Do the type specific update
   virtual void addUpdate(uint64_t id, double time) = 0;
 
+  /// Adds all the updates for numberOfSeconds with one bulk call per entity, followed by the per-point extras
+  void addBulkUpdates(size_t numberOfSeconds)
+  {
+    if (dataPerSecond_ == 0)
+      return;
+
+    std::vector<double> times;
+    times.reserve(numberOfSeconds * dataPerSecond_);
+    for (size_t ii = 0; ii < numberOfSeconds; ii++)
+    {
+      for (size_t jj = 0; jj < dataPerSecond_; jj++)
+        times.push_back(static_cast<double>(ii) + static_cast<double>(jj) / static_cast<double>(dataPerSecond_));
+    }
+
+    for (size_t kk = 0; kk < number_; kk++)
+    {
+      uint64_t id = initialId_+kk;
+      addUpdateList(id, times);
+
+      for (double time : times)
+      {
+        if (includeColorPerData_)
+          addColor(id, time);
+
+        addCategory(helper_, id, categoryPerDataPoint_, time);
+        addGeneric(helper_, id, genericPerDataPoint_, time);
+        addTableData(helper_, id, time);
+      }
+    }
+  }
+
+  /// Do the type specific bulk update; the default adds one update at a time
+  virtual void addUpdateList(uint64_t id, const std::vector<double>& times)
+  {
+    for (double time : times)
+      addUpdate(id, time);
+  }
+
   /// Add category data
   void addCategory(simUtil::DataStoreTestHelper& helper, uint64_t id, size_t number, double time)
   {
@@ -390,6 +434,21 @@ public:
   {
     helper_.addPlatformUpdate(time, id);
   };
+
+  virtual void addUpdateList(uint64_t id, const std::vector<double>& times) override
+  {
+    // Same values as DataStoreTestHelper::addPlatformUpdate()
+    std::vector<simData::PlatformUpdate> updates(times.size());
+    for (size_t ii = 0; ii < times.size(); ii++)
+    {
+      const double time = times[ii];
+      updates[ii].set_time(time);
+      updates[ii].set_x(0.0 + time);
+      updates[ii].set_y(1.0 + time);
+      updates[ii].set_z(2.0 + time);
+    }
+    helper_.dataStore()->addPlatformUpdates(id, updates);
+  }
 };
 
 /// Handles special processing for beams
@@ -423,6 +482,21 @@ public:
   {
     helper_.addBeamUpdate(time, id);
   };
+
+  virtual void addUpdateList(uint64_t id, const std::vector<double>& times) override
+  {
+    // Same values as DataStoreTestHelper::addBeamUpdate()
+    std::vector<simData::BeamUpdate> updates(times.size());
+    for (size_t ii = 0; ii < times.size(); ii++)
+    {
+      const double time = times[ii];
+      updates[ii].set_time(time);
+      updates[ii].set_azimuth(0.0 + time);
+      updates[ii].set_elevation(1.0 + time);
+      updates[ii].set_range(2.0 + time);
+    }
+    helper_.dataStore()->addBeamUpdates(id, updates);
+  }
 };
 
 /// Handles special processing for gates
@@ -456,6 +530,21 @@ public:
   {
     helper_.addGateUpdate(time, id);
   };
+
+  virtual void addUpdateList(uint64_t id, const std::vector<double>& times) override
+  {
+    // Same values as DataStoreTestHelper::addGateUpdate()
+    std::vector<simData::GateUpdate> updates(times.size());
+    for (size_t ii = 0; ii < times.size(); ii++)
+    {
+      const double time = times[ii];
+      updates[ii].set_time(time);
+      updates[ii].set_azimuth(0.0 + time);
+      updates[ii].set_elevation(1.0 + time);
+      updates[ii].set_width(2.0 + time);
+    }
+    helper_.dataStore()->addGateUpdates(id, updates);
+  }
 };
 
 /// Handles special processing for lasers
@@ -489,6 +578,21 @@ public:
   {
     helper_.addLaserUpdate(time, id);
   };
+
+  virtual void addUpdateList(uint64_t id, const std::vector<double>& times) override
+  {
+    // Same values as DataStoreTestHelper::addLaserUpdate()
+    std::vector<simData::LaserUpdate> updates(times.size());
+    for (size_t ii = 0; ii < times.size(); ii++)
+    {
+      const double time = times[ii];
+      updates[ii].set_time(time);
+      updates[ii].mutable_orientation()->set_yaw(0.0 + time);
+      updates[ii].mutable_orientation()->set_pitch(1.0 + time);
+      updates[ii].mutable_orientation()->set_roll(2.0 + time);
+    }
+    helper_.dataStore()->addLaserUpdates(id, updates);
+  }
 };
 
 /// Handles special processing for LOB Groups
@@ -566,7 +670,14 @@ struct TopLevelOptions
     dataLimiting(false),
     playforward(true),
     addListener(true),
-    testCD(false)
+    testCD(false),
+    updateStorage(simData::MemoryDataStore::UpdateStorage::DEQUE),
+    compareStorage(false),
+    updateThreads(1),
+    threadScaling(false),
+    bulkLoad(false),
+    compareSeek(false),
+    compareLookup(false)
   {
   }
 
@@ -578,6 +689,13 @@ struct TopLevelOptions
   bool playforward;  // True = move time forwards, False = move time backwards
   bool addListener;  // True = count the number of callbacks
   bool testCD;       // True = testing will include testing of CategoryData
+  simData::MemoryDataStore::UpdateStorage updateStorage;  // Storage used for platform, beam and gate updates
+  bool compareStorage;  // True = report memory and throughput for each update storage instead of running a playback
+  unsigned int updateThreads;  // Number of threads used by the DataStore update, including the calling thread
+  bool threadScaling;  // True = in file mode, repeat the playback with 1, 2, 4... threads and report the speedup
+  bool bulkLoad;  // True = in file mode, load each entity's updates with one bulk call
+  bool compareSeek;  // True = report DataStore::update() rates for sequential, reverse and random times with and without the time index
+  bool compareLookup;  // True = report the cost of entity type, properties and slice lookups at 1k, 10k and 100k entities
 };
 
 /// Initializes the DataStore and creates all the entities
@@ -635,34 +753,9 @@ int cleanUpDataStore(simData::DataStore& ds, const TopLevelOptions& options, Ent
   return rv;
 }
 
-/// Simulates file mode by loading the data than doing one playback
-double fileMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities)
+/// Plays the data back and returns the elapsed seconds
+double playback(simData::DataStore& ds, const TopLevelOptions& options, Entities& entities)
 {
-  std::cout << "In File Mode" << std::endl;
-  std::cout << "Creating Data" << std::endl;
-
-  for (size_t ii = 0; ii < static_cast<size_t>(options.numberOfSeconds); ii++)
-  {
-    for (size_t jj = 0; jj < entities.platforms->dataPerSecond(); jj++)
-      entities.platforms->addUpdates(ii, jj, entities.platforms->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.beams->dataPerSecond(); jj++)
-      entities.beams->addUpdates(ii, jj, entities.beams->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.gates->dataPerSecond(); jj++)
-      entities.gates->addUpdates(ii, jj, entities.gates->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.lasers->dataPerSecond(); jj++)
-      entities.lasers->addUpdates(ii, jj, entities.lasers->dataPerSecond());
-
-    for (size_t jj = 0; jj < entities.lobGroups->dataPerSecond(); jj++)
-      entities.lobGroups->addUpdates(ii, jj, entities.lobGroups->dataPerSecond());
-  }
-
-  std::cout << "Starting updates" << std::endl;
-  // The sleep helps with looking at the data in the Intel tools
-  Sleep(1000);
-
   double direction = 1.0;
   int offset = 0;
   if (!options.playforward)
@@ -691,6 +784,71 @@ double fileMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, To
   return endTime-startTime;
 }
 
+/// Repeats the playback with an increasing number of update threads, reporting the speedup over one thread
+double threadScaling(simData::MemoryDataStore& ds, const TopLevelOptions& options, Entities& entities)
+{
+  const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 2u);
+  double serialTime = 0.0;
+  double lastTime = 0.0;
+  for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+  {
+    ds.setUpdateThreads(numThreads);
+    lastTime = playback(ds, options, entities);
+    if (numThreads == 1)
+      serialTime = lastTime;
+    std::cout << "Threads " << numThreads << ": " << lastTime << " seconds, speedup "
+      << (lastTime <= 0.0 ? 0.0 : serialTime / lastTime) << std::endl;
+  }
+  return lastTime;
+}
+
+/// Simulates file mode by loading the data than doing one playback
+double fileMode(simData::MemoryDataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities)
+{
+  std::cout << "In File Mode" << std::endl;
+  std::cout << "Creating Data" << std::endl;
+
+  const double loadStartTime = simCore::systemTimeToSecsBgnYr();
+  if (options.bulkLoad)
+  {
+    entities.platforms->addBulkUpdates(options.numberOfSeconds);
+    entities.beams->addBulkUpdates(options.numberOfSeconds);
+    entities.gates->addBulkUpdates(options.numberOfSeconds);
+    entities.lasers->addBulkUpdates(options.numberOfSeconds);
+    entities.lobGroups->addBulkUpdates(options.numberOfSeconds);
+  }
+  else
+  {
+    for (size_t ii = 0; ii < static_cast<size_t>(options.numberOfSeconds); ii++)
+    {
+      for (size_t jj = 0; jj < entities.platforms->dataPerSecond(); jj++)
+        entities.platforms->addUpdates(ii, jj, entities.platforms->dataPerSecond());
+
+      for (size_t jj = 0; jj < entities.beams->dataPerSecond(); jj++)
+        entities.beams->addUpdates(ii, jj, entities.beams->dataPerSecond());
+
+      for (size_t jj = 0; jj < entities.gates->dataPerSecond(); jj++)
+        entities.gates->addUpdates(ii, jj, entities.gates->dataPerSecond());
+
+      for (size_t jj = 0; jj < entities.lasers->dataPerSecond(); jj++)
+        entities.lasers->addUpdates(ii, jj, entities.lasers->dataPerSecond());
+
+      for (size_t jj = 0; jj < entities.lobGroups->dataPerSecond(); jj++)
+        entities.lobGroups->addUpdates(ii, jj, entities.lobGroups->dataPerSecond());
+    }
+  }
+
+  std::cout << "Data created in " << simCore::systemTimeToSecsBgnYr() - loadStartTime << " seconds" << std::endl;
+  std::cout << "Starting updates" << std::endl;
+  // The sleep helps with looking at the data in the Intel tools
+  Sleep(1000);
+
+  if (options.threadScaling)
+    return threadScaling(ds, options, entities);
+
+  return playback(ds, options, entities);
+}
+
 /// Simulates live mode by repeatedly adding data and doing an update
 double liveMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, TopLevelOptions& options, Entities& entities)
 {
@@ -772,6 +930,226 @@ double liveMode(simData::DataStore& ds, simUtil::DataStoreTestHelper& helper, To
   return endTime-startTime;
 }
 
+/// Returns the approximate bytes used by the platform update slices, and their total number of points
+size_t platformBytes(const simData::MemoryDataStore& ds, const std::vector<uint64_t>& ids, size_t& points)
+{
+  size_t bytes = 0;
+  points = 0;
+  for (auto id : ids)
+  {
+    const simData::MemoryDataSlice<simData::PlatformUpdate>* slice = dynamic_cast<const simData::MemoryDataSlice<simData::PlatformUpdate>*>(ds.platformUpdateSlice(id));
+    if (slice == nullptr)
+      continue;
+    bytes += slice->memoryUsage();
+    points += slice->numItems();
+  }
+  return bytes;
+}
+
+/// Inserts and searches the same platform data with the given update storage, printing bytes per point and throughput
+void measureStorage(simData::MemoryDataStore::UpdateStorage storage, const std::string& name, const TopLevelOptions& options, size_t numPlatforms, size_t dataPerSecond)
+{
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(storage);
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  std::vector<uint64_t> ids;
+  for (size_t ii = 0; ii < numPlatforms; ++ii)
+    ids.push_back(helper.addPlatform());
+
+  const size_t pointsPerPlatform = static_cast<size_t>(options.numberOfSeconds) * dataPerSecond;
+  const double insertStart = simCore::systemTimeToSecsBgnYr();
+  for (size_t ii = 0; ii < pointsPerPlatform; ++ii)
+  {
+    const double time = static_cast<double>(ii) / static_cast<double>(dataPerSecond);
+    for (auto id : ids)
+      helper.addPlatformUpdate(time, id);
+  }
+  const double insertTime = simCore::systemTimeToSecsBgnYr() - insertStart;
+  size_t points = 0;
+  const size_t insertedBytes = platformBytes(ds, ids, points);
+
+  // Search at a fixed stride through the data so that both storages see identical requests
+  const size_t numLookups = 100000;
+  const double lastTime = static_cast<double>(pointsPerPlatform) / static_cast<double>(dataPerSecond);
+  size_t found = 0;
+  const double lookupStart = simCore::systemTimeToSecsBgnYr();
+  for (size_t ii = 0; ii < numLookups; ++ii)
+  {
+    const double time = fmod(static_cast<double>(ii) * 7.31, lastTime);
+    const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(ids[ii % ids.size()]);
+    if (slice->lower_bound(time).peekNext() != nullptr)
+      ++found;
+  }
+  const double lookupTime = simCore::systemTimeToSecsBgnYr() - lookupStart;
+  // Iterators can materialize update objects, so report memory after searching separately
+  const size_t searchedBytes = platformBytes(ds, ids, points);
+
+  const size_t inserted = pointsPerPlatform * ids.size();
+  std::cout << name << ": " << points << " points, "
+    << (points == 0 ? 0.0 : static_cast<double>(insertedBytes) / static_cast<double>(points)) << " bytes/point ("
+    << (points == 0 ? 0.0 : static_cast<double>(searchedBytes) / static_cast<double>(points)) << " after lookups), "
+    << (insertTime <= 0.0 ? 0.0 : static_cast<double>(inserted) / insertTime) << " inserts/sec, "
+    << (lookupTime <= 0.0 ? 0.0 : static_cast<double>(numLookups) / lookupTime) << " lookups/sec"
+    << " (" << found << " hits)" << std::endl;
+}
+
+/// Compares the memory use and throughput of the update storage options
+void compareStorage(const TopLevelOptions& options, Entities& entities)
+{
+  std::cout << "Comparing Update Storage" << std::endl;
+  const size_t numPlatforms = std::max<size_t>(1, entities.platforms->number());
+  const size_t dataPerSecond = std::max<size_t>(1, entities.platforms->dataPerSecond());
+  measureStorage(simData::MemoryDataStore::UpdateStorage::DEQUE, "Deque", options, numPlatforms, dataPerSecond);
+  measureStorage(simData::MemoryDataStore::UpdateStorage::COLUMNAR, "Columnar", options, numPlatforms, dataPerSecond);
+}
+
+/// Times DataStore::update() for sequential, reverse and random times, printing frames per second
+void measureSeeks(bool timeIndexing, const std::string& name, const TopLevelOptions& options, size_t numPlatforms, size_t dataPerSecond)
+{
+  simData::MemoryDataStore ds;
+  ds.setTimeIndexing(timeIndexing);
+  simData::LinearInterpolator interpolator;
+  ds.setInterpolator(&interpolator);
+  ds.enableInterpolation(options.interpolate);
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  const size_t pointsPerPlatform = static_cast<size_t>(options.numberOfSeconds) * dataPerSecond;
+  std::vector<uint64_t> ids;
+  for (size_t ii = 0; ii < numPlatforms; ++ii)
+  {
+    ids.push_back(helper.addPlatform());
+    std::vector<simData::PlatformUpdate> updates(pointsPerPlatform);
+    for (size_t jj = 0; jj < pointsPerPlatform; ++jj)
+    {
+      updates[jj].set_time(static_cast<double>(jj) / static_cast<double>(dataPerSecond));
+      updates[jj].set_x(6378137.0 + static_cast<double>(jj));
+      updates[jj].set_y(static_cast<double>(ii));
+      updates[jj].set_z(0.0);
+    }
+    ds.addPlatformUpdates(ids.back(), updates);
+  }
+
+  // Steps cover about two points per frame, so sequential playback sometimes misses the neighbor check
+  const size_t numFrames = std::max<size_t>(1, pointsPerPlatform / 2);
+  const double lastTime = static_cast<double>(pointsPerPlatform) / static_cast<double>(dataPerSecond);
+  std::vector<double> forward(numFrames);
+  for (size_t ii = 0; ii < numFrames; ++ii)
+    forward[ii] = lastTime * static_cast<double>(ii) / static_cast<double>(numFrames);
+  const std::vector<double> reverse(forward.rbegin(), forward.rend());
+  std::vector<double> random(numFrames);
+  // Fixed seed so that every run sees the same seeks
+  std::mt19937 generator(5150);
+  std::uniform_real_distribution<double> distribution(0.0, lastTime);
+  for (auto& time : random)
+    time = distribution(generator);
+
+  auto framesPerSecond = [&ds](const std::vector<double>& times) {
+    const double start = simCore::systemTimeToSecsBgnYr();
+    for (double time : times)
+      ds.update(time);
+    const double elapsed = simCore::systemTimeToSecsBgnYr() - start;
+    return (elapsed <= 0.0) ? 0.0 : static_cast<double>(times.size()) / elapsed;
+  };
+  // The first update builds the time index, so keep it out of the timing
+  ds.update(lastTime);
+  const double sequentialRate = framesPerSecond(forward);
+  const double reverseRate = framesPerSecond(reverse);
+  const double randomRate = framesPerSecond(random);
+
+  std::cout << name << ": " << numPlatforms << " platforms of " << pointsPerPlatform << " points, frames/sec: "
+    << sequentialRate << " sequential, " << reverseRate << " reverse, " << randomRate << " random" << std::endl;
+}
+
+/// Compares DataStore::update() rates with and without the time index
+void compareSeek(const TopLevelOptions& options, Entities& entities)
+{
+  std::cout << "Comparing Time Index" << std::endl;
+  const size_t numPlatforms = std::max<size_t>(1, entities.platforms->number());
+  const size_t dataPerSecond = std::max<size_t>(1, entities.platforms->dataPerSecond());
+  measureSeeks(false, "Binary search", options, numPlatforms, dataPerSecond);
+  measureSeeks(true, "Time index", options, numPlatforms, dataPerSecond);
+}
+
+/// Times lookups of the type, properties and update slice of random entities, printing nanoseconds per lookup
+void measureLookups(size_t numEntities)
+{
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  // Half platforms, with a beam and a laser on every other platform, so lookups cross entity types
+  std::vector<uint64_t> ids;
+  ids.reserve(numEntities);
+  while (ids.size() < numEntities)
+  {
+    const uint64_t platformId = helper.addPlatform();
+    ids.push_back(platformId);
+    if (ids.size() < numEntities)
+      ids.push_back(helper.addPlatform());
+    if (ids.size() < numEntities)
+      ids.push_back(helper.addBeam(platformId));
+    if (ids.size() < numEntities)
+      ids.push_back(helper.addLaser(platformId));
+  }
+
+  // Fixed seed so that every run sees the same order; visit each entity several times
+  std::mt19937 generator(5150);
+  std::vector<uint64_t> order;
+  const size_t numLookups = std::max<size_t>(1000000, numEntities);
+  order.reserve(numLookups);
+  while (order.size() < numLookups)
+  {
+    std::shuffle(ids.begin(), ids.end(), generator);
+    order.insert(order.end(), ids.begin(), ids.begin() + std::min(ids.size(), numLookups - order.size()));
+  }
+
+  auto nanosecondsPerLookup = [&order](const std::function<size_t(uint64_t)>& lookup) {
+    size_t found = 0;
+    const double start = simCore::systemTimeToSecsBgnYr();
+    for (uint64_t id : order)
+      found += lookup(id);
+    const double elapsed = simCore::systemTimeToSecsBgnYr() - start;
+    // Every lookup is expected to find its entity; the check also keeps the loop from being optimized away
+    if (found != order.size())
+      std::cerr << "Lookup failed for " << (order.size() - found) << " entities" << std::endl;
+    return elapsed * 1e9 / static_cast<double>(order.size());
+  };
+
+  const double typeTime = nanosecondsPerLookup([&ds](uint64_t id) {
+    return (ds.objectType(id) != simData::NONE) ? 1 : 0;
+  });
+  const double propertiesTime = nanosecondsPerLookup([&ds](uint64_t id) {
+    simData::DataStore::Transaction txn;
+    switch (ds.objectType(id))
+    {
+    case simData::PLATFORM:
+      return (ds.platformProperties(id, &txn) != nullptr) ? 1 : 0;
+    case simData::BEAM:
+      return (ds.beamProperties(id, &txn) != nullptr) ? 1 : 0;
+    case simData::LASER:
+      return (ds.laserProperties(id, &txn) != nullptr) ? 1 : 0;
+    default:
+      return 0;
+    }
+  });
+  const double sliceTime = nanosecondsPerLookup([&ds](uint64_t id) {
+    return ((ds.platformUpdateSlice(id) != nullptr) || (ds.beamUpdateSlice(id) != nullptr) ||
+      (ds.laserUpdateSlice(id) != nullptr)) ? 1 : 0;
+  });
+
+  std::cout << numEntities << " entities, ns/lookup: " << typeTime << " objectType, "
+    << propertiesTime << " type and properties, " << sliceTime << " update slice" << std::endl;
+}
+
+/// Reports entity lookup costs as the number of entities grows
+void compareLookup()
+{
+  std::cout << "Comparing Entity Lookup" << std::endl;
+  measureLookups(1000);
+  measureLookups(10000);
+  measureLookups(100000);
+}
+
 void writeEntityConfigurationPart(std::ofstream& output, const std::string& entity, int number)
 {
   output << entity << " Number " << number << " # Number of entities, can be zero for all entity types except platforms" << std::endl;
@@ -804,6 +1182,13 @@ void writeExampleConfigurationFile()
   output << "Interpolate true          # State of the DataStore interpolation" << std::endl;
   output << "NumberOfSeconds 150       # Seconds of data" << std::endl;
   output << "DataLimiting false        # Used in Live mode to limit the amount of data, limits are set below" << std::endl;
+  output << "UpdateStorage Deque       # Storage for platform, beam and gate updates, Deque, Columnar or Tiered" << std::endl;
+  output << "CompareStorage false      # True reports bytes/point and insert/lookup rates for each storage instead of a playback" << std::endl;
+  output << "UpdateThreads 1           # Number of threads used by the DataStore update, including the main thread" << std::endl;
+  output << "ThreadScaling false       # True repeats the File mode playback with 1, 2, 4... threads and reports the speedup" << std::endl;
+  output << "BulkLoad false            # True loads each entity's File mode updates with one bulk call" << std::endl;
+  output << "CompareSeek false         # True reports update rates for sequential, reverse and random times with and without the time index" << std::endl;
+  output << "CompareLookup false       # True reports entity lookup costs at 1k, 10k and 100k entities" << std::endl;
   output << std::endl;
 
   writeEntityConfigurationPart(output, "Platform", 1000);
@@ -1038,6 +1423,32 @@ int loadConfigurationFile(const std::string& fileName, TopLevelOptions& options,
         options.numberOfSeconds = atoi(tokens[1].c_str());
       else if (simCore::caseCompare(tokens[0], "DataLimiting") == 0)
         options.dataLimiting = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "UpdateStorage") == 0)
+      {
+        if (simCore::caseCompare(tokens[1], "Columnar") == 0)
+          options.updateStorage = simData::MemoryDataStore::UpdateStorage::COLUMNAR;
+        else if (simCore::caseCompare(tokens[1], "Deque") == 0)
+          options.updateStorage = simData::MemoryDataStore::UpdateStorage::DEQUE;
+        else if (simCore::caseCompare(tokens[1], "Tiered") == 0)
+          options.updateStorage = simData::MemoryDataStore::UpdateStorage::TIERED;
+        else
+        {
+          std::cerr << "Unknown update storage " << tokens[1] << " on line " << currentLineNumber << std::endl;
+          return -1;
+        }
+      }
+      else if (simCore::caseCompare(tokens[0], "CompareStorage") == 0)
+        options.compareStorage = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "CompareSeek") == 0)
+        options.compareSeek = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "CompareLookup") == 0)
+        options.compareLookup = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "UpdateThreads") == 0)
+        options.updateThreads = static_cast<unsigned int>(std::max(1, atoi(tokens[1].c_str())));
+      else if (simCore::caseCompare(tokens[0], "ThreadScaling") == 0)
+        options.threadScaling = (simCore::caseCompare(tokens[1], "True") == 0);
+      else if (simCore::caseCompare(tokens[0], "BulkLoad") == 0)
+        options.bulkLoad = (simCore::caseCompare(tokens[1], "True") == 0);
       else
       {
         std::cerr << "Unknown command on line " << currentLineNumber << std::endl;
@@ -1114,6 +1525,29 @@ int main(int argc, char *argv[])
     return -1;
   }
 
+  if (options.compareStorage)
+  {
+    compareStorage(options, entities);
+    return 0;
+  }
+
+  if (options.compareSeek)
+  {
+    compareSeek(options, entities);
+    return 0;
+  }
+
+  if (options.compareLookup)
+  {
+    compareLookup();
+    return 0;
+  }
+
+  ds.setUpdateStorage(options.updateStorage);
+  ds.setUpdateThreads(options.updateThreads);
+  // Repeated playbacks would throw off the callback counts checked in cleanUpDataStore()
+  if (options.threadScaling)
+    options.addListener = false;
   simData::LinearInterpolator* interpolator = initializeDataStore(ds, helper, options, entities, &counters);
 
   double updateTime;
@@ -20,6 +20,8 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Math.h"
@@ -2313,6 +2315,306 @@ int maxSubTableRowTest()
   return rv;
 }
 
+int readColumnsTest()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simData::DataTableManager& mgr = ds.dataTableManager();
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(mgr.addDataTable(1, "Test Table", &table).isSuccess());
+  simData::TableColumn* doubles = nullptr;
+  simData::TableColumn* ints = nullptr;
+  simData::TableColumn* strings = nullptr;
+  rv += SDK_ASSERT(table->addColumn("Double", simData::VT_DOUBLE, 0, &doubles).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("Int", simData::VT_INT16, 0, &ints).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("String", simData::VT_STRING, 0, &strings).isSuccess());
+
+  // Rows out of order, with the int column only in odd rows and the string column only in the last row
+  for (int k : { 4, 0, 3, 1, 2, 5 })
+  {
+    simData::TableRow row;
+    row.setTime(k * 10.0);
+    row.setValue(doubles->columnId(), k + 0.5);
+    if (k % 2 == 1)
+      row.setValue(ints->columnId(), static_cast<int16_t>(k * 100));
+    if (k == 5)
+      row.setValue(strings->columnId(), std::string("last"));
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  }
+
+  simData::TableColumnChunk chunk;
+  rv += SDK_ASSERT(table->readColumns(10.0, 50.0, { ints->columnId(), doubles->columnId() }, chunk).isSuccess());
+  rv += SDK_ASSERT(chunk.rowCount() == 4);
+  rv += SDK_ASSERT(chunk.columnCount() == 2);
+  rv += SDK_ASSERT(chunk.times() == std::vector<double>({ 10.0, 20.0, 30.0, 40.0 }));
+  rv += SDK_ASSERT(chunk.columnId(0) == ints->columnId());
+  rv += SDK_ASSERT(chunk.variableType(0) == simData::VT_INT16);
+  rv += SDK_ASSERT(chunk.values<double>(0) == nullptr);
+  rv += SDK_ASSERT(chunk.hasType<int16_t>(0) && !chunk.hasType<double>(0));
+  const int16_t* intValues = chunk.values<int16_t>(0);
+  rv += SDK_ASSERT(intValues != nullptr);
+  if (intValues)
+  {
+    rv += SDK_ASSERT(intValues[0] == 100 && intValues[2] == 300);
+    rv += SDK_ASSERT(intValues[1] == 0 && intValues[3] == 0);
+  }
+  rv += SDK_ASSERT(!chunk.isNull(0, 0) && chunk.isNull(0, 1) && !chunk.isNull(0, 2) && chunk.isNull(0, 3));
+  rv += SDK_ASSERT(chunk.nullCount(0) == 2);
+  rv += SDK_ASSERT(chunk.nullBitmap(0).size() == 1 && chunk.nullBitmap(0)[0] == 0xa);
+  const double* doubleValues = chunk.values<double>(1);
+  rv += SDK_ASSERT(doubleValues != nullptr);
+  if (doubleValues)
+    rv += SDK_ASSERT(doubleValues[0] == 1.5 && doubleValues[1] == 2.5 && doubleValues[3] == 4.5);
+  rv += SDK_ASSERT(chunk.nullCount(1) == 0);
+
+  // Rows only come from the subtables of the requested columns
+  rv += SDK_ASSERT(table->readColumns(0.0, 100.0, { strings->columnId() }, chunk).isSuccess());
+  rv += SDK_ASSERT(chunk.rowCount() == 1 && chunk.times()[0] == 50.0);
+  rv += SDK_ASSERT(chunk.values<std::string>(0) != nullptr && chunk.values<std::string>(0)[0] == "last");
+
+  // Empty ranges and invalid columns
+  rv += SDK_ASSERT(table->readColumns(60.0, 100.0, { doubles->columnId() }, chunk).isSuccess());
+  rv += SDK_ASSERT(chunk.rowCount() == 0 && chunk.columnCount() == 1 && chunk.nullCount(0) == 0);
+  rv += SDK_ASSERT(chunk.hasType<double>(0) && !chunk.hasType<float>(0));
+  rv += SDK_ASSERT(table->readColumns(0.0, 100.0, { doubles->columnId(), 1000 }, chunk).isError());
+  rv += SDK_ASSERT(chunk.columnCount() == 0);
+
+  // Single column reads convert to double
+  std::vector<double> times;
+  std::vector<double> values;
+  ints->values(0.0, 100.0, times, values);
+  rv += SDK_ASSERT(times == std::vector<double>({ 10.0, 30.0, 50.0 }));
+  rv += SDK_ASSERT(values == std::vector<double>({ 100.0, 300.0, 500.0 }));
+  doubles->values(20.0, 30.0, times, values);
+  rv += SDK_ASSERT(times.size() == 1 && values.size() == 1 && values[0] == 2.5);
+  return rv;
+}
+
+/** Computes the aggregate of the column in the time range from its values */
+simData::TableColumnAggregate bruteForceAggregate(const simData::TableColumn& column, double beginTime, double endTime)
+{
+  std::vector<double> times;
+  std::vector<double> values;
+  column.values(beginTime, endTime, times, values);
+  simData::TableColumnAggregate rv;
+  for (size_t k = 0; k < values.size(); ++k)
+  {
+    simData::TableColumnAggregate one;
+    one.count = 1;
+    one.min = one.max = one.sum = one.firstValue = one.lastValue = values[k];
+    one.firstTime = one.lastTime = one.minTime = one.maxTime = times[k];
+    rv.append(one);
+  }
+  return rv;
+}
+
+/** Returns 0 if the column's aggregates match the brute force aggregates for a few windows */
+int checkAggregates(const simData::TableColumn& column)
+{
+  int rv = 0;
+  double beginTime = 0.0;
+  double endTime = 0.0;
+  column.getTimeRange(beginTime, endTime);
+  const double span = endTime - beginTime;
+  for (double from : { -1.0, 0.0, 0.13, 0.5 })
+  {
+    for (double to : { 0.2, 0.71, 1.0, 2.0 })
+    {
+      const double windowBegin = beginTime + from * span;
+      const double windowEnd = beginTime + to * span;
+      simData::TableColumnAggregate aggregate;
+      rv += SDK_ASSERT(column.aggregate(windowBegin, windowEnd, aggregate).isSuccess());
+      const simData::TableColumnAggregate expected = bruteForceAggregate(column, windowBegin, windowEnd);
+      rv += SDK_ASSERT(aggregate.count == expected.count);
+      rv += SDK_ASSERT(aggregate.min == expected.min && aggregate.max == expected.max);
+      rv += SDK_ASSERT(aggregate.minTime == expected.minTime && aggregate.maxTime == expected.maxTime);
+      rv += SDK_ASSERT(simCore::areEqual(aggregate.sum, expected.sum, 1e-6 * std::abs(expected.sum) + 1e-9));
+      rv += SDK_ASSERT(aggregate.firstTime == expected.firstTime && aggregate.firstValue == expected.firstValue);
+      rv += SDK_ASSERT(aggregate.lastTime == expected.lastTime && aggregate.lastValue == expected.lastValue);
+    }
+  }
+  return rv;
+}
+
+int aggregateTest()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platformId = helper.addPlatform();
+  simData::DataTableManager& mgr = ds.dataTableManager();
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(mgr.addDataTable(platformId, "Test Table", &table).isSuccess());
+  simData::TableColumn* values = nullptr;
+  simData::TableColumn* strings = nullptr;
+  rv += SDK_ASSERT(table->addColumn("Values", simData::VT_INT32, 0, &values).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("Strings", simData::VT_STRING, 0, &strings).isSuccess());
+
+  simData::TableColumnAggregate aggregate;
+  rv += SDK_ASSERT(values->aggregate(0.0, 10.0, aggregate).isSuccess());
+  rv += SDK_ASSERT(aggregate.count == 0 && aggregate.mean() == 0.0);
+  rv += SDK_ASSERT(strings->aggregate(0.0, 10.0, aggregate).isError());
+
+  // Appends, which extend the summaries
+  for (int k = 0; k < 2000; ++k)
+  {
+    simData::TableRow row;
+    row.setTime(k * 0.1);
+    row.setValue(values->columnId(), (k * 37) % 1001 - 500);
+    table->addRow(row);
+    if (k % 500 == 499)
+      rv += checkAggregates(*values);
+  }
+  rv += SDK_ASSERT(values->aggregate(0.0, 1.0, aggregate).isSuccess());
+  rv += SDK_ASSERT(aggregate.count == 10 && aggregate.mean() == aggregate.sum / 10);
+
+  // Out of order inserts, replacements through rows and through iterators
+  simData::TableRow row;
+  row.setTime(50.05);
+  row.setValue(values->columnId(), 100000);
+  table->addRow(row);
+  rv += checkAggregates(*values);
+  row.setTime(20.0);
+  row.setValue(values->columnId(), -100000);
+  table->addRow(row);
+  rv += checkAggregates(*values);
+  simData::TableColumn::Iterator iter = values->lower_bound(150.0);
+  rv += SDK_ASSERT(iter.hasNext());
+  iter.next()->setValue(200000);
+  rv += checkAggregates(*values);
+
+  // Flushing a time range
+  table->flush(100.0, 120.0);
+  rv += checkAggregates(*values);
+
+  // Buckets match single windows
+  std::vector<simData::TableColumnAggregate> buckets;
+  rv += SDK_ASSERT(values->aggregate(0.0, 200.0, 8, buckets).isSuccess());
+  rv += SDK_ASSERT(buckets.size() == 8);
+  size_t total = 0;
+  for (size_t k = 0; k < buckets.size(); ++k)
+  {
+    rv += SDK_ASSERT(values->aggregate(k * 25.0, (k + 1) * 25.0, aggregate).isSuccess());
+    rv += SDK_ASSERT(aggregate.count == buckets[k].count && aggregate.min == buckets[k].min && aggregate.max == buckets[k].max);
+    total += buckets[k].count;
+  }
+  rv += SDK_ASSERT(total == values->size());
+  rv += SDK_ASSERT(values->aggregate(0.0, 200.0, 0, buckets).isError());
+
+  // Data limiting drops the oldest entries and their summaries
+  ds.setDataLimiting(true);
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_datalimitpoints(700);
+  helper.updatePlatformPrefs(prefs, platformId);
+  for (int k = 2000; k < 3000; ++k)
+  {
+    row.clear();
+    row.setTime(k * 0.1);
+    row.setValue(values->columnId(), (k * 53) % 777);
+    table->addRow(row);
+    if (k % 250 == 0)
+      rv += checkAggregates(*values);
+  }
+  rv += SDK_ASSERT(values->size() < 1000);
+  rv += checkAggregates(*values);
+  return rv;
+}
+
+/** Returns 0 if the decimated entries are a time ordered subset of the column that keeps each bucket's extremes */
+int checkDecimation(const simData::TableColumn& column, double beginTime, double endTime, size_t maxPoints)
+{
+  int rv = 0;
+  std::vector<double> times;
+  std::vector<double> values;
+  rv += SDK_ASSERT(column.decimate(beginTime, endTime, maxPoints, times, values).isSuccess());
+  rv += SDK_ASSERT(times.size() == values.size());
+  rv += SDK_ASSERT(times.size() <= maxPoints);
+  rv += SDK_ASSERT(std::is_sorted(times.begin(), times.end()));
+  rv += SDK_ASSERT(std::adjacent_find(times.begin(), times.end()) == times.end());
+
+  std::vector<double> allTimes;
+  std::vector<double> allValues;
+  column.values(beginTime, endTime, allTimes, allValues);
+  if (allTimes.size() <= maxPoints)
+  {
+    rv += SDK_ASSERT(times == allTimes && values == allValues);
+    return rv;
+  }
+  for (size_t k = 0; k < times.size(); ++k)
+  {
+    const size_t index = std::lower_bound(allTimes.begin(), allTimes.end(), times[k]) - allTimes.begin();
+    rv += SDK_ASSERT(index < allTimes.size() && allTimes[index] == times[k] && allValues[index] == values[k]);
+  }
+  // Extremes of the whole range are always among the representative entries
+  const simData::TableColumnAggregate expected = bruteForceAggregate(column, beginTime, endTime);
+  rv += SDK_ASSERT(std::find(times.begin(), times.end(), expected.minTime) != times.end());
+  rv += SDK_ASSERT(std::find(times.begin(), times.end(), expected.maxTime) != times.end());
+  rv += SDK_ASSERT(times.front() == expected.firstTime && times.back() == expected.lastTime);
+  return rv;
+}
+
+int decimateTest()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platformId = helper.addPlatform();
+  simData::DataTableManager& mgr = ds.dataTableManager();
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(mgr.addDataTable(platformId, "Test Table", &table).isSuccess());
+  simData::TableColumn* values = nullptr;
+  simData::TableColumn* strings = nullptr;
+  rv += SDK_ASSERT(table->addColumn("Values", simData::VT_DOUBLE, 0, &values).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("Strings", simData::VT_STRING, 0, &strings).isSuccess());
+
+  std::vector<double> times;
+  std::vector<double> decimated;
+  rv += SDK_ASSERT(values->decimate(0.0, 10.0, 100, times, decimated).isSuccess());
+  rv += SDK_ASSERT(times.empty() && decimated.empty());
+  rv += SDK_ASSERT(values->decimate(0.0, 10.0, 3, times, decimated).isError());
+  rv += SDK_ASSERT(strings->decimate(0.0, 10.0, 100, times, decimated).isError());
+
+  // Enough live rows for several levels of summaries
+  for (int k = 0; k < 40000; ++k)
+  {
+    simData::TableRow row;
+    row.setTime(k * 0.01);
+    row.setValue(values->columnId(), std::sin(k * 0.001) * 100.0 + (k * 7919) % 13);
+    table->addRow(row);
+    if (k % 10000 == 9999)
+      rv += checkDecimation(*values, 0.0, 400.0, 400);
+  }
+  rv += checkDecimation(*values, 0.0, 400.0, 4000);
+  rv += checkDecimation(*values, 12.345, 267.89, 1000);
+  rv += checkDecimation(*values, 100.0, 100.5, 400);
+  rv += checkDecimation(*values, 100.0, 100.5, 4);
+
+  // Changes in the middle and data limiting at the front
+  simData::TableRow row;
+  row.setTime(123.455);
+  row.setValue(values->columnId(), 1000.0);
+  table->addRow(row);
+  rv += checkDecimation(*values, 0.0, 400.0, 400);
+  ds.setDataLimiting(true);
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_datalimitpoints(15000);
+  helper.updatePlatformPrefs(prefs, platformId);
+  for (int k = 40000; k < 50000; ++k)
+  {
+    row.clear();
+    row.setTime(k * 0.01);
+    row.setValue(values->columnId(), -(k % 1000) * 0.5);
+    table->addRow(row);
+  }
+  rv += SDK_ASSERT(values->size() < 40000);
+  rv += checkDecimation(*values, 0.0, 500.0, 400);
+  rv += checkDecimation(*values, 450.0, 500.0, 800);
+  return rv;
+}
+
 }
 
 int MemoryDataTableTest(int argc, char* argv[])
@@ -2331,5 +2633,8 @@ int MemoryDataTableTest(int argc, char* argv[])
   rv += testPartialFlush();
   rv += getTimeRangeTest();
   rv += maxSubTableRowTest();
+  rv += readColumnsTest();
+  rv += aggregateTest();
+  rv += decimateTest();
   return rv;
 }
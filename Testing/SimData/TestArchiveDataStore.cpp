@@ -0,0 +1,363 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "simCore/Common/ScopeGuard.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/System/File.h"
+#include "simData/ArchiveDataStore.h"
+#include "simData/CategoryData/CategoryData.h"
+#include "simData/DataTable.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MappedDataSlice.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/// Counts the messages of a slice
+template <typename T>
+class CountMessages : public simData::VisitableDataSlice<T>::Visitor
+{
+public:
+  virtual void operator()(const T* message) override
+  {
+    ++count;
+  }
+
+  int count = 0;
+};
+
+/// Counts the category data of a slice
+class CountCategoryData : public simData::CategoryDataSlice::Visitor
+{
+public:
+  virtual void operator()(const simData::CategoryData* message) override
+  {
+    ++count;
+  }
+
+  int count = 0;
+};
+
+/// Counts the rows of a table
+class CountRows : public simData::DataTable::RowVisitor
+{
+public:
+  virtual VisitReturn visit(const simData::TableRow& row) override
+  {
+    ++count;
+    row.value(stringColumn, lastString);
+    return VISIT_CONTINUE;
+  }
+
+  simData::TableColumnId stringColumn = 0;
+  std::string lastString;
+  int count = 0;
+};
+
+/// Fills a data store with platforms, a beam, a gate and their data
+void fillDataStore(simData::MemoryDataStore& ds, uint64_t& platId, uint64_t& beamId, uint64_t& gateId)
+{
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  // Leave a hole in the IDs, so that the archive has to translate them
+  const uint64_t removed = helper.addPlatform(99);
+  platId = helper.addPlatform(100);
+  ds.removeEntity(removed);
+  const uint64_t targetId = helper.addPlatform(101);
+  beamId = helper.addBeam(platId, 200);
+  gateId = helper.addGate(beamId, 300);
+
+  for (int ii = 0; ii < 300; ++ii)
+  {
+    helper.addPlatformUpdate(ii, platId);
+    helper.addBeamUpdate(ii * 2.0, beamId);
+  }
+  helper.addPlatformUpdate(0.0, targetId);
+  helper.addGateUpdate(10.0, gateId);
+  helper.addGateUpdate(20.0, gateId);
+
+  simData::DataStore::Transaction t;
+  simData::BeamPrefs* beamPrefs = ds.mutable_beamPrefs(beamId, &t);
+  beamPrefs->mutable_commonprefs()->set_name("Beam Name");
+  // Only meaningful for target beams, but translated regardless
+  beamPrefs->set_targetid(targetId);
+  t.commit();
+
+  simData::PlatformCommand command;
+  command.set_time(5.0);
+  command.mutable_updateprefs()->mutable_commonprefs()->set_color(0xff0000ff);
+  helper.addPlatformCommand(command, platId);
+
+  helper.addCategoryData(platId, "Key", "Value1", 1.0);
+  helper.addCategoryData(platId, "Key", "Value2", 2.0);
+  helper.addGenericData(platId, "Generic", "Value", 3.0);
+
+  simData::DataTable* table = nullptr;
+  ds.dataTableManager().addDataTable(platId, "Table", &table);
+  simData::TableColumn* doubleColumn = nullptr;
+  simData::TableColumn* stringColumn = nullptr;
+  table->addColumn("Double", simData::VT_DOUBLE, 0, &doubleColumn);
+  table->addColumn("String", simData::VT_STRING, 0, &stringColumn);
+  for (int ii = 0; ii < 10; ++ii)
+  {
+    simData::TableRow row;
+    row.setTime(ii);
+    row.setValue(doubleColumn->columnId(), ii * 0.5);
+    row.setValue(stringColumn->columnId(), "Row " + std::to_string(ii));
+    table->addRow(row);
+  }
+}
+
+int testMappedSlice()
+{
+  int rv = 0;
+
+  // Lay out 300 updates the way the archive does; the file only has to outlive the slice
+  const size_t numUpdates = 300;
+  const size_t numBlocks = (numUpdates + simData::ColumnChunkSize - 1) / simData::ColumnChunkSize;
+  std::vector<double> storage((numUpdates * sizeof(double) + numBlocks * simData::MappedChunkLayout<simData::PlatformUpdate>::Bytes) / sizeof(double));
+  double* times = storage.data();
+  uint8_t* chunks = reinterpret_cast<uint8_t*>(times + numUpdates);
+  for (size_t ii = 0; ii < numUpdates; ++ii)
+  {
+    simData::PlatformUpdate update;
+    update.set_time(ii);
+    update.set_x(ii * 10.0);
+    update.set_y(0.0);
+    update.set_z(0.0);
+    times[ii] = update.time();
+    uint8_t* block = chunks + (ii / simData::ColumnChunkSize) * simData::MappedChunkLayout<simData::PlatformUpdate>::Bytes;
+    simData::ColumnLayout<simData::PlatformUpdate>::store(update, reinterpret_cast<double*>(block),
+      reinterpret_cast<float*>(block + simData::MappedChunkLayout<simData::PlatformUpdate>::FloatsOffset),
+      block[simData::MappedChunkLayout<simData::PlatformUpdate>::FlagsOffset + ii % simData::ColumnChunkSize], ii % simData::ColumnChunkSize);
+  }
+
+  simData::MappedDataSlice<simData::PlatformUpdate> slice(nullptr, times, chunks, numUpdates);
+  rv += SDK_ASSERT(slice.numItems() == 300);
+  rv += SDK_ASSERT(slice.firstTime() == 0.0);
+  rv += SDK_ASSERT(slice.lastTime() == 299.0);
+
+  slice.update(150.5);
+  rv += SDK_ASSERT(slice.current() != nullptr && slice.current()->time() == 150.0 && slice.current()->x() == 1500.0);
+  slice.update(-1.0);
+  rv += SDK_ASSERT(slice.current() == nullptr);
+
+  simData::LinearInterpolator interpolator;
+  slice.update(200.5, &interpolator);
+  rv += SDK_ASSERT(slice.isInterpolated());
+  rv += SDK_ASSERT(slice.current() != nullptr && slice.current()->time() == 200.5);
+
+  // Iteration across blocks
+  simData::PlatformUpdateSlice::Iterator iter = slice.lower_bound(126.5);
+  for (int ii = 127; ii < 131; ++ii)
+  {
+    const simData::PlatformUpdate* update = iter.next();
+    rv += SDK_ASSERT(update != nullptr && update->time() == ii && update->x() == ii * 10.0);
+  }
+  rv += SDK_ASSERT(slice.upper_bound(299.0).next() == nullptr);
+
+  // Inserts are discarded
+  simData::PlatformUpdate* extra = new simData::PlatformUpdate();
+  extra->set_time(1000.0);
+  slice.insert(extra);
+  rv += SDK_ASSERT(slice.numItems() == 300);
+
+  // Data limiting and flushing hide updates from the ends
+  slice.limitByPoints(200);
+  rv += SDK_ASSERT(slice.numItems() == 200);
+  rv += SDK_ASSERT(slice.firstTime() == 100.0);
+  slice.flush(250.0, 1000.0);
+  rv += SDK_ASSERT(slice.lastTime() == 249.0);
+  slice.flush(150.0, 160.0);
+  rv += SDK_ASSERT(slice.numItems() == 150);
+  slice.update(200.0);
+  rv += SDK_ASSERT(slice.current() != nullptr && slice.current()->x() == 2000.0);
+  slice.flush();
+  rv += SDK_ASSERT(slice.numItems() == 0);
+
+  return rv;
+}
+
+int testArchive(const std::string& filename)
+{
+  int rv = 0;
+
+  uint64_t platId = 0;
+  uint64_t beamId = 0;
+  uint64_t gateId = 0;
+  {
+    simData::MemoryDataStore source;
+    fillDataStore(source, platId, beamId, gateId);
+    rv += SDK_ASSERT(simData::ArchiveDataStore::write(source, filename) == 0);
+  }
+
+  simData::ArchiveDataStore ds;
+  rv += SDK_ASSERT(ds.open(filename) == 0);
+
+  simData::DataStore::IdList ids;
+  ds.idListByOriginalId(&ids, 100);
+  rv += SDK_ASSERT(ids.size() == 1);
+  if (ids.size() != 1)
+    return rv;
+  const uint64_t newPlatId = ids.front();
+  ids.clear();
+  ds.idListByOriginalId(&ids, 101);
+  rv += SDK_ASSERT(ids.size() == 1);
+  const uint64_t newTargetId = ids.empty() ? 0 : ids.front();
+  ids.clear();
+  ds.idListByOriginalId(&ids, 200);
+  rv += SDK_ASSERT(ids.size() == 1);
+  const uint64_t newBeamId = ids.empty() ? 0 : ids.front();
+  ids.clear();
+  ds.idListByOriginalId(&ids, 300);
+  rv += SDK_ASSERT(ids.size() == 1);
+  const uint64_t newGateId = ids.empty() ? 0 : ids.front();
+  rv += SDK_ASSERT(ds.isArchived(newPlatId));
+  rv += SDK_ASSERT(ds.isArchived(newGateId));
+
+  // Host and target IDs are translated
+  {
+    simData::DataStore::Transaction t;
+    const simData::BeamProperties* beamProps = ds.beamProperties(newBeamId, &t);
+    rv += SDK_ASSERT(beamProps != nullptr && beamProps->hostid() == newPlatId);
+    const simData::BeamPrefs* beamPrefs = ds.beamPrefs(newBeamId, &t);
+    rv += SDK_ASSERT(beamPrefs != nullptr && beamPrefs->targetid() == newTargetId);
+    rv += SDK_ASSERT(beamPrefs != nullptr && beamPrefs->commonprefs().name() == "Beam Name");
+    const simData::GateProperties* gateProps = ds.gateProperties(newGateId, &t);
+    rv += SDK_ASSERT(gateProps != nullptr && gateProps->hostid() == newBeamId);
+  }
+
+  // Updates come from the archive
+  const simData::PlatformUpdateSlice* platSlice = ds.platformUpdateSlice(newPlatId);
+  rv += SDK_ASSERT(dynamic_cast<const simData::MappedDataSlice<simData::PlatformUpdate>*>(platSlice) != nullptr);
+  rv += SDK_ASSERT(platSlice->numItems() == 300);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(newBeamId)->numItems() == 300);
+  rv += SDK_ASSERT(ds.gateUpdateSlice(newGateId)->numItems() == 2);
+  ds.update(150.0);
+  rv += SDK_ASSERT(platSlice->current() != nullptr && platSlice->current()->x() == 150.0 && platSlice->current()->y() == 151.0);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(newBeamId)->current() != nullptr && ds.beamUpdateSlice(newBeamId)->current()->azimuth() == 150.0);
+  rv += SDK_ASSERT(ds.gateUpdateSlice(newGateId)->current() != nullptr && ds.gateUpdateSlice(newGateId)->current()->width() == 22.0);
+
+  // Commands, category data, generic data and tables are loaded
+  CountMessages<simData::PlatformCommand> commands;
+  ds.platformCommandSlice(newPlatId)->visit(&commands);
+  rv += SDK_ASSERT(commands.count == 1);
+  {
+    simData::DataStore::Transaction t;
+    const simData::PlatformPrefs* prefs = ds.platformPrefs(newPlatId, &t);
+    rv += SDK_ASSERT(prefs != nullptr && prefs->commonprefs().color() == 0xff0000ff);
+  }
+  CountCategoryData categories;
+  ds.categoryDataSlice(newPlatId)->visit(&categories);
+  rv += SDK_ASSERT(categories.count == 2);
+  rv += SDK_ASSERT(ds.genericDataSlice(newPlatId)->numItems() == 1);
+  simData::DataTable* table = ds.dataTableManager().findTable(newPlatId, "Table");
+  rv += SDK_ASSERT(table != nullptr);
+  if (table != nullptr)
+  {
+    rv += SDK_ASSERT(table->columnCount() == 2);
+    CountRows rows;
+    rows.stringColumn = table->column("String")->columnId();
+    table->accept(0.0, 100.0, rows);
+    rv += SDK_ASSERT(rows.count == 10);
+    rv += SDK_ASSERT(rows.lastString == "Row 9");
+    double value = 0.0;
+    rv += SDK_ASSERT(table->column("Double")->interpolate(value, 4.0, nullptr).isSuccess() && value == 2.0);
+  }
+
+  // Archived entities are read-only
+  simData::DataStore::Transaction t;
+  rv += SDK_ASSERT(ds.addPlatformUpdate(newPlatId, &t) == nullptr);
+  rv += SDK_ASSERT(ds.addPlatformUpdates(newPlatId, std::vector<simData::PlatformUpdate>(1)) != 0);
+
+  // New entities behave normally
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t liveId = helper.addPlatform();
+  rv += SDK_ASSERT(!ds.isArchived(liveId));
+  helper.addPlatformUpdate(1.0, liveId);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(liveId)->numItems() == 1);
+
+  return rv;
+}
+
+int testInvalidArchives(const std::string& filename)
+{
+  int rv = 0;
+
+  simData::ArchiveDataStore ds;
+  rv += SDK_ASSERT(ds.open(filename + ".missing") != 0);
+
+  // Truncated archive
+  std::string contents;
+  {
+    std::ifstream in(filename, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  rv += SDK_ASSERT(contents.size() > 100);
+  const std::string badName = filename + ".bad";
+  const simCore::ScopeGuard removeBad([badName]() { std::remove(badName.c_str()); });
+  {
+    std::ofstream out(badName, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 10);
+  }
+  rv += SDK_ASSERT(ds.open(badName) != 0);
+  simData::DataStore::IdList ids;
+  ds.idList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+
+  // Wrong magic
+  contents[0] = 'X';
+  {
+    std::ofstream out(badName, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+  }
+  rv += SDK_ASSERT(ds.open(badName) != 0);
+
+  // Reopening a good archive works after a failure
+  rv += SDK_ASSERT(ds.open(filename) == 0);
+  ds.idList(&ids);
+  rv += SDK_ASSERT(ids.size() == 4);
+
+  return rv;
+}
+
+}
+
+int TestArchiveDataStore(int argc, char* argv[])
+{
+  int rv = 0;
+
+  std::error_code unused;
+  const std::string filename = simCore::pathJoin({ std::filesystem::temp_directory_path(unused).string(), "TestArchiveDataStore.sdkarchive" });
+  const simCore::ScopeGuard removeArchive([filename]() { std::remove(filename.c_str()); });
+
+  rv += testMappedSlice();
+  rv += testArchive(filename);
+  rv += testInvalidArchives(filename);
+
+  return rv;
+}
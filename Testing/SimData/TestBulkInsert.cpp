@@ -0,0 +1,228 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <map>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/// Counts the new update notifications per entity
+class CountNewUpdates : public simData::DataStore::DefaultNewUpdatesListener
+{
+public:
+  virtual void onEntityUpdate(simData::DataStore* source, simData::ObjectId id, double dataTime) override
+  {
+    ++counts[id];
+    lastTimes[id] = dataTime;
+  }
+
+  std::map<simData::ObjectId, int> counts;
+  std::map<simData::ObjectId, double> lastTimes;
+};
+
+simData::PlatformUpdate makePlatformUpdate(double time, double x)
+{
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  update.set_x(x);
+  update.set_y(0.0);
+  update.set_z(0.0);
+  return update;
+}
+
+/// Returns the times in the slice, in order
+std::vector<double> sliceTimes(const simData::PlatformUpdateSlice* slice)
+{
+  std::vector<double> times;
+  simData::PlatformUpdateSlice::Iterator iter = slice->lower_bound(-1.0);
+  while (iter.hasNext())
+    times.push_back(iter.next()->time());
+  return times;
+}
+
+int testPlatforms(simData::MemoryDataStore::UpdateStorage storage)
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(storage);
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  auto listener = std::make_shared<CountNewUpdates>();
+  ds.addNewUpdatesListener(listener);
+
+  // Unsorted input with a duplicate time; the later duplicate wins
+  std::vector<simData::PlatformUpdate> updates;
+  updates.push_back(makePlatformUpdate(3.0, 3.0));
+  updates.push_back(makePlatformUpdate(1.0, 1.0));
+  updates.push_back(makePlatformUpdate(2.0, 2.0));
+  updates.push_back(makePlatformUpdate(1.0, 10.0));
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId, updates) == 0);
+
+  const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(platId);
+  rv += SDK_ASSERT(slice->numItems() == 3);
+  rv += SDK_ASSERT(sliceTimes(slice) == std::vector<double>({ 1.0, 2.0, 3.0 }));
+  rv += SDK_ASSERT(slice->lower_bound(1.0).next()->x() == 10.0);
+  rv += SDK_ASSERT(slice->firstTime() == 1.0);
+  rv += SDK_ASSERT(slice->lastTime() == 3.0);
+
+  // One notification for the whole batch, at the latest time
+  rv += SDK_ASSERT(listener->counts[platId] == 1);
+  rv += SDK_ASSERT(listener->lastTimes[platId] == 3.0);
+
+  // Appending newer data
+  updates.clear();
+  updates.push_back(makePlatformUpdate(5.0, 5.0));
+  updates.push_back(makePlatformUpdate(4.0, 4.0));
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId, updates) == 0);
+  rv += SDK_ASSERT(sliceTimes(slice) == std::vector<double>({ 1.0, 2.0, 3.0, 4.0, 5.0 }));
+  rv += SDK_ASSERT(listener->counts[platId] == 2);
+  rv += SDK_ASSERT(listener->lastTimes[platId] == 5.0);
+
+  // Merging into existing data replaces the matching times
+  ds.update(2.0);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->x() == 2.0);
+  updates.clear();
+  updates.push_back(makePlatformUpdate(2.0, 20.0));
+  updates.push_back(makePlatformUpdate(0.5, 0.5));
+  updates.push_back(makePlatformUpdate(3.5, 3.5));
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId, updates) == 0);
+  rv += SDK_ASSERT(sliceTimes(slice) == std::vector<double>({ 0.5, 1.0, 2.0, 3.0, 3.5, 4.0, 5.0 }));
+  rv += SDK_ASSERT(slice->lower_bound(2.0).next()->x() == 20.0);
+  rv += SDK_ASSERT(slice->firstTime() == 0.5);
+  rv += SDK_ASSERT(listener->counts[platId] == 3);
+  rv += SDK_ASSERT(listener->lastTimes[platId] == 3.5);
+
+  // The merged data is visible on the next update
+  ds.update(2.0);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->x() == 20.0);
+  ds.update(3.7);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->time() == 3.5);
+
+  // Empty input does nothing
+  updates.clear();
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId, updates) == 0);
+  rv += SDK_ASSERT(slice->numItems() == 7);
+  rv += SDK_ASSERT(listener->counts[platId] == 3);
+
+  // Unknown entities and the wrong entity type are errors
+  updates.push_back(makePlatformUpdate(6.0, 6.0));
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId + 1000, updates) != 0);
+  const uint64_t beamId = helper.addBeam(platId);
+  rv += SDK_ASSERT(ds.addPlatformUpdates(beamId, updates) != 0);
+  rv += SDK_ASSERT(ds.addBeamUpdates(platId, std::vector<simData::BeamUpdate>(1)) != 0);
+
+  ds.removeNewUpdatesListener(listener);
+  return rv;
+}
+
+int testDataLimiting()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  ds.setDataLimiting(true);
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(platId, &t);
+  prefs->mutable_commonprefs()->set_datalimitpoints(5);
+  t.commit();
+
+  std::vector<simData::PlatformUpdate> updates;
+  for (int ii = 0; ii < 20; ++ii)
+    updates.push_back(makePlatformUpdate(ii, ii));
+  rv += SDK_ASSERT(ds.addPlatformUpdates(platId, updates) == 0);
+
+  // Limiting is applied once after the batch, keeping the newest points
+  const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(platId);
+  rv += SDK_ASSERT(slice->numItems() == 5);
+  rv += SDK_ASSERT(slice->firstTime() == 15.0);
+  rv += SDK_ASSERT(slice->lastTime() == 19.0);
+
+  return rv;
+}
+
+int testOtherTypes()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+  const uint64_t laserId = helper.addLaser(platId);
+  const uint64_t projectorId = helper.addProjector(platId);
+
+  std::vector<simData::BeamUpdate> beams(3);
+  std::vector<simData::GateUpdate> gates(3);
+  std::vector<simData::LaserUpdate> lasers(3);
+  std::vector<simData::ProjectorUpdate> projectors(3);
+  for (int ii = 0; ii < 3; ++ii)
+  {
+    // Reverse order
+    const double time = 2.0 - ii;
+    beams[ii].set_time(time);
+    beams[ii].set_range(time);
+    gates[ii].set_time(time);
+    gates[ii].set_minrange(time);
+    gates[ii].set_maxrange(time + 1.0);
+    lasers[ii].set_time(time);
+    projectors[ii].set_time(time);
+    projectors[ii].set_fov(time + 1.0);
+  }
+  rv += SDK_ASSERT(ds.addBeamUpdates(beamId, beams) == 0);
+  rv += SDK_ASSERT(ds.addGateUpdates(gateId, gates) == 0);
+  rv += SDK_ASSERT(ds.addLaserUpdates(laserId, lasers) == 0);
+  rv += SDK_ASSERT(ds.addProjectorUpdates(projectorId, projectors) == 0);
+
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->numItems() == 3);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->firstTime() == 0.0);
+  rv += SDK_ASSERT(ds.gateUpdateSlice(gateId)->numItems() == 3);
+  rv += SDK_ASSERT(ds.laserUpdateSlice(laserId)->numItems() == 3);
+  rv += SDK_ASSERT(ds.projectorUpdateSlice(projectorId)->numItems() == 3);
+
+  ds.update(1.0);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->current() != nullptr && ds.beamUpdateSlice(beamId)->current()->range() == 1.0);
+  rv += SDK_ASSERT(ds.projectorUpdateSlice(projectorId)->current() != nullptr && ds.projectorUpdateSlice(projectorId)->current()->fov() == 2.0);
+
+  return rv;
+}
+
+}
+
+int TestBulkInsert(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testPlatforms(simData::MemoryDataStore::UpdateStorage::DEQUE);
+  rv += testPlatforms(simData::MemoryDataStore::UpdateStorage::COLUMNAR);
+  rv += testDataLimiting();
+  rv += testOtherTypes();
+
+  return rv;
+}
@@ -0,0 +1,147 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CategoryFilterResults.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/DataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Records the most recent notification */
+class RecordChanges : public simData::CategoryFilterResults::Listener
+{
+public:
+  virtual void onMatchesChanged(const simData::CategoryFilterResults& results, const std::vector<simData::ObjectId>& added, const std::vector<simData::ObjectId>& removed) override
+  {
+    ++notifications;
+    this->added = added;
+    this->removed = removed;
+  }
+
+  /** Returns true if the last notification matches, then resets */
+  bool check(int expectedNotifications, const std::vector<simData::ObjectId>& expectedAdded, const std::vector<simData::ObjectId>& expectedRemoved)
+  {
+    const bool rv = (notifications == expectedNotifications && added == expectedAdded && removed == expectedRemoved);
+    notifications = 0;
+    added.clear();
+    removed.clear();
+    return rv;
+  }
+
+  int notifications = 0;
+  std::vector<simData::ObjectId> added;
+  std::vector<simData::ObjectId> removed;
+};
+
+int testResults()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  simData::DataStore* ds = helper.dataStore();
+
+  const uint64_t p1 = helper.addPlatform();
+  const uint64_t p2 = helper.addPlatform();
+  const uint64_t p3 = helper.addPlatform();
+  helper.addCategoryData(p1, "Color", "Red", 0.0);
+  helper.addCategoryData(p2, "Color", "Blue", 0.0);
+  ds->update(0.0);
+
+  // Empty filter matches every entity, and existing entities are not reported
+  simData::CategoryFilterResults results(*ds);
+  auto changes = std::make_shared<RecordChanges>();
+  results.addListener(changes);
+  rv += SDK_ASSERT(results.matchingIds().size() == 3);
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+
+  // Changing the filter reports only the entities that stop matching
+  const simData::CategoryNameManager& names = ds->categoryNameManager();
+  simData::CategoryFilter filter(ds);
+  filter.setValue(names.nameToInt("Color"), names.valueToInt("Red"), true);
+  results.setFilter(filter);
+  rv += SDK_ASSERT(changes->check(1, {}, { p2, p3 }));
+  rv += SDK_ASSERT(results.matches(p1));
+  rv += SDK_ASSERT(!results.matches(p2));
+
+  // Category changes are reported at the end of the update that makes them current
+  helper.addCategoryData(p2, "Color", "Red", 5.0);
+  ds->update(1.0);
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+  ds->update(5.0);
+  rv += SDK_ASSERT(changes->check(1, { p2 }, {}));
+
+  helper.addCategoryData(p1, "Color", "Blue", 10.0);
+  helper.addCategoryData(p3, "Color", "Red", 10.0);
+  ds->update(10.0);
+  rv += SDK_ASSERT(changes->check(1, { p3 }, { p1 }));
+  rv += SDK_ASSERT(results.matchingIds() == std::set<simData::ObjectId>({ p2, p3 }));
+
+  // Category data that is flushed and replaced before the next update does not change the match
+  rv += SDK_ASSERT(ds->flush(p3, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_CATEGORY_DATA) == 0);
+  helper.addCategoryData(p3, "Color", "Red", 0.0);
+  ds->update(10.0);
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+  rv += SDK_ASSERT(results.matches(p3));
+  helper.addCategoryData(p1, "Color", "Red", 20.0);
+  ds->update(20.0);
+  rv += SDK_ASSERT(changes->check(1, { p1 }, {}));
+  results.publishChanges();
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+
+  // New entities without category data do not match
+  const uint64_t p4 = helper.addPlatform();
+  rv += SDK_ASSERT(!results.matches(p4));
+  ds->update(20.0);
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+
+  // Flushed category data is applied on the next update
+  rv += SDK_ASSERT(ds->flush(p3, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_CATEGORY_DATA) == 0);
+  rv += SDK_ASSERT(results.matches(p3));
+  ds->update(20.0);
+  rv += SDK_ASSERT(changes->check(1, {}, { p3 }));
+
+  // Removed entities are reported immediately
+  ds->removeEntity(p2);
+  rv += SDK_ASSERT(changes->check(1, {}, { p2 }));
+  rv += SDK_ASSERT(results.matchingIds() == std::set<simData::ObjectId>({ p1 }));
+
+  // Removed listeners are not told about later changes
+  results.removeListener(changes);
+  ds->clear();
+  rv += SDK_ASSERT(changes->check(0, {}, {}));
+  rv += SDK_ASSERT(results.matchingIds().empty());
+  return rv;
+}
+
+}
+
+int TestCategoryFilterResults(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testResults() == 0);
+  return rv;
+}
@@ -0,0 +1,302 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/ColumnarDataSlice.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+simData::PlatformUpdate* newPlatformUpdate(double time, double offset = 0.0)
+{
+  simData::PlatformUpdate* rv = new simData::PlatformUpdate();
+  rv->set_time(time);
+  rv->set_x(6378137.0 + time + offset);
+  rv->set_y(time * 2.0);
+  rv->set_z(time * 3.0);
+  rv->set_psi(0.1);
+  rv->set_theta(0.2);
+  rv->set_phi(0.3);
+  // leave velocity unset every other point to exercise the sentinel values
+  if ((static_cast<int>(time) % 2) == 0)
+  {
+    rv->set_vx(10.0);
+    rv->set_vy(20.0);
+    rv->set_vz(30.0);
+  }
+  return rv;
+}
+
+bool samePlatform(const simData::PlatformUpdate* lhs, const simData::PlatformUpdate* rhs)
+{
+  if (lhs == nullptr || rhs == nullptr)
+    return lhs == rhs;
+  return lhs->time() == rhs->time() && lhs->x() == rhs->x() && lhs->y() == rhs->y() && lhs->z() == rhs->z() &&
+    lhs->psi() == rhs->psi() && lhs->theta() == rhs->theta() && lhs->phi() == rhs->phi() &&
+    lhs->has_velocity() == rhs->has_velocity() && lhs->vx() == rhs->vx() && lhs->vy() == rhs->vy() && lhs->vz() == rhs->vz();
+}
+
+/** Inserts the same data into both slices; out of order and duplicate times included */
+void fillSlices(simData::MemoryDataSlice<simData::PlatformUpdate>& deque, simData::MemoryDataSlice<simData::PlatformUpdate>& columns)
+{
+  // Enough points to cross several chunks
+  for (int ii = 0; ii < 400; ii += 2)
+  {
+    deque.insert(newPlatformUpdate(ii));
+    columns.insert(newPlatformUpdate(ii));
+  }
+  // Fill in the odd times in reverse order
+  for (int ii = 399; ii > 0; ii -= 2)
+  {
+    deque.insert(newPlatformUpdate(ii));
+    columns.insert(newPlatformUpdate(ii));
+  }
+  // Replace a few points
+  for (int ii = 0; ii < 400; ii += 50)
+  {
+    deque.insert(newPlatformUpdate(ii, 0.5));
+    columns.insert(newPlatformUpdate(ii, 0.5));
+  }
+}
+
+int compareSlices(const simData::MemoryDataSlice<simData::PlatformUpdate>& deque, const simData::MemoryDataSlice<simData::PlatformUpdate>& columns)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(deque.numItems() == columns.numItems());
+  rv += SDK_ASSERT(deque.firstTime() == columns.firstTime());
+  rv += SDK_ASSERT(deque.lastTime() == columns.lastTime());
+
+  // Walk both slices from the front
+  auto dequeIt = deque.lower_bound(-1.0);
+  auto columnIt = columns.lower_bound(-1.0);
+  while (dequeIt.hasNext())
+  {
+    rv += SDK_ASSERT(columnIt.hasNext());
+    if (!columnIt.hasNext())
+      break;
+    rv += SDK_ASSERT(samePlatform(dequeIt.next(), columnIt.next()));
+  }
+  rv += SDK_ASSERT(!columnIt.hasNext());
+
+  // Spot check searches on and between points
+  for (double time = -1.0; time < 410.0; time += 3.25)
+  {
+    auto dequeLower = deque.lower_bound(time);
+    auto columnLower = columns.lower_bound(time);
+    rv += SDK_ASSERT(samePlatform(dequeLower.peekNext(), columnLower.peekNext()));
+    rv += SDK_ASSERT(samePlatform(dequeLower.peekPrevious(), columnLower.peekPrevious()));
+    auto dequeUpper = deque.upper_bound(time);
+    auto columnUpper = columns.upper_bound(time);
+    rv += SDK_ASSERT(samePlatform(dequeUpper.peekNext(), columnUpper.peekNext()));
+    rv += SDK_ASSERT(samePlatform(dequeUpper.peekPrevious(), columnUpper.peekPrevious()));
+    rv += SDK_ASSERT(deque.deltaTime(time) == columns.deltaTime(time));
+  }
+  return rv;
+}
+
+int testParity()
+{
+  int rv = 0;
+
+  auto pool = std::make_shared<simData::ColumnChunkPool<simData::PlatformUpdate> >();
+  simData::MemoryDataSlice<simData::PlatformUpdate> deque;
+  simData::ColumnarDataSlice<simData::PlatformUpdate> columns(pool);
+  fillSlices(deque, columns);
+  rv += SDK_ASSERT(columns.numItems() == 400);
+  rv += compareSlices(deque, columns);
+
+  // Sequential and random time updates without interpolation
+  for (double time = -5.0; time < 420.0; time += 0.7)
+  {
+    deque.update(time);
+    columns.update(time);
+    rv += SDK_ASSERT(samePlatform(deque.current(), columns.current()));
+    rv += SDK_ASSERT(deque.hasChanged() == columns.hasChanged());
+  }
+  for (double time = 420.0; time > -5.0; time -= 13.3)
+  {
+    std::optional<double> dequeStart;
+    std::optional<double> dequeEnd;
+    std::optional<double> columnStart;
+    std::optional<double> columnEnd;
+    deque.update(time, dequeStart, dequeEnd);
+    columns.update(time, columnStart, columnEnd);
+    rv += SDK_ASSERT(samePlatform(deque.current(), columns.current()));
+    rv += SDK_ASSERT(dequeStart == columnStart);
+    rv += SDK_ASSERT(dequeEnd == columnEnd);
+  }
+
+  // Interpolated updates, through the base class like MemoryDataStore does
+  simData::LinearInterpolator interpolator;
+  simData::MemoryDataSlice<simData::PlatformUpdate>* base = &columns;
+  for (double time = -5.0; time < 420.0; time += 0.37)
+  {
+    deque.update(time, &interpolator);
+    base->update(time, &interpolator);
+    rv += SDK_ASSERT(samePlatform(deque.current(), columns.current()));
+    rv += SDK_ASSERT(deque.isInterpolated() == columns.isInterpolated());
+    rv += SDK_ASSERT(samePlatform(deque.interpolationBounds().first, columns.interpolationBounds().first));
+    rv += SDK_ASSERT(samePlatform(deque.interpolationBounds().second, columns.interpolationBounds().second));
+  }
+
+  // Data limiting and flushing
+  deque.limitByPoints(300);
+  columns.limitByPoints(300);
+  rv += compareSlices(deque, columns);
+  deque.limitByTime(150.0);
+  columns.limitByTime(150.0);
+  rv += compareSlices(deque, columns);
+  deque.flush(300.0, 310.5);
+  columns.flush(300.0, 310.5);
+  rv += compareSlices(deque, columns);
+  deque.flush(250.0, 260.0);
+  columns.flush(250.0, 260.0);
+  rv += compareSlices(deque, columns);
+
+  // Visitor sees every point in order
+  class CountVisitor : public simData::PlatformUpdateSlice::Visitor
+  {
+  public:
+    virtual void operator()(const simData::PlatformUpdate* update) override
+    {
+      if (update->time() > lastTime)
+        ++count;
+      lastTime = update->time();
+    }
+    size_t count = 0;
+    double lastTime = -1.0;
+  };
+  CountVisitor visitor;
+  columns.visit(&visitor);
+  rv += SDK_ASSERT(visitor.count == columns.numItems());
+
+  // Full flush returns every chunk to the pool
+  columns.flush(false);
+  rv += SDK_ASSERT(columns.numItems() == 0);
+  rv += SDK_ASSERT(pool->numInUse() == 0);
+  rv += SDK_ASSERT(pool->numFree() > 0);
+
+  return rv;
+}
+
+int testProtobufFields()
+{
+  int rv = 0;
+
+  auto beamPool = std::make_shared<simData::ColumnChunkPool<simData::BeamUpdate> >();
+  simData::ColumnarDataSlice<simData::BeamUpdate> beams(beamPool);
+  simData::BeamUpdate* beam = new simData::BeamUpdate();
+  beam->set_time(1.0);
+  beam->set_azimuth(0.5);
+  beams.insert(beam);
+  beams.update(1.0);
+  rv += SDK_ASSERT(beams.current() != nullptr);
+  if (beams.current())
+  {
+    rv += SDK_ASSERT(beams.current()->azimuth() == 0.5);
+    rv += SDK_ASSERT(!beams.current()->has_range());
+    rv += SDK_ASSERT(!beams.current()->has_elevation());
+  }
+
+  auto gatePool = std::make_shared<simData::ColumnChunkPool<simData::GateUpdate> >();
+  simData::ColumnarDataSlice<simData::GateUpdate> gates(gatePool);
+  simData::GateUpdate* gate = new simData::GateUpdate();
+  gate->set_time(2.0);
+  gate->set_minrange(100.0);
+  gate->set_maxrange(200.0);
+  gates.insert(gate);
+  const simData::GateUpdate* view = gates.at(0);
+  rv += SDK_ASSERT(view->minrange() == 100.0);
+  rv += SDK_ASSERT(view->maxrange() == 200.0);
+  rv += SDK_ASSERT(!view->has_centroid());
+  rv += SDK_ASSERT(!view->has_azimuth());
+
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::COLUMNAR);
+  rv += SDK_ASSERT(ds.updateStorage() == simData::MemoryDataStore::UpdateStorage::COLUMNAR);
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+  for (int ii = 0; ii < 300; ++ii)
+  {
+    helper.addPlatformUpdate(ii, platId);
+    helper.addBeamUpdate(ii, beamId);
+    helper.addGateUpdate(ii, gateId);
+  }
+
+  const simData::PlatformUpdateSlice* platSlice = ds.platformUpdateSlice(platId);
+  rv += SDK_ASSERT(dynamic_cast<const simData::ColumnarDataSlice<simData::PlatformUpdate>*>(platSlice) != nullptr);
+  rv += SDK_ASSERT(dynamic_cast<const simData::ColumnarDataSlice<simData::BeamUpdate>*>(ds.beamUpdateSlice(beamId)) != nullptr);
+  rv += SDK_ASSERT(platSlice->numItems() == 300);
+
+  ds.update(150.0);
+  rv += SDK_ASSERT(platSlice->current() != nullptr && platSlice->current()->time() == 150.0);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->current() != nullptr && ds.beamUpdateSlice(beamId)->current()->time() == 150.0);
+  rv += SDK_ASSERT(ds.gateUpdateSlice(gateId)->current() != nullptr && ds.gateUpdateSlice(gateId)->current()->time() == 150.0);
+
+  // Interpolation through the data store
+  simData::LinearInterpolator interpolator;
+  ds.setInterpolator(&interpolator);
+  ds.enableInterpolation(true);
+  ds.update(150.5);
+  rv += SDK_ASSERT(platSlice->current() != nullptr && platSlice->current()->time() == 150.5);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->isInterpolated());
+
+  // Lasers keep the default storage
+  const uint64_t laserId = helper.addLaser(platId);
+  rv += SDK_ASSERT(dynamic_cast<const simData::ColumnarDataSlice<simData::LaserUpdate>*>(ds.laserUpdateSlice(laserId)) == nullptr);
+
+  // Entities added after switching back use the deque storage
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::DEQUE);
+  const uint64_t platId2 = helper.addPlatform();
+  rv += SDK_ASSERT(dynamic_cast<const simData::ColumnarDataSlice<simData::PlatformUpdate>*>(ds.platformUpdateSlice(platId2)) == nullptr);
+
+  ds.enableInterpolation(false);
+  ds.setInterpolator(nullptr);
+  return rv;
+}
+
+}
+
+int TestColumnarSlice(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testParity();
+  rv += testProtobufFields();
+  rv += testDataStore();
+
+  return rv;
+}
@@ -0,0 +1,337 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <map>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/CategoryData/CategoryValueTable.h"
+#include "simData/CategoryData/CompiledCategoryFilter.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Regular expression filter for testing, using std::regex */
+class StdRegExpFilter : public simData::RegExpFilter
+{
+public:
+  explicit StdRegExpFilter(const std::string& pattern)
+    : pattern_(pattern),
+      regex_(pattern)
+  {
+  }
+
+  virtual bool match(const std::string& test) const override
+  {
+    return std::regex_search(test, regex_);
+  }
+
+  virtual std::string pattern() const override
+  {
+    return pattern_;
+  }
+
+private:
+  std::string pattern_;
+  std::regex regex_;
+};
+
+const int NUM_CATEGORIES = 5;
+const int NUM_VALUES = 6;
+
+std::string categoryName(int index)
+{
+  return "C" + std::to_string(index);
+}
+
+std::string valueName(int index)
+{
+  return "V" + std::to_string(index);
+}
+
+/** Returns the value of the category that CategoryFilterCounter would count the entity under */
+int countedValue(const simData::CategoryFilter::CurrentCategoryValues& values, int nameInt)
+{
+  auto it = values.find(nameInt);
+  return (it == values.end()) ? simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME : it->second;
+}
+
+/** Returns a filter with random checks and regular expressions on the categories */
+simData::CategoryFilter randomFilter(simData::DataStore& ds, std::mt19937& gen)
+{
+  const simData::CategoryNameManager& names = ds.categoryNameManager();
+  std::uniform_int_distribution<int> pick(0, 3);
+  std::bernoulli_distribution coin;
+  static const char* patterns[] = { "^V[0-2]$", "V5", "^$", "^(V1|V3|)$" };
+
+  simData::CategoryFilter filter(&ds);
+  for (int k = 0; k < NUM_CATEGORIES; ++k)
+  {
+    const int nameInt = names.nameToInt(categoryName(k));
+    switch (pick(gen))
+    {
+    case 0:
+      // Category does not contribute
+      break;
+    case 1:
+      filter.setCategoryRegExp(nameInt, std::make_shared<StdRegExpFilter>(patterns[pick(gen)]));
+      break;
+    default:
+      filter.setValue(nameInt, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, coin(gen));
+      if (coin(gen))
+        filter.setValue(nameInt, simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE, coin(gen));
+      for (int v = 0; v < NUM_VALUES; ++v)
+      {
+        if (coin(gen))
+          filter.setValue(nameInt, names.valueToInt(valueName(v)), coin(gen));
+      }
+      // An unchecked name does not contribute, whatever its values
+      if (pick(gen) == 0)
+        filter.updateCategoryFilterName(nameInt, false);
+      break;
+    }
+  }
+  return filter;
+}
+
+int testRandomFilters()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  simData::MemoryDataStore* ds = dynamic_cast<simData::MemoryDataStore*>(helper.dataStore());
+  rv += SDK_ASSERT(ds != nullptr);
+  if (ds == nullptr)
+    return rv;
+
+  // Random values, with about one in four categories of each entity missing
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> value(-2, NUM_VALUES - 1);
+  std::vector<uint64_t> ids;
+  for (int k = 0; k < 300; ++k)
+  {
+    ids.push_back(helper.addPlatform());
+    for (int c = 0; c < NUM_CATEGORIES; ++c)
+    {
+      const int v = value(gen);
+      if (v >= 0)
+        helper.addCategoryData(ids.back(), categoryName(c), valueName(v), 0.0);
+    }
+  }
+  // Category whose only value belongs to a removed entity still has a column
+  const uint64_t removed = helper.addPlatform();
+  helper.addCategoryData(removed, "Removed", "Gone", 0.0);
+  ds->update(0.0);
+  ds->removeEntity(removed);
+
+  const simData::CategoryValueTable& table = ds->categoryValueTable();
+  rv += SDK_ASSERT(table.numRows() == ids.size());
+  std::vector<simData::CategoryFilter::CurrentCategoryValues> current(table.numRows());
+  for (size_t row = 0; row < table.numRows(); ++row)
+    simData::CategoryFilter::getCurrentCategoryValues(*ds, table.id(row), current[row]);
+
+  // Table matches the values in the data store
+  std::vector<int> nameInts;
+  table.names(nameInts);
+  for (int nameInt : nameInts)
+  {
+    const std::vector<int>* column = table.column(nameInt);
+    rv += SDK_ASSERT(column != nullptr && column->size() == table.numRows());
+    for (size_t row = 0; column != nullptr && row < column->size(); ++row)
+    {
+      auto it = current[row].find(nameInt);
+      rv += SDK_ASSERT((*column)[row] == (it == current[row].end() ? simData::CategoryValueTable::NO_VALUE : it->second));
+    }
+  }
+
+  std::vector<uint64_t> allRows;
+  simData::CompiledCategoryFilter(simData::CategoryFilter(ds)).match(table, allRows);
+  rv += SDK_ASSERT(allRows.size() == (table.numRows() + 63) / 64);
+
+  for (int k = 0; k < 200; ++k)
+  {
+    const simData::CategoryFilter filter = randomFilter(*ds, gen);
+    const simData::CompiledCategoryFilter compiled(filter);
+
+    // Matches agree with the uncompiled filter
+    std::vector<uint64_t> rows;
+    compiled.match(table, rows);
+    std::vector<simData::ObjectId> matched;
+    compiled.matchingIds(table, matched);
+    std::vector<simData::ObjectId> expected;
+    for (size_t row = 0; row < table.numRows(); ++row)
+    {
+      const bool match = filter.matchData(current[row]);
+      rv += SDK_ASSERT(compiled.matchData(current[row]) == match);
+      rv += SDK_ASSERT(((rows[row / 64] >> (row % 64)) & 1) == (match ? 1u : 0u));
+      if (match)
+        expected.push_back(table.id(row));
+    }
+    rv += SDK_ASSERT(matched == expected);
+
+    // Counts match removing each category from the filter in turn
+    std::map<int, simData::CompiledCategoryFilter::ValueCounts> counts;
+    for (int c = 0; c < NUM_CATEGORIES; ++c)
+      counts[ds->categoryNameManager().nameToInt(categoryName(c))];
+    compiled.countValues(table, allRows, counts);
+    for (const auto& nameAndCounts : counts)
+    {
+      simData::CategoryFilter without(filter);
+      without.removeName(nameAndCounts.first);
+      simData::CompiledCategoryFilter::ValueCounts expectedCounts;
+      for (size_t row = 0; row < table.numRows(); ++row)
+      {
+        if (without.matchData(current[row]))
+          ++expectedCounts[countedValue(current[row], nameAndCounts.first)];
+      }
+      rv += SDK_ASSERT(nameAndCounts.second == expectedCounts);
+    }
+  }
+  return rv;
+}
+
+int testStoredNoValue()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  simData::DataStore* ds = helper.dataStore();
+  const uint64_t id = helper.addPlatform();
+  helper.addCategoryData(id, "Name", "Value", 0.0);
+  const int nameInt = ds->categoryNameManager().nameToInt("Name");
+  const int valueInt = ds->categoryNameManager().valueToInt("Value");
+
+  // Values that are not in the filter use the unlisted check, including values added after compiling
+  simData::CategoryFilter filter(ds);
+  filter.setValue(nameInt, valueInt, false);
+  filter.setValue(nameInt, simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE, true);
+  const simData::CompiledCategoryFilter compiled(filter);
+  simData::CategoryFilter::CurrentCategoryValues values;
+  values[nameInt] = valueInt;
+  rv += SDK_ASSERT(!compiled.matchData(values));
+  values[nameInt] = valueInt + 1000;
+  rv += SDK_ASSERT(compiled.matchData(values));
+  // Missing value without a "No Value" check fails
+  values.clear();
+  rv += SDK_ASSERT(!filter.matchData(values));
+  rv += SDK_ASSERT(!compiled.matchData(values));
+  // Negative values stored in the data are checked as values
+  values[nameInt] = simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME;
+  rv += SDK_ASSERT(filter.matchData(values));
+  rv += SDK_ASSERT(compiled.matchData(values));
+
+  // Regular expressions match values added after compiling
+  simData::CategoryFilter regExpFilter(ds);
+  regExpFilter.setCategoryRegExp(nameInt, std::make_shared<StdRegExpFilter>("^Later$"));
+  const simData::CompiledCategoryFilter compiledRegExp(regExpFilter);
+  helper.addCategoryData(id, "Name", "Later", 1.0);
+  values[nameInt] = ds->categoryNameManager().valueToInt("Later");
+  rv += SDK_ASSERT(compiledRegExp.matchData(values));
+  values[nameInt] = valueInt;
+  rv += SDK_ASSERT(!compiledRegExp.matchData(values));
+
+  // Without a data store, regular expressions are ignored but still replace the checks
+  simData::CategoryFilter noDataStore(nullptr);
+  noDataStore.setValue(nameInt, valueInt, false);
+  noDataStore.setCategoryRegExp(nameInt, std::make_shared<StdRegExpFilter>("^Later$"));
+  rv += SDK_ASSERT(noDataStore.matchData(values));
+  rv += SDK_ASSERT(simData::CompiledCategoryFilter(noDataStore).matchData(values));
+  return rv;
+}
+
+int testTableMaintenance()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  simData::MemoryDataStore* ds = dynamic_cast<simData::MemoryDataStore*>(helper.dataStore());
+  rv += SDK_ASSERT(ds != nullptr);
+  if (ds == nullptr)
+    return rv;
+  const simData::CategoryValueTable& table = ds->categoryValueTable();
+  const simData::CategoryNameManager& names = ds->categoryNameManager();
+
+  // Every entity has a row, even without category data
+  const uint64_t id1 = helper.addPlatform();
+  const uint64_t id2 = helper.addPlatform();
+  const uint64_t beam = helper.addBeam(id1);
+  rv += SDK_ASSERT(table.numRows() == 3);
+  size_t row = 0;
+  rv += SDK_ASSERT(table.findRow(beam, row) && table.id(row) == beam);
+
+  helper.addCategoryData(id1, "Color", "Red", 0.0);
+  helper.addCategoryData(id1, "Color", "Blue", 10.0);
+  helper.addCategoryData(id2, "Shape", "Square", 5.0);
+  const int color = names.nameToInt("Color");
+  const int shape = names.nameToInt("Shape");
+  ds->update(0.0);
+  rv += SDK_ASSERT(table.column(color) != nullptr);
+  rv += SDK_ASSERT(table.findRow(id1, row) && (*table.column(color))[row] == names.valueToInt("Red"));
+  rv += SDK_ASSERT(table.findRow(id2, row) && (*table.column(color))[row] == simData::CategoryValueTable::NO_VALUE);
+  rv += SDK_ASSERT(table.column(shape) == nullptr);
+
+  ds->update(10.0);
+  rv += SDK_ASSERT(table.findRow(id1, row) && (*table.column(color))[row] == names.valueToInt("Blue"));
+  rv += SDK_ASSERT(table.findRow(id2, row) && (*table.column(shape))[row] == names.valueToInt("Square"));
+
+  // Going back in time clears values that did not exist yet
+  ds->update(1.0);
+  rv += SDK_ASSERT(table.findRow(id1, row) && (*table.column(color))[row] == names.valueToInt("Red"));
+  rv += SDK_ASSERT(table.findRow(id2, row) && (*table.column(shape))[row] == simData::CategoryValueTable::NO_VALUE);
+
+  // Flushed values are cleared on the next update
+  ds->update(10.0);
+  rv += SDK_ASSERT(ds->flush(id1, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_CATEGORY_DATA) == 0);
+  ds->update(10.0);
+  rv += SDK_ASSERT(table.findRow(id1, row) && (*table.column(color))[row] == simData::CategoryValueTable::NO_VALUE);
+  rv += SDK_ASSERT(table.findRow(id2, row) && (*table.column(shape))[row] == names.valueToInt("Square"));
+
+  // Removed entities lose their rows, and the last row moves into the gap
+  ds->removeEntity(id2);
+  rv += SDK_ASSERT(table.numRows() == 2);
+  rv += SDK_ASSERT(!table.findRow(id2, row));
+  rv += SDK_ASSERT(table.findRow(beam, row) && row == 1 && table.id(row) == beam);
+  rv += SDK_ASSERT((*table.column(shape))[row] == simData::CategoryValueTable::NO_VALUE);
+  rv += SDK_ASSERT(table.findRow(id1, row) && row == 0 && table.id(row) == id1);
+
+  // Copies are independent of the original
+  const simData::CategoryValueTable copy = table;
+  ds->clear();
+  rv += SDK_ASSERT(table.numRows() == 0);
+  rv += SDK_ASSERT(table.column(shape) == nullptr);
+  rv += SDK_ASSERT(copy.numRows() == 2);
+  return rv;
+}
+
+}
+
+int TestCompiledCategoryFilter(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testRandomFilters() == 0);
+  rv += SDK_ASSERT(testStoredNoValue() == 0);
+  rv += SDK_ASSERT(testTableMaintenance() == 0);
+  return rv;
+}
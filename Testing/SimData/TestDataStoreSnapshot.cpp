@@ -0,0 +1,269 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataStoreSnapshot.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Adds platform updates with the times, with x set to the time plus the offset */
+void addUpdates(simData::MemoryDataStore& ds, uint64_t id, size_t begin, size_t end, double offset = 0.0)
+{
+  for (size_t ii = begin; ii < end; ++ii)
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformUpdate* update = ds.addPlatformUpdate(id, &t);
+    update->set_time(static_cast<double>(ii));
+    update->set_x(static_cast<double>(ii) + offset);
+    t.commit();
+  }
+}
+
+/** Tests that snapshots keep their values while the data store changes */
+int testValues()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platformId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platformId);
+  addUpdates(ds, platformId, 0, 10);
+  helper.addBeamUpdate(5.0, beamId);
+  ds.update(9.0);
+
+  auto first = ds.createSnapshot();
+  rv += SDK_ASSERT(first->updateTime() == 9.0);
+  simData::DataStore::IdList ids;
+  first->idList(&ids);
+  rv += SDK_ASSERT(ids.size() == 2);
+  rv += SDK_ASSERT(first->objectType(platformId) == simData::PLATFORM);
+  rv += SDK_ASSERT(first->objectType(beamId) == simData::BEAM);
+  rv += SDK_ASSERT(first->platformProperties(beamId) == nullptr);
+  rv += SDK_ASSERT(first->beamProperties(beamId) != nullptr);
+  rv += SDK_ASSERT(first->beamUpdates(beamId) != nullptr && first->beamUpdates(beamId)->size() == 1);
+  const simData::SnapshotSlice<simData::PlatformUpdate>* slice = first->platformUpdates(platformId);
+  rv += SDK_ASSERT(slice != nullptr);
+  if (slice == nullptr)
+    return rv;
+  rv += SDK_ASSERT(slice->size() == 10);
+  rv += SDK_ASSERT(slice->firstTime() == 0.0 && slice->lastTime() == 9.0);
+  rv += SDK_ASSERT(slice->lowerBound(4.5) == 5 && slice->upperBound(5.0) == 6);
+  rv += SDK_ASSERT(slice->atOrBefore(4.5) != nullptr && slice->atOrBefore(4.5)->time() == 4.0);
+  rv += SDK_ASSERT(slice->atOrBefore(-1.0) == nullptr);
+
+  // Change the prefs and replace an update
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_name("Changed");
+  helper.updatePlatformPrefs(prefs, platformId);
+  addUpdates(ds, platformId, 5, 6, 100.0);
+  ds.update(9.0);
+  auto second = ds.createSnapshot();
+  rv += SDK_ASSERT(first->platformPrefs(platformId)->commonprefs().name() != "Changed");
+  rv += SDK_ASSERT(second->platformPrefs(platformId)->commonprefs().name() == "Changed");
+  rv += SDK_ASSERT((*slice)[5].x() == 5.0);
+  rv += SDK_ASSERT((*second->platformUpdates(platformId))[5].x() == 105.0);
+  // Unchanged settings are shared
+  rv += SDK_ASSERT(first->platformProperties(platformId) == second->platformProperties(platformId));
+  rv += SDK_ASSERT(first->beamPrefs(beamId) == second->beamPrefs(beamId));
+
+  // Flushing and removing entities do not change earlier snapshots
+  ds.flush(platformId, simData::DataStore::RECURSIVE);
+  ds.removeEntity(beamId);
+  ds.update(9.0);
+  auto third = ds.createSnapshot();
+  rv += SDK_ASSERT(third->platformUpdates(platformId)->empty());
+  rv += SDK_ASSERT(third->objectType(beamId) == simData::NONE);
+  rv += SDK_ASSERT(slice->size() == 10 && (*slice)[9].x() == 9.0);
+  rv += SDK_ASSERT(second->beamUpdates(beamId)->size() == 1);
+  return rv;
+}
+
+/** Tests that consecutive snapshots share the unchanged chunks of a growing, limited slice */
+int testSharing()
+{
+  int rv = 0;
+  const size_t chunkSize = simData::SnapshotSlice<simData::PlatformUpdate>::ChunkSize;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t id = helper.addPlatform();
+  addUpdates(ds, id, 0, 3 * chunkSize + 10);
+  ds.update(0.0);
+  auto first = ds.createSnapshot();
+
+  // Unchanged slices are shared whole
+  auto second = ds.createSnapshot();
+  rv += SDK_ASSERT(first->platformUpdates(id) == second->platformUpdates(id));
+
+  // Appending shares the full chunks
+  addUpdates(ds, id, 3 * chunkSize + 10, 3 * chunkSize + 20);
+  auto third = ds.createSnapshot();
+  const auto* slice1 = first->platformUpdates(id);
+  const auto* slice3 = third->platformUpdates(id);
+  rv += SDK_ASSERT(slice3->size() == 3 * chunkSize + 20);
+  rv += SDK_ASSERT(&(*slice1)[0] == &(*slice3)[0]);
+  rv += SDK_ASSERT(&(*slice1)[3 * chunkSize - 1] == &(*slice3)[3 * chunkSize - 1]);
+  rv += SDK_ASSERT(&(*slice1)[3 * chunkSize] != &(*slice3)[3 * chunkSize]);
+
+  // Replacing an update copies its chunk and all later ones
+  addUpdates(ds, id, chunkSize + 1, chunkSize + 2, 0.5);
+  auto fourth = ds.createSnapshot();
+  const auto* slice4 = fourth->platformUpdates(id);
+  rv += SDK_ASSERT(&(*slice3)[0] == &(*slice4)[0]);
+  rv += SDK_ASSERT(&(*slice3)[chunkSize] != &(*slice4)[chunkSize]);
+  rv += SDK_ASSERT((*slice4)[chunkSize + 1].x() == chunkSize + 1.5);
+  rv += SDK_ASSERT((*slice3)[chunkSize + 1].x() == chunkSize + 1.0);
+
+  // Data limiting removes updates without notification, and the rest stay shared
+  ds.setDataLimiting(true);
+  {
+    simData::DataStore::Transaction t;
+    ds.mutable_platformPrefs(id, &t)->mutable_commonprefs()->set_datalimitpoints(static_cast<uint32_t>(2 * chunkSize));
+    t.commit();
+  }
+  ds.update(0.0);
+  const size_t numItems = ds.platformUpdateSlice(id)->numItems();
+  rv += SDK_ASSERT(numItems == 2 * chunkSize);
+  auto fifth = ds.createSnapshot();
+  const auto* slice5 = fifth->platformUpdates(id);
+  rv += SDK_ASSERT(slice5->size() == numItems);
+  rv += SDK_ASSERT(slice5->firstTime() == ds.platformUpdateSlice(id)->firstTime());
+  rv += SDK_ASSERT(slice5->lastTime() == ds.platformUpdateSlice(id)->lastTime());
+  rv += SDK_ASSERT(&(*slice5)[0] == &(*slice4)[slice4->size() - numItems]);
+  rv += SDK_ASSERT(slice4->size() == 3 * chunkSize + 20);
+  return rv;
+}
+
+/** Tests the copies of the data tables */
+int testTables()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t id = helper.addPlatform();
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Table", &table).isSuccess());
+  simData::TableColumn* column = nullptr;
+  rv += SDK_ASSERT(table->addColumn("Column", simData::VT_DOUBLE, 0, &column).isSuccess());
+  for (size_t ii = 0; ii < 5; ++ii)
+  {
+    simData::TableRow row;
+    row.setTime(static_cast<double>(ii));
+    row.setValue(column->columnId(), 10.0 * ii);
+    table->addRow(row);
+  }
+
+  auto first = ds.createSnapshot();
+  const simData::SnapshotTable* copy = first->findTable(id, "Table");
+  rv += SDK_ASSERT(copy != nullptr);
+  if (copy == nullptr)
+    return rv;
+  rv += SDK_ASSERT(first->table(table->tableId()) == copy);
+  rv += SDK_ASSERT(first->tablesForOwner(id).size() == 1);
+  rv += SDK_ASSERT(copy->columns().size() == 1 && copy->columns()[0].name == "Column");
+  rv += SDK_ASSERT(copy->rows().size() == 5);
+  double value = 0.0;
+  rv += SDK_ASSERT(copy->rows()[3].value(column->columnId(), value).isSuccess() && value == 30.0);
+
+  // Unchanged tables are shared; changed tables are copied again
+  auto second = ds.createSnapshot();
+  rv += SDK_ASSERT(second->table(table->tableId()) == copy);
+  simData::TableRow row;
+  row.setTime(5.0);
+  row.setValue(column->columnId(), 50.0);
+  table->addRow(row);
+  auto third = ds.createSnapshot();
+  rv += SDK_ASSERT(third->table(table->tableId()) != copy);
+  rv += SDK_ASSERT(third->table(table->tableId())->rows().size() == 6);
+  rv += SDK_ASSERT(copy->rows().size() == 5);
+
+  // Removed tables stay in earlier snapshots
+  ds.dataTableManager().deleteTable(table->tableId());
+  auto fourth = ds.createSnapshot();
+  rv += SDK_ASSERT(fourth->findTable(id, "Table") == nullptr);
+  rv += SDK_ASSERT(third->findTable(id, "Table") != nullptr);
+  return rv;
+}
+
+/** Tests reading snapshots from another thread while the data store updates */
+int testThreads()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t id = helper.addPlatform();
+
+  std::shared_ptr<const simData::DataStoreSnapshot> shared;
+  std::mutex mutex;
+  std::atomic<bool> done = false;
+  std::atomic<int> errors = 0;
+  std::thread reader([&]() {
+    while (!done)
+    {
+      std::shared_ptr<const simData::DataStoreSnapshot> snapshot;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot = shared;
+      }
+      if (!snapshot)
+        continue;
+      // Every snapshot is consistent: the updates are in order and match their times
+      const auto* slice = snapshot->platformUpdates(id);
+      for (size_t ii = 0; slice && ii < slice->size(); ++ii)
+      {
+        if ((*slice)[ii].time() != static_cast<double>(ii) || (*slice)[ii].x() != static_cast<double>(ii))
+          ++errors;
+      }
+    }
+  });
+
+  for (size_t ii = 0; ii < 50; ++ii)
+  {
+    addUpdates(ds, id, ii * 20, (ii + 1) * 20);
+    ds.update(static_cast<double>(ii * 20));
+    auto snapshot = ds.createSnapshot();
+    std::lock_guard<std::mutex> lock(mutex);
+    shared = snapshot;
+  }
+  done = true;
+  reader.join();
+  rv += SDK_ASSERT(errors == 0);
+  rv += SDK_ASSERT(shared->platformUpdates(id)->size() == 1000);
+  return rv;
+}
+
+}
+
+int TestDataStoreSnapshot(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testValues();
+  rv += testSharing();
+  rv += testTables();
+  rv += testThreads();
+  return rv;
+}
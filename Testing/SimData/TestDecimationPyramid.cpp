@@ -0,0 +1,390 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "simCore/Calc/MathConstants.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DecimationPyramid.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/TieredDataSlice.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+typedef simData::DecimationPyramid<3> Pyramid;
+
+/** Time ordered points with three values each, read by the pyramid */
+struct Series
+{
+  std::vector<double> times;
+  std::vector<double> values;
+
+  void append(double time, double x, double y, double z)
+  {
+    times.push_back(time);
+    values.insert(values.end(), { x, y, z });
+  }
+
+  /** Implements the pyramid's Reader */
+  void operator()(double beginTime, double endTime, std::vector<double>& rangeTimes, std::vector<double>& rangeValues) const
+  {
+    const size_t first = std::lower_bound(times.begin(), times.end(), beginTime) - times.begin();
+    const size_t last = std::lower_bound(times.begin(), times.end(), endTime) - times.begin();
+    rangeTimes.assign(times.begin() + first, times.begin() + std::max(first, last));
+    rangeValues.assign(values.begin() + 3 * first, values.begin() + 3 * std::max(first, last));
+  }
+
+  /** Removes the points in [beginTime, endTime] */
+  void erase(double beginTime, double endTime)
+  {
+    const size_t first = std::lower_bound(times.begin(), times.end(), beginTime) - times.begin();
+    const size_t last = std::upper_bound(times.begin(), times.end(), endTime) - times.begin();
+    times.erase(times.begin() + first, times.begin() + last);
+    values.erase(values.begin() + 3 * first, values.begin() + 3 * last);
+  }
+};
+
+/** Computes the extent of the points in the time range one point at a time */
+Pyramid::Extent bruteForceExtent(const Series& series, double beginTime, double endTime)
+{
+  Pyramid::Extent rv;
+  for (size_t k = 0; k < series.times.size(); ++k)
+  {
+    if (series.times[k] < beginTime || series.times[k] >= endTime)
+      continue;
+    Pyramid::Extent one;
+    one.count = 1;
+    one.firstTime = one.lastTime = series.times[k];
+    for (size_t c = 0; c < 3; ++c)
+    {
+      one.first[c] = one.last[c] = one.min[c] = one.max[c] = one.sum[c] = series.values[3 * k + c];
+      one.minTime[c] = one.maxTime[c] = series.times[k];
+    }
+    rv.append(one);
+  }
+  return rv;
+}
+
+/** Returns 0 if the pyramid's extents match the brute force extents for random windows */
+int checkExtents(const Pyramid& pyramid, const Series& series, std::mt19937& random)
+{
+  int rv = 0;
+  if (series.times.empty())
+    return rv;
+  std::uniform_real_distribution<double> time(series.times.front() - 10.0, series.times.back() + 10.0);
+  for (size_t ii = 0; ii < 20; ++ii)
+  {
+    double beginTime = time(random);
+    double endTime = time(random);
+    if (ii == 0)
+    {
+      beginTime = -1e12;
+      endTime = 1e12;
+    }
+    else if (endTime < beginTime)
+      std::swap(beginTime, endTime);
+
+    Pyramid::Extent extent;
+    pyramid.extent(series, beginTime, endTime, extent);
+    const Pyramid::Extent expected = bruteForceExtent(series, beginTime, endTime);
+    rv += SDK_ASSERT(extent.count == expected.count);
+    rv += SDK_ASSERT(extent.firstTime == expected.firstTime && extent.lastTime == expected.lastTime);
+    rv += SDK_ASSERT(extent.first == expected.first && extent.last == expected.last);
+    rv += SDK_ASSERT(extent.min == expected.min && extent.max == expected.max);
+    rv += SDK_ASSERT(extent.minTime == expected.minTime && extent.maxTime == expected.maxTime);
+    for (size_t c = 0; c < 3; ++c)
+      rv += SDK_ASSERT(std::abs(extent.sum[c] - expected.sum[c]) <= 1e-9 * (1.0 + std::abs(expected.sum[c])));
+  }
+  return rv;
+}
+
+/** Returns 0 if the decimated times are a time ordered subset of the range that keeps its first, last and extreme points */
+int checkDecimation(const Pyramid& pyramid, const Series& series, double beginTime, double endTime, size_t maxPoints)
+{
+  int rv = 0;
+  std::vector<double> times;
+  pyramid.decimate(series, beginTime, endTime, maxPoints, times);
+  rv += SDK_ASSERT(times.size() <= maxPoints);
+  rv += SDK_ASSERT(std::is_sorted(times.begin(), times.end()));
+  rv += SDK_ASSERT(std::adjacent_find(times.begin(), times.end()) == times.end());
+
+  std::vector<double> allTimes;
+  std::vector<double> allValues;
+  series(beginTime, endTime, allTimes, allValues);
+  if (allTimes.size() <= maxPoints)
+  {
+    rv += SDK_ASSERT(times == allTimes);
+    return rv;
+  }
+  for (double time : times)
+    rv += SDK_ASSERT(std::binary_search(allTimes.begin(), allTimes.end(), time));
+  const Pyramid::Extent expected = bruteForceExtent(series, beginTime, endTime);
+  rv += SDK_ASSERT(!times.empty() && times.front() == expected.firstTime && times.back() == expected.lastTime);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    rv += SDK_ASSERT(std::binary_search(times.begin(), times.end(), expected.minTime[c]));
+    rv += SDK_ASSERT(std::binary_search(times.begin(), times.end(), expected.maxTime[c]));
+  }
+  return rv;
+}
+
+/** Tests extents and decimation as points are appended, inserted, changed and removed */
+int testPyramid()
+{
+  int rv = 0;
+  std::mt19937 random(1234);
+  std::normal_distribution<double> step(0.0, 1.0);
+  Series series;
+  Pyramid pyramid;
+
+  Pyramid::Extent extent;
+  pyramid.extent(series, 0.0, 10.0, extent);
+  rv += SDK_ASSERT(extent.count == 0);
+  rv += checkDecimation(pyramid, series, 0.0, 10.0, 16);
+
+  // Random walks appended in pieces, as live data arrives
+  double x = 0.0;
+  double y = 0.0;
+  double z = 0.0;
+  for (size_t k = 0; k < 70000; ++k)
+  {
+    x += step(random);
+    y += step(random);
+    z += step(random);
+    series.append(k * 0.01, x, y, z);
+    if (k % 17000 == 0)
+      rv += checkExtents(pyramid, series, random);
+  }
+  rv += checkExtents(pyramid, series, random);
+  // 64-point blocks, then 1024 and 16384 points
+  rv += SDK_ASSERT(pyramid.numLevels() == 3);
+  rv += checkDecimation(pyramid, series, -1.0, 1000.0, 800);
+  rv += checkDecimation(pyramid, series, 123.456, 234.567, 80);
+  rv += checkDecimation(pyramid, series, 123.456, 123.789, 80);
+  rv += checkDecimation(pyramid, series, 100.0, 600.0, Pyramid::PointsPerBucket);
+
+  // Insert a point out of order and change another
+  series.times.insert(series.times.begin() + 30000, 299.995);
+  series.values.insert(series.values.begin() + 90000, { 1e6, -1e6, 0.0 });
+  pyramid.changed(299.995);
+  series.values[3 * 50000 + 2] = -1e6;
+  pyramid.changed(series.times[50000]);
+  rv += checkExtents(pyramid, series, random);
+  rv += checkDecimation(pyramid, series, 0.0, 1000.0, 400);
+
+  // Remove from the front, as data limiting does, and from the middle
+  pyramid.removed(-1e12, 105.0);
+  series.erase(-1e12, 105.0);
+  rv += checkExtents(pyramid, series, random);
+  pyramid.removed(400.0, 420.5);
+  series.erase(400.0, 420.5);
+  rv += checkExtents(pyramid, series, random);
+  rv += checkDecimation(pyramid, series, 0.0, 1000.0, 400);
+
+  pyramid.clear();
+  rv += SDK_ASSERT(pyramid.numLevels() == 0);
+  rv += checkExtents(pyramid, series, random);
+  return rv;
+}
+
+/** Adds platform updates from the times in [begin, end), circling the earth once every 10000 updates */
+void addUpdates(simData::MemoryDataStore& ds, uint64_t id, size_t begin, size_t end)
+{
+  std::vector<simData::PlatformUpdate> updates;
+  for (size_t k = begin; k < end; ++k)
+  {
+    const double angle = k * M_TWOPI / 10000.0;
+    simData::PlatformUpdate update;
+    update.set_time(k * 0.1);
+    update.set_x(6378137.0 * std::cos(angle));
+    update.set_y(6378137.0 * std::sin(angle));
+    update.set_z(1000.0 * std::sin(k * 0.37));
+    updates.push_back(update);
+  }
+  ds.addPlatformUpdates(id, updates);
+}
+
+/** Returns 0 if the decimated updates are time ordered, in the slice and no more than maxPoints */
+int checkUpdates(simData::MemoryDataStore& ds, uint64_t id, double beginTime, double endTime, size_t maxPoints)
+{
+  int rv = 0;
+  std::vector<simData::PlatformUpdate> updates;
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(id, beginTime, endTime, maxPoints, updates) == 0);
+  rv += SDK_ASSERT(!updates.empty() && updates.size() <= maxPoints);
+  const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(id);
+  const double firstTime = std::max(beginTime, slice->firstTime());
+  for (size_t k = 0; k < updates.size(); ++k)
+  {
+    rv += SDK_ASSERT(updates[k].time() >= firstTime && updates[k].time() < endTime);
+    rv += SDK_ASSERT(k == 0 || updates[k - 1].time() < updates[k].time());
+  }
+  // The first update of the range and the farthest east and west are always kept
+  rv += SDK_ASSERT(!updates.empty() && updates.front().time() == slice->lower_bound(beginTime).next()->time());
+  const auto maxX = std::max_element(updates.begin(), updates.end(),
+    [](const simData::PlatformUpdate& a, const simData::PlatformUpdate& b) { return a.x() < b.x(); });
+  const auto minX = std::min_element(updates.begin(), updates.end(),
+    [](const simData::PlatformUpdate& a, const simData::PlatformUpdate& b) { return a.x() < b.x(); });
+  rv += SDK_ASSERT(maxX != updates.end() && maxX->x() > 6378136.0);
+  rv += SDK_ASSERT(minX != updates.end() && minX->x() < -6378136.0);
+  return rv;
+}
+
+/** Tests the platform track pyramids of MemoryDataStore */
+int testDataStore()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platformId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platformId);
+
+  std::vector<simData::PlatformUpdate> updates;
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(beamId, 0.0, 10.0, 100, updates) != 0);
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 10.0, 7, updates) != 0);
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 10.0, 100, updates) == 0);
+  rv += SDK_ASSERT(updates.empty());
+
+  // Few updates are returned as is
+  addUpdates(ds, platformId, 0, 50);
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 100.0, 100, updates) == 0);
+  rv += SDK_ASSERT(updates.size() == 50);
+
+  addUpdates(ds, platformId, 50, 30000);
+  rv += checkUpdates(ds, platformId, 0.0, 3000.0, 800);
+  rv += checkUpdates(ds, platformId, 500.0, 2500.0, 80);
+
+  // Live updates extend the pyramid, including one out of order
+  for (size_t k = 30000; k < 30100; ++k)
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformUpdate* update = ds.addPlatformUpdate(platformId, &t);
+    update->set_time(k * 0.1);
+    update->set_x(-1e8);
+    t.commit();
+  }
+  {
+    simData::DataStore::Transaction t;
+    simData::PlatformUpdate* update = ds.addPlatformUpdate(platformId, &t);
+    update->set_time(1234.56);
+    update->set_z(1e8);
+    t.commit();
+  }
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 4000.0, 800, updates) == 0);
+  rv += SDK_ASSERT(updates.size() <= 800 && updates.back().time() == 3009.9 && updates.back().x() == -1e8);
+  rv += SDK_ASSERT(std::find_if(updates.begin(), updates.end(), [](const simData::PlatformUpdate& update) { return update.z() == 1e8; }) != updates.end());
+
+  // Data limiting removes the oldest updates without notification
+  ds.setDataLimiting(true);
+  {
+    simData::DataStore::Transaction t;
+    ds.mutable_platformPrefs(platformId, &t)->mutable_commonprefs()->set_datalimitpoints(15000);
+    t.commit();
+  }
+  ds.update(0.0);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(platformId)->numItems() == 15000);
+  addUpdates(ds, platformId, 40000, 45000);
+  rv += checkUpdates(ds, platformId, 0.0, 5000.0, 400);
+
+  // Flushing drops the pyramid
+  ds.flush(platformId);
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 5000.0, 400, updates) == 0);
+  rv += SDK_ASSERT(updates.empty());
+  addUpdates(ds, platformId, 0, 20000);
+  rv += checkUpdates(ds, platformId, 0.0, 5000.0, 400);
+  return rv;
+}
+
+/** Returns 0 if both data stores decimate the platform's updates to the same updates */
+int checkSameUpdates(simData::MemoryDataStore& ds, simData::MemoryDataStore& expectedDs, uint64_t id, double beginTime, double endTime, size_t maxPoints)
+{
+  int rv = 0;
+  std::vector<simData::PlatformUpdate> updates;
+  std::vector<simData::PlatformUpdate> expected;
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(id, beginTime, endTime, maxPoints, updates) == 0);
+  rv += SDK_ASSERT(expectedDs.decimatePlatformUpdates(id, beginTime, endTime, maxPoints, expected) == 0);
+  rv += SDK_ASSERT(!updates.empty() && updates.size() == expected.size());
+  bool same = (updates.size() == expected.size());
+  for (size_t k = 0; same && k < updates.size(); ++k)
+    same = (updates[k].time() == expected[k].time()) && (updates[k].x() == expected[k].x()) && (updates[k].z() == expected[k].z());
+  rv += SDK_ASSERT(same);
+  return rv;
+}
+
+/** Decimating cold TIERED updates must match decimating the same updates in a DEQUE */
+int testTieredStorage()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::TIERED);
+  ds.setColdStorageBudget(4 * 1024 * 1024);
+  ds.setDataLimiting(true);
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platformId = helper.addPlatform();
+  {
+    simData::DataStore::Transaction t;
+    ds.mutable_platformPrefs(platformId, &t)->mutable_commonprefs()->set_datalimitpoints(50);
+    t.commit();
+  }
+  simData::MemoryDataStore dequeDs;
+  simUtil::DataStoreTestHelper dequeHelper(&dequeDs);
+  rv += SDK_ASSERT(dequeHelper.addPlatform() == platformId);
+
+  addUpdates(ds, platformId, 0, 20000);
+  addUpdates(dequeDs, platformId, 0, 20000);
+  const auto* tiered = dynamic_cast<const simData::TieredDataSlice<simData::PlatformUpdate>*>(ds.platformUpdateSlice(platformId));
+  rv += SDK_ASSERT(tiered != nullptr && tiered->numColdItems() == 19950);
+
+  rv += checkUpdates(ds, platformId, 0.0, 2000.0, 800);
+  rv += checkSameUpdates(ds, dequeDs, platformId, 0.0, 2000.0, 800);
+  rv += checkSameUpdates(ds, dequeDs, platformId, 123.4, 1567.8, 80);
+
+  // Results stay intact while other cold blocks are read
+  std::vector<simData::PlatformUpdate> updates;
+  std::vector<simData::PlatformUpdate> expected;
+  rv += SDK_ASSERT(ds.decimatePlatformUpdates(platformId, 0.0, 1000.0, 400, updates) == 0);
+  rv += SDK_ASSERT(dequeDs.decimatePlatformUpdates(platformId, 0.0, 1000.0, 400, expected) == 0);
+  auto iter = ds.platformUpdateSlice(platformId)->lower_bound(1500.0);
+  while (iter.hasNext())
+    iter.next();
+  bool same = (updates.size() == expected.size());
+  for (size_t k = 0; same && k < updates.size(); ++k)
+    same = (updates[k].time() == expected[k].time()) && (updates[k].y() == expected[k].y());
+  rv += SDK_ASSERT(same);
+  return rv;
+}
+
+}
+
+int TestDecimationPyramid(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testPyramid();
+  rv += testDataStore();
+  rv += testTieredStorage();
+
+  return rv;
+}
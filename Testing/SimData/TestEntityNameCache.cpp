@@ -20,8 +20,11 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 #include "simCore/Common/SDKAssert.h"
+#include "simData/EntityNameCache.h"
 #include "simData/MemoryDataStore.h"
 #include "simUtil/DataStoreTestHelper.h"
 
@@ -125,6 +128,128 @@ int testAliasInvalidation()
   return rv;
 }
 
+/** Returns the sorted IDs from idListByNameSearch() */
+simData::DataStore::IdList search(const simData::DataStore& ds, const std::string& text, simData::DataStore::NameSearch how, bool caseSensitive, simData::ObjectType type = simData::ALL)
+{
+  simData::DataStore::IdList ids;
+  ds.idListByNameSearch(text, how, caseSensitive, &ids, type);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/** Sets the name of the platform or beam */
+void setName(simData::DataStore& ds, uint64_t id, const std::string& name)
+{
+  simData::DataStore::Transaction txn;
+  simData::CommonPrefs* prefs = ds.mutable_commonPrefs(id, &txn);
+  prefs->set_name(name);
+  txn.complete(&prefs);
+}
+
+int testNameSearch()
+{
+  int rv = 0;
+
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore& ds = *testHelper.dataStore();
+  const uint64_t alpha = testHelper.addPlatform();
+  const uint64_t alphabet = testHelper.addPlatform();
+  const uint64_t beam = testHelper.addBeam(alpha);
+  setName(ds, alpha, "Alpha");
+  setName(ds, alphabet, "alphabet");
+  setName(ds, beam, "Beta Alpha Beam");
+
+  typedef simData::DataStore::NameSearch NameSearch;
+  const simData::DataStore::IdList NONE;
+  const simData::DataStore::IdList ALPHA = { alpha };
+  const simData::DataStore::IdList ALPHABET = { alphabet };
+  const simData::DataStore::IdList BOTH = { alpha, alphabet };
+  const simData::DataStore::IdList ALL = { alpha, alphabet, beam };
+  const simData::DataStore::IdList BEAM = { beam };
+  const simData::DataStore::IdList ALPHA_BEAM = { alpha, beam };
+  const simData::DataStore::IdList ALPHABET_BEAM = { alphabet, beam };
+
+  rv += SDK_ASSERT(search(ds, "Alpha", NameSearch::EXACT, true) == ALPHA);
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::EXACT, true) == NONE);
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::EXACT, false) == ALPHA);
+  rv += SDK_ASSERT(search(ds, "alp", NameSearch::PREFIX, true) == ALPHABET);
+  rv += SDK_ASSERT(search(ds, "ALP", NameSearch::PREFIX, false) == BOTH);
+  rv += SDK_ASSERT(search(ds, "", NameSearch::PREFIX, false) == ALL);
+  rv += SDK_ASSERT(search(ds, "lph", NameSearch::SUBSTRING, true) == ALL);
+  rv += SDK_ASSERT(search(ds, "A B", NameSearch::SUBSTRING, false) == BEAM);
+  rv += SDK_ASSERT(search(ds, "Alpha", NameSearch::SUBSTRING, true) == ALPHA_BEAM);
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::SUBSTRING, false, simData::PLATFORM) == BOTH);
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::SUBSTRING, false, simData::BEAM) == BEAM);
+  rv += SDK_ASSERT(search(ds, "bet", NameSearch::SUBSTRING, false) == ALPHABET_BEAM);
+  // Shorter than a trigram
+  rv += SDK_ASSERT(search(ds, "b", NameSearch::SUBSTRING, true) == ALPHABET);
+  rv += SDK_ASSERT(search(ds, "", NameSearch::SUBSTRING, true) == ALL);
+  rv += SDK_ASSERT(search(ds, "gamma", NameSearch::SUBSTRING, false) == NONE);
+
+  // Renames and removals update the index
+  setName(ds, alpha, "Gamma");
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::SUBSTRING, false, simData::PLATFORM) == ALPHABET);
+  rv += SDK_ASSERT(search(ds, "gam", NameSearch::PREFIX, false) == ALPHA);
+  ds.removeEntity(alpha);
+  rv += SDK_ASSERT(search(ds, "gam", NameSearch::PREFIX, false) == NONE);
+  rv += SDK_ASSERT(search(ds, "alpha", NameSearch::SUBSTRING, false) == ALPHABET);
+
+  return rv;
+}
+
+int testIndexCompaction()
+{
+  int rv = 0;
+
+  // Enough removals to compact the posting lists several times
+  simData::EntityNameIndex index;
+  std::vector<simData::EntityNameEntry> entries;
+  const size_t count = 5000;
+  entries.reserve(count);
+  for (size_t ii = 0; ii < count; ++ii)
+    entries.push_back(simData::EntityNameEntry(ii + 1, (ii % 2) ? simData::BEAM : simData::PLATFORM));
+  auto nameOf = [](size_t ii) {
+    std::ostringstream os;
+    os << "Track " << ii;
+    return os.str();
+  };
+  for (size_t ii = 0; ii < count; ++ii)
+    index.add(nameOf(ii), &entries[ii]);
+  rv += SDK_ASSERT(index.size() == count);
+
+  // Keep every tenth name, renaming the rest
+  for (size_t ii = 0; ii < count; ++ii)
+  {
+    if (ii % 10 == 0)
+      continue;
+    index.remove(&entries[ii]);
+    if (ii % 10 == 1)
+      index.add("renamed " + nameOf(ii), &entries[ii]);
+  }
+  rv += SDK_ASSERT(index.size() == count / 5);
+
+  std::vector<const simData::EntityNameEntry*> found;
+  index.find("track 12", simData::EntityNameIndex::Match::SUBSTRING, false, simData::ALL, found);
+  // "Track 120", "Track 1200" to "Track 1290", and the renamed "Track 121" and "Track 1201" to "Track 1291"
+  rv += SDK_ASSERT(found.size() == 22);
+  found.clear();
+  index.find("track 12", simData::EntityNameIndex::Match::PREFIX, false, simData::ALL, found);
+  rv += SDK_ASSERT(found.size() == 11);
+  found.clear();
+  index.find("Track 12", simData::EntityNameIndex::Match::PREFIX, true, simData::BEAM, found);
+  rv += SDK_ASSERT(found.empty());
+  found.clear();
+  index.find("Track 4990", simData::EntityNameIndex::Match::EXACT, true, simData::PLATFORM, found);
+  rv += SDK_ASSERT(found.size() == 1 && found[0] == &entries[4990]);
+
+  index.clear();
+  rv += SDK_ASSERT(index.size() == 0);
+  found.clear();
+  index.find("", simData::EntityNameIndex::Match::SUBSTRING, false, simData::ALL, found);
+  rv += SDK_ASSERT(found.empty());
+  return rv;
+}
+
 }
 
 int TestEntityNameCache(int argc, char* argv[])
@@ -132,6 +257,8 @@ int TestEntityNameCache(int argc, char* argv[])
   int rv = 0;
 
   rv += testAliasInvalidation();
+  rv += testNameSearch();
+  rv += testIndexCompaction();
 
   std::cout << "TestEntityNameCache: " << (rv == 0 ? "PASSED" : "FAILED") << std::endl;
 
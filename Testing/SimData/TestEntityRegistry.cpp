@@ -0,0 +1,179 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <set>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/EntityRegistry.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/// Returns 0 if every item of the slots is found at its own position
+template <typename T>
+int checkSlots(const simData::EntitySlots<T>& slots)
+{
+  int rv = 0;
+  for (auto it = slots.begin(); it != slots.end(); ++it)
+    rv += SDK_ASSERT(slots.find(it->first) == it);
+  return rv;
+}
+
+int testSlots()
+{
+  int rv = 0;
+  simData::EntityRegistry registry;
+  simData::EntitySlots<int> platforms(registry, simData::EntityRegistry::ENTITY, simData::PLATFORM);
+  simData::EntitySlots<int> beams(registry, simData::EntityRegistry::ENTITY, simData::BEAM);
+  simData::EntitySlots<int> generic(registry, simData::EntityRegistry::GENERIC_DATA);
+
+  for (int id = 1; id <= 10; ++id)
+  {
+    platforms[id] = id * 10;
+    generic[id] = id * 100;
+  }
+  beams[20] = 200;
+  generic[0] = 1;
+  rv += SDK_ASSERT(platforms.size() == 10);
+  rv += SDK_ASSERT(beams.size() == 1);
+  rv += SDK_ASSERT(generic.size() == 11);
+  rv += SDK_ASSERT(registry.size() == 12);
+
+  // Types come from the ENTITY column only
+  rv += SDK_ASSERT(registry.type(3) == simData::PLATFORM);
+  rv += SDK_ASSERT(registry.type(20) == simData::BEAM);
+  rv += SDK_ASSERT(registry.type(0) == simData::NONE);
+  rv += SDK_ASSERT(registry.type(99) == simData::NONE);
+
+  // Lookups are limited to the container's type
+  rv += SDK_ASSERT(platforms.find(20) == platforms.end());
+  rv += SDK_ASSERT(beams.find(3) == beams.end());
+  rv += SDK_ASSERT(beams.find(20)->second == 200);
+  rv += SDK_ASSERT(platforms.find(3)->second == 30);
+  rv += SDK_ASSERT(generic.find(3)->second == 300);
+  rv += SDK_ASSERT(generic.find(20) == generic.end());
+  rv += SDK_ASSERT(registry.slot(3, simData::EntityRegistry::ENTITY, simData::BEAM) == simData::EntityRegistry::NO_SLOT);
+  rv += SDK_ASSERT(registry.slot(3, simData::EntityRegistry::ENTITY, simData::PLATFORM) != simData::EntityRegistry::NO_SLOT);
+
+  // Removal moves the last item into the freed slot
+  rv += SDK_ASSERT(platforms.erase(1) == 1);
+  rv += SDK_ASSERT(platforms.erase(1) == 0);
+  platforms.erase(platforms.find(5));
+  rv += SDK_ASSERT(platforms.size() == 8);
+  rv += SDK_ASSERT(checkSlots(platforms) == 0);
+  for (int id = 2; id <= 10; ++id)
+  {
+    if (id != 5)
+      rv += SDK_ASSERT(platforms.find(id)->second == id * 10);
+  }
+
+  // The ID stays registered while another column holds it
+  rv += SDK_ASSERT(registry.type(1) == simData::NONE);
+  rv += SDK_ASSERT(generic.find(1)->second == 100);
+  rv += SDK_ASSERT(registry.size() == 12);
+  generic.erase(1);
+  rv += SDK_ASSERT(registry.size() == 11);
+
+  // Clearing one container leaves the others
+  platforms.clear();
+  rv += SDK_ASSERT(platforms.empty());
+  rv += SDK_ASSERT(registry.type(3) == simData::NONE);
+  rv += SDK_ASSERT(generic.find(3)->second == 300);
+  rv += SDK_ASSERT(beams.find(20)->second == 200);
+  rv += SDK_ASSERT(checkSlots(generic) == 0);
+  generic.clear();
+  beams.clear();
+  rv += SDK_ASSERT(registry.size() == 0);
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  std::vector<uint64_t> platforms;
+  std::vector<uint64_t> beams;
+  for (int ii = 0; ii < 20; ++ii)
+  {
+    platforms.push_back(helper.addPlatform());
+    beams.push_back(helper.addBeam(platforms.back()));
+  }
+  const uint64_t gate = helper.addGate(beams[3]);
+  rv += SDK_ASSERT(ds.objectType(platforms[0]) == simData::PLATFORM);
+  rv += SDK_ASSERT(ds.objectType(beams[0]) == simData::BEAM);
+  rv += SDK_ASSERT(ds.objectType(gate) == simData::GATE);
+  rv += SDK_ASSERT(ds.objectType(0) == simData::NONE);
+  rv += SDK_ASSERT(ds.idCount(simData::PLATFORM) == 20);
+  rv += SDK_ASSERT(ds.idCount() == 41);
+
+  // Remove platforms from the middle, taking their beams and the gate with them
+  ds.removeEntity(platforms[3]);
+  ds.removeEntity(platforms[0]);
+  rv += SDK_ASSERT(ds.objectType(platforms[3]) == simData::NONE);
+  rv += SDK_ASSERT(ds.objectType(beams[3]) == simData::NONE);
+  rv += SDK_ASSERT(ds.objectType(gate) == simData::NONE);
+  rv += SDK_ASSERT(ds.idCount() == 36);
+
+  // Every survivor is still found with the right properties and generic data
+  simData::DataStore::IdList ids;
+  ds.idList(&ids);
+  rv += SDK_ASSERT(ids.size() == 36);
+  rv += SDK_ASSERT(std::set<uint64_t>(ids.begin(), ids.end()).size() == ids.size());
+  for (uint64_t id : ids)
+  {
+    simData::DataStore::Transaction txn;
+    if (ds.objectType(id) == simData::PLATFORM)
+    {
+      const auto* props = ds.platformProperties(id, &txn);
+      rv += SDK_ASSERT(props != nullptr && props->id() == id);
+    }
+    else
+    {
+      const auto* props = ds.beamProperties(id, &txn);
+      rv += SDK_ASSERT(props != nullptr && props->id() == id);
+      rv += SDK_ASSERT(ds.objectType(props->hostid()) == simData::PLATFORM);
+    }
+    rv += SDK_ASSERT(ds.genericDataSlice(id) != nullptr);
+    rv += SDK_ASSERT(ds.categoryDataSlice(id) != nullptr);
+  }
+  rv += SDK_ASSERT(ds.genericDataSlice(0) != nullptr);
+  rv += SDK_ASSERT(ds.genericDataSlice(platforms[3]) == nullptr);
+
+  ds.clear();
+  rv += SDK_ASSERT(ds.idCount() == 0);
+  rv += SDK_ASSERT(ds.objectType(platforms[5]) == simData::NONE);
+  return rv;
+}
+
+}
+
+int TestEntityRegistry(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testSlots() == 0);
+  rv += SDK_ASSERT(testDataStore() == 0);
+  return rv;
+}
@@ -21,8 +21,12 @@
  *
  */
 
+#include <sstream>
+#include <string>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simData/MemoryDataStore.h"
+#include "simData/MemoryGenericDataSlice.h"
 #include "simUtil/DataStoreTestHelper.h"
 
 namespace
@@ -427,6 +431,120 @@ void test_5743()
   gdslice->visit(&sc);
 }
 
+/// Collects every entry of a generic data slice as "time key value" lines
+struct GenericDataCollector : public simData::GenericDataSlice::Visitor
+{
+  std::vector<std::string> entries;
+  virtual void operator()(const simData::GenericData *update)
+  {
+    for (int k = 0; k < update->entry_size(); ++k)
+    {
+      std::stringstream s;
+      s << update->time() << " " << update->entry(k).key() << " " << update->entry(k).value();
+      entries.push_back(s.str());
+    }
+  }
+};
+
+/// Returns all the entries of the entity's generic data
+std::vector<std::string> allEntries(const simData::DataStore& ds, uint64_t id)
+{
+  GenericDataCollector collector;
+  ds.genericDataSlice(id)->visit(&collector);
+  return collector.entries;
+}
+
+/// Returns the current entries of the entity's generic data
+std::vector<std::string> currentEntries(const simData::DataStore& ds, uint64_t id)
+{
+  std::vector<std::string> rv;
+  const simData::GenericData* current = ds.genericDataSlice(id)->current();
+  for (int k = 0; k < current->entry_size(); ++k)
+    rv.push_back(current->entry(k).key() + " " + current->entry(k).value());
+  return rv;
+}
+
+int test_stringPooling()
+{
+  int rv = 0;
+
+  // Same data into a data store with and without pooling must give the same results
+  simUtil::DataStoreTestHelper helpers[2];
+  uint64_t ids[2];
+  for (int k = 0; k < 2; ++k)
+  {
+    simData::MemoryDataStore* ds = dynamic_cast<simData::MemoryDataStore*>(helpers[k].dataStore());
+    rv += SDK_ASSERT(ds != nullptr);
+    if (ds == nullptr)
+      return rv;
+    ds->setGenericDataStringPooling(k == 1);
+    ds->setDataLimiting(true);
+    setIgnoreDupeGD_(*ds, false);
+    ids[k] = helpers[k].addPlatform();
+    simData::PlatformPrefs prefs;
+    prefs.mutable_commonprefs()->set_datalimitpoints(40);
+    helpers[k].updatePlatformPrefs(prefs, ids[k]);
+  }
+  simData::MemoryDataStore* pooled = dynamic_cast<simData::MemoryDataStore*>(helpers[1].dataStore());
+  rv += SDK_ASSERT(pooled->genericDataStringPooling());
+
+  for (int ii = 0; ii < 400; ++ii)
+  {
+    const double time = ii;
+    for (int k = 0; k < 2; ++k)
+    {
+      // Mix of repeating, rarely repeating and unique values, with an occasional out of order time
+      helpers[k].addGenericData(ids[k], "Repeat", (ii % 3 == 0) ? "a" : "b", time);
+      helpers[k].addGenericData(ids[k], "Rare", "value" + std::to_string(ii % 17), time);
+      helpers[k].addGenericData(ids[k], "Unique", "unique" + std::to_string(ii), (ii % 10 == 5) ? time - 3.5 : time);
+      if (ii % 50 == 49)
+        helpers[k].dataStore()->flush(ids[k], simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_GENERIC_DATA, time - 20.0, time - 10.0);
+      helpers[k].dataStore()->update(time - 2.0);
+    }
+    rv += SDK_ASSERT(currentEntries(*helpers[0].dataStore(), ids[0]) == currentEntries(*helpers[1].dataStore(), ids[1]));
+    if (ii % 25 == 0)
+      rv += SDK_ASSERT(allEntries(*helpers[0].dataStore(), ids[0]) == allEntries(*helpers[1].dataStore(), ids[1]));
+  }
+  rv += SDK_ASSERT(helpers[1].dataStore()->genericDataSlice(ids[1])->numItems() == helpers[0].dataStore()->genericDataSlice(ids[0])->numItems());
+
+  // Values repeated by another entity are stored once, in the pool shared by the data store
+  const uint64_t otherId = helpers[1].addPlatform();
+  const simData::MemoryGenericDataSlice* otherSlice = dynamic_cast<const simData::MemoryGenericDataSlice*>(pooled->genericDataSlice(otherId));
+  rv += SDK_ASSERT(otherSlice != nullptr && otherSlice->stringPool() != nullptr);
+  rv += SDK_ASSERT(otherSlice != nullptr && otherSlice->stringPool() == dynamic_cast<const simData::MemoryGenericDataSlice*>(pooled->genericDataSlice(ids[1]))->stringPool());
+  const size_t poolUsage = pooled->genericDataStringPoolMemoryUsage();
+  rv += SDK_ASSERT(poolUsage > 0);
+  for (int ii = 0; ii < 17; ++ii)
+    helpers[1].addGenericData(otherId, "Rare", "value" + std::to_string(ii), ii);
+  rv += SDK_ASSERT(pooled->genericDataStringPoolMemoryUsage() == poolUsage);
+  rv += SDK_ASSERT(pooled->genericDataMemoryUsage(otherId) > 0);
+
+  // Limiting reclaims pooled values, so memory use stays bounded as unique values stream in
+  const size_t usage = pooled->genericDataMemoryUsage(ids[1]);
+  rv += SDK_ASSERT(usage > 0);
+  for (int ii = 400; ii < 4000; ++ii)
+    helpers[1].addGenericData(ids[1], "Unique", "unique value number " + std::to_string(ii), ii);
+  rv += SDK_ASSERT(pooled->genericDataMemoryUsage(ids[1]) < 2 * usage);
+  rv += SDK_ASSERT(pooled->genericDataMemoryUsage(0) > 0);
+  rv += SDK_ASSERT(pooled->genericDataMemoryUsage(12345) == 0);
+
+  // Converting keeps the data, in either direction
+  const std::vector<std::string> before = allEntries(*pooled, ids[1]);
+  pooled->setGenericDataStringPooling(false);
+  rv += SDK_ASSERT(allEntries(*pooled, ids[1]) == before);
+  pooled->setGenericDataStringPooling(true);
+  rv += SDK_ASSERT(allEntries(*pooled, ids[1]) == before);
+
+  // Removing a tag and flushing release the pooled values
+  const simData::MemoryGenericDataSlice* slice = dynamic_cast<const simData::MemoryGenericDataSlice*>(pooled->genericDataSlice(ids[1]));
+  rv += SDK_ASSERT(slice != nullptr && slice->stringPooling());
+  rv += SDK_ASSERT(pooled->removeGenericDataTag(ids[1], "Unique") == 0);
+  rv += SDK_ASSERT(pooled->flush(ids[1], simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_GENERIC_DATA) == 0);
+  rv += SDK_ASSERT(slice->numItems() == 0);
+  rv += SDK_ASSERT(pooled->genericDataMemoryUsage(ids[1]) < usage);
+  return rv;
+}
+
 void testPerformance()
 {
   testPerformanceRepeating();
@@ -448,6 +566,7 @@ int TestGenericData(int argc, char *argv[])
   rv += test_limitTime();
   rv += test_Sim4722_CurrentGenData();
   rv += test_ignoreDuplicates();
+  rv += test_stringPooling();
   test_5743();
 
   // The performance tests are not part of the commit, since they take time and don't generate
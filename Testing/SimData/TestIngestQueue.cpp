@@ -0,0 +1,244 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <map>
+#include <thread>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/IngestQueue.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/// Counts the new update notifications per entity
+class CountNewUpdates : public simData::DataStore::DefaultNewUpdatesListener
+{
+public:
+  virtual void onEntityUpdate(simData::DataStore* source, simData::ObjectId id, double dataTime) override
+  {
+    ++counts[id];
+    lastTimes[id] = dataTime;
+  }
+
+  std::map<simData::ObjectId, int> counts;
+  std::map<simData::ObjectId, double> lastTimes;
+};
+
+simData::PlatformUpdate makePlatformUpdate(double time)
+{
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  update.set_x(6378137.0);
+  update.set_y(time);
+  update.set_z(0.0);
+  return update;
+}
+
+int testQueue()
+{
+  int rv = 0;
+
+  simData::IngestQueue queue(5);
+  rv += SDK_ASSERT(queue.statistics().capacity == 8);
+
+  // Fill the queue, and the next push is dropped
+  for (int ii = 0; ii < 8; ++ii)
+    rv += SDK_ASSERT(queue.pushPlatformUpdate(1, makePlatformUpdate(ii)));
+  rv += SDK_ASSERT(!queue.pushPlatformUpdate(1, makePlatformUpdate(8.0)));
+
+  simData::IngestQueue::Statistics stats = queue.statistics();
+  rv += SDK_ASSERT(stats.depth == 8);
+  rv += SDK_ASSERT(stats.pushed == 8);
+  rv += SDK_ASSERT(stats.dropped == 1);
+
+  // Drains in push order
+  std::vector<double> times;
+  rv += SDK_ASSERT(queue.drain([&times](simData::IngestQueue::Item& item) {
+    auto* update = std::get_if<std::unique_ptr<simData::PlatformUpdate> >(&item.data);
+    if (update)
+      times.push_back((*update)->time());
+  }) == 8);
+  rv += SDK_ASSERT(times.size() == 8);
+  for (size_t ii = 0; ii < times.size(); ++ii)
+    rv += SDK_ASSERT(times[ii] == static_cast<double>(ii));
+
+  stats = queue.statistics();
+  rv += SDK_ASSERT(stats.depth == 0);
+  rv += SDK_ASSERT(stats.drained == 8);
+  rv += SDK_ASSERT(stats.lastDrainCount == 8);
+
+  // Space is available again after the drain, across the wrap of the ring
+  for (int ii = 0; ii < 6; ++ii)
+    rv += SDK_ASSERT(queue.pushBeamUpdate(2, simData::BeamUpdate()));
+  rv += SDK_ASSERT(queue.drain([](simData::IngestQueue::Item&) {}) == 6);
+  rv += SDK_ASSERT(queue.drain([](simData::IngestQueue::Item&) {}) == 0);
+
+  return rv;
+}
+
+int testProducerThreads()
+{
+  int rv = 0;
+
+  simData::IngestQueue queue(1024);
+  const int numThreads = 4;
+  const int perThread = 5000;
+  std::vector<std::thread> producers;
+  for (int thread = 0; thread < numThreads; ++thread)
+  {
+    producers.push_back(std::thread([&queue, thread, perThread]() {
+      for (int ii = 0; ii < perThread; ++ii)
+      {
+        // Retry until accepted so that every item arrives
+        while (!queue.pushPlatformUpdate(thread + 1, makePlatformUpdate(ii)))
+          std::this_thread::yield();
+      }
+    }));
+  }
+
+  // Consume while the producers run, checking that each producer's items arrive in order
+  std::map<simData::ObjectId, double> lastTimes;
+  int received = 0;
+  bool inOrder = true;
+  while (received < numThreads * perThread)
+  {
+    received += static_cast<int>(queue.drain([&](simData::IngestQueue::Item& item) {
+      const double time = (*std::get<std::unique_ptr<simData::PlatformUpdate> >(item.data)).time();
+      auto it = lastTimes.find(item.id);
+      if (it != lastTimes.end() && it->second >= time)
+        inOrder = false;
+      lastTimes[item.id] = time;
+    }));
+  }
+  for (auto& producer : producers)
+    producer.join();
+
+  rv += SDK_ASSERT(inOrder);
+  rv += SDK_ASSERT(received == numThreads * perThread);
+  const simData::IngestQueue::Statistics stats = queue.statistics();
+  rv += SDK_ASSERT(stats.pushed == static_cast<uint64_t>(numThreads * perThread));
+  rv += SDK_ASSERT(stats.drained == stats.pushed);
+  rv += SDK_ASSERT(stats.depth == 0);
+
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+
+  rv += SDK_ASSERT(ds.ingestQueue() == nullptr);
+  ds.setIngestQueueCapacity(100);
+  std::shared_ptr<simData::IngestQueue> queue = ds.ingestQueue();
+  rv += SDK_ASSERT(queue != nullptr);
+  if (!queue)
+    return rv;
+
+  auto listener = std::make_shared<CountNewUpdates>();
+  ds.addNewUpdatesListener(listener);
+
+  std::thread producer([&]() {
+    for (int ii = 0; ii < 10; ++ii)
+    {
+      queue->pushPlatformUpdate(platId, makePlatformUpdate(ii));
+      simData::BeamUpdate beam;
+      beam.set_time(ii);
+      beam.set_range(100.0);
+      queue->pushBeamUpdate(beamId, beam);
+      simData::GateUpdate gate;
+      gate.set_time(ii);
+      gate.set_minrange(10.0);
+      gate.set_maxrange(20.0);
+      queue->pushGateUpdate(gateId, gate);
+    }
+    simData::CategoryData category;
+    category.set_time(0.0);
+    simData::CategoryData::Entry* entry = category.add_entry();
+    entry->set_key("Key");
+    entry->set_value("Value");
+    queue->pushCategoryData(platId, category);
+    simData::GenericData generic;
+    generic.set_time(0.0);
+    simData::GenericData::Entry* genericEntry = generic.add_entry();
+    genericEntry->set_key("Key");
+    genericEntry->set_value("Value");
+    queue->pushGenericData(platId, generic);
+    // Unknown entity is discarded
+    queue->pushPlatformUpdate(1000, makePlatformUpdate(0.0));
+  });
+  producer.join();
+
+  // Nothing is committed until the update
+  rv += SDK_ASSERT(ds.platformUpdateSlice(platId)->numItems() == 0);
+  rv += SDK_ASSERT(listener->counts.empty());
+
+  ds.update(5.0);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(platId)->numItems() == 10);
+  rv += SDK_ASSERT(ds.beamUpdateSlice(beamId)->numItems() == 10);
+  rv += SDK_ASSERT(ds.gateUpdateSlice(gateId)->numItems() == 10);
+  rv += SDK_ASSERT(ds.categoryDataSlice(platId)->current().hasNext());
+  rv += SDK_ASSERT(ds.genericDataSlice(platId)->numItems() == 1);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(platId)->current() != nullptr && ds.platformUpdateSlice(platId)->current()->time() == 5.0);
+
+  // One notification per entity, with the latest time
+  rv += SDK_ASSERT(listener->counts.size() == 3);
+  rv += SDK_ASSERT(listener->counts[platId] == 1);
+  rv += SDK_ASSERT(listener->counts[beamId] == 1);
+  rv += SDK_ASSERT(listener->counts[gateId] == 1);
+  rv += SDK_ASSERT(listener->lastTimes[platId] == 9.0);
+
+  const simData::IngestQueue::Statistics stats = queue->statistics();
+  rv += SDK_ASSERT(stats.drained == 33);
+  rv += SDK_ASSERT(stats.dropped == 0);
+  rv += SDK_ASSERT(stats.lastDrainSeconds >= 0.0);
+
+  // Updates made directly through transactions still notify immediately
+  helper.addPlatformUpdate(20.0, platId);
+  rv += SDK_ASSERT(listener->counts[platId] == 2);
+
+  ds.removeNewUpdatesListener(listener);
+  ds.setIngestQueueCapacity(0);
+  rv += SDK_ASSERT(ds.ingestQueue() == nullptr);
+
+  return rv;
+}
+
+}
+
+int TestIngestQueue(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testQueue();
+  rv += testProducerThreads();
+  rv += testDataStore();
+
+  return rv;
+}
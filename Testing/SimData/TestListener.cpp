@@ -21,6 +21,9 @@
  *
  */
 
+#include <memory>
+#include <string>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simData/MemoryDataStore.h"
 #include "simUtil/DataStoreTestHelper.h"
@@ -836,6 +839,103 @@ int testMultipleRemoval()
   return rv;
 }
 
+/// Records the change sets of a batch listener
+class BatchRecorder : public simData::DataStore::BatchListener
+{
+public:
+  virtual void onChanges(simData::DataStore* source, const simData::DataStore::ChangeSet& changes) override
+  {
+    batches.push_back(changes);
+  }
+
+  std::vector<simData::DataStore::ChangeSet> batches;
+};
+
+/// Sets the name of the entity
+void setName(simData::DataStore* ds, uint64_t id, const std::string& name)
+{
+  simData::DataStore::Transaction txn;
+  simData::CommonPrefs* prefs = ds->mutable_commonPrefs(id, &txn);
+  prefs->set_name(name);
+  txn.complete(&prefs);
+}
+
+int testBatchListener()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore* ds = testHelper.dataStore();
+
+  auto recorder = std::make_shared<BatchRecorder>();
+  ds->addBatchListener(recorder);
+  typedef simData::DataStore::IdList IdList;
+
+  // Adds, with the name and prefs changes that come with them, arrive as one sorted list
+  const uint64_t plat1 = testHelper.addPlatform();
+  const uint64_t plat2 = testHelper.addPlatform();
+  const uint64_t beam = testHelper.addBeam(plat1);
+  const uint64_t shortLived = testHelper.addPlatform();
+  setName(ds, plat2, "Two");
+  ds->removeEntity(shortLived);
+  ds->update(1.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 1);
+  const simData::DataStore::ChangeSet& first = recorder->batches.back();
+  rv += SDK_ASSERT(first.added == IdList({ plat1, plat2, beam }));
+  rv += SDK_ASSERT(first.removed.empty());
+  rv += SDK_ASSERT(first.prefs.empty());
+  rv += SDK_ASSERT(first.names.empty());
+  rv += SDK_ASSERT(!first.scenarioDeleted);
+
+  // Repeated changes to the same entities are consolidated
+  for (int ii = 0; ii < 10; ++ii)
+  {
+    setName(ds, plat1, (ii % 2) ? "A" : "B");
+    setName(ds, beam, (ii % 2) ? "C" : "D");
+  }
+  testHelper.addCategoryData(plat2, "Key", "Value", 0.0);
+  ds->update(2.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 2);
+  const simData::DataStore::ChangeSet& second = recorder->batches.back();
+  rv += SDK_ASSERT(second.added.empty());
+  rv += SDK_ASSERT(second.prefs == IdList({ plat1, beam }));
+  rv += SDK_ASSERT(second.names == IdList({ plat1, beam }));
+  rv += SDK_ASSERT(second.categoryData == IdList({ plat2 }));
+
+  // Removal hides the other changes of the entity; removing a platform removes its beam
+  setName(ds, plat1, "E");
+  ds->flush(plat2);
+  ds->removeEntity(plat1);
+  ds->update(3.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 3);
+  const simData::DataStore::ChangeSet& third = recorder->batches.back();
+  rv += SDK_ASSERT(third.removed == IdList({ plat1, beam }));
+  rv += SDK_ASSERT(third.prefs.empty());
+  rv += SDK_ASSERT(third.names.empty());
+  rv += SDK_ASSERT(third.flushed == IdList({ plat2 }));
+
+  // A time change alone still delivers an empty change set, in place of onChange()
+  ds->update(4.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 4);
+  rv += SDK_ASSERT(recorder->batches.back().empty());
+  // No time or data change means no update
+  ds->update(4.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 4);
+
+  ds->clear();
+  ds->update(5.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 5);
+  rv += SDK_ASSERT(recorder->batches.back().scenarioDeleted);
+  rv += SDK_ASSERT(recorder->batches.back().removed == IdList({ plat2 }));
+
+  // Nothing is delivered after removal
+  ds->removeBatchListener(recorder);
+  testHelper.addPlatform();
+  ds->update(6.0);
+  rv += SDK_ASSERT(recorder->batches.size() == 5);
+
+  return rv;
+}
+
 }
 
 int TestListener(int argc, char* argv[])
@@ -851,6 +951,7 @@ int TestListener(int argc, char* argv[])
   rv += testFlush();
   rv += testScenarioDelete();
   rv += testMultipleRemoval();
+  rv += testBatchListener();
 
   return rv;
 }
@@ -0,0 +1,258 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/// Records the thread that made each onChange callback
+class ThreadListener : public simData::DataStore::DefaultListener
+{
+public:
+  virtual void onChange(simData::DataStore* source) override
+  {
+    if (std::this_thread::get_id() != mainThread)
+      ++otherThreadCalls;
+    ++calls;
+  }
+
+  std::thread::id mainThread = std::this_thread::get_id();
+  int calls = 0;
+  int otherThreadCalls = 0;
+};
+
+/// Linear interpolator that counts its calls without locking, like a typical stateful interpolator
+class ThreadInterpolator : public simData::LinearInterpolator
+{
+public:
+  virtual bool interpolate(double time, const simData::PlatformUpdate& prev, const simData::PlatformUpdate& next, simData::PlatformUpdate* result) override
+  {
+    record_();
+    return LinearInterpolator::interpolate(time, prev, next, result);
+  }
+  virtual bool interpolate(double time, const simData::BeamUpdate& prev, const simData::BeamUpdate& next, simData::BeamUpdate* result) override
+  {
+    record_();
+    return LinearInterpolator::interpolate(time, prev, next, result);
+  }
+  virtual bool interpolate(double time, const simData::GateUpdate& prev, const simData::GateUpdate& next, simData::GateUpdate* result) override
+  {
+    record_();
+    return LinearInterpolator::interpolate(time, prev, next, result);
+  }
+  virtual bool interpolate(double time, const simData::LaserUpdate& prev, const simData::LaserUpdate& next, simData::LaserUpdate* result) override
+  {
+    record_();
+    return LinearInterpolator::interpolate(time, prev, next, result);
+  }
+  virtual bool interpolate(double time, const simData::ProjectorUpdate& prev, const simData::ProjectorUpdate& next, simData::ProjectorUpdate* result) override
+  {
+    record_();
+    return LinearInterpolator::interpolate(time, prev, next, result);
+  }
+
+  std::thread::id mainThread = std::this_thread::get_id();
+  int calls = 0;
+  int otherThreadCalls = 0;
+
+private:
+  void record_()
+  {
+    if (std::this_thread::get_id() != mainThread)
+      ++otherThreadCalls;
+    ++calls;
+  }
+};
+
+/// Fills the data store with enough entities to be split between threads
+void fillDataStore(simData::MemoryDataStore& ds, std::vector<uint64_t>& ids)
+{
+  simUtil::DataStoreTestHelper helper(&ds);
+  uint64_t previousPlatform = 0;
+  for (int ii = 0; ii < 300; ++ii)
+  {
+    const uint64_t platId = helper.addPlatform();
+    ids.push_back(platId);
+    for (int time = 0; time < 20; ++time)
+      helper.addPlatformUpdate(time + ii * 0.01, platId);
+
+    const uint64_t beamId = helper.addBeam(platId);
+    ids.push_back(beamId);
+    for (int time = 0; time < 20; ++time)
+      helper.addBeamUpdate(time, beamId);
+
+    const uint64_t gateId = helper.addGate(beamId);
+    ids.push_back(gateId);
+    for (int time = 0; time < 20; ++time)
+      helper.addGateUpdate(time, gateId);
+
+    const uint64_t laserId = helper.addLaser(platId);
+    ids.push_back(laserId);
+    for (int time = 0; time < 20; ++time)
+      helper.addLaserUpdate(time, laserId);
+
+    // Target beams depend on the current position of two platforms
+    if (previousPlatform != 0)
+    {
+      const uint64_t targetBeamId = helper.addBeam(platId, 0, true);
+      ids.push_back(targetBeamId);
+      simData::BeamPrefs prefs;
+      prefs.set_targetid(previousPlatform);
+      helper.updateBeamPrefs(prefs, targetBeamId);
+    }
+    previousPlatform = platId;
+  }
+}
+
+/// Returns the time of the current update, or -2 if there is no current update
+template <typename SliceType>
+double currentTime(const SliceType* slice)
+{
+  if ((slice == nullptr) || (slice->current() == nullptr))
+    return -2.0;
+  return slice->current()->time();
+}
+
+int compareDataStores(simData::MemoryDataStore& serial, simData::MemoryDataStore& parallel, const std::vector<uint64_t>& ids)
+{
+  int rv = 0;
+  for (auto id : ids)
+  {
+    switch (serial.objectType(id))
+    {
+    case simData::PLATFORM:
+    {
+      const auto* lhs = serial.platformUpdateSlice(id);
+      const auto* rhs = parallel.platformUpdateSlice(id);
+      rv += SDK_ASSERT(currentTime(lhs) == currentTime(rhs));
+      if (lhs->current() && rhs->current())
+        rv += SDK_ASSERT(lhs->current()->x() == rhs->current()->x());
+      rv += SDK_ASSERT(lhs->hasChanged() == rhs->hasChanged());
+      break;
+    }
+    case simData::BEAM:
+      rv += SDK_ASSERT(currentTime(serial.beamUpdateSlice(id)) == currentTime(parallel.beamUpdateSlice(id)));
+      rv += SDK_ASSERT(serial.beamUpdateSlice(id)->hasChanged() == parallel.beamUpdateSlice(id)->hasChanged());
+      break;
+    case simData::GATE:
+      rv += SDK_ASSERT(currentTime(serial.gateUpdateSlice(id)) == currentTime(parallel.gateUpdateSlice(id)));
+      break;
+    case simData::LASER:
+      rv += SDK_ASSERT(currentTime(serial.laserUpdateSlice(id)) == currentTime(parallel.laserUpdateSlice(id)));
+      break;
+    default:
+      rv += SDK_ASSERT(0);
+      break;
+    }
+  }
+  return rv;
+}
+
+int testParallelMatchesSerial()
+{
+  int rv = 0;
+
+  simData::LinearInterpolator interpolator;
+  ThreadInterpolator parallelInterpolator;
+  simData::MemoryDataStore serial;
+  simData::MemoryDataStore parallel;
+  parallel.setUpdateThreads(4);
+  rv += SDK_ASSERT(parallel.updateThreads() == 4);
+  rv += SDK_ASSERT(serial.updateThreads() == 1);
+
+  std::vector<uint64_t> serialIds;
+  std::vector<uint64_t> parallelIds;
+  fillDataStore(serial, serialIds);
+  fillDataStore(parallel, parallelIds);
+  rv += SDK_ASSERT(serialIds == parallelIds);
+
+  // Time range monitors are callbacks, so they need to come from this thread
+  std::atomic<int> otherThreadMonitors(0);
+  const std::thread::id mainThread = std::this_thread::get_id();
+  for (auto id : parallelIds)
+  {
+    if (parallel.objectType(id) != simData::PLATFORM)
+      continue;
+    parallel.installSliceTimeRangeMonitor(id, [&](double, double) {
+      if (std::this_thread::get_id() != mainThread)
+        ++otherThreadMonitors;
+    });
+  }
+
+  auto listener = std::make_shared<ThreadListener>();
+  parallel.addListener(listener);
+
+  for (double time = -1.0; time < 22.0; time += 0.3)
+  {
+    serial.update(time);
+    parallel.update(time);
+    rv += compareDataStores(serial, parallel, serialIds);
+  }
+
+  serial.setInterpolator(&interpolator);
+  serial.enableInterpolation(true);
+  parallel.setInterpolator(&parallelInterpolator);
+  parallel.enableInterpolation(true);
+  for (double time = 22.0; time > -1.0; time -= 0.7)
+  {
+    serial.update(time);
+    parallel.update(time);
+    rv += compareDataStores(serial, parallel, serialIds);
+  }
+
+  rv += SDK_ASSERT(listener->calls > 0);
+  rv += SDK_ASSERT(listener->otherThreadCalls == 0);
+  rv += SDK_ASSERT(otherThreadMonitors == 0);
+  // The Interpolator need not be thread safe, so it is only called from this thread
+  rv += SDK_ASSERT(parallelInterpolator.calls > 0);
+  rv += SDK_ASSERT(parallelInterpolator.otherThreadCalls == 0);
+
+  // Back to serial
+  parallel.setUpdateThreads(0);
+  rv += SDK_ASSERT(parallel.updateThreads() == 1);
+  serial.update(5.5);
+  parallel.update(5.5);
+  rv += compareDataStores(serial, parallel, serialIds);
+
+  parallel.removeListener(listener);
+  serial.setInterpolator(nullptr);
+  parallel.setInterpolator(nullptr);
+  return rv;
+}
+
+}
+
+int TestParallelUpdate(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testParallelMatchesSerial();
+
+  return rv;
+}
@@ -0,0 +1,229 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <random>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/NearestNeighborInterpolator.h"
+#include "simData/PlatformBatchInterpolator.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Holds the output arrays of a PlatformBatchInterpolator */
+struct Arrays
+{
+  explicit Arrays(size_t size)
+    : x(size), y(size), z(size), psi(size), theta(size), phi(size), vx(size), vy(size), vz(size), flags(size)
+  {
+    output.x = x.data();
+    output.y = y.data();
+    output.z = z.data();
+    output.psi = psi.data();
+    output.theta = theta.data();
+    output.phi = phi.data();
+    output.vx = vx.data();
+    output.vy = vy.data();
+    output.vz = vz.data();
+    output.flags = flags.data();
+  }
+
+  std::vector<double> x, y, z, psi, theta, phi, vx, vy, vz;
+  std::vector<uint8_t> flags;
+  simData::PlatformBatchInterpolator::Output output;
+};
+
+/** Returns true if the values are within the tolerance */
+bool near(double lhs, double rhs, double tolerance)
+{
+  return std::abs(lhs - rhs) <= tolerance;
+}
+
+/** Compares the batch results against the current updates of the data store after DataStore::update() */
+int compare(const simData::DataStore& ds, const std::vector<uint64_t>& ids, const Arrays& arrays)
+{
+  int rv = 0;
+  for (size_t ii = 0; ii < ids.size(); ++ii)
+  {
+    const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(ids[ii]);
+    const simData::PlatformUpdate* current = (slice != nullptr) ? slice->current() : nullptr;
+    // The data store hides platforms after their last update per their life span; the batch keeps the last update
+    if ((current == nullptr) && (slice != nullptr) && (slice->numItems() > 0) && (ds.updateTime() > slice->lastTime()))
+      current = slice->upper_bound(ds.updateTime()).peekPrevious();
+    const uint8_t flags = arrays.flags[ii];
+    rv += SDK_ASSERT((current != nullptr) == ((flags & simData::PlatformBatchInterpolator::HAS_POSITION) != 0));
+    if (current == nullptr)
+      continue;
+    rv += SDK_ASSERT(slice->isInterpolated() == ((flags & simData::PlatformBatchInterpolator::INTERPOLATED) != 0) || (slice->current() == nullptr));
+
+    // The data store keeps angles and velocities as floats
+    rv += SDK_ASSERT(near(arrays.x[ii], current->x(), 1e-6));
+    rv += SDK_ASSERT(near(arrays.y[ii], current->y(), 1e-6));
+    rv += SDK_ASSERT(near(arrays.z[ii], current->z(), 1e-6));
+    const bool orientation = (flags & simData::PlatformBatchInterpolator::HAS_ORIENTATION) != 0;
+    // An interpolated update of the data store keeps stale angles and velocities when a bound lacks them
+    const bool interpolated = (flags & simData::PlatformBatchInterpolator::INTERPOLATED) != 0;
+    rv += SDK_ASSERT(orientation ? current->has_orientation() : (interpolated || !current->has_orientation()));
+    if (orientation)
+    {
+      rv += SDK_ASSERT(!arrays.output.psi || near(arrays.psi[ii], current->psi(), 1e-6));
+      rv += SDK_ASSERT(near(arrays.theta[ii], current->theta(), 1e-6));
+      rv += SDK_ASSERT(near(arrays.phi[ii], current->phi(), 1e-6));
+    }
+    const bool velocity = (flags & simData::PlatformBatchInterpolator::HAS_VELOCITY) != 0;
+    rv += SDK_ASSERT(velocity ? current->has_velocity() : (interpolated || !current->has_velocity()));
+    if (velocity)
+    {
+      rv += SDK_ASSERT(!arrays.output.vx || near(arrays.vx[ii], current->vx(), 1e-3));
+      rv += SDK_ASSERT(near(arrays.vy[ii], current->vy(), 1e-3));
+      rv += SDK_ASSERT(near(arrays.vz[ii], current->vz(), 1e-3));
+    }
+  }
+  return rv;
+}
+
+/** Fills the data store with platforms all over the earth, with angles that wrap between updates */
+std::vector<uint64_t> addPlatforms(simData::MemoryDataStore& ds, std::mt19937& random)
+{
+  simUtil::DataStoreTestHelper helper(&ds);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::vector<uint64_t> ids;
+  for (size_t ii = 0; ii < 200; ++ii)
+  {
+    ids.push_back(helper.addPlatform());
+    std::vector<simData::PlatformUpdate> updates;
+    const size_t count = (ii == 0) ? 0 : ((ii == 1) ? 1 : 20);
+    const double lat = angle(random) / 2.0;
+    const double lon = angle(random);
+    for (size_t jj = 0; jj < count; ++jj)
+    {
+      simData::PlatformUpdate update;
+      update.set_time(static_cast<double>(jj) * 10.0 + static_cast<double>(ii % 7));
+      const double radius = 6378137.0 + 10000.0 * unit(random);
+      update.set_x(radius * cos(lat + jj * 0.01) * cos(lon + jj * 0.01));
+      update.set_y(radius * cos(lat + jj * 0.01) * sin(lon + jj * 0.01));
+      update.set_z(radius * sin(lat + jj * 0.01));
+      // Some platforms lack orientation or velocity on a few updates
+      if ((ii % 5 != 0) || (jj % 3 != 0))
+      {
+        // Alternate near +pi and -pi so that interpolation must go the short way around
+        const double wrap = (jj % 2 == 0) ? 3.1 : -3.1;
+        update.set_psi(wrap + 0.01 * angle(random));
+        update.set_theta(angle(random) / 4.0);
+        update.set_phi(angle(random));
+      }
+      if ((ii % 11 != 0) || (jj % 4 != 0))
+      {
+        update.set_vx(100.0 * angle(random));
+        update.set_vy(100.0 * angle(random));
+        update.set_vz(10.0 * angle(random));
+      }
+      updates.push_back(update);
+    }
+    if (!updates.empty())
+      ds.addPlatformUpdates(ids.back(), updates);
+  }
+  return ids;
+}
+
+/** Compares the batch against the data store interpolation at many times */
+int testMethod(simData::PlatformBatchInterpolator::Method method, simData::Interpolator& interpolator)
+{
+  int rv = 0;
+  std::mt19937 random(42);
+  simData::MemoryDataStore ds;
+  ds.setInterpolator(&interpolator);
+  ds.enableInterpolation(true);
+  const std::vector<uint64_t> ids = addPlatforms(ds, random);
+
+  simData::PlatformBatchInterpolator batch(method);
+  rv += SDK_ASSERT(batch.method() == method);
+  Arrays arrays(ids.size());
+
+  // Forward and back, times on updates, between them and outside of them
+  std::vector<double> times = { -5.0, 0.0, 1.0, 10.0, 250.0 };
+  for (double time = 0.0; time < 200.0; time += 0.7)
+    times.push_back(time);
+  for (double time = 200.0; time > 0.0; time -= 3.3)
+    times.push_back(time);
+  std::uniform_real_distribution<double> any(-10.0, 210.0);
+  for (size_t ii = 0; ii < 50; ++ii)
+    times.push_back(any(random));
+
+  for (double time : times)
+  {
+    ds.update(time);
+    rv += SDK_ASSERT(batch.interpolate(ds, time, ids, arrays.output) == 0);
+    rv += compare(ds, ids, arrays);
+  }
+
+  // Changes to the data are picked up by the next call
+  simData::PlatformUpdate update = *ds.platformUpdateSlice(ids[5])->lower_bound(35.0).peekNext();
+  update.set_x(update.x() + 1000.0);
+  update.set_psi(0.5);
+  ds.addPlatformUpdates(ids[5], { update });
+  ds.update(33.0);
+  rv += SDK_ASSERT(batch.interpolate(ds, 33.0, ids, arrays.output) == 0);
+  rv += compare(ds, ids, arrays);
+
+  // Fewer IDs, in a different order, and only some outputs
+  std::vector<uint64_t> reversed(ids.rbegin(), ids.rbegin() + 50);
+  Arrays partial(reversed.size());
+  partial.output.psi = nullptr;
+  partial.output.vx = nullptr;
+  rv += SDK_ASSERT(batch.interpolate(ds, 33.0, reversed, partial.output) == 0);
+  rv += compare(ds, reversed, partial);
+
+  // IDs that are not platforms are reported without failing the others
+  simUtil::DataStoreTestHelper helper(&ds);
+  std::vector<uint64_t> mixed = { ids[3], helper.addBeam(ids[3]), 123456, ids[4] };
+  Arrays mixedArrays(mixed.size());
+  ds.update(33.0);
+  rv += SDK_ASSERT(batch.interpolate(ds, 33.0, mixed, mixedArrays.output) != 0);
+  rv += SDK_ASSERT(mixedArrays.flags[1] == 0);
+  rv += SDK_ASSERT(mixedArrays.flags[2] == 0);
+  rv += SDK_ASSERT(mixedArrays.flags[0] != 0);
+  rv += SDK_ASSERT(mixedArrays.flags[3] != 0);
+  rv += SDK_ASSERT(mixedArrays.x[3] == arrays.x[4]);
+
+  batch.clear();
+  rv += SDK_ASSERT(batch.interpolate(ds, 33.0, ids, arrays.output) == 0);
+  rv += compare(ds, ids, arrays);
+  return rv;
+}
+
+}
+
+int TestPlatformBatchInterpolator(int argc, char* argv[])
+{
+  int rv = 0;
+  simData::LinearInterpolator linear;
+  rv += testMethod(simData::PlatformBatchInterpolator::Method::LINEAR, linear);
+  simData::NearestNeighborInterpolator nearest;
+  rv += testMethod(simData::PlatformBatchInterpolator::Method::NEAREST_NEIGHBOR, nearest);
+  return rv;
+}
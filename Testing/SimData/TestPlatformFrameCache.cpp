@@ -0,0 +1,292 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <random>
+#include <vector>
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/PlatformFrameCache.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Returns an update on a circle around the earth, with or without orientation and velocity */
+simData::PlatformUpdate makeUpdate(double time, bool orientation, bool velocity)
+{
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  const double radius = 6378137.0 + 1000.0 * time;
+  update.set_x(radius * cos(time * 0.01));
+  update.set_y(radius * sin(time * 0.01));
+  update.set_z(1000.0 * time);
+  if (orientation)
+  {
+    update.set_psi(0.1 * time);
+    update.set_theta(0.2);
+    update.set_phi(-0.3);
+  }
+  if (velocity)
+  {
+    update.set_vx(10.0 * time);
+    update.set_vy(-5.0);
+    update.set_vz(1.0);
+  }
+  return update;
+}
+
+/** Tests the cache on its own */
+int testCache()
+{
+  int rv = 0;
+  const simData::PlatformUpdate update = makeUpdate(10.0, true, true);
+
+  // The frames match a direct conversion
+  simData::PlatformFrames frames;
+  simData::PlatformFrameCache::compute(update, frames);
+  rv += SDK_ASSERT(frames.matches(update));
+  rv += SDK_ASSERT(frames.flags == (simData::PlatformFrames::HAS_ORIENTATION | simData::PlatformFrames::HAS_VELOCITY));
+  simCore::Coordinate ecef(simCore::COORD_SYS_ECEF, simCore::Vec3(update.x(), update.y(), update.z()),
+    simCore::Vec3(update.psi(), update.theta(), update.phi()), simCore::Vec3(update.vx(), update.vy(), update.vz()));
+  simCore::Coordinate lla;
+  simCore::CoordinateConverter::convertEcefToGeodetic(ecef, lla);
+  rv += SDK_ASSERT(frames.lla[0] == lla.lat() && frames.lla[1] == lla.lon() && frames.lla[2] == lla.alt());
+  rv += SDK_ASSERT(frames.llaOrientation[0] == lla.yaw() && frames.llaOrientation[2] == lla.roll());
+  rv += SDK_ASSERT(frames.llaVelocity[0] == lla.vx() && frames.llaVelocity[2] == lla.vz());
+  double q[4];
+  simCore::d3EulertoQ(simCore::Vec3(update.psi(), update.theta(), update.phi()), q);
+  rv += SDK_ASSERT(frames.quaternion[0] == q[0] && frames.quaternion[3] == q[3]);
+
+  // Missing orientation and velocity are flagged and do not match updates that have them
+  simData::PlatformFrames bare;
+  simData::PlatformFrameCache::compute(makeUpdate(10.0, false, false), bare);
+  rv += SDK_ASSERT(bare.flags == 0);
+  rv += SDK_ASSERT(bare.quaternion[0] == 1.0);
+  rv += SDK_ASSERT(!bare.matches(update));
+
+  simData::PlatformFrameCache cache;
+  rv += SDK_ASSERT(cache.size() == 0);
+  rv += SDK_ASSERT(cache.find(update) == nullptr);
+  rv += SDK_ASSERT(cache.current() == nullptr);
+
+  // Out of order adds are kept in time order, and equal times replace
+  cache.add(makeUpdate(20.0, true, true));
+  cache.add(makeUpdate(10.0, true, true));
+  cache.add(makeUpdate(15.0, true, true));
+  cache.add(makeUpdate(15.0, false, true));
+  rv += SDK_ASSERT(cache.size() == 3);
+  rv += SDK_ASSERT(cache.find(update) != nullptr);
+  rv += SDK_ASSERT(cache.find(makeUpdate(15.0, true, true)) == nullptr);
+  rv += SDK_ASSERT(cache.find(makeUpdate(15.0, false, true)) != nullptr);
+  rv += SDK_ASSERT(cache.find(makeUpdate(12.0, true, true)) == nullptr);
+
+  // Precomputed frames in any order, with duplicate times where the last one wins
+  std::vector<simData::PlatformFrames> batch(4);
+  simData::PlatformFrameCache::compute(makeUpdate(30.0, true, false), batch[0]);
+  simData::PlatformFrameCache::compute(makeUpdate(5.0, true, true), batch[1]);
+  simData::PlatformFrameCache::compute(makeUpdate(15.0, true, false), batch[2]);
+  simData::PlatformFrameCache::compute(makeUpdate(15.0, true, true), batch[3]);
+  cache.add(std::move(batch));
+  rv += SDK_ASSERT(cache.size() == 5);
+  rv += SDK_ASSERT(cache.find(makeUpdate(15.0, true, true)) != nullptr);
+  rv += SDK_ASSERT(cache.find(makeUpdate(30.0, true, false)) != nullptr);
+  rv += SDK_ASSERT(cache.find(makeUpdate(5.0, true, true)) != nullptr);
+
+  // get() computes missing entries and replaces stale ones
+  const simData::PlatformUpdate missing = makeUpdate(25.0, false, true);
+  rv += SDK_ASSERT(cache.get(missing).matches(missing));
+  rv += SDK_ASSERT(cache.size() == 6);
+  simData::PlatformUpdate changed = makeUpdate(20.0, true, true);
+  changed.set_x(1.0);
+  rv += SDK_ASSERT(cache.find(changed) == nullptr);
+  rv += SDK_ASSERT(cache.get(changed).matches(changed));
+  rv += SDK_ASSERT(cache.find(changed) != nullptr);
+  rv += SDK_ASSERT(cache.size() == 6);
+
+  // Current frames
+  cache.setCurrent(&missing);
+  rv += SDK_ASSERT(cache.current() != nullptr && cache.current()->matches(missing));
+  const simData::PlatformUpdate interpolated = makeUpdate(22.0, true, false);
+  cache.setCurrent(&interpolated);
+  rv += SDK_ASSERT(cache.current() != nullptr && cache.current()->matches(interpolated));
+  rv += SDK_ASSERT(cache.size() == 6);
+  cache.setCurrent(nullptr);
+  rv += SDK_ASSERT(cache.current() == nullptr);
+
+  cache.eraseBefore(15.0);
+  rv += SDK_ASSERT(cache.size() == 4);
+  rv += SDK_ASSERT(cache.find(update) == nullptr);
+  cache.setCurrent(&interpolated);
+  cache.clear();
+  rv += SDK_ASSERT(cache.size() == 0);
+  rv += SDK_ASSERT(cache.current() == nullptr);
+  return rv;
+}
+
+/** Returns true if the updates are identical */
+bool sameUpdate(const simData::PlatformUpdate& lhs, const simData::PlatformUpdate& rhs)
+{
+  return (lhs.time() == rhs.time()) &&
+    (lhs.x() == rhs.x()) && (lhs.y() == rhs.y()) && (lhs.z() == rhs.z()) &&
+    (lhs.psi() == rhs.psi()) && (lhs.theta() == rhs.theta()) && (lhs.phi() == rhs.phi()) &&
+    (lhs.vx() == rhs.vx()) && (lhs.vy() == rhs.vy()) && (lhs.vz() == rhs.vz());
+}
+
+/** Adds the same platforms to the data store, half with addPlatformUpdates() and half with transactions */
+std::vector<uint64_t> addPlatforms(simData::MemoryDataStore& ds)
+{
+  simUtil::DataStoreTestHelper helper(&ds);
+  std::mt19937 random(7);
+  std::uniform_real_distribution<double> jitter(0.0, 5.0);
+  std::vector<uint64_t> ids;
+  for (size_t ii = 0; ii < 20; ++ii)
+  {
+    ids.push_back(helper.addPlatform());
+    std::vector<simData::PlatformUpdate> updates;
+    for (size_t jj = 0; jj < 30; ++jj)
+      updates.push_back(makeUpdate(jj * 10.0 + jitter(random), (ii % 3 != 0) || (jj % 4 != 0), (ii % 4 != 0) || (jj % 5 != 0)));
+    if (ii % 2 == 0)
+      ds.addPlatformUpdates(ids.back(), updates);
+    else
+    {
+      for (const auto& update : updates)
+      {
+        simData::DataStore::Transaction t;
+        *ds.addPlatformUpdate(ids.back(), &t) = update;
+        t.commit();
+      }
+    }
+  }
+  return ids;
+}
+
+/** Tests that the internal interpolator gives the same results with and without the cache */
+int testDataStore(unsigned int numThreads)
+{
+  int rv = 0;
+  simData::MemoryDataStore plain;
+  simData::MemoryDataStore cached;
+  rv += SDK_ASSERT(!cached.platformFrameCaching());
+  cached.setPlatformFrameCaching(true);
+  rv += SDK_ASSERT(cached.platformFrameCaching());
+  cached.setUpdateThreads(numThreads);
+  plain.enableInterpolation(simData::DataStore::InterpolatorState::INTERNAL);
+  cached.enableInterpolation(simData::DataStore::InterpolatorState::INTERNAL);
+
+  const std::vector<uint64_t> plainIds = addPlatforms(plain);
+  const std::vector<uint64_t> ids = addPlatforms(cached);
+  rv += SDK_ASSERT(plain.platformFrameCache(plainIds[0]) == nullptr);
+  rv += SDK_ASSERT(plain.currentPlatformFrames(plainIds[0]) == nullptr);
+  for (auto id : ids)
+  {
+    const simData::PlatformFrameCache* cache = cached.platformFrameCache(id);
+    rv += SDK_ASSERT(cache != nullptr);
+    rv += SDK_ASSERT(cache != nullptr && cache->size() == cached.platformUpdateSlice(id)->numItems());
+  }
+
+  // Forward, backward and random times
+  std::vector<double> times;
+  for (double time = -5.0; time < 310.0; time += 1.3)
+    times.push_back(time);
+  for (double time = 300.0; time > 0.0; time -= 7.1)
+    times.push_back(time);
+  std::mt19937 random(11);
+  std::uniform_real_distribution<double> any(-10.0, 310.0);
+  for (size_t ii = 0; ii < 50; ++ii)
+    times.push_back(any(random));
+
+  size_t interpolated = 0;
+  for (double time : times)
+  {
+    plain.update(time);
+    cached.update(time);
+    for (size_t ii = 0; ii < ids.size(); ++ii)
+    {
+      const simData::PlatformUpdate* expected = plain.platformUpdateSlice(plainIds[ii])->current();
+      const simData::PlatformUpdate* actual = cached.platformUpdateSlice(ids[ii])->current();
+      const simData::PlatformFrames* frames = cached.currentPlatformFrames(ids[ii]);
+      rv += SDK_ASSERT((expected == nullptr) == (actual == nullptr));
+      rv += SDK_ASSERT((actual == nullptr) == (frames == nullptr));
+      if (expected && actual)
+        rv += SDK_ASSERT(sameUpdate(*expected, *actual));
+      if (cached.platformUpdateSlice(ids[ii])->isInterpolated())
+        ++interpolated;
+      if (actual && frames)
+        rv += SDK_ASSERT(frames->matches(*actual));
+    }
+  }
+  rv += SDK_ASSERT(interpolated > 0);
+  return rv;
+}
+
+/** Tests that data limiting and flushing remove frames */
+int testLimiting()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  ds.setPlatformFrameCaching(true);
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t id = helper.addPlatform();
+  ds.setDataLimiting(true);
+  {
+    simData::DataStore::Transaction t;
+    ds.mutable_platformPrefs(id, &t)->mutable_commonprefs()->set_datalimitpoints(5);
+    t.commit();
+  }
+
+  for (size_t ii = 0; ii < 20; ++ii)
+  {
+    simData::DataStore::Transaction t;
+    *ds.addPlatformUpdate(id, &t) = makeUpdate(static_cast<double>(ii), true, true);
+    t.commit();
+  }
+  ds.update(19.0);
+  const simData::PlatformFrameCache* cache = ds.platformFrameCache(id);
+  rv += SDK_ASSERT(cache != nullptr);
+  if (cache == nullptr)
+    return rv;
+  rv += SDK_ASSERT(cache->size() == ds.platformUpdateSlice(id)->numItems());
+  rv += SDK_ASSERT(cache->size() < 20);
+  rv += SDK_ASSERT(ds.currentPlatformFrames(id) != nullptr);
+
+  // Removed frames are dropped on the next update
+  ds.flush(id, simData::DataStore::RECURSIVE);
+  ds.update(19.0);
+  rv += SDK_ASSERT(cache->size() == 0);
+  rv += SDK_ASSERT(ds.currentPlatformFrames(id) == nullptr);
+  return rv;
+}
+
+}
+
+int TestPlatformFrameCache(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testCache();
+  rv += testDataStore(1);
+  rv += testDataStore(3);
+  rv += testLimiting();
+  return rv;
+}
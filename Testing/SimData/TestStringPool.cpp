@@ -0,0 +1,125 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <map>
+#include <string>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/StringPool.h"
+
+namespace
+{
+
+int testInterning()
+{
+  int rv = 0;
+  simData::StringPool pool;
+  const uint32_t a = pool.acquire("alpha");
+  const uint32_t b = pool.acquire("beta");
+  const uint32_t empty = pool.acquire("");
+  rv += SDK_ASSERT(a != b && a != empty && b != empty);
+  rv += SDK_ASSERT(pool.acquire(std::string("alp") + "ha") == a);
+  rv += SDK_ASSERT(pool.acquire("") == empty);
+  rv += SDK_ASSERT(pool.numStrings() == 3);
+  rv += SDK_ASSERT(pool.get(a) == "alpha");
+  rv += SDK_ASSERT(pool.get(b) == "beta");
+  rv += SDK_ASSERT(pool.get(empty).empty());
+  // A few short strings do not cost a full sized chunk
+  rv += SDK_ASSERT(pool.memoryUsage() < 4096);
+
+  // Strings last until their last reference is released
+  pool.release(a);
+  rv += SDK_ASSERT(pool.get(a) == "alpha");
+  pool.addReference(b);
+  pool.release(b);
+  pool.release(a);
+  rv += SDK_ASSERT(pool.numStrings() == 2);
+  pool.release(empty);
+  pool.release(empty);
+  rv += SDK_ASSERT(pool.numStrings() == 1);
+  rv += SDK_ASSERT(pool.get(b) == "beta");
+
+  // Released handles are reused
+  const uint32_t c = pool.acquire("gamma");
+  rv += SDK_ASSERT(c == a || c == empty);
+  rv += SDK_ASSERT(pool.get(c) == "gamma");
+  rv += SDK_ASSERT(pool.acquire("alpha") != b);
+
+  pool.clear();
+  rv += SDK_ASSERT(pool.numStrings() == 0);
+  return rv;
+}
+
+int testReclaim()
+{
+  int rv = 0;
+  simData::StringPool pool;
+  const size_t emptyUsage = pool.memoryUsage();
+
+  // A long lived string in each of many chunks keeps them pinned until compaction
+  std::map<uint32_t, std::string> kept;
+  std::vector<uint32_t> released;
+  const std::string padding(100, 'x');
+  for (int k = 0; k < 50000; ++k)
+  {
+    const std::string value = std::to_string(k) + padding;
+    const uint32_t handle = pool.acquire(value);
+    if (k % 1000 == 0)
+      kept[handle] = value;
+    else
+      released.push_back(handle);
+  }
+  // Long strings get their own chunk
+  const std::string longString(100000, 'y');
+  const uint32_t longHandle = pool.acquire(longString);
+  kept[longHandle] = longString;
+
+  const size_t fullUsage = pool.memoryUsage();
+  rv += SDK_ASSERT(fullUsage > 50000 * padding.size());
+  for (uint32_t handle : released)
+    pool.release(handle);
+  rv += SDK_ASSERT(pool.numStrings() == kept.size());
+  rv += SDK_ASSERT(pool.memoryUsage() < fullUsage / 4);
+
+  // Handles survive compaction
+  for (const auto& handleAndValue : kept)
+  {
+    rv += SDK_ASSERT(pool.get(handleAndValue.first) == handleAndValue.second);
+    rv += SDK_ASSERT(pool.acquire(handleAndValue.second) == handleAndValue.first);
+    pool.release(handleAndValue.first);
+  }
+  for (const auto& handleAndValue : kept)
+    pool.release(handleAndValue.first);
+  rv += SDK_ASSERT(pool.numStrings() == 0);
+  rv += SDK_ASSERT(pool.memoryUsage() < emptyUsage + fullUsage / 4);
+  return rv;
+}
+
+}
+
+int TestStringPool(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testInterning() == 0);
+  rv += SDK_ASSERT(testReclaim() == 0);
+  return rv;
+}
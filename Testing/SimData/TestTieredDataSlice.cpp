@@ -0,0 +1,463 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/TieredDataSlice.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+simData::PlatformUpdate* newPlatformUpdate(double time, double offset = 0.0)
+{
+  simData::PlatformUpdate* rv = new simData::PlatformUpdate();
+  rv->set_time(time);
+  rv->set_x(6378137.0 + time * 0.37 + offset);
+  rv->set_y(time * 2.0);
+  rv->set_z(1000.0 + time * 0.013);
+  rv->set_psi(0.1);
+  rv->set_theta(0.2);
+  rv->set_phi(0.3 + time * 0.001);
+  // leave velocity unset every other point to exercise the sentinel values
+  if ((static_cast<int>(time) % 2) == 0)
+  {
+    rv->set_vx(10.0);
+    rv->set_vy(20.0);
+    rv->set_vz(30.0);
+  }
+  return rv;
+}
+
+bool samePlatform(const simData::PlatformUpdate* lhs, const simData::PlatformUpdate* rhs)
+{
+  if (lhs == nullptr || rhs == nullptr)
+    return lhs == rhs;
+  return lhs->time() == rhs->time() && lhs->x() == rhs->x() && lhs->y() == rhs->y() && lhs->z() == rhs->z() &&
+    lhs->psi() == rhs->psi() && lhs->theta() == rhs->theta() && lhs->phi() == rhs->phi() &&
+    lhs->has_velocity() == rhs->has_velocity() && lhs->vx() == rhs->vx() && lhs->vy() == rhs->vy() && lhs->vz() == rhs->vz();
+}
+
+/** Compares the visited updates with the ones in a reference slice */
+class CompareVisitor : public simData::PlatformUpdateSlice::Visitor
+{
+public:
+  explicit CompareVisitor(const simData::MemoryDataSlice<simData::PlatformUpdate>& reference)
+    : iter_(reference.lower_bound(-1.0))
+  {
+  }
+
+  virtual void operator()(const simData::PlatformUpdate* update)
+  {
+    errors += SDK_ASSERT(samePlatform(iter_.next(), update));
+    ++visited;
+  }
+
+  int errors = 0;
+  size_t visited = 0;
+
+private:
+  simData::PlatformUpdateSlice::Iterator iter_;
+};
+
+/** Compares a tiered slice against an unlimited slice holding the same data */
+int compareSlices(const simData::MemoryDataSlice<simData::PlatformUpdate>& deque, const simData::TieredDataSlice<simData::PlatformUpdate>& tiered)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(deque.numItems() == tiered.numItems());
+  rv += SDK_ASSERT(deque.firstTime() == tiered.firstTime());
+  rv += SDK_ASSERT(deque.lastTime() == tiered.lastTime());
+
+  // Walk both slices from the front
+  auto dequeIt = deque.lower_bound(-1.0);
+  auto tieredIt = tiered.lower_bound(-1.0);
+  while (dequeIt.hasNext())
+  {
+    rv += SDK_ASSERT(tieredIt.hasNext());
+    if (!tieredIt.hasNext())
+      break;
+    rv += SDK_ASSERT(samePlatform(dequeIt.next(), tieredIt.next()));
+  }
+  rv += SDK_ASSERT(!tieredIt.hasNext());
+
+  // Visiting sees the same sequence
+  CompareVisitor visitor(deque);
+  tiered.visit(&visitor);
+  rv += visitor.errors;
+  rv += SDK_ASSERT(visitor.visited == deque.numItems());
+
+  // Spot check searches on and between points, on both sides of the tier boundary
+  for (double time = -1.0; time < deque.lastTime() + 10.0; time += 3.25)
+  {
+    auto dequeLower = deque.lower_bound(time);
+    auto tieredLower = tiered.lower_bound(time);
+    rv += SDK_ASSERT(samePlatform(dequeLower.peekNext(), tieredLower.peekNext()));
+    rv += SDK_ASSERT(samePlatform(dequeLower.peekPrevious(), tieredLower.peekPrevious()));
+    auto dequeUpper = deque.upper_bound(time);
+    auto tieredUpper = tiered.upper_bound(time);
+    rv += SDK_ASSERT(samePlatform(dequeUpper.peekNext(), tieredUpper.peekNext()));
+    rv += SDK_ASSERT(samePlatform(dequeUpper.peekPrevious(), tieredUpper.peekPrevious()));
+    rv += SDK_ASSERT(deque.deltaTime(time) == tiered.deltaTime(time));
+  }
+  return rv;
+}
+
+int testSpill()
+{
+  int rv = 0;
+
+  simData::MemoryDataSlice<simData::PlatformUpdate> deque;
+  simData::TieredDataSlice<simData::PlatformUpdate> tiered(1024 * 1024);
+  for (int ii = 0; ii < 1000; ++ii)
+  {
+    deque.insert(newPlatformUpdate(ii));
+    tiered.insert(newPlatformUpdate(ii));
+    // Limit as the data store does, one point at a time
+    tiered.limitByPoints(100);
+  }
+
+  // Nothing was lost; the old points moved to the cold tier
+  rv += SDK_ASSERT(tiered.numHotItems() == 100);
+  rv += SDK_ASSERT(tiered.numColdItems() == 900);
+
+  // The cold tier is much smaller than the same points held hot; nothing has been decoded yet
+  rv += SDK_ASSERT(tiered.coldMemoryUsage() < 900 * sizeof(simData::PlatformUpdate) / 2);
+  rv += SDK_ASSERT(tiered.memoryUsage() == tiered.hotMemoryUsage() + tiered.coldMemoryUsage());
+
+  rv += compareSlices(deque, tiered);
+
+  // Time updates into the cold tier return exact copies
+  tiered.update(10.0);
+  rv += SDK_ASSERT(samePlatform(tiered.current(), deque.lower_bound(10.0).peekNext()));
+  tiered.update(500.5);
+  rv += SDK_ASSERT(samePlatform(tiered.current(), deque.lower_bound(500.0).peekNext()));
+  std::optional<double> startTime;
+  std::optional<double> endTime;
+  tiered.update(20.5, startTime, endTime);
+  rv += SDK_ASSERT(tiered.current() != nullptr && tiered.current()->time() == 20.0);
+  rv += SDK_ASSERT(startTime.value_or(-1.0) == 20.0);
+  rv += SDK_ASSERT(endTime.value_or(-1.0) == 21.0);
+  tiered.update(950.0);
+  rv += SDK_ASSERT(samePlatform(tiered.current(), deque.lower_bound(950.0).peekNext()));
+
+  // Interpolation across the boundary between the tiers
+  simData::LinearInterpolator interpolator;
+  tiered.update(899.5, &interpolator);
+  rv += SDK_ASSERT(tiered.isInterpolated());
+  rv += SDK_ASSERT(tiered.current() != nullptr && tiered.current()->time() == 899.5);
+  rv += SDK_ASSERT(tiered.interpolationBounds().first != nullptr && tiered.interpolationBounds().first->time() == 899.0);
+  rv += SDK_ASSERT(tiered.interpolationBounds().second != nullptr && tiered.interpolationBounds().second->time() == 900.0);
+  tiered.update(-5.0, &interpolator);
+  rv += SDK_ASSERT(tiered.current() == nullptr);
+
+  // Time limiting moves points too
+  tiered.limitByTime(9.0);
+  rv += SDK_ASSERT(tiered.numHotItems() == 9);
+  rv += SDK_ASSERT(tiered.numItems() == 1000);
+
+  return rv;
+}
+
+int testBudget()
+{
+  int rv = 0;
+
+  // Room for only a few blocks
+  simData::TieredDataSlice<simData::PlatformUpdate> tiered(4096);
+  for (int ii = 0; ii < 5000; ++ii)
+  {
+    tiered.insert(newPlatformUpdate(ii));
+    tiered.limitByPoints(50);
+  }
+  rv += SDK_ASSERT(tiered.numHotItems() == 50);
+  rv += SDK_ASSERT(tiered.numColdItems() > 0);
+  rv += SDK_ASSERT(tiered.numColdItems() < 5000 - 50);
+  rv += SDK_ASSERT(tiered.coldMemoryUsage() <= 4096 + simData::ColumnChunkSize * sizeof(simData::PlatformUpdate));
+  rv += SDK_ASSERT(tiered.numColdItems() % simData::ColumnChunkSize == (4950 % simData::ColumnChunkSize));
+
+  // The oldest points are gone for good
+  const double first = tiered.firstTime();
+  rv += SDK_ASSERT(first > 0.0);
+  rv += SDK_ASSERT(tiered.numItems() == static_cast<size_t>(5000 - first));
+  tiered.update(first - 1.0);
+  rv += SDK_ASSERT(tiered.current() == nullptr);
+  tiered.update(first);
+  rv += SDK_ASSERT(tiered.current() != nullptr && tiered.current()->time() == first);
+
+  // A zero budget deletes limited points, like MemoryDataSlice
+  simData::TieredDataSlice<simData::PlatformUpdate> noCold(0);
+  for (int ii = 0; ii < 500; ++ii)
+  {
+    noCold.insert(newPlatformUpdate(ii));
+    noCold.limitByPoints(50);
+  }
+  rv += SDK_ASSERT(noCold.numItems() == 50);
+  rv += SDK_ASSERT(noCold.numColdItems() == 0);
+  rv += SDK_ASSERT(noCold.coldMemoryUsage() == 0);
+
+  return rv;
+}
+
+int testEdits()
+{
+  int rv = 0;
+
+  simData::MemoryDataSlice<simData::PlatformUpdate> deque;
+  simData::TieredDataSlice<simData::PlatformUpdate> tiered(1024 * 1024);
+  for (int ii = 0; ii < 600; ii += 2)
+  {
+    deque.insert(newPlatformUpdate(ii));
+    tiered.insert(newPlatformUpdate(ii));
+  }
+  tiered.limitByPoints(20);
+  rv += SDK_ASSERT(tiered.numColdItems() == 280);
+
+  // Late arrivals inside the cold tier, including replacements and a batch
+  tiered.update(101.0);
+  for (int ii = 1; ii < 200; ii += 20)
+  {
+    deque.insert(newPlatformUpdate(ii));
+    tiered.insert(newPlatformUpdate(ii));
+  }
+  deque.insert(newPlatformUpdate(100.0, 0.5));
+  tiered.insert(newPlatformUpdate(100.0, 0.5));
+  std::vector<simData::PlatformUpdate*> dequeBatch;
+  std::vector<simData::PlatformUpdate*> tieredBatch;
+  for (int ii = 3; ii < 600; ii += 50)
+  {
+    dequeBatch.push_back(newPlatformUpdate(ii));
+    tieredBatch.push_back(newPlatformUpdate(ii));
+  }
+  deque.insertMany(dequeBatch);
+  tiered.insertMany(tieredBatch);
+  rv += compareSlices(deque, tiered);
+  rv += SDK_ASSERT(tiered.isDirty());
+  tiered.update(101.0);
+  rv += SDK_ASSERT(tiered.current() != nullptr && tiered.current()->time() == 101.0);
+
+  // Flush a range that spans both tiers
+  deque.flush(250.0, 590.0);
+  tiered.flush(250.0, 590.0);
+  rv += compareSlices(deque, tiered);
+
+  deque.flush();
+  tiered.flush();
+  rv += SDK_ASSERT(tiered.numItems() == 0);
+  rv += SDK_ASSERT(tiered.coldMemoryUsage() == 0);
+  tiered.update(10.0);
+  rv += SDK_ASSERT(tiered.current() == nullptr);
+
+  return rv;
+}
+
+int testProtobufFields()
+{
+  int rv = 0;
+
+  // Has-bits survive compression
+  simData::TieredDataSlice<simData::GateUpdate> gates(1024 * 1024);
+  for (int ii = 0; ii < 300; ++ii)
+  {
+    simData::GateUpdate* update = new simData::GateUpdate();
+    update->set_time(ii);
+    update->set_azimuth(ii * 0.01);
+    update->set_minrange(100.0);
+    if (ii % 3 == 0)
+      update->set_maxrange(200.0 + ii);
+    gates.insert(update);
+  }
+  gates.limitByPoints(10);
+  rv += SDK_ASSERT(gates.numColdItems() == 290);
+  for (int ii = 0; ii < 290; ++ii)
+  {
+    const simData::GateUpdate* view = gates.lower_bound(ii).peekNext();
+    rv += SDK_ASSERT(view != nullptr && view->time() == ii);
+    if (view == nullptr)
+      continue;
+    rv += SDK_ASSERT(view->azimuth() == ii * 0.01);
+    rv += SDK_ASSERT(view->minrange() == 100.0);
+    rv += SDK_ASSERT(view->has_maxrange() == (ii % 3 == 0));
+    rv += SDK_ASSERT(!view->has_elevation());
+  }
+
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::TIERED);
+  ds.setColdStorageBudget(64 * 1024);
+  rv += SDK_ASSERT(ds.coldStorageBudget() == 64 * 1024);
+  ds.setDataLimiting(true);
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(platId, &t);
+  prefs->mutable_commonprefs()->set_datalimitpoints(50);
+  t.commit();
+  for (int ii = 0; ii < 400; ++ii)
+  {
+    helper.addPlatformUpdate(ii, platId);
+    helper.addBeamUpdate(ii, beamId);
+  }
+
+  const auto* platSlice = dynamic_cast<const simData::TieredDataSlice<simData::PlatformUpdate>*>(ds.platformUpdateSlice(platId));
+  rv += SDK_ASSERT(platSlice != nullptr);
+  rv += SDK_ASSERT(dynamic_cast<const simData::TieredDataSlice<simData::BeamUpdate>*>(ds.beamUpdateSlice(beamId)) != nullptr);
+  if (platSlice == nullptr)
+    return rv;
+  rv += SDK_ASSERT(platSlice->numHotItems() == 50);
+  rv += SDK_ASSERT(platSlice->numItems() == 400);
+  rv += SDK_ASSERT(platSlice->coldBudget() == 64 * 1024);
+
+  // Playback reaches the cold points
+  ds.update(10.0);
+  rv += SDK_ASSERT(platSlice->current() != nullptr && platSlice->current()->time() == 10.0);
+  ds.update(380.0);
+  rv += SDK_ASSERT(platSlice->current() != nullptr && platSlice->current()->time() == 380.0);
+
+  size_t hotBytes = 0;
+  size_t coldBytes = 0;
+  rv += SDK_ASSERT(ds.updateMemoryUsage(platId, hotBytes, coldBytes) == 0);
+  rv += SDK_ASSERT(hotBytes == platSlice->hotMemoryUsage());
+  rv += SDK_ASSERT(coldBytes == platSlice->coldMemoryUsage());
+  rv += SDK_ASSERT(coldBytes > 0);
+  rv += SDK_ASSERT(ds.updateMemoryUsage(beamId, hotBytes, coldBytes) == 0);
+  rv += SDK_ASSERT(coldBytes == 0);
+
+  // Other storage reports everything as hot; other entity types are an error
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::DEQUE);
+  const uint64_t platId2 = helper.addPlatform();
+  helper.addPlatformUpdate(0.0, platId2);
+  rv += SDK_ASSERT(ds.updateMemoryUsage(platId2, hotBytes, coldBytes) == 0);
+  rv += SDK_ASSERT(hotBytes > 0);
+  rv += SDK_ASSERT(coldBytes == 0);
+  const uint64_t laserId = helper.addLaser(platId);
+  rv += SDK_ASSERT(ds.updateMemoryUsage(laserId, hotBytes, coldBytes) != 0);
+
+  return rv;
+}
+
+/** Adds the update from newPlatformUpdate() to the data store */
+void addPlatformUpdate(simData::MemoryDataStore& ds, uint64_t id, double time)
+{
+  std::unique_ptr<simData::PlatformUpdate> update(newPlatformUpdate(time));
+  simData::DataStore::Transaction t;
+  *ds.addPlatformUpdate(id, &t) = *update;
+  t.commit();
+}
+
+/** Returns true if the slice holds an update interpolated at time between the points from newPlatformUpdate() at before and after */
+bool interpolatedBetween(const simData::PlatformUpdateSlice* slice, double time, double before, double after)
+{
+  const simData::PlatformUpdate* current = slice->current();
+  return (current != nullptr) && (current->time() == time) && slice->isInterpolated() &&
+    (current->y() > 2.0 * before) && (current->y() < 2.0 * after);
+}
+
+/** Iterating over cold points between time updates must not disturb the bracket the data store caches for playback */
+int testIterationDuringPlayback()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  ds.setUpdateStorage(simData::MemoryDataStore::UpdateStorage::TIERED);
+  ds.setColdStorageBudget(1024 * 1024);
+  ds.setDataLimiting(true);
+  ds.enableInterpolation(simData::DataStore::InterpolatorState::INTERNAL);
+  simUtil::DataStoreTestHelper helper(&ds);
+
+  const uint64_t platId = helper.addPlatform();
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(platId, &t);
+  prefs->mutable_commonprefs()->set_datalimitpoints(50);
+  t.commit();
+  for (int ii = 0; ii < 4000; ++ii)
+    addPlatformUpdate(ds, platId, ii);
+
+  const simData::PlatformUpdateSlice* slice = ds.platformUpdateSlice(platId);
+  const auto* tiered = dynamic_cast<const simData::TieredDataSlice<simData::PlatformUpdate>*>(slice);
+  rv += SDK_ASSERT(tiered != nullptr && tiered->numColdItems() == 3950);
+
+  ds.update(10.5);
+  rv += SDK_ASSERT(interpolatedBetween(slice, 10.5, 10.0, 11.0));
+
+  // Walk through other cold blocks, holding on to the views from each
+  std::vector<const simData::PlatformUpdate*> views;
+  for (double start : { 1000.0, 2500.0, 3900.0 })
+  {
+    auto iter = slice->lower_bound(start);
+    for (int ii = 0; ii < 300 && iter.hasNext(); ++ii)
+      views.push_back(iter.next());
+  }
+  bool viewsValid = true;
+  for (size_t ii = 0; ii < views.size(); ++ii)
+    viewsValid = viewsValid && (views[ii]->y() == 2.0 * views[ii]->time()) && ((ii % 300 == 0) || (views[ii]->time() == views[ii - 1]->time() + 1.0));
+  rv += SDK_ASSERT(viewsValid);
+
+  // Playback inside the cached bracket still sees points 10 and 11
+  ds.update(11.0);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->time() == 11.0 && slice->current()->y() == 22.0);
+  ds.update(10.0);
+  rv += SDK_ASSERT(slice->current() != nullptr && slice->current()->time() == 10.0 && slice->current()->y() == 20.0);
+  ds.update(10.25);
+  rv += SDK_ASSERT(interpolatedBetween(slice, 10.25, 10.0, 11.0));
+
+  // New points push more updates into the cold tier while a bracket near the tier boundary is cached
+  ds.update(3960.5);
+  rv += SDK_ASSERT(interpolatedBetween(slice, 3960.5, 3960.0, 3961.0));
+  for (int ii = 4000; ii < 4200; ++ii)
+    addPlatformUpdate(ds, platId, ii);
+  auto iter = slice->lower_bound(3900.0);
+  while (iter.hasNext() && iter.peekNext()->time() < 4100.0)
+    iter.next();
+  ds.update(3960.75);
+  rv += SDK_ASSERT(interpolatedBetween(slice, 3960.75, 3960.0, 3961.0));
+  ds.update(10.5);
+  rv += SDK_ASSERT(interpolatedBetween(slice, 10.5, 10.0, 11.0));
+
+  return rv;
+}
+
+}
+
+int TestTieredDataSlice(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testSpill();
+  rv += testBudget();
+  rv += testEdits();
+  rv += testProtobufFields();
+  rv += testDataStore();
+  rv += testIterationDuringPlayback();
+
+  return rv;
+}
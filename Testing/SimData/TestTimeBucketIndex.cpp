@@ -0,0 +1,291 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <deque>
+#include <random>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataSlice.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/TimeBucketIndex.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+simData::PlatformUpdate* newPlatformUpdate(double time)
+{
+  simData::PlatformUpdate* rv = new simData::PlatformUpdate();
+  rv->set_time(time);
+  rv->set_x(6378137.0 + time);
+  rv->set_y(time * 2.0);
+  rv->set_z(time * 3.0);
+  return rv;
+}
+
+/** Owns the updates of a deque and frees them on destruction */
+struct UpdateList
+{
+  ~UpdateList()
+  {
+    for (auto* update : updates)
+      delete update;
+  }
+
+  std::deque<simData::PlatformUpdate*> updates;
+};
+
+/** Compares the index against std::lower_bound and std::upper_bound at the given times */
+int checkIndex(const simData::TimeBucketIndex<simData::PlatformUpdate>& index, const std::deque<simData::PlatformUpdate*>& updates, const std::vector<double>& times)
+{
+  int rv = 0;
+  for (double time : times)
+  {
+    const size_t lower = std::lower_bound(updates.begin(), updates.end(), time, simData::UpdateComp<simData::PlatformUpdate>()) - updates.begin();
+    const size_t upper = std::upper_bound(updates.begin(), updates.end(), time, simData::UpdateComp<simData::PlatformUpdate>()) - updates.begin();
+    rv += SDK_ASSERT(static_cast<size_t>(index.lowerBound(updates.begin(), updates.end(), time) - updates.begin()) == lower);
+    rv += SDK_ASSERT(static_cast<size_t>(index.upperBound(updates.begin(), updates.end(), time) - updates.begin()) == upper);
+  }
+  return rv;
+}
+
+/** Times on and between the updates, and outside of them */
+std::vector<double> probeTimes(const std::deque<simData::PlatformUpdate*>& updates, std::mt19937& random)
+{
+  std::vector<double> rv = { -1e12, -1.0, 0.0, 1e12 };
+  if (updates.empty())
+    return rv;
+  std::uniform_real_distribution<double> between(updates.front()->time() - 10.0, updates.back()->time() + 10.0);
+  for (size_t ii = 0; ii < 200; ++ii)
+  {
+    rv.push_back(between(random));
+    rv.push_back(updates[random() % updates.size()]->time());
+  }
+  return rv;
+}
+
+int testIndex()
+{
+  int rv = 0;
+
+  std::mt19937 random(1234);
+  std::exponential_distribution<double> gap(1.0);
+  UpdateList list;
+  simData::TimeBucketIndex<simData::PlatformUpdate> index;
+  rv += SDK_ASSERT(index.numBuckets() == 0);
+  rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+
+  // Irregular data, with bursts and long gaps, appended a few at a time like live data
+  double time = 0.0;
+  for (size_t ii = 0; ii < 3000; ++ii)
+  {
+    time += (ii % 500 < 50) ? gap(random) * 0.001 : gap(random);
+    if (ii % 700 == 0)
+      time += 5000.0;
+    list.updates.push_back(newPlatformUpdate(time));
+    index.append(list.updates);
+    if (ii % 250 == 0)
+      rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+  }
+  rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+  rv += SDK_ASSERT(index.numBuckets() > 0);
+
+  // Data limiting removes from the front
+  for (size_t ii = 0; ii < 20; ++ii)
+  {
+    for (size_t jj = 0; jj < 50; ++jj)
+    {
+      delete list.updates.front();
+      list.updates.pop_front();
+    }
+    index.eraseFront(50);
+    time += 1.0;
+    list.updates.push_back(newPlatformUpdate(time));
+    index.append(list.updates);
+    rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+  }
+
+  // Inserting in the middle without telling the index is caught by the size check
+  list.updates.insert(list.updates.begin() + 100, newPlatformUpdate((list.updates[99]->time() + list.updates[100]->time()) / 2.0));
+  rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+
+  // A static point in front of the data
+  list.updates.push_front(newPlatformUpdate(-1.0));
+  index.invalidate();
+  rv += checkIndex(index, list.updates, probeTimes(list.updates, random));
+
+  // Small slices and slices with a single time are searched without buckets
+  UpdateList small;
+  for (int ii = 0; ii < 5; ++ii)
+    small.updates.push_back(newPlatformUpdate(ii));
+  simData::TimeBucketIndex<simData::PlatformUpdate> smallIndex;
+  rv += checkIndex(smallIndex, small.updates, probeTimes(small.updates, random));
+  rv += SDK_ASSERT(smallIndex.numBuckets() == 0);
+
+  return rv;
+}
+
+int testSlice()
+{
+  int rv = 0;
+
+  simData::MemoryDataSlice<simData::PlatformUpdate> plain;
+  simData::MemoryDataSlice<simData::PlatformUpdate> indexed;
+  rv += SDK_ASSERT(!indexed.timeIndexEnabled());
+  indexed.enableTimeIndex(true);
+  rv += SDK_ASSERT(indexed.timeIndexEnabled());
+
+  // Appends, out of order inserts and a bulk merge
+  for (int ii = 0; ii < 2000; ii += 2)
+  {
+    plain.insert(newPlatformUpdate(ii * 0.5));
+    indexed.insert(newPlatformUpdate(ii * 0.5));
+  }
+  for (int ii = 1; ii < 400; ii += 6)
+  {
+    plain.insert(newPlatformUpdate(ii * 0.5));
+    indexed.insert(newPlatformUpdate(ii * 0.5));
+  }
+  std::vector<simData::PlatformUpdate*> plainBatch;
+  std::vector<simData::PlatformUpdate*> indexedBatch;
+  for (int ii = 1001; ii < 3000; ii += 4)
+  {
+    plainBatch.push_back(newPlatformUpdate(ii * 0.5));
+    indexedBatch.push_back(newPlatformUpdate(ii * 0.5));
+  }
+  plain.insertMany(plainBatch);
+  indexed.insertMany(indexedBatch);
+
+  // Scrub back and forth, with and without interpolation, limiting the data part way through
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> seek(-10.0, 1600.0);
+  simData::LinearInterpolator interpolator;
+  for (int ii = 0; ii < 2000; ++ii)
+  {
+    if (ii == 1000)
+    {
+      plain.limitByPoints(900);
+      indexed.limitByPoints(900);
+      plain.limitByTime(400.0);
+      indexed.limitByTime(400.0);
+      rv += SDK_ASSERT(plain.numItems() == indexed.numItems());
+    }
+
+    const double time = seek(random);
+    if (ii % 2 == 0)
+    {
+      plain.update(time);
+      indexed.update(time);
+    }
+    else
+    {
+      plain.update(time, &interpolator);
+      indexed.update(time, &interpolator);
+    }
+    rv += SDK_ASSERT((plain.current() == nullptr) == (indexed.current() == nullptr));
+    if (plain.current() != nullptr && indexed.current() != nullptr)
+    {
+      rv += SDK_ASSERT(plain.current()->time() == indexed.current()->time());
+      rv += SDK_ASSERT(plain.current()->x() == indexed.current()->x());
+    }
+
+    const simData::PlatformUpdate* plainLower = plain.lower_bound(time).peekNext();
+    const simData::PlatformUpdate* indexedLower = indexed.lower_bound(time).peekNext();
+    rv += SDK_ASSERT((plainLower == nullptr) ? (indexedLower == nullptr) : (indexedLower != nullptr && plainLower->time() == indexedLower->time()));
+    const simData::PlatformUpdate* plainUpper = plain.upper_bound(time).peekPrevious();
+    const simData::PlatformUpdate* indexedUpper = indexed.upper_bound(time).peekPrevious();
+    rv += SDK_ASSERT((plainUpper == nullptr) ? (indexedUpper == nullptr) : (indexedUpper != nullptr && plainUpper->time() == indexedUpper->time()));
+    rv += SDK_ASSERT(plain.deltaTime(time) == indexed.deltaTime(time));
+  }
+
+  // Flushing a range leaves the index usable
+  plain.flush(1300.0, 1400.0);
+  indexed.flush(1300.0, 1400.0);
+  plain.update(1350.0);
+  indexed.update(1350.0);
+  rv += SDK_ASSERT(plain.current() != nullptr && indexed.current() != nullptr && plain.current()->time() == indexed.current()->time());
+
+  indexed.enableTimeIndex(false);
+  rv += SDK_ASSERT(!indexed.timeIndexEnabled());
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+
+  simData::MemoryDataStore ds;
+  rv += SDK_ASSERT(!ds.timeIndexing());
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t plainId = helper.addPlatform();
+
+  ds.setTimeIndexing(true);
+  rv += SDK_ASSERT(ds.timeIndexing());
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+  for (int ii = 0; ii < 100; ++ii)
+  {
+    helper.addPlatformUpdate(ii, platId);
+    helper.addBeamUpdate(ii, beamId);
+    helper.addGateUpdate(ii, gateId);
+  }
+
+  auto isIndexed = [](const simData::DataSliceBase* slice) {
+    const auto* platforms = dynamic_cast<const simData::MemoryDataSlice<simData::PlatformUpdate>*>(slice);
+    if (platforms)
+      return platforms->timeIndexEnabled();
+    const auto* beams = dynamic_cast<const simData::MemoryDataSlice<simData::BeamUpdate>*>(slice);
+    if (beams)
+      return beams->timeIndexEnabled();
+    const auto* gates = dynamic_cast<const simData::MemoryDataSlice<simData::GateUpdate>*>(slice);
+    return gates != nullptr && gates->timeIndexEnabled();
+  };
+  rv += SDK_ASSERT(!isIndexed(ds.platformUpdateSlice(plainId)));
+  rv += SDK_ASSERT(isIndexed(ds.platformUpdateSlice(platId)));
+  rv += SDK_ASSERT(isIndexed(ds.beamUpdateSlice(beamId)));
+  rv += SDK_ASSERT(isIndexed(ds.gateUpdateSlice(gateId)));
+
+  // Jump around in time
+  for (double time : { 75.0, 3.0, 99.0, 50.0, 0.0 })
+  {
+    ds.update(time);
+    rv += SDK_ASSERT(ds.platformUpdateSlice(platId)->current() != nullptr && ds.platformUpdateSlice(platId)->current()->time() == time);
+    rv += SDK_ASSERT(ds.gateUpdateSlice(gateId)->current() != nullptr && ds.gateUpdateSlice(gateId)->current()->time() == time);
+  }
+
+  return rv;
+}
+
+}
+
+int TestTimeBucketIndex(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testIndex();
+  rv += testSlice();
+  rv += testDataStore();
+
+  return rv;
+}
@@ -0,0 +1,225 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@us.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <atomic>
+#include <deque>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataSlice.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/UpdateReclaimer.h"
+
+namespace
+{
+
+/** Number of CountedUpdate instances that have been destroyed */
+std::atomic<int> s_destroyed(0);
+
+/** Minimal update type that counts its own destruction */
+class CountedUpdate
+{
+public:
+  explicit CountedUpdate(double time)
+    : time_(time)
+  {
+  }
+
+  ~CountedUpdate()
+  {
+    ++s_destroyed;
+  }
+
+  double time() const
+  {
+    return time_;
+  }
+
+private:
+  double time_;
+};
+
+/** Owns the updates of a deque and frees them on destruction */
+struct CountedList
+{
+  explicit CountedList(int count)
+  {
+    for (int k = 0; k < count; ++k)
+      updates.push_back(new CountedUpdate(k));
+  }
+
+  ~CountedList()
+  {
+    for (auto* update : updates)
+      delete update;
+  }
+
+  std::deque<CountedUpdate*> updates;
+};
+
+int testReclaim()
+{
+  int rv = 0;
+  const size_t bigBatch = simData::UpdateReclaimer::MIN_DEFERRED_BATCH * 10;
+  simData::UpdateReclaimer reclaimer;
+
+  // Small batches are deleted inline
+  s_destroyed = 0;
+  std::vector<CountedUpdate*> items;
+  items.push_back(new CountedUpdate(1.0));
+  items.push_back(new CountedUpdate(2.0));
+  reclaimer.reclaim(items);
+  rv += SDK_ASSERT(items.empty());
+  rv += SDK_ASSERT(s_destroyed == 2);
+
+  // Large batches are deleted eventually
+  s_destroyed = 0;
+  for (size_t k = 0; k < bigBatch; ++k)
+    items.push_back(new CountedUpdate(static_cast<double>(k)));
+  reclaimer.reclaim(items);
+  rv += SDK_ASSERT(items.empty());
+  reclaimer.waitForIdle();
+  rv += SDK_ASSERT(s_destroyed == static_cast<int>(bigBatch));
+
+  // Shutting down destroys queued batches, and later batches are deleted inline regardless of size
+  s_destroyed = 0;
+  for (size_t k = 0; k < bigBatch; ++k)
+    items.push_back(new CountedUpdate(static_cast<double>(k)));
+  reclaimer.reclaim(items);
+  rv += SDK_ASSERT(!reclaimer.isShutDown());
+  reclaimer.shutDown();
+  rv += SDK_ASSERT(reclaimer.isShutDown());
+  rv += SDK_ASSERT(s_destroyed == static_cast<int>(bigBatch));
+  for (size_t k = 0; k < bigBatch; ++k)
+    items.push_back(new CountedUpdate(static_cast<double>(k)));
+  reclaimer.reclaim(items);
+  rv += SDK_ASSERT(s_destroyed == static_cast<int>(2 * bigBatch));
+
+  // Destructor finishes the queued batches
+  s_destroyed = 0;
+  {
+    simData::UpdateReclaimer scoped;
+    for (size_t k = 0; k < bigBatch; ++k)
+      items.push_back(new CountedUpdate(static_cast<double>(k)));
+    scoped.reclaim(items);
+  }
+  rv += SDK_ASSERT(s_destroyed == static_cast<int>(bigBatch));
+
+  return rv;
+}
+
+int testSliceHelper(simData::UpdateReclaimer* reclaimer)
+{
+  int rv = 0;
+
+  {
+    s_destroyed = 0;
+    CountedList list(1000);
+    rv += SDK_ASSERT(simData::MemorySliceHelper::limitByPoints(list.updates, 100, reclaimer) == 0);
+    rv += SDK_ASSERT(list.updates.size() == 100);
+    rv += SDK_ASSERT(list.updates.front()->time() == 900.0);
+    if (reclaimer)
+      reclaimer->waitForIdle();
+    rv += SDK_ASSERT(s_destroyed == 900);
+  }
+
+  {
+    s_destroyed = 0;
+    CountedList list(1000);
+    // Removes everything up to and including 499
+    rv += SDK_ASSERT(simData::MemorySliceHelper::limitByTime(list.updates, 499.0, reclaimer) == 0);
+    rv += SDK_ASSERT(list.updates.size() == 500);
+    rv += SDK_ASSERT(list.updates.front()->time() == 500.0);
+    // Always leaves one point
+    rv += SDK_ASSERT(simData::MemorySliceHelper::limitByTime(list.updates, 5000.0, reclaimer) == 0);
+    rv += SDK_ASSERT(list.updates.size() == 1);
+    rv += SDK_ASSERT(list.updates.front()->time() == 999.0);
+    if (reclaimer)
+      reclaimer->waitForIdle();
+    rv += SDK_ASSERT(s_destroyed == 999);
+  }
+
+  {
+    s_destroyed = 0;
+    CountedList list(1000);
+    // End time is not inclusive
+    rv += SDK_ASSERT(simData::MemorySliceHelper::flush(list.updates, 100.0, 800.0, reclaimer) == 0);
+    rv += SDK_ASSERT(list.updates.size() == 300);
+    rv += SDK_ASSERT(list.updates[99]->time() == 99.0);
+    rv += SDK_ASSERT(list.updates[100]->time() == 800.0);
+    rv += SDK_ASSERT(simData::MemorySliceHelper::flush(list.updates, 100.0, 800.0, reclaimer) == 1);
+    rv += SDK_ASSERT(simData::MemorySliceHelper::flush(list.updates, false, reclaimer) == 0);
+    rv += SDK_ASSERT(list.updates.empty());
+    if (reclaimer)
+      reclaimer->waitForIdle();
+    rv += SDK_ASSERT(s_destroyed == 1000);
+  }
+
+  return rv;
+}
+
+int testDataStore()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  rv += SDK_ASSERT(!ds.updateReclaiming());
+
+  simData::DataStore::Transaction txn;
+  simData::PlatformProperties* props = ds.addPlatform(&txn);
+  const simData::ObjectId id = props->id();
+  txn.complete(&props);
+  std::vector<simData::PlatformUpdate> updates(1000);
+  for (size_t k = 0; k < updates.size(); ++k)
+  {
+    updates[k].set_time(static_cast<double>(k));
+    updates[k].set_x(6378137.0);
+  }
+  rv += SDK_ASSERT(ds.addPlatformUpdates(id, updates) == 0);
+
+  // Existing entities pick up the reclaimer, and removals stay synchronous to the caller
+  ds.setUpdateReclaiming(true);
+  rv += SDK_ASSERT(ds.updateReclaiming());
+  ds.flush(id, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_UPDATES, 0.0, 900.0);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(id)->numItems() == 100);
+  ds.setUpdateReclaiming(false);
+  rv += SDK_ASSERT(!ds.updateReclaiming());
+  ds.flush(id, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_UPDATES, 0.0, 950.0);
+  rv += SDK_ASSERT(ds.platformUpdateSlice(id)->numItems() == 50);
+
+  // Destroying the store with reclaiming on shuts the thread down
+  ds.setUpdateReclaiming(true);
+  return rv;
+}
+
+}
+
+int TestUpdateReclaimer(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testReclaim();
+  rv += testSliceHelper(nullptr);
+  simData::UpdateReclaimer reclaimer;
+  rv += testSliceHelper(&reclaimer);
+  rv += testDataStore();
+
+  return rv;
+}